@@ -18,9 +18,10 @@ auto Demo_LineFeatures = [](Application& app)
         std::shared_ptr<rocky::FeatureSource> fs;
     };
     static jobs::future<LoadedFeatures> data;
+    static jobs::future<int> compiled;
     static FeatureView feature_view;
 
-    if (feature_view.entity == entt::null)
+    if (compiled.empty())
     {
         if (data.empty())
         {
@@ -38,21 +39,6 @@ auto Demo_LineFeatures = [](Application& app)
         }
         else if (data.available() && data->status.ok())
         {
-            auto[lock, registry] = app.registry.write();
-
-            // create a feature view and add features to it:
-            auto iter = data->fs->iterate(app.context->io);
-            while (iter.hasMore())
-            {
-                auto feature = iter.next();
-                if (feature.valid())
-                {
-                    // convert anything we find to lines:
-                    feature.geometry.convertToType(Geometry::Type::LineString);
-                    feature_view.features.emplace_back(std::move(feature));
-                }
-            }
-
             // apply a style for geometry creation:
             feature_view.styles.line = LineStyle
             {
@@ -64,8 +50,16 @@ auto Demo_LineFeatures = [](Application& app)
                 5000.0f            // depth offset (meters)
             };
 
-            // generate our renderable geometry
-            feature_view.generate(registry, app.mapNode->worldSRS(), app.context);
+            // stream the features into renderable geometry, batch by batch;
+            // the first lines appear while the source is still reading.
+            compiled = feature_view.generate(data->fs, app.registry, app.mapNode->worldSRS(),
+                app.context, app.context->io,
+                [](Feature& feature)
+                {
+                    // convert anything we find to lines:
+                    feature.geometry.convertToType(Geometry::Type::LineString);
+                    return true;
+                });
         }
         else
         {
@@ -73,6 +67,11 @@ auto Demo_LineFeatures = [](Application& app)
         }
     }
 
+    else if (compiled.working())
+    {
+        ImGui::Text("Compiling features...");
+    }
+
     else if (ImGuiLTable::Begin("Line features"))
     {
         auto [lock, registry] = app.registry.read();
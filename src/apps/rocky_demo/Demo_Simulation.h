@@ -75,8 +75,6 @@ auto Demo_Simulation = [](Application& app)
 
     if (platforms.empty())
     {
-        auto [lock, registry] = app.registry.write();
-
         // add an icon:
         auto io = app.context->io;
         auto image = io.services.readImageFromURI(icon_location, io);
@@ -117,15 +115,22 @@ auto Demo_Simulation = [](Application& app)
 
             auto ll_to_ecef = SRS::WGS84.to(SRS::ECEF);
 
+            // Build each component type in a contiguous array, then hand them
+            // all to the registry's bulk-create API, which preallocates the
+            // component storage and creates everything under a single lock.
+            std::vector<Icon> icons(num_platforms);
+            std::vector<Transform> transforms(num_platforms);
+            std::vector<MotionGreatCircle> motions(num_platforms);
+            std::vector<Widget> widgets(num_platforms);
+            std::vector<Line> drop_lines(num_platforms);
+            std::vector<Declutter> declutters(num_platforms);
+
             for (unsigned i = 0; i < num_platforms; ++i)
             {
                 float t = (float)i / (float)(num_platforms);
 
-                // Create a host entity:
-                auto entity = registry.create();
-
-                // Attach an icon:
-                auto& icon = registry.emplace<Icon>(entity);
+                // An icon:
+                auto& icon = icons[i];
                 icon.style = IconStyle{ 16.0f + t*16.0f, 0.0f }; // pixels, rotation(rad)
 
                 if (image.status.ok())
@@ -141,40 +146,45 @@ auto Demo_Simulation = [](Application& app)
                 // by avoiding a conversion every frame.
                 pos.transformInPlace(SRS::ECEF);
 
-                // Add a transform component:
-                auto& transform = registry.emplace<Transform>(entity);
+                // A transform component:
+                auto& transform = transforms[i];
                 transform.position = pos;
 
                 // We need this to support the drop-line. There is a small performance hit.
                 transform.topocentric = true;
 
-                // Add a motion component to represent movement:
+                // A motion component to represent movement:
                 double initial_bearing = -180.0 + rand_unit(mt) * 360.0;
-                auto& motion = registry.emplace<MotionGreatCircle>(entity);
+                auto& motion = motions[i];
                 motion.velocity = { -75000 + rand_unit(mt) * 150000, 0.0, 0.0 };
                 motion.normalAxis = pos.srs.ellipsoid().greatCircleRotationAxis(glm::dvec3(lon, lat, 0.0), initial_bearing);
 
-                // Add a labeling widget:
-                auto& widget = registry.emplace<Widget>(entity);
+                // A labeling widget:
+                auto& widget = widgets[i];
                 widget.text = std::to_string(i);
                 widget.render = render_widget;
 
                 // How about a drop line?
                 // Since the drop line is relative to the platfrom, we have to enable
                 // transform.localTangentPlane = true (see above)
-                auto& drop_line = registry.emplace<Line>(entity);
+                auto& drop_line = drop_lines[i];
                 drop_line.points = { {0.0, 0.0, 0.0}, {0.0, 0.0, -1e6} };
                 drop_line.style.width = 1.5f;
                 drop_line.style.color = vsg::vec4{ 0.4f, 0.4f, 0.4f, 1.0f };
 
                 // Decluttering control. The presence of this component will allow the entity
                 // to participate in decluttering when it's enabled.
-                auto& declutter = registry.emplace<Declutter>(entity);
+                auto& declutter = declutters[i];
                 declutter.priority = alt;
-
-                platforms.emplace(entity);
             }
 
+            // Create all the entities in one batched operation:
+            auto entities = app.registry.create(num_platforms,
+                icons.data(), transforms.data(), motions.data(),
+                widgets.data(), drop_lines.data(), declutters.data());
+
+            platforms.insert(entities.begin(), entities.end());
+
             sim.run();
         }
     }
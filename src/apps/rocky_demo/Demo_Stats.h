@@ -12,6 +12,7 @@
 #include <rocky/vsg/Application.h>
 #include <rocky/vsg/terrain/TerrainEngine.h>
 #include <rocky/Memory.h>
+#include <rocky/Trace.h>
 #include <vsg/core/Allocator.h>
 #include "helpers.h"
 
@@ -90,9 +91,23 @@ auto Demo_Stats = [](Application& app)
         buf = util::format(u8"%lld us", average(&record, over, f));
         ImGuiLTable::PlotLines("Record", get_timings, &record, frame_count, f, buf.c_str(), 0.0f, 10.0f);
 
+        auto p = app.stats.percentiles("frame");
+        ImGuiLTable::Text("Frame p50/p95/p99", "%.2f / %.2f / %.2f ms", p.p50, p.p95, p.p99);
+
         ImGuiLTable::End();
     }
 
+    if (util::trace::active())
+    {
+        if (ImGui::Button("Stop trace capture"))
+            util::trace::stop();
+    }
+    else
+    {
+        if (ImGui::Button("Start trace capture"))
+            util::trace::start("rocky_trace.json");
+    }
+
     ImGui::SeparatorText("Memory");
     if (ImGuiLTable::Begin("Memory"))
     {
@@ -100,6 +115,37 @@ auto Demo_Stats = [](Application& app)
         ImGuiLTable::Text("Working set", "%.1lf MB", (double)Memory::getProcessPhysicalUsage() / 1048576.0);
         ImGuiLTable::Text("Private bytes", "%.1lf MB", (double)Memory::getProcessPrivateUsage() / 1048576.0);
 
+        if (app.context->memory.peakUsage() > 0)
+        {
+            ImGuiLTable::Text("Private bytes (peak)", "%.1lf MB", (double)app.context->memory.peakUsage() / 1048576.0);
+        }
+
+        if (app.context->memory.budget > 0)
+        {
+            ImGuiLTable::Text("Memory budget", "%.1lf MB", (double)app.context->memory.budget / 1048576.0);
+        }
+        for (auto& s : app.context->memory.snapshot())
+        {
+            ImGuiLTable::Text(s.name.c_str(), "%u (peak %u)", (unsigned)s.size, (unsigned)s.peak);
+        }
+
+        if (app.context->gpuMemory.available())
+        {
+            for (auto& h : app.context->gpuMemory.heaps())
+            {
+                if (h.deviceLocal && h.budget > 0)
+                {
+                    ImGuiLTable::Text("GPU heap", "%.0lf / %.0lf MB",
+                        (double)h.usage / 1048576.0, (double)h.budget / 1048576.0);
+                }
+            }
+        }
+        for (auto& s : app.context->gpuMemory.snapshot())
+        {
+            ImGuiLTable::Text(s.name.c_str(), "%.1lf MB (peak %.1lf)",
+                (double)s.size / 1048576.0, (double)s.peak / 1048576.0);
+        }
+
         // VSG allocator. Commented out for now b/c this API may not be threadsafe (occaissonal crashes)
         //if (alloc->allocatorType == vsg::ALLOCATOR_TYPE_VSG_ALLOCATOR)
         //{
@@ -110,6 +156,32 @@ auto Demo_Stats = [](Application& app)
         ImGuiLTable::End();
     }
 
+    ImGui::SeparatorText("Caches");
+    if (ImGuiLTable::Begin("Caches"))
+    {
+        // sample on a fixed interval; each report() call starts the next
+        // measurement window, so calling it every frame would starve it
+        static std::vector<util::CacheTelemetry::Report> reports;
+        static auto lastReport = std::chrono::steady_clock::time_point{};
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport > std::chrono::seconds(10))
+        {
+            reports = util::CacheTelemetry::report();
+            lastReport = now;
+        }
+
+        for (auto& r : reports)
+        {
+            ImGuiLTable::Text(r.name.c_str(), "%.0f%% hit, %.0f evict/min",
+                100.0 * r.hitRatio, r.evictionsPerMinute);
+            if (!r.advice.empty())
+            {
+                ImGui::TextColored(ImVec4(1, .6f, .3f, 1), "  %s", r.advice.c_str());
+            }
+        }
+        ImGuiLTable::End();
+    }
+
     ImGui::SeparatorText("Thread Pools");
     auto* metrics = jobs::get_metrics();
     if (ImGuiLTable::Begin("Thread Pools"))
@@ -128,7 +200,8 @@ auto Demo_Stats = [](Application& app)
 
     auto& engine = app.mapNode->terrainNode->engine;
     auto& cache = app.context->io.services.contentCache;
-    float ratio = cache->gets > 0 ? float(cache->hits) / float(cache->gets) : 0.0f;
+    auto cacheGets = cache->gets();
+    float ratio = cacheGets > 0 ? float(cache->hits()) / float(cacheGets) : 0.0f;
 
     ImGui::SeparatorText("System");
     if (ImGuiLTable::Begin("System"))
@@ -0,0 +1,362 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+
+/**
+* ROCKY_STRESS is a headless terrain-paging stress harness. It drives the
+* CPU side of the paging pipeline - TerrainTileModelFactory against a
+* configurable layer stack - along a scripted, reproducible camera path,
+* with no window or GPU required, and reports:
+*
+*   - tiles merged per second
+*   - time to first full LOD (the opening view fully resident)
+*   - merge latency percentiles (p50 / p90 / p99)
+*   - peak RSS
+*
+* Run the same script against two builds for an apples-to-apples paging
+* comparison. A camera script is a text file of keyframes, one per line:
+*
+*   # seconds longitude latitude range_meters
+*   0   -77 42 10000000
+*   20  -77 42 50000
+*   40  -70 42 50000
+*
+* The camera interpolates linearly between keyframes. With no --script,
+* a built-in zoom-and-pan path is used. With no --map (a map JSON file),
+* a default OpenStreetMap imagery stack is used.
+*/
+
+#include <rocky/Context.h>
+#include <rocky/IOReplay.h>
+#include <rocky/Version.h>
+#include <rocky/Map.h>
+#include <rocky/Math.h>
+#include <rocky/Memory.h>
+#include <rocky/TerrainTileModelFactory.h>
+#include <rocky/TMSImageLayer.h>
+#include <rocky/TMSElevationLayer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ROCKY_NAMESPACE;
+using namespace std::chrono;
+
+namespace
+{
+    int usage(const char* name)
+    {
+        std::cout
+            << "usage: " << name << " [options]\n"
+            << "    --map <file.json>     layer stack to page (default: OSM imagery)\n"
+            << "    --script <file.txt>   camera keyframes: sec lon lat range_m\n"
+            << "    --concurrency <n>     merge worker threads (default 4)\n"
+            << "    --max-level <n>       deepest LOD to page (default 19)\n"
+            << "    --record <file>       archive every URI read and its timing\n"
+            << "    --replay <file>       serve URI reads from an archive, on the\n"
+            << "                          recorded timings, for deterministic runs\n"
+            << std::endl;
+        return -1;
+    }
+
+    struct Keyframe
+    {
+        double t;     // seconds from script start
+        double lon;   // degrees
+        double lat;   // degrees
+        double range; // meters above the surface
+    };
+
+    // the built-in path: zoom from orbit onto the US northeast, then pan
+    std::vector<Keyframe> defaultScript()
+    {
+        return {
+            {  0.0, -77.0, 42.0, 10.0e6 },
+            { 20.0, -77.0, 42.0, 50.0e3 },
+            { 40.0, -70.0, 42.0, 50.0e3 },
+        };
+    }
+
+    std::vector<Keyframe> loadScript(const std::string& filename)
+    {
+        std::vector<Keyframe> script;
+        std::ifstream in(filename);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            Keyframe k;
+            if (std::istringstream(line) >> k.t >> k.lon >> k.lat >> k.range)
+                script.emplace_back(k);
+        }
+        return script;
+    }
+
+    Keyframe sample(const std::vector<Keyframe>& script, double t)
+    {
+        if (t <= script.front().t) return script.front();
+        if (t >= script.back().t) return script.back();
+        for (std::size_t i = 0; i + 1 < script.size(); ++i)
+        {
+            auto& a = script[i];
+            auto& b = script[i + 1];
+            if (t <= b.t)
+            {
+                double u = (t - a.t) / (b.t - a.t);
+                return Keyframe{
+                    t,
+                    a.lon + u * (b.lon - a.lon),
+                    a.lat + u * (b.lat - a.lat),
+                    a.range + u * (b.range - a.range) };
+            }
+        }
+        return script.back();
+    }
+
+    // collected under a mutex by the merge workers
+    struct Stats
+    {
+        std::mutex mutex;
+        std::vector<double> mergeMilliseconds;
+        std::atomic<unsigned> merged = { 0 };
+        std::atomic<unsigned> empty = { 0 };
+    };
+
+    double percentile(std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0.0;
+        auto i = (std::size_t)(p * (double)(sorted.size() - 1));
+        return sorted[i];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string mapFile, scriptFile, recordFile, replayFile;
+    unsigned concurrency = 4;
+    unsigned maxLevel = 19;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--map" && i + 1 < argc) mapFile = argv[++i];
+        else if (arg == "--script" && i + 1 < argc) scriptFile = argv[++i];
+        else if (arg == "--concurrency" && i + 1 < argc) concurrency = std::atoi(argv[++i]);
+        else if (arg == "--max-level" && i + 1 < argc) maxLevel = std::atoi(argv[++i]);
+        else if (arg == "--record" && i + 1 < argc) recordFile = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc) replayFile = argv[++i];
+        else return usage(argv[0]);
+    }
+
+    if (!recordFile.empty() && !replayFile.empty())
+    {
+        std::cout << "--record and --replay are mutually exclusive" << std::endl;
+        return -1;
+    }
+
+    Log()->set_level(log::level::warn);
+
+    auto context = ContextFactory::create();
+
+    // record/replay wraps everything that touches the network, including
+    // the layers' metadata reads during open:
+    if (!recordFile.empty() && !util::ioreplay::record(recordFile))
+    {
+        std::cout << "Cannot create archive " << recordFile << std::endl;
+        return -1;
+    }
+    if (!replayFile.empty() && !util::ioreplay::replay(replayFile))
+    {
+        std::cout << "Cannot load archive " << replayFile << std::endl;
+        return -1;
+    }
+
+    // the layer stack to page:
+    auto map = Map::create();
+
+    if (!mapFile.empty())
+    {
+        std::ifstream in(mapFile);
+        if (!in)
+        {
+            std::cout << "Cannot open map file " << mapFile << std::endl;
+            return -1;
+        }
+        std::stringstream buf;
+        buf << in.rdbuf();
+        auto status = map->from_json(buf.str(), context->io);
+        if (status.failed())
+        {
+            std::cout << "Cannot parse map file: " << status.message << std::endl;
+            return -1;
+        }
+    }
+    else
+    {
+        auto imagery = TMSImageLayer::create();
+        imagery->uri = "https://[abc].tile.openstreetmap.org/{z}/{x}/{y}.png";
+        imagery->profile = Profile("spherical-mercator");
+        map->add(imagery);
+    }
+
+    map->openAllLayers(context->io);
+
+    for (auto& layer : map->layers().all())
+    {
+        if (layer->status().failed())
+        {
+            std::cout << "Layer \"" << layer->name() << "\" failed to open: "
+                << layer->status().message << std::endl;
+            return -1;
+        }
+    }
+
+    auto script = scriptFile.empty() ? defaultScript() : loadScript(scriptFile);
+    if (script.size() < 2)
+    {
+        std::cout << "Camera script needs at least 2 keyframes" << std::endl;
+        return -1;
+    }
+
+    // the paging grid; same default the terrain engine uses
+    Profile profile("global-geodetic");
+    const unsigned tileSize = 257;
+
+    // a nominal viewport for mapping camera range to level of detail
+    const double vfov = 30.0;        // degrees
+    const double viewportHeight = 1080.0; // pixels
+    const double metersPerDegree = 111320.0;
+
+    TerrainTileModelFactory factory;
+
+    auto pool = jobs::get_pool("rocky.stress", concurrency);
+
+    Stats stats;
+    std::map<TileKey, jobs::future<bool>> inflight;
+    std::set<TileKey> resident;
+
+    // the opening view's tiles; time-to-first-full-LOD is the wall time
+    // at which the last of them merges
+    std::set<TileKey> firstView;
+    double firstFullLOD = -1.0;
+
+    std::cout << ROCKY_PROJECT_NAME " " ROCKY_VERSION_STRING " paging stress harness\n"
+        << "concurrency=" << concurrency << ", script=" << script.back().t << "s\n";
+
+    auto start = steady_clock::now();
+    auto elapsed = [&]() { return 1e-3 * (double)duration_cast<milliseconds>(steady_clock::now() - start).count(); };
+
+    for (double now = elapsed(); now <= script.back().t || !inflight.empty(); now = elapsed())
+    {
+        auto cam = sample(script, std::min(now, script.back().t));
+
+        // ground resolution at the camera's range, in profile units:
+        double mpp = 2.0 * cam.range * tan(util::deg2rad(0.5 * vfov)) / viewportHeight;
+        double res = mpp / metersPerDegree;
+
+        unsigned lod = profile.getLevelOfDetailForHorizResolution(res, tileSize);
+        lod = std::min(lod, maxLevel);
+
+        // the extent the viewport covers at that resolution, clamped to
+        // the profile:
+        double h = res * viewportHeight * 0.5;
+        double w = h * (16.0 / 9.0);
+        GeoExtent visible(profile.srs(),
+            std::max(cam.lon - w, profile.extent().xmin()),
+            std::max(cam.lat - h, profile.extent().ymin()),
+            std::min(cam.lon + w, profile.extent().xmax()),
+            std::min(cam.lat + h, profile.extent().ymax()));
+
+        TileKey::Vector wanted;
+        TileKey::getIntersectingKeys(visible, lod, profile, wanted);
+
+        if (firstView.empty())
+            firstView.insert(wanted.begin(), wanted.end());
+
+        // schedule merges for tiles entering the working set:
+        for (auto& key : wanted)
+        {
+            if (resident.count(key) > 0 || inflight.count(key) > 0)
+                continue;
+
+            auto task = [&factory, &stats, map, key, io = context->io](jobs::cancelable&)
+                {
+                    auto t0 = steady_clock::now();
+                    auto model = factory.createTileModel(map.get(), key, {}, io);
+                    auto t1 = steady_clock::now();
+
+                    if (model.empty())
+                    {
+                        stats.empty++;
+                    }
+                    else
+                    {
+                        std::lock_guard lock(stats.mutex);
+                        stats.mergeMilliseconds.push_back(
+                            1e-3 * (double)duration_cast<microseconds>(t1 - t0).count());
+                    }
+                    stats.merged++;
+                    return true;
+                };
+
+            inflight[key] = jobs::dispatch(task, jobs::context{ "rocky::stress", pool });
+        }
+
+        // harvest completed merges:
+        for (auto iter = inflight.begin(); iter != inflight.end(); )
+        {
+            if (iter->second.available())
+            {
+                resident.insert(iter->first);
+
+                if (firstFullLOD < 0.0)
+                {
+                    firstView.erase(iter->first);
+                    if (firstView.empty())
+                        firstFullLOD = elapsed();
+                }
+
+                iter = inflight.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        std::this_thread::sleep_for(milliseconds(100));
+    }
+
+    double total = elapsed();
+
+    auto& lat = stats.mergeMilliseconds;
+    std::sort(lat.begin(), lat.end());
+
+    std::cout
+        << "tiles merged          " << stats.merged << " (" << stats.empty << " empty)\n"
+        << "tiles/sec             " << (double)stats.merged / total << "\n"
+        << "time-to-first-LOD     " << firstFullLOD << " s\n"
+        << "merge latency p50     " << percentile(lat, 0.50) << " ms\n"
+        << "merge latency p90     " << percentile(lat, 0.90) << " ms\n"
+        << "merge latency p99     " << percentile(lat, 0.99) << " ms\n"
+        << "peak RSS              " << (Memory::getProcessPeakPhysicalUsage() >> 20) << " MB\n";
+
+    util::ioreplay::stop();
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+
+/**
+* ROCKY_TILESERVER is a headless tile backend. It runs the compositing
+* pipeline - TerrainTileModelFactory against a configurable layer stack,
+* with the full cache stack behind it - and serves the composited output
+* per TileKey over HTTP, so thin clients page pre-merged tiles instead of
+* duplicating the compositing logic.
+*
+* Endpoints:
+*
+*   GET /tiles/{z}/{x}/{y}/image       composited imagery for the key
+*   GET /tiles/{z}/{x}/{y}/elevation   composited elevation for the key
+*   GET /status                        serving profile and layer stack
+*
+* Imagery is encoded with the context's image encoder when one is
+* registered (e.g. "?format=image/png"); otherwise - and always for
+* elevation - the payload is the raw grid behind a small header:
+*
+*   magic   char[4]    "RTS1" (imagery) / "RTS2" (elevation)
+*   format  uint32     Image::PixelFormat of the payload
+*   width   uint32
+*   height  uint32
+*   ...     raw pixels in native layout, row-major from the south
+*
+* A 404 means the pipeline produced no data for the key; a 204 means the
+* key is outside the serving profile.
+*/
+
+#include <rocky/Context.h>
+#include <rocky/Version.h>
+#include <rocky/Heightfield.h>
+#include <rocky/Image.h>
+#include <rocky/Map.h>
+#include <rocky/TerrainTileModelFactory.h>
+#include <rocky/TMSImageLayer.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifdef ROCKY_HAS_HTTPLIB
+#include <httplib.h>
+#endif
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    int usage(const char* name)
+    {
+        std::cout
+            << "usage: " << name << " [options]\n"
+            << "    --map <file.json>     layer stack to serve (default: OSM imagery)\n"
+            << "    --profile <name>      serving tile grid (default: global-geodetic)\n"
+            << "    --port <n>            listen port (default 8080)\n"
+            << "    --host <address>      bind address (default 0.0.0.0)\n"
+            << "    --cache <folder>      composited-tile disk cache (shareable)\n"
+            << "    --max-level <n>       deepest LOD to serve (default 19)\n"
+            << std::endl;
+        return -1;
+    }
+
+#ifdef ROCKY_HAS_HTTPLIB
+
+    // raw-payload header; see the file comment
+    struct PayloadHeader
+    {
+        char magic[4];
+        std::uint32_t format;
+        std::uint32_t width, height;
+    };
+
+    std::string rawPayload(const char* magic, const Image& image)
+    {
+        PayloadHeader header;
+        std::memcpy(header.magic, magic, 4);
+        header.format = (std::uint32_t)image.pixelFormat();
+        header.width = image.width();
+        header.height = image.height();
+
+        std::string body;
+        body.reserve(sizeof(header) + image.sizeInBytes());
+        body.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        body.append(reinterpret_cast<const char*>(image.data<unsigned char>()), image.sizeInBytes());
+        return body;
+    }
+
+#endif
+}
+
+int main(int argc, char** argv)
+{
+#ifndef ROCKY_HAS_HTTPLIB
+
+    std::cout << "This tool requires a build with BUILD_WITH_HTTPLIB=ON" << std::endl;
+    return -1;
+
+#else
+
+    std::string mapFile;
+    std::string profileName = "global-geodetic";
+    std::string host = "0.0.0.0";
+    std::string cacheFolder;
+    int port = 8080;
+    unsigned maxLevel = 19;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help") return usage(argv[0]);
+        else if (arg == "--map" && i + 1 < argc) mapFile = argv[++i];
+        else if (arg == "--profile" && i + 1 < argc) profileName = argv[++i];
+        else if (arg == "--port" && i + 1 < argc) port = std::atoi(argv[++i]);
+        else if (arg == "--host" && i + 1 < argc) host = argv[++i];
+        else if (arg == "--cache" && i + 1 < argc) cacheFolder = argv[++i];
+        else if (arg == "--max-level" && i + 1 < argc) maxLevel = std::atoi(argv[++i]);
+        else return usage(argv[0]);
+    }
+
+    Log()->set_level(log::level::info);
+
+    auto context = ContextFactory::create();
+
+    // the layer stack to composite:
+    auto map = Map::create();
+
+    if (!mapFile.empty())
+    {
+        std::ifstream in(mapFile);
+        if (!in)
+        {
+            std::cout << "Cannot open map file " << mapFile << std::endl;
+            return -1;
+        }
+        std::stringstream buf;
+        buf << in.rdbuf();
+        auto status = map->from_json(buf.str(), context->io);
+        if (status.failed())
+        {
+            std::cout << "Cannot parse map file: " << status.message << std::endl;
+            return -1;
+        }
+    }
+    else
+    {
+        auto imagery = TMSImageLayer::create();
+        imagery->uri = "https://[abc].tile.openstreetmap.org/{z}/{x}/{y}.png";
+        imagery->profile = Profile("spherical-mercator");
+        map->add(imagery);
+    }
+
+    map->openAllLayers(context->io);
+
+    for (auto& layer : map->layers().all())
+    {
+        if (layer->status().failed())
+        {
+            std::cout << "Layer \"" << layer->name() << "\" failed to open: "
+                << layer->status().message << std::endl;
+            return -1;
+        }
+    }
+
+    Profile profile(profileName);
+    if (!profile.valid())
+    {
+        std::cout << "Invalid profile \"" << profileName << "\"" << std::endl;
+        return -1;
+    }
+
+    TerrainTileModelFactory factory;
+    factory.diskCachePath = cacheFolder;
+
+    httplib::Server server;
+
+    // composited tile payloads. httplib runs each request on a worker
+    // thread and createTileModel is thread-safe, so requests composite
+    // in parallel; the cache stack (layer L2 caches, the HTTP disk
+    // cache, and the composited-tile disk cache) sits behind every one.
+    server.Get(R"(/tiles/(\d+)/(\d+)/(\d+)/(image|elevation))",
+        [&](const httplib::Request& req, httplib::Response& res)
+        {
+            unsigned z = (unsigned)std::stoul(req.matches[1]);
+            unsigned x = (unsigned)std::stoul(req.matches[2]);
+            unsigned y = (unsigned)std::stoul(req.matches[3]);
+            bool wantElevation = req.matches[4] == "elevation";
+
+            TileKey key(z, x, y, profile);
+            if (!key.valid() || z > maxLevel)
+            {
+                res.status = 204;
+                return;
+            }
+
+            auto model = factory.createTileModel(map.get(), key, {}, context->io);
+
+            if (wantElevation)
+            {
+                auto hf = model.elevation.heightfield.heightfield();
+                if (!hf)
+                {
+                    res.status = 404;
+                    return;
+                }
+                res.set_content(rawPayload("RTS2", *hf), "application/octet-stream");
+                return;
+            }
+
+            auto image = model.colorLayers.empty() ?
+                nullptr : model.colorLayers.front().image.image();
+            if (!image || !image->valid())
+            {
+                res.status = 404;
+                return;
+            }
+
+            // encode on request (e.g. format=image/png) when the context
+            // has an encoder; raw otherwise.
+            auto format = req.get_param_value("format");
+            if (!format.empty() && format != "raw" && context->io.services.writeImageToStream)
+            {
+                std::stringstream encoded;
+                auto status = context->io.services.writeImageToStream(image, encoded, format, context->io);
+                if (status.ok())
+                {
+                    res.set_content(encoded.str(), format);
+                    return;
+                }
+            }
+
+            res.set_content(rawPayload("RTS1", *image), "application/octet-stream");
+        });
+
+    server.Get("/status", [&](const httplib::Request&, httplib::Response& res)
+        {
+            std::stringstream buf;
+            buf << "{ \"profile\": \"" << profileName << "\", "
+                << "\"maxLevel\": " << maxLevel << ", "
+                << "\"map\": " << map->to_json() << " }";
+            res.set_content(buf.str(), "application/json");
+        });
+
+    Log()->info("Serving \"{}\" tiles on {}:{}", profileName, host, port);
+
+    if (!server.listen(host, port))
+    {
+        std::cout << "Cannot bind " << host << ":" << port << std::endl;
+        return -1;
+    }
+
+    return 0;
+
+#endif // ROCKY_HAS_HTTPLIB
+}
@@ -0,0 +1,217 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/Common.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    namespace util
+    {
+        /**
+         * Chunked bump allocator for short-lived, job-local allocations.
+         *
+         * Allocation is a pointer bump; nothing is freed individually.
+         * Instead, take a Marker with mark() before a burst of transient
+         * work and rewind() to it afterwards, returning every byte
+         * allocated in between. Chunks persist across rewinds, so a
+         * worker thread that processes many jobs through the same arena
+         * (see threadLocal) stops hitting the heap once the first few
+         * jobs have sized it.
+         *
+         * Scopes nest: an inner mark/rewind pair is safe inside an outer
+         * one as long as the outer scope does all of its allocating
+         * before the inner scope begins (e.g., reserve() a container up
+         * front rather than growing it across a nested call). The arena
+         * is not thread-safe; share one per thread, not across threads.
+         */
+        class Arena
+        {
+        public:
+            //! Position in the arena; see mark() and rewind().
+            struct Marker
+            {
+                std::size_t chunk = 0;
+                std::size_t offset = 0;
+            };
+
+            Arena(std::size_t chunkSize = 64 * 1024) :
+                _chunkSize(chunkSize)
+            {
+                //nop
+            }
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            //! Allocates "size" bytes with the given alignment. The memory
+            //! remains valid until a rewind past the current position.
+            inline void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+            {
+                for (;;)
+                {
+                    if (_chunk < _chunks.size())
+                    {
+                        auto& c = _chunks[_chunk];
+                        std::size_t aligned = (_offset + alignment - 1) & ~(alignment - 1);
+                        if (aligned + size <= c.size)
+                        {
+                            _offset = aligned + size;
+                            return c.data.get() + aligned;
+                        }
+                        // no room; fall through to the next chunk.
+                        ++_chunk;
+                        _offset = 0;
+                    }
+                    else
+                    {
+                        // oversized requests get a dedicated chunk.
+                        _chunks.emplace_back(std::max(_chunkSize, size + alignment));
+                        _chunk = _chunks.size() - 1;
+                        _offset = 0;
+                    }
+                }
+            }
+
+            //! Current position, for a later rewind().
+            inline Marker mark() const
+            {
+                return Marker{ _chunk, _offset };
+            }
+
+            //! Returns every byte allocated since the marker was taken.
+            //! Chunks are retained for reuse.
+            inline void rewind(const Marker& m)
+            {
+                _chunk = m.chunk;
+                _offset = m.offset;
+            }
+
+            //! Rewinds to the beginning, retaining the chunks.
+            inline void clear()
+            {
+                _chunk = 0;
+                _offset = 0;
+            }
+
+            //! Returns all memory to the heap.
+            inline void release()
+            {
+                _chunks.clear();
+                _chunk = 0;
+                _offset = 0;
+            }
+
+            //! Total bytes held by the arena's chunks.
+            inline std::size_t capacity() const
+            {
+                std::size_t total = 0;
+                for (auto& c : _chunks)
+                    total += c.size;
+                return total;
+            }
+
+            //! The calling thread's arena. Loader jobs share this through
+            //! ScopedArena so each pool thread warms up one set of chunks.
+            static inline Arena& threadLocal()
+            {
+                static thread_local Arena arena;
+                return arena;
+            }
+
+        private:
+            struct Chunk
+            {
+                std::unique_ptr<std::uint8_t[]> data;
+                std::size_t size;
+
+                explicit Chunk(std::size_t s) :
+                    data(new std::uint8_t[s]), size(s) { }
+            };
+
+            std::vector<Chunk> _chunks;
+            std::size_t _chunk = 0;
+            std::size_t _offset = 0;
+            std::size_t _chunkSize;
+        };
+
+        /**
+         * Standard allocator adapter that bump-allocates from an Arena.
+         * Deallocation is a no-op; memory comes back when the owning
+         * scope rewinds.
+         */
+        template<class T>
+        class ArenaAllocator
+        {
+        public:
+            using value_type = T;
+
+            ArenaAllocator(Arena& arena) : _arena(&arena) { }
+
+            template<class U>
+            ArenaAllocator(const ArenaAllocator<U>& rhs) : _arena(rhs._arena) { }
+
+            inline T* allocate(std::size_t n)
+            {
+                return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+            }
+
+            inline void deallocate(T*, std::size_t)
+            {
+                //nop - freed wholesale by the scope's rewind
+            }
+
+            template<class U>
+            bool operator==(const ArenaAllocator<U>& rhs) const { return _arena == rhs._arena; }
+            template<class U>
+            bool operator!=(const ArenaAllocator<U>& rhs) const { return _arena != rhs._arena; }
+
+            Arena* _arena;
+        };
+
+        /**
+         * RAII arena scope. Marks the arena on construction and rewinds
+         * it on destruction, freeing everything the scope allocated in
+         * one shot. Converts implicitly to an ArenaAllocator so it can
+         * be passed straight to an arena_vector's constructor.
+         */
+        class ScopedArena
+        {
+        public:
+            ScopedArena(Arena& arena) :
+                _arena(arena), _marker(arena.mark())
+            {
+                //nop
+            }
+
+            ScopedArena(const ScopedArena&) = delete;
+            ScopedArena& operator=(const ScopedArena&) = delete;
+
+            ~ScopedArena()
+            {
+                _arena.rewind(_marker);
+            }
+
+            template<class T>
+            operator ArenaAllocator<T>() const
+            {
+                return ArenaAllocator<T>(_arena);
+            }
+
+        private:
+            Arena& _arena;
+            Arena::Marker _marker;
+        };
+
+        //! std::vector whose storage lives in an Arena.
+        template<class T>
+        using arena_vector = std::vector<T, ArenaAllocator<T>>;
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "CacheTelemetry.h"
+#include "Utils.h"
+
+#include <mutex>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    std::mutex _mutex;
+    std::vector<std::weak_ptr<util::CacheTelemetry::Registration>> _registry;
+}
+
+std::shared_ptr<util::CacheTelemetry::Registration>
+util::CacheTelemetry::add(const std::string& name, Sampler sampler)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(sampler, nullptr);
+
+    auto reg = std::make_shared<Registration>();
+    reg->name = name;
+    reg->sampler = sampler;
+    reg->last = sampler();
+    reg->lastTime = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _registry.emplace_back(reg);
+    return reg;
+}
+
+std::vector<util::CacheTelemetry::Report>
+util::CacheTelemetry::report()
+{
+    std::vector<Report> result;
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto iter = _registry.begin(); iter != _registry.end(); )
+    {
+        auto reg = iter->lock();
+        if (!reg)
+        {
+            iter = _registry.erase(iter);
+            continue;
+        }
+        ++iter;
+
+        auto stats = reg->sampler();
+
+        Report r;
+        r.name = reg->name;
+        r.total = stats;
+
+        double minutes = 1e-3 * (double)std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - reg->lastTime).count() / 60.0;
+
+        auto gets = stats.gets - reg->last.gets;
+        auto hits = stats.hits - reg->last.hits;
+        auto evictions = stats.evictions - reg->last.evictions;
+
+        if (gets > 0)
+            r.hitRatio = (double)hits / (double)gets;
+
+        if (minutes > 0.0)
+        {
+            r.getsPerMinute = (double)gets / minutes;
+            r.evictionsPerMinute = (double)evictions / minutes;
+        }
+
+        // the advisor. A cache that misses more than it hits while
+        // evicting is cycling its working set through a too-small
+        // budget; one that always hits while half empty is overbudgeted.
+        if (gets >= 100)
+        {
+            if (r.hitRatio < 0.5 && evictions > 0 &&
+                stats.capacity > 0 && stats.size * 10 >= stats.capacity * 9)
+            {
+                r.advice = util::format(
+                    "thrashing at %.0f%% hit rate; consider a larger capacity",
+                    100.0 * r.hitRatio);
+            }
+            else if (r.hitRatio > 0.95 && evictions == 0 &&
+                stats.capacity > 0 && stats.size * 2 < stats.capacity)
+            {
+                r.advice = util::format(
+                    "hit rate %.0f%% with capacity less than half used; budget could be reduced",
+                    100.0 * r.hitRatio);
+            }
+        }
+
+        reg->last = stats;
+        reg->lastTime = now;
+
+        result.emplace_back(std::move(r));
+    }
+
+    return result;
+}
@@ -0,0 +1,82 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/Common.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    namespace util
+    {
+        /**
+        * Process-wide registry of cache statistics. Each cache registers a
+        * sampler; report() samples them all, computes per-interval hit
+        * ratios and eviction rates, and attaches advice when a capacity
+        * looks misconfigured (a thrashing cache, an oversized one) - so
+        * cache capacities can be tuned from evidence instead of folklore.
+        *
+        * Registration costs nothing per cache operation; the counters are
+        * the ones the caches already keep.
+        */
+        class ROCKY_EXPORT CacheTelemetry
+        {
+        public:
+            //! Counters a cache reports when sampled. All counters are
+            //! totals since the cache was created; report() differences
+            //! consecutive samples to compute rates.
+            struct Stats
+            {
+                std::uint64_t gets = 0;
+                std::uint64_t hits = 0;
+                std::uint64_t evictions = 0;
+                std::size_t size = 0;     // resident cost (bytes or entries)
+                std::size_t capacity = 0; // configured budget, same units
+            };
+
+            using Sampler = std::function<Stats()>;
+
+            //! Registration handle. Dropping it unregisters the cache.
+            struct Registration
+            {
+                std::string name;
+                Sampler sampler;
+
+                // previous sample, for rate computation in report()
+                Stats last;
+                std::chrono::steady_clock::time_point lastTime;
+            };
+
+            //! Registers a cache. Keep the returned handle alive for as
+            //! long as the cache exists.
+            static std::shared_ptr<Registration> add(const std::string& name, Sampler sampler);
+
+            //! One cache's activity over the interval since the previous
+            //! report() call.
+            struct Report
+            {
+                std::string name;
+                Stats total;                   // lifetime counters
+                double hitRatio = 0.0;         // interval [0..1]
+                double getsPerMinute = 0.0;    // interval
+                double evictionsPerMinute = 0.0; // interval
+                std::string advice;            // empty when healthy
+            };
+
+            //! Samples every registered cache and computes interval rates.
+            //! Call it periodically (once a minute is plenty); each call
+            //! starts the next interval.
+            static std::vector<Report> report();
+
+            // Not creatable.
+            CacheTelemetry() = delete;
+        };
+    }
+}
@@ -5,6 +5,7 @@
  */
 #include "Context.h"
 #include "GeoExtent.h"
+#include "Memory.h"
 #include "Profile.h"
 #include "SRS.h"
 #include "Threading.h"
@@ -12,6 +13,7 @@
 #include "Version.h"
 #include "json.h"
 #include "weejobs.h"
+#include <cstdlib>
 
 ROCKY_ABOUT(rocky, ROCKY_VERSION_STRING)
 ROCKY_ABOUT(weejobs, WEEJOBS_VERSION_STRING)
@@ -144,6 +146,89 @@ ContextImpl::~ContextImpl()
 //    return _impl->ioOptions;
 //}
 
+MemoryGovernor::MemoryGovernor()
+{
+    auto budgetMB = util::getEnvVar("ROCKY_MEMORY_BUDGET_MB");
+    if (!budgetMB.empty())
+    {
+        budget = (std::int64_t)std::atoll(budgetMB.c_str()) * 1048576LL;
+    }
+}
+
+std::shared_ptr<MemoryGovernor::Registration>
+MemoryGovernor::add(
+    const std::string& name,
+    std::function<std::size_t()> size,
+    std::function<void(float)> shrink)
+{
+    auto reg = std::make_shared<Registration>(Registration{ name, size, shrink });
+    std::scoped_lock L(_mutex);
+    _registrations.emplace_back(reg);
+    return reg;
+}
+
+float
+MemoryGovernor::update()
+{
+    auto usage = Memory::getProcessPrivateUsage();
+    if (usage > _peakUsage)
+        _peakUsage = usage;
+
+    if (budget <= 0)
+        return 0.0f;
+
+    auto threshold = (std::int64_t)((double)budget * (double)pressureThreshold);
+    if (usage <= threshold)
+        return 0.0f;
+
+    // don't hammer the caches; once a second is plenty for eviction
+    // to land and the process stats to catch up.
+    auto now = std::chrono::steady_clock::now();
+    if (now - _lastPressureTime < std::chrono::seconds(1))
+        return 0.0f;
+    _lastPressureTime = now;
+
+    // pressure ramps from 0 at the threshold to 1 at the full budget:
+    float pressure = (float)std::min(1.0,
+        (double)(usage - threshold) / (double)std::max<std::int64_t>(1, budget - threshold));
+
+    std::scoped_lock L(_mutex);
+    for (auto it = _registrations.begin(); it != _registrations.end(); )
+    {
+        auto reg = it->lock();
+        if (!reg)
+        {
+            it = _registrations.erase(it);
+            continue;
+        }
+        if (reg->shrink)
+        {
+            reg->shrink(pressure);
+        }
+        ++it;
+    }
+
+    return pressure;
+}
+
+std::vector<MemoryGovernor::Snapshot>
+MemoryGovernor::snapshot() const
+{
+    std::vector<Snapshot> result;
+    std::scoped_lock L(_mutex);
+    for (auto& entry : _registrations)
+    {
+        auto reg = entry.lock();
+        if (reg && reg->size)
+        {
+            auto size = reg->size();
+            reg->peak = std::max(reg->peak, size);
+            result.emplace_back(Snapshot{ reg->name, size, reg->peak });
+        }
+    }
+    return result;
+}
+
 UID rocky::createUID()
 {
     static std::atomic<unsigned> uidgen = 0;
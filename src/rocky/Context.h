@@ -6,13 +6,82 @@
 #pragma once
 #include <rocky/Common.h>
 #include <rocky/IOTypes.h>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include <unordered_map>
 #include <set>
+#include <vector>
 
 namespace ROCKY_NAMESPACE
 {
+    /**
+     * Central memory governor. The various caches in the system (URI
+     * content cache, terrain geometry pool, etc.) each manage their own
+     * capacity with no global view of process memory. Caches register
+     * here with a size-reporting function and an optional shrink
+     * function; update() polls the process's private byte count and,
+     * when it approaches the configured budget, applies eviction
+     * pressure to every registered cache in proportion to the overage.
+     */
+    class ROCKY_EXPORT MemoryGovernor
+    {
+    public:
+        //! A registered cache. Hold the token returned by add() for as
+        //! long as the cache exists; the registration expires with it.
+        struct Registration
+        {
+            std::string name;
+            std::function<std::size_t()> size;  //! resident bytes (or entries, where bytes are unknown)
+            std::function<void(float)> shrink;  //! evict roughly this fraction of contents [0..1]; empty = informational only
+            std::size_t peak = 0;               //! high-water mark of size(); maintained by snapshot()
+        };
+
+        //! Process memory budget, in bytes. Zero disables governing.
+        //! Defaults to the ROCKY_MEMORY_BUDGET_MB environment variable.
+        std::int64_t budget = 0;
+
+        //! Fraction of the budget at which eviction pressure begins.
+        float pressureThreshold = 0.8f;
+
+        //! Register a cache with the governor.
+        std::shared_ptr<Registration> add(
+            const std::string& name,
+            std::function<std::size_t()> size,
+            std::function<void(float)> shrink = {});
+
+        //! Checks process memory against the budget and applies eviction
+        //! pressure if needed. Call once per frame; pressure applies at
+        //! most once per second so caches are not flushed outright.
+        //! @return The pressure applied, [0..1] (zero when under budget)
+        float update();
+
+        //! One registered cache's current size and high-water mark, for
+        //! diagnostics displays.
+        struct Snapshot
+        {
+            std::string name;
+            std::size_t size = 0;
+            std::size_t peak = 0;
+        };
+
+        //! Samples each registered cache, updating its high-water mark.
+        std::vector<Snapshot> snapshot() const;
+
+        //! Highest process private byte count seen by update().
+        std::int64_t peakUsage() const { return _peakUsage; }
+
+        MemoryGovernor();
+
+    private:
+        mutable std::mutex _mutex;
+        std::vector<std::weak_ptr<Registration>> _registrations;
+        std::chrono::steady_clock::time_point _lastPressureTime;
+        std::int64_t _peakUsage = 0;
+    };
+
     class ROCKY_EXPORT ContextImpl
     {
     public:
@@ -26,6 +95,9 @@ namespace ROCKY_NAMESPACE
         //! Default IO options
         IOOptions io;
 
+        //! Memory budget governor; see MemoryGovernor
+        MemoryGovernor memory;
+
     public: // Object factory functions
 
         //! Object creation function that lets you create objects based on their name.
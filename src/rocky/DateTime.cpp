@@ -5,7 +5,8 @@
  */
 #include "DateTime.h"
 #include "Utils.h"
-#include <stdio.h> 
+#include <algorithm>
+#include <stdio.h>
 #include <time.h>
 
 // to get the TIXML_SSCANF macro
@@ -185,46 +186,60 @@ DateTime::hours() const
     return (double)_tm.tm_hour + ((double)_tm.tm_min)/60. + ((double)_tm.tm_sec)/3600.;
 }
 
+namespace
+{
+    // clamps an snprintf result to the characters actually written
+    inline std::size_t written(int n, std::size_t size)
+    {
+        if (n <= 0 || size == 0)
+            return 0;
+        return std::min((std::size_t)n, size - 1);
+    }
+}
+
+std::size_t
+DateTime::formatRFC1123(char* buf, std::size_t size) const
+{
+    return written(::snprintf(buf, size, "%s, %02d %s %04d %02d:%02d:%02d GMT",
+        rfc_wkday[_tm.tm_wday], _tm.tm_mday, rfc_month[_tm.tm_mon],
+        1900 + _tm.tm_year, _tm.tm_hour, _tm.tm_min, _tm.tm_sec), size);
+}
+
+std::size_t
+DateTime::formatISO8601(char* buf, std::size_t size) const
+{
+    return written(::snprintf(buf, size, "%04d-%02d-%02dT%02d:%02d:%02dZ",
+        _tm.tm_year + 1900, _tm.tm_mon + 1, _tm.tm_mday,
+        _tm.tm_hour, _tm.tm_min, _tm.tm_sec), size);
+}
+
+std::size_t
+DateTime::formatCompactISO8601(char* buf, std::size_t size) const
+{
+    return written(::snprintf(buf, size, "%04d%02d%02dT%02d%02d%02dZ",
+        _tm.tm_year + 1900, _tm.tm_mon + 1, _tm.tm_mday,
+        _tm.tm_hour, _tm.tm_min, _tm.tm_sec), size);
+}
+
 const std::string
 DateTime::asRFC1123() const
 {
-    return util::make_string()
-        << rfc_wkday[_tm.tm_wday] << ", "
-        << std::setfill('0') << std::setw(2) << _tm.tm_mday << ' '
-        << rfc_month[_tm.tm_mon] << ' '
-        << std::setw(4) << (1900 + _tm.tm_year) << ' '
-        << std::setw(2) << _tm.tm_hour << ':'
-        << std::setw(2) << _tm.tm_min << ':'
-        << std::setw(2) << _tm.tm_sec << ' '
-        << "GMT";
+    char buf[32];
+    return std::string(buf, formatRFC1123(buf, sizeof(buf)));
 }
 
 const std::string
 DateTime::asISO8601() const
 {
-    return util::make_string()
-        << std::setw(4) << (_tm.tm_year + 1900) << '-'
-        << std::setfill('0') << std::setw(2) << (_tm.tm_mon + 1) << '-'
-        << std::setfill('0') << std::setw(2) << (_tm.tm_mday)
-        << 'T'
-        << std::setfill('0') << std::setw(2) << _tm.tm_hour << ':'
-        << std::setfill('0') << std::setw(2) << _tm.tm_min << ':'
-        << std::setfill('0') << std::setw(2) << _tm.tm_sec
-        << 'Z';
+    char buf[24];
+    return std::string(buf, formatISO8601(buf, sizeof(buf)));
 }
 
 const std::string
 DateTime::asCompactISO8601() const
 {
-    return util::make_string()
-        << std::setw(4) << (_tm.tm_year + 1900)
-        << std::setfill('0') << std::setw(2) << (_tm.tm_mon + 1)
-        << std::setfill('0') << std::setw(2) << (_tm.tm_mday)
-        << 'T'
-        << std::setfill('0') << std::setw(2) << _tm.tm_hour
-        << std::setfill('0') << std::setw(2) << _tm.tm_min
-        << std::setfill('0') << std::setw(2) << _tm.tm_sec
-        << 'Z';
+    char buf[20];
+    return std::string(buf, formatCompactISO8601(buf, sizeof(buf)));
 }
 
 
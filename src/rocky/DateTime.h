@@ -57,6 +57,20 @@ namespace ROCKY_NAMESPACE
           * order with no delimiters). */
         const std::string asCompactISO8601() const;
 
+        /** Formats RFC 1123 into a caller-provided buffer (at least 30
+          * bytes) with no allocation; returns the characters written,
+          * excluding the terminator. For per-frame readouts. */
+        std::size_t formatRFC1123(char* buf, std::size_t size) const;
+
+        /** Formats ISO 8601 into a caller-provided buffer (at least 21
+          * bytes) with no allocation; returns the characters written. */
+        std::size_t formatISO8601(char* buf, std::size_t size) const;
+
+        /** Formats compact ISO 8601 into a caller-provided buffer (at
+          * least 17 bytes) with no allocation; returns the characters
+          * written. */
+        std::size_t formatCompactISO8601(char* buf, std::size_t size) const;
+
         /** Julian day (fractional) corresponding to this DateTime */
         double getJulianDay() const;
 
@@ -0,0 +1,182 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "ElevationConstraintLayer.h"
+#include "Context.h"
+#include "GeoExtent.h"
+#include "Heightfield.h"
+#include "rtree.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace ROCKY_NAMESPACE;
+
+#undef LC
+#define LC "[ElevationConstraint] "
+
+ROCKY_ADD_OBJECT_FACTORY(ElevationConstraint,
+    [](const std::string& JSON, const IOOptions& io) {
+        return ElevationConstraintLayer::create(JSON, io); })
+
+struct ElevationConstraintLayer::ConstraintIndex : public RTree<std::size_t, double, 2>
+{
+    //nop
+};
+
+ElevationConstraintLayer::ElevationConstraintLayer() :
+    super()
+{
+    construct({}, {});
+}
+
+ElevationConstraintLayer::ElevationConstraintLayer(const std::string& JSON, const IOOptions& io) :
+    super(JSON)
+{
+    construct(JSON, io);
+}
+
+void
+ElevationConstraintLayer::construct(const std::string& JSON, const IOOptions& io)
+{
+    setLayerTypeName("ElevationConstraint");
+    _index = std::make_shared<ConstraintIndex>();
+}
+
+void
+ElevationConstraintLayer::add(ElevationConstraint&& constraint)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(constraint.srs.valid(), void());
+    ROCKY_SOFT_ASSERT_AND_RETURN(
+        !constraint.geometry.points.empty() || !constraint.geometry.parts.empty(), void());
+
+    // bounds in the common index SRS:
+    auto to_index = constraint.srs.to(SRS::WGS84);
+
+    double xmin = std::numeric_limits<double>::max(), ymin = xmin;
+    double xmax = -xmin, ymax = -xmin;
+
+    Geometry::const_iterator iter(constraint.geometry);
+    while (iter.hasMore())
+    {
+        for (auto& point : iter.next().points)
+        {
+            glm::dvec3 p = point;
+            if (to_index.transform(p.x, p.y, p.z))
+            {
+                xmin = std::min(xmin, p.x), xmax = std::max(xmax, p.x);
+                ymin = std::min(ymin, p.y), ymax = std::max(ymax, p.y);
+            }
+        }
+    }
+
+    ROCKY_SOFT_ASSERT_AND_RETURN(xmin <= xmax && ymin <= ymax, void());
+
+    {
+        std::unique_lock lock(_mutex);
+
+        double a_min[2] = { xmin, ymin };
+        double a_max[2] = { xmax, ymax };
+        _index->Insert(a_min, a_max, _constraints.size());
+        _constraints.emplace_back(std::move(constraint));
+    }
+
+    // invalidate so the terrain re-pages intersecting tiles:
+    dirty();
+}
+
+void
+ElevationConstraintLayer::clear()
+{
+    {
+        std::unique_lock lock(_mutex);
+
+        if (_constraints.empty())
+            return;
+
+        _constraints.clear();
+        _index->RemoveAll();
+    }
+
+    dirty();
+}
+
+std::size_t
+ElevationConstraintLayer::size() const
+{
+    std::shared_lock lock(_mutex);
+    return _constraints.size();
+}
+
+bool
+ElevationConstraintLayer::applyTo(Heightfield& hf, const GeoExtent& extent) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(extent.valid(), false);
+    ROCKY_SOFT_ASSERT_AND_RETURN(hf.width() > 1 && hf.height() > 1, false);
+
+    std::shared_lock lock(_mutex);
+
+    if (_constraints.empty())
+        return false;
+
+    // one rectangle query rules out the overwhelming majority of tiles:
+    auto searchExtent = extent.transform(SRS::WGS84);
+    if (!searchExtent.valid())
+        return false;
+
+    std::vector<std::size_t> hits;
+    double a_min[2] = { searchExtent.xmin(), searchExtent.ymin() };
+    double a_max[2] = { searchExtent.xmax(), searchExtent.ymax() };
+    _index->Search(a_min, a_max, [&](const std::size_t& i) {
+        hits.push_back(i);
+        return true; });
+
+    if (hits.empty())
+        return false;
+
+    // apply in registration order so a later constraint wins an overlap:
+    std::sort(hits.begin(), hits.end());
+
+    bool changed = false;
+
+    // coordinate op, rebuilt only when the SRS changes (constraints
+    // overwhelmingly share one):
+    SRS cached_srs;
+    SRSOperation xform;
+
+    for (auto i : hits)
+    {
+        auto& constraint = _constraints[i];
+
+        if (constraint.srs != cached_srs)
+        {
+            cached_srs = constraint.srs;
+            xform = extent.srs().to(constraint.srs);
+        }
+
+        for (unsigned row = 0; row < hf.height(); ++row)
+        {
+            double y = extent.ymin() + extent.height() * (double)row / (double)(hf.height() - 1);
+
+            for (unsigned col = 0; col < hf.width(); ++col)
+            {
+                double x = extent.xmin() + extent.width() * (double)col / (double)(hf.width() - 1);
+
+                glm::dvec3 p(x, y, 0.0);
+                if (!xform.transform(p.x, p.y, p.z))
+                    continue;
+
+                if (!constraint.geometry.contains(p.x, p.y))
+                    continue;
+
+                float& h = hf.heightAt(col, row);
+                h = (constraint.elevation.has_value() ? constraint.elevation.value() : h) + constraint.offset;
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,88 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/Layer.h>
+#include <rocky/Feature.h>
+#include <rocky/SRS.h>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    class GeoExtent;
+    class Heightfield;
+
+    /**
+     * One elevation constraint: a polygon with a flatten/offset rule.
+     * Samples inside the polygon flatten to "elevation" when it is set
+     * (otherwise they keep the sampled terrain height) and then shift by
+     * "offset" - so a runway flattens with a fixed elevation, and a
+     * building pad excavates with a negative offset alone.
+     */
+    struct ElevationConstraint
+    {
+        //! Area the rule applies to; a Polygon or MultiPolygon
+        Geometry geometry;
+
+        //! Spatial reference of the geometry coordinates
+        SRS srs = SRS::WGS84;
+
+        //! Target elevation to flatten to, in meters; unset leaves the
+        //! sampled terrain height in place
+        option<float> elevation;
+
+        //! Offset added after flattening, in meters; negative excavates
+        float offset = 0.0f;
+    };
+
+    /**
+     * Layer holding runtime elevation constraints.
+     *
+     * Add it to the Map and register constraints at runtime; the terrain
+     * tile factory applies them during heightfield assembly, so editing
+     * a constraint re-pages only the affected tiles instead of requiring
+     * an offline DEM rebuild. Constraint bounds live in a spatial index
+     * and tiles that intersect nothing pay a single rectangle query.
+     */
+    class ROCKY_EXPORT ElevationConstraintLayer : public Inherit<Layer, ElevationConstraintLayer>
+    {
+    public:
+        //! Construct an empty constraint layer
+        ElevationConstraintLayer();
+        ElevationConstraintLayer(const std::string& JSON, const IOOptions& io);
+
+        //! Register a constraint. Bumps the layer revision so the
+        //! terrain invalidates and re-pages intersecting tiles.
+        void add(ElevationConstraint&& constraint);
+
+        //! Remove all constraints
+        void clear();
+
+        //! Number of registered constraints
+        std::size_t size() const;
+
+        //! Apply every constraint intersecting the given extent to the
+        //! heightfield, in registration order (a later constraint wins
+        //! where two overlap). Called by the terrain tile factory on a
+        //! load job; safe to call from any thread.
+        //! @return true if any sample changed
+        bool applyTo(Heightfield& hf, const GeoExtent& extent) const;
+
+    private:
+        struct ConstraintIndex;
+
+        std::vector<ElevationConstraint> _constraints;
+
+        //! constraint bounds, indexed in a common SRS so one search
+        //! covers constraints registered in different SRSs
+        std::shared_ptr<ConstraintIndex> _index;
+
+        mutable std::shared_mutex _mutex;
+
+        void construct(const std::string& JSON, const IOOptions& io);
+    };
+}
@@ -4,11 +4,14 @@
  * MIT License
  */
 #include "ElevationLayer.h"
+#include "Arena.h"
 #include "Geoid.h"
 #include "Heightfield.h"
 #include "json.h"
 
 #include <cinttypes>
+#include <mutex>
+#include <unordered_map>
 
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::util;
@@ -72,6 +75,22 @@ namespace
 
 //------------------------------------------------------------------------
 
+namespace
+{
+    // registry of pluggable decoders for custom "encoding" values.
+    std::mutex _decodersMutex;
+    std::unordered_map<std::string, ElevationLayer::Decoder> _decoders;
+}
+
+void
+ElevationLayer::registerDecoder(const std::string& encoding, Decoder decoder)
+{
+    std::scoped_lock L(_decodersMutex);
+    _decoders[encoding] = decoder;
+}
+
+//------------------------------------------------------------------------
+
 ElevationLayer::ElevationLayer() :
     super()
 {
@@ -94,6 +113,7 @@ ElevationLayer::construct(const std::string& JSON, const IOOptions& io)
     get_to(j, "no_data_value", noDataValue);
     get_to(j, "min_valid_value", minValidValue);
     get_to(j, "max_valid_value", maxValidValue);
+    get_to(j, "generate_min_max_pyramids", generateMinMaxPyramids);
     std::string encoding_value;
     if (get_to(j, "encoding", encoding_value))
     {
@@ -101,6 +121,10 @@ ElevationLayer::construct(const std::string& JSON, const IOOptions& io)
             encoding = Encoding::SingleChannel;
         else if (encoding_value == "mapboxrgb")
             encoding = Encoding::MapboxRGB;
+        else if (encoding_value == "terrariumrgb")
+            encoding = Encoding::TerrariumRGB;
+        else
+            _customEncoding = encoding_value; // resolved by a registered decoder
     }
 
     // a small L2 cache will help with things like normal map creation
@@ -131,10 +155,15 @@ ElevationLayer::to_json() const
     set(j, "no_data_value", noDataValue);
     set(j, "min_valid_value", minValidValue);
     set(j, "max_valid_value", maxValidValue);
-    if (encoding.has_value(Encoding::SingleChannel))
+    set(j, "generate_min_max_pyramids", generateMinMaxPyramids);
+    if (!_customEncoding.empty())
+        set(j, "encoding", _customEncoding);
+    else if (encoding.has_value(Encoding::SingleChannel))
         set(j, "encoding", "single_channel");
     else if (encoding.has_value(Encoding::MapboxRGB))
         set(j, "encoding", "mapboxrgb");
+    else if (encoding.has_value(Encoding::TerrariumRGB))
+        set(j, "encoding", "terrariumrgb");
 
     return j.dump();
 }
@@ -148,6 +177,8 @@ ElevationLayer::openImplementation(const IOOptions& io)
 
     _dependencyCache = std::make_shared<TileMosaicWeakCache<Heightfield>>();
 
+    _telemetryReg = _L2cache.telemetry("elevation L2 (" + name() + ")");
+
     return StatusOK;
 }
 
@@ -155,6 +186,7 @@ void
 ElevationLayer::closeImplementation()
 {
     _dependencyCache = nullptr;
+    _telemetryReg = nullptr;
     super::closeImplementation();
 }
 
@@ -184,15 +216,20 @@ ElevationLayer::assembleHeightfield(const TileKey& key, const IOOptions& io) con
 {
     std::shared_ptr<HeightfieldMosaic> output;
 
+    // Transient working storage (the source set and the sample grid)
+    // comes from the thread's arena and is released wholesale on return.
+    util::ScopedArena arena(util::Arena::threadLocal());
+
     // Determine the intersecting keys
-    std::vector<TileKey> intersectingKeys;
+    TileKey::Vector intersectingKeys;
     unsigned targetLOD = profile.getEquivalentLOD(key.profile, key.level);
     key.getIntersectingKeys(profile, intersectingKeys);
 
     // collect heightfield for each intersecting key. Note, we're hitting the
     // underlying tile source here, so there's no vetical datum shifts happening yet.
     // we will do that later.
-    std::vector<GeoHeightfield> sources;
+    util::arena_vector<GeoHeightfield> sources(arena);
+    sources.reserve(intersectingKeys.size());
 
     if (intersectingKeys.size() > 0)
     {
@@ -233,7 +270,7 @@ ElevationLayer::assembleHeightfield(const TileKey& key, const IOOptions& io) con
                     _dependencyCache->put(intersectingKey, subKey, subTile.value.heightfield());
 
                     // add it to our sources collection:
-                    sources.emplace_back(subTile.value);
+                    sources.emplace_back(std::move(subTile.value));
 
                     if (subKey.level == targetLOD)
                     {
@@ -281,7 +318,7 @@ ElevationLayer::assembleHeightfield(const TileKey& key, const IOOptions& io) con
                 };
 
             // working set of points. it's much faster to xform an entire vector all at once.
-            std::vector<glm::dvec3> points;
+            util::arena_vector<glm::dvec3> points(arena);
             points.resize(cols * rows);
 
             // note, for elevation we sample edge to edge instead of on pixel-center.
@@ -341,10 +378,15 @@ ElevationLayer::assembleHeightfield(const TileKey& key, const IOOptions& io) con
 Result<GeoHeightfield>
 ElevationLayer::createHeightfield(const TileKey& key, const IOOptions& io) const
 {
+    // join the layer's task group so close() can cancel this operation
+    // while it is in flight:
+    util::CancelableGroup::Member canceler(backgroundTasks(), io);
+    IOOptions local(io, canceler);
+
     std::shared_lock readLock(layerStateMutex());
     if (isOpen())
     {
-        return createHeightfieldInKeyProfile(key, io);
+        return createHeightfieldInKeyProfile(key, local);
     }
     return status();
 }
@@ -425,6 +467,12 @@ ElevationLayer::createHeightfieldInKeyProfile(const TileKey& key, const IOOption
 
     result = GeoHeightfield(hf, key.extent());
 
+    // optionally precompute the min/max pyramid for fast intersection culling:
+    if (generateMinMaxPyramids == true)
+    {
+        result.generateMinMaxPyramid();
+    }
+
     return result;
 }
 
@@ -465,15 +513,18 @@ namespace
             double lonInterval = geodeticExtent.width() / (double)(numCols - 1);
             double latInterval = geodeticExtent.height() / (double)(numRows - 1);
 
+            // query the geoid for the whole grid in one batch, then patch
+            // just the invalid samples:
+            std::vector<float> offsets((std::size_t)numCols * numRows);
+            geoid->getHeights(offsets.data(), numCols, numRows, lonMin, latMin, lonInterval, latInterval);
+
             for (unsigned r = 0; r < numRows; ++r)
             {
-                double lat = latMin + latInterval * (double)r;
                 for (unsigned c = 0; c < numCols; ++c)
                 {
-                    double lon = lonMin + lonInterval * (double)c;
                     if (grid->heightAt(c, r) == invalidValue)
                     {
-                        grid->heightAt(c, r) = geoid->getHeight(lat, lon);
+                        grid->heightAt(c, r) = offsets[(std::size_t)r * numCols + c];
                     }
                 }
             }
@@ -628,10 +679,6 @@ ElevationLayerVector::populateHeightfield(
 
     unsigned int total = numColumns * numRows;
 
-    int nodataCount = 0;
-
-    TileKey actualKey; // Storage if a new key needs to be constructed
-
     bool requiresResample = true;
 
     // If we only have a single contender layer, and the tile is the same size as the requested
@@ -669,183 +716,165 @@ ElevationLayerVector::populateHeightfield(
         }
     }
 
-    // If we need to mosaic multiple layers or resample it to a new output tilesize go through a resampling loop.
+    // If we need to mosaic multiple layers or resample to a new output
+    // tile size, gather the layer stack in a single pass. Each sample
+    // takes its height from the highest-priority layer with valid data
+    // there; a layer only fills the samples the layers above it left
+    // empty, and a layer whose samples are all covered never loads at
+    // all. Each layer's heightfield resolves at most once per tile and
+    // its SRS transform builds once, instead of per sample, and no
+    // intermediate per-layer resamplings are allocated.
     if (requiresResample)
     {
-        // We will load the actual heightfields on demand. We might not need them all.
-        std::vector<GeoHeightfield> heightfields(contenders.size());
-        std::vector<TileKey> heightfieldActualKeys(contenders.size());
-        std::vector<GeoHeightfield> offsetfields(offsets.size());
-        std::vector<bool> heightFallback(contenders.size(), false);
-        std::vector<bool> heightFailed(contenders.size(), false);
-        std::vector<bool> offsetFailed(offsets.size(), false);
-
-        // Initialize the actual keys to match the contender keys.
-        // We'll adjust these as necessary if we need to fall back
-        for(unsigned i=0; i<contenders.size(); ++i)
-        {
-            heightfieldActualKeys[i] = contenders[i].key;
-        }
+        // which layer (by stack index) resolved each sample, or -1:
+        std::vector<int> resolvedIndex(total, -1);
 
-        // The maximum number of heightfields to keep in this local cache
-        const unsigned maxHeightfields = 50;
-        unsigned numHeightfieldsInCache = 0;
+        std::vector<float> resolution;
+        if (resolutions)
+            resolution.assign(total, FLT_MAX);
 
-        for (unsigned c = 0; c < numColumns; ++c)
-        {
-            double x = xmin + (dx * (double)c);
+        unsigned remaining = total;
+
+        // scratch for the batched sampling, reused across layers:
+        std::vector<glm::dvec3> points;
+        std::vector<unsigned> pointIndex;
+        points.reserve(total);
+        pointIndex.reserve(total);
 
-            // periodically check for cancelation
+        for (unsigned i = 0; i < contenders.size() && remaining > 0; ++i)
+        {
             if (io.canceled())
-            {
                 return false;
-            }
 
-            for (unsigned r = 0; r < numRows; ++r)
+            ElevationLayer* layer = contenders[i].layer.get();
+
+            // resolve this layer's heightfield once, falling back on
+            // parent tiles until data appears:
+            TileKey actualKey = contenders[i].key;
+            GeoHeightfield layerHF;
+            while (!layerHF.valid() && actualKey.valid() && layer->isKeyInLegalRange(actualKey))
             {
-                double y = ymin + (dy * (double)r);
+                layerHF = layer->createHeightfield(actualKey, io).value;
+                if (!layerHF.valid())
+                    actualKey.makeParent();
+            }
 
-                // Collect elevations from each layer as necessary.
-                int resolvedIndex = -1;
+            if (!layerHF.valid())
+                continue;
 
-                float resolution = FLT_MAX;
+            // We only have real data if this is not a fallback heightfield.
+            bool isFallback =
+                contenders[i].isFallback ||
+                (actualKey != contenders[i].key);
+
+            if (!isFallback)
+            {
+                realData = true;
+            }
 
-                glm::fvec3 normal_sum(0, 0, 0);
+            float layerResolution = (float)actualKey.getResolutionForTileSize(hf->width()).second;
 
-                for (int i = 0; i < contenders.size() && resolvedIndex < 0; ++i)
+            // gather the samples that are still empty:
+            points.clear();
+            pointIndex.clear();
+            for (unsigned s = 0; s < total; ++s)
+            {
+                if (resolvedIndex[s] < 0)
                 {
-                    ElevationLayer* layer = contenders[i].layer.get();
-                    TileKey& contenderKey = contenders[i].key;
-                    int index = contenders[i].index;
+                    points.emplace_back(
+                        xmin + dx * (double)(s % numColumns),
+                        ymin + dy * (double)(s / numColumns),
+                        0.0);
+                    pointIndex.emplace_back(s);
+                }
+            }
 
-                    if (heightFailed[i])
-                        continue;
+            // one transform and one sampling pass for the whole set:
+            SRSOperation xform;
+            if (keySRS != layerHF.srs())
+                xform = keySRS.to(layerHF.srs());
 
-                    GeoHeightfield& layerHF = heightfields[i];
-                    TileKey& actualKey = heightfieldActualKeys[i];
+            layerHF.heightAt(points, xform, interpolation);
 
-                    if (!layerHF.valid())
-                    {
-                        // We couldn't get the heightfield from the cache, so try to create it.
-                        // We also fallback on parent layers to make sure that we have data at the location even if it's fallback.
-                        while (!layerHF.valid() && actualKey.valid() && layer->isKeyInLegalRange(actualKey))
-                        {
-                            layerHF = layer->createHeightfield(actualKey, io).value;
-                            if (!layerHF.valid())
-                            {
-                                actualKey.makeParent();
-                            }
-                        }
-
-                        // Mark this layer as fallback if necessary.
-                        if (layerHF.valid())
-                        {
-                            //TODO: check this. Should it be actualKey != keyToUse...?
-                            heightFallback[i] =
-                                contenders[i].isFallback ||
-                                (actualKey != contenderKey);
-
-                            numHeightfieldsInCache++;
-                        }
-                        else
-                        {
-                            heightFailed[i] = true;
-                            continue;
-                        }
-                    }
+            for (std::size_t p = 0; p < points.size(); ++p)
+            {
+                float elevation = (float)points[p].z;
+                if (elevation != NO_DATA_VALUE)
+                {
+                    unsigned s = pointIndex[p];
+                    hf->heightAt(s % numColumns, s / numColumns) = elevation;
 
-                    if (layerHF.valid())
-                    {
-                        bool isFallback = heightFallback[i];
-
-                        // We only have real data if this is not a fallback heightfield.
-                        if (!isFallback)
-                        {
-                            realData = true;
-                        }
-
-                        //TODO: optimize by using SRSOperation variant
-                        float elevation = layerHF.heightAt(x, y, keySRS, interpolation);
-                        if (elevation != NO_DATA_VALUE)
-                        {
-                            // remember the index so we can only apply offset layers that
-                            // sit on TOP of this layer.
-                            resolvedIndex = index;
-
-                            hf->write(glm::fvec4(elevation), c, r);
-
-                            resolution = (float)actualKey.getResolutionForTileSize(hf->width()).second;
-                        }
-                        else
-                        {
-                            ++nodataCount;
-                        }
-                    }
+                    // remember the stack index so we only apply offset
+                    // layers that sit on TOP of this layer.
+                    resolvedIndex[s] = contenders[i].index;
 
+                    if (resolutions)
+                        resolution[s] = layerResolution;
 
-                    // Clear the heightfield cache if we have too many heightfields in the cache.
-                    if (numHeightfieldsInCache >= maxHeightfields)
-                    {
-                        //OE_NOTICE << "Clearing cache" << std::endl;
-                        for (unsigned int k = 0; k < heightfields.size(); k++)
-                        {
-                            heightfields[k] = GeoHeightfield::INVALID;
-                            heightFallback[k] = false;
-                        }
-                        numHeightfieldsInCache = 0;
-                    }
+                    --remaining;
                 }
+            }
+        }
 
-                for (int i = (int)offsets.size() - 1; i >= 0; --i)
-                {
-                    if (io.canceled())
-                        return false;
+        // Offset layers apply additively, lowest priority first, and only
+        // where they sit on top of the layer that resolved the sample (or
+        // where no layer resolved it).
+        for (int i = (int)offsets.size() - 1; i >= 0; --i)
+        {
+            if (io.canceled())
+                return false;
 
-                    // Only apply an offset layer if it sits on top of the resolved layer
-                    // (or if there was no resolved layer).
-                    if (resolvedIndex >= 0 && offsets[i].index < resolvedIndex)
-                        continue;
+            const TileKey& contenderKey = offsets[i].key;
 
-                    TileKey& contenderKey = offsets[i].key;
+            auto layerHF = offsets[i].layer->createHeightfield(contenderKey, io).value;
+            if (!layerHF.valid())
+                continue;
 
-                    if (offsetFailed[i] == true)
-                        continue;
+            // If we actually got a layer then we have real data
+            realData = true;
 
-                    GeoHeightfield& layerHF = offsetfields[i];
-                    if (!layerHF.valid())
-                    {
-                        ElevationLayer* offset = offsets[i].layer.get();
-
-                        layerHF = offset->createHeightfield(contenderKey, io).value;
-                        if (!layerHF.valid())
-                        {
-                            offsetFailed[i] = true;
-                            continue;
-                        }
-                    }
+            float layerResolution = (float)contenderKey.getResolutionForTileSize(hf->width()).second;
 
-                    // If we actually got a layer then we have real data
-                    realData = true;
+            points.clear();
+            pointIndex.clear();
+            for (unsigned s = 0; s < total; ++s)
+            {
+                if (resolvedIndex[s] < 0 || offsets[i].index >= resolvedIndex[s])
+                {
+                    points.emplace_back(
+                        xmin + dx * (double)(s % numColumns),
+                        ymin + dy * (double)(s / numColumns),
+                        0.0);
+                    pointIndex.emplace_back(s);
+                }
+            }
 
-                    float elevation = layerHF.heightAt(x, y, keySRS, interpolation);
-                    if (elevation != NO_DATA_VALUE && !equiv(elevation, 0.0f))
-                    {
-                        hf->heightAt(c, r) += elevation;
+            SRSOperation xform;
+            if (keySRS != layerHF.srs())
+                xform = keySRS.to(layerHF.srs());
 
-                        // Technically this is correct, but the resultin normal maps
-                        // look awful and faceted.
-                        resolution = std::min(
-                            resolution,
-                            (float)contenderKey.getResolutionForTileSize(hf->width()).second);
-                    }
-                }
+            layerHF.heightAt(points, xform, interpolation);
 
-                if (resolutions)
+            for (std::size_t p = 0; p < points.size(); ++p)
+            {
+                float elevation = (float)points[p].z;
+                if (elevation != NO_DATA_VALUE && !equiv(elevation, 0.0f))
                 {
-                    (*resolutions)[r*numColumns+c] = resolution;
+                    unsigned s = pointIndex[p];
+                    hf->heightAt(s % numColumns, s / numColumns) += elevation;
+
+                    // Technically this is correct, but the resulting normal
+                    // maps look awful and faceted.
+                    if (resolutions)
+                        resolution[s] = std::min(resolution[s], layerResolution);
                 }
             }
         }
+
+        if (resolutions)
+        {
+            std::copy(resolution.begin(), resolution.end(), resolutions->begin());
+        }
     }
 
     // Resolve any invalid heights in the output heightfield.
@@ -866,47 +895,148 @@ ElevationLayer::decodeRGB(std::shared_ptr<Image> image) const
     if (!image || !image->valid())
         return nullptr;
 
+    // a custom encoding dispatches to its registered decoder:
+    if (!_customEncoding.empty())
+    {
+        Decoder decode;
+        {
+            std::scoped_lock L(_decodersMutex);
+            auto i = _decoders.find(_customEncoding);
+            if (i != _decoders.end())
+                decode = i->second;
+        }
+        if (decode)
+        {
+            return decode(image);
+        }
+        // no decoder registered; fall through to the built-in conversions.
+    }
+
     // convert the RGB Elevation into an actual heightfield
     auto hf = Heightfield::create(image->width(), image->height());
 
-    if (encoding == Encoding::TerrariumRGB)
+    // fast path: 8-bit RGB(A) tiles decode in one fused integer pass
+    // over the raw buffer, skipping the per-pixel normalize/denormalize
+    // round trip through the generic pixel reader.
+    if (image->pixelFormat() == Image::R8G8B8_UNORM ||
+        image->pixelFormat() == Image::R8G8B8A8_UNORM)
     {
-        glm::fvec4 pixel;
-        for (unsigned y = 0; y < image->height(); ++y)
+        const unsigned stride = image->pixelFormat() == Image::R8G8B8A8_UNORM ? 4u : 3u;
+        const unsigned char* px = image->data<unsigned char>();
+        float* out = hf->data<float>();
+        std::size_t count = (std::size_t)image->width() * image->height();
+
+        if (encoding == Encoding::TerrariumRGB)
         {
-            for (unsigned x = 0; x < image->width(); ++x)
+            for (std::size_t i = 0; i < count; ++i, px += stride)
             {
-                image->read(pixel, x, y);
-
                 float height =
-                    ((pixel.r * 255.0f * 256.0f + pixel.g * 255.0f + pixel.b * 255.0f / 256.0f) - 32768.0f);
+                    (float)((px[0] << 8) + px[1]) + (float)px[2] * (1.0f / 256.0f) - 32768.0f;
 
-                if (height < -9999 || height > 999999)
-                    height = NO_DATA_VALUE;
+                out[i] = (height < -9999 || height > 999999) ? NO_DATA_VALUE : height;
+            }
+        }
+        else // default to MapboxRGB
+        {
+            for (std::size_t i = 0; i < count; ++i, px += stride)
+            {
+                float height =
+                    -10000.0f + (float)((px[0] << 16) + (px[1] << 8) + px[2]) * 0.1f;
 
-                hf->heightAt(x, y) = height;
+                out[i] = (height < -9999 || height > 999999) ? NO_DATA_VALUE : height;
             }
         }
+
+        return hf;
+    }
+
+    // dispatch on the source format once so the per-pixel reads inline
+    // (see ImageView):
+    if (encoding == Encoding::TerrariumRGB)
+    {
+        visitImagePixelFormat(image.get(), [&](auto view)
+            {
+                glm::fvec4 pixel;
+                for (unsigned y = 0; y < image->height(); ++y)
+                {
+                    for (unsigned x = 0; x < image->width(); ++x)
+                    {
+                        view.read(pixel, x, y);
+
+                        float height =
+                            ((pixel.r * 255.0f * 256.0f + pixel.g * 255.0f + pixel.b * 255.0f / 256.0f) - 32768.0f);
+
+                        if (height < -9999 || height > 999999)
+                            height = NO_DATA_VALUE;
+
+                        hf->heightAt(x, y) = height;
+                    }
+                }
+            });
     }
 
     else // default to MapboxRGB
     {
-        glm::fvec4 pixel;
-        for (unsigned y = 0; y < image->height(); ++y)
-        {
-            for (unsigned x = 0; x < image->width(); ++x)
+        visitImagePixelFormat(image.get(), [&](auto view)
             {
-                image->read(pixel, x, y);
+                glm::fvec4 pixel;
+                for (unsigned y = 0; y < image->height(); ++y)
+                {
+                    for (unsigned x = 0; x < image->width(); ++x)
+                    {
+                        view.read(pixel, x, y);
 
-                float height = -10000.f +
-                    ((pixel.r * 256.0f * 256.0f + pixel.g * 256.0f + pixel.b) * 256.0f * 0.1f);
+                        float height = -10000.f +
+                            ((pixel.r * 256.0f * 256.0f + pixel.g * 256.0f + pixel.b) * 256.0f * 0.1f);
 
-                if (height < -9999 || height > 999999)
-                    height = NO_DATA_VALUE;
+                        if (height < -9999 || height > 999999)
+                            height = NO_DATA_VALUE;
 
-                hf->heightAt(x, y) = height;
-            }
-        }
+                        hf->heightAt(x, y) = height;
+                    }
+                }
+            });
+    }
+
+    return hf;
+}
+
+std::shared_ptr<Heightfield>
+ElevationLayer::decodeSingleChannel(std::shared_ptr<Image> image) const
+{
+    if (!image || !image->valid())
+        return nullptr;
+
+    if (image->pixelFormat() == Image::R32_SFLOAT)
+    {
+        // already in heightfield form; adopt the buffer in place instead
+        // of reallocating and converting.
+        return Heightfield::create(image.get());
+    }
+
+    ROCKY_SOFT_ASSERT_AND_RETURN(image->numComponents() == 1, nullptr);
+
+    auto hf = Heightfield::create(image->width(), image->height());
+
+    // raw component values convert directly to heights - no RGB
+    // expansion and no normalization round trip.
+    if (image->pixelFormat() == Image::R8_UNORM)
+    {
+        for (unsigned y = 0; y < image->height(); ++y)
+            for (unsigned x = 0; x < image->width(); ++x)
+                hf->heightAt(x, y) = (float)image->value<unsigned char>(x, y);
+    }
+    else if (image->pixelFormat() == Image::R16_UNORM)
+    {
+        for (unsigned y = 0; y < image->height(); ++y)
+            for (unsigned x = 0; x < image->width(); ++x)
+                hf->heightAt(x, y) = (float)image->value<unsigned short>(x, y);
+    }
+    else // R64_SFLOAT
+    {
+        for (unsigned y = 0; y < image->height(); ++y)
+            for (unsigned x = 0; x < image->width(); ++x)
+                hf->heightAt(x, y) = (float)image->value<double>(x, y);
     }
 
     return hf;
@@ -38,6 +38,21 @@ namespace ROCKY_NAMESPACE
         //! Encoding of the elevation data
         option<Encoding> encoding = Encoding::SingleChannel;
 
+        //! Function that decodes an encoded elevation image into a
+        //! heightfield in a single pass.
+        using Decoder = std::function<std::shared_ptr<Heightfield>(std::shared_ptr<Image>)>;
+
+        //! Registers a decoder for a custom "encoding" value. A layer
+        //! configured with that encoding runs the decoder in place of the
+        //! built-in conversions in decodeRGB(). Decoders must be
+        //! re-entrant; tiles decode concurrently on the job system.
+        static void registerDecoder(const std::string& encoding, Decoder decoder);
+
+        //! Whether to build a min/max pyramid on each loaded heightfield so
+        //! intersection queries (line of sight, picking) can hierarchically
+        //! reject regions instead of marching samples
+        option<bool> generateMinMaxPyramids = false;
+
         //! Serialize this layer
         std::string to_json() const override;
 
@@ -85,9 +100,18 @@ namespace ROCKY_NAMESPACE
         //! as denoted in the "encoding" option
         std::shared_ptr<Heightfield> decodeRGB(std::shared_ptr<Image> image) const;
 
+        //! Converts a single-channel image directly into a heightfield with
+        //! no RGB expansion. R32 float data is adopted in place (resetting
+        //! the source image); other single-channel formats convert raw
+        //! component values to heights.
+        std::shared_ptr<Heightfield> decodeSingleChannel(std::shared_ptr<Image> image) const;
+
     private:
         void construct(const std::string& JSON, const IOOptions& io);
 
+        // encoding value naming a registered decoder (see registerDecoder)
+        std::string _customEncoding;
+
         std::shared_ptr<Heightfield> assembleHeightfield(const TileKey& key, const IOOptions& io) const;
 
         void normalizeNoDataValues(Heightfield* hf) const;
@@ -96,6 +120,9 @@ namespace ROCKY_NAMESPACE
 
         mutable util::LRUCache<TileKey, Result<GeoHeightfield>> _L2cache;
 
+        // cache telemetry registration; held open() to close()
+        std::shared_ptr<util::CacheTelemetry::Registration> _telemetryReg;
+
         Result<GeoHeightfield> createHeightfieldImplementation_internal(
             const TileKey& key,
             const IOOptions& io) const;
@@ -182,6 +182,72 @@ Ellipsoid::geocentricToGeodetic(const glm::dvec3& geoc) const
     return out;
 }
 
+void
+Ellipsoid::geodeticToGeocentricArray(glm::dvec3* inout, std::size_t count) const
+{
+    // Same math as geodeticToGeocentric, with the constants hoisted and
+    // a branch-free loop body the compiler can vectorize.
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double latitude = deg2rad(inout[i].y);
+        double longitude = deg2rad(inout[i].x);
+        double height = inout[i].z;
+
+        double sin_latitude = sin(latitude);
+        double cos_latitude = cos(latitude);
+
+        double N = _re / sqrt(1.0 - _ecc2 * sin_latitude * sin_latitude);
+
+        inout[i] = glm::dvec3(
+            (N + height) * cos_latitude * cos(longitude),
+            (N + height) * cos_latitude * sin(longitude),
+            (N * (1.0 - _ecc2) + height) * sin_latitude);
+    }
+}
+
+void
+Ellipsoid::geocentricToGeodeticArray(glm::dvec3* inout, std::size_t count) const
+{
+    double eDashSquared = (_re * _re - _rp * _rp) / (_rp * _rp);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const glm::dvec3 geoc = inout[i];
+
+        // points on the polar axis need the special-case handling in the
+        // single-point converter; everything else stays in the fast loop.
+        double p = sqrt(geoc.x * geoc.x + geoc.y * geoc.y);
+        if (p == 0.0)
+        {
+            inout[i] = geocentricToGeodetic(geoc);
+            continue;
+        }
+
+        double longitude = atan2(geoc.y, geoc.x);
+        double theta = atan2(geoc.z * _re, (p * _rp));
+
+        double sin_theta = sin(theta);
+        double cos_theta = cos(theta);
+
+        double latitude = atan(
+            (geoc.z + eDashSquared * _rp * sin_theta * sin_theta * sin_theta) /
+            (p - _ecc2 * _re * cos_theta * cos_theta * cos_theta));
+
+        double sin_latitude = sin(latitude);
+        double N = _re / sqrt(1.0 - _ecc2 * sin_latitude * sin_latitude);
+
+        double height = p / cos(latitude) - N;
+
+        glm::dvec3 out(rad2deg(longitude), rad2deg(latitude), height);
+
+        for (int c = 0; c < 3; ++c)
+            if (std::isnan(out[c]))
+                out[c] = 0.0;
+
+        inout[i] = out;
+    }
+}
+
 void
 Ellipsoid::set(double re, double rp)
 {
@@ -54,6 +54,20 @@ namespace ROCKY_NAMESPACE
         //! @return output geocentric (x, y, z meters) point
         glm::dvec3 geodeticToGeocentric(const glm::dvec3& geodPoint) const;
 
+        //! Convert an array of geocentric points to geodetic, in place.
+        //! Faster than converting one point at a time.
+        //! @param inout Geocentric (x, y, z meters) points in; geodetic
+        //!   (degrees longitude, degrees latitude, meters altitude) points out
+        //! @param count Number of points
+        void geocentricToGeodeticArray(glm::dvec3* inout, std::size_t count) const;
+
+        //! Convert an array of geodetic points to geocentric, in place.
+        //! Faster than converting one point at a time.
+        //! @param inout Geodetic (degrees longitude, degrees latitude, meters altitude)
+        //!   points in; geocentric (x, y, z meters) points out
+        //! @param count Number of points
+        void geodeticToGeocentricArray(glm::dvec3* inout, std::size_t count) const;
+
         //! Converts degrees to meters at a given latitide
         //! @param value Degrees to convert
         //! @param lat_deg Reference latitude in degrees
@@ -7,6 +7,11 @@
 #include "DateTime.h"
 #include "Ellipsoid.h"
 
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
+
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::util;
 
@@ -33,25 +38,35 @@ namespace
         return a - floor(a / 360.0) * 360.0;
     }
 
+    //! Day count relative to the astronomical reference time
+    //! (1999Dec31.0TDT).
+    double refDay(const DateTime& dt)
+    {
+        static const double JD_REFTIME = DateTime(1999, 12, 31, 0.0).getJulianDay();
+        return dt.getJulianDay() - JD_REFTIME;
+    }
+
+    struct SunSample
+    {
+        double RA_deg = 0.0;
+        double DECL_deg = 0.0;
+    };
+
     struct Sun
     {
         // http://www.stjarnhimlen.se/comp/tutorial.html#5
         // Test: http://www.satellite-calculations.com/Satellite/suncalc.htm
-        CelestialBody position(const DateTime& dt) const
-        {
-            static const Ellipsoid WGS84;
-
-            // Reference to 1999Dec31.0TDT
-            const double JD_REFTIME = DateTime(1999, 12, 31, 0.0).getJulianDay();
-            double d = dt.getJulianDay() - JD_REFTIME;
 
+        //! The slowly varying part of the series: right ascension and
+        //! declination for day number d.
+        SunSample sample(double d) const
+        {
             double w = 282.9404 + 4.70935E-5 * d;
             const double a = 1.0;
 
             double e = 0.016709 - 1.151E-9 * d;
             double M = 356.0470 + 0.9856002585 * d;
             double oblecl = 23.4393 - 3.563E-7 * d;
-            double L = rev(w + rev(M));
 
             double E = rev(M + rad2deg(e * sin(deg2rad(M)) * (1.0 + e * cos(deg2rad(M)))));
             double x = a * cos(deg2rad(E)) - e;
@@ -68,8 +83,24 @@ namespace
             double yequat = y * cos(deg2rad(oblecl)) + z * sin(deg2rad(oblecl));
             double zequat = y * sin(deg2rad(oblecl)) + z * cos(deg2rad(oblecl));
 
-            double RA_deg = rev(rad2deg(atan2(yequat, xequat)));
-            double DECL_deg = rad2deg(atan2(zequat, sqrt(xequat * xequat + yequat * yequat)));
+            SunSample s;
+            s.RA_deg = rev(rad2deg(atan2(yequat, xequat)));
+            s.DECL_deg = rad2deg(atan2(zequat, sqrt(xequat * xequat + yequat * yequat)));
+            return s;
+        }
+
+        //! Everything that depends on the time of day: the earth's
+        //! rotation and the derived geocentric and ECI positions.
+        CelestialBody assemble(const SunSample& s, double d) const
+        {
+            static const Ellipsoid WGS84;
+
+            double w = 282.9404 + 4.70935E-5 * d;
+            double M = 356.0470 + 0.9856002585 * d;
+            double L = rev(w + rev(M));
+
+            double RA_deg = s.RA_deg;
+            double DECL_deg = s.DECL_deg;
 
             double GMST0_deg = rev(L + 180);
             double UT = d - floor(d);
@@ -136,19 +167,26 @@ namespace
         }
     };
 
+    struct MoonSample
+    {
+        double RA_rad = 0.0;
+        double DECL_rad = 0.0;
+        double r_m = 0.0;
+    };
+
     struct Moon
     {
         // Math: http://www.stjarnhimlen.se/comp/ppcomp.html
         // More: http://www.stjarnhimlen.se/comp/tutorial.html#7
         // Test: http://www.satellite-calculations.com/Satellite/suncalc.htm
         // Test: http://www.timeanddate.com/astronomy/moon/light.html
-        CelestialBody position(const DateTime& dt) const
+
+        //! The slowly varying part of the series: the perturbed lunar
+        //! right ascension, declination, and distance for day number d.
+        MoonSample sample(double d) const
         {
             static const Ellipsoid WGS84;
 
-            // Reference to 1999Dec31.0TDT
-            const double JD_REFTIME = DateTime(1999, 12, 31, 0.0).getJulianDay();
-            double d = dt.getJulianDay() - JD_REFTIME;
             double N = deg2rad(125.1228 - 0.0529538083 * d);  nrad(N);
             double i = deg2rad(5.1454);
             double w = deg2rad(318.0634 + 0.1643573223 * d);  nrad(w);
@@ -240,7 +278,28 @@ namespace
             double RA = atan2(ye, xe); nrad(RA);
             double Decl = atan2(ze, sqrt(xe * xe + ye * ye));
 
-            // finally, adjust for the time of day (rotation of the earth).
+            MoonSample s;
+            s.RA_rad = RA;
+            s.DECL_rad = Decl;
+            // since r (distance to moon) is in "earth radius units", resolve it to meters
+            s.r_m = r * WGS84.semiMajorAxis();
+            return s;
+        }
+
+        //! Everything that depends on the time of day: the earth's
+        //! rotation and the derived geocentric and ECI positions.
+        CelestialBody assemble(const MoonSample& s, double d) const
+        {
+            static const Ellipsoid WGS84;
+
+            double Ms = deg2rad(356.0470 + 0.9856002585 * d); // sun mean anomaly
+            double ws = deg2rad(282.9404 + 4.70935E-5 * d);   // sun longitude of perihelion
+            double Ls = ws + Ms;    nrad(Ls);                 // sun mean longitude
+
+            double RA = s.RA_rad;
+            double Decl = s.DECL_rad;
+
+            // adjust for the time of day (rotation of the earth).
             double UT = 2.0 * M_PI * (d - floor(d));
             //double UT = d - floor(d); // 0..1
             double GMST0 = Ls + deg2rad(180.0); nrad(GMST0);
@@ -253,16 +312,13 @@ namespace
             double earthLon = RA - GMST0 - UT;
             nrad(earthLon);
 
-            // since r (distance to moon) is in "earth radius units", resolve it to meters
-            r *= WGS84.semiMajorAxis();
-
             CelestialBody moon;
 
             moon.rightAscension.set(RA, Units::RADIANS);
             moon.declination.set(Decl, Units::RADIANS);
             moon.latitude.set(earthLat, Units::RADIANS);
             moon.longitude.set(earthLon, Units::RADIANS);
-            moon.altitude.set(r, Units::METERS);
+            moon.altitude.set(s.r_m, Units::METERS);
 
             // geocentric:
             {
@@ -289,6 +345,70 @@ namespace
             return moon;
         }
     };
+
+    // Lazily built lookup tables of sun and moon samples, one table per
+    // day with hourly knots. The expensive part of each series (the
+    // orbital elements and perturbation terms) changes slowly, so
+    // per-frame queries interpolate between two precomputed knots and
+    // only the cheap time-of-day rotation is evaluated exactly. The
+    // tables are shared process-wide since callers routinely construct
+    // throwaway Ephemeris instances.
+    constexpr int KNOTS_PER_DAY = 24;
+
+    std::mutex g_tableMutex;
+    std::map<int, std::array<SunSample, KNOTS_PER_DAY + 1>> g_sunTables;
+    std::map<int, std::array<MoonSample, KNOTS_PER_DAY + 1>> g_moonTables;
+
+    //! Fetches the two knots bracketing day number d from the per-day
+    //! table, building the table on first use, and returns the blend
+    //! factor between them.
+    template<typename TABLES, typename BODY, typename SAMPLE>
+    void getBracketingKnots(TABLES& tables, const BODY& body, double d,
+        SAMPLE& k0, SAMPLE& k1, double& mix)
+    {
+        int day = (int)floor(d);
+        double hours = (d - (double)day) * (double)KNOTS_PER_DAY;
+        int i = std::min((int)hours, KNOTS_PER_DAY - 1);
+        mix = hours - (double)i;
+
+        std::lock_guard<std::mutex> lock(g_tableMutex);
+
+        auto iter = tables.find(day);
+        if (iter == tables.end())
+        {
+            // keep the footprint bounded for long time-lapse sweeps:
+            if (tables.size() > 8)
+                tables.clear();
+
+            auto& table = tables[day];
+            for (int k = 0; k <= KNOTS_PER_DAY; ++k)
+                table[k] = body.sample((double)day + (double)k / (double)KNOTS_PER_DAY);
+            iter = tables.find(day);
+        }
+
+        k0 = iter->second[i];
+        k1 = iter->second[i + 1];
+    }
+
+    //! Interpolates between two angles in degrees along the shorter arc.
+    double lerpAngleDeg(double a, double b, double mix)
+    {
+        double delta = rev(b - a);
+        if (delta > 180.0)
+            delta -= 360.0;
+        return rev(a + delta * mix);
+    }
+
+    //! Interpolates between two angles in radians along the shorter arc.
+    double lerpAngleRad(double a, double b, double mix)
+    {
+        double delta = b - a;
+        while (delta > M_PI) delta -= TWO_PI;
+        while (delta < -M_PI) delta += TWO_PI;
+        double result = a + delta * mix;
+        nrad(result);
+        return result;
+    }
 }
 
 
@@ -298,11 +418,54 @@ namespace
 CelestialBody
 Ephemeris::sunPosition(const DateTime& dt) const
 {
-    return Sun().position(dt);
+    Sun sun;
+    double d = refDay(dt);
+
+    SunSample k0, k1;
+    double mix;
+    getBracketingKnots(g_sunTables, sun, d, k0, k1, mix);
+
+    SunSample s;
+    s.RA_deg = lerpAngleDeg(k0.RA_deg, k1.RA_deg, mix);
+    s.DECL_deg = k0.DECL_deg + (k1.DECL_deg - k0.DECL_deg) * mix;
+
+    return sun.assemble(s, d);
 }
 
 CelestialBody
 Ephemeris::moonPosition(const DateTime& dt) const
 {
-    return Moon().position(dt);
+    Moon moon;
+    double d = refDay(dt);
+
+    MoonSample k0, k1;
+    double mix;
+    getBracketingKnots(g_moonTables, moon, d, k0, k1, mix);
+
+    MoonSample s;
+    s.RA_rad = lerpAngleRad(k0.RA_rad, k1.RA_rad, mix);
+    s.DECL_rad = k0.DECL_rad + (k1.DECL_rad - k0.DECL_rad) * mix;
+    s.r_m = k0.r_m + (k1.r_m - k0.r_m) * mix;
+
+    return moon.assemble(s, d);
+}
+
+void
+Ephemeris::sunPositions(const DateTime* times, CelestialBody* output, std::size_t count) const
+{
+    if (!times || !output)
+        return;
+
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = sunPosition(times[i]);
+}
+
+void
+Ephemeris::moonPositions(const DateTime* times, CelestialBody* output, std::size_t count) const
+{
+    if (!times || !output)
+        return;
+
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = moonPosition(times[i]);
 }
@@ -40,6 +40,22 @@ namespace ROCKY_NAMESPACE
 
         //! Return the moon's position for a given date and time.
         virtual CelestialBody moonPosition(const DateTime& dt) const;
+
+        //! Compute the sun's position for a series of dates and times in
+        //! one call. The positions come from the same interpolation tables
+        //! as sunPosition, so a time-lapse sweep over a narrow time span
+        //! reuses the tables instead of evaluating the full series per step.
+        //! @param times Array of dates and times to evaluate
+        //! @param output Output array; receives one position per input time
+        //! @param count Number of entries in both arrays
+        void sunPositions(const DateTime* times, CelestialBody* output, std::size_t count) const;
+
+        //! Compute the moon's position for a series of dates and times in
+        //! one call, sharing interpolation tables like sunPositions does.
+        //! @param times Array of dates and times to evaluate
+        //! @param output Output array; receives one position per input time
+        //! @param count Number of entries in both arrays
+        void moonPositions(const DateTime* times, CelestialBody* output, std::size_t count) const;
     };
 
 }
@@ -120,6 +120,186 @@ Geometry::contains(double x, double y) const
     }
 }
 
+namespace
+{
+    // Clips a ring against one axis-aligned half-plane (Sutherland-Hodgman).
+    // The clip window is convex, so four of these passes clip a ring
+    // completely; z interpolates along with the clipped edges.
+    void clip_ring_to_halfplane(std::vector<glm::dvec3>& ring, int axis, double limit, bool keep_below)
+    {
+        if (ring.empty())
+            return;
+
+        auto value = [axis](const glm::dvec3& p) { return axis == 0 ? p.x : p.y; };
+        auto inside = [&](const glm::dvec3& p) { return keep_below ? value(p) <= limit : value(p) >= limit; };
+        auto intersect = [&](const glm::dvec3& a, const glm::dvec3& b) {
+                double t = (limit - value(a)) / (value(b) - value(a));
+                return a + t * (b - a);
+            };
+
+        std::vector<glm::dvec3> out;
+        out.reserve(ring.size() + 4);
+
+        for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+        {
+            auto& curr = ring[i];
+            auto& prev = ring[j];
+
+            if (inside(curr))
+            {
+                if (!inside(prev))
+                    out.emplace_back(intersect(prev, curr));
+                out.emplace_back(curr);
+            }
+            else if (inside(prev))
+            {
+                out.emplace_back(intersect(prev, curr));
+            }
+        }
+
+        ring.swap(out);
+    }
+
+    void clip_ring(std::vector<glm::dvec3>& ring, const Rect& window)
+    {
+        clip_ring_to_halfplane(ring, 0, window.xmin, false);
+        clip_ring_to_halfplane(ring, 0, window.xmax, true);
+        clip_ring_to_halfplane(ring, 1, window.ymin, false);
+        clip_ring_to_halfplane(ring, 1, window.ymax, true);
+
+        if (ring.size() < 3)
+            ring.clear();
+    }
+
+    // Clips one polyline segment to the window (Liang-Barsky), returning
+    // false if the segment lies entirely outside
+    bool clip_segment(glm::dvec3& a, glm::dvec3& b, const Rect& window)
+    {
+        double t0 = 0.0, t1 = 1.0;
+        auto d = b - a;
+
+        auto test = [&](double p, double q)
+            {
+                if (p == 0.0)
+                    return q >= 0.0;
+                double r = q / p;
+                if (p < 0.0) {
+                    if (r > t1) return false;
+                    if (r > t0) t0 = r;
+                }
+                else {
+                    if (r < t0) return false;
+                    if (r < t1) t1 = r;
+                }
+                return true;
+            };
+
+        if (!test(-d.x, a.x - window.xmin)) return false;
+        if (!test(d.x, window.xmax - a.x)) return false;
+        if (!test(-d.y, a.y - window.ymin)) return false;
+        if (!test(d.y, window.ymax - a.y)) return false;
+
+        auto start = a;
+        if (t0 > 0.0) a = start + t0 * d;
+        if (t1 < 1.0) b = start + t1 * d;
+        return true;
+    }
+
+    // Clips a polyline to the window, assembling the surviving segments
+    // into contiguous runs (one run per window entry/exit)
+    void clip_linestring(const std::vector<glm::dvec3>& input, const Rect& window,
+        std::vector<std::vector<glm::dvec3>>& runs)
+    {
+        for (std::size_t i = 0; i + 1 < input.size(); ++i)
+        {
+            auto a = input[i], b = input[i + 1];
+            if (!clip_segment(a, b, window))
+                continue;
+
+            if (runs.empty() || runs.back().back() != a)
+            {
+                auto& run = runs.emplace_back();
+                run.emplace_back(a);
+            }
+            runs.back().emplace_back(b);
+        }
+    }
+}
+
+Geometry
+Geometry::clip(const Rect& window) const
+{
+    Geometry result(type);
+
+    switch (type)
+    {
+    case Type::Points:
+        result.points.reserve(points.size());
+        for (auto& p : points)
+        {
+            if (p.x >= window.xmin && p.x <= window.xmax && p.y >= window.ymin && p.y <= window.ymax)
+                result.points.emplace_back(p);
+        }
+        break;
+
+    case Type::LineString:
+    {
+        std::vector<std::vector<glm::dvec3>> runs;
+        clip_linestring(points, window, runs);
+
+        if (runs.size() == 1)
+        {
+            result.points = std::move(runs.front());
+        }
+        else if (runs.size() > 1)
+        {
+            result.type = Type::MultiLineString;
+            for (auto& run : runs)
+                result.parts.emplace_back(Type::LineString).points = std::move(run);
+        }
+        break;
+    }
+
+    case Type::Polygon:
+    {
+        result.points = points;
+        clip_ring(result.points, window);
+
+        if (!result.points.empty())
+        {
+            for (auto& hole : parts)
+            {
+                Geometry clipped_hole(Type::Polygon);
+                clipped_hole.points = hole.points;
+                clip_ring(clipped_hole.points, window);
+                if (!clipped_hole.points.empty())
+                    result.parts.emplace_back(std::move(clipped_hole));
+            }
+        }
+        break;
+    }
+
+    default: // multi types: clip each part, flattening any splits
+        for (auto& part : parts)
+        {
+            auto clipped = part.clip(window);
+
+            if (clipped.parts.size() > 0 && clipped.points.empty() && clipped.type != Type::Polygon)
+            {
+                for (auto& sub : clipped.parts)
+                    result.parts.emplace_back(std::move(sub));
+            }
+            else if (!clipped.points.empty())
+            {
+                result.parts.emplace_back(std::move(clipped));
+            }
+        }
+        break;
+    }
+
+    return result;
+}
+
 bool
 Feature::FieldNameComparator::operator()(const std::string& L, const std::string& R) const
 {
@@ -148,6 +328,187 @@ Feature::dirtyExtent()
     extent = GeoExtent(srs, box);
 }
 
+namespace
+{
+    // 2D distance from p to the segment [a, b]
+    double distance_to_segment_2d(const glm::dvec3& p, const glm::dvec3& a, const glm::dvec3& b)
+    {
+        double dx = b.x - a.x, dy = b.y - a.y;
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0.0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0;
+        t = t < 0.0 ? 0.0 : t > 1.0 ? 1.0 : t;
+        double ex = a.x + t * dx - p.x;
+        double ey = a.y + t * dy - p.y;
+        return std::sqrt(ex * ex + ey * ey);
+    }
+
+    // Douglas-Peucker point reduction, in place. Endpoints always survive.
+    void douglas_peucker(std::vector<glm::dvec3>& points, double tolerance)
+    {
+        if (points.size() < 3)
+            return;
+
+        std::vector<bool> keep(points.size(), false);
+        keep.front() = true, keep.back() = true;
+
+        std::stack<std::pair<std::size_t, std::size_t>> ranges;
+        ranges.emplace(0, points.size() - 1);
+
+        while (!ranges.empty())
+        {
+            auto [first, last] = ranges.top();
+            ranges.pop();
+
+            double max_d = 0.0;
+            std::size_t max_i = first;
+
+            for (std::size_t i = first + 1; i < last; ++i)
+            {
+                double d = distance_to_segment_2d(points[i], points[first], points[last]);
+                if (d > max_d)
+                {
+                    max_d = d;
+                    max_i = i;
+                }
+            }
+
+            if (max_d > tolerance)
+            {
+                keep[max_i] = true;
+                ranges.emplace(first, max_i);
+                ranges.emplace(max_i, last);
+            }
+        }
+
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            if (keep[i])
+                points[out++] = points[i];
+        }
+        points.resize(out);
+    }
+}
+
+void
+Feature::generalize(std::vector<double> tolerances)
+{
+    generalizations.clear();
+
+    if (geometry.type == Geometry::Type::Points || geometry.type == Geometry::Type::MultiPoints)
+        return; // nothing to reduce
+
+    std::sort(tolerances.begin(), tolerances.end());
+
+    for (double tolerance : tolerances)
+    {
+        if (tolerance <= 0.0)
+            continue;
+
+        auto& level = generalizations.emplace_back();
+        level.tolerance = tolerance;
+        level.geometry = geometry;
+
+        Geometry::iterator<Geometry> iter(level.geometry);
+        while (iter.hasMore())
+        {
+            douglas_peucker(iter.next().points, tolerance);
+        }
+    }
+}
+
+const Geometry&
+Feature::geometryForTolerance(double tolerance) const
+{
+    const Geometry* best = &geometry;
+
+    for (auto& level : generalizations)
+    {
+        if (level.tolerance <= tolerance)
+            best = &level.geometry;
+        else
+            break; // levels are sorted finest to coarsest
+    }
+    return *best;
+}
+
+bool
+Feature::splitAcrossAntimeridian()
+{
+    if (!srs.isGeodetic())
+        return false;
+
+    if (geometry.type == Geometry::Type::Points || geometry.type == Geometry::Type::MultiPoints)
+        return false;
+
+    // a segment spanning more than half the world indicates a crossing:
+    bool crosses = false;
+    Geometry::const_iterator detect(geometry);
+    while (detect.hasMore() && !crosses)
+    {
+        auto& points = detect.next().points;
+        for (std::size_t i = 0; i + 1 < points.size() && !crosses; ++i)
+        {
+            if (std::abs(points[i + 1].x - points[i].x) > 180.0)
+                crosses = true;
+        }
+    }
+
+    if (!crosses)
+        return false;
+
+    // unwrap the western longitudes so the geometry is contiguous in
+    // [0..360), then clip out each side of the antimeridian:
+    Geometry unwrapped = geometry;
+    Geometry::iterator<Geometry> unwrap(unwrapped);
+    while (unwrap.hasMore())
+    {
+        for (auto& p : unwrap.next().points)
+        {
+            if (p.x < 0.0)
+                p.x += 360.0;
+        }
+    }
+
+    auto east = unwrapped.clip(Rect(0.0, -90.0, 180.0, 90.0));
+
+    auto west = unwrapped.clip(Rect(180.0, -90.0, 360.0, 90.0));
+    Geometry::iterator<Geometry> rewrap(west);
+    while (rewrap.hasMore())
+    {
+        for (auto& p : rewrap.next().points)
+        {
+            p.x -= 360.0;
+        }
+    }
+
+    // combine both halves under the corresponding multi type:
+    Geometry combined(
+        geometry.type == Geometry::Type::LineString ? Geometry::Type::MultiLineString :
+        geometry.type == Geometry::Type::Polygon ? Geometry::Type::MultiPolygon :
+        geometry.type);
+
+    auto append = [&combined](Geometry&& half)
+        {
+            if (half.type == combined.type && half.points.empty())
+            {
+                for (auto& part : half.parts)
+                    combined.parts.emplace_back(std::move(part));
+            }
+            else if (!half.points.empty())
+            {
+                combined.parts.emplace_back(std::move(half));
+            }
+        };
+
+    append(std::move(east));
+    append(std::move(west));
+
+    geometry = std::move(combined);
+    dirtyExtent();
+    return true;
+}
+
 #ifdef ROCKY_HAS_GDAL
 
 namespace
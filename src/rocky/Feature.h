@@ -106,6 +106,15 @@ namespace ROCKY_NAMESPACE
         //! Attempt to convert this geometry to a different type
         void convertToType(Type type);
 
+        //! Clip this geometry to an axis-aligned window in a single pass,
+        //! returning the result. Rings clip with Sutherland-Hodgman (the
+        //! window is convex, so four half-plane passes suffice) and lines
+        //! with Liang-Barsky, so a LineString that exits and re-enters the
+        //! window comes back as a MultiLineString. An empty result has no
+        //! points and no parts.
+        //! @param window Clip window, in the same units as the points
+        Geometry clip(const Rect& window) const;
+
         //! Weather the point is contained in the 2D geometry.
         //! Only applicable to polygons
         bool contains(double x, double y) const;
@@ -241,6 +250,36 @@ namespace ROCKY_NAMESPACE
         }
 
         void dirtyExtent();
+
+        //! One precomputed generalization of the feature's geometry
+        struct Generalization
+        {
+            double tolerance = 0.0; // simplification tolerance, in SRS units
+            Geometry geometry;
+        };
+
+        //! Precomputed generalization levels, finest to coarsest (see generalize)
+        std::vector<Generalization> generalizations;
+
+        //! Precompute generalized copies of the geometry at the given
+        //! simplification tolerances (in the feature's SRS units), using
+        //! Douglas-Peucker point reduction on each line or ring part.
+        //! Call once after loading; geometryForTolerance() then selects
+        //! the best level for a given view.
+        void generalize(std::vector<double> tolerances);
+
+        //! The coarsest precomputed generalization whose tolerance does not
+        //! exceed the given value, or the full-resolution geometry if there
+        //! is none (or if tolerance is zero or less)
+        const Geometry& geometryForTolerance(double tolerance) const;
+
+        //! If this is a geodetic feature whose geometry crosses the
+        //! antimeridian, split it into east and west halves (promoting the
+        //! geometry to the corresponding Multi type) so each half is
+        //! contiguous in longitude. Latitudes clamp to the poles as part
+        //! of the clip. Recomputes the extent when a split occurs.
+        //! @return true if the feature was modified
+        bool splitAcrossAntimeridian();
     };
 
     /**
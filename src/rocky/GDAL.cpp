@@ -28,6 +28,37 @@ namespace ROCKY_NAMESPACE
 {
     namespace detail
     {
+        // Scopes GDAL's network timeouts to the operation's remaining
+        // time budget (thread-local, so concurrent reads don't fight).
+        // GDAL cannot be preempted mid-read, but /vsicurl/-backed
+        // datasets honor GDAL_HTTP_TIMEOUT, which keeps a hung network
+        // filesystem read from holding a worker past its deadline.
+        struct ScopedHttpTimeout
+        {
+            bool engaged = false;
+
+            ScopedHttpTimeout(const IOOptions& io)
+            {
+                if (io.deadline.has_value())
+                {
+                    auto remaining = io.timeRemaining(std::chrono::milliseconds(0));
+                    auto seconds = std::to_string(std::max<long long>(1, (remaining.count() + 999) / 1000));
+                    CPLSetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", seconds.c_str());
+                    CPLSetThreadLocalConfigOption("GDAL_HTTP_CONNECTTIMEOUT", seconds.c_str());
+                    engaged = true;
+                }
+            }
+
+            ~ScopedHttpTimeout()
+            {
+                if (engaged)
+                {
+                    CPLSetThreadLocalConfigOption("GDAL_HTTP_TIMEOUT", nullptr);
+                    CPLSetThreadLocalConfigOption("GDAL_HTTP_CONNECTTIMEOUT", nullptr);
+                }
+            }
+        };
+
         // From easyrgb.com
         inline float Hue_2_RGB(float v1, float v2, float vH)
         {
@@ -144,6 +175,54 @@ namespace ROCKY_NAMESPACE
             }
         }
 
+        // Explicitly selects the overview (pyramid) level whose resolution
+        // best matches the requested decimation, rescaling the pixel window
+        // into that level's coordinates. GDAL does this internally for
+        // simple datasets, but being explicit also covers bands behind
+        // VRTs where the automatic path can fall back to the base level.
+        inline GDALRasterBand* selectOverview(
+            GDALRasterBand* band,
+            double& nXOff, double& nYOff, double& nXSize, double& nYSize,
+            int nBufXSize, int nBufYSize)
+        {
+            if (band->GetOverviewCount() == 0 ||
+                nXSize <= (double)nBufXSize ||
+                nYSize <= (double)nBufYSize)
+            {
+                return band;
+            }
+
+            // how much coarser than the base level may the data be:
+            double targetRatio = std::min(
+                nXSize / (double)nBufXSize,
+                nYSize / (double)nBufYSize);
+
+            // pick the coarsest overview still at or above the target resolution:
+            GDALRasterBand* best = band;
+            double bestRatio = 1.0;
+
+            for (int i = 0; i < band->GetOverviewCount(); ++i)
+            {
+                GDALRasterBand* ovr = band->GetOverview(i);
+                double ratio = (double)band->GetXSize() / (double)ovr->GetXSize();
+                if (ratio <= targetRatio && ratio > bestRatio)
+                {
+                    best = ovr;
+                    bestRatio = ratio;
+                }
+            }
+
+            if (best != band)
+            {
+                double sx = (double)best->GetXSize() / (double)band->GetXSize();
+                double sy = (double)best->GetYSize() / (double)band->GetYSize();
+                nXOff *= sx, nXSize *= sx;
+                nYOff *= sy, nYSize *= sy;
+            }
+
+            return best;
+        }
+
         // GDALRasterBand::RasterIO helper method
         inline bool rasterIO(
             GDALRasterBand *band,
@@ -160,6 +239,12 @@ namespace ROCKY_NAMESPACE
             GSpacing nLineSpace,
             Interpolation interpolation = Interpolation::NEAREST)
         {
+            // read decimated data from the best-fitting pyramid level:
+            if (eRWFlag == GF_Read)
+            {
+                band = selectOverview(band, nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize);
+            }
+
             GDALRasterIOExtraArg psExtraArg;
 
             // defaults to GRIORA_NearestNeighbour
@@ -220,6 +305,92 @@ namespace ROCKY_NAMESPACE
 
             return (err == CE_None);
         }
+
+        // GDALDataset::RasterIO helper: reads several bands with a single
+        // call, into band-sequential planes, so the driver traverses the
+        // raster blocks once instead of once per band.
+        inline bool rasterIOMulti(
+            GDALDataset* ds,
+            const std::vector<GDALRasterBand*>& bands,
+            double nXOff,
+            double nYOff,
+            double nXSize,
+            double nYSize,
+            void* pData,
+            int nBufXSize,
+            int nBufYSize,
+            GDALDataType eBufType,
+            Interpolation interpolation = Interpolation::NEAREST)
+        {
+            GDALRasterIOExtraArg psExtraArg;
+
+            // defaults to GRIORA_NearestNeighbour
+            INIT_RASTERIO_EXTRA_ARG(psExtraArg);
+
+            switch (interpolation)
+            {
+            case Interpolation::AVERAGE:
+                // see rasterIO() above for why this is not GRIORA_Average
+                psExtraArg.eResampleAlg = GRIORA_Bilinear;
+                break;
+            case Interpolation::BILINEAR:
+                psExtraArg.eResampleAlg = GRIORA_Bilinear;
+                break;
+            case Interpolation::CUBIC:
+                psExtraArg.eResampleAlg = GRIORA_Cubic;
+                break;
+            case Interpolation::CUBICSPLINE:
+                psExtraArg.eResampleAlg = GRIORA_CubicSpline;
+                break;
+            }
+
+            psExtraArg.bFloatingPointWindowValidity = TRUE;
+            psExtraArg.dfXOff = nXOff;
+            psExtraArg.dfYOff = nYOff;
+            psExtraArg.dfXSize = nXSize;
+            psExtraArg.dfYSize = nYSize;
+
+            std::vector<int> bandMap;
+            bandMap.reserve(bands.size());
+            for (auto* band : bands)
+                bandMap.push_back(band->GetBand());
+
+            GSpacing bandSpace = (GSpacing)nBufXSize * (GSpacing)nBufYSize * GDALGetDataTypeSizeBytes(eBufType);
+
+            CPLErr err = ds->RasterIO(GF_Read, (int)nXOff, (int)nYOff, (int)ceil(nXSize), (int)ceil(nYSize),
+                pData, nBufXSize, nBufYSize, eBufType,
+                (int)bands.size(), bandMap.data(), 0, 0, bandSpace, &psExtraArg);
+
+            if (err != CE_None)
+            {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < bands.size(); ++i)
+            {
+                double scale = bands[i]->GetScale();
+                double offset = bands[i]->GetOffset();
+
+                if (scale != 1.0 || offset != 0.0)
+                {
+                    int count = nBufXSize * nBufYSize;
+                    void* plane = (unsigned char*)pData + (std::size_t)bandSpace * i;
+
+                    if (eBufType == GDT_Float32)
+                        applyScaleAndOffset<float>(plane, count, scale, offset);
+                    else if (eBufType == GDT_Float64)
+                        applyScaleAndOffset<double>(plane, count, scale, offset);
+                    else if (eBufType == GDT_Int16 || eBufType == GDT_UInt16)
+                        applyScaleAndOffset<short>(plane, count, scale, offset);
+                    else if (eBufType == GDT_Int32 || eBufType == GDT_UInt32)
+                        applyScaleAndOffset<int>(plane, count, scale, offset);
+                    else if (eBufType == GDT_Byte)
+                        applyScaleAndOffset<char>(plane, count, scale, offset);
+                }
+            }
+
+            return true;
+        }
     }
 
     namespace GDAL
@@ -350,14 +521,86 @@ namespace ROCKY_NAMESPACE
 
 //...................................................................
 
+namespace
+{
+    // All drivers with open dataset handles, coldest first. Keeping every
+    // warped VRT open forever does not scale to a mosaic with dozens of
+    // layers paged by a dozen threads, so we cap the number of open
+    // handles; the coldest drivers close theirs and reopen lazily on
+    // their next read.
+    std::mutex g_handleLRUMutex;
+    std::vector<GDAL::Driver*> g_handleLRU;
+
+    int maxOpenDatasets()
+    {
+        static int value = std::max(8,
+            util::as<int>(util::getEnvVar("ROCKY_GDAL_MAX_OPEN_DATASETS"), 512));
+        return value;
+    }
+}
+
 GDAL::Driver::~Driver()
 {
     //Log()->info("GDAL::Driver::~Driver, _warped={}, _src={}", (std::uintptr_t)_warpedDS, (std::uintptr_t)_srcDS);
 
+    removeFromHandleLRU();
+
+    if (_warpedDS)
+        GDALClose(_warpedDS);
+    else if (_srcDS)
+        GDALClose(_srcDS);
+}
+
+// Closes the dataset handles but keeps the configuration, so the driver
+// can reopen on its next read. The caller is responsible for the LRU entry.
+void
+GDAL::Driver::closeHandles()
+{
     if (_warpedDS)
         GDALClose(_warpedDS);
     else if (_srcDS)
         GDALClose(_srcDS);
+
+    _warpedDS = nullptr;
+    _srcDS = nullptr;
+    _open = false;
+}
+
+void
+GDAL::Driver::touchHandleLRU()
+{
+    std::scoped_lock lock(g_handleLRUMutex);
+
+    auto it = std::find(g_handleLRU.begin(), g_handleLRU.end(), this);
+    if (it != g_handleLRU.end())
+        g_handleLRU.erase(it);
+    g_handleLRU.push_back(this);
+
+    // Over the cap? Evict the coldest drivers, skipping any that are
+    // mid-read (try_lock fails) and any wrapping an external dataset
+    // we cannot reopen.
+    for (auto i = g_handleLRU.begin();
+        i != g_handleLRU.end() && (int)g_handleLRU.size() > maxOpenDatasets(); )
+    {
+        GDAL::Driver* victim = *i;
+        if (victim != this && !victim->_external && victim->_handleMutex.try_lock())
+        {
+            victim->closeHandles();
+            victim->_handleMutex.unlock();
+            i = g_handleLRU.erase(i);
+        }
+        else ++i;
+    }
+}
+
+void
+GDAL::Driver::removeFromHandleLRU()
+{
+    std::scoped_lock lock(g_handleLRUMutex);
+
+    auto it = std::find(g_handleLRU.begin(), g_handleLRU.end(), this);
+    if (it != g_handleLRU.end())
+        g_handleLRU.erase(it);
 }
 
 // Open the data source and prepare it for reading
@@ -464,6 +707,38 @@ GDAL::Driver::open(
         _srcDS = _external->dataset;
     }
 
+    // Optionally build overview pyramids if the source has none, so that
+    // low-LOD tiles can read from a matching level instead of decimating
+    // the full-resolution raster. This mutates the dataset (or writes a
+    // sidecar .ovr), so only one driver at a time attempts it; later
+    // threads just see the finished levels.
+    if (layer->buildOverviews.has_value(true) && useExternalDataset == false)
+    {
+        GDALRasterBand* band1 = _srcDS->GetRasterBand(1);
+        if (band1 && band1->GetOverviewCount() == 0)
+        {
+            static std::mutex s_buildOverviewsMutex;
+            std::scoped_lock buildLock(s_buildOverviewsMutex);
+
+            if (band1->GetOverviewCount() == 0)
+            {
+                std::vector<int> decimations;
+                int maxDim = std::max(_srcDS->GetRasterXSize(), _srcDS->GetRasterYSize());
+                for (int d = 2; maxDim / d >= (int)tileSize; d *= 2)
+                    decimations.push_back(d);
+
+                if (!decimations.empty())
+                {
+                    if (_srcDS->BuildOverviews("AVERAGE", (int)decimations.size(), decimations.data(),
+                        0, nullptr, nullptr, nullptr) != CE_None)
+                    {
+                        Log()->warn(LC "Failed to build overviews (is the dataset writable?)");
+                    }
+                }
+            }
+        }
+    }
+
     // Establish the source spatial reference:
     SRS src_srs;
 
@@ -692,6 +967,9 @@ GDAL::Driver::open(
     _linearUnits = 1.0; // srs.getReportedLinearUnits();
 
     _open = true;
+
+    touchHandleLRU();
+
     return StatusOK;
 }
 
@@ -784,6 +1062,18 @@ GDAL::Driver::intersects(const TileKey& key)
     return key.extent().intersects(_extents);
 }
 
+namespace
+{
+    // per-thread plane/scanline workspaces for createImage, reused
+    // across reads so a steady panning workload costs zero heap
+    // allocations per tile. (The warp machinery itself is already
+    // thread-affine: each worker thread holds its own Driver, whose
+    // warped VRT is built once at open and touched via the handle LRU.)
+    thread_local std::vector<unsigned char> s_byteWorkspace;
+    thread_local std::vector<short> s_int16Workspace;
+    thread_local std::vector<float> s_float32Workspace;
+}
+
 Result<std::shared_ptr<Image>>
 GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions& io)
 {
@@ -797,6 +1087,21 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
         return Status(Status::ResourceUnavailable);
     }
 
+    detail::ScopedHttpTimeout httpTimeout(io);
+
+    // serialize this read against any LRU eviction, and reopen the
+    // dataset handles if an eviction closed them:
+    std::scoped_lock lock(_handleMutex);
+
+    if (!_open && _layer != nullptr)
+    {
+        Status reopen = open(_name, _layer, tileSize, nullptr, io);
+        if (reopen.failed())
+            return reopen;
+    }
+
+    touchHandleLRU();
+
     std::shared_ptr<Image> image;
 
     const bool invert = true;
@@ -924,26 +1229,27 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
 
     if (bandRed && bandGreen && bandBlue)
     {
-        unsigned char *red = new unsigned char[target_width * target_height];
-        unsigned char *green = new unsigned char[target_width * target_height];
-        unsigned char *blue = new unsigned char[target_width * target_height];
-        unsigned char *alpha = new unsigned char[target_width * target_height];
+        std::size_t planeSize = (std::size_t)target_width * target_height;
+        s_byteWorkspace.resize(planeSize * 4);
+        unsigned char* planes = s_byteWorkspace.data();
+        unsigned char* red = planes;
+        unsigned char* green = planes + planeSize;
+        unsigned char* blue = planes + planeSize * 2;
+        unsigned char* alpha = planes + planeSize * 3;
 
         //Initialize the alpha values to 255.
-        memset(alpha, 255, target_width * target_height);
+        memset(alpha, 255, planeSize);
 
         image = Image::create(pixelFormat, tileSize, tileSize);
 
         memset(image->data<char>(), 0, image->sizeInBytes());
 
-        detail::rasterIO(bandRed, GF_Read, src_min_x, src_min_y, src_width, src_height, red, target_width, target_height, GDT_Byte, 0, 0, _layer->interpolation);
-        detail::rasterIO(bandGreen, GF_Read, src_min_x, src_min_y, src_width, src_height, green, target_width, target_height, GDT_Byte, 0, 0, _layer->interpolation);
-        detail::rasterIO(bandBlue, GF_Read, src_min_x, src_min_y, src_width, src_height, blue, target_width, target_height, GDT_Byte, 0, 0, _layer->interpolation);
-
+        // one dataset-level read for all the color bands:
+        std::vector<GDALRasterBand*> bands = { bandRed, bandGreen, bandBlue };
         if (bandAlpha)
-        {
-            detail::rasterIO(bandAlpha, GF_Read, src_min_x, src_min_y, src_width, src_height, alpha, target_width, target_height, GDT_Byte, 0, 0, _layer->interpolation);
-        }
+            bands.push_back(bandAlpha);
+
+        detail::rasterIOMulti(_warpedDS, bands, src_min_x, src_min_y, src_width, src_height, planes, target_width, target_height, GDT_Byte, _layer->interpolation);
 
         for (int src_row = 0, dst_row = tile_offset_top;
             src_row < target_height;
@@ -968,11 +1274,6 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
                 image->write(c, dst_col, flippedRow);
             }
         }
-
-        delete[] red;
-        delete[] green;
-        delete[] blue;
-        delete[] alpha;
     }
 
     else if (bandGray)
@@ -1004,7 +1305,8 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
             
             if (gdalDataType == GDT_Int16)
             {
-                short* temp = new short[target_width * target_height];
+                s_int16Workspace.resize((std::size_t)target_width * target_height);
+                short* temp = s_int16Workspace.data();
 
                 detail::rasterIO(bandGray, GF_Read, src_min_x, src_min_y, src_width, src_height, temp, target_width, target_height, gdalDataType, 0, 0, _layer->interpolation);
 
@@ -1023,12 +1325,11 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
                         image->write(c, dst_col, flippedRow);
                     }
                 }
-
-                delete[] temp;
             }
             else // if (gdalDataType == GDT_Float32)
             {
-                float* temp = new float[target_width * target_height];
+                s_float32Workspace.resize((std::size_t)target_width * target_height);
+                float* temp = s_float32Workspace.data();
 
                 detail::rasterIO(bandGray, GF_Read, src_min_x, src_min_y, src_width, src_height, temp, target_width, target_height, gdalDataType, 0, 0, _layer->interpolation);
 
@@ -1047,8 +1348,6 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
                         image->write(c, dst_col, flippedRow);
                     }
                 }
-
-                delete[] temp;
             }
         }
         
@@ -1057,23 +1356,25 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
             image = Image::create(Image::R8G8B8A8_UNORM, tileSize, tileSize);
             image->fill(glm::fvec4(0));
 
-            unsigned char* gray = new unsigned char[target_width * target_height];
+            std::size_t planeSize = (std::size_t)target_width * target_height;
+            s_byteWorkspace.resize(planeSize * (bandAlpha ? 2 : 1));
+            unsigned char* planes = s_byteWorkspace.data();
+            unsigned char* gray = planes;
 
             // color only:
             unsigned char* alpha = nullptr;
             if (bandAlpha)
             {
-                alpha = new unsigned char[target_width * target_height];
-                memset(alpha, 255, target_width * target_height);
+                alpha = planes + planeSize;
+                memset(alpha, 255, planeSize);
             }
 
-            detail::rasterIO(bandGray, GF_Read, src_min_x, src_min_y, src_width, src_height, gray, target_width, target_height, GDT_Byte, 0, 0, _layer->interpolation);
-
-            // color only:
+            // gray and alpha fetched with a single dataset-level read:
+            std::vector<GDALRasterBand*> bands = { bandGray };
             if (bandAlpha)
-            {
-                detail::rasterIO(bandAlpha, GF_Read, src_min_x, src_min_y, src_width, src_height, alpha, target_width, target_height, GDT_Byte, 0, 0, _layer->interpolation);
-            }
+                bands.push_back(bandAlpha);
+
+            detail::rasterIOMulti(_warpedDS, bands, src_min_x, src_min_y, src_width, src_height, planes, target_width, target_height, GDT_Byte, _layer->interpolation);
 
             for (int src_row = 0, dst_row = tile_offset_top;
                 src_row < target_height;
@@ -1100,9 +1401,6 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
                     image->write(c, dst_col, flippedRow);
                 }
             }
-
-            if (gray) delete[] gray;
-            if (alpha) delete[] alpha;
         }
     }
 
@@ -1110,7 +1408,8 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
     {
         //Palette indexed imagery doesn't support interpolation currently and only uses nearest
         //b/c interpolating palette indexes doesn't make sense.
-        unsigned char *palette = new unsigned char[target_width * target_height];
+        s_byteWorkspace.resize((std::size_t)target_width * target_height);
+        unsigned char* palette = s_byteWorkspace.data();
         image = Image::create(pixelFormat, tileSize, tileSize);
         memset(image->data<unsigned char>(), 0, image->sizeInBytes());
 
@@ -1149,9 +1448,6 @@ GDAL::Driver::createImage(const TileKey& key, unsigned tileSize, const IOOptions
                 image->write(fcolor, dst_col, flippedRow);
             }
         }
-
-        delete[] palette;
-
     }
     else
     {
@@ -1453,6 +1749,21 @@ GDAL::Driver::createHeightfield(const TileKey& key, unsigned tileSize, const IOO
         return Status(Status::ResourceUnavailable);
     }
 
+    detail::ScopedHttpTimeout httpTimeout(io);
+
+    // serialize this read against any LRU eviction, and reopen the
+    // dataset handles if an eviction closed them:
+    std::scoped_lock lock(_handleMutex);
+
+    if (!_open && _layer != nullptr)
+    {
+        Status reopen = open(_name, _layer, tileSize, nullptr, io);
+        if (reopen.failed())
+            return reopen;
+    }
+
+    touchHandleLRU();
+
     std::shared_ptr<Heightfield> hf;
 
     const bool invert = true;
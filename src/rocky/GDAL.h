@@ -12,6 +12,7 @@
 #include <rocky/Image.h>
 #include <rocky/GeoExtent.h>
 #include <rocky/TileKey.h>
+#include <mutex>
 
 class GDALDataset;
 class GDALRasterBand;
@@ -47,6 +48,11 @@ namespace ROCKY_NAMESPACE
             //! Interpolation method for resampling (default is average)
             option<Interpolation> interpolation = Interpolation::AVERAGE;
 
+            //! Whether to build overview (pyramid) levels at open time if the
+            //! source dataset has none. Low-LOD tiles read from the matching
+            //! overview instead of decimating the base resolution.
+            option<bool> buildOverviews = false;
+
         protected:
             option<bool> singleThreaded = false;
         };
@@ -72,6 +78,7 @@ namespace ROCKY_NAMESPACE
             Driver(const Driver&) = delete;
 
             Driver(Driver&& rhs) noexcept {
+                rhs.removeFromHandleLRU();
                 _srcDS = rhs._srcDS;
                 _warpedDS = rhs._warpedDS;
                 _linearUnits = rhs._linearUnits;
@@ -88,6 +95,8 @@ namespace ROCKY_NAMESPACE
                 rhs._profile = {};
                 rhs._layer = nullptr;
                 rhs._external = nullptr;
+                if (_open)
+                    touchHandleLRU();
             }
 
             Driver& operator=(Driver&& rhs) noexcept = delete;
@@ -128,6 +137,18 @@ namespace ROCKY_NAMESPACE
             bool _open = false;
             GDALDataset* _srcDS = nullptr;
             GDALDataset* _warpedDS = nullptr;
+
+            // Open dataset handles live in a process-wide LRU; when the
+            // number of open handles exceeds the cap (see
+            // ROCKY_GDAL_MAX_OPEN_DATASETS) the coldest drivers close
+            // their datasets and reopen lazily on the next read. The
+            // mutex serializes a read against an eviction; it is
+            // uncontended on the normal per-thread read path.
+            mutable std::mutex _handleMutex;
+            void closeHandles();
+            void touchHandleLRU();
+            void removeFromHandleLRU();
+
             double _linearUnits = 1.0;
             double _geotransform[6];
             double _invtransform[6];
@@ -81,6 +81,7 @@ GDALElevationLayer::construct(const std::string& JSON, const IOOptions& io)
     if (temp == "nearest") interpolation = Interpolation::NEAREST;
     else if (temp == "bilinear") interpolation = Interpolation::BILINEAR;
     get_to(j, "single_threaded", singleThreaded);
+    get_to(j, "build_overviews", buildOverviews);
 
     // default for GDAL elevation is nearest-neighbor.
     if (!interpolation.has_value())
@@ -103,6 +104,7 @@ GDALElevationLayer::to_json() const
     else if (interpolation.has_value(Interpolation::BILINEAR))
         set(j, "interpolation", "bilinear");
     set(j, "single_threaded", singleThreaded);
+    set(j, "build_overviews", buildOverviews);
     return j.dump();
 }
 
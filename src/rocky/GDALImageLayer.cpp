@@ -80,6 +80,7 @@ GDALImageLayer::construct(const std::string& JSON, const IOOptions& io)
     if (temp == "nearest") interpolation = Interpolation::NEAREST;
     else if (temp == "bilinear") interpolation = Interpolation::BILINEAR;
     get_to(j, "single_threaded", singleThreaded);
+    get_to(j, "build_overviews", buildOverviews);
 
     setRenderType(RenderType::TERRAIN_SURFACE);
 }
@@ -96,6 +97,7 @@ GDALImageLayer::to_json() const
     else if (interpolation.has_value(Interpolation::BILINEAR))
         set(j, "interpolation", "bilinear");
     set(j, "single_threaded", singleThreaded);
+    set(j, "build_overviews", buildOverviews);
     return j.dump();
 }
 
@@ -248,7 +248,7 @@ namespace
         // TODO: rethink this to be more generic.
         if (fromSRS.isGeodetic() && !toSRS.isGeodetic())
         {
-            auto to_geo = toSRS.to(fromSRS);
+            const auto& to_geo = toSRS.cachedTo(fromSRS);
             Box b = toSRS.bounds(); // long,lat degrees
             glm::dvec3 min(b.xmin, b.ymin, 0);
             glm::dvec3 max(b.xmax, b.ymax, 0);
@@ -311,7 +311,7 @@ namespace
             v.push_back(glm::dvec3(in_out_xmin + dWidth * (double)i, in_out_ymin, 0));
         }
 
-        auto xform = fromSRS.to(toSRS);
+        const auto& xform = fromSRS.cachedTo(toSRS);
 
         if (xform.transformRange(v.begin(), v.end()))
         {
@@ -416,7 +416,7 @@ GeoExtent::contains(double x, double y, const SRS& xy_srs) const
     if (xy_srs.valid() && xy_srs != srs())
     {
         glm::dvec3 temp(x, y, 0);
-        if (xy_srs.to(srs()).transform(temp, temp))
+        if (xy_srs.cachedTo(srs()).transform(temp, temp))
             return contains(temp.x, temp.y, SRS::EMPTY);
         else
             return false;
@@ -558,7 +558,7 @@ GeoExtent::computeBoundingGeoCircle() const
                 glm::dvec3(west(), north(), 0.0)
             };
             
-            srs().to(SRS::ECEF).transformRange(p.begin(), p.end());
+            srs().cachedTo(SRS::ECEF).transformRange(p.begin(), p.end());
             
             double radius2 = lengthSquared(p[0] - p[1]);
             radius2 = std::max(radius2, lengthSquared(p[0] - p[2]));
@@ -1001,7 +1001,7 @@ GeoExtent::createWorldBoundingSphere(double minElev, double maxElev) const
         }
 
         // transform to world coords:
-        auto to_world = srs().to(SRS::ECEF);
+        const auto& to_world = srs().cachedTo(SRS::ECEF);
         to_world.transformRange(samplePoints.begin(), samplePoints.end());
 
         // Compute the bounding box of the sample points
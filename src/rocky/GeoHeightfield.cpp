@@ -1,6 +1,7 @@
 #include "GeoHeightfield.h"
 #include "Heightfield.h"
 #include "Math.h"
+#include "weejobs.h"
 
 using namespace ROCKY_NAMESPACE;
 
@@ -22,6 +23,7 @@ GeoHeightfield::operator=(GeoHeightfield&& rhs) noexcept
     {
         _hf = std::move(rhs._hf);
         _extent = std::move(rhs._extent);
+        _minMaxPyramid = std::move(rhs._minMaxPyramid);
         _minHeight = rhs._minHeight;
         _maxHeight = rhs._maxHeight;
         _resolution = rhs._resolution;
@@ -66,6 +68,116 @@ GeoHeightfield::init()
     }
 }
 
+void
+GeoHeightfield::generateMinMaxPyramid()
+{
+    if (!_hf)
+        return;
+
+    auto pyramid = std::make_shared<MinMaxPyramid>();
+
+    // base level: each cell reduces a 2x2 block of samples.
+    // cells with no valid samples stay at (FLT_MAX, -FLT_MAX) and
+    // naturally fail any range test.
+    MinMaxPyramid::Level base;
+    base.width = std::max(1u, (_hf->width() + 1) / 2);
+    base.height = std::max(1u, (_hf->height() + 1) / 2);
+    base.cells.assign(base.width * base.height, glm::fvec2(FLT_MAX, -FLT_MAX));
+
+    for (unsigned row = 0; row < _hf->height(); ++row)
+    {
+        for (unsigned col = 0; col < _hf->width(); ++col)
+        {
+            float h = _hf->heightAt(col, row);
+            if (h != NO_DATA_VALUE)
+            {
+                auto& cell = base.cells[(row / 2) * base.width + (col / 2)];
+                cell.x = std::min(cell.x, h);
+                cell.y = std::max(cell.y, h);
+            }
+        }
+    }
+
+    pyramid->levels.emplace_back(std::move(base));
+
+    // each successive level reduces a 2x2 block of cells:
+    while (pyramid->levels.back().width > 1 || pyramid->levels.back().height > 1)
+    {
+        auto& prev = pyramid->levels.back();
+
+        MinMaxPyramid::Level next;
+        next.width = std::max(1u, (prev.width + 1) / 2);
+        next.height = std::max(1u, (prev.height + 1) / 2);
+        next.cells.assign(next.width * next.height, glm::fvec2(FLT_MAX, -FLT_MAX));
+
+        for (unsigned r = 0; r < prev.height; ++r)
+        {
+            for (unsigned c = 0; c < prev.width; ++c)
+            {
+                auto& src = prev.cells[r * prev.width + c];
+                auto& dst = next.cells[(r / 2) * next.width + (c / 2)];
+                dst.x = std::min(dst.x, src.x);
+                dst.y = std::max(dst.y, src.y);
+            }
+        }
+
+        pyramid->levels.emplace_back(std::move(next));
+    }
+
+    _minMaxPyramid = pyramid;
+}
+
+glm::fvec2
+GeoHeightfield::minMaxHeight(double xmin, double ymin, double xmax, double ymax) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid(), glm::fvec2(NO_DATA_VALUE, NO_DATA_VALUE));
+
+    if (!_minMaxPyramid || _minMaxPyramid->levels.empty())
+    {
+        return glm::fvec2(_minHeight, _maxHeight);
+    }
+
+    // convert the query rect to an inclusive sample range:
+    double maxcol = (double)(_hf->width() - 1);
+    double maxrow = (double)(_hf->height() - 1);
+    unsigned col0 = (unsigned)clamp(std::floor((xmin - _extent.xmin()) / _resolution.x), 0.0, maxcol);
+    unsigned col1 = (unsigned)clamp(std::ceil((xmax - _extent.xmin()) / _resolution.x), 0.0, maxcol);
+    unsigned row0 = (unsigned)clamp(std::floor((ymin - _extent.ymin()) / _resolution.y), 0.0, maxrow);
+    unsigned row1 = (unsigned)clamp(std::ceil((ymax - _extent.ymin()) / _resolution.y), 0.0, maxrow);
+
+    // pick the level whose cells are at least as large as the query span,
+    // so at most a 2x2 block of cells covers it:
+    unsigned span = std::max(col1 - col0, row1 - row0);
+    unsigned level = 0;
+    unsigned cellSize = 2;
+    while (cellSize < span && level + 1 < _minMaxPyramid->levels.size())
+    {
+        cellSize <<= 1;
+        ++level;
+    }
+
+    auto& cells = _minMaxPyramid->levels[level];
+
+    glm::fvec2 result(FLT_MAX, -FLT_MAX);
+    for (unsigned r = row0 / cellSize; r <= row1 / cellSize && r < cells.height; ++r)
+    {
+        for (unsigned c = col0 / cellSize; c <= col1 / cellSize && c < cells.width; ++c)
+        {
+            auto& cell = cells.cells[r * cells.width + c];
+            result.x = std::min(result.x, cell.x);
+            result.y = std::max(result.y, cell.y);
+        }
+    }
+
+    if (result.x > result.y)
+    {
+        // no valid samples in range
+        return glm::fvec2(NO_DATA_VALUE, NO_DATA_VALUE);
+    }
+
+    return result;
+}
+
 float
 GeoHeightfield::heightAtLocation(
     double x,
@@ -135,6 +247,125 @@ GeoHeightfield::heightAt(double x, double y, const SRS& xy_srs, Interpolation in
     return (float)temp.z;
 }
 
+unsigned
+GeoHeightfield::heightAtRange(
+    glm::dvec3* begin, glm::dvec3* end,
+    const SRSOperation& xform,
+    Interpolation interp) const
+{
+    for (auto* p = begin; p != end; ++p)
+        p->z = 0.0;
+
+    // one PROJ call for the whole range:
+    if (xform.valid())
+    {
+        xform.transformRange(begin, end);
+    }
+
+    // sample in a tight loop; track failures so we can restore their
+    // markers after the inverse transform:
+    unsigned count = 0;
+    std::vector<glm::dvec3*> failed;
+
+    double maxcol = (double)(_hf->width() - 1);
+    double maxrow = (double)(_hf->height() - 1);
+
+    for (auto* p = begin; p != end; ++p)
+    {
+        if (_extent.contains(p->x, p->y))
+        {
+            double px = clamp((p->x - _extent.xmin()) / _resolution.x, 0.0, maxcol);
+            double py = clamp((p->y - _extent.ymin()) / _resolution.y, 0.0, maxrow);
+            p->z = _hf->heightAtPixel(px, py, interp);
+        }
+        else
+        {
+            p->z = NO_DATA_VALUE;
+        }
+
+        if (p->z != NO_DATA_VALUE)
+        {
+            ++count;
+        }
+        else
+        {
+            // park the z at zero so it doesn't poison the inverse transform
+            p->z = 0.0;
+            failed.push_back(p);
+        }
+    }
+
+    // return the points to their original SRS, again in one call:
+    if (xform.valid())
+    {
+        xform.inverseRange(begin, end);
+    }
+
+    for (auto* p : failed)
+        p->z = NO_DATA_VALUE;
+
+    return count;
+}
+
+unsigned
+GeoHeightfield::heightAt(
+    std::vector<glm::dvec3>& points,
+    const SRSOperation& operation,
+    Interpolation interp) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid(), 0);
+
+    if (points.empty())
+        return 0;
+
+    return heightAtRange(points.data(), points.data() + points.size(), operation, interp);
+}
+
+unsigned
+GeoHeightfield::heightAtParallel(
+    std::vector<glm::dvec3>& points,
+    const SRSOperation& operation,
+    Interpolation interp) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid(), 0);
+
+    if (points.empty())
+        return 0;
+
+    unsigned numBands = std::min((unsigned)points.size(),
+        std::max(1u, std::thread::hardware_concurrency()));
+
+    if (numBands <= 1)
+    {
+        return heightAtRange(points.data(), points.data() + points.size(), operation, interp);
+    }
+
+    std::size_t pointsPerBand = (points.size() + numBands - 1) / numBands;
+    std::atomic_uint count = { 0u };
+    auto group = jobs::jobgroup::create();
+
+    for (std::size_t i0 = 0; i0 < points.size(); i0 += pointsPerBand)
+    {
+        std::size_t i1 = std::min(i0 + pointsPerBand, points.size());
+
+        jobs::dispatch([this, &points, &operation, interp, i0, i1, &count]()
+            {
+                // PROJ contexts are thread-local, so each band needs its
+                // own copy of the transform:
+                SRSOperation bandOp;
+                if (operation.valid())
+                    bandOp = operation.from().to(operation.to());
+
+                count += heightAtRange(points.data() + i0, points.data() + i1, bandOp, interp);
+            },
+            jobs::context{ "GeoHeightfield::heightAt", nullptr, {}, group });
+    }
+
+    group->join();
+
+    return count;
+}
+
 GeoHeightfield
 GeoHeightfield::createSubSample(
     const GeoExtent& destExtent,
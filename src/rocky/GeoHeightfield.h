@@ -22,7 +22,7 @@ namespace ROCKY_NAMESPACE
         GeoHeightfield();
         GeoHeightfield(const GeoHeightfield&) = default;
         GeoHeightfield& operator=(const GeoHeightfield&) = default;
-        GeoHeightfield(GeoHeightfield&& rhs) noexcept { *this = rhs; }
+        GeoHeightfield(GeoHeightfield&& rhs) noexcept { *this = std::move(rhs); }
         GeoHeightfield& operator=(GeoHeightfield&& rhs) noexcept;
 
         //! Constructs a new georeferenced heightfield.
@@ -70,6 +70,34 @@ namespace ROCKY_NAMESPACE
             const SRSOperation& operation,
             Interpolation interp) const;
 
+        //! Samples the elevation at a collection of points in one batch.
+        //! All points transform into this heightfield's SRS in a single
+        //! PROJ call, sample in a tight loop, and transform back, which is
+        //! much faster than calling heightAt() once per point.
+        //!
+        //! @param points
+        //!      Points to sample, in the operation's source SRS. Modified
+        //!      in place: each point's z is replaced with its height, or
+        //!      NO_DATA_VALUE if the query failed.
+        //! @param operation
+        //!      SRS transformation from the points' SRS to this
+        //!      heightfield's SRS.
+        //! @param interp
+        //!      Interpolation method for the elevation queries.
+        //! @return Number of points that yielded a valid height
+        unsigned heightAt(
+            std::vector<glm::dvec3>& points,
+            const SRSOperation& operation,
+            Interpolation interp) const;
+
+        //! Multi-threaded variant of the batch heightAt(). Partitions the
+        //! points across the jobs pool, each worker with its own SRS
+        //! transform. Worthwhile for very large batches.
+        unsigned heightAtParallel(
+            std::vector<glm::dvec3>& points,
+            const SRSOperation& operation,
+            Interpolation interp) const;
+
         //! Subsamples the heightfield, returning a new heightfield corresponding to
         //! the destEx extent. The destEx must be a smaller, inset area of sourceEx.
         GeoHeightfield createSubSample(
@@ -89,8 +117,39 @@ namespace ROCKY_NAMESPACE
         //! The maximum height in the heightfield
         float maxHeight() const { return _maxHeight; }
 
-        //! Gets a pointer to the underlying OSG heightfield.
-        std::shared_ptr<Heightfield> heightfield() const {
+        //! Hierarchical min/max of the underlying samples. Level 0 cells each
+        //! cover a 2x2 block of samples; each successive level halves the
+        //! resolution of the one before it. Used by intersection queries to
+        //! reject regions without marching individual samples.
+        struct MinMaxPyramid
+        {
+            struct Level
+            {
+                unsigned width = 0, height = 0;
+                std::vector<glm::fvec2> cells; // x=min, y=max
+            };
+            std::vector<Level> levels; // finest first
+        };
+
+        //! Builds the optional min/max pyramid for this heightfield.
+        //! Typically called once at load time (see ElevationLayer); queries
+        //! without a pyramid fall back to the overall min/max height.
+        void generateMinMaxPyramid();
+
+        //! Whether this heightfield has a min/max pyramid
+        bool hasMinMaxPyramid() const { return _minMaxPyramid != nullptr; }
+
+        //! Conservative (min, max) height over a sub-rectangle of this
+        //! heightfield's extent, resolved hierarchically when a pyramid is
+        //! present. A query whose height range falls outside the result
+        //! cannot intersect the terrain in that region.
+        //! @return (min, max), or (NO_DATA_VALUE, NO_DATA_VALUE) if the
+        //!    region contains no valid samples
+        glm::fvec2 minMaxHeight(double xmin, double ymin, double xmax, double ymax) const;
+
+        //! Gets a pointer to the underlying OSG heightfield. Returns a
+        //! reference so hot loops can poll it without refcount traffic.
+        const std::shared_ptr<Heightfield>& heightfield() const {
             return _hf;
         }
 
@@ -114,11 +173,17 @@ namespace ROCKY_NAMESPACE
     private:
         GeoExtent _extent;
         std::shared_ptr<Heightfield> _hf;
+        std::shared_ptr<MinMaxPyramid> _minMaxPyramid;
         float _minHeight = FLT_MAX;
         float _maxHeight = -FLT_MAX;
         glm::dvec2 _resolution;
 
         void init();
+
+        unsigned heightAtRange(
+            glm::dvec3* begin, glm::dvec3* end,
+            const SRSOperation& operation,
+            Interpolation interp) const;
     };
 
 
@@ -1,6 +1,7 @@
 #include "GeoImage.h"
 #include "Math.h"
 #include "Image.h"
+#include "weejobs.h"
 
 #ifdef ROCKY_HAS_GDAL
 #include <gdal.h>
@@ -570,7 +571,7 @@ GeoImage::valid() const
     return _extent.valid() && _image != nullptr;
 }
 
-std::shared_ptr<Image>
+const std::shared_ptr<Image>&
 GeoImage::image() const
 {
     return _image;
@@ -750,47 +751,83 @@ GeoImage::reproject(
 void
 GeoImage::composite(const std::vector<GeoImage>& sources, const std::vector<float>& opacities)
 {
-    double x, y;
-    glm::fvec4 pixel, temp;
     bool have_opacities = opacities.size() == sources.size();
-    
-    std::vector<SRSOperation> xforms;
-    xforms.reserve(sources.size());
-    for(auto& source : sources)
-        xforms.emplace_back(srs().to(source.srs()));
 
-        for (unsigned s = 0; s < _image->width(); ++s)
+    // composites the rows [t0, t1) of the destination image.
+    auto compositeBand = [&](unsigned t0, unsigned t1)
         {
-            for (unsigned t = 0; t < _image->height(); ++t)
-            {
-                getCoord(s, t, x, y);
-
-                for (unsigned layer = 0; layer < _image->depth(); ++layer)
+            double x, y;
+            glm::fvec4 pixel, temp;
+
+            // Each band gets its own transforms; PROJ contexts are
+            // thread-local so operations must not cross threads.
+            std::vector<SRSOperation> xforms;
+            xforms.reserve(sources.size());
+            for (auto& source : sources)
+                xforms.emplace_back(srs().to(source.srs()));
+
+            // hoist the destination format dispatch out of the pixel loop
+            // so the per-pixel write inlines (see ImageView):
+            visitImagePixelFormat(_image.get(), [&](auto dest)
                 {
-                    bool pixel_valid = false;
-
-                    for (int i = 0; i < (int)sources.size(); ++i)
+                    for (unsigned t = t0; t < t1; ++t)
                     {
-                        auto& source = sources[i];
-                        float opacity = have_opacities ? opacities[i] : 1.0f;
-
-                        if (!pixel_valid)
+                        for (unsigned s = 0; s < _image->width(); ++s)
                         {
-                            if (source.read(pixel, xforms[i], x, y, layer) && pixel.a > 0.0f)
+                            getCoord(s, t, x, y);
+
+                            for (unsigned layer = 0; layer < _image->depth(); ++layer)
                             {
-                                pixel.a *= opacity;
-                                pixel_valid = true;
+                                bool pixel_valid = false;
+
+                                for (int i = 0; i < (int)sources.size(); ++i)
+                                {
+                                    auto& source = sources[i];
+                                    float opacity = have_opacities ? opacities[i] : 1.0f;
+
+                                    if (!pixel_valid)
+                                    {
+                                        if (source.read(pixel, xforms[i], x, y, layer) && pixel.a > 0.0f)
+                                        {
+                                            pixel.a *= opacity;
+                                            pixel_valid = true;
+                                        }
+                                    }
+                                    else if (source.read(temp, xforms[i], x, y, layer))
+                                    {
+                                        pixel = glm::mix(pixel, temp, temp.a * opacity);
+                                    }
+                                }
+
+                                dest.write(pixel, s, t, layer);
                             }
                         }
-                        else if (source.read(temp, xforms[i], x, y, layer))
-                        {
-                            pixel = glm::mix(pixel, temp, temp.a * opacity);
-                        }
                     }
+                });
+        };
 
-                    _image->write(pixel, s, t, layer);
-                }
+    // Partition the destination into horizontal bands and farm them out
+    // to the jobs system; bands write disjoint rows so no locking needed.
+    unsigned numBands = std::min(_image->height(), std::max(1u, std::thread::hardware_concurrency()));
+    unsigned rowsPerBand = (_image->height() + numBands - 1) / numBands;
+
+    if (numBands > 1)
+    {
+        auto group = jobs::jobgroup::create();
+
+        for (unsigned t0 = 0; t0 < _image->height(); t0 += rowsPerBand)
+        {
+            unsigned t1 = std::min(t0 + rowsPerBand, _image->height());
+            jobs::dispatch(
+                [compositeBand, t0, t1]() { compositeBand(t0, t1); },
+                jobs::context{ "GeoImage::composite", nullptr, {}, group });
         }
+
+        group->join();
+    }
+    else
+    {
+        compositeBand(0u, _image->height());
     }
 }
 
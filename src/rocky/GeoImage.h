@@ -25,7 +25,7 @@ namespace ROCKY_NAMESPACE
         GeoImage();
         GeoImage(const GeoImage&) = default;
         GeoImage& operator=(const GeoImage&) = default;
-        GeoImage(const GeoImage&& rhs) noexcept { *this = rhs; }
+        GeoImage(GeoImage&& rhs) noexcept { *this = std::move(rhs); }
         GeoImage& operator=(GeoImage&&) noexcept;
 
         //! Constructs a new goereferenced image.
@@ -39,8 +39,9 @@ namespace ROCKY_NAMESPACE
         //! True if this is a valid geo image.
         bool valid() const;
 
-        //! Gets a pointer to the underlying image
-        std::shared_ptr<Image> image() const;
+        //! Gets a pointer to the underlying image. Returns a reference
+        //! so hot loops can poll it without refcount traffic.
+        const std::shared_ptr<Image>& image() const;
 
         //! Gets the geospatial extent of the image
         const GeoExtent& extent() const;
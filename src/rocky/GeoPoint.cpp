@@ -35,7 +35,7 @@ GeoPoint::transform(const SRS& outSRS) const
     GeoPoint result;
     if (valid() && outSRS.valid())
     {
-        if (srs.to(outSRS).transform(*this, result))
+        if (srs.cachedTo(outSRS).transform(*this, result))
         {
             result.srs = outSRS;
         }
@@ -48,7 +48,7 @@ GeoPoint::transformInPlace(const SRS& to_srs)
 {
     if (valid() && srs.valid())
     {
-        if (srs.to(to_srs).transform(*this, *this))
+        if (srs.cachedTo(to_srs).transform(*this, *this))
         {
             srs = to_srs;
         }
@@ -5,6 +5,12 @@
  */
 #include "Geocoder.h"
 #include "Feature.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+#include <mutex>
 
 #ifdef ROCKY_HAS_GEOCODER
 #include <ogr_geocoding.h>
@@ -12,10 +18,129 @@
 
 using namespace ROCKY_NAMESPACE;
 
+namespace
+{
+    // One gazetteer record. Records live in a vector sorted by the
+    // lowercased name, so both exact lookups and prefix scans are a
+    // binary search; the sorted keys share prefixes in memory order,
+    // which is what a trie would buy us without the pointer chasing.
+    struct Place
+    {
+        std::string key;  // lowercased name, for searching
+        std::string name; // name as it appears in the source file
+        double lon;
+        double lat;
+    };
+
+    std::mutex _gazetteerMutex;
+    std::vector<Place> _gazetteer;
+
+    Feature placeToFeature(const Place& place)
+    {
+        Feature feature;
+        feature.geometry.type = Geometry::Type::Points;
+        feature.geometry.points.emplace_back(place.lon, place.lat, 0.0);
+        feature.fields.emplace("display_name", Feature::FieldValueUnion{ place.name });
+        feature.dirtyExtent();
+        return feature;
+    }
+}
+
+Status
+Geocoder::loadGazetteer(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in.is_open())
+        return Status(Status::ResourceUnavailable, "Cannot open gazetteer file " + path);
+
+    std::vector<Place> places;
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        auto fields = util::StringTokenizer()
+            .delim("\t")
+            .keepEmpties(false)
+            .tokenize(line);
+
+        if (fields.size() < 3)
+            continue;
+
+        Place place;
+        place.name = util::trim(fields[0]);
+        place.lat = util::as<double>(fields[1], DBL_MAX);
+        place.lon = util::as<double>(fields[2], DBL_MAX);
+
+        if (place.name.empty() || place.lat == DBL_MAX || place.lon == DBL_MAX)
+            continue;
+
+        place.key = util::toLower(place.name);
+        places.emplace_back(std::move(place));
+    }
+
+    if (places.empty())
+        return Status(Status::GeneralError, "No usable records in gazetteer file " + path);
+
+    std::sort(places.begin(), places.end(),
+        [](const Place& lhs, const Place& rhs) { return lhs.key < rhs.key; });
+
+    std::scoped_lock lock(_gazetteerMutex);
+    _gazetteer.swap(places);
+
+    return StatusOK;
+}
+
+std::vector<Feature>
+Geocoder::suggest(const std::string& prefix, unsigned maxResults)
+{
+    std::vector<Feature> results;
+
+    if (prefix.empty())
+        return results;
+
+    auto key = util::toLower(prefix);
+
+    std::scoped_lock lock(_gazetteerMutex);
+
+    auto iter = std::lower_bound(_gazetteer.begin(), _gazetteer.end(), key,
+        [](const Place& place, const std::string& key) { return place.key < key; });
+
+    for (; iter != _gazetteer.end() && results.size() < maxResults; ++iter)
+    {
+        if (iter->key.compare(0, key.size(), key) != 0)
+            break;
+
+        results.emplace_back(placeToFeature(*iter));
+    }
+
+    return results;
+}
 
 Result<std::vector<Feature>>
 Geocoder::geocode(const std::string& location, IOOptions& io) const
 {
+    // instant path: exact (case-insensitive) match in the local gazetteer.
+    {
+        auto key = util::toLower(location);
+
+        std::scoped_lock lock(_gazetteerMutex);
+
+        auto iter = std::lower_bound(_gazetteer.begin(), _gazetteer.end(), key,
+            [](const Place& place, const std::string& key) { return place.key < key; });
+
+        std::vector<Feature> result;
+        for (; iter != _gazetteer.end() && iter->key == key; ++iter)
+        {
+            result.emplace_back(placeToFeature(*iter));
+        }
+
+        if (!result.empty())
+            return result;
+    }
+
 #ifdef ROCKY_HAS_GEOCODER
 
     std::vector<Feature> result;
@@ -47,3 +172,23 @@ Geocoder::geocode(const std::string& location, IOOptions& io) const
     return Status(Status::ServiceUnavailable, "Geocoder service is not available");
 #endif
 }
+
+jobs::future<Result<std::vector<Feature>>>
+Geocoder::geocodeAsync(const std::string& location, const IOOptions& in_io) const
+{
+    const IOOptions io(in_io);
+
+    auto task = [location, io](Cancelable& c) -> Result<std::vector<Feature>>
+    {
+        if (c.canceled())
+            return Status(Status::ResourceUnavailable, "Canceled");
+
+        IOOptions local_io(io, c);
+        Geocoder geocoder;
+        return geocoder.geocode(location, local_io);
+    };
+
+    return jobs::dispatch(task, jobs::context{
+        "geocode " + location,
+        jobs::get_pool("rocky.io", 4) });
+}
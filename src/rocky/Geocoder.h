@@ -18,6 +18,28 @@ namespace ROCKY_NAMESPACE
     public:
         Geocoder() = default;
 
+        //! Looks up a location by name. Checks the local gazetteer first
+        //! (see loadGazetteer) and only falls back to the backend service
+        //! on a miss. Blocks until a result is available.
         Result<std::vector<Feature>> geocode(const std::string& location, IOOptions& io) const;
+
+        //! Like geocode(), but runs on the IO job pool and returns a
+        //! future immediately. For interactive lookups that must not
+        //! stall the caller.
+        jobs::future<Result<std::vector<Feature>>> geocodeAsync(const std::string& location, const IOOptions& io) const;
+
+        //! Loads a local gazetteer into a shared in-memory index for
+        //! instant offline lookups. The file is UTF-8 text with one
+        //! tab-separated "name, latitude, longitude" record per line;
+        //! additional columns and lines starting with '#' are ignored.
+        //! Matching is case-insensitive. The index is shared by every
+        //! Geocoder instance.
+        static Status loadGazetteer(const std::string& path);
+
+        //! Prefix query against the loaded gazetteer only - no network
+        //! and no blocking, for search-as-you-type completion. Returns up
+        //! to maxResults point features in alphabetical order, each with
+        //! a "display_name" field.
+        static std::vector<Feature> suggest(const std::string& prefix, unsigned maxResults = 10);
     };
 }
@@ -7,6 +7,9 @@
 #include "Heightfield.h"
 #include "Units.h"
 #include "GeoHeightfield.h"
+#include "Math.h"
+
+#include <cstring>
 
 #define LC "[Geoid] "
 
@@ -22,7 +25,14 @@ Geoid::Geoid(
     heightfield(hf_),
     units(units_)
 {
-    //nop
+    // keep a flat copy of the samples for batched queries:
+    if (heightfield)
+    {
+        _width = heightfield->width();
+        _height = heightfield->height();
+        _grid.resize((std::size_t)_width * _height);
+        std::memcpy(_grid.data(), heightfield->data<float>(), _grid.size() * sizeof(float));
+    }
 }
 
 bool
@@ -50,3 +60,57 @@ Geoid::getHeight(
 
     return result;
 }
+
+void
+Geoid::getHeights(
+    float* out,
+    unsigned numCols, unsigned numRows,
+    double lonMin, double latMin,
+    double lonInterval, double latInterval) const
+{
+    if (!out || numCols == 0 || numRows == 0)
+        return;
+
+    if (_grid.empty())
+    {
+        for (std::size_t i = 0; i < (std::size_t)numCols * numRows; ++i)
+            out[i] = 0.0f;
+        return;
+    }
+
+    // Bilinear sampling of a regular grid is separable, so compute the
+    // column sample positions and weights once and reuse them for every
+    // row. Geoid grids have no voids, so plain bilinear is safe here.
+    std::vector<int> col0(numCols), col1(numCols);
+    std::vector<float> colMix(numCols);
+
+    for (unsigned c = 0; c < numCols; ++c)
+    {
+        double lon = lonMin + lonInterval * (double)c;
+        double px = util::clamp((lon + 180.0) / 360.0, 0.0, 1.0) * (double)(_width - 1);
+        col0[c] = std::max((int)std::floor(px), 0);
+        col1[c] = std::max(std::min((int)std::ceil(px), (int)(_width - 1)), 0);
+        colMix[c] = (float)(px - (double)col0[c]);
+    }
+
+    for (unsigned r = 0; r < numRows; ++r)
+    {
+        double lat = latMin + latInterval * (double)r;
+        double py = util::clamp((lat + 90.0) / 180.0, 0.0, 1.0) * (double)(_height - 1);
+        int row0 = std::max((int)std::floor(py), 0);
+        int row1 = std::max(std::min((int)std::ceil(py), (int)(_height - 1)), 0);
+        float rowMix = (float)(py - (double)row0);
+
+        const float* south = _grid.data() + (std::size_t)row0 * _width;
+        const float* north = _grid.data() + (std::size_t)row1 * _width;
+
+        float* out_row = out + (std::size_t)r * numCols;
+
+        for (unsigned c = 0; c < numCols; ++c)
+        {
+            float s = south[col0[c]] + colMix[c] * (south[col1[c]] - south[col0[c]]);
+            float n = north[col0[c]] + colMix[c] * (north[col1[c]] - north[col0[c]]);
+            out_row[c] = s + rowMix * (n - s);
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include <rocky/Heightfield.h>
 #include <rocky/GeoExtent.h>
 #include <rocky/Units.h>
+#include <vector>
 
 namespace ROCKY_NAMESPACE
 {
@@ -34,10 +35,28 @@ namespace ROCKY_NAMESPACE
         //! coordinates (in degrees).
         float getHeight(
             double lat_deg,
-            double lon_deg, 
+            double lon_deg,
             Interpolation interp = Interpolation::BILINEAR) const;
 
+        //! Queries the geoid for bilinear height offsets across a regular
+        //! geodetic grid (degrees), filling a row-major numCols x numRows
+        //! array with rows advancing south to north. Much faster than
+        //! calling getHeight once per sample when normalizing a whole
+        //! heightfield.
+        void getHeights(
+            float* out,
+            unsigned numCols, unsigned numRows,
+            double lonMin, double latMin,
+            double lonInterval, double latInterval) const;
+
         //! Whether this is a valid object to use
         bool valid() const;
+
+    private:
+        // flat copy of the geoid samples, made at construction, so batch
+        // queries read a contiguous array instead of going through the
+        // heightfield's per-sample accessors:
+        std::vector<float> _grid;
+        unsigned _width = 0, _height = 0;
     };
 }
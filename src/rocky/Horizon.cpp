@@ -132,6 +132,28 @@ Horizon::isVisible(double x, double y, double z, double radius) const
     return false;
 }
 
+void
+Horizon::isVisible(const glm::dvec4* spheres, bool* visible, std::size_t count) const
+{
+    if (!spheres || !visible)
+        return;
+
+    if (!_valid)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            visible[i] = true;
+        return;
+    }
+
+    // the per-sphere test inlines here, so the loop streams straight
+    // through the input and output arrays:
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const glm::dvec4& s = spheres[i];
+        visible[i] = isVisible(s.x, s.y, s.z, s.w);
+    }
+}
+
 double
 Horizon::getDistanceToVisibleHorizon() const
 {
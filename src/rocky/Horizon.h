@@ -46,6 +46,16 @@ namespace ROCKY_NAMESPACE
             return isVisible(vec3.x, vec3.y, vec3.z, radius);
         }
 
+        //! Batch visibility test. Streams an array of bounding spheres
+        //! (center in geocentric coordinates, w = radius in meters) through
+        //! the horizon test in one pass, writing one result per sphere.
+        //! Use this to test a whole table of bounds - resident tiles,
+        //! entity bounds - without a function call per element.
+        //! @param spheres Bounding spheres to test
+        //! @param visible Output array; receives one result per sphere
+        //! @param count Number of spheres
+        void isVisible(const glm::dvec4* spheres, bool* visible, std::size_t count) const;
+
         //! Caclulate distance from eye to visible horizon
         //! @param Distance (meters) to the visible horizon
         double getDistanceToVisibleHorizon() const;
@@ -0,0 +1,204 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "IOReplay.h"
+#include "Log.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[ioreplay] "
+
+namespace
+{
+    // archive format: magic line, then length-prefixed records. Every
+    // integer is little-endian and fixed-width, so an archive recorded
+    // on one machine replays on another.
+    const char* magic = "ROCKY-IO-ARCHIVE-1\n";
+
+    enum class Mode { OFF, RECORD, REPLAY };
+
+    // one archived read: the outcome, the payload (or the error), and
+    // what the read cost when it was recorded.
+    struct Entry
+    {
+        Status status;
+        Content content;
+        double durationMS = 0.0;
+    };
+
+    std::atomic<int> _mode = { (int)Mode::OFF };
+    std::mutex _mutex;
+    std::ofstream _out;
+    std::unordered_map<std::string, Entry> _archive;
+
+    void writeString(std::ofstream& out, const std::string& s)
+    {
+        std::uint64_t len = s.size();
+        out.write((const char*)&len, sizeof(len));
+        out.write(s.data(), (std::streamsize)len);
+    }
+
+    bool readString(std::ifstream& in, std::string& s)
+    {
+        std::uint64_t len = 0;
+        if (!in.read((char*)&len, sizeof(len)))
+            return false;
+        s.resize(len);
+        return (bool)in.read(s.data(), (std::streamsize)len);
+    }
+}
+
+bool
+util::ioreplay::record(const std::string& filename)
+{
+    std::scoped_lock L(_mutex);
+
+    if ((Mode)_mode.load() != Mode::OFF)
+        return false;
+
+    _out.open(filename, std::ios::binary);
+    if (!_out.is_open())
+        return false;
+
+    _out.write(magic, (std::streamsize)strlen(magic));
+    _mode = (int)Mode::RECORD;
+
+    Log()->info(LC "recording URI reads to {}", filename);
+    return true;
+}
+
+bool
+util::ioreplay::replay(const std::string& filename)
+{
+    std::scoped_lock L(_mutex);
+
+    if ((Mode)_mode.load() != Mode::OFF)
+        return false;
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    std::string header(strlen(magic), '\0');
+    if (!in.read(header.data(), (std::streamsize)header.size()) || header != magic)
+    {
+        Log()->warn(LC "{} is not an IO archive", filename);
+        return false;
+    }
+
+    _archive.clear();
+    for (;;)
+    {
+        std::string uri;
+        if (!readString(in, uri))
+            break; // clean EOF
+
+        Entry entry;
+        std::int32_t code = 0;
+        in.read((char*)&code, sizeof(code));
+        entry.status.code = (Status::Code)code;
+        readString(in, entry.status.message);
+        readString(in, entry.content.contentType);
+        readString(in, entry.content.data);
+        in.read((char*)&entry.durationMS, sizeof(entry.durationMS));
+        if (!in)
+        {
+            Log()->warn(LC "{} is truncated; replaying what loaded", filename);
+            break;
+        }
+
+        // a URI fetched more than once keeps its first recording, so a
+        // replayed run sees the timing the original run saw first.
+        _archive.emplace(std::move(uri), std::move(entry));
+    }
+
+    _mode = (int)Mode::REPLAY;
+
+    Log()->info(LC "replaying {} URI reads from {}", _archive.size(), filename);
+    return true;
+}
+
+void
+util::ioreplay::stop()
+{
+    std::scoped_lock L(_mutex);
+
+    if (_out.is_open())
+        _out.close();
+
+    _archive.clear();
+    _mode = (int)Mode::OFF;
+}
+
+bool
+util::ioreplay::recording()
+{
+    return (Mode)_mode.load(std::memory_order_relaxed) == Mode::RECORD;
+}
+
+bool
+util::ioreplay::replaying()
+{
+    return (Mode)_mode.load(std::memory_order_relaxed) == Mode::REPLAY;
+}
+
+void
+util::ioreplay::capture(const std::string& uri, const IOResult<Content>& result,
+    std::chrono::steady_clock::duration elapsed)
+{
+    if (!recording())
+        return;
+
+    double durationMS = 1e-6 * (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    std::scoped_lock L(_mutex);
+
+    if (!_out.is_open())
+        return;
+
+    writeString(_out, uri);
+    std::int32_t code = (std::int32_t)result.status.code;
+    _out.write((const char*)&code, sizeof(code));
+    writeString(_out, result.status.message);
+    writeString(_out, result.status.ok() ? result.value.contentType : std::string());
+    writeString(_out, result.status.ok() ? result.value.data : std::string());
+    _out.write((const char*)&durationMS, sizeof(durationMS));
+}
+
+IOResult<Content>
+util::ioreplay::lookup(const std::string& uri)
+{
+    Entry entry;
+    {
+        std::scoped_lock L(_mutex);
+
+        auto iter = _archive.find(uri);
+        if (iter == _archive.end())
+        {
+            return Status(Status::ResourceUnavailable, "Not in replay archive: " + uri);
+        }
+        entry = iter->second;
+    }
+
+    // reproduce the recorded timing, so a replayed run stresses the
+    // pager and the frame loop exactly the way the original run did:
+    std::this_thread::sleep_for(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(entry.durationMS)));
+
+    if (entry.status.failed())
+    {
+        return entry.status;
+    }
+    return entry.content;
+}
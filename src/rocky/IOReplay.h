@@ -0,0 +1,62 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/IOTypes.h>
+#include <chrono>
+#include <string>
+
+namespace ROCKY_NAMESPACE
+{
+    namespace util
+    {
+        /**
+        * Record/replay layer for URI reads. A performance regression
+        * reported from the field is rarely reproducible, because network
+        * and disk timing differ run to run. While recording, every
+        * URI::read result is captured to an archive along with how long
+        * it took; while replaying, reads are served from the archive and
+        * delayed to their recorded durations, so two runs of the same
+        * camera script see byte-identical inputs on identical timing and
+        * a frame-hitch regression can be bisected against them.
+        *
+        * When neither mode is active the instrumentation is a single
+        * relaxed atomic load per read.
+        */
+        namespace ioreplay
+        {
+            //! Begins recording URI reads to the given archive file.
+            //! Returns false if a file cannot be created or a session is
+            //! already in progress.
+            extern ROCKY_EXPORT bool record(const std::string& filename);
+
+            //! Begins replaying URI reads from the given archive file,
+            //! loading it fully into memory. Returns false if the file
+            //! cannot be read or a session is already in progress.
+            extern ROCKY_EXPORT bool replay(const std::string& filename);
+
+            //! Ends the active session, flushing the archive when recording.
+            extern ROCKY_EXPORT void stop();
+
+            //! Whether a recording session is active.
+            extern ROCKY_EXPORT bool recording();
+
+            //! Whether a replay session is active.
+            extern ROCKY_EXPORT bool replaying();
+
+            //! Captures one read's result and wall-clock duration.
+            //! (Called by URI::read while recording; no-op otherwise.)
+            extern ROCKY_EXPORT void capture(
+                const std::string& uri,
+                const IOResult<Content>& result,
+                std::chrono::steady_clock::duration elapsed);
+
+            //! Serves one read from the archive, sleeping out its recorded
+            //! duration first. A URI absent from the archive resolves to
+            //! ResourceUnavailable. (Called by URI::read while replaying.)
+            extern ROCKY_EXPORT IOResult<Content> lookup(const std::string& uri);
+        }
+    }
+}
@@ -5,6 +5,7 @@
  */
 #include "IOTypes.h"
 #include "Context.h"
+#include "Utils.h"
 #include "json.h"
 
 using namespace ROCKY_NAMESPACE;
@@ -46,13 +47,45 @@ IOOptions::operator = (const IOOptions& rhs)
     referrer = rhs.referrer;
     maxNetworkAttempts = rhs.maxNetworkAttempts;
     uriGate = rhs.uriGate;
+    uriRequests = rhs.uriRequests;
+    deadline = rhs.deadline;
     _cancelable = rhs._cancelable;
     _properties = rhs._properties;
     return *this;
 }
 
+IOOptions
+IOOptions::withBudget(std::chrono::milliseconds budget) const
+{
+    IOOptions result(*this);
+    auto candidate = std::chrono::steady_clock::now() + budget;
+    if (!result.deadline.has_value() || candidate < result.deadline.value())
+        result.deadline = candidate;
+    return result;
+}
+
 Services::Services()
 {
     readImageFromURI = [](const std::string& location, const IOOptions&) { return Status_ServiceUnavailable; };
     readImageFromStream = [](std::istream& stream, std::string contentType, const IOOptions& io) { return Status_ServiceUnavailable; };
+
+    // shared by all copies, so a codec installed on one IOOptions is
+    // visible everywhere (like the content cache):
+    _imageCodecs = std::make_shared<std::unordered_map<std::string, DecodeImageService>>();
+}
+
+void
+Services::setImageCodec(const std::string& contentType, DecodeImageService codec)
+{
+    (*_imageCodecs)[util::toLower(contentType)] = codec;
+}
+
+const DecodeImageService*
+Services::imageCodec(const std::string& contentType) const
+{
+    if (_imageCodecs->empty())
+        return nullptr;
+
+    auto iter = _imageCodecs->find(util::toLower(contentType));
+    return iter != _imageCodecs->end() ? &iter->second : nullptr;
 }
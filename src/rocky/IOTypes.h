@@ -13,6 +13,7 @@
 #include <rocky/LRUCache.h>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 /**
  * A collection of types used by the various I/O systems.
@@ -40,6 +41,13 @@ namespace ROCKY_NAMESPACE
     using WriteImageStreamService = std::function<
         Status(std::shared_ptr<Image> image, std::ostream& stream, std::string contentType, const IOOptions& io)>;
 
+    //! Service that decodes one encoded image format from an in-memory
+    //! buffer. Register one per content type with Services::setImageCodec
+    //! to plug in an accelerated decoder (libjpeg-turbo, SIMD PNG, WebP);
+    //! an error result falls through to the default reader.
+    using DecodeImageService = std::function<
+        Result<std::shared_ptr<Image>>(const char* data, std::size_t length, const IOOptions& io)>;
+
     //! Service for caching data
     using CacheImpl = void*; // todo.
     using CacheService = std::function<std::shared_ptr<CacheImpl>()>;
@@ -57,7 +65,12 @@ namespace ROCKY_NAMESPACE
         std::chrono::system_clock::time_point timestamp;
     };
 
-    using ContentCache = rocky::util::LRUCache<std::string, Result<Content>>;
+    class URI;
+
+    // keyed on URI rather than the URL string so lookups reuse the hash
+    // the URI computed once at assembly instead of re-hashing the full
+    // URL on every request.
+    using ContentCache = rocky::util::LRUCache<URI, Result<Content>>;
 
     class ROCKY_EXPORT Services
     {
@@ -73,8 +86,23 @@ namespace ROCKY_NAMESPACE
         WriteImageStreamService writeImageToStream;
         //CacheService cache = nullptr;
         std::shared_ptr<ContentCache> contentCache;
+
+        //! Installs a codec for a content type (e.g. "image/jpeg"),
+        //! replacing any previous one. The default image reader only runs
+        //! for content types with no codec (or whose codec declined).
+        //! Install codecs at startup, before any IO begins; the registry
+        //! is shared by all copies of this object and is not locked.
+        void setImageCodec(const std::string& contentType, DecodeImageService codec);
+
+        //! The codec installed for a content type, or nullptr.
+        const DecodeImageService* imageCodec(const std::string& contentType) const;
+
+    private:
+        std::shared_ptr<std::unordered_map<std::string, DecodeImageService>> _imageCodecs;
     };
 
+    template<typename T> struct IOResult;
+
     /**
      * Options and services passed along to IO operations.
      */
@@ -95,9 +123,26 @@ namespace ROCKY_NAMESPACE
             return IOOptions(*this, referrer);
         }
 
-        //! Was the current operation canceled?
+        //! Copy this options structure with a completion deadline of
+        //! "budget" from now. An existing earlier deadline wins, so
+        //! nested stages can only tighten the budget, never extend it.
+        IOOptions withBudget(std::chrono::milliseconds budget) const;
+
+        //! Was the current operation canceled? Also true once the
+        //! deadline (if any) has passed, so every cancellation check at
+        //! a stage boundary doubles as time-budget enforcement.
         inline bool canceled() const override;
 
+        //! Time remaining until the deadline, clamped at zero; or
+        //! "fallback" when no deadline is set. Forward this into
+        //! transport-level timeouts so a hung read cannot outlive the
+        //! operation's budget.
+        inline std::chrono::milliseconds timeRemaining(std::chrono::milliseconds fallback) const;
+
+        //! Absolute completion deadline for the operation chain, if any.
+        //! Copies inherit it; prefer withBudget() to set it.
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+
         //! Access to pluggable services
         Services services;
 
@@ -110,6 +155,10 @@ namespace ROCKY_NAMESPACE
         //! Gate for seriaizing duplicate URI requests (shared)
         mutable std::shared_ptr<util::Gate<std::string>> uriGate;
 
+        //! Table of in-flight URI requests that lets concurrent requests for
+        //! the same resource share a single fetch (shared)
+        mutable std::shared_ptr<util::Coalescer<std::string, IOResult<Content>>> uriRequests;
+
     public:
         IOOptions& operator = (const IOOptions& rhs);
 
@@ -154,6 +203,9 @@ namespace ROCKY_NAMESPACE
         bool fromCache = false;
         JSON metadata;
 
+        IOResult() :
+            Result<T>() { }
+
         IOResult(const T& result) :
             Result<T>(result) { }
 
@@ -196,6 +248,16 @@ namespace ROCKY_NAMESPACE
     };
 
     bool IOOptions::canceled() const {
-        return _cancelable ? _cancelable->canceled() : false;
+        if (_cancelable && _cancelable->canceled())
+            return true;
+        return deadline.has_value() && std::chrono::steady_clock::now() >= deadline.value();
+    }
+
+    std::chrono::milliseconds IOOptions::timeRemaining(std::chrono::milliseconds fallback) const {
+        if (!deadline.has_value())
+            return fallback;
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline.value() - std::chrono::steady_clock::now());
+        return remaining.count() > 0 ? remaining : std::chrono::milliseconds(0);
     }
 }
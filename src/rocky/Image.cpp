@@ -5,6 +5,9 @@
  */
 #include "Image.h"
 
+#include <unordered_map>
+#include <vector>
+
 using namespace ROCKY_NAMESPACE;
 
 namespace
@@ -12,6 +15,60 @@ namespace
     using uchar = unsigned char;
     using ushort = unsigned short;
 
+    // Thread-local, size-bucketed pool of pixel buffers. Tile loading
+    // allocates and frees several identically sized buffers per tile
+    // (source, reprojected, composited), and at high paging rates the
+    // global allocator becomes a contention point across the load
+    // threads; recycling buffers per-thread takes it off the hot path.
+    // Buffers above MAX_BUFFER_SIZE or beyond the per-thread budget fall
+    // through to the heap. Because the pool is per-thread, first-touch
+    // placement keeps recycled buffers on the NUMA node of the worker
+    // that owns them when job pool threads are pinned (see
+    // jobs::jobpool::set_thread_init_function).
+    class BufferPool
+    {
+    public:
+        unsigned char* acquire(std::size_t size)
+        {
+            auto iter = _buckets.find(size);
+            if (iter != _buckets.end() && !iter->second.empty())
+            {
+                auto* buffer = iter->second.back();
+                iter->second.pop_back();
+                _totalBytes -= size;
+                return buffer;
+            }
+            return new unsigned char[size];
+        }
+
+        void release(unsigned char* buffer, std::size_t size)
+        {
+            if (size == 0 || size > MAX_BUFFER_SIZE || _totalBytes + size > MAX_POOL_BYTES)
+            {
+                delete[] buffer;
+                return;
+            }
+            _buckets[size].push_back(buffer);
+            _totalBytes += size;
+        }
+
+        ~BufferPool()
+        {
+            for (auto& bucket : _buckets)
+                for (auto* buffer : bucket.second)
+                    delete[] buffer;
+        }
+
+    private:
+        static constexpr std::size_t MAX_BUFFER_SIZE = 8 * 1024 * 1024;
+        static constexpr std::size_t MAX_POOL_BYTES = 64 * 1024 * 1024;
+
+        std::unordered_map<std::size_t, std::vector<unsigned char*>> _buckets;
+        std::size_t _totalBytes = 0;
+    };
+
+    thread_local BufferPool t_bufferPool;
+
     constexpr float norm_8 = 255.0f;
     constexpr float denorm_8 = 1.0f / norm_8;
 
@@ -46,6 +103,55 @@ namespace
         }
     };
 
+    // box-filters one mip level from the level above it. Runs with a
+    // fixed component type and count so the compiler can vectorize.
+    template<typename T, int N>
+    void downsample(const T* src, unsigned sw, unsigned sh, T* dst, unsigned dw, unsigned dh, unsigned depth)
+    {
+        for (unsigned layer = 0; layer < depth; ++layer)
+        {
+            const T* srcLayer = src + (std::size_t)layer * sw * sh * N;
+            T* dstLayer = dst + (std::size_t)layer * dw * dh * N;
+
+            for (unsigned y = 0; y < dh; ++y)
+            {
+                unsigned t0 = 2 * y, t1 = std::min(t0 + 1, sh - 1);
+
+                for (unsigned x = 0; x < dw; ++x)
+                {
+                    unsigned s0 = 2 * x, s1 = std::min(s0 + 1, sw - 1);
+
+                    const T* a = srcLayer + (t0 * sw + s0) * N;
+                    const T* b = srcLayer + (t0 * sw + s1) * N;
+                    const T* c = srcLayer + (t1 * sw + s0) * N;
+                    const T* d = srcLayer + (t1 * sw + s1) * N;
+                    T* out = dstLayer + (y * dw + x) * N;
+
+                    for (int i = 0; i < N; ++i)
+                        out[i] = (T)(0.25f * ((float)a[i] + (float)b[i] + (float)c[i] + (float)d[i]));
+                }
+            }
+        }
+    }
+
+    template<typename T, int N>
+    void build_mip_chain(unsigned char* chain, unsigned width, unsigned height, unsigned depth, unsigned levels)
+    {
+        T* src = reinterpret_cast<T*>(chain);
+        unsigned sw = width, sh = height;
+
+        for (unsigned level = 1; level < levels; ++level)
+        {
+            unsigned dw = std::max(sw >> 1, 1u);
+            unsigned dh = std::max(sh >> 1, 1u);
+            T* dst = src + (std::size_t)sw * sh * depth * N;
+
+            downsample<T, N>(src, sw, sh, dst, dw, dh, depth);
+
+            src = dst, sw = dw, sh = dh;
+        }
+    }
+
     template<typename T>
     struct FLOAT {
         static void read(Image::Pixel& pixel, unsigned char* ptr, int n) {
@@ -85,7 +191,7 @@ Image::Image(PixelFormat format, unsigned cols, unsigned rows, unsigned depth) :
 Image::Image(const Image& rhs) :
     super(rhs)
 {
-    allocate(rhs.pixelFormat(), rhs.width(), rhs.height(), rhs.depth());
+    allocate(rhs.pixelFormat(), rhs.width(), rhs.height(), rhs.depth(), rhs.mipLevels());
     memcpy(_data, rhs._data, sizeInBytes());
 }
 
@@ -97,6 +203,7 @@ Image::Image(Image&& rhs) noexcept :
         _width = rhs._width;
         _height = rhs._height;
         _depth = rhs._depth;
+        _mipLevels = rhs._mipLevels;
         _pixelFormat = rhs._pixelFormat;
         _data = rhs.releaseData();
     }
@@ -105,7 +212,7 @@ Image::Image(Image&& rhs) noexcept :
 Image::~Image()
 {
     if (_data)
-        delete[] _data;
+        t_bufferPool.release(_data, sizeInBytes());
 }
 
 bool
@@ -120,8 +227,8 @@ Image::clone() const
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(_data, nullptr);
 
-    auto clone = Image::create(
-        pixelFormat(), width(), height(), depth());
+    auto clone = Image::create();
+    clone->allocate(pixelFormat(), width(), height(), depth(), mipLevels());
 
     memcpy(
         clone->data<unsigned char*>(),
@@ -136,30 +243,107 @@ Image::allocate(
     PixelFormat pixelFormat_,
     unsigned width_,
     unsigned height_,
-    unsigned depth_)
+    unsigned depth_,
+    unsigned mipLevels_)
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(
-        width_ > 0 && height_ > 0 && depth_ > 0 &&
+        width_ > 0 && height_ > 0 && depth_ > 0 && mipLevels_ > 0 &&
         (unsigned)pixelFormat_ >= 0 && pixelFormat_ < NUM_PIXEL_FORMATS,
         void());
-    
+
+    // recycle any existing buffer (sized with the old dimensions):
+    if (_data)
+    {
+        t_bufferPool.release(_data, sizeInBytes());
+        _data = nullptr;
+    }
+
     _width = width_;
     _height = height_;
     _depth = depth_;
+    _mipLevels = mipLevels_;
     _pixelFormat = pixelFormat_;
 
-    auto layout = _layouts[pixelFormat()];
-
-    if (_data)
-        delete[] _data;
-
-    _data = new unsigned char[sizeInBytes()];
+    _data = t_bufferPool.acquire(sizeInBytes());
 
     // simple init for one-byte images
     if (sizeInBytes() > 0)
         write(glm::fvec4(0, 0, 0, 0), 0, 0);
 }
 
+void
+Image::dirty(unsigned x, unsigned y, unsigned width_, unsigned height_)
+{
+    if (width_ == 0 || height_ == 0)
+        return;
+
+    if (_dirtyRegion.empty())
+    {
+        _dirtyRegion = Region{ x, y, width_, height_ };
+    }
+    else
+    {
+        // union with the existing region:
+        unsigned x0 = std::min(_dirtyRegion.x, x);
+        unsigned y0 = std::min(_dirtyRegion.y, y);
+        unsigned x1 = std::max(_dirtyRegion.x + _dirtyRegion.width, x + width_);
+        unsigned y1 = std::max(_dirtyRegion.y + _dirtyRegion.height, y + height_);
+        _dirtyRegion = Region{ x0, y0, x1 - x0, y1 - y0 };
+    }
+}
+
+void
+Image::generateMipmaps()
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(valid(), void());
+
+    if (_mipLevels > 1)
+        return;
+
+    // count the levels down to 1x1:
+    unsigned levels = 1;
+    for (unsigned dim = std::max(width(), height()); dim > 1; dim >>= 1)
+        ++levels;
+
+    if (levels == 1)
+        return;
+
+    // move the base level into one contiguous buffer sized for the
+    // entire chain:
+    _mipLevels = levels;
+    auto* chain = t_bufferPool.acquire(sizeInBytes());
+    memcpy(chain, _data, sizeof_miplevel(0));
+    t_bufferPool.release(_data, sizeof_miplevel(0));
+    _data = chain;
+
+    switch (pixelFormat())
+    {
+    case R8_UNORM:
+        build_mip_chain<uchar, 1>(_data, width(), height(), depth(), levels);
+        break;
+    case R8G8_UNORM:
+        build_mip_chain<uchar, 2>(_data, width(), height(), depth(), levels);
+        break;
+    case R8G8B8_UNORM:
+        build_mip_chain<uchar, 3>(_data, width(), height(), depth(), levels);
+        break;
+    case R8G8B8A8_UNORM:
+        build_mip_chain<uchar, 4>(_data, width(), height(), depth(), levels);
+        break;
+    case R16_UNORM:
+        build_mip_chain<ushort, 1>(_data, width(), height(), depth(), levels);
+        break;
+    case R32_SFLOAT:
+        build_mip_chain<float, 1>(_data, width(), height(), depth(), levels);
+        break;
+    case R64_SFLOAT:
+        build_mip_chain<double, 1>(_data, width(), height(), depth(), levels);
+        break;
+    default:
+        break;
+    }
+}
+
 unsigned char*
 Image::releaseData()
 {
@@ -168,6 +352,7 @@ Image::releaseData()
     _width = 0;
     _height = 0;
     _depth = 0;
+    _mipLevels = 1;
     return released;
 }
 
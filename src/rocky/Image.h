@@ -7,6 +7,7 @@
 
 #include <rocky/Common.h>
 #include <rocky/Math.h>
+#include <limits>
 
 namespace ROCKY_NAMESPACE
 {
@@ -48,6 +49,9 @@ namespace ROCKY_NAMESPACE
         //! Pixel format (see PixelFormat enum)
         PixelFormat pixelFormat() const { return _pixelFormat; }
 
+        //! Number of mipmap levels in the data (1 = base level only)
+        unsigned mipLevels() const { return _mipLevels; }
+
         //! Whether there's an alpha channel
         bool hasAlphaChannel() const;
 
@@ -193,6 +197,40 @@ namespace ROCKY_NAMESPACE
         //! Fills the entire image with a single value
         void fill(const Pixel& p);
 
+        //! Generates a full mipmap chain by box-filtering each level from
+        //! the one above it. The chain is stored contiguously after the
+        //! base level so the whole image can upload to the GPU in a single
+        //! staging copy. No-op if the chain already exists.
+        void generateMipmaps();
+
+        //! Axis-aligned rectangle of pixels, used for dirty tracking
+        struct Region
+        {
+            unsigned x = 0, y = 0, width = 0, height = 0;
+            bool empty() const { return width == 0 || height == 0; }
+        };
+
+        //! Whether this image's contents are expected to change after
+        //! creation (e.g. a weather layer that refreshes in place).
+        //! Dynamic images stay resident in CPU memory after upload so
+        //! dirty regions can re-sync to the GPU.
+        bool dynamic() const { return _dynamic; }
+        void setDynamic(bool value) { _dynamic = value; }
+
+        //! Marks a rectangle of pixels as changed since the last upload,
+        //! unioning it with any region already marked. Consumers (e.g. the
+        //! terrain engine) use this to refresh only the affected pixels.
+        void dirty(unsigned x, unsigned y, unsigned width, unsigned height);
+
+        //! Marks the entire image as changed
+        void dirty() { dirty(0, 0, width(), height()); }
+
+        //! Region marked since the last clearDirty(); empty if none
+        const Region& dirtyRegion() const { return _dirtyRegion; }
+
+        //! Resets the dirty region; call after consuming it
+        void clearDirty() { _dirtyRegion = {}; }
+
         //! Releases this image's data without deleting it. 
         //! Use this to transfer ownership of the raw data to someone else.
         //! The inheritor is responsible to deleting the data.
@@ -201,10 +239,13 @@ namespace ROCKY_NAMESPACE
 
     protected:
         unsigned _width = 0, _height = 0, _depth = 0;
+        unsigned _mipLevels = 1;
         PixelFormat _pixelFormat = R8G8B8A8_UNORM;
         unsigned char* _data = nullptr;
+        bool _dynamic = false;
+        Region _dirtyRegion;
 
-        void allocate(PixelFormat format, unsigned s, unsigned t, unsigned r);
+        void allocate(PixelFormat format, unsigned s, unsigned t, unsigned r, unsigned mipLevels = 1);
 
         struct Layout {
             void(*read)(Pixel&, unsigned char*, int);
@@ -217,8 +258,179 @@ namespace ROCKY_NAMESPACE
 
         inline unsigned sizeof_miplevel(unsigned level) const;
         inline unsigned char* data_at_miplevel(unsigned level);
+
+        // bilinear kernel specialized on the component type and count at
+        // compile time; see read_bilinear.
+        template<typename T, int N, bool NORMALIZED>
+        inline void read_bilinear_t(Pixel& pixel,
+            unsigned s0, unsigned s1, float smix,
+            unsigned t0, unsigned t1, float tmix,
+            unsigned layer) const;
+    };
+
+
+    namespace detail
+    {
+        // compile-time component type and count for each pixel format;
+        // see ImageView.
+        template<Image::PixelFormat FORMAT> struct PixelFormatTraits;
+
+        template<> struct PixelFormatTraits<Image::R8_UNORM> {
+            using component_type = unsigned char;
+            static constexpr int components = 1;
+            static constexpr bool normalized = true;
+        };
+        template<> struct PixelFormatTraits<Image::R8G8_UNORM> {
+            using component_type = unsigned char;
+            static constexpr int components = 2;
+            static constexpr bool normalized = true;
+        };
+        template<> struct PixelFormatTraits<Image::R8G8B8_UNORM> {
+            using component_type = unsigned char;
+            static constexpr int components = 3;
+            static constexpr bool normalized = true;
+        };
+        template<> struct PixelFormatTraits<Image::R8G8B8A8_UNORM> {
+            using component_type = unsigned char;
+            static constexpr int components = 4;
+            static constexpr bool normalized = true;
+        };
+        template<> struct PixelFormatTraits<Image::R16_UNORM> {
+            using component_type = unsigned short;
+            static constexpr int components = 1;
+            static constexpr bool normalized = true;
+        };
+        template<> struct PixelFormatTraits<Image::R32_SFLOAT> {
+            using component_type = float;
+            static constexpr int components = 1;
+            static constexpr bool normalized = false;
+        };
+        template<> struct PixelFormatTraits<Image::R64_SFLOAT> {
+            using component_type = double;
+            static constexpr int components = 1;
+            static constexpr bool normalized = false;
+        };
+    }
+
+    /**
+     * Typed view over an Image's pixel data, specialized on the pixel
+     * format at compile time. read() and write() inline into their call
+     * sites with no Layout function-pointer dispatch, so the compiler can
+     * unroll and vectorize the surrounding loop. Use in hot per-pixel
+     * loops where the format is known, or hoist the runtime dispatch out
+     * of the loop with visitImagePixelFormat().
+     */
+    template<Image::PixelFormat FORMAT>
+    class ImageView
+    {
+    public:
+        using traits = detail::PixelFormatTraits<FORMAT>;
+        using component_type = typename traits::component_type;
+
+        //! Construct a view over an image whose pixel format matches FORMAT
+        explicit ImageView(Image* image) :
+            _data(image->data<component_type>()),
+            _width(image->width()),
+            _height(image->height())
+        {
+            ROCKY_SOFT_ASSERT(image->pixelFormat() == FORMAT, "ImageView pixel format mismatch");
+        }
+
+        //! Whether this view is usable
+        bool valid() const {
+            return _data != nullptr;
+        }
+
+        //! Read the pixel at a column, row, and layer
+        inline void read(Image::Pixel& pixel, unsigned s, unsigned t, unsigned layer = 0) const {
+            constexpr int N = traits::components;
+            const component_type* ptr = _data + (_width * _height * layer + _width * t + s) * N;
+            for (int i = 0; i < N; ++i)
+                pixel[i] = (float)ptr[i] * denorm;
+            for (int i = N; i < 4; ++i)
+                pixel[i] = 1.0f; // fills in alpha if source doesn't have it
+        }
+
+        //! Write the pixel at a column, row, and layer
+        inline void write(const Image::Pixel& pixel, unsigned s, unsigned t, unsigned layer = 0) {
+            constexpr int N = traits::components;
+            component_type* ptr = _data + (_width * _height * layer + _width * t + s) * N;
+            for (int i = 0; i < N; ++i)
+                ptr[i] = (component_type)(pixel[i] * norm);
+        }
+
+    private:
+        static constexpr float norm = traits::normalized ?
+            (float)std::numeric_limits<component_type>::max() : 1.0f;
+        static constexpr float denorm = 1.0f / norm;
+
+        component_type* _data = nullptr;
+        unsigned _width = 0, _height = 0;
     };
 
+    /**
+     * Generic fallback view that works for any pixel format by going
+     * through the regular Layout dispatch. Same interface as the typed
+     * specializations so templated loops can use either.
+     */
+    template<>
+    class ImageView<Image::UNDEFINED>
+    {
+    public:
+        explicit ImageView(Image* image) : _image(image) { }
+
+        bool valid() const {
+            return _image && _image->valid();
+        }
+
+        inline void read(Image::Pixel& pixel, unsigned s, unsigned t, unsigned layer = 0) const {
+            _image->read(pixel, s, t, layer);
+        }
+
+        inline void write(const Image::Pixel& pixel, unsigned s, unsigned t, unsigned layer = 0) {
+            _image->write(pixel, s, t, layer);
+        }
+
+    private:
+        Image* _image = nullptr;
+    };
+
+    //! Invokes a callable with an ImageView matching the image's pixel
+    //! format, compiling the callable once per format. Use this to hoist
+    //! the format dispatch out of a per-pixel loop:
+    //!   visitImagePixelFormat(image, [&](auto view) { ... });
+    template<typename CALLABLE>
+    inline void visitImagePixelFormat(Image* image, CALLABLE&& func)
+    {
+        switch (image->pixelFormat())
+        {
+        case Image::R8_UNORM:
+            func(ImageView<Image::R8_UNORM>(image));
+            break;
+        case Image::R8G8_UNORM:
+            func(ImageView<Image::R8G8_UNORM>(image));
+            break;
+        case Image::R8G8B8_UNORM:
+            func(ImageView<Image::R8G8B8_UNORM>(image));
+            break;
+        case Image::R8G8B8A8_UNORM:
+            func(ImageView<Image::R8G8B8A8_UNORM>(image));
+            break;
+        case Image::R16_UNORM:
+            func(ImageView<Image::R16_UNORM>(image));
+            break;
+        case Image::R32_SFLOAT:
+            func(ImageView<Image::R32_SFLOAT>(image));
+            break;
+        case Image::R64_SFLOAT:
+            func(ImageView<Image::R64_SFLOAT>(image));
+            break;
+        default:
+            func(ImageView<Image::UNDEFINED>(image));
+            break;
+        }
+    }
+
 
     // inline functions
 
@@ -235,6 +447,31 @@ namespace ROCKY_NAMESPACE
             _layouts[pixelFormat()].num_components);
     }
 
+    template<typename T, int N, bool NORMALIZED>
+    void Image::read_bilinear_t(Pixel& pixel,
+        unsigned s0, unsigned s1, float smix,
+        unsigned t0, unsigned t1, float tmix,
+        unsigned layer) const
+    {
+        const unsigned rowpitch = width() * N;
+        const T* base = reinterpret_cast<const T*>(_data) + layer * height() * rowpitch;
+        const T* UL = base + t0 * rowpitch + s0 * N;
+        const T* UR = base + t0 * rowpitch + s1 * N;
+        const T* LL = base + t1 * rowpitch + s0 * N;
+        const T* LR = base + t1 * rowpitch + s1 * N;
+
+        constexpr float denorm = NORMALIZED ? 1.0f / (float)std::numeric_limits<T>::max() : 1.0f;
+
+        for (int i = 0; i < N; ++i)
+        {
+            float top = (float)UL[i] + ((float)UR[i] - (float)UL[i]) * smix;
+            float bot = (float)LL[i] + ((float)LR[i] - (float)LL[i]) * smix;
+            pixel[i] = (top + (bot - top) * tmix) * denorm;
+        }
+        for (int i = N; i < 4; ++i)
+            pixel[i] = 1.0f;
+    }
+
     void Image::read_bilinear(Pixel& pixel, float u, float v, unsigned layer) const
     {
         u = clamp(u, 0.0f, 1.0f);
@@ -252,28 +489,67 @@ namespace ROCKY_NAMESPACE
         float t1 = std::min(t0 + 1.0f, sizeT);
         float tmix = t0 < t1 ? (t - t0) / (t1 - t0) : 0.0f;
 
-        Pixel UL, UR, LL, LR;
-        read(UL, (unsigned)s0, (unsigned)t0, layer);
-        read(UR, (unsigned)s1, (unsigned)t0, layer);
-        read(LL, (unsigned)s0, (unsigned)t1, layer);
-        read(LR, (unsigned)s1, (unsigned)t1, layer);
+        unsigned is0 = (unsigned)s0, is1 = (unsigned)s1;
+        unsigned it0 = (unsigned)t0, it1 = (unsigned)t1;
 
-        Pixel TOP = UL * (1.0f - smix) + UR * smix;
-        Pixel BOT = LL * (1.0f - smix) + LR * smix;
-        pixel = TOP * (1.0f - tmix) + BOT * tmix;
+        // Dispatch once to a kernel specialized on the pixel format at
+        // compile time. The four corner fetches then run with a fixed
+        // component type and count - no Layout function-pointer calls -
+        // which the compiler can unroll and vectorize. This is the hot
+        // path for compositing and reprojection.
+        switch (pixelFormat())
+        {
+        case R8_UNORM:
+            read_bilinear_t<unsigned char, 1, true>(pixel, is0, is1, smix, it0, it1, tmix, layer);
+            break;
+        case R8G8_UNORM:
+            read_bilinear_t<unsigned char, 2, true>(pixel, is0, is1, smix, it0, it1, tmix, layer);
+            break;
+        case R8G8B8_UNORM:
+            read_bilinear_t<unsigned char, 3, true>(pixel, is0, is1, smix, it0, it1, tmix, layer);
+            break;
+        case R8G8B8A8_UNORM:
+            read_bilinear_t<unsigned char, 4, true>(pixel, is0, is1, smix, it0, it1, tmix, layer);
+            break;
+        case R16_UNORM:
+            read_bilinear_t<unsigned short, 1, true>(pixel, is0, is1, smix, it0, it1, tmix, layer);
+            break;
+        case R32_SFLOAT:
+            read_bilinear_t<float, 1, false>(pixel, is0, is1, smix, it0, it1, tmix, layer);
+            break;
+        case R64_SFLOAT:
+            read_bilinear_t<double, 1, false>(pixel, is0, is1, smix, it0, it1, tmix, layer);
+            break;
+        default:
+        {
+            Pixel UL, UR, LL, LR;
+            read(UL, is0, it0, layer);
+            read(UR, is1, it0, layer);
+            read(LL, is0, it1, layer);
+            read(LR, is1, it1, layer);
+
+            Pixel TOP = UL * (1.0f - smix) + UR * smix;
+            Pixel BOT = LL * (1.0f - smix) + LR * smix;
+            pixel = TOP * (1.0f - tmix) + BOT * tmix;
+            break;
+        }
+        }
     }
 
     void Image::write(const Pixel& pixel, unsigned s, unsigned t, unsigned layer)
     {
         _layouts[pixelFormat()].write(
             pixel,
-            _data + (width()*height()*layer + height() * t + s)*_layouts[pixelFormat()].bytes_per_pixel,
+            _data + (width()*height()*layer + width() * t + s)*_layouts[pixelFormat()].bytes_per_pixel,
             _layouts[pixelFormat()].num_components);
     }
 
     unsigned Image::sizeInBytes() const
     {
-        return sizeInPixels() * _layouts[pixelFormat()].bytes_per_pixel;
+        unsigned total = 0;
+        for (unsigned level = 0; level < _mipLevels; ++level)
+            total += sizeof_miplevel(level);
+        return total;
     }
 
     unsigned Image::sizeInPixels() const
@@ -296,7 +572,11 @@ namespace ROCKY_NAMESPACE
 
     unsigned Image::sizeof_miplevel(unsigned level) const
     {
-        return (width() * height() * depth()) >> level;
+        return
+            std::max(width() >> level, 1u) *
+            std::max(height() >> level, 1u) *
+            depth() *
+            _layouts[pixelFormat()].bytes_per_pixel;
     }
 
     unsigned Image::numComponents() const
@@ -5,6 +5,7 @@
  */
 #include "ImageLayer.h"
 
+#include "Arena.h"
 #include "Color.h"
 #include "IOTypes.h"
 #include "Utils.h"
@@ -13,6 +14,7 @@
 #include "TileKey.h"
 #include "json.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 using namespace ROCKY_NAMESPACE;
@@ -70,6 +72,7 @@ ImageLayer::construct(const std::string& JSON, const IOOptions& io)
 {
     const auto j = parse_json(JSON);
     get_to(j, "sharpness", sharpness);
+    get_to(j, "generate_mipmaps", generateMipmaps);
     get_to(j, "crop", crop);
 
     setRenderType(RenderType::TERRAIN_SURFACE);
@@ -80,6 +83,7 @@ ImageLayer::to_json() const
 {
     auto j = parse_json(super::to_json());
     set(j, "sharpness", sharpness);
+    set(j, "generate_mipmaps", generateMipmaps);
     set(j, "crop", crop);
     return j.dump();
 }
@@ -92,6 +96,7 @@ ImageLayer::openImplementation(const IOOptions& io)
         return r;
 
     _dependencyCache = std::make_shared<TileMosaicWeakCache<Image>>();
+    _assembledCache = std::make_shared<TileMosaicWeakCache<Image>>();
 
     return StatusOK;
 }
@@ -100,16 +105,22 @@ void
 ImageLayer::closeImplementation()
 {
     _dependencyCache = nullptr;
+    _assembledCache = nullptr;
     super::closeImplementation();
 }
 
 Result<GeoImage>
 ImageLayer::createImage(const TileKey& key, const IOOptions& io) const
 {
+    // join the layer's task group so close() can cancel this operation
+    // while it is in flight:
+    util::CancelableGroup::Member canceler(backgroundTasks(), io);
+    IOOptions local(io, canceler);
+
     std::shared_lock readLock(layerStateMutex());
     if (isOpen())
     {
-        return createImageInKeyProfile(key, io);
+        return createImageInKeyProfile(key, local);
     }
     return status();
 }
@@ -137,6 +148,7 @@ ImageLayer::createImageInKeyProfile(const TileKey& key, const IOOptions& io) con
     }
 
     Result<GeoImage> result;
+    bool assembled = false;
     float sharpness_value = sharpness.has_value() ? sharpness.value() : 0.0f;
 
     GeoExtent cropIntersection;
@@ -168,6 +180,18 @@ ImageLayer::createImageInKeyProfile(const TileKey& key, const IOOptions& io) con
     else
     {
         // If the profiles are different, use a compositing method to assemble the tile.
+        // First try the warp cache: panning and multi-view traversals
+        // re-request target keys whose assembled image is often still
+        // alive elsewhere, and a hit skips the whole warp. The cached
+        // value is already post-processed (crop/sharpen/mipmaps), so we
+        // can return it as-is.
+        auto cached = _assembledCache->get(key);
+        if (auto cached_image = cached.value.lock())
+        {
+            return GeoImage(cached_image, key.extent());
+        }
+
+        assembled = true;
         auto image = assembleImage(key, io);
         result = GeoImage(image, key.extent());
 
@@ -181,7 +205,10 @@ ImageLayer::createImageInKeyProfile(const TileKey& key, const IOOptions& io) con
     // address this later if necessary.
     //ROCKY_SOFT_ASSERT(result.status.failed() || result.value.image());
 
-    if (result.status.ok() && result.value.image())
+    // Post-processing needs CPU pixel access. An image without a pixel
+    // buffer (e.g. one decoded straight to a GPU-native format) passes
+    // through untouched.
+    if (result.status.ok() && result.value.image() && result.value.image()->valid())
     {
         if (cropIntersection.valid())
         {
@@ -212,6 +239,19 @@ ImageLayer::createImageInKeyProfile(const TileKey& key, const IOOptions& io) con
         {
             result = GeoImage(result.value.image()->sharpen(sharpness_value), key.extent());
         }
+
+        // build the mipmap chain here on the load job, not on the GPU:
+        if (generateMipmaps == true)
+        {
+            result.value.image()->generateMipmaps();
+        }
+    }
+
+    // publish the finished warp so concurrent and near-future requests
+    // for this key reuse it instead of re-warping:
+    if (assembled && result.status.ok() && result.value.image())
+    {
+        _assembledCache->put(key, key, result.value.image());
     }
 
     return result;
@@ -222,16 +262,21 @@ ImageLayer::assembleImage(const TileKey& key, const IOOptions& io) const
 {
     std::shared_ptr<Mosaic> output;
 
+    // Transient working storage (the source set and the sample grid)
+    // comes from the thread's arena and is released wholesale on return.
+    util::ScopedArena arena(util::Arena::threadLocal());
+
     // Map the key's LOD to the target profile's LOD.
     unsigned targetLOD = profile.getEquivalentLOD(key.profile, key.level);
 
     // Find the set of keys that covers the same area as in input key in our target profile.
-    std::vector<TileKey> intersectingKeys;
+    TileKey::Vector intersectingKeys;
     key.getIntersectingKeys(profile, intersectingKeys);
 
     // collect raster data for each intersecting key, falling back on ancestor images
     // if none are available at the target LOD.
-    std::vector<GeoImage> sources;
+    util::arena_vector<GeoImage> sources(arena);
+    sources.reserve(intersectingKeys.size());
 
     if (intersectingKeys.size() > 0)
     {
@@ -274,7 +319,7 @@ ImageLayer::assembleImage(const TileKey& key, const IOOptions& io) const
                     _dependencyCache->put(intersectingKey, subKey, subTile.value.image());
 
                     // add it to our sources collection:
-                    sources.emplace_back(subTile.value);
+                    sources.emplace_back(std::move(subTile.value));
 
                     if (subKey.level == targetLOD)
                     {
@@ -284,9 +329,16 @@ ImageLayer::assembleImage(const TileKey& key, const IOOptions& io) const
             }
         }
 
+        // Images without a CPU pixel buffer (e.g. decoded straight to a
+        // GPU-native format) cannot be resampled into a mosaic; drop them.
+        sources.erase(
+            std::remove_if(sources.begin(), sources.end(),
+                [](const GeoImage& s) { return !s.image()->valid(); }),
+            sources.end());
+
         // If we actually got at least one piece of usable data,
         // move ahead and build a mosaic of all sources.
-        if (hasAtLeastOneSourceAtTargetLOD)
+        if (!sources.empty() && hasAtLeastOneSourceAtTargetLOD)
         {
             unsigned cols = 0;
             unsigned rows = 0;
@@ -319,14 +371,15 @@ ImageLayer::assembleImage(const TileKey& key, const IOOptions& io) const
                 output->dependencies.push_back(source.image());
 
             // Clean up orphaned entries any time a tile destructs.
-            output->cleanupOperation = [captured{ std::weak_ptr(_dependencyCache) }, key]() {
-                auto cache = captured.lock();
-                if (cache)
+            output->cleanupOperation = [deps{ std::weak_ptr(_dependencyCache) }, warps{ std::weak_ptr(_assembledCache) }, key]() {
+                if (auto cache = deps.lock())
+                    cache->clean();
+                if (auto cache = warps.lock())
                     cache->clean();
                 };
 
             // Working set of points. it's much faster to xform an entire vector all at once.
-            std::vector<glm::dvec3> points;
+            util::arena_vector<glm::dvec3> points(arena);
             points.resize(cols * rows);
 
             double minx, miny, maxx, maxy;
@@ -21,6 +21,10 @@ namespace ROCKY_NAMESPACE
         //! Sharpness filter strength to apply to the image
         option<float> sharpness = 0.0f;
 
+        //! Whether to generate a mipmap chain for each image tile on the
+        //! load job, letting the GPU sample pre-filtered levels
+        option<bool> generateMipmaps = false;
+
         //! Creates an image for the given tile key.
         //! @param key TileKey for which to create an image
         //! @param io IO options
@@ -81,6 +85,11 @@ namespace ROCKY_NAMESPACE
 
         // a weak cache that helps us avoid re-fetching dependent images in a mosaic
         std::shared_ptr<TileMosaicWeakCache<Image>> _dependencyCache;
+
+        // a weak cache of assembled (reprojected) results keyed by the
+        // target key, so re-requesting a key whose warped image is still
+        // alive elsewhere skips the whole warp
+        std::shared_ptr<TileMosaicWeakCache<Image>> _assembledCache;
     };
 
 } // namespace ROCKY_NAMESPACE
@@ -4,54 +4,111 @@
  * MIT License
  */
 #pragma once
+#include <rocky/CacheTelemetry.h>
 #include <rocky/Common.h>
 #include <rocky/Utils.h>
-#include <mutex>
+#include <array>
+#include <cmath>
+#include <functional>
 #include <list>
+#include <mutex>
+#include <vector>
 #include <algorithm>
 
 namespace ROCKY_NAMESPACE
 {
     namespace util
     {
-        // Adapted from https://www.geeksforgeeks.org/lru-cache-implementation
+        /**
+         * Sharded LRU cache. The key space is hashed across a fixed number
+         * of independently locked shards so concurrent load threads rarely
+         * contend on the same mutex. Each shard keeps its own recency list
+         * and hit/miss counters.
+         *
+         * Capacity is an entry count by default. Assign a "sizeOf" function
+         * to charge each value a cost (e.g., bytes) instead; the capacity
+         * is then a budget in those units.
+         */
         template<class K, class V>
         class LRUCache
         {
         private:
-            mutable std::mutex mutex;
-            int capacity;
             using E = typename std::pair<K, V>;
-            typename std::list<E> cache;
-            vector_map<K, typename std::list<E>::iterator> map;
+
+            struct Shard
+            {
+                mutable std::mutex mutex;
+                typename std::list<E> cache;
+                flat_hash_map<K, typename std::list<E>::iterator> map;
+                std::size_t size = 0; // total cost of resident entries
+                unsigned gets = 0;
+                unsigned hits = 0;
+                unsigned evictions = 0;
+            };
+
+            static constexpr std::size_t NUM_SHARDS = 8;
+            mutable std::array<Shard, NUM_SHARDS> shards;
+            std::size_t capacity; // per-shard budget
+
+            inline Shard& shard(const K& key) const
+            {
+                return shards[std::hash<K>()(key) % NUM_SHARDS];
+            }
+
+            inline std::size_t cost(const V& value) const
+            {
+                return sizeOf ? sizeOf(value) : 1;
+            }
 
         public:
-            int hits = 0;
-            int gets = 0;
+            //! Optional cost function. When set, "capacity" is a budget in
+            //! whatever units this returns (typically bytes) rather than a
+            //! count of entries.
+            std::function<std::size_t(const V&)> sizeOf;
 
-            LRUCache(int capacity_ = 32) : capacity(capacity_) { }
+            //! Per-shard usage snapshot (see shardStats)
+            struct ShardStats
+            {
+                unsigned gets = 0;
+                unsigned hits = 0;
+                std::size_t entries = 0;
+                std::size_t size = 0;
+            };
+
+            LRUCache(std::size_t capacity_ = 32)
+            {
+                setCapacity(capacity_);
+            }
 
-            inline void setCapacity(int value)
+            //! Sets the total capacity (entries, or cost units when sizeOf
+            //! is set) and clears the cache.
+            inline void setCapacity(std::size_t value)
             {
-                std::scoped_lock L(mutex);
-                cache.clear();
-                map.clear();
-                hits = 0;
-                gets = 0;
-                capacity = std::max(0, value);
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    s.cache.clear();
+                    s.map.clear();
+                    s.size = 0;
+                    s.gets = 0;
+                    s.hits = 0;
+                    s.evictions = 0;
+                }
+                capacity = value > 0 ? std::max<std::size_t>(1, value / NUM_SHARDS) : 0;
             }
 
             inline V get(const K& key)
             {
                 if (capacity == 0)
                     return V();
-                std::scoped_lock L(mutex);
-                ++gets;
-                auto it = map.find(key);
-                if (it == map.end())
+                auto& s = shard(key);
+                std::scoped_lock L(s.mutex);
+                ++s.gets;
+                auto it = s.map.find(key);
+                if (it == s.map.end())
                     return V();
-                cache.splice(cache.end(), cache, it->second);
-                ++hits;
+                s.cache.splice(s.cache.end(), s.cache, it->second);
+                ++s.hits;
                 return it->second->second;
             }
 
@@ -59,23 +116,144 @@ namespace ROCKY_NAMESPACE
             {
                 if (capacity == 0)
                     return;
-                std::scoped_lock L(mutex);
-                if (cache.size() == capacity)
+                auto& s = shard(key);
+                std::scoped_lock L(s.mutex);
+
+                // replace an existing entry in place:
+                auto it = s.map.find(key);
+                if (it != s.map.end())
+                {
+                    s.size -= cost(it->second->second);
+                    s.cache.erase(it->second);
+                    s.map.erase(key);
+                }
+
+                // evict from the cold end until the new entry fits:
+                std::size_t c = cost(value);
+                while (!s.cache.empty() && s.size + c > std::max(capacity, c))
                 {
-                    auto first_key = cache.front().first;
-                    cache.pop_front();
-                    map.erase(first_key);
+                    s.size -= cost(s.cache.front().second);
+                    s.map.erase(s.cache.front().first);
+                    s.cache.pop_front();
+                    ++s.evictions;
                 }
-                cache.emplace_back(key, value);
-                map[key] = std::prev(cache.end());
+
+                s.cache.emplace_back(key, value);
+                s.map[key] = std::prev(s.cache.end());
+                s.size += c;
             }
 
             inline void clear()
             {
-                std::scoped_lock L(mutex);
-                cache.clear();
-                map.clear();
-                gets = 0, hits = 0;
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    s.cache.clear();
+                    s.map.clear();
+                    s.size = 0;
+                    s.gets = 0;
+                    s.hits = 0;
+                    s.evictions = 0;
+                }
+            }
+
+            //! Total number of get() calls across all shards
+            inline unsigned gets() const
+            {
+                unsigned total = 0;
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    total += s.gets;
+                }
+                return total;
+            }
+
+            //! Total number of cache hits across all shards
+            inline unsigned hits() const
+            {
+                unsigned total = 0;
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    total += s.hits;
+                }
+                return total;
+            }
+
+            //! Total number of evictions across all shards
+            inline unsigned evictions() const
+            {
+                unsigned total = 0;
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    total += s.evictions;
+                }
+                return total;
+            }
+
+            //! Total configured capacity (cost units when sizeOf is set,
+            //! entry count otherwise)
+            inline std::size_t totalCapacity() const
+            {
+                return capacity * NUM_SHARDS;
+            }
+
+            //! Registers this cache with the process-wide cache telemetry
+            //! (see CacheTelemetry). Keep the returned handle alive as long
+            //! as the cache; dropping it unregisters.
+            inline std::shared_ptr<CacheTelemetry::Registration> telemetry(const std::string& name)
+            {
+                return CacheTelemetry::add(name, [this]()
+                    {
+                        return CacheTelemetry::Stats{
+                            gets(), hits(), evictions(), size(), totalCapacity() };
+                    });
+            }
+
+            //! Total cost of resident entries (bytes when sizeOf is set,
+            //! entry count otherwise)
+            inline std::size_t size() const
+            {
+                std::size_t total = 0;
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    total += s.size;
+                }
+                return total;
+            }
+
+            //! Evicts roughly the given fraction [0..1] of resident
+            //! entries, coldest first.
+            inline void shrink(float fraction)
+            {
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    std::size_t count = (std::size_t)std::ceil(fraction * (double)s.cache.size());
+                    for (std::size_t i = 0; i < count && !s.cache.empty(); ++i)
+                    {
+                        s.size -= cost(s.cache.front().second);
+                        s.map.erase(s.cache.front().first);
+                        s.cache.pop_front();
+                        ++s.evictions;
+                    }
+                }
+            }
+
+            //! Usage counters for each shard, for diagnostics
+            inline std::vector<ShardStats> shardStats() const
+            {
+                std::vector<ShardStats> result;
+                result.reserve(NUM_SHARDS);
+                for (auto& s : shards)
+                {
+                    std::scoped_lock L(s.mutex);
+                    result.emplace_back(ShardStats{ s.gets, s.hits, s.cache.size(), s.size });
+                }
+                return result;
             }
         };
     }
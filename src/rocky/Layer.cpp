@@ -106,6 +106,9 @@ Layer::open(const IOOptions& io)
 
     std::unique_lock lock(_state_mutex);
 
+    // re-arm the task group in case a previous close() canceled it:
+    _backgroundTasks.reset();
+
     setStatus(openImplementation(io));
 
     Log()->debug("Layer \"{}\" status = {}", name(), status().toString());
@@ -118,6 +121,11 @@ Layer::close()
 {
     if (isOpen())
     {
+        // cancel outstanding background work BEFORE taking the state
+        // lock, so in-flight operations holding read locks wind down
+        // quickly instead of blocking the close:
+        _backgroundTasks.cancel();
+
         std::unique_lock lock(_state_mutex);
         closeImplementation();
         _status = Status(Status::ResourceUnavailable, "Layer closed");
@@ -10,6 +10,7 @@
 #include <rocky/DateTime.h>
 #include <rocky/IOTypes.h>
 #include <rocky/Status.h>
+#include <rocky/Threading.h>
 #include <rocky/URI.h>
 #include <vector>
 #include <shared_mutex>
@@ -70,6 +71,17 @@ namespace ROCKY_NAMESPACE
         //! Serialize this layer into a JSON string
         virtual std::string to_json() const;
 
+        //! Serialize any state this layer probed from its data source at
+        //! open time (resolved profiles, tile matrices, etc.) so a
+        //! MapSnapshot can restore it without touching the source again.
+        //! Returns an empty string if the layer has nothing to snapshot.
+        virtual std::string snapshotState() const { return {}; }
+
+        //! Restore state captured by snapshotState(). Call before open();
+        //! layers that honor it will skip their capability probes. A layer
+        //! is free to ignore state it no longer understands.
+        virtual void restoreSnapshotState(const std::string&) { }
+
         //! Extent of this layer's data.
         //! This method may return GeoExtent::INVALID which means that the
         //! extent is unavailable (not necessarily that there is no data).
@@ -84,6 +96,13 @@ namespace ROCKY_NAMESPACE
         //! Register a callback for layer close
         Callback<void(std::shared_ptr<Layer>)> onLayerClosed;
 
+        //! Group joining all of this layer's in-flight background
+        //! operations. close() cancels the group, so workers abandon jobs
+        //! against a closed layer at their next cancellation check instead
+        //! of running them to completion. Join it (or poll it) from any
+        //! asynchronous function you run against this layer.
+        util::CancelableGroup& backgroundTasks() const { return _backgroundTasks; }
+
         void removeCallback(UID);
 
     public:
@@ -153,6 +172,7 @@ namespace ROCKY_NAMESPACE
         std::atomic<Revision> _revision = { 1 };
         mutable std::shared_mutex _state_mutex;
         std::string _layerTypeName;
+        mutable util::CancelableGroup _backgroundTasks;
 
         //! post-ctor initialization
         void construct(const JSON&);
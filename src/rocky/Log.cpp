@@ -6,6 +6,7 @@
 #include "Log.h"
 #include "Context.h"
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 ROCKY_ABOUT(spdlog, std::to_string(SPDLOG_VER_MAJOR) + "." + std::to_string(SPDLOG_VER_MINOR) + "." + std::to_string(SPDLOG_VER_PATCH));
@@ -28,7 +29,22 @@ LogSettings::LogSettings()
     const spdlog::level::level_enum default_level = spdlog::level::info;
     try
     {
-        auto logger = spdlog::stdout_color_mt("rocky");
+        // Route the logger through spdlog's asynchronous mode: callers
+        // enqueue into a preallocated ring serviced by one background
+        // thread, which does the pattern formatting and sink I/O. The
+        // overrun-oldest policy drops messages instead of blocking when
+        // the ring fills, so enabling debug logging during a paging storm
+        // doesn't perturb the threads being observed.
+        spdlog::init_thread_pool(8192, 1);
+
+        auto logger = std::make_shared<spdlog::async_logger>(
+            "rocky",
+            std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+            spdlog::thread_pool(),
+            spdlog::async_overflow_policy::overrun_oldest);
+
+        spdlog::register_logger(logger);
+
         logger->set_pattern("%^[%n %l]%$ %v");
 
         std::string log_level = util::getEnvVar("ROCKY_LOG_LEVEL");
@@ -13,3 +13,50 @@ namespace ROCKY_NAMESPACE
 
     extern ROCKY_EXPORT std::shared_ptr<spdlog::logger> Log();
 }
+
+// Logging macros with compile-time level elision. Statements below
+// ROCKY_LOG_ACTIVE_LEVEL vanish entirely from the build - arguments are
+// never evaluated - so instrumented builds can carry heavy trace/debug
+// statements in hot paths and still behave like production builds.
+// Enabled levels still check the runtime level before evaluating their
+// arguments, so a disabled debug message costs one predictable branch.
+#ifndef ROCKY_LOG_ACTIVE_LEVEL
+#define ROCKY_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+#define ROCKY_LOG_IMPL(lvl, ...) \
+    do { \
+        auto _rocky_logger = ROCKY_NAMESPACE::Log(); \
+        if (_rocky_logger && _rocky_logger->should_log(lvl)) \
+            _rocky_logger->log(lvl, __VA_ARGS__); \
+    } while (0)
+
+#if ROCKY_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define ROCKY_LOG_TRACE(...) ROCKY_LOG_IMPL(spdlog::level::trace, __VA_ARGS__)
+#else
+#define ROCKY_LOG_TRACE(...) (void)0
+#endif
+
+#if ROCKY_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define ROCKY_LOG_DEBUG(...) ROCKY_LOG_IMPL(spdlog::level::debug, __VA_ARGS__)
+#else
+#define ROCKY_LOG_DEBUG(...) (void)0
+#endif
+
+#if ROCKY_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define ROCKY_LOG_INFO(...) ROCKY_LOG_IMPL(spdlog::level::info, __VA_ARGS__)
+#else
+#define ROCKY_LOG_INFO(...) (void)0
+#endif
+
+#if ROCKY_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define ROCKY_LOG_WARN(...) ROCKY_LOG_IMPL(spdlog::level::warn, __VA_ARGS__)
+#else
+#define ROCKY_LOG_WARN(...) (void)0
+#endif
+
+#if ROCKY_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define ROCKY_LOG_ERROR(...) ROCKY_LOG_IMPL(spdlog::level::err, __VA_ARGS__)
+#else
+#define ROCKY_LOG_ERROR(...) (void)0
+#endif
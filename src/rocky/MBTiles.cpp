@@ -35,9 +35,62 @@ MBTiles::Driver::~Driver()
     close();
 }
 
+MBTiles::Driver::ReadConnection::~ReadConnection()
+{
+    if (select != nullptr)
+        sqlite3_finalize((sqlite3_stmt*)select);
+
+    if (selectRange != nullptr)
+        sqlite3_finalize((sqlite3_stmt*)selectRange);
+
+    if (database != nullptr)
+        sqlite3_close_v2((sqlite3*)database);
+}
+
+Status
+MBTiles::Driver::openReadConnection(ReadConnection& conn) const
+{
+    if (conn.database == nullptr)
+    {
+        int rc = sqlite3_open_v2(_filename.c_str(), (sqlite3**)&conn.database,
+            SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, 0L);
+        if (rc != 0)
+        {
+            return Status(Status::ResourceUnavailable, util::make_string()
+                << "Database \"" << _filename << "\": " << sqlite3_errmsg((sqlite3*)conn.database));
+        }
+    }
+    return StatusOK;
+}
+
+Result<std::shared_ptr<Image>>
+MBTiles::Driver::decodeTile(std::string& dataBuffer, const IOOptions& io) const
+{
+#ifdef ROCKY_HAS_ZLIB
+    // decompress if necessary:
+    if (_options.compress == true)
+    {
+        std::istringstream inputStream(dataBuffer);
+        std::string value;
+
+        if (!util::ZLibCompressor().decompress(inputStream, value))
+        {
+            return Status(Status::GeneralError, "Decompression failed");
+        }
+        dataBuffer = value;
+    }
+#endif // ROCKY_HAS_ZLIB
+
+    // decode the raw image data:
+    std::istringstream inputStream(dataBuffer);
+    return io.services.readImageFromStream(inputStream, {}, io);
+}
+
 void
 MBTiles::Driver::close()
 {
+    _readConnections.clear();
+
     if (_database != nullptr)
     {
         sqlite3* database = (sqlite3*)_database;
@@ -99,6 +152,17 @@ MBTiles::Driver::open(
             << "Database \"" << fullFilename << "\": " << sqlite3_errmsg(database));
     }
 
+    // remember the filename so reader threads can open their own connections.
+    _filename = fullFilename;
+
+    // WAL journaling lets the per-thread readers keep going while tiles are
+    // being written, instead of blocking on the rollback journal. (It can
+    // only be enabled through a writable connection.)
+    if (readWrite)
+    {
+        sqlite3_exec((sqlite3*)_database, "PRAGMA journal_mode=WAL;", 0L, 0L, 0L);
+    }
+
     // New database setup:
     if (isNewDatabase)
     {
@@ -291,8 +355,6 @@ MBTiles::Driver::readMaxLevel()
 Result<std::shared_ptr<Image>>
 MBTiles::Driver::read(const TileKey& key, const IOOptions& io) const
 {
-    std::scoped_lock lock(_mutex);
-
     int z = key.level;
     int x = key.x;
     int y = key.y;
@@ -311,28 +373,34 @@ MBTiles::Driver::read(const TileKey& key, const IOOptions& io) const
     auto [numCols, numRows] = key.profile.numTiles(key.level);
     y = numRows - y - 1;
 
-    sqlite3* database = (sqlite3*)_database;
-
-    //Get the image
-    sqlite3_stmt* select = NULL;
-    std::string query = "SELECT tile_data from tiles where zoom_level = ? AND tile_column = ? AND tile_row = ?";
-    int rc = sqlite3_prepare_v2(database, query.c_str(), -1, &select, 0L);
-    if (rc != SQLITE_OK)
+    // Fetch this thread's connection, opening it (and compiling the tile
+    // query) on first use:
+    auto& conn = _readConnections.value();
+    if (conn.select == nullptr)
     {
-        return Status(Status::GeneralError, util::make_string()
-            << "Failed to prepare SQL: " << query << "; " << sqlite3_errmsg(database));
+        Status s = openReadConnection(conn);
+        if (s.failed())
+            return s;
+
+        std::string query = "SELECT tile_data from tiles where zoom_level = ? AND tile_column = ? AND tile_row = ?";
+        int rc = sqlite3_prepare_v2((sqlite3*)conn.database, query.c_str(), -1, (sqlite3_stmt**)&conn.select, 0L);
+        if (rc != SQLITE_OK)
+        {
+            return Status(Status::GeneralError, util::make_string()
+                << "Failed to prepare SQL: " << query << "; " << sqlite3_errmsg((sqlite3*)conn.database));
+        }
     }
 
-    bool valid = true;
+    sqlite3_stmt* select = (sqlite3_stmt*)conn.select;
+    sqlite3_reset(select);
 
     sqlite3_bind_int(select, 1, z);
     sqlite3_bind_int(select, 2, x);
     sqlite3_bind_int(select, 3, y);
 
     Result<std::shared_ptr<Image>> result;
-    std::string errorMessage;
 
-    rc = sqlite3_step(select);
+    int rc = sqlite3_step(select);
     if (rc == SQLITE_ROW)
     {
         // the pointer returned from _blob gets freed internally by sqlite, supposedly
@@ -341,41 +409,124 @@ MBTiles::Driver::read(const TileKey& key, const IOOptions& io) const
 
         std::string dataBuffer(data, dataLen);
 
-#ifdef ROCKY_HAS_ZLIB
-        // decompress if necessary:
-        if (_options.compress == true)
+        result = decodeTile(dataBuffer, io);
+    }
+
+    // reset (rather than finalize) so the compiled statement survives for
+    // the next query on this thread:
+    sqlite3_reset(select);
+
+    return result;
+}
+
+std::vector<Result<std::shared_ptr<Image>>>
+MBTiles::Driver::readTiles(const std::vector<TileKey>& keys, const IOOptions& io) const
+{
+    // the default result is ResourceUnavailable, same as a single-tile miss.
+    std::vector<Result<std::shared_ptr<Image>>> results(keys.size());
+
+    if (keys.empty())
+        return results;
+
+    // the flipped database coordinates of each requested key:
+    struct Lookup { int z = -1, x = 0, y = 0; bool pending = false; };
+    std::vector<Lookup> lookups(keys.size());
+
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        int z = keys[i].level;
+        if (z < (int)_minLevel || z > (int)_maxLevel)
+            continue;
+
+        auto [numCols, numRows] = keys[i].profile.numTiles(keys[i].level);
+        lookups[i] = { z, (int)keys[i].x, (int)(numRows - keys[i].y - 1), true };
+    }
+
+    auto& conn = _readConnections.value();
+    if (conn.selectRange == nullptr)
+    {
+        Status s = openReadConnection(conn);
+        if (s.failed())
         {
-            std::istringstream inputStream(dataBuffer);
-            std::string value;
+            for (auto& result : results)
+                result = s;
+            return results;
+        }
 
-            if (!util::ZLibCompressor().decompress(inputStream, value))
-            {
-                errorMessage = "Decompression failed";
-                valid = false;
-            }
-            else
+        std::string query =
+            "SELECT tile_column, tile_row, tile_data from tiles where zoom_level = ? "
+            "AND tile_column BETWEEN ? AND ? AND tile_row BETWEEN ? AND ?";
+
+        int rc = sqlite3_prepare_v2((sqlite3*)conn.database, query.c_str(), -1, (sqlite3_stmt**)&conn.selectRange, 0L);
+        if (rc != SQLITE_OK)
+        {
+            Status error(Status::GeneralError, util::make_string()
+                << "Failed to prepare SQL: " << query << "; " << sqlite3_errmsg((sqlite3*)conn.database));
+            for (auto& result : results)
+                result = error;
+            return results;
+        }
+    }
+
+    sqlite3_stmt* select = (sqlite3_stmt*)conn.selectRange;
+
+    // one ranged query per zoom level present in the batch:
+    for (std::size_t first = 0; first < lookups.size(); ++first)
+    {
+        if (!lookups[first].pending)
+            continue;
+
+        int z = lookups[first].z;
+        int minX = lookups[first].x, maxX = minX;
+        int minY = lookups[first].y, maxY = minY;
+
+        for (std::size_t i = first + 1; i < lookups.size(); ++i)
+        {
+            if (lookups[i].pending && lookups[i].z == z)
             {
-                dataBuffer = value;
+                minX = std::min(minX, lookups[i].x), maxX = std::max(maxX, lookups[i].x);
+                minY = std::min(minY, lookups[i].y), maxY = std::max(maxY, lookups[i].y);
             }
         }
-#endif // ROCKY_HAS_ZLIB
 
-        // decode the raw image data:
-        if (valid)
+        sqlite3_reset(select);
+        sqlite3_bind_int(select, 1, z);
+        sqlite3_bind_int(select, 2, minX);
+        sqlite3_bind_int(select, 3, maxX);
+        sqlite3_bind_int(select, 4, minY);
+        sqlite3_bind_int(select, 5, maxY);
+
+        while (sqlite3_step(select) == SQLITE_ROW)
         {
-            std::istringstream inputStream(dataBuffer);
-            result = io.services.readImageFromStream(inputStream, {}, io);
+            int x = sqlite3_column_int(select, 0);
+            int y = sqlite3_column_int(select, 1);
+
+            // match the row back to a requested key. (the range can cover
+            // cells no one asked for; skip those.)
+            for (std::size_t i = first; i < lookups.size(); ++i)
+            {
+                if (lookups[i].pending && lookups[i].z == z && lookups[i].x == x && lookups[i].y == y)
+                {
+                    const char* data = (const char*)sqlite3_column_blob(select, 2);
+                    int dataLen = sqlite3_column_bytes(select, 2);
+
+                    std::string dataBuffer(data, dataLen);
+
+                    results[i] = decodeTile(dataBuffer, io);
+                    lookups[i].pending = false;
+                }
+            }
         }
-    }
 
-    sqlite3_finalize(select);
+        sqlite3_reset(select);
 
-    if (!valid)
-    {
-        result = Status(Status::GeneralError, errorMessage);
+        // anything still pending at this level simply isn't in the database:
+        for (std::size_t i = first; i < lookups.size(); ++i)
+            if (lookups[i].z == z)
+                lookups[i].pending = false;
     }
 
-    return result;
+    return results;
 }
 
 
@@ -8,6 +8,7 @@
 #ifdef ROCKY_HAS_MBTILES
 
 #include <rocky/Status.h>
+#include <rocky/Threading.h>
 #include <rocky/URI.h>
 #include <rocky/TileKey.h>
 
@@ -55,6 +56,13 @@ namespace ROCKY_NAMESPACE
                 const TileKey& key,
                 const IOOptions& io) const;
 
+            //! Reads a batch of tiles in one pass, issuing a single ranged
+            //! query per zoom level instead of one query per key. Returns
+            //! one result per input key, in the same order.
+            std::vector<Result<std::shared_ptr<Image>>> readTiles(
+                const std::vector<TileKey>& keys,
+                const IOOptions& io) const;
+
             Status write(
                 const TileKey& key,
                 std::shared_ptr<Image> image,
@@ -70,13 +78,31 @@ namespace ROCKY_NAMESPACE
             mutable unsigned _maxLevel;
             std::shared_ptr<Image> _emptyImage;
             Options _options;
+            std::string _filename;
             std::string _tileFormat;
             bool _forceRGB;
             std::string _name;
 
             // because no one knows if/when sqlite3 is threadsafe.
+            // (guards the shared write/metadata connection only; the read
+            // path uses per-thread connections instead)
             mutable std::mutex _mutex;
 
+            // Read-only connection with a precompiled tile query, one per
+            // reader thread, so concurrent reads neither serialize on a
+            // single connection nor recompile the SQL on every query.
+            struct ReadConnection
+            {
+                void* database = nullptr;     // sqlite3*
+                void* select = nullptr;       // sqlite3_stmt* (single tile)
+                void* selectRange = nullptr;  // sqlite3_stmt* (ranged batch)
+                ~ReadConnection();
+            };
+            mutable util::ThreadLocal<ReadConnection> _readConnections;
+
+            Status openReadConnection(ReadConnection& conn) const;
+            Result<std::shared_ptr<Image>> decodeTile(std::string& dataBuffer, const IOOptions& io) const;
+
             bool createTables();
             void computeLevels();
             Result<int> readMaxLevel();
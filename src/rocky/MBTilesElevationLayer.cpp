@@ -93,10 +93,52 @@ MBTilesElevationLayer::createHeightfieldImplementation(const TileKey& key, const
 {
     if (status().failed()) return status();
 
-    auto result = _driver.read(key, io);
+    Result<std::shared_ptr<Image>> result;
+
+    // a sibling's earlier read-ahead may have already pulled in this tile:
+    auto cached = _siblingCache.get(key);
+    if (cached)
+    {
+        result = cached;
+    }
+    else if (key.level > 0)
+    {
+        // when the terrain refines, all four children of a parent get
+        // requested back to back; grab the whole quad in one database pass
+        // and hold the siblings for the requests that follow.
+        TileKey parent = key.createParentKey();
+        std::vector<TileKey> quad = {
+            parent.createChildKey(0), parent.createChildKey(1),
+            parent.createChildKey(2), parent.createChildKey(3) };
+
+        auto results = _driver.readTiles(quad, io);
+
+        for (std::size_t i = 0; i < quad.size(); ++i)
+        {
+            if (quad[i] == key)
+                result = results[i];
+            else if (results[i].status.ok())
+                _siblingCache.put(quad[i], results[i].value);
+        }
+    }
+    else
+    {
+        result = _driver.read(key, io);
+    }
 
     if (result.status.ok())
-        return GeoHeightfield(Heightfield::create(result.value.get()), key.extent());
+    {
+        // single-channel tiles (including raw R32 float) convert directly;
+        // RGB-encoded tiles go through the encoding decoder.
+        auto hf = result.value->numComponents() == 1 ?
+            decodeSingleChannel(result.value) :
+            decodeRGB(result.value);
+
+        if (hf)
+            return GeoHeightfield(hf, key.extent());
+        else
+            return Status(Status::ResourceUnavailable, "Failed to decode elevation tile");
+    }
     else
         return result.status;
 }
@@ -8,6 +8,7 @@
 #ifdef ROCKY_HAS_MBTILES
 
 #include <rocky/ElevationLayer.h>
+#include <rocky/LRUCache.h>
 
 namespace ROCKY_NAMESPACE
 {
@@ -41,6 +42,11 @@ namespace ROCKY_NAMESPACE
 
     private:
         MBTiles::Driver _driver;
+
+        // tiles batched in by a sibling's quad read-ahead, awaiting their
+        // own requests (see createHeightfieldImplementation)
+        mutable util::LRUCache<TileKey, std::shared_ptr<Image>> _siblingCache{ 16 };
+
         void construct(const std::string& JSON, const IOOptions& io);
     };
 }
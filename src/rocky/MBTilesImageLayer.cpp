@@ -95,6 +95,38 @@ MBTilesImageLayer::createImageImplementation(const TileKey& key, const IOOptions
 {
     if (status().failed()) return status();
 
+    // a previous sibling's read-ahead may have already fetched this tile:
+    auto cached = _siblingCache.get(key);
+    if (cached)
+        return GeoImage(cached, key.extent());
+
+    // Subtree refinement requests all four children of a parent in short
+    // order, so read the whole quad in one database pass and stash the
+    // siblings for the requests that follow.
+    if (key.level > 0)
+    {
+        TileKey parent = key.createParentKey();
+        std::vector<TileKey> quad = {
+            parent.createChildKey(0), parent.createChildKey(1),
+            parent.createChildKey(2), parent.createChildKey(3) };
+
+        auto results = _driver.readTiles(quad, io);
+
+        Result<std::shared_ptr<Image>> mine;
+        for (std::size_t i = 0; i < quad.size(); ++i)
+        {
+            if (quad[i] == key)
+                mine = results[i];
+            else if (results[i].status.ok())
+                _siblingCache.put(quad[i], results[i].value);
+        }
+
+        if (mine.status.ok())
+            return GeoImage(mine.value, key.extent());
+        else
+            return mine.status;
+    }
+
     auto result = _driver.read(key, io);
 
     if (result.status.ok())
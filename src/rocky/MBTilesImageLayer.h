@@ -8,6 +8,7 @@
 #ifdef ROCKY_HAS_MBTILES
 
 #include <rocky/ImageLayer.h>
+#include <rocky/LRUCache.h>
 
 namespace ROCKY_NAMESPACE
 {
@@ -42,6 +43,10 @@ namespace ROCKY_NAMESPACE
     private:
         MBTiles::Driver _driver;
 
+        // tiles batched in by a sibling's quad read-ahead, awaiting their
+        // own requests (see createImageImplementation)
+        mutable util::LRUCache<TileKey, std::shared_ptr<Image>> _siblingCache{ 16 };
+
         void construct(const std::string& JSON, const IOOptions& io);
     };
 }
@@ -0,0 +1,500 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "MVT.h"
+#include "Log.h"
+#include "Utils.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string_view>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[MVT] "
+
+namespace
+{
+    // Minimal zero-copy protobuf reader over a byte range. Every
+    // accessor checks its bounds and latches "ok" false on a malformed
+    // stream, so callers can parse first and validate once at the end.
+    struct Reader
+    {
+        const std::uint8_t* p = nullptr;
+        const std::uint8_t* end = nullptr;
+        bool ok = true;
+
+        Reader(std::string_view bytes) :
+            p((const std::uint8_t*)bytes.data()),
+            end((const std::uint8_t*)bytes.data() + bytes.size()) { }
+
+        bool more() const {
+            return ok && p < end;
+        }
+
+        std::uint64_t varint()
+        {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (p >= end)
+                {
+                    ok = false;
+                    return 0;
+                }
+                std::uint8_t byte = *p++;
+                value |= (std::uint64_t)(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                    return value;
+            }
+            ok = false;
+            return 0;
+        }
+
+        std::int64_t zigzag()
+        {
+            auto v = varint();
+            return (std::int64_t)(v >> 1) ^ -(std::int64_t)(v & 1);
+        }
+
+        std::string_view bytes()
+        {
+            auto length = varint();
+            if (!ok || (std::uint64_t)(end - p) < length)
+            {
+                ok = false;
+                return {};
+            }
+            std::string_view result((const char*)p, length);
+            p += length;
+            return result;
+        }
+
+        //! Reads the next field tag; false at end of stream
+        bool next(std::uint32_t& field, std::uint32_t& wire)
+        {
+            if (!more())
+                return false;
+            auto tag = varint();
+            field = (std::uint32_t)(tag >> 3);
+            wire = (std::uint32_t)(tag & 0x7);
+            return ok;
+        }
+
+        void skip(std::uint32_t wire)
+        {
+            if (wire == 0) // varint
+                varint();
+            else if (wire == 1) // fixed64
+                p = (end - p) >= 8 ? p + 8 : (ok = false, end);
+            else if (wire == 2) // length-delimited
+                bytes();
+            else if (wire == 5) // fixed32
+                p = (end - p) >= 4 ? p + 4 : (ok = false, end);
+            else
+                ok = false;
+        }
+    };
+
+    // decodes an MVT Value message into the all-members-filled union the
+    // rest of the feature code expects (see the OGR reader)
+    Feature::FieldValueUnion decodeValue(std::string_view message)
+    {
+        Reader pb(message);
+        std::uint32_t field, wire;
+
+        while (pb.next(field, wire))
+        {
+            switch (field)
+            {
+            case 1: // string
+            {
+                std::string value(pb.bytes());
+                bool truthy = util::toLower(value) == "true";
+                return { value, 0.0, 0, truthy };
+            }
+            case 2: // float
+            {
+                if (pb.end - pb.p < 4) { pb.ok = false; break; }
+                float value;
+                std::memcpy(&value, pb.p, 4);
+                return { std::to_string(value), (double)value, (long long)value, value != 0.0f };
+            }
+            case 3: // double
+            {
+                if (pb.end - pb.p < 8) { pb.ok = false; break; }
+                double value;
+                std::memcpy(&value, pb.p, 8);
+                return { std::to_string(value), value, (long long)value, value != 0.0 };
+            }
+            case 4: // int64
+            case 5: // uint64
+            {
+                auto value = (long long)pb.varint();
+                return { std::to_string(value), (double)value, value, value != 0 };
+            }
+            case 6: // sint64
+            {
+                auto value = (long long)pb.zigzag();
+                return { std::to_string(value), (double)value, value, value != 0 };
+            }
+            case 7: // bool
+            {
+                bool value = pb.varint() != 0;
+                return { value ? "true" : "false", value ? 1.0 : 0.0, value ? 1LL : 0LL, value };
+            }
+            default:
+                pb.skip(wire);
+                break;
+            }
+
+            if (!pb.ok)
+                break;
+        }
+
+        return {};
+    }
+
+    // signed area of a ring (in world coordinates); positive = CCW
+    double signedArea(const std::vector<glm::dvec3>& ring)
+    {
+        double area = 0.0;
+        for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+        {
+            area += (ring[j].x * ring[i].y) - (ring[i].x * ring[j].y);
+        }
+        return 0.5 * area;
+    }
+
+    // decodes the packed geometry commands into world-space parts
+    std::vector<std::vector<glm::dvec3>> decodeGeometry(
+        std::string_view commands,
+        int geomType,
+        const GeoExtent& extent,
+        double tileExtent)
+    {
+        // tile-local y runs down from the top-left corner:
+        double scalex = extent.width() / tileExtent;
+        double scaley = extent.height() / tileExtent;
+
+        std::vector<std::vector<glm::dvec3>> parts;
+        std::vector<glm::dvec3> current;
+
+        std::int64_t x = 0, y = 0;
+
+        Reader pb(commands);
+        while (pb.more())
+        {
+            auto command = pb.varint();
+            auto op = command & 0x7;
+            auto count = command >> 3;
+
+            if (op == 1) // MoveTo
+            {
+                for (std::uint64_t i = 0; i < count && pb.ok; ++i)
+                {
+                    x += pb.zigzag();
+                    y += pb.zigzag();
+
+                    // points accumulate into one part; every other type
+                    // starts a new part on MoveTo:
+                    if (geomType != 1 && !current.empty())
+                    {
+                        parts.emplace_back(std::move(current));
+                        current = {};
+                    }
+
+                    current.emplace_back(
+                        extent.xmin() + (double)x * scalex,
+                        extent.ymax() - (double)y * scaley,
+                        0.0);
+                }
+            }
+            else if (op == 2) // LineTo
+            {
+                for (std::uint64_t i = 0; i < count && pb.ok; ++i)
+                {
+                    x += pb.zigzag();
+                    y += pb.zigzag();
+
+                    current.emplace_back(
+                        extent.xmin() + (double)x * scalex,
+                        extent.ymax() - (double)y * scaley,
+                        0.0);
+                }
+            }
+            else if (op == 7) // ClosePath
+            {
+                // rings stay open; consumers close them implicitly
+            }
+            else
+            {
+                return {}; // malformed
+            }
+        }
+
+        if (!pb.ok)
+            return {};
+
+        if (!current.empty())
+            parts.emplace_back(std::move(current));
+
+        return parts;
+    }
+
+    // assembles decoded parts into a rocky Geometry
+    Geometry assembleGeometry(std::vector<std::vector<glm::dvec3>>&& parts, int geomType)
+    {
+        Geometry geometry;
+
+        if (geomType == 1) // point(s)
+        {
+            geometry.type = Geometry::Type::Points;
+            if (!parts.empty())
+                geometry.points = std::move(parts.front());
+        }
+        else if (geomType == 2) // linestring(s)
+        {
+            if (parts.size() == 1)
+            {
+                geometry.type = Geometry::Type::LineString;
+                geometry.points = std::move(parts.front());
+            }
+            else
+            {
+                geometry.type = Geometry::Type::MultiLineString;
+                geometry.parts.reserve(parts.size());
+                for (auto& part : parts)
+                {
+                    auto& line = geometry.parts.emplace_back();
+                    line.type = Geometry::Type::LineString;
+                    line.points = std::move(part);
+                }
+            }
+        }
+        else if (geomType == 3) // polygon(s)
+        {
+            // The y-flip into world space makes exterior rings CCW
+            // (positive area) and holes CW, which is the winding the
+            // Geometry type wants. Each exterior starts a new polygon;
+            // holes attach to the polygon that precedes them.
+            std::vector<Geometry> polygons;
+
+            for (auto& ring : parts)
+            {
+                if (ring.size() < 3)
+                    continue;
+
+                if (signedArea(ring) >= 0.0 || polygons.empty())
+                {
+                    auto& polygon = polygons.emplace_back();
+                    polygon.type = Geometry::Type::Polygon;
+                    polygon.points = std::move(ring);
+                }
+                else
+                {
+                    auto& hole = polygons.back().parts.emplace_back();
+                    hole.type = Geometry::Type::Polygon;
+                    hole.points = std::move(ring);
+                }
+            }
+
+            if (polygons.size() == 1)
+            {
+                geometry = std::move(polygons.front());
+            }
+            else
+            {
+                geometry.type = Geometry::Type::MultiPolygon;
+                geometry.parts = std::move(polygons);
+            }
+        }
+
+        return geometry;
+    }
+
+    // decodes one layer's features into the output collection
+    void decodeLayer(
+        std::string_view message,
+        const TileKey& key,
+        const std::vector<std::string>& layers,
+        std::vector<Feature>& out)
+    {
+        Reader pb(message);
+        std::uint32_t field, wire;
+
+        // Feature messages may precede the key/value tables they index,
+        // so hold their (zero-copy) byte ranges and decode them last.
+        std::string name;
+        double tileExtent = 4096.0;
+        std::vector<std::string_view> featureMessages;
+        std::vector<std::string_view> keys;
+        std::vector<std::string_view> valueMessages;
+
+        while (pb.next(field, wire))
+        {
+            switch (field)
+            {
+            case 1: // name
+                name = std::string(pb.bytes());
+                break;
+            case 2: // feature
+                featureMessages.emplace_back(pb.bytes());
+                break;
+            case 3: // key
+                keys.emplace_back(pb.bytes());
+                break;
+            case 4: // value
+                valueMessages.emplace_back(pb.bytes());
+                break;
+            case 5: // extent
+                tileExtent = (double)pb.varint();
+                break;
+            default:
+                pb.skip(wire);
+                break;
+            }
+        }
+
+        if (!pb.ok || tileExtent <= 0.0)
+            return;
+
+        if (!layers.empty() &&
+            std::find(layers.begin(), layers.end(), name) == layers.end())
+        {
+            return;
+        }
+
+        // decode each referenced value at most once:
+        std::vector<Feature::FieldValueUnion> values(valueMessages.size());
+        std::vector<bool> valueDecoded(valueMessages.size(), false);
+
+        auto& extent = key.extent();
+
+        for (auto& featureMessage : featureMessages)
+        {
+            Reader fpb(featureMessage);
+
+            Feature feature;
+            feature.srs = key.profile.srs();
+            int geomType = 0;
+            std::string_view geometry;
+            std::vector<std::uint32_t> tags;
+
+            while (fpb.next(field, wire))
+            {
+                switch (field)
+                {
+                case 1: // id
+                    feature.id = (Feature::ID)fpb.varint();
+                    break;
+                case 2: // tags (packed)
+                {
+                    Reader tpb(fpb.bytes());
+                    while (tpb.more())
+                        tags.emplace_back((std::uint32_t)tpb.varint());
+                    break;
+                }
+                case 3: // type
+                    geomType = (int)fpb.varint();
+                    break;
+                case 4: // geometry (packed commands)
+                    geometry = fpb.bytes();
+                    break;
+                default:
+                    fpb.skip(wire);
+                    break;
+                }
+            }
+
+            if (!fpb.ok || geomType < 1 || geomType > 3)
+                continue;
+
+            feature.geometry = assembleGeometry(
+                decodeGeometry(geometry, geomType, extent, tileExtent),
+                geomType);
+
+            if (feature.geometry.points.empty() && feature.geometry.parts.empty())
+                continue;
+
+            for (std::size_t i = 0; i + 1 < tags.size(); i += 2)
+            {
+                auto k = tags[i], v = tags[i + 1];
+                if (k >= keys.size() || v >= values.size())
+                    continue;
+
+                if (!valueDecoded[v])
+                {
+                    values[v] = decodeValue(valueMessages[v]);
+                    valueDecoded[v] = true;
+                }
+
+                feature.fields.emplace(std::string(keys[k]), values[v]);
+            }
+
+            feature.fields.emplace(MVT::LAYER_FIELD,
+                Feature::FieldValueUnion{ name, 0.0, 0, false });
+
+            feature.dirtyExtent();
+
+            out.emplace_back(std::move(feature));
+        }
+    }
+}
+
+std::vector<Feature>
+MVT::decodeTile(
+    const std::string& data,
+    const TileKey& key,
+    const std::vector<std::string>& layers)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(key.valid(), {});
+
+    std::vector<Feature> result;
+
+    if (data.empty())
+        return result;
+
+    // inflate a gzip- or zlib-wrapped payload first:
+    std::string_view payload(data);
+    std::string inflated;
+
+    if (data.size() >= 2 &&
+        (((std::uint8_t)data[0] == 0x1f && (std::uint8_t)data[1] == 0x8b) ||
+         ((std::uint8_t)data[0] == 0x78)))
+    {
+#ifdef ROCKY_HAS_ZLIB
+        std::istringstream in(data);
+        if (!util::ZLibCompressor().decompress(in, inflated))
+        {
+            Log()->warn(LC "failed to inflate tile {}", key.str());
+            return result;
+        }
+        payload = inflated;
+#else
+        Log()->warn(LC "tile {} is compressed, but zlib support is not compiled in", key.str());
+        return result;
+#endif
+    }
+
+    Reader pb(payload);
+    std::uint32_t field, wire;
+
+    while (pb.next(field, wire))
+    {
+        if (field == 3 && wire == 2) // layer
+            decodeLayer(pb.bytes(), key, layers, result);
+        else
+            pb.skip(wire);
+    }
+
+    if (!pb.ok)
+    {
+        Log()->warn(LC "malformed tile {}", key.str());
+        result.clear();
+    }
+
+    return result;
+}
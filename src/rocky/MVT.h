@@ -0,0 +1,48 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/Common.h>
+#include <rocky/Feature.h>
+#include <rocky/TileKey.h>
+#include <string>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Decoder for Mapbox Vector Tiles (MVT).
+     *
+     * Parses the tile's protobuf encoding directly off the wire bytes -
+     * varints, zigzag deltas and all - into Feature geometry, with no
+     * protobuf library and no intermediate copies of the payload. Decode
+     * is self-contained and thread-safe, so callers (like a feature tile
+     * pager) can decode each tile on a worker thread as it arrives.
+     */
+    namespace MVT
+    {
+        //! Name of the synthetic field on each decoded feature carrying
+        //! the name of the MVT layer it came from
+        constexpr const char* LAYER_FIELD = "mvt_layer";
+
+        //! Decodes one vector tile into features.
+        //!
+        //! Tile-local coordinates map into the key's extent, so the
+        //! features come out in the key's profile SRS. Attributes decode
+        //! into the feature fields, and each feature gains a LAYER_FIELD
+        //! naming its source layer. Gzip- or zlib-compressed payloads
+        //! are inflated first when zlib support is compiled in.
+        //!
+        //! @param data The raw tile payload
+        //! @param key Tile key the payload corresponds to
+        //! @param layers Names of the layers to decode; empty = all
+        //! @return Decoded features; empty on a malformed payload
+        ROCKY_EXPORT std::vector<Feature> decodeTile(
+            const std::string& data,
+            const TileKey& key,
+            const std::vector<std::string>& layers = {});
+    }
+}
@@ -6,7 +6,13 @@
 #include "Map.h"
 #include "ImageLayer.h"
 #include "ElevationLayer.h"
+#include "GeoHeightfield.h"
+#include "Heightfield.h"
+#include "Log.h"
+#include "TileKey.h"
 #include "json.h"
+#include <atomic>
+#include <map>
 #include <tuple>
 
 using namespace ROCKY_NAMESPACE;
@@ -120,17 +126,173 @@ Map::add(std::shared_ptr<Layer> layer)
 Status
 Map::openAllLayers(const IOOptions& io)
 {
-    Status status;
+    return openAllLayersAsync(io).join();
+}
+
+jobs::future<Status>
+Map::openAllLayersAsync(const IOOptions& io)
+{
+    // snapshot the layers that want opening; disabled layers defer
+    // until someone opens them explicitly.
+    std::vector<std::shared_ptr<Layer>> toOpen;
     for (auto& layer : layers().all())
     {
         if (layer->openAutomatically && !layer->isOpen())
         {
-            auto layer_status = layer->open(io);
-            if (layer_status.failed())
+            toOpen.emplace_back(layer);
+        }
+    }
+
+    jobs::future<Status> promise;
+
+    if (toOpen.empty())
+    {
+        promise.resolve(Status_OK);
+        return promise;
+    }
+
+    // Each open runs in its own job so the network- and disk-bound opens
+    // overlap. The last one to land resolves the readiness future.
+    struct InFlight
+    {
+        std::atomic_int remaining;
+        std::atomic_bool anyFailed = { false };
+    };
+    auto inflight = std::make_shared<InFlight>();
+    inflight->remaining = (int)toOpen.size();
+
+    for (auto& layer : toOpen)
+    {
+        const IOOptions local_io(io);
+
+        auto open_one = [layer, inflight, promise, local_io](Cancelable&) mutable
+        {
+            auto status = layer->open(local_io);
+            if (status.failed())
+            {
+                Log()->warn(LC "layer \"{}\" failed to open: {}", layer->name(), status.message);
+                inflight->anyFailed = true;
+            }
+
+            if (inflight->remaining.fetch_sub(1) == 1)
             {
-                status = Status_GeneralError;
+                promise.resolve(inflight->anyFailed ? Status_GeneralError : Status_OK);
+            }
+            return true;
+        };
+
+        // can_cancel must be false since we discard the per-job futures;
+        // the aggregate future tracks completion instead.
+        jobs::dispatch(open_one, jobs::context{
+            "open layer " + layer->name(), jobs::get_pool("rocky.io", 4), {}, nullptr, false });
+    }
+
+    return promise;
+}
+
+namespace
+{
+    // Sampling guts shared by the blocking and async entry points. Only
+    // points whose z is still NO_DATA_VALUE sample, so the layers apply
+    // in map order and earlier answers win.
+    unsigned sampleElevationLayers(
+        const std::vector<std::shared_ptr<ElevationLayer>>& elevationLayers,
+        std::vector<glm::dvec3>& points,
+        const SRS& srs,
+        const IOOptions& io)
+    {
+        unsigned resolved = 0;
+
+        for (auto& layer : elevationLayers)
+        {
+            if (resolved == points.size())
+                break;
+
+            if (!layer->isOpen() || !layer->profile.valid())
+                continue;
+
+            auto toProfile = srs.to(layer->profile.srs());
+            if (!toProfile.valid())
+                continue;
+
+            // group the unresolved points by the deepest tile with data,
+            // so each tile reads once no matter how many points land in it:
+            std::map<TileKey, std::vector<std::size_t>> groups;
+            for (std::size_t i = 0; i < points.size(); ++i)
+            {
+                if (points[i].z != NO_DATA_VALUE)
+                    continue;
+
+                glm::dvec3 m;
+                if (!toProfile.transform(glm::dvec3(points[i].x, points[i].y, 0.0), m))
+                    continue;
+
+                auto key = TileKey::createTileKeyContainingPoint(
+                    m.x, m.y, layer->maxLevel.value(), layer->profile);
+
+                key = layer->bestAvailableTileKey(key);
+                if (key.valid())
+                    groups[key].emplace_back(i);
+            }
+
+            for (auto& [key, indices] : groups)
+            {
+                if (io.canceled())
+                    return resolved;
+
+                auto hf = layer->createHeightfield(key, io);
+                if (hf.status.failed() || !hf.value.valid())
+                    continue;
+
+                std::vector<glm::dvec3> batch;
+                batch.reserve(indices.size());
+                for (auto i : indices)
+                    batch.emplace_back(points[i].x, points[i].y, 0.0);
+
+                hf.value.heightAt(batch, toProfile, Interpolation::BILINEAR);
+
+                for (std::size_t j = 0; j < indices.size(); ++j)
+                {
+                    if (batch[j].z != NO_DATA_VALUE)
+                    {
+                        points[indices[j]].z = batch[j].z;
+                        ++resolved;
+                    }
+                }
             }
         }
+
+        return resolved;
     }
-    return status;
+}
+
+unsigned
+Map::elevation(std::vector<glm::dvec3>& points, const SRS& srs, const IOOptions& io) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(srs.valid(), 0);
+
+    for (auto& p : points)
+        p.z = NO_DATA_VALUE;
+
+    return sampleElevationLayers(layers().ofType<ElevationLayer>(), points, srs, io);
+}
+
+jobs::future<std::vector<glm::dvec3>>
+Map::elevationAsync(std::vector<glm::dvec3> points, const SRS& srs, const IOOptions& io) const
+{
+    // snapshot the layer stack into the job; the map itself need not
+    // outlive the query.
+    auto elevationLayers = layers().ofType<ElevationLayer>();
+    const IOOptions local_io(io);
+
+    return jobs::dispatch(
+        [elevationLayers, points(std::move(points)), srs, local_io](Cancelable&) mutable
+        {
+            for (auto& p : points)
+                p.z = NO_DATA_VALUE;
+
+            sampleElevationLayers(elevationLayers, points, srs, local_io);
+            return std::move(points);
+        },
+        jobs::context{ "map elevation query", jobs::get_pool("rocky.io", 4) });
 }
@@ -44,6 +44,33 @@ namespace ROCKY_NAMESPACE
         //! and check for errors.
         Status openAllLayers(const IOOptions& options);
 
+        //! Like openAllLayers(), but each open runs as its own job so
+        //! network- and disk-bound opens overlap instead of serializing;
+        //! a map full of slow layers comes up in the time of the slowest
+        //! open, not the sum of all of them. Returns a readiness future
+        //! that resolves once the last open lands, so callers (like
+        //! MapNode) can keep rendering while the map comes up. Layers not
+        //! marked openAutomatically stay closed until opened explicitly.
+        //! @return Future status: OK, or GeneralError if any layer failed
+        jobs::future<Status> openAllLayersAsync(const IOOptions& options);
+
+        //! Samples the elevation at a batch of points from the map's
+        //! elevation layers, replacing each point's z with its height (or
+        //! NO_DATA_VALUE where no layer has data). Layers are consulted in
+        //! order at their best available resolution, with the points
+        //! grouped by tile so each tile reads once. This blocks on layer
+        //! I/O; prefer elevationAsync() from anything latency-sensitive,
+        //! or MapNode::elevationAsync to reuse resident terrain data.
+        //! @param points Points to sample; z is replaced in place
+        //! @param srs Spatial reference of the points
+        //! @param io I/O options for the layer reads
+        //! @return Number of points that yielded a valid height
+        unsigned elevation(std::vector<glm::dvec3>& points, const SRS& srs, const IOOptions& io) const;
+
+        //! Like elevation(), but the sampling runs on the jobs pool and
+        //! the sampled points come back through a future.
+        jobs::future<std::vector<glm::dvec3>> elevationAsync(std::vector<glm::dvec3> points, const SRS& srs, const IOOptions& io) const;
+
         //! Gets the revision # of the map. The revision # changes every time
         //! you add, remove, or move layers. You can use this to track changes
         //! in the map model (as a alternative to installing a MapCallback).
@@ -0,0 +1,183 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "MapSnapshot.h"
+#include "Map.h"
+#include "Context.h"
+#include "Log.h"
+#include "json.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[MapSnapshot] "
+
+namespace
+{
+    // snapshot format: magic line, source-file validators, then
+    // length-prefixed records (same on-disk idiom as the IO replay
+    // archive). Bump the trailing number when the record layout changes;
+    // an old snapshot then reads as stale and the caller re-probes.
+    const char* magic = "ROCKY-MAP-SNAPSHOT-1\n";
+
+    void writeString(std::ofstream& out, const std::string& s)
+    {
+        std::uint64_t len = s.size();
+        out.write((const char*)&len, sizeof(len));
+        out.write(s.data(), (std::streamsize)len);
+    }
+
+    bool readString(std::ifstream& in, std::string& s)
+    {
+        std::uint64_t len = 0;
+        if (!in.read((char*)&len, sizeof(len)))
+            return false;
+        s.resize(len);
+        return (bool)in.read(s.data(), (std::streamsize)len);
+    }
+
+    // size and mtime of the configuration file the snapshot was built
+    // from; a change in either invalidates the snapshot.
+    bool statSource(const std::string& path, std::uint64_t& size, std::int64_t& mtime)
+    {
+        std::error_code ec;
+        size = (std::uint64_t)std::filesystem::file_size(path, ec);
+        if (ec)
+            return false;
+
+        auto t = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return false;
+
+        mtime = (std::int64_t)std::chrono::duration_cast<std::chrono::seconds>(
+            t.time_since_epoch()).count();
+        return true;
+    }
+}
+
+Status
+MapSnapshot::write(std::shared_ptr<Map> map, const std::string& sourcePath, const std::string& snapshotPath)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(map, Status(Status::AssertionFailure));
+
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceMTime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMTime))
+    {
+        return Status(Status::ResourceUnavailable, "Cannot stat source file " + sourcePath);
+    }
+
+    std::ofstream out(snapshotPath, std::ios::binary);
+    if (!out.is_open())
+    {
+        return Status(Status::ResourceUnavailable, "Cannot write snapshot " + snapshotPath);
+    }
+
+    out.write(magic, (std::streamsize)strlen(magic));
+    out.write((const char*)&sourceSize, sizeof(sourceSize));
+    out.write((const char*)&sourceMTime, sizeof(sourceMTime));
+
+    writeString(out, map->name());
+
+    auto layers = map->layers().all();
+    std::uint64_t count = layers.size();
+    out.write((const char*)&count, sizeof(count));
+
+    for (auto& layer : layers)
+    {
+        writeString(out, layer->to_json());
+        writeString(out, layer->snapshotState());
+    }
+
+    if (!out)
+    {
+        return Status(Status::GeneralError, "Error writing snapshot " + snapshotPath);
+    }
+
+    Log()->info(LC "wrote {} ({} layers)", snapshotPath, count);
+    return StatusOK;
+}
+
+Result<std::shared_ptr<Map>>
+MapSnapshot::read(const std::string& sourcePath, const std::string& snapshotPath, const IOOptions& io)
+{
+    std::ifstream in(snapshotPath, std::ios::binary);
+    if (!in.is_open())
+    {
+        return Status(Status::ResourceUnavailable, "No snapshot at " + snapshotPath);
+    }
+
+    std::string header(strlen(magic), '\0');
+    if (!in.read(header.data(), (std::streamsize)header.size()) || header != magic)
+    {
+        return Status(Status::GeneralError, snapshotPath + " is not a map snapshot (or is an old version)");
+    }
+
+    std::uint64_t storedSize = 0;
+    std::int64_t storedMTime = 0;
+    in.read((char*)&storedSize, sizeof(storedSize));
+    in.read((char*)&storedMTime, sizeof(storedMTime));
+    if (!in)
+    {
+        return Status(Status::GeneralError, snapshotPath + " is truncated");
+    }
+
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceMTime = 0;
+    if (!statSource(sourcePath, sourceSize, sourceMTime) ||
+        sourceSize != storedSize || sourceMTime != storedMTime)
+    {
+        return Status(Status::GeneralError, "Snapshot is stale; source " + sourcePath + " changed");
+    }
+
+    auto map = Map::create();
+
+    std::string name;
+    if (!readString(in, name))
+    {
+        return Status(Status::GeneralError, snapshotPath + " is truncated");
+    }
+    map->setName(name);
+
+    std::uint64_t count = 0;
+    in.read((char*)&count, sizeof(count));
+
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        std::string layerJSON, layerState;
+        if (!readString(in, layerJSON) || !readString(in, layerState))
+        {
+            return Status(Status::GeneralError, snapshotPath + " is truncated");
+        }
+
+        // same factory dispatch as Map::from_json:
+        auto j = parse_json(layerJSON);
+        if (j.status.failed())
+            return j.status;
+
+        std::string type;
+        get_to(j, "type", type);
+
+        auto layer = ContextImpl::createObject<Layer>(type, layerJSON, io);
+        if (!layer)
+        {
+            return Status(Status::GeneralError, "Snapshot contains unknown layer type \"" + type + "\"");
+        }
+
+        if (!layerState.empty())
+        {
+            layer->restoreSnapshotState(layerState);
+        }
+
+        map->layers().add(layer);
+    }
+
+    Log()->info(LC "restored {} ({} layers) from {}", name, count, snapshotPath);
+    return map;
+}
@@ -0,0 +1,55 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/Common.h>
+#include <rocky/IOTypes.h>
+#include <rocky/Status.h>
+#include <memory>
+#include <string>
+
+namespace ROCKY_NAMESPACE
+{
+    class Map;
+
+    /**
+     * Versioned snapshot of a fully-resolved Map: parsed layer
+     * configuration plus whatever each layer probed from its data source
+     * at open time (resolved profiles, tile matrices - see
+     * Layer::snapshotState). Write one after the map opens successfully;
+     * on the next startup, read() rebuilds the same map without
+     * re-parsing the source file or re-probing any endpoints, which takes
+     * the network round-trips out of a cold boot.
+     *
+     * A snapshot records the size and modification time of the source
+     * file it was built from, and read() refuses a snapshot whose source
+     * has changed since - the caller then falls back to the normal
+     * parse-and-probe path (and can write a fresh snapshot afterwards).
+     */
+    class ROCKY_EXPORT MapSnapshot
+    {
+    public:
+        //! Write a snapshot of an opened map.
+        //! @param map Map to snapshot; its layers should be open so their
+        //!   probed state is available
+        //! @param sourcePath Configuration file the map was built from;
+        //!   its size and mtime validate the snapshot later
+        //! @param snapshotPath Where to write the snapshot
+        static Status write(
+            std::shared_ptr<Map> map,
+            const std::string& sourcePath,
+            const std::string& snapshotPath);
+
+        //! Rebuild a map from a snapshot, skipping parse and probing.
+        //! Fails (and the caller should fall back to parsing sourcePath)
+        //! if the snapshot is missing, malformed, from a different format
+        //! version, or stale relative to the source file.
+        static Result<std::shared_ptr<Map>> read(
+            const std::string& sourcePath,
+            const std::string& snapshotPath,
+            const IOOptions& io);
+    };
+}
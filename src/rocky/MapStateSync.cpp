@@ -0,0 +1,307 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "MapStateSync.h"
+#include "Map.h"
+#include "Context.h"
+#include "Log.h"
+#include "json.h"
+
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[MapStateSync] "
+
+namespace
+{
+    constexpr std::uint8_t MAGIC = 0xB5;
+    constexpr std::uint8_t FORMAT_VERSION = 1;
+
+    constexpr std::uint8_t SECTION_LAYERS = 0x01;
+    constexpr std::uint8_t SECTION_REVISIONS = 0x02;
+    constexpr std::uint8_t SECTION_CAMERA = 0x04;
+
+    // LEB128-style varint; small values (indexes, revisions, counts)
+    // cost one byte.
+    void append_varint(std::vector<std::uint8_t>& buf, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buf.push_back((std::uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        buf.push_back((std::uint8_t)value);
+    }
+
+    // doubles travel as raw bytes; like rocky's binary tile caches, the
+    // format assumes same-endian peers.
+    void append_double(std::vector<std::uint8_t>& buf, double value)
+    {
+        std::uint8_t bytes[sizeof(double)];
+        std::memcpy(bytes, &value, sizeof(double));
+        buf.insert(buf.end(), bytes, bytes + sizeof(double));
+    }
+
+    void append_string(std::vector<std::uint8_t>& buf, const std::string& value)
+    {
+        append_varint(buf, value.size());
+        buf.insert(buf.end(), value.begin(), value.end());
+    }
+
+    // bounds-checked reader; any overrun latches "failed" and subsequent
+    // reads return zeros, so callers can validate once at the end.
+    struct Reader
+    {
+        const std::uint8_t* ptr;
+        const std::uint8_t* end;
+        bool failed = false;
+
+        std::uint8_t u8()
+        {
+            if (ptr >= end) { failed = true; return 0; }
+            return *ptr++;
+        }
+
+        std::uint64_t varint()
+        {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                std::uint8_t byte = u8();
+                value |= (std::uint64_t)(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                    return value;
+            }
+            failed = true;
+            return 0;
+        }
+
+        double f64()
+        {
+            if (end - ptr < (std::ptrdiff_t)sizeof(double)) { failed = true; return 0.0; }
+            double value;
+            std::memcpy(&value, ptr, sizeof(double));
+            ptr += sizeof(double);
+            return value;
+        }
+
+        std::string str()
+        {
+            auto size = varint();
+            if (failed || (std::uint64_t)(end - ptr) < size) { failed = true; return {}; }
+            std::string value((const char*)ptr, (std::size_t)size);
+            ptr += size;
+            return value;
+        }
+    };
+
+    bool same_camera(const Viewpoint& lhs, const Viewpoint& rhs)
+    {
+        return
+            lhs.position() == rhs.position() &&
+            lhs.heading->as(Units::DEGREES) == rhs.heading->as(Units::DEGREES) &&
+            lhs.pitch->as(Units::DEGREES) == rhs.pitch->as(Units::DEGREES) &&
+            lhs.range->as(Units::METERS) == rhs.range->as(Units::METERS);
+    }
+}
+
+std::vector<std::uint8_t>
+MapStateSync::encode(std::shared_ptr<Map> map, const Viewpoint& camera)
+{
+    std::vector<std::uint8_t> out;
+    ROCKY_SOFT_ASSERT_AND_RETURN(map, out);
+
+    auto layers = map->layers().all();
+
+    std::uint8_t flags = 0;
+
+    // the layer set travels whenever the map's data model changed
+    // (add/remove/move); it is a full replacement, so followers heal
+    // from any lost deltas.
+    bool layersChanged = (map->revision() != _mapRevision);
+    if (layersChanged)
+        flags |= SECTION_LAYERS;
+
+    // per-layer revision bumps (layer invalidations) travel by index:
+    std::vector<std::pair<unsigned, Revision>> revisions;
+    _layerRevisions.resize(layers.size(), -1);
+    for (unsigned i = 0; i < layers.size(); ++i)
+    {
+        if (layersChanged || layers[i]->revision() != _layerRevisions[i])
+        {
+            revisions.emplace_back(i, layers[i]->revision());
+        }
+    }
+    if (!revisions.empty())
+        flags |= SECTION_REVISIONS;
+
+    bool cameraChanged = camera.valid() && (!_cameraValid || !same_camera(camera, _camera));
+    if (cameraChanged)
+        flags |= SECTION_CAMERA;
+
+    if (flags == 0)
+        return out; // nothing changed.
+
+    out.push_back(MAGIC);
+    out.push_back(FORMAT_VERSION);
+    append_varint(out, ++_sequence);
+    out.push_back(flags);
+
+    if (flags & SECTION_LAYERS)
+    {
+        append_varint(out, layers.size());
+        for (auto& layer : layers)
+        {
+            append_string(out, layer->to_json());
+        }
+        _mapRevision = map->revision();
+    }
+
+    if (flags & SECTION_REVISIONS)
+    {
+        append_varint(out, revisions.size());
+        for (auto& [index, revision] : revisions)
+        {
+            append_varint(out, index);
+            append_varint(out, (std::uint64_t)revision);
+            _layerRevisions[index] = revision;
+        }
+    }
+
+    if (flags & SECTION_CAMERA)
+    {
+        auto position = camera.position();
+        append_string(out, position.srs.definition());
+        append_double(out, position.x);
+        append_double(out, position.y);
+        append_double(out, position.z);
+        append_double(out, camera.heading->as(Units::DEGREES));
+        append_double(out, camera.pitch->as(Units::DEGREES));
+        append_double(out, camera.range->as(Units::METERS));
+
+        // store the resolved position so a dynamic target on the leader
+        // still diffs correctly frame to frame:
+        _camera = camera;
+        _camera.point = position;
+        _camera.target = nullptr;
+        _cameraValid = true;
+    }
+
+    return out;
+}
+
+Status
+MapStateSync::apply(std::shared_ptr<Map> map, const std::uint8_t* data, std::size_t size, Viewpoint& camera, const IOOptions& io)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(map && data, Status(Status::AssertionFailure));
+
+    Reader in{ data, data + size };
+
+    if (in.u8() != MAGIC || in.u8() != FORMAT_VERSION)
+        return Status(Status::GeneralError, "unrecognized delta format");
+
+    auto sequence = in.varint();
+    auto flags = in.u8();
+    if (in.failed)
+        return Status(Status::GeneralError, "malformed delta");
+
+    // reject stale packets; gaps are fine since every section is absolute.
+    if (sequence <= _sequence)
+        return Status(Status::GeneralError, "stale delta");
+    _sequence = sequence;
+
+    bool rebuilt = false;
+
+    if (flags & SECTION_LAYERS)
+    {
+        // full replacement of the layer set:
+        for (auto& layer : map->layers().all())
+        {
+            map->layers().remove(layer);
+        }
+
+        auto count = in.varint();
+        for (std::uint64_t i = 0; i < count && !in.failed; ++i)
+        {
+            auto conf = in.str();
+            if (in.failed)
+                break;
+
+            auto j = parse_json(conf);
+            if (j.status.failed())
+                continue;
+
+            std::string type;
+            get_to(j, "type", type);
+            auto layer = ContextImpl::createObject<Layer>(type, conf, io);
+            if (layer)
+                map->layers().add(layer);
+            else
+                Log()->warn(LC "no factory for layer type \"{}\"; layer skipped", type);
+        }
+
+        // fresh layers load fresh data; don't re-dirty them below.
+        _layerRevisions.assign(map->layers().size(), -1);
+        rebuilt = true;
+    }
+
+    if (flags & SECTION_REVISIONS)
+    {
+        auto layers = map->layers().all();
+        _layerRevisions.resize(layers.size(), -1);
+
+        auto count = in.varint();
+        for (std::uint64_t i = 0; i < count && !in.failed; ++i)
+        {
+            auto index = (unsigned)in.varint();
+            auto revision = (Revision)in.varint();
+            if (in.failed || index >= layers.size())
+                continue;
+
+            if (!rebuilt && _layerRevisions[index] >= 0 && _layerRevisions[index] != revision)
+            {
+                // the leader invalidated this layer; do the same so our
+                // resident tiles reload in step.
+                layers[index]->dirty();
+            }
+            _layerRevisions[index] = revision;
+        }
+    }
+
+    if (flags & SECTION_CAMERA)
+    {
+        auto srs_def = in.str();
+        double x = in.f64(), y = in.f64(), z = in.f64();
+        double heading = in.f64(), pitch = in.f64(), range = in.f64();
+
+        if (!in.failed)
+        {
+            // reuse the previous SRS when the definition is unchanged;
+            // constructing one is far from free and the definition almost
+            // never changes mid-session.
+            SRS srs = (camera.point.srs.definition() == srs_def) ? camera.point.srs : SRS(srs_def);
+
+            camera.target = nullptr;
+            camera.point = GeoPoint(srs, x, y, z);
+            camera.heading = Angle(heading, Units::DEGREES);
+            camera.pitch = Angle(pitch, Units::DEGREES);
+            camera.range = Distance(range, Units::METERS);
+        }
+    }
+
+    if (in.failed)
+        return Status(Status::GeneralError, "malformed delta");
+
+    return Status_OK;
+}
+
+void
+MapStateSync::reset()
+{
+    _mapRevision = -1;
+    _layerRevisions.clear();
+    _cameraValid = false;
+}
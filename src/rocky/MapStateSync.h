@@ -0,0 +1,77 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/Common.h>
+#include <rocky/IOTypes.h>
+#include <rocky/Status.h>
+#include <rocky/Viewpoint.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    class Map;
+
+    /**
+     * Differential codec for mirroring one station's map and camera state
+     * on follower stations (e.g., instructor/student setups). The leader
+     * calls encode() each frame and ships the resulting bytes over the
+     * application's own session channel; each follower feeds them to
+     * apply(). Only what changed since the previous frame goes on the
+     * wire: the full layer configuration travels when the layer set
+     * changes, per-layer revision bumps travel so follower tiles
+     * invalidate in step with the leader, and the camera travels when it
+     * moves - a steady camera costs nothing and a moving one tens of
+     * bytes per frame.
+     *
+     * The codec is transport-agnostic and connectionless: deltas carry a
+     * sequence number so stale packets are rejected, and every section is
+     * absolute (full layer set, absolute revisions, absolute camera), so
+     * a lost delta is healed by any later one. Call reset() on the leader
+     * when a follower joins mid-session to force the next delta to carry
+     * the full state.
+     */
+    class ROCKY_EXPORT MapStateSync
+    {
+    public:
+        //! Construct a codec. Use one instance per role (a leader's
+        //! encoder, or a follower's decoder) for the life of the session.
+        MapStateSync() = default;
+
+        //! Leader side: encode everything that changed since the last
+        //! call. Returns an empty vector when nothing changed.
+        //! @param map Map whose layer set and revisions to mirror
+        //! @param camera Camera state to mirror (may be invalid to skip)
+        std::vector<std::uint8_t> encode(std::shared_ptr<Map> map, const Viewpoint& camera);
+
+        //! Follower side: apply a delta from the leader. Layer-set and
+        //! revision changes are applied to the map directly; when the
+        //! delta carries a camera it is written to "camera", otherwise
+        //! "camera" is left alone. Stale (out-of-order) deltas fail and
+        //! leave everything untouched.
+        //! @param map Map to update
+        //! @param data Delta bytes from the leader's encode()
+        //! @param size Number of bytes
+        //! @param camera Receives the leader's camera when present
+        //! @param io IO options used to construct incoming layers
+        Status apply(std::shared_ptr<Map> map, const std::uint8_t* data, std::size_t size,
+            Viewpoint& camera, const IOOptions& io);
+
+        //! Leader side: forget the acknowledged state so the next
+        //! encode() emits a full state frame. Call when a follower joins
+        //! mid-session.
+        void reset();
+
+    private:
+        std::uint64_t _sequence = 0;
+        Revision _mapRevision = -1;
+        std::vector<Revision> _layerRevisions;
+        Viewpoint _camera;
+        bool _cameraValid = false;
+    };
+}
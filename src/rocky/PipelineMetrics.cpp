@@ -0,0 +1,71 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "PipelineMetrics.h"
+#include <atomic>
+#include <cmath>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    struct StageData
+    {
+        std::atomic<std::uint64_t> buckets[util::PipelineMetrics::NUM_BUCKETS] = {};
+        std::atomic<std::uint64_t> count = { 0 };
+    };
+
+    StageData _stages[util::PipelineMetrics::NUM_STAGES];
+}
+
+const char*
+util::PipelineMetrics::name(Stage stage)
+{
+    static const char* names[NUM_STAGES] = {
+        "queue wait", "fetch", "decode", "composite", "compile", "merge" };
+    return names[stage];
+}
+
+void
+util::PipelineMetrics::insert(Stage stage, double ms)
+{
+    unsigned bucket = 0;
+    if (ms > 0.1)
+    {
+        bucket = (unsigned)std::log2(ms / 0.1) + 1;
+        if (bucket >= NUM_BUCKETS)
+            bucket = NUM_BUCKETS - 1;
+    }
+
+    auto& data = _stages[stage];
+    data.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    data.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::array<std::uint64_t, util::PipelineMetrics::NUM_BUCKETS>
+util::PipelineMetrics::histogram(Stage stage)
+{
+    std::array<std::uint64_t, NUM_BUCKETS> result;
+    for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+        result[i] = _stages[stage].buckets[i].load(std::memory_order_relaxed);
+    return result;
+}
+
+std::uint64_t
+util::PipelineMetrics::count(Stage stage)
+{
+    return _stages[stage].count.load(std::memory_order_relaxed);
+}
+
+void
+util::PipelineMetrics::reset()
+{
+    for (auto& stage : _stages)
+    {
+        for (auto& bucket : stage.buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        stage.count.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/Common.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace ROCKY_NAMESPACE
+{
+    namespace util
+    {
+        /**
+        * Always-on latency histograms for the stages a tile passes through
+        * on its way to the screen. Each stage keeps a log-scale histogram
+        * (bucket N covers 0.1ms * 2^N) fed by the pager and I/O layers;
+        * recording a sample is two relaxed atomic increments, so the
+        * collection stays on in production and a diagnostics panel can
+        * show at a glance whether a slow site is network-bound (fetch) or
+        * CPU-bound (decode/composite/compile).
+        */
+        class ROCKY_EXPORT PipelineMetrics
+        {
+        public:
+            enum Stage
+            {
+                QUEUE_WAIT = 0, // load request to job execution
+                FETCH,          // URI read (network, disk, or cache)
+                DECODE,         // image stream decode
+                COMPOSITE,      // color layer compositing
+                COMPILE,        // render model build + GPU compile
+                MERGE,          // state command swap on the update thread
+                NUM_STAGES
+            };
+
+            // bucket N covers [0.1ms * 2^N, 0.1ms * 2^(N+1)); 24 buckets
+            // reach ~14 minutes, so nothing falls off the top in practice
+            static constexpr unsigned NUM_BUCKETS = 24;
+
+            //! Display name of a stage
+            static const char* name(Stage stage);
+
+            //! Records one sample
+            static void insert(Stage stage, double ms);
+
+            //! Copy of one stage's histogram
+            static std::array<std::uint64_t, NUM_BUCKETS> histogram(Stage stage);
+
+            //! Total samples recorded for one stage
+            static std::uint64_t count(Stage stage);
+
+            //! Zeroes all histograms
+            static void reset();
+
+            //! RAII sample: records the enclosing scope's duration
+            struct Scoped
+            {
+                Scoped(Stage stage) : _stage(stage),
+                    _begin(std::chrono::steady_clock::now()) { }
+
+                ~Scoped()
+                {
+                    insert(_stage, 1e-6 * (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - _begin).count());
+                }
+
+                Scoped(const Scoped&) = delete;
+                Scoped& operator=(const Scoped&) = delete;
+
+            private:
+                Stage _stage;
+                std::chrono::steady_clock::time_point _begin;
+            };
+
+            // Not creatable.
+            PipelineMetrics() = delete;
+        };
+    }
+}
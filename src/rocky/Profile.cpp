@@ -20,6 +20,10 @@ const double MERC_MINY = -20037508.34278925;
 const double MERC_MAXX = 20037508.34278925;
 const double MERC_MAXY = 20037508.34278925;
 
+// number of LODs with precomputed tile dimensions; tile indices are
+// 32-bit unsigned so nothing deeper is addressable anyway.
+const unsigned MAX_LOD_TABLE_SIZE = 33;
+
 void
 Profile::setup(
     const SRS& srs,
@@ -75,6 +79,18 @@ Profile::setup(
             _shared->_extent :
             _shared->_extent.transform(srs.geodeticSRS());
 
+        // precompute the tile dimensions for each usable LOD, so that
+        // per-tile extent math is a lookup plus two multiplies. LODs
+        // past the table (if any) fall back to computing on the fly.
+        double w0 = _shared->_extent.width() / (double)tx;
+        double h0 = _shared->_extent.height() / (double)ty;
+        _shared->_tileDims.reserve(MAX_LOD_TABLE_SIZE);
+        for (unsigned lod = 0; lod < MAX_LOD_TABLE_SIZE; ++lod)
+        {
+            double factor = double(1ull << lod);
+            _shared->_tileDims.emplace_back(w0 / factor, h0 / factor);
+        }
+
         // make a profile sig (sans srs) and an srs sig for quick comparisons.
         std::string temp = to_json();
         _shared->_fullSignature = util::make_string() << std::hex << util::hashString(temp);
@@ -289,10 +305,15 @@ Profile::tileExtent(unsigned lod, unsigned tileX, unsigned tileY) const
 std::pair<double,double>
 Profile::tileDimensions(unsigned int lod) const
 {
+    if (lod < _shared->_tileDims.size())
+    {
+        return _shared->_tileDims[lod];
+    }
+
     double out_width  = _shared->_extent.width() / (double)_shared->_numTilesWideAtLod0;
     double out_height = _shared->_extent.height() / (double)_shared->_numTilesHighAtLod0;
 
-    double factor = double(1u << lod);
+    double factor = double(1ull << lod);
     out_width /= (double)factor;
     out_height /= (double)factor;
 
@@ -187,6 +187,9 @@ namespace ROCKY_NAMESPACE
             std::string _fullSignature;
             std::string _horizSignature;
             std::size_t _hash;
+            // per-LOD tile dimensions, precomputed in setup() so that
+            // tileExtent and tileDimensions are a table lookup:
+            std::vector<std::pair<double, double>> _tileDims;
         };
         std::shared_ptr<Data> _shared;
     };
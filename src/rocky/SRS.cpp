@@ -11,6 +11,11 @@
 #include <filesystem>
 #include <proj.h>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #define LC "[SRS] "
 
@@ -68,6 +73,10 @@ namespace
     //! SRS data factory and PROJ main interface
     struct SRSFactory : public std::unordered_map<std::string, SRSEntry>
     {
+        //! cache of operation fast-path classifications, keyed the same
+        //! way as the operation cache ("fromDef->toDef")
+        std::unordered_map<std::string, int> fast_path_cache;
+
         //! destroy cache entries and threading context upon descope
         ~SRSFactory()
         {
@@ -518,6 +527,71 @@ namespace
 
     // create an SRS repo per thread since proj is not thread safe.
     thread_local SRSFactory g_srs_factory;
+
+    //! Full PROJ-based horizontal equivalence comparison. Used only to
+    //! classify definitions into equivalence classes for horizontalToken();
+    //! everyday comparisons use the interned tokens instead.
+    bool horizontally_equivalent(const SRS& lhs, const SRS& rhs)
+    {
+        if (lhs.definition().empty() || rhs.definition().empty())
+            return false;
+
+        if (lhs.isGeodetic() && rhs.isGeodetic() && lhs.ellipsoid() == rhs.ellipsoid())
+            return true;
+
+        auto& lhs_entry = g_srs_factory.get_or_create(lhs.definition());
+        PJ* pj1 = lhs_entry.pj;
+        if (!pj1)
+            return false;
+
+        auto& rhs_entry = g_srs_factory.get_or_create(rhs.definition());
+        PJ* pj2 = rhs_entry.pj;
+        if (!pj2)
+            return false;
+
+        if (lhs_entry.crs_type != rhs_entry.crs_type)
+            return false;
+
+        // compare only the horizontal CRS components:
+        PJ* lhs_pj = lhs_entry.crs_type == PJ_TYPE_COMPOUND_CRS ?
+            proj_crs_get_sub_crs(g_srs_factory.threading_context(), pj1, 0) : pj1;
+
+        PJ* rhs_pj = rhs_entry.crs_type == PJ_TYPE_COMPOUND_CRS ?
+            proj_crs_get_sub_crs(g_srs_factory.threading_context(), pj2, 0) : pj2;
+
+        PJ_COMPARISON_CRITERION criterion =
+            lhs.isGeodetic() ? PJ_COMP_EQUIVALENT_EXCEPT_AXIS_ORDER_GEOGCRS :
+            PJ_COMP_EQUIVALENT;
+
+        return proj_is_equivalent_to_with_ctx(
+            g_srs_factory.threading_context(), lhs_pj, rhs_pj, criterion);
+    }
+
+    // Global (cross-thread) registry of horizontal equivalence classes.
+    // Each distinct definition is classified exactly once against one
+    // representative of each known class; SRS objects cache their token
+    // so repeated comparisons never come back here.
+    std::mutex g_equivalence_mutex;
+    std::unordered_map<std::string, int> g_equivalence_tokens;
+    std::vector<SRS> g_equivalence_representatives;
+
+    // Global registry interning each distinct definition string to a
+    // small integer id. SRS objects cache their id, so per-pair caches
+    // can key on two ints instead of hashing concatenated strings.
+    // Written once per unique definition; read through the cached id.
+    std::mutex g_definition_id_mutex;
+    std::unordered_map<std::string, int> g_definition_ids;
+
+    int intern_definition(const std::string& def)
+    {
+        std::lock_guard<std::mutex> lock(g_definition_id_mutex);
+        auto iter = g_definition_ids.find(def);
+        if (iter != g_definition_ids.end())
+            return iter->second;
+        int id = (int)g_definition_ids.size();
+        g_definition_ids[def] = id;
+        return id;
+    }
 }
 
 
@@ -638,38 +712,56 @@ SRS::horizontallyEquivalentTo(const SRS& rhs) const
     if (definition().empty() || rhs.definition().empty())
         return false;
 
-    if (isGeodetic() && rhs.isGeodetic() && ellipsoid() == rhs.ellipsoid())
-        return true;
+    if (definition() == rhs.definition())
+        return valid();
 
-    auto& lhs_entry = g_srs_factory.get_or_create(definition());
-    PJ* pj1 = lhs_entry.pj;
-    if (!pj1)
-        return false;
+    int lhs_token = horizontalToken();
+    return lhs_token >= 0 && lhs_token == rhs.horizontalToken();
+}
 
-    auto& rhs_entry = g_srs_factory.get_or_create(rhs.definition());
-    PJ* pj2 = rhs_entry.pj;
-    if (!pj2)
-        return false;
+int
+SRS::horizontalToken() const
+{
+    if (_equivalenceToken.has_value())
+        return _equivalenceToken.value();
 
-    if (lhs_entry.crs_type != rhs_entry.crs_type)
-        return false;
+    if (!valid())
+    {
+        _equivalenceToken = -1;
+        return -1;
+    }
 
-    // compare only the horizontal CRS components:
-    PJ* lhs_pj = nullptr;
-    PJ* rhs_pj = nullptr;
+    std::lock_guard<std::mutex> lock(g_equivalence_mutex);
 
-    lhs_pj = lhs_entry.crs_type == PJ_TYPE_COMPOUND_CRS ?
-        proj_crs_get_sub_crs(g_srs_factory.threading_context(), pj1, 0) : pj1;
+    auto iter = g_equivalence_tokens.find(definition());
+    if (iter != g_equivalence_tokens.end())
+    {
+        _equivalenceToken = iter->second;
+        return iter->second;
+    }
 
-    rhs_pj = rhs_entry.crs_type == PJ_TYPE_COMPOUND_CRS ?
-        proj_crs_get_sub_crs(g_srs_factory.threading_context(), pj2, 0) : pj2;
+    // new definition; classify it against a representative of each
+    // equivalence class seen so far:
+    int token = -1;
+    for (int i = 0; i < (int)g_equivalence_representatives.size(); ++i)
+    {
+        if (horizontally_equivalent(*this, g_equivalence_representatives[i]))
+        {
+            token = i;
+            break;
+        }
+    }
 
-    PJ_COMPARISON_CRITERION criterion =
-        isGeodetic() ? PJ_COMP_EQUIVALENT_EXCEPT_AXIS_ORDER_GEOGCRS :
-        PJ_COMP_EQUIVALENT;
+    if (token < 0)
+    {
+        // first of a new class; it becomes the representative.
+        token = (int)g_equivalence_representatives.size();
+        g_equivalence_representatives.push_back(*this);
+    }
 
-    return proj_is_equivalent_to_with_ctx(
-        g_srs_factory.threading_context(), lhs_pj, rhs_pj, criterion);
+    g_equivalence_tokens[definition()] = token;
+    _equivalenceToken = token;
+    return token;
 }
 
 const std::string&
@@ -708,6 +800,31 @@ SRS::to(const SRS& rhs) const
     return SRSOperation(*this, rhs);
 }
 
+const SRSOperation&
+SRS::cachedTo(const SRS& rhs) const
+{
+    // fully-constructed operations keyed by the interned definition
+    // pair. The cache is per-thread because the underlying PJ handles
+    // are per-thread; entries live for the lifetime of the thread.
+    thread_local std::unordered_map<std::uint64_t, SRSOperation> cache;
+
+    if (!_internedID.has_value())
+        _internedID = intern_definition(_definition);
+    if (!rhs._internedID.has_value())
+        rhs._internedID = intern_definition(rhs._definition);
+
+    std::uint64_t key =
+        ((std::uint64_t)(std::uint32_t)_internedID.value() << 32) |
+        (std::uint64_t)(std::uint32_t)rhs._internedID.value();
+
+    auto iter = cache.find(key);
+    if (iter == cache.end())
+    {
+        iter = cache.emplace(key, SRSOperation(*this, rhs)).first;
+    }
+    return iter->second;
+}
+
 const SRS&
 SRS::geodeticSRS() const
 {
@@ -854,12 +971,137 @@ SRSOperation::SRSOperation(const SRS& from, const SRS& to) :
     if (_from.valid() && _to.valid())
     {
         _handle = (void*)g_srs_factory.get_or_create_operation(_from.definition(), _to.definition());
+
+        if (_handle != nullptr && !_nop)
+        {
+            classifyFastPath();
+        }
+    }
+}
+
+void
+SRSOperation::classifyFastPath()
+{
+    // classification requires a few PROJ queries, so cache the result
+    // per definition-pair alongside this thread's operation cache:
+    std::string key = _from.definition() + "->" + _to.definition();
+    auto iter = g_srs_factory.fast_path_cache.find(key);
+    if (iter != g_srs_factory.fast_path_cache.end())
+    {
+        _fastPath = (FastPath)iter->second;
+        return;
+    }
+
+    _fastPath = FastPath::None;
+
+    // anything with a vertical datum shift goes through PROJ.
+    if (!_from.hasVerticalDatumShift() && !_to.hasVerticalDatumShift())
+    {
+        if (_from.isGeodetic() && _to.isGeocentric() && _from.geocentricSRS() == _to)
+        {
+            _fastPath = FastPath::GeodeticToGeocentric;
+        }
+        else if (_from.isGeocentric() && _to.isGeodetic() && _to.geocentricSRS() == _from)
+        {
+            _fastPath = FastPath::GeocentricToGeodetic;
+        }
+        else if (_from.horizontallyEquivalentTo(SRS::WGS84) &&
+            _to.horizontallyEquivalentTo(SRS::SPHERICAL_MERCATOR))
+        {
+            _fastPath = FastPath::GeodeticToSphericalMercator;
+        }
+        else if (_from.horizontallyEquivalentTo(SRS::SPHERICAL_MERCATOR) &&
+            _to.horizontallyEquivalentTo(SRS::WGS84))
+        {
+            _fastPath = FastPath::SphericalMercatorToGeodetic;
+        }
+    }
+
+    g_srs_factory.fast_path_cache[key] = (int)_fastPath;
+}
+
+bool
+SRSOperation::forwardFast(double& x, double& y, double& z) const
+{
+    // closed-form equivalents of the most common PROJ pipelines;
+    // see classifyFastPath() for how these are selected.
+    constexpr double R = 6378137.0; // web mercator sphere radius
+
+    switch (_fastPath)
+    {
+    case FastPath::GeodeticToSphericalMercator:
+        x = R * util::deg2rad(x);
+        y = R * std::log(std::tan(M_PI * 0.25 + 0.5 * util::deg2rad(y)));
+        return true;
+
+    case FastPath::SphericalMercatorToGeodetic:
+        x = util::rad2deg(x / R);
+        y = util::rad2deg(2.0 * std::atan(std::exp(y / R)) - M_PI * 0.5);
+        return true;
+
+    case FastPath::GeodeticToGeocentric:
+    {
+        glm::dvec3 p = _from.ellipsoid().geodeticToGeocentric(glm::dvec3(x, y, z));
+        x = p.x, y = p.y, z = p.z;
+        return true;
+    }
+
+    case FastPath::GeocentricToGeodetic:
+    {
+        glm::dvec3 p = _to.ellipsoid().geocentricToGeodetic(glm::dvec3(x, y, z));
+        x = p.x, y = p.y, z = p.z;
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+bool
+SRSOperation::inverseFast(double& x, double& y, double& z) const
+{
+    constexpr double R = 6378137.0; // web mercator sphere radius
+
+    switch (_fastPath)
+    {
+    case FastPath::GeodeticToSphericalMercator:
+        x = util::rad2deg(x / R);
+        y = util::rad2deg(2.0 * std::atan(std::exp(y / R)) - M_PI * 0.5);
+        return true;
+
+    case FastPath::SphericalMercatorToGeodetic:
+        x = R * util::deg2rad(x);
+        y = R * std::log(std::tan(M_PI * 0.25 + 0.5 * util::deg2rad(y)));
+        return true;
+
+    case FastPath::GeodeticToGeocentric:
+    {
+        glm::dvec3 p = _from.ellipsoid().geocentricToGeodetic(glm::dvec3(x, y, z));
+        x = p.x, y = p.y, z = p.z;
+        return true;
+    }
+
+    case FastPath::GeocentricToGeodetic:
+    {
+        glm::dvec3 p = _to.ellipsoid().geodeticToGeocentric(glm::dvec3(x, y, z));
+        x = p.x, y = p.y, z = p.z;
+        return true;
+    }
+
+    default:
+        return false;
     }
 }
 
 bool
 SRSOperation::forward(void* handle, double& x, double& y, double& z) const
 {
+    if (_fastPath != FastPath::None)
+    {
+        return forwardFast(x, y, z);
+    }
+
     if (handle)
     {
         proj_errno_reset((PJ*)handle);
@@ -880,6 +1122,33 @@ SRSOperation::forward(void* handle, double& x, double& y, double& z) const
 bool
 SRSOperation::forward(void* handle, double* x, double* y, double* z, std::size_t stride, std::size_t count) const
 {
+    if (_fastPath != FastPath::None)
+    {
+        // packed dvec3 arrays convert through the ellipsoid's batch methods:
+        if (stride == sizeof(glm::dvec3) && y == x + 1 && z == y + 1)
+        {
+            if (_fastPath == FastPath::GeodeticToGeocentric)
+            {
+                _from.ellipsoid().geodeticToGeocentricArray((glm::dvec3*)x, count);
+                return true;
+            }
+            else if (_fastPath == FastPath::GeocentricToGeodetic)
+            {
+                _to.ellipsoid().geocentricToGeodeticArray((glm::dvec3*)x, count);
+                return true;
+            }
+        }
+
+        char* px = (char*)x;
+        char* py = (char*)y;
+        char* pz = (char*)z;
+        for (std::size_t i = 0; i < count; ++i, px += stride, py += stride, pz += stride)
+        {
+            forwardFast(*(double*)px, *(double*)py, *(double*)pz);
+        }
+        return true;
+    }
+
     if (handle)
     {
         proj_errno_reset((PJ*)handle);
@@ -906,6 +1175,11 @@ SRSOperation::forward(void* handle, double* x, double* y, double* z, std::size_t
 bool
 SRSOperation::inverse(void* handle, double& x, double& y, double& z) const
 {
+    if (_fastPath != FastPath::None)
+    {
+        return inverseFast(x, y, z);
+    }
+
     if (handle)
     {
         proj_errno_reset((PJ*)handle);
@@ -926,6 +1200,33 @@ SRSOperation::inverse(void* handle, double& x, double& y, double& z) const
 bool
 SRSOperation::inverse(void* handle, double* x, double* y, double* z, std::size_t stride, std::size_t count) const
 {
+    if (_fastPath != FastPath::None)
+    {
+        // packed dvec3 arrays convert through the ellipsoid's batch methods:
+        if (stride == sizeof(glm::dvec3) && y == x + 1 && z == y + 1)
+        {
+            if (_fastPath == FastPath::GeodeticToGeocentric)
+            {
+                _from.ellipsoid().geocentricToGeodeticArray((glm::dvec3*)x, count);
+                return true;
+            }
+            else if (_fastPath == FastPath::GeocentricToGeodetic)
+            {
+                _to.ellipsoid().geodeticToGeocentricArray((glm::dvec3*)x, count);
+                return true;
+            }
+        }
+
+        char* px = (char*)x;
+        char* py = (char*)y;
+        char* pz = (char*)z;
+        for (std::size_t i = 0; i < count; ++i, px += stride, py += stride, pz += stride)
+        {
+            inverseFast(*(double*)px, *(double*)py, *(double*)pz);
+        }
+        return true;
+    }
+
     if (handle)
     {
         proj_errno_reset((PJ*)handle);
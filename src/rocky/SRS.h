@@ -8,6 +8,8 @@
 #include <rocky/Common.h>
 #include <rocky/Units.h>
 #include <rocky/Ellipsoid.h>
+#include <iterator>
+#include <type_traits>
 
 namespace ROCKY_NAMESPACE
 {
@@ -58,6 +60,15 @@ namespace ROCKY_NAMESPACE
         //! @return Operation that will transform coordinates from this SRS to the target SRS
         SRSOperation to(const SRS& target) const;
 
+        //! Same as to(), but returns a reference to an operation cached
+        //! per-thread and keyed by the interned (from, to) pair, so
+        //! repeated ad-hoc transforms between the same SRS pair skip
+        //! operation construction entirely. The reference remains valid
+        //! for the lifetime of the calling thread.
+        //! @param target Target SRS for coordinate operation
+        //! @return Cached operation from this SRS to the target SRS
+        const SRSOperation& cachedTo(const SRS& target) const;
+
         //! Name of this SRS
         //! @return Name of the SRS, or an empty string if the SRS is invalid
         const char* name() const;
@@ -129,6 +140,14 @@ namespace ROCKY_NAMESPACE
         //! @return True if the SRS are equivalent, false if not
         bool horizontallyEquivalentTo(const SRS& rhs) const;
 
+        //! Interned token identifying this SRS's horizontal equivalence
+        //! class. Two valid SRS are horizontally equivalent if and only if
+        //! their tokens match, so callers that compare the same SRS pairs
+        //! repeatedly (extent intersection, tile culling) pay an integer
+        //! compare instead of a PROJ query. Computed once and cached;
+        //! returns -1 for an invalid SRS.
+        int horizontalToken() const;
+
         //! Whether this SRS is mathematically equivalent to another SRS
         //! @param rhs SRS to compare against
         //! @return True if the SRS are equivalent, false if not
@@ -216,6 +235,8 @@ namespace ROCKY_NAMESPACE
         std::string _definition;
         mutable std::optional<bool> _valid;
         mutable std::optional<int> _crs_type;
+        mutable std::optional<int> _equivalenceToken;
+        mutable std::optional<int> _internedID;
         friend class SRSOperation;
 
         bool _establish_valid() const;
@@ -301,11 +322,26 @@ namespace ROCKY_NAMESPACE
             return _nop ? true : forward(_handle, out[0], out[1], out[2]);
         }
 
-        //! Transform a range of 3-vectors in place
+        //! Transform a range of 3-vectors in place. A contiguous range
+        //! (e.g. a vector or array) transforms in a single batched call,
+        //! which is much faster than transforming point by point.
         //! @return True if all transformations succeeded
         template<typename ITERATOR>
         inline bool transformRange(ITERATOR begin, ITERATOR end) const {
             if (_nop) return true;
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                typename std::iterator_traits<ITERATOR>::iterator_category>)
+            {
+                auto count = end - begin;
+                if (count == 0)
+                    return true;
+                if ((const char*)&*(end - 1) - (const char*)&*begin ==
+                    (std::ptrdiff_t)((count - 1) * sizeof(*begin)))
+                {
+                    return forward(_handle, &begin->x, &begin->y, &begin->z,
+                        sizeof(*begin), (std::size_t)count);
+                }
+            }
             unsigned errors = 0;
             for (auto iter = begin; iter != end; ++iter)
                 if (!forward(_handle, iter->x, iter->y, iter->z))
@@ -342,11 +378,26 @@ namespace ROCKY_NAMESPACE
             return _nop ? true : inverse(_handle, out[0], out[1], out[2]);
         }
 
-        //! Inverse-transform a range of 3-vectors in place
+        //! Inverse-transform a range of 3-vectors in place. A contiguous
+        //! range (e.g. a vector or array) transforms in a single batched
+        //! call, which is much faster than transforming point by point.
         //! @return True if all transformations succeeded
         template<typename ITERATOR>
         inline bool inverseRange(ITERATOR begin, ITERATOR end) const {
             if (_nop) return true;
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                typename std::iterator_traits<ITERATOR>::iterator_category>)
+            {
+                auto count = end - begin;
+                if (count == 0)
+                    return true;
+                if ((const char*)&*(end - 1) - (const char*)&*begin ==
+                    (std::ptrdiff_t)((count - 1) * sizeof(*begin)))
+                {
+                    return inverse(_handle, &begin->x, &begin->y, &begin->z,
+                        sizeof(*begin), (std::size_t)count);
+                }
+            }
             unsigned errors = 0;
             for (auto iter = begin; iter != end; ++iter)
                 if (!inverse(_handle, iter->x, iter->y, iter->z))
@@ -396,11 +447,28 @@ namespace ROCKY_NAMESPACE
         SRSOperation& operator=(SRSOperation&&) noexcept = default;
 
     private:
+        //! Closed-form shortcuts for the most common operations, detected
+        //! once at construction. Anything more exotic (datum shifts,
+        //! vertical transforms, arbitrary projections) goes through PROJ.
+        enum class FastPath : std::uint8_t
+        {
+            None,
+            GeodeticToSphericalMercator,
+            SphericalMercatorToGeodetic,
+            GeodeticToGeocentric,
+            GeocentricToGeodetic
+        };
+
         void* _handle = nullptr;
         bool _nop = true;
+        FastPath _fastPath = FastPath::None;
         SRS _from, _to;
         mutable std::string _lastError;
 
+        void classifyFastPath();
+        bool forwardFast(double& x, double& y, double& z) const;
+        bool inverseFast(double& x, double& y, double& z) const;
+
         bool forward(void* handle, double& x, double& y, double& z) const;
         bool inverse(void* handle, double& x, double& y, double& z) const;
 
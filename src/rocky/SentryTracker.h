@@ -5,6 +5,9 @@
  */
 #pragma once
 #include <rocky/Common.h>
+#include <algorithm>
+#include <list>
+#include <vector>
 
 namespace ROCKY_NAMESPACE
 {
@@ -26,6 +29,7 @@ namespace ROCKY_NAMESPACE
                 ListEntry(T data, void* token) : _data(data), _token(token) { }
                 T _data;
                 void* _token;
+                float _weight = 0.0f;
             };
 
             using List = std::list<ListEntry>;
@@ -63,7 +67,10 @@ namespace ROCKY_NAMESPACE
             List _list;
             ListIterator _sentryptr;
 
-            inline void* use(const T& data, void* token)
+            //! The optional weight is an eviction preference used by
+            //! flushWeighted(); higher-weighted entries expire first when
+            //! the disposal count is capped.
+            inline void* use(const T& data, void* token, float weight = 0.0f)
             {
                 // Find the tracker for this tile and update its timestamp
                 if (token)
@@ -75,6 +82,7 @@ namespace ROCKY_NAMESPACE
                     // in front of the sentry, leaving all non-visited tiles behind it.
                     _list.splice(_list.begin(), _list, *ptr);
                     *ptr = _list.begin();
+                    _list.front()._weight = weight;
                     return ptr;
                 }
                 else
@@ -82,6 +90,7 @@ namespace ROCKY_NAMESPACE
                     // New entry:
                     Token* ptr = new Token();
                     _list.emplace_front(data, ptr); // ListEntry
+                    _list.front()._weight = weight;
                     *ptr = _list.begin();
                     return ptr;
                 }
@@ -123,6 +132,68 @@ namespace ROCKY_NAMESPACE
                 _list.splice(_list.begin(), _list, _sentryptr);
                 _sentryptr = _list.begin();
             }
+
+            //! Like flush(), but when the candidates outnumber maxCount,
+            //! disposes the highest-weighted entries first (see use()).
+            //! Weight entries by how cheaply they can be rebuilt so a
+            //! capped flush preferentially keeps the expensive ones.
+            template<typename CALLABLE>
+            inline void flushWeighted(unsigned maxCount, CALLABLE&& dispose)
+            {
+                std::vector<ListIterator> candidates;
+                ListIterator i = _sentryptr;
+                for (++i; i != _list.end(); ++i)
+                {
+                    candidates.push_back(i);
+                }
+
+                if (candidates.size() > maxCount)
+                {
+                    std::partial_sort(
+                        candidates.begin(), candidates.begin() + maxCount, candidates.end(),
+                        [](const ListIterator& lhs, const ListIterator& rhs)
+                        {
+                            return lhs->_weight > rhs->_weight;
+                        });
+                    candidates.resize(maxCount);
+                }
+
+                for (auto& candidate : candidates)
+                {
+                    ListEntry& le = *candidate;
+
+                    // user disposal function
+                    if (dispose(le._data))
+                    {
+                        // delete the token
+                        delete static_cast<Token*>(le._token);
+
+                        // remove it from the tracker list:
+                        _list.erase(candidate);
+                    }
+                }
+
+                // reset the sentry.
+                _list.splice(_list.begin(), _list, _sentryptr);
+                _sentryptr = _list.begin();
+            }
+
+            //! Like flushWeighted(), but rescoring every candidate with
+            //! the supplied function first. Stored weights go stale the
+            //! moment an entry stops calling use(), so a scorer that
+            //! depends on current conditions (like predicted re-use)
+            //! needs to weigh at flush time.
+            template<typename WEIGH, typename CALLABLE>
+            inline void flushWeighted(unsigned maxCount, WEIGH&& weigh, CALLABLE&& dispose)
+            {
+                ListIterator i = _sentryptr;
+                for (++i; i != _list.end(); ++i)
+                {
+                    i->_weight = weigh(i->_data);
+                }
+
+                flushWeighted(maxCount, dispose);
+            }
         };
     }
 }
@@ -4,15 +4,25 @@
  * MIT License
  */
 #include "TMS.h"
+#include "Utils.h"
 
 #include "tinyxml/tinyxml.h"
 
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::TMS;
 
+#undef LC
+#define LC "[TMS] "
+
 
 #define ELEM_TILEMAP "tilemap"
 #define ELEM_TITLE "title"
@@ -615,6 +625,238 @@ ROCKY_NAMESPACE::TMS::readTileMap(const URI& location, const IOOptions& io)
 
 
 
+namespace
+{
+    // on-disk TileMap metadata cache; see setMetadataCacheDirectory().
+    std::mutex _cacheMutex;
+    std::string _cacheDir;
+    bool _cacheDirSet = false;
+
+    // cache file for an endpoint, or empty if the cache is disabled
+    std::string metadataCachePath(const std::string& endpoint)
+    {
+        auto dir = TMS::metadataCacheDirectory();
+        if (dir.empty())
+            return {};
+
+        auto hash = std::hash<std::string>()(endpoint);
+        return dir + "/tms-" + std::to_string(hash) + ".json";
+    }
+
+    std::string readCacheFile(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open())
+            return {};
+
+        std::stringstream buf;
+        buf << in.rdbuf();
+        return buf.str();
+    }
+
+    void writeCacheFile(const std::string& path, const std::string& content)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+        // write-then-rename so a concurrent reader never sees a partial file:
+        auto temp = path + "~";
+        {
+            std::ofstream out(temp, std::ios::binary);
+            if (!out.is_open())
+                return;
+            out.write(content.data(), (std::streamsize)content.size());
+            if (!out)
+                return;
+        }
+        std::filesystem::rename(temp, path, ec);
+    }
+}
+
+void
+TMS::setMetadataCacheDirectory(const std::string& path)
+{
+    std::scoped_lock L(_cacheMutex);
+    _cacheDir = path;
+    _cacheDirSet = true;
+}
+
+std::string
+TMS::metadataCacheDirectory()
+{
+    std::scoped_lock L(_cacheMutex);
+    if (!_cacheDirSet)
+    {
+        _cacheDir = util::getEnvVar("TMS_CACHE_DIR");
+        _cacheDirSet = true;
+    }
+    return _cacheDir;
+}
+
+std::string
+TMS::tileMapToJSON(const TileMap& tm)
+{
+    auto j = json::object();
+    j["tile_map_service"] = tm.tileMapService;
+    j["version"] = tm.version;
+    j["title"] = tm.title;
+    j["abstract"] = tm.abstract;
+    j["srs"] = tm.srsString;
+    j["vsrs"] = tm.vsrsString;
+    j["origin_x"] = tm.originX;
+    j["origin_y"] = tm.originY;
+    j["xmin"] = tm.minX;
+    j["ymin"] = tm.minY;
+    j["xmax"] = tm.maxX;
+    j["ymax"] = tm.maxY;
+    j["filename"] = tm.filename;
+    j["min_level"] = tm.minLevel;
+    j["max_level"] = tm.maxLevel;
+    j["num_tiles_wide"] = tm.numTilesWide;
+    j["num_tiles_high"] = tm.numTilesHigh;
+    j["profile_type"] = (int)tm.profileType;
+    j["timestamp"] = (std::int64_t)tm.timestamp;
+    j["invert_y_axis"] = tm.invertYaxis;
+
+    auto j_format = json::object();
+    j_format["width"] = tm.format.width;
+    j_format["height"] = tm.format.height;
+    j_format["mime_type"] = tm.format.mimeType;
+    j_format["extension"] = tm.format.extension;
+    j["format"] = j_format;
+
+    auto j_tileSets = json::array();
+    for (auto& ts : tm.tileSets)
+    {
+        auto j_ts = json::object();
+        j_ts["href"] = ts.href;
+        j_ts["units_per_pixel"] = ts.unitsPerPixel;
+        j_ts["order"] = ts.order;
+        j_tileSets.push_back(j_ts);
+    }
+    j["tile_sets"] = j_tileSets;
+
+    auto j_extents = json::array();
+    for (auto& de : tm.dataExtents)
+    {
+        if (!de.valid())
+            continue;
+        auto j_de = json::object();
+        j_de["srs"] = de.srs().definition();
+        j_de["xmin"] = de.xmin();
+        j_de["ymin"] = de.ymin();
+        j_de["xmax"] = de.xmax();
+        j_de["ymax"] = de.ymax();
+        j_de["data_min_level"] = de.minLevel.value();
+        j_de["data_max_level"] = de.maxLevel.value();
+        j_de["description"] = de.description.value();
+        j_extents.push_back(j_de);
+    }
+    j["data_extents"] = j_extents;
+
+    return j.dump();
+}
+
+Result<TMS::TileMap>
+TMS::tileMapFromJSON(const std::string& input)
+{
+    auto j = json::parse(input, nullptr, false);
+    if (j.is_discarded() || !j.is_object())
+        return Status(Status::GeneralError, "Malformed TileMap snapshot");
+
+    auto str = [&](const json& o, const char* key, std::string& out)
+        { if (o.contains(key) && o.at(key).is_string()) out = o.at(key).get<std::string>(); };
+    auto num = [&](const json& o, const char* key, auto& out)
+        { if (o.contains(key) && o.at(key).is_number()) out = o.at(key).get<std::decay_t<decltype(out)>>(); };
+
+    TileMap tm;
+    str(j, "tile_map_service", tm.tileMapService);
+    str(j, "version", tm.version);
+    str(j, "title", tm.title);
+    str(j, "abstract", tm.abstract);
+    str(j, "srs", tm.srsString);
+    str(j, "vsrs", tm.vsrsString);
+    num(j, "origin_x", tm.originX);
+    num(j, "origin_y", tm.originY);
+    num(j, "xmin", tm.minX);
+    num(j, "ymin", tm.minY);
+    num(j, "xmax", tm.maxX);
+    num(j, "ymax", tm.maxY);
+    str(j, "filename", tm.filename);
+    num(j, "min_level", tm.minLevel);
+    num(j, "max_level", tm.maxLevel);
+    num(j, "num_tiles_wide", tm.numTilesWide);
+    num(j, "num_tiles_high", tm.numTilesHigh);
+
+    int profileType = (int)ProfileType::UNKNOWN;
+    num(j, "profile_type", profileType);
+    tm.profileType = (ProfileType)profileType;
+
+    std::int64_t timestamp = 0;
+    num(j, "timestamp", timestamp);
+    tm.timestamp = (TimeStamp)timestamp;
+
+    if (j.contains("invert_y_axis") && j.at("invert_y_axis").is_boolean())
+        tm.invertYaxis = j.at("invert_y_axis").get<bool>();
+
+    if (j.contains("format") && j.at("format").is_object())
+    {
+        auto& j_format = j.at("format");
+        num(j_format, "width", tm.format.width);
+        num(j_format, "height", tm.format.height);
+        str(j_format, "mime_type", tm.format.mimeType);
+        str(j_format, "extension", tm.format.extension);
+    }
+
+    if (j.contains("tile_sets") && j.at("tile_sets").is_array())
+    {
+        for (auto& j_ts : j.at("tile_sets"))
+        {
+            TileSet ts;
+            str(j_ts, "href", ts.href);
+            num(j_ts, "units_per_pixel", ts.unitsPerPixel);
+            num(j_ts, "order", ts.order);
+            tm.tileSets.emplace_back(std::move(ts));
+        }
+    }
+
+    if (j.contains("data_extents") && j.at("data_extents").is_array())
+    {
+        for (auto& j_de : j.at("data_extents"))
+        {
+            std::string srsdef;
+            double xmin = 0, ymin = 0, xmax = -1, ymax = -1;
+            str(j_de, "srs", srsdef);
+            num(j_de, "xmin", xmin);
+            num(j_de, "ymin", ymin);
+            num(j_de, "xmax", xmax);
+            num(j_de, "ymax", ymax);
+
+            DataExtent de(GeoExtent(SRS(srsdef), xmin, ymin, xmax, ymax));
+            unsigned minl = 0u, maxl = 99u;
+            num(j_de, "data_min_level", minl);
+            num(j_de, "data_max_level", maxl);
+            de.minLevel = minl;
+            de.maxLevel = maxl;
+            std::string description;
+            str(j_de, "description", description);
+            if (!description.empty())
+                de.description = description;
+            tm.dataExtents.emplace_back(std::move(de));
+        }
+    }
+
+    // re-derive the rotation element instead of persisting working state:
+    auto rotateStart = tm.filename.find('[');
+    auto rotateEnd = tm.filename.find(']');
+    if (rotateStart != std::string::npos && rotateEnd != std::string::npos && rotateEnd - rotateStart > 1)
+    {
+        tm.rotateString = tm.filename.substr(rotateStart, rotateEnd - rotateStart + 1);
+    }
+
+    return tm;
+}
+
 void
 TMS::Driver::close()
 {
@@ -645,18 +887,75 @@ TMS::Driver::open(const URI& uri, Profile& profile, const std::string& format, D
 
     else
     {
-        // Attempt to read the tile map parameters from a TMS TileMap manifest:
-        auto tileMapRead = readTileMap(uri, io);
+        // With the metadata cache enabled, a warm start restores the
+        // parsed TileMap from disk and skips the manifest fetch; the
+        // manifest is then re-fetched in the background and the cache
+        // refreshed if it changed, so the next run picks up the update.
+        auto cachePath = metadataCachePath(uri.full());
+        bool restoredFromCache = false;
+
+        if (!cachePath.empty())
+        {
+            auto cachedJSON = readCacheFile(cachePath);
+            if (!cachedJSON.empty())
+            {
+                auto cached = tileMapFromJSON(cachedJSON);
+                if (cached.status.ok() && cached.value.valid())
+                {
+                    Profile cachedProfile = cached.value.createProfile();
+                    if (cachedProfile.valid())
+                    {
+                        tileMap = cached.value;
+                        profile = cachedProfile;
+                        restoredFromCache = true;
 
-        if (tileMapRead.status.failed())
-            return tileMapRead.status;
+                        const URI local_uri(uri);
+                        const IOOptions local_io(io);
 
-        tileMap = tileMapRead.value;
+                        auto revalidate = [local_uri, cachePath, cachedJSON, local_io](Cancelable&)
+                            {
+                                auto fresh = readTileMap(local_uri, local_io);
+                                if (fresh.status.ok())
+                                {
+                                    auto freshJSON = tileMapToJSON(fresh.value);
+                                    if (freshJSON != cachedJSON)
+                                    {
+                                        writeCacheFile(cachePath, freshJSON);
+                                        Log()->info(LC "TileMap changed at {}; cache refreshed for the next run", local_uri.full());
+                                    }
+                                }
+                                return true;
+                            };
+
+                        // can_cancel=false since we discard the future.
+                        jobs::dispatch(revalidate, jobs::context{
+                            "tms revalidate " + local_uri.full(), jobs::get_pool("rocky.io", 4), {}, nullptr, false });
+                    }
+                }
+            }
+        }
 
-        Profile profileFromTileMap = tileMap.createProfile();
-        if (profileFromTileMap.valid())
+        if (!restoredFromCache)
         {
-            profile = profileFromTileMap;
+            // Attempt to read the tile map parameters from a TMS TileMap manifest:
+            auto tileMapRead = readTileMap(uri, io);
+
+            if (tileMapRead.status.failed())
+                return tileMapRead.status;
+
+            tileMap = tileMapRead.value;
+
+            Profile profileFromTileMap = tileMap.createProfile();
+            if (profileFromTileMap.valid())
+            {
+                profile = profileFromTileMap;
+            }
+
+            // prime the cache for the next warm start:
+            if (!cachePath.empty() && tileMap.valid())
+            {
+                writeCacheFile(cachePath, tileMapToJSON(tileMap));
+            }
         }
     }
 
@@ -687,6 +986,38 @@ TMS::Driver::open(const URI& uri, Profile& profile, const std::string& format, D
     return StatusOK;
 }
 
+Status
+TMS::Driver::open(const TileMap& in_tileMap, const Profile& profile, DataExtentList& dataExtents)
+{
+    if (!in_tileMap.valid())
+    {
+        return Status(Status::ConfigurationError, "Invalid TileMap snapshot");
+    }
+
+    if (!profile.valid())
+    {
+        return Status(Status::ConfigurationError, "TileMap snapshot requires a valid profile");
+    }
+
+    tileMap = in_tileMap;
+
+    // Same data-extents policy as a live open, minus the manifest fetch:
+    if (!tileMap.tileSets.empty())
+    {
+        for (auto& de : tileMap.dataExtents)
+        {
+            dataExtents.push_back(de);
+        }
+    }
+
+    if (dataExtents.empty())
+    {
+        dataExtents.push_back(DataExtent(profile.extent(), 0, tileMap.maxLevel));
+    }
+
+    return StatusOK;
+}
+
 Result<std::shared_ptr<Image>>
 TMS::Driver::read(const TileKey& key, bool invertY, bool isMapboxRGB, const URIContext& context, const IOOptions& io) const
 {
@@ -104,6 +104,25 @@ namespace ROCKY_NAMESPACE
 
         extern TileMapEntries readTileMapEntries(const URI& location, const IOOptions& io);
 
+        //! Serializes a probed TileMap, so a configuration snapshot can
+        //! restore it on a later startup without re-fetching the manifest.
+        extern ROCKY_EXPORT std::string tileMapToJSON(const TileMap& tileMap);
+
+        //! Restores a TileMap serialized with tileMapToJSON.
+        extern ROCKY_EXPORT Result<TileMap> tileMapFromJSON(const std::string& input);
+
+        //! Directory for the on-disk TileMap metadata cache. When set, a
+        //! Driver opening a TMS manifest loads the cached TileMap (keyed
+        //! by endpoint) instead of fetching and parsing the manifest, and
+        //! revalidates the cache in the background; the open only blocks
+        //! on the network when there is no usable cached entry. An empty
+        //! string (the default) disables the cache. Also settable with
+        //! the ROCKY_TMS_CACHE_DIR environment variable.
+        extern ROCKY_EXPORT void setMetadataCacheDirectory(const std::string& path);
+
+        //! The TileMap metadata cache directory; empty if disabled.
+        extern ROCKY_EXPORT std::string metadataCacheDirectory();
+
 
         /**
          * Underlying TMS driver that does the actual TMS I/O
@@ -118,6 +137,14 @@ namespace ROCKY_NAMESPACE
                 DataExtentList& out_dataExtents,
                 const IOOptions& io);
 
+            //! Open from a previously probed TileMap (see tileMapFromJSON),
+            //! skipping the manifest fetch entirely. The caller supplies the
+            //! resolved profile it recorded alongside the TileMap.
+            Status open(
+                const TileMap& in_tileMap,
+                const Profile& profile,
+                DataExtentList& out_dataExtents);
+
             void close();
 
             Result<std::shared_ptr<Image>> read(
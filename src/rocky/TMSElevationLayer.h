@@ -24,6 +24,12 @@ namespace ROCKY_NAMESPACE
         //! Serialize
         std::string to_json() const override;
 
+        //! Serialize the probed TileMap and resolved profile
+        std::string snapshotState() const override;
+
+        //! Restore a probed TileMap so open() can skip the manifest fetch
+        void restoreSnapshotState(const std::string&) override;
+
         option<Encoding> encoding;
 
     public: // Layer
@@ -37,6 +43,8 @@ namespace ROCKY_NAMESPACE
 
     private:
         TMS::Driver _driver;
+        TMS::TileMap _restoredTileMap;
+        Profile _restoredProfile;
         void construct(const std::string& JSON, const IOOptions& io);
     };
 }
@@ -58,6 +58,35 @@ TMSImageLayer::to_json() const
     return j.dump();
 }
 
+std::string
+TMSImageLayer::snapshotState() const
+{
+    if (!isOpen() || !_driver.tileMap.valid())
+        return {};
+
+    auto j = json::object();
+    j["tile_map"] = json::parse(TMS::tileMapToJSON(_driver.tileMap));
+    if (profile.valid())
+        set(j, "profile", profile);
+    return j.dump();
+}
+
+void
+TMSImageLayer::restoreSnapshotState(const std::string& state)
+{
+    const auto j = parse_json(state);
+    if (j.status.failed())
+        return;
+
+    if (j.contains("tile_map"))
+    {
+        auto tileMap = TMS::tileMapFromJSON(j.at("tile_map").dump());
+        if (tileMap.status.ok())
+            _restoredTileMap = tileMap.value;
+    }
+    get_to(j, "profile", _restoredProfile);
+}
+
 Status
 TMSImageLayer::openImplementation(const IOOptions& io)
 {
@@ -65,6 +94,24 @@ TMSImageLayer::openImplementation(const IOOptions& io)
     if (parent.failed())
         return parent;
 
+    // A restored snapshot lets us skip the manifest fetch entirely:
+    if (_restoredTileMap.valid() && _restoredProfile.valid())
+    {
+        DataExtentList dataExtents;
+        Status status = _driver.open(_restoredTileMap, _restoredProfile, dataExtents);
+        if (status.ok())
+        {
+            profile = _restoredProfile;
+            if (name().empty() && !_driver.tileMap.title.empty())
+            {
+                setName(_driver.tileMap.title);
+            }
+            setDataExtents(dataExtents);
+            return StatusOK;
+        }
+        // fall through to a live open if the snapshot was unusable
+    }
+
     Profile driver_profile = profile;
 
     DataExtentList dataExtents;
@@ -24,6 +24,12 @@ namespace ROCKY_NAMESPACE
         //! serialize
         std::string to_json() const override;
 
+        //! serialize the probed TileMap and resolved profile
+        std::string snapshotState() const override;
+
+        //! restore a probed TileMap so open() can skip the manifest fetch
+        void restoreSnapshotState(const std::string&) override;
+
     protected: // Layer
 
         Status openImplementation(const IOOptions& io) override;
@@ -35,6 +41,8 @@ namespace ROCKY_NAMESPACE
 
     private:
         TMS::Driver _driver;
+        TMS::TileMap _restoredTileMap;
+        Profile _restoredProfile;
 
         void construct(const std::string& JSON, const IOOptions& io);
     };
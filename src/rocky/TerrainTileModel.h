@@ -10,6 +10,7 @@
 #include <rocky/Math.h>
 #include <rocky/GeoImage.h>
 #include <rocky/GeoHeightfield.h>
+#include <rocky/Utils.h>
 #include <vector>
 
 namespace ROCKY_NAMESPACE
@@ -80,7 +81,9 @@ namespace ROCKY_NAMESPACE
         {
             GeoImage image;
             std::shared_ptr<const Layer> layer;
-            using Vector = std::vector<ColorLayer>;
+
+            // inline storage; tiles nearly always carry just a few layers
+            using Vector = util::small_vector<ColorLayer, 4>;
         };
 
         struct ROCKY_EXPORT Elevation : public Tile
@@ -117,6 +120,12 @@ namespace ROCKY_NAMESPACE
         //! Whether some data here requires updates
         bool requiresUpdate = false;
 
+        //! Layers whose fetch was skipped because the layer was at its
+        //! concurrent-request quota (see TileLayer::maxConcurrentRequests).
+        //! A tile built from this model is missing that data and should
+        //! schedule a reload.
+        std::vector<UID> skippedLayers;
+
         //! Imagery and other surface coloring layers
         ColorLayer::Vector colorLayers;
 
@@ -4,16 +4,290 @@
  * MIT License
  */
 #include "TerrainTileModelFactory.h"
+#include "Arena.h"
 #include "Map.h"
+#include "PipelineMetrics.h"
+#include "ElevationConstraintLayer.h"
 #include "ElevationLayer.h"
 #include "ImageLayer.h"
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define LC "[TerrainTileModelFactory] "
 
 using namespace ROCKY_NAMESPACE;
 
 namespace
 {
+    // Simple binary container for a composited tile model. Payloads are
+    // raw pixels in the Image's native layout, so a cache hit is a couple
+    // of reads straight into the tile's buffers - no decoding or warping.
+    constexpr char CACHE_MAGIC[4] = { 'R', 'T', 'C', '1' };
+
+    struct CachedModelHeader
+    {
+        char magic[4];
+        std::int32_t revision;
+        std::uint32_t imageFormat;
+        std::uint32_t imageWidth, imageHeight;   // 0x0 => no color layer
+        std::uint32_t hfWidth, hfHeight;         // 0x0 => no elevation
+    };
+
+    std::string cachedModelPath(const std::string& folder, const TileKey& key)
+    {
+        return folder + '/' +
+            std::to_string(key.level) + '_' +
+            std::to_string(key.x) + '_' +
+            std::to_string(key.y) + ".rtile";
+    }
+
+    // Read-only memory map of one cache entry. The mapping aliases the
+    // OS page cache, so when several processes on a host point at the
+    // same cache directory (e.g. one Rocky process per display channel)
+    // the warm bytes exist once in physical memory instead of once per
+    // process. Entries are immutable once renamed into place (see
+    // writeCachedModel), so readers need no locking at all.
+    struct MappedCacheEntry
+    {
+        const char* data = nullptr;
+        std::size_t size = 0;
+
+        bool valid() const { return data != nullptr; }
+
+#if defined(_WIN32)
+        HANDLE _file = INVALID_HANDLE_VALUE;
+        HANDLE _mapping = NULL;
+
+        MappedCacheEntry(const std::string& path)
+        {
+            _file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (_file == INVALID_HANDLE_VALUE)
+                return;
+
+            LARGE_INTEGER filesize;
+            if (!::GetFileSizeEx(_file, &filesize) || filesize.QuadPart <= 0)
+                return;
+
+            _mapping = ::CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (_mapping == NULL)
+                return;
+
+            data = static_cast<const char*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (data)
+                size = (std::size_t)filesize.QuadPart;
+        }
+
+        ~MappedCacheEntry()
+        {
+            if (data)
+                ::UnmapViewOfFile(data);
+            if (_mapping != NULL)
+                ::CloseHandle(_mapping);
+            if (_file != INVALID_HANDLE_VALUE)
+                ::CloseHandle(_file);
+        }
+#else
+        int _fd = -1;
+
+        MappedCacheEntry(const std::string& path)
+        {
+            _fd = ::open(path.c_str(), O_RDONLY);
+            if (_fd < 0)
+                return;
+
+            struct stat st;
+            if (::fstat(_fd, &st) != 0 || st.st_size <= 0)
+                return;
+
+            void* mapped = ::mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                data = static_cast<const char*>(mapped);
+                size = (std::size_t)st.st_size;
+            }
+        }
+
+        ~MappedCacheEntry()
+        {
+            if (data)
+                ::munmap(const_cast<char*>(data), size);
+            if (_fd >= 0)
+                ::close(_fd);
+        }
+#endif
+
+        MappedCacheEntry(const MappedCacheEntry&) = delete;
+        MappedCacheEntry& operator=(const MappedCacheEntry&) = delete;
+    };
+
+    bool readCachedModel(const std::string& folder, const TileKey& key, TerrainTileModel& out)
+    {
+        MappedCacheEntry entry(cachedModelPath(folder, key));
+        if (!entry.valid() || entry.size < sizeof(CachedModelHeader))
+            return false;
+
+        const char* ptr = entry.data;
+        std::size_t remaining = entry.size;
+
+        CachedModelHeader header;
+        std::memcpy(&header, ptr, sizeof(header));
+        ptr += sizeof(header), remaining -= sizeof(header);
+
+        if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+            header.revision != out.revision)
+        {
+            return false;
+        }
+
+        TerrainTileModel model;
+        model.key = key;
+        model.revision = out.revision;
+
+        if (header.imageWidth > 0 && header.imageHeight > 0)
+        {
+            auto image = Image::create(
+                (Image::PixelFormat)header.imageFormat,
+                header.imageWidth, header.imageHeight);
+
+            if (remaining < image->sizeInBytes())
+                return false;
+
+            std::memcpy(image->data<unsigned char>(), ptr, image->sizeInBytes());
+            ptr += image->sizeInBytes(), remaining -= image->sizeInBytes();
+
+            TerrainTileModel::ColorLayer color;
+            color.key = key;
+            color.revision = out.revision;
+            color.image = GeoImage(image, key.extent());
+            model.colorLayers.emplace_back(std::move(color));
+        }
+
+        if (header.hfWidth > 0 && header.hfHeight > 0)
+        {
+            auto hf = Heightfield::create(header.hfWidth, header.hfHeight);
+
+            if (remaining < hf->sizeInBytes())
+                return false;
+
+            std::memcpy(hf->data<unsigned char>(), ptr, hf->sizeInBytes());
+            ptr += hf->sizeInBytes(), remaining -= hf->sizeInBytes();
+
+            model.elevation.key = key;
+            model.elevation.revision = out.revision;
+            model.elevation.heightfield = GeoHeightfield(hf, key.extent());
+        }
+
+        if (model.empty())
+            return false;
+
+        out = std::move(model);
+        return true;
+    }
+
+    void writeCachedModel(const std::string& folder, const TerrainTileModel& model)
+    {
+        // only cache fully-composited models whose data actually belongs
+        // to this key (i.e. nothing inherited from an ancestor).
+        if (model.colorLayers.size() > 1)
+            return;
+        if (!model.colorLayers.empty() && model.colorLayers.front().key != model.key)
+            return;
+        if (model.elevation.heightfield.valid() && model.elevation.key != model.key)
+            return;
+
+        auto image = model.colorLayers.empty() ?
+            nullptr : model.colorLayers.front().image.image();
+        auto hf = model.elevation.heightfield.heightfield();
+
+        // the cache format is raw CPU pixels; an image without a pixel
+        // buffer (e.g. a GPU-native payload) cannot round-trip it.
+        if (image && !image->valid())
+            return;
+
+        CachedModelHeader header;
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.revision = model.revision;
+        header.imageFormat = image ? (std::uint32_t)image->pixelFormat() : 0u;
+        header.imageWidth = image ? image->width() : 0u;
+        header.imageHeight = image ? image->height() : 0u;
+        header.hfWidth = hf ? hf->width() : 0u;
+        header.hfHeight = hf ? hf->height() : 0u;
+
+        auto path = cachedModelPath(folder, model.key);
+
+        // when several processes share the cache directory, the first
+        // writer wins and everyone else skips the I/O entirely:
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec))
+            return;
+
+        std::filesystem::create_directories(folder, ec);
+
+        // Write to a private temp file, then publish it with an atomic
+        // rename. Readers in other processes either see the complete
+        // entry or no entry - never a partial file - which is what lets
+        // readCachedModel map entries with no locking.
+#if defined(_WIN32)
+        auto temp = path + ".w" + std::to_string(::GetCurrentProcessId());
+#else
+        auto temp = path + ".w" + std::to_string((unsigned long)::getpid());
+#endif
+
+        {
+            std::ofstream out(temp, std::ios::binary);
+            if (!out)
+                return;
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            if (image)
+                out.write(reinterpret_cast<const char*>(image->data<unsigned char>()), image->sizeInBytes());
+
+            if (hf)
+                out.write(reinterpret_cast<const char*>(hf->data<unsigned char>()), hf->sizeInBytes());
+
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(temp, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp, path, ec);
+        if (ec)
+        {
+            // another process published the entry first; discard ours.
+            std::filesystem::remove(temp, ec);
+        }
+    }
+    bool is_entirely_zero(const GeoHeightfield& geohf)
+    {
+        auto grid = geohf.heightfield();
+        if (!grid)
+            return false;
+
+        const float* ptr = grid->data<float>();
+        for (unsigned i = 0; i < grid->sizeInPixels(); ++i, ++ptr)
+        {
+            if (*ptr != 0.0f)
+                return false;
+        }
+        return true;
+    }
+
     void replace_nodata_values(GeoHeightfield& geohf)
     {
         auto grid = geohf.heightfield();
@@ -147,12 +421,34 @@ TerrainTileModelFactory::createTileModel(
     model.key = key;
     model.revision = map->revision();
 
-    // assemble all the components:
+    // a disk-cache hit hands back the composited model without touching
+    // the source layers at all:
+    if (!diskCachePath.empty() && readCachedModel(diskCachePath, key, model))
+    {
+        return std::move(model);
+    }
+
+    // assemble all the components, bailing between stages if the
+    // requesting tile has been abandoned (e.g., scrolled off-screen and
+    // expired) so the worker frees up for visible tiles.
     addColorLayers(model, map, key, manifest, io, false);
 
+    if (io.canceled())
+        return {};
+
     unsigned border = 0u;
     addElevation(model, map, key, manifest, border, io);
 
+    if (io.canceled())
+        return {};
+
+    // never cache a model that skipped an over-quota layer; it is
+    // missing data and will be rebuilt.
+    if (!diskCachePath.empty() && !model.empty() && model.skippedLayers.empty())
+    {
+        writeCachedModel(diskCachePath, model);
+    }
+
     return std::move(model);
 }
 
@@ -165,7 +461,7 @@ namespace
         TileKey key = requested_key;
         if (fallback)
         {
-            while(key.valid() && !result.value.valid())
+            while(key.valid() && !result.value.valid() && !io.canceled())
             {
                 result = layer->createImage(key, io);
                 if (!result.value.valid())
@@ -221,10 +517,13 @@ TerrainTileModelFactory::addColorLayers(
         });
 
     // first collect the image layers that have intersecting data.
-    std::vector<std::shared_ptr<ImageLayer>> intersecting_layers;
+    // the working list is job-local, so it lives in the thread's arena.
+    util::ScopedArena arena(util::Arena::threadLocal());
+    util::arena_vector<std::shared_ptr<ImageLayer>> intersecting_layers(arena);
+    intersecting_layers.reserve(layers.size());
     bool inLegalRange = false;
     bool intersects = false;
-    for (auto layer : layers)
+    for (auto& layer : layers)
     {
         auto imageLayer = ImageLayer::cast(layer);
         if (imageLayer)
@@ -244,7 +543,12 @@ TerrainTileModelFactory::addColorLayers(
     {
         // if only one layer intersects we will not need to composite
         // so just get the raw data for this key if there is any.
-        addImageLayer(key, intersecting_layers.front(), false, model, io);
+        auto& layer = intersecting_layers.front();
+        TileLayer::RequestSlot slot(layer.get(), io);
+        if (slot.acquired())
+            addImageLayer(key, layer, false, model, io);
+        else
+            model.skippedLayers.push_back(layer->uid());
     }
 
     else if (intersecting_layers.size() > 1)
@@ -253,7 +557,7 @@ TerrainTileModelFactory::addColorLayers(
         // First count the number of layers that MIGHT have data.
         // If any of them do, we must fetch them all for composition.
         bool data_maybe = false;
-        for (auto layer : intersecting_layers)
+        for (auto& layer : intersecting_layers)
         {
             if (layer->mayHaveData(key))
             {
@@ -264,14 +568,34 @@ TerrainTileModelFactory::addColorLayers(
 
         if (data_maybe)
         {
-            for (auto layer : intersecting_layers)
+            for (auto& layer : intersecting_layers)
             {
+                // check for cancelation between layer fetches so an
+                // abandoned tile releases its worker mid-pipeline.
+                if (io.canceled())
+                    return;
+
+                // honor the layer's in-flight quota; a saturated (likely
+                // degraded) source gets skipped so it degrades only its
+                // own layer instead of stalling the whole tile.
+                TileLayer::RequestSlot slot(layer.get(), io);
+                if (!slot.acquired())
+                {
+                    model.skippedLayers.push_back(layer->uid());
+                    continue;
+                }
+
                 addImageLayer(key, layer, true, model, io);
             }
 
             // now composite them.
+            if (io.canceled())
+                return;
+
             if (compositeColorLayers && model.colorLayers.size() > 1)
             {
+                util::PipelineMetrics::Scoped pm(util::PipelineMetrics::COMPOSITE);
+
                 auto& base_image = model.colorLayers.front().image;
                 TerrainTileModel::Tile tile = model.colorLayers.front();
 
@@ -287,6 +611,11 @@ TerrainTileModelFactory::addColorLayers(
                 std::vector<float> opacities;
                 for (auto& i : model.colorLayers)
                 {
+                    // an image without a CPU pixel buffer (e.g. a
+                    // GPU-native payload) cannot be composited; skip it.
+                    if (i.image.image() && !i.image.image()->valid())
+                        continue;
+
                     sources.emplace_back(std::move(i.image));
                     auto* imagelayer = dynamic_cast<const ImageLayer*>(i.layer.get());
                     opacities.emplace_back(imagelayer ? imagelayer->opacity.value() : 1.0f);
@@ -383,7 +712,7 @@ TerrainTileModelFactory::addElevation(
             combinedRevision += layer->revision();
         }
     }
-    if (!needElevation)
+    if (!needElevation || io.canceled())
         return false;
 
     auto layer = map->layers().firstOfType<ElevationLayer>();
@@ -393,22 +722,55 @@ TerrainTileModelFactory::addElevation(
         layer->isKeyInLegalRange(key) &&
         layer->mayHaveData(key))
     {
-        auto result = layer->createHeightfield(key, io);
-
-        if (result.status.ok())
+        TileLayer::RequestSlot slot(layer.get(), io);
+        if (!slot.acquired())
         {
-            replace_nodata_values(result.value);
+            // over quota; skip the fetch so a degraded elevation source
+            // doesn't stall the tile, and mark the model for a retry.
+            model.skippedLayers.push_back(layer->uid());
+        }
+        else
+        {
+            auto result = layer->createHeightfield(key, io);
 
-            model.elevation.heightfield = std::move(result.value);
-            model.elevation.revision = layer->revision();
-            model.elevation.key = key;
+            if (result.status.ok())
+            {
+                replace_nodata_values(result.value);
+
+                // optionally treat an all-zero heightfield (e.g. open ocean)
+                // as no data; the tile renders identically with the default
+                // flat elevation and skips the texture upload.
+                if (!discardFlatHeightfields || !is_entirely_zero(result.value))
+                {
+                    model.elevation.heightfield = std::move(result.value);
+                    model.elevation.revision = layer->revision();
+                    model.elevation.key = key;
+                }
+            }
+
+            // ResourceUnavailable just means the driver could not produce data
+            // for the tilekey; it is not an actual read error.
+            else if (result.status.code != Status::ResourceUnavailable)
+            {
+                Log()->warn("Problem getting data from \"" + layer->name() + "\" : " + result.status.message);
+            }
         }
+    }
 
-        // ResourceUnavailable just means the driver could not produce data
-        // for the tilekey; it is not an actual read error.
-        else if (result.status.code != Status::ResourceUnavailable)
+    // apply any runtime elevation constraints (flatten/offset polygons)
+    // while the heightfield is still on the load job; each constraint
+    // layer's spatial index rules out non-intersecting tiles with a
+    // single rectangle query.
+    if (model.elevation.heightfield.valid())
+    {
+        for (auto& constraints : map->layers().ofType<ElevationConstraintLayer>())
         {
-            Log()->warn("Problem getting data from \"" + layer->name() + "\" : " + result.status.message);
+            if (constraints->isOpen() && constraints->size() > 0)
+            {
+                constraints->applyTo(
+                    *model.elevation.heightfield.heightfield(),
+                    model.elevation.heightfield.extent());
+            }
         }
     }
 
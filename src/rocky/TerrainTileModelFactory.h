@@ -25,6 +25,25 @@ namespace ROCKY_NAMESPACE
         //! Whether to composite all color layers into one
         bool compositeColorLayers = true;
 
+        //! Whether to discard heightfields that are entirely at zero
+        //! elevation (e.g. open ocean) instead of returning them; the
+        //! consumer then falls back on its default flat elevation.
+        bool discardFlatHeightfields = false;
+
+        //! Optional folder in which to persist composited tile models.
+        //! When set, createTileModel will attempt to read a tile from
+        //! disk (keyed by tile key and map revision) before recomputing
+        //! it from the source layers, and will store newly composited
+        //! tiles. The cache stores raw pixels, so a hit requires no
+        //! decoding or warping. Empty string disables the cache.
+        //!
+        //! The cache is safe to share between processes: entries publish
+        //! with an atomic rename and reads memory-map them, so multiple
+        //! instances on one host (e.g. one per display channel) share a
+        //! single warm cache - a tile fetched by any instance serves all
+        //! of them, and the mapped pages exist once in physical memory.
+        std::string diskCachePath;
+
     public:
         TerrainTileModelFactory();
 
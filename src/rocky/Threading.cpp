@@ -14,6 +14,11 @@
 #   include <pthread.h>
 #endif
 
+#ifdef __linux__
+#   include <sys/resource.h>
+#   include <sys/syscall.h>
+#endif
+
 void
 rocky::util::setThreadName(const std::string& name)
 {
@@ -46,3 +51,58 @@ rocky::util::setThreadName(const std::string& name)
     }
 #endif
 }
+
+void
+rocky::util::setThreadPriority(ThreadPriority priority)
+{
+#ifdef _WIN32
+
+    auto thread = ::GetCurrentThread();
+
+    if (priority == ThreadPriority::Background)
+    {
+        // background mode also lowers the thread's I/O and memory
+        // priorities, which is what keeps bulk work from stealing
+        // frames on single-GPU kiosk machines:
+        ::SetThreadPriority(thread, THREAD_MODE_BACKGROUND_BEGIN);
+    }
+    else if (priority == ThreadPriority::TimeCritical)
+    {
+        ::SetThreadPriority(thread, THREAD_MODE_BACKGROUND_END);
+        ::SetThreadPriority(thread, THREAD_PRIORITY_HIGHEST);
+    }
+    else
+    {
+        ::SetThreadPriority(thread, THREAD_MODE_BACKGROUND_END);
+        ::SetThreadPriority(thread, THREAD_PRIORITY_NORMAL);
+    }
+
+#elif defined(__APPLE__)
+
+    if (priority == ThreadPriority::Background)
+        pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+    else if (priority == ThreadPriority::TimeCritical)
+        pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+    else
+        pthread_set_qos_class_self_np(QOS_CLASS_DEFAULT, 0);
+
+#elif defined(__linux__)
+
+    // SCHED_IDLE demotes the thread below every normal-priority thread.
+    // Raising priority above normal needs CAP_SYS_NICE, so TimeCritical
+    // just attempts a negative nice value and quietly stays at Normal
+    // if the OS refuses.
+    sched_param param;
+    param.sched_priority = 0;
+
+    pthread_setschedparam(pthread_self(),
+        priority == ThreadPriority::Background ? SCHED_IDLE : SCHED_OTHER,
+        &param);
+
+    if (priority == ThreadPriority::TimeCritical)
+    {
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), -4);
+    }
+
+#endif
+}
@@ -8,6 +8,7 @@
 #include <rocky/weejobs.h>
 #include <vector>
 #include <list>
+#include <unordered_map>
 
 namespace ROCKY_NAMESPACE
 {
@@ -18,6 +19,78 @@ namespace ROCKY_NAMESPACE
         //! Sets the name of the current thread
         extern ROCKY_EXPORT void setThreadName(const std::string& name);
 
+        //! OS scheduling class for a worker thread.
+        enum class ThreadPriority
+        {
+            //! Default OS scheduling
+            Normal,
+
+            //! Yields to all interactive work; for bulk jobs like cache
+            //! warming and prefetch that should never cost the render
+            //! thread a frame
+            Background,
+
+            //! Elevated scheduling for latency-sensitive work; the OS may
+            //! refuse the request for an unprivileged process, in which
+            //! case the thread stays at Normal
+            TimeCritical
+        };
+
+        //! Sets the OS scheduling priority of the current thread.
+        extern ROCKY_EXPORT void setThreadPriority(ThreadPriority priority);
+
+        //! Installs a hook that runs each of a job pool's worker threads at
+        //! the given scheduling priority. Only affects threads started after
+        //! the call, so use it on a pool created with zero threads, before
+        //! raising its concurrency.
+        inline void setJobPoolThreadPriority(jobs::jobpool* pool, ThreadPriority priority)
+        {
+            if (pool)
+            {
+                pool->set_thread_init_function([priority](unsigned) {
+                    setThreadPriority(priority);
+                    });
+            }
+        }
+
+        /**
+        * Cancelable shared by a family of related background operations so
+        * they can all be canceled with one call - for example, everything
+        * a Layer has in flight when it closes. An operation joins the
+        * group by layering a Member over its own canceler; the member
+        * reports canceled when either the operation's own canceler or the
+        * whole group trips.
+        */
+        class CancelableGroup : public Cancelable
+        {
+        public:
+            //! Whether the group has been canceled
+            bool canceled() const override { return _canceled; }
+
+            //! Cancel every operation in the group
+            void cancel() { _canceled = true; }
+
+            //! Re-arm the group after a cancellation
+            void reset() { _canceled = false; }
+
+            /** Canceler an individual operation uses while in the group */
+            struct Member : public Cancelable
+            {
+                Member(const CancelableGroup& group, const Cancelable& own) :
+                    _group(&group), _own(&own) { }
+
+                bool canceled() const override {
+                    return _group->canceled() || _own->canceled();
+                }
+
+                const CancelableGroup* _group;
+                const Cancelable* _own;
+            };
+
+        private:
+            std::atomic_bool _canceled = { false };
+        };
+
         /** Per-thread data store */
         template<class T>
         struct ThreadLocal
@@ -127,6 +200,60 @@ namespace ROCKY_NAMESPACE
             Gate<T>* _gate = nullptr;
             T _key;
         };
+
+        /**
+         * Table of in-flight keyed operations that lets concurrent requesters
+         * of the same key share a single result. The first caller to join() a
+         * key becomes its leader and performs the work; late arrivals get a
+         * future attached to the leader's result.
+         */
+        template<typename KEY, typename RESULT>
+        class Coalescer
+        {
+        public:
+            struct Ticket
+            {
+                jobs::future<RESULT> result;
+                bool leader = false;
+            };
+
+            //! Join the in-flight operation for a key, registering a new one
+            //! if necessary. A leader ticket obligates the caller to perform
+            //! the work and call resolve() with the result.
+            Ticket join(const KEY& key)
+            {
+                std::scoped_lock lock(_m);
+
+                auto iter = _inflight.find(key);
+                if (iter != _inflight.end())
+                    return Ticket{ iter->second, false };
+
+                Ticket ticket;
+                ticket.leader = true;
+                _inflight[key] = ticket.result;
+                return ticket;
+            }
+
+            //! Resolve the in-flight operation for a key and remove it from
+            //! the table, waking everyone attached to it.
+            void resolve(const KEY& key, const RESULT& value)
+            {
+                jobs::future<RESULT> promise;
+                {
+                    std::scoped_lock lock(_m);
+                    auto iter = _inflight.find(key);
+                    if (iter == _inflight.end())
+                        return;
+                    promise = iter->second;
+                    _inflight.erase(iter);
+                }
+                promise.resolve(value);
+            }
+
+        private:
+            std::mutex _m;
+            std::unordered_map<KEY, jobs::future<RESULT>> _inflight;
+        };
     }
 
 } // namepsace rocky::util
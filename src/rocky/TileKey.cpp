@@ -305,7 +305,7 @@ namespace
         const GeoExtent& key_ext,
         unsigned localLOD,
         const Profile& target_profile,
-        std::vector<TileKey>& out_intersectingKeys)
+        TileKey::Vector& out_intersectingKeys)
     {
         ROCKY_SOFT_ASSERT_AND_RETURN(
             !key_ext.crossesAntimeridian(),
@@ -374,7 +374,7 @@ namespace
 void
 TileKey::getIntersectingKeys(
     const Profile& target_profile,
-    std::vector<TileKey>& out_intersectingKeys) const
+    TileKey::Vector& out_intersectingKeys) const
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(valid(), void());
 
@@ -401,7 +401,7 @@ TileKey::getIntersectingKeys(
     const GeoExtent& input,
     unsigned localLOD,
     const Profile& target_profile,
-    std::vector<TileKey>& out_intersectingKeys)
+    TileKey::Vector& out_intersectingKeys)
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(input.valid() && target_profile.valid(), void());
 
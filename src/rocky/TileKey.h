@@ -7,7 +7,9 @@
 
 #include <rocky/Common.h>
 #include <rocky/Profile.h>
+#include <rocky/Utils.h>
 #include <string>
+#include <cstdint>
 #include <functional> // std::hash
 
 namespace ROCKY_NAMESPACE
@@ -64,14 +66,37 @@ namespace ROCKY_NAMESPACE
                 !profile.equivalentTo(rhs.profile);
         }
 
-        //! Sorts tilekeys, ignoring profiles
+        //! Morton (Z-order) index of this key, with the level packed into
+        //! the top bits: keys sort by level first, and within a level in
+        //! Z-order, which keeps spatially adjacent tiles adjacent in sorted
+        //! containers like the terrain pager's tile table. Collision-free
+        //! through level 28 only: beyond that, x can need more than the 29
+        //! interleaved bits (a 2x1-root profile needs level+1 bits), so
+        //! distinct keys can share a code. operator< compensates; see below.
+        constexpr std::uint64_t zOrder() const {
+            std::uint64_t xs = spreadBits(x), ys = spreadBits(y);
+            return ((std::uint64_t)level << 58) | (ys << 1) | xs;
+        }
+
+        //! Sorts tilekeys by level, then in Z-order, ignoring profiles.
+        //! Above level 28 the Morton code can alias distinct keys (see
+        //! zOrder), which would silently merge them in a sorted container,
+        //! so those levels fall back to a plain field-wise comparison.
+        //! Both orderings sort by level first, so mixing them stays a
+        //! strict weak ordering.
         inline bool operator < (const TileKey& rhs) const {
-            if (level < rhs.level) return true;
-            if (level > rhs.level) return false;
-            if (x < rhs.x) return true;
-            if (x > rhs.x) return false;
-            if (y < rhs.y) return true;
-            if (y > rhs.y) return false;
+            if (level > 28 || rhs.level > 28)
+            {
+                if (level != rhs.level) return level < rhs.level;
+                if (y != rhs.y) return y < rhs.y;
+                if (x != rhs.x) return x < rhs.x;
+            }
+            else
+            {
+                std::uint64_t a = zOrder(), b = rhs.zOrder();
+                if (a < b) return true;
+                if (a > b) return false;
+            }
             return profile.getHorizSignature() < rhs.profile.getHorizSignature();
         }
 
@@ -153,20 +178,46 @@ namespace ROCKY_NAMESPACE
             unsigned level,
             const Profile& profile);
 
+        //! Collection of tile keys with inline storage; intersecting-key
+        //! queries rarely yield more than a 2x2 block of tiles, so results
+        //! stay out of the heap entirely.
+        using Vector = util::small_vector<TileKey, 4>;
+
         //! Gets the keys that intersect this TileKey in the requested profile.
         void getIntersectingKeys(
             const Profile& profile,
-            std::vector<TileKey>& output) const;
+            Vector& output) const;
 
         static void getIntersectingKeys(
             const GeoExtent& extent,
             unsigned localLOD,
             const Profile& target_profile,
-            std::vector<TileKey>& out_intersectingKeys);
+            Vector& out_intersectingKeys);
 
         //! Convenience method to match this key.
         //bool is(unsigned lod_, unsigned x_, unsigned y_) const {
         //    return lod == lod_ && x == x_ && y == y_;
         //}
+
+    private:
+        //! Spreads the low 29 bits of v to every other bit position.
+        static constexpr std::uint64_t spreadBits(std::uint64_t v) {
+            v &= 0x1fffffffull;
+            v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+            v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+            v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+            v = (v | (v << 2)) & 0x3333333333333333ull;
+            v = (v | (v << 1)) & 0x5555555555555555ull;
+            return v;
+        }
+    };
+}
+
+namespace std {
+    // std::hash specialization for TileKey
+    template<> struct hash<rocky::TileKey> {
+        inline size_t operator()(const rocky::TileKey& value) const {
+            return hash<std::uint64_t>()(value.zOrder());
+        }
     };
 }
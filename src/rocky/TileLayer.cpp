@@ -8,6 +8,8 @@
 #include "Map.h"
 #include "rtree.h"
 #include "json.h"
+#include <chrono>
+#include <thread>
 
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::util;
@@ -40,7 +42,8 @@ TileLayer::construct(const JSON& conf)
     get_to(j, "max_data_level", maxDataLevel);
     get_to(j, "min_level", minLevel);
     get_to(j, "tile_size", tileSize);
-    get_to(j, "profile", _originalProfile);        
+    get_to(j, "max_concurrent_requests", maxConcurrentRequests);
+    get_to(j, "profile", _originalProfile);
 }
 
 JSON
@@ -52,10 +55,54 @@ TileLayer::to_json() const
     set(j, "max_data_level", maxDataLevel);
     set(j, "min_level", minLevel);
     set(j, "tile_size", tileSize);
+    set(j, "max_concurrent_requests", maxConcurrentRequests);
     set(j, "profile", _originalProfile);
     return j.dump();
 }
 
+TileLayer::RequestSlot::RequestSlot(const TileLayer* layer, const IOOptions& io)
+{
+    if (!layer)
+        return;
+
+    unsigned quota = layer->maxConcurrentRequests.value();
+    if (quota == 0u)
+    {
+        ++layer->_requestsInFlight;
+        _layer = layer;
+        return;
+    }
+
+    // Wait briefly for a slot to open so a momentarily busy layer isn't
+    // skipped; a genuinely degraded source stays saturated past the
+    // deadline and the caller moves on to the other layers.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+
+    while (!io.canceled())
+    {
+        unsigned current = layer->_requestsInFlight.load();
+        while (current < quota)
+        {
+            if (layer->_requestsInFlight.compare_exchange_weak(current, current + 1u))
+            {
+                _layer = layer;
+                return;
+            }
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline)
+            return;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+TileLayer::RequestSlot::~RequestSlot()
+{
+    if (_layer)
+        --_layer->_requestsInFlight;
+}
+
 Status
 TileLayer::openImplementation(const IOOptions& io)
 {
@@ -91,6 +138,57 @@ TileLayer::setPermanentProfile(const Profile& perm_profile)
     profile = perm_profile;
 }
 
+void
+TileLayer::dirty(const GeoExtent& dirtyExtent)
+{
+    if (!dirtyExtent.valid())
+    {
+        dirty();
+        return;
+    }
+
+    std::scoped_lock lock(_dirtyExtentsMutex);
+
+    bumpRevision();
+    _dirtyExtents.emplace_back(revision(), dirtyExtent);
+
+    // cap the history; a consumer further behind than this will just
+    // refresh everything.
+    const std::size_t maxHistory = 64;
+    if (_dirtyExtents.size() > maxHistory)
+    {
+        _dirtyHistoryFloor = _dirtyExtents.front().first;
+        _dirtyExtents.erase(_dirtyExtents.begin());
+    }
+}
+
+void
+TileLayer::dirty()
+{
+    std::scoped_lock lock(_dirtyExtentsMutex);
+
+    super::dirty();
+    _dirtyExtents.clear();
+    _dirtyHistoryFloor = revision();
+}
+
+bool
+TileLayer::getDirtyExtents(Revision sinceRevision, std::vector<GeoExtent>& out) const
+{
+    std::scoped_lock lock(_dirtyExtentsMutex);
+
+    if (sinceRevision < _dirtyHistoryFloor)
+        return false;
+
+    for (auto& [rev, extent] : _dirtyExtents)
+    {
+        if (rev > sinceRevision)
+            out.emplace_back(extent);
+    }
+
+    return true;
+}
+
 bool
 TileLayer::isKeyInLegalRange(const TileKey& key) const
 {
@@ -10,6 +10,7 @@
 #include <rocky/VisibleLayer.h>
 #include <rocky/Profile.h>
 #include <rocky/TileKey.h>
+#include <atomic>
 
 namespace ROCKY_NAMESPACE
 {
@@ -44,6 +45,14 @@ namespace ROCKY_NAMESPACE
         //! The extent to which the layer should be cropped.
         option<GeoExtent> crop;
 
+        //! Maximum number of requests this layer may have in flight at
+        //! once across all loader threads (0 = unlimited). A degraded
+        //! source (e.g., a stalled network endpoint) can otherwise occupy
+        //! every loader worker with its slow requests and starve the
+        //! other layers; a quota confines the damage to this layer.
+        //! See RequestSlot for the enforcement mechanism.
+        option<unsigned> maxConcurrentRequests = 0u;
+
         //! Tiling profile and SRS or the layer.
         Profile profile;
 
@@ -87,6 +96,46 @@ namespace ROCKY_NAMESPACE
         //! will result in data.)
         virtual bool isKeyInLegalRange(const TileKey& key) const;
 
+        //! Like dirty(), but records the extent that actually changed.
+        //! Consumers tracking this layer's revision (e.g., the terrain
+        //! pager) can then invalidate only the tiles intersecting that
+        //! extent instead of everything resident. Passing an invalid
+        //! extent is equivalent to dirty().
+        void dirty(const GeoExtent& dirtyExtent);
+
+        //! Dirty the entire layer (see Layer::dirty). Discards any
+        //! recorded dirty extents; the whole layer must refresh.
+        void dirty() override;
+
+        //! Copies the extents recorded by dirty(GeoExtent) for revisions
+        //! newer than sinceRevision into out. Returns false if that span
+        //! includes a whole-layer dirty() or predates the recorded
+        //! history, in which case the caller must treat the entire layer
+        //! as dirty.
+        bool getDirtyExtents(Revision sinceRevision, std::vector<GeoExtent>& out) const;
+
+        /**
+         * RAII hold on one of a layer's concurrent-request slots; see
+         * TileLayer::maxConcurrentRequests. Waits briefly for a slot to
+         * free up so a momentarily busy layer isn't skipped, then gives
+         * up so the calling job can keep servicing the other layers.
+         */
+        struct ROCKY_EXPORT RequestSlot
+        {
+            RequestSlot(const TileLayer* layer, const IOOptions& io);
+            ~RequestSlot();
+
+            //! False when the layer stayed at its quota; the caller
+            //! should skip the fetch and schedule a retry.
+            bool acquired() const { return _layer != nullptr; }
+
+            RequestSlot(const RequestSlot&) = delete;
+            RequestSlot& operator=(const RequestSlot&) = delete;
+
+        private:
+            const TileLayer* _layer = nullptr;
+        };
+
         //! Data extents reported for this layer
         virtual const DataExtentList& dataExtents() const;
 
@@ -119,6 +168,15 @@ namespace ROCKY_NAMESPACE
         // Post-ctor
         void construct(const JSON&);
 
+        // extents recorded by dirty(GeoExtent), newest last; revisions at
+        // or below _dirtyHistoryFloor have no recorded extents.
+        mutable std::mutex _dirtyExtentsMutex;
+        std::vector<std::pair<Revision, GeoExtent>> _dirtyExtents;
+        Revision _dirtyHistoryFloor = 0;
+
+        // requests currently in flight (see RequestSlot)
+        mutable std::atomic<unsigned> _requestsInFlight = { 0u };
+
         // available data extents.
         DataExtentList _dataExtents;
         DataExtent _dataExtentsUnion;
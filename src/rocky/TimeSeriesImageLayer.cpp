@@ -0,0 +1,150 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "TimeSeriesImageLayer.h"
+#include "Context.h"
+#include "json.h"
+
+using namespace ROCKY_NAMESPACE;
+
+#undef LC
+#define LC "[TimeSeriesImage] "
+
+ROCKY_ADD_OBJECT_FACTORY(TimeSeriesImage,
+    [](const std::string& JSON, const IOOptions& io) {
+        return TimeSeriesImageLayer::create(JSON, io); })
+
+TimeSeriesImageLayer::TimeSeriesImageLayer() :
+    super()
+{
+    construct({}, {});
+}
+
+TimeSeriesImageLayer::TimeSeriesImageLayer(const std::string& JSON, const IOOptions& io) :
+    super(JSON, io)
+{
+    construct(JSON, io);
+}
+
+void
+TimeSeriesImageLayer::construct(const std::string& JSON, const IOOptions& io)
+{
+    setLayerTypeName("TimeSeriesImage");
+
+    const auto j = parse_json(JSON);
+    if (j.contains("frames") && j["frames"].is_array())
+    {
+        for (auto& frame_json : j["frames"])
+        {
+            std::string type;
+            get_to(frame_json, "type", type);
+
+            auto frame = ContextImpl::createObject<ImageLayer>(type, frame_json.dump(), io);
+            if (frame)
+                frames.emplace_back(frame);
+            else
+                Log()->warn(LC "skipping frame with unknown type \"{}\"", type);
+        }
+    }
+}
+
+JSON
+TimeSeriesImageLayer::to_json() const
+{
+    auto j = parse_json(super::to_json());
+
+    auto frames_json = json::array();
+    for (auto& frame : frames)
+    {
+        if (frame)
+            frames_json.push_back(json::parse(frame->to_json()));
+    }
+    if (!frames_json.empty())
+        j["frames"] = frames_json;
+
+    return j.dump();
+}
+
+Status
+TimeSeriesImageLayer::openImplementation(const IOOptions& io)
+{
+    auto result = super::openImplementation(io);
+    if (result.failed())
+        return result;
+
+    if (frames.empty())
+        return Status(Status::ConfigurationError, "TimeSeriesImage layer with no frames");
+
+    for (auto& frame : frames)
+    {
+        auto frame_status = frame->open(io);
+        if (frame_status.failed())
+            return frame_status;
+    }
+
+    // all frames share the first one's profile:
+    if (!profile.valid())
+        profile = frames.front()->profile;
+
+    return StatusOK;
+}
+
+void
+TimeSeriesImageLayer::closeImplementation()
+{
+    for (auto& frame : frames)
+        frame->close();
+
+    super::closeImplementation();
+}
+
+Result<GeoImage>
+TimeSeriesImageLayer::createImageImplementation(const TileKey& key, const IOOptions& io) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(!frames.empty(), Status(Status::ConfigurationError));
+
+    // Pack one slice per frame into a single stacked raster; the render
+    // engine uploads it as a texture array in one shot. A frame with no
+    // data at this key leaves its slice transparent, and a frame whose
+    // tile size differs from the first one's resamples into place.
+    std::shared_ptr<Image> output;
+    bool anyData = false;
+
+    for (std::size_t f = 0; f < frames.size(); ++f)
+    {
+        auto r = frames[f]->createImage(key, io);
+        if (r.status.failed() || !r->valid())
+            continue;
+
+        auto src = r->image();
+
+        if (!output)
+        {
+            output = Image::create(
+                Image::R8G8B8A8_UNORM,
+                src->width(), src->height(), (unsigned)frames.size());
+            output->fill(glm::fvec4(0.0f, 0.0f, 0.0f, 0.0f));
+        }
+
+        glm::fvec4 pixel;
+        for (unsigned t = 0; t < output->height(); ++t)
+        {
+            float v = ((float)t + 0.5f) / (float)output->height();
+            for (unsigned s = 0; s < output->width(); ++s)
+            {
+                float u = ((float)s + 0.5f) / (float)output->width();
+                src->read_bilinear(pixel, u, v);
+                output->write(pixel, s, t, (unsigned)f);
+            }
+        }
+
+        anyData = true;
+    }
+
+    if (!anyData)
+        return Status(Status::ResourceUnavailable);
+
+    return GeoImage(output, key.extent());
+}
@@ -0,0 +1,184 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "Trace.h"
+#include "Log.h"
+#include "weejobs.h"
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    struct Event
+    {
+        std::string name;
+        std::string detail;
+        char phase;            // 'X', 'b', 'e'
+        std::uint32_t tid;
+        std::int64_t ts;       // microseconds from capture start
+        std::int64_t dur;      // 'X' only
+        std::uint64_t id;      // async spans only
+    };
+
+    std::atomic_bool _active = { false };
+    std::mutex _mutex;
+    std::vector<Event> _events;
+    std::string _filename;
+    std::chrono::steady_clock::time_point _epoch;
+
+    std::uint32_t thisThreadID()
+    {
+        return (std::uint32_t)std::hash<std::thread::id>{}(std::this_thread::get_id());
+    }
+
+    std::int64_t micros(std::chrono::steady_clock::time_point t)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - _epoch).count();
+    }
+
+    void record(Event&& e)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_active)
+            _events.emplace_back(std::move(e));
+    }
+
+    std::string escaped(const std::string& in)
+    {
+        std::string out;
+        out.reserve(in.size());
+        for (char c : in)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\', out += c;
+            else if ((unsigned char)c >= 0x20)
+                out += c;
+        }
+        return out;
+    }
+}
+
+bool
+util::trace::active()
+{
+    return _active.load(std::memory_order_relaxed);
+}
+
+bool
+util::trace::start(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_active)
+        return false;
+
+    _filename = filename;
+    _events.clear();
+    _events.reserve(64 * 1024);
+    _epoch = std::chrono::steady_clock::now();
+    _active = true;
+
+    // Every job the job system executes becomes a duration event. Install
+    // the hook exactly once and leave it in place - it no-ops when no
+    // capture is active - since swapping it out while worker threads are
+    // calling it would race.
+    static std::once_flag hooked;
+    std::call_once(hooked, []()
+        {
+            jobs::set_job_trace_function([](const char* name, std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+                {
+                    complete("job", t0, t1, name);
+                });
+        });
+
+    return true;
+}
+
+void
+util::trace::stop()
+{
+    std::vector<Event> events;
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_active)
+            return;
+        _active = false;
+        events.swap(_events);
+        filename.swap(_filename);
+    }
+
+    std::ofstream out(filename);
+    if (!out)
+    {
+        Log()->warn("Failed to open trace file " + filename);
+        return;
+    }
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (auto& e : events)
+    {
+        if (!first) out << ",\n";
+        first = false;
+
+        out << "{\"name\":\"" << escaped(e.name)
+            << "\",\"ph\":\"" << e.phase
+            << "\",\"pid\":1,\"tid\":" << e.tid
+            << ",\"ts\":" << e.ts;
+
+        if (e.phase == 'X')
+            out << ",\"dur\":" << e.dur;
+
+        if (e.phase == 'b' || e.phase == 'e')
+            out << ",\"cat\":\"rocky\",\"id\":" << e.id;
+
+        if (!e.detail.empty())
+            out << ",\"args\":{\"detail\":\"" << escaped(e.detail) << "\"}";
+
+        out << "}";
+    }
+    out << "]}";
+
+    Log()->info("Wrote " + std::to_string(events.size()) + " trace events to " + filename);
+}
+
+void
+util::trace::complete(const char* name, std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point end, const std::string& detail)
+{
+    if (!active())
+        return;
+
+    record(Event{ name, detail, 'X', thisThreadID(), micros(begin),
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count(), 0 });
+}
+
+void
+util::trace::asyncBegin(const char* name, std::uint64_t id, const std::string& detail)
+{
+    if (!active())
+        return;
+
+    record(Event{ name, detail, 'b', thisThreadID(),
+        micros(std::chrono::steady_clock::now()), 0, id });
+}
+
+void
+util::trace::asyncEnd(const char* name, std::uint64_t id)
+{
+    if (!active())
+        return;
+
+    record(Event{ name, {}, 'e', thisThreadID(),
+        micros(std::chrono::steady_clock::now()), 0, id });
+}
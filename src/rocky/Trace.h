@@ -0,0 +1,89 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/Common.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace ROCKY_NAMESPACE
+{
+    namespace util
+    {
+        /**
+        * Opt-in trace-event capture in the Chrome trace format, viewable in
+        * chrome://tracing or Perfetto. While a capture is active, the job
+        * system emits a duration event for every job it executes, and
+        * instrumented call sites (URI reads, terrain tile load/merge) add
+        * duration and async-span events - so one capture correlates job
+        * execution, pager state transitions, and the frame timeline.
+        *
+        * When no capture is active the instrumentation is a single relaxed
+        * atomic load per call site.
+        */
+        namespace trace
+        {
+            //! Begins a capture, buffering events in memory until stop()
+            //! writes them to the given file. Returns false if a capture
+            //! is already in progress.
+            extern ROCKY_EXPORT bool start(const std::string& filename);
+
+            //! Ends the capture and writes the buffered events as
+            //! chrome://tracing-compatible JSON.
+            extern ROCKY_EXPORT void stop();
+
+            //! Whether a capture is in progress. Cheap; call sites use this
+            //! to skip all work when tracing is off.
+            extern ROCKY_EXPORT bool active();
+
+            //! Records a complete duration event on the calling thread.
+            //! "detail" (optional) lands in the event's args, keeping the
+            //! name table small when the detail is high-cardinality (URLs,
+            //! tile keys).
+            extern ROCKY_EXPORT void complete(
+                const char* name,
+                std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end,
+                const std::string& detail = {});
+
+            //! Begins/ends an async span. Spans with the same name and id
+            //! connect across threads, tracking a logical operation (like
+            //! one tile's journey from request to merge) through the system.
+            extern ROCKY_EXPORT void asyncBegin(const char* name, std::uint64_t id, const std::string& detail = {});
+            extern ROCKY_EXPORT void asyncEnd(const char* name, std::uint64_t id);
+
+            //! RAII duration event for the enclosing scope.
+            struct Scoped
+            {
+                Scoped(const char* name, const std::string& detail = {}) :
+                    _name(name)
+                {
+                    if (active())
+                    {
+                        _detail = detail;
+                        _begin = std::chrono::steady_clock::now();
+                        _armed = true;
+                    }
+                }
+
+                ~Scoped()
+                {
+                    if (_armed)
+                        complete(_name, _begin, std::chrono::steady_clock::now(), _detail);
+                }
+
+                Scoped(const Scoped&) = delete;
+                Scoped& operator=(const Scoped&) = delete;
+
+            private:
+                const char* _name;
+                std::string _detail;
+                std::chrono::steady_clock::time_point _begin;
+                bool _armed = false;
+            };
+        }
+    }
+}
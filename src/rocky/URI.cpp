@@ -7,6 +7,9 @@
 
 #include "URI.h"
 #include "Utils.h"
+#include "IOReplay.h"
+#include "Trace.h"
+#include "PipelineMetrics.h"
 #include "Context.h"
 #include "Version.h"
 #include "json.h"
@@ -17,6 +20,14 @@
 #include <cstdlib>
 #include <random>
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <atomic>
+#include <iomanip>
+#include <filesystem>
 
 #ifdef ROCKY_HAS_HTTPLIB
     #ifdef ROCKY_HAS_OPENSSL
@@ -69,6 +80,8 @@ URI::inferContentType(const std::string& buffer)
     //        4D 4D 00 2A
     // .bmp:  BM
     // .webp: RIFF ???? WEBP
+    // .ktx:  AB 4B 54 58 20 31 31 BB ( "«KTX 11»" )
+    // .ktx2: AB 4B 54 58 20 32 30 BB ( "«KTX 20»" )
     // .ico   00 00 01 00
     //        00 00 02 00 ( cursor files )
     const char* data = buffer.c_str();
@@ -96,6 +109,11 @@ URI::inferContentType(const std::string& buffer)
 
     case 'R':
         return (!strncmp((const char*)data, "RIFF", 4)) ? "image/webp" : "";
+
+    case '\xAB':
+        return
+            (!strncmp((const char*)data, "\xAB\x4B\x54\x58\x20\x32\x30\xBB", 8)) ? "image/ktx2" :
+            (!strncmp((const char*)data, "\xAB\x4B\x54\x58\x20\x31\x31\xBB", 8)) ? "image/ktx" : "";
     }
 
 
@@ -106,6 +124,19 @@ namespace
 {
     static bool httpDebug = !ROCKY_NAMESPACE::util::getEnvVar("HTTP_DEBUG").empty();
 
+    // Status returned by a fetch that was cut short by its caller's
+    // cancellation. When such a result comes from the leader of a coalesced
+    // request, followers whose own io is still live recognize it and retry
+    // instead of adopting the aborted result.
+    const Status fetchCanceled(Status::ResourceUnavailable, "Canceled");
+
+    IOResult<Content> canceledResult()
+    {
+        IOResult<Content> r(fetchCanceled);
+        r.ioCode = IOResult<Content>::RESULT_CANCELED;
+        return r;
+    }
+
     std::string inferContentTypeFromFileExtension(const std::string& filename)
     {
         ROCKY_TODO("Map the extension to a known mime type");
@@ -146,6 +177,167 @@ namespace
         return {};
     }
 
+    // On-disk HTTP cache, enabled by pointing the ROCKY_HTTP_CACHE_DIR
+    // environment variable at a writable directory. Each response is stored
+    // under a hash of its URI as a JSON metadata sidecar (content type,
+    // validators, freshness) plus the raw body. Entries still fresh per the
+    // server's Cache-Control directives are served without any network
+    // traffic; stale entries contribute If-None-Match / If-Modified-Since
+    // validators to the request and are renewed in place when the server
+    // answers 304 Not Modified.
+    class HTTPDiskCache
+    {
+    public:
+        struct Entry
+        {
+            bool valid = false;
+            std::string url;
+            std::string contentType;
+            std::string etag;
+            std::string lastModified;
+            std::int64_t freshUntil = 0; // unix seconds
+            std::string dataPath;
+
+            //! may be served without revalidation
+            bool fresh() const
+            {
+                return valid && now() < freshUntil;
+            }
+        };
+
+        HTTPDiskCache()
+        {
+            _dir = util::getEnvVar("HTTP_CACHE_DIR");
+        }
+
+        bool enabled() const
+        {
+            return !_dir.empty();
+        }
+
+        //! looks up the cache entry for a URL; the body stays on disk
+        //! until load() is called.
+        Entry fetch(const std::string& url) const
+        {
+            Entry entry;
+            auto base = pathFor(url);
+
+            std::ifstream in(base + ".meta", std::ios_base::in);
+            if (!in)
+                return entry;
+
+            std::stringstream buf;
+            buf << in.rdbuf();
+            auto j = parse_json(buf.str());
+
+            // reject corrupt metadata and hash collisions:
+            if (j.status.failed() || j.value("url", "") != url)
+                return entry;
+
+            entry.url = url;
+            entry.contentType = j.value("content_type", "");
+            entry.etag = j.value("etag", "");
+            entry.lastModified = j.value("last_modified", "");
+            entry.freshUntil = j.value("fresh_until", (std::int64_t)0);
+            entry.dataPath = base + ".data";
+            entry.valid = true;
+            return entry;
+        }
+
+        //! loads a cached body from disk.
+        std::string load(const Entry& entry) const
+        {
+            std::ifstream in(entry.dataPath, std::ios_base::in | std::ios_base::binary);
+            std::stringstream buf;
+            buf << in.rdbuf();
+            return buf.str();
+        }
+
+        //! stores a freshly fetched response, honoring Cache-Control.
+        void store(const std::string& url, const HTTPResponse& response, const Content& content) const
+        {
+            auto cacheControl = findHeader(response.headers, "Cache-Control");
+            if (cacheControl.find("no-store") != std::string::npos)
+                return;
+
+            Entry entry;
+            entry.url = url;
+            entry.contentType = content.contentType;
+            entry.etag = findHeader(response.headers, "ETag");
+            entry.lastModified = findHeader(response.headers, "Last-Modified");
+            entry.freshUntil = now() + maxAge(cacheControl);
+            write(entry, &content.data);
+        }
+
+        //! renews a revalidated entry's freshness after a 304.
+        void refresh(Entry entry, const HTTPResponse& response) const
+        {
+            auto etag = findHeader(response.headers, "ETag");
+            if (!etag.empty())
+                entry.etag = etag;
+
+            entry.freshUntil = now() + maxAge(findHeader(response.headers, "Cache-Control"));
+            write(entry, nullptr);
+        }
+
+        static std::int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        std::string _dir;
+
+        //! seconds a response may be served without revalidation.
+        static std::int64_t maxAge(const std::string& cacheControl)
+        {
+            auto pos = cacheControl.find("max-age=");
+            if (pos != std::string::npos)
+                return std::atoll(cacheControl.c_str() + pos + 8);
+            return 0;
+        }
+
+        std::string pathFor(const std::string& url) const
+        {
+            std::stringstream buf;
+            buf << std::hex << std::setfill('0') << std::setw(16) << std::hash<std::string>{}(url);
+            auto name = buf.str();
+
+            // spread entries over 256 subfolders to keep directories small:
+            auto folder = std::filesystem::path(_dir) / name.substr(0, 2);
+            return (folder / name).generic_string();
+        }
+
+        void write(const Entry& entry, const std::string* body) const
+        {
+            auto base = pathFor(entry.url);
+
+            std::error_code ec;
+            std::filesystem::create_directories(std::filesystem::path(base).parent_path(), ec);
+            if (ec)
+                return;
+
+            if (body)
+            {
+                std::ofstream out(base + ".data", std::ios_base::out | std::ios_base::binary);
+                out.write(body->data(), body->size());
+            }
+
+            json j = json::object();
+            j["url"] = entry.url;
+            j["content_type"] = entry.contentType;
+            j["etag"] = entry.etag;
+            j["last_modified"] = entry.lastModified;
+            j["fresh_until"] = entry.freshUntil;
+
+            std::ofstream meta(base + ".meta", std::ios_base::out);
+            meta << j.dump();
+        }
+    };
+
+    static HTTPDiskCache httpDiskCache;
+
     bool split_url(
         const std::string& url,
         std::string& proto_host_port,
@@ -181,13 +373,54 @@ namespace
         return true;
     }
 
+    // Payloads compressed at rest (as opposed to transfer-encoded, which the
+    // HTTP client already handles) arrive as opaque binary. Sniff the leading
+    // magic bytes and set up a streaming decoder so decompression can overlap
+    // the download.
+    std::unique_ptr<util::StreamingDecompressor> makeStreamingDecompressor(const char* data, std::size_t len)
+    {
+#ifdef ROCKY_HAS_ZLIB
+        if (len >= 2 &&
+            (unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b) // gzip
+        {
+            return std::make_unique<util::StreamingZLibDecompressor>();
+        }
+#endif
+#ifdef ROCKY_HAS_ZSTD
+        if (len >= 4 &&
+            (unsigned char)data[0] == 0x28 && (unsigned char)data[1] == 0xb5 &&
+            (unsigned char)data[2] == 0x2f && (unsigned char)data[3] == 0xfd) // zstd
+        {
+            return std::make_unique<util::StreamingZstdDecompressor>();
+        }
+#endif
+        return nullptr;
+    }
+
 #ifdef ROCKY_HAS_CURL
 
     struct stream_object
     {
         void write(const char* ptr, size_t realsize)
         {
-            stream.write(ptr, realsize);
+            // the first chunk tells us whether the payload is compressed;
+            // if so, every chunk decompresses as it arrives off the wire:
+            if (first)
+            {
+                first = false;
+                decoder = makeStreamingDecompressor(ptr, realsize);
+            }
+
+            if (decoder)
+            {
+                std::string decoded;
+                decoder->decode(ptr, realsize, decoded);
+                stream.write(decoded.data(), decoded.size());
+            }
+            else
+            {
+                stream.write(ptr, realsize);
+            }
         }
 
         void writeHeader(const char* ptr, size_t realsize)
@@ -204,6 +437,8 @@ namespace
 
         std::stringstream stream;
         std::vector<KeyValuePair> headers;
+        bool first = true;
+        std::unique_ptr<util::StreamingDecompressor> decoder;
     };
 
     static size_t stream_object_write_function(void* ptr, size_t size, size_t nmemb, void* data)
@@ -223,18 +458,17 @@ namespace
     }
 
 
-    IOResult<HTTPResponse> http_get_curl(const HTTPRequest& request, const IOOptions& io)
+    // One-time configuration common to every easy handle we create;
+    // per-request state (URL, headers, write targets) is set by the caller.
+    void configure_curl_handle(CURL* handle)
     {
-        HTTPResponse response;
-
-        auto handle = curl_easy_init();
-
         curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, stream_object_write_function);
         curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, stream_object_header_function);
         curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, (void*)1);
         curl_easy_setopt(handle, CURLOPT_MAXREDIRS, (void*)5);
         curl_easy_setopt(handle, CURLOPT_FILETIME, true);
         curl_easy_setopt(handle, CURLOPT_USERAGENT, "rocky/" ROCKY_VERSION_STRING);
+        curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
 
         // Enable automatic CURL decompression of known types.
         // An empty string will automatically add all supported encoding types that are built into CURL.
@@ -245,8 +479,62 @@ namespace
         // where the peer certificate cannot be verified.
         curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, (void*)0);
 
+#ifdef CURL_HTTP_VERSION_2TLS
+        // negotiate HTTP/2 over TLS when the server offers it, and wait
+        // for an existing connection to multiplex on rather than opening
+        // a new one for each concurrent request:
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    #ifdef CURLOPT_PIPEWAIT
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    #endif
+#endif
+
         //todo: authentication
         //todo: proxy server
+    }
+
+    // Cache of configured CURL easy handles, one per scheme://host:port.
+    // Reusing a handle reuses its connection cache, so back-to-back tile
+    // fetches against the same server skip the TCP+TLS setup that would
+    // otherwise dominate small-tile latency, and can share an HTTP/2
+    // connection where the server supports it. The cache is thread-local
+    // so the long-lived loader threads never contend on a lock; handles
+    // are cleaned up when the owning thread exits.
+    struct CurlHandleCache
+    {
+        std::unordered_map<std::string, CURL*> handles;
+
+        CURL* acquire(const std::string& proto_host_port)
+        {
+            auto iter = handles.find(proto_host_port);
+            if (iter != handles.end())
+                return iter->second;
+
+            auto handle = curl_easy_init();
+            configure_curl_handle(handle);
+
+            handles[proto_host_port] = handle;
+            return handle;
+        }
+
+        ~CurlHandleCache()
+        {
+            for (auto& iter : handles)
+                curl_easy_cleanup(iter.second);
+        }
+    };
+
+    thread_local CurlHandleCache t_curlHandles;
+
+    IOResult<HTTPResponse> http_get_curl(const HTTPRequest& request, const IOOptions& io)
+    {
+        HTTPResponse response;
+
+        std::string proto_host_port, path, query_text;
+        if (!split_url(request.url, proto_host_port, path, query_text))
+            return Status(Status::ConfigurationError);
+
+        auto handle = t_curlHandles.acquire(proto_host_port);
 
         // request headers:
         struct curl_slist* headers = nullptr;
@@ -301,7 +589,10 @@ namespace
             break;
         }
 
-        curl_easy_cleanup(handle);
+        // clear the per-request header list; the handle itself stays in the
+        // thread-local cache so its connection survives for the next fetch.
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, nullptr);
+        curl_slist_free_all(headers);
 
         if (result == CURLE_OK)
         {
@@ -317,7 +608,7 @@ namespace
                 Log()->info(LC "({} {:3d}ms {:6}b {}) HTTP GET {}", response.status, (int)dur_ms, response.data.size(), ct, request.url);
             }
 
-            if (response.status != 200)
+            if (response.status != 200 && response.status != 304)
             {
                 if (response.status == 404) // NOT FOUND (permanent)
                 {
@@ -336,9 +627,277 @@ namespace
 
         return response;
     }
+
+    // Drives many concurrent HTTP transfers through the curl multi interface
+    // on a single event-loop thread. Callers enqueue a request and get back a
+    // future that resolves when the transfer completes, so in-flight network
+    // I/O never occupies a job-pool worker - hundreds of concurrent fetches
+    // cost one thread - and all transfers to the same host can multiplex over
+    // a shared HTTP/2 connection. Abandoning the future cancels the transfer.
+    class CurlEventLoop
+    {
+    public:
+        jobs::future<IOResult<HTTPResponse>> get(const HTTPRequest& request, unsigned maxAttempts)
+        {
+            auto xfer = std::make_unique<Transfer>();
+            xfer->url = request.url;
+            xfer->maxAttempts = std::max(1u, maxAttempts);
+
+            xfer->handle = curl_easy_init();
+            configure_curl_handle(xfer->handle);
+
+            for (auto& h : request.headers)
+            {
+                std::string header = h.name + ": " + h.value;
+                xfer->requestHeaders = curl_slist_append(xfer->requestHeaders, header.c_str());
+            }
+            curl_easy_setopt(xfer->handle, CURLOPT_HTTPHEADER, xfer->requestHeaders);
+            curl_easy_setopt(xfer->handle, CURLOPT_URL, xfer->url.c_str());
+            curl_easy_setopt(xfer->handle, CURLOPT_WRITEDATA, (void*)&xfer->so);
+            curl_easy_setopt(xfer->handle, CURLOPT_HEADERDATA, (void*)&xfer->so);
+            curl_easy_setopt(xfer->handle, CURLOPT_ERRORBUFFER, (void*)xfer->errorBuf);
+
+            auto result = xfer->promise;
+
+            std::scoped_lock lock(_mutex);
+            _pending.emplace_back(std::move(xfer));
+            if (!_thread.joinable())
+                _thread = std::thread([this]() { run(); });
+
+            return result;
+        }
+
+        ~CurlEventLoop()
+        {
+            _running = false;
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+    private:
+        struct Transfer
+        {
+            CURL* handle = nullptr;
+            curl_slist* requestHeaders = nullptr;
+            stream_object so;
+            char errorBuf[CURL_ERROR_SIZE] = { 0 };
+            std::string url;
+            unsigned attempts = 0;
+            unsigned maxAttempts = 1;
+            std::chrono::steady_clock::time_point notBefore;
+            jobs::future<IOResult<HTTPResponse>> promise;
+        };
+
+        void discard(CURLM* multi, std::unique_ptr<Transfer> xfer)
+        {
+            curl_multi_remove_handle(multi, xfer->handle);
+            curl_slist_free_all(xfer->requestHeaders);
+            curl_easy_cleanup(xfer->handle);
+        }
+
+        void resolve(Transfer* xfer, CURLcode result)
+        {
+            if (result != CURLE_OK)
+            {
+                xfer->promise.resolve(Status(Status::ServiceUnavailable, xfer->errorBuf));
+                return;
+            }
+
+            HTTPResponse response;
+            long status = 0;
+            curl_easy_getinfo(xfer->handle, CURLINFO_RESPONSE_CODE, &status);
+            response.status = (int)status;
+            response.data = xfer->so.stream.str();
+            response.headers = xfer->so.headers;
+
+            if (httpDebug)
+            {
+                auto cti = findHeader(response.headers, "Content-Type");
+                auto ct = cti.empty() ? "unknown" : cti;
+                Log()->info(LC "({} {:6}b {}) HTTP GET (async) {}", response.status, response.data.size(), ct, xfer->url);
+            }
+
+            if (response.status != 200 && response.status != 304)
+            {
+                if (response.status == 404) // NOT FOUND (permanent)
+                {
+                    xfer->promise.resolve(Status(Status::ResourceUnavailable, xfer->url));
+                }
+                else
+                {
+                    xfer->promise.resolve(Status(Status::ResourceUnavailable, std::to_string(response.status)));
+                }
+                return;
+            }
+
+            xfer->promise.resolve(response);
+        }
+
+        void run()
+        {
+            auto multi = curl_multi_init();
+            std::unordered_map<CURL*, std::unique_ptr<Transfer>> active;
+            std::vector<std::unique_ptr<Transfer>> waiting; // retries backing off
+
+            std::random_device device;
+            std::default_random_engine engine(device());
+            std::uniform_real_distribution distribution;
+
+            while (_running)
+            {
+                // pick up newly queued requests:
+                {
+                    std::scoped_lock lock(_mutex);
+                    for (auto& xfer : _pending)
+                    {
+                        curl_multi_add_handle(multi, xfer->handle);
+                        active[xfer->handle] = std::move(xfer);
+                    }
+                    _pending.clear();
+                }
+
+                // re-submit transfers whose retry delay has elapsed:
+                auto now = std::chrono::steady_clock::now();
+                for (auto iter = waiting.begin(); iter != waiting.end(); )
+                {
+                    if (now >= (*iter)->notBefore)
+                    {
+                        auto xfer = std::move(*iter);
+                        iter = waiting.erase(iter);
+                        curl_multi_add_handle(multi, xfer->handle);
+                        active[xfer->handle] = std::move(xfer);
+                    }
+                    else ++iter;
+                }
+
+                int in_flight = 0;
+                curl_multi_perform(multi, &in_flight);
+
+                // wait for socket activity, timing out quickly enough that
+                // newly queued requests and abandoned futures get serviced:
+                int numfds = 0;
+                curl_multi_wait(multi, nullptr, 0, 10, &numfds);
+
+                // process completed transfers:
+                int msgs_left = 0;
+                CURLMsg* msg = nullptr;
+                while ((msg = curl_multi_info_read(multi, &msgs_left)) != nullptr)
+                {
+                    if (msg->msg != CURLMSG_DONE)
+                        continue;
+
+                    auto iter = active.find(msg->easy_handle);
+                    if (iter == active.end())
+                        continue;
+
+                    auto xfer = std::move(iter->second);
+                    active.erase(iter);
+                    curl_multi_remove_handle(multi, xfer->handle);
+
+                    auto code = msg->data.result;
+                    long status = 0;
+                    if (code == CURLE_OK)
+                        curl_easy_getinfo(xfer->handle, CURLINFO_RESPONSE_CODE, &status);
+
+                    bool retryable =
+                        code == CURLE_COULDNT_CONNECT ||
+                        code == CURLE_OPERATION_TIMEDOUT ||
+                        (code == CURLE_OK && status == 429); // TOO MANY REQUESTS (rate limiting)
+
+                    if (retryable && xfer->attempts + 1 < xfer->maxAttempts)
+                    {
+                        // same backoff-with-jitter as the synchronous path:
+                        ++xfer->attempts;
+                        auto delay = 1000ms * std::pow(2, xfer->attempts + distribution(engine));
+                        xfer->notBefore = std::chrono::steady_clock::now() +
+                            std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay);
+                        xfer->so = {}; // discard any partial response
+                        waiting.emplace_back(std::move(xfer));
+                    }
+                    else
+                    {
+                        resolve(xfer.get(), code);
+                        curl_slist_free_all(xfer->requestHeaders);
+                        curl_easy_cleanup(xfer->handle);
+                    }
+                }
+
+                // drop transfers whose futures were abandoned by the caller:
+                for (auto iter = active.begin(); iter != active.end(); )
+                {
+                    if (iter->second->promise.canceled())
+                    {
+                        auto xfer = std::move(iter->second);
+                        iter = active.erase(iter);
+                        discard(multi, std::move(xfer));
+                    }
+                    else ++iter;
+                }
+
+                for (auto iter = waiting.begin(); iter != waiting.end(); )
+                {
+                    if ((*iter)->promise.canceled())
+                    {
+                        curl_slist_free_all((*iter)->requestHeaders);
+                        curl_easy_cleanup((*iter)->handle);
+                        iter = waiting.erase(iter);
+                    }
+                    else ++iter;
+                }
+            }
+
+            for (auto& iter : active)
+                discard(multi, std::move(iter.second));
+
+            for (auto& xfer : waiting)
+            {
+                curl_slist_free_all(xfer->requestHeaders);
+                curl_easy_cleanup(xfer->handle);
+            }
+
+            curl_multi_cleanup(multi);
+        }
+
+        std::mutex _mutex;
+        std::vector<std::unique_ptr<Transfer>> _pending;
+        std::thread _thread;
+        std::atomic_bool _running = { true };
+    };
+
+    CurlEventLoop& curlEventLoop()
+    {
+        static CurlEventLoop loop;
+        return loop;
+    }
 #endif
 
 #ifdef ROCKY_HAS_HTTPLIB
+    // Cache of keep-alive clients, one per scheme://host:port, so consecutive
+    // tile fetches against the same server reuse an open connection instead of
+    // paying TCP+TLS setup per request. httplib clients are not safe to share
+    // across threads, so the cache is thread-local; the long-lived loader
+    // threads each keep their own connections open.
+    httplib::Client& acquireHttplibClient(const std::string& proto_host_port)
+    {
+        thread_local std::unordered_map<std::string, std::unique_ptr<httplib::Client>> clients;
+
+        auto& client = clients[proto_host_port];
+        if (!client)
+        {
+            client = std::make_unique<httplib::Client>(proto_host_port);
+
+            // reuse the connection across requests
+            client->set_keep_alive(true);
+
+            // follow redirects
+            client->set_follow_location(true);
+
+            // disable cert verification
+            client->enable_server_certificate_verification(false);
+        }
+        return *client;
+    }
+
     IOResult<HTTPResponse> http_get_httplib(const HTTPRequest& request, const IOOptions& io)
     {
         httplib::Headers headers;
@@ -368,13 +927,7 @@ namespace
 
         try
         {
-            httplib::Client client(proto_host_port);
-
-            // follow redirects
-            client.set_follow_location(true);
-
-            // disable cert verification
-            client.enable_server_certificate_verification(false);
+            auto& client = acquireHttplibClient(proto_host_port);
 
             unsigned max_attempts = std::max(1u, io.maxNetworkAttempts);
 
@@ -386,8 +939,26 @@ namespace
             for(;;)
             {
                 if (io.canceled())
-                    return StatusOK;
-                
+                    return fetchCanceled;
+
+                // cap the socket timeouts at the operation's remaining
+                // time budget so a stalled server cannot hold this worker
+                // past the deadline. The clients are cached per thread, so
+                // restore the compiled-in defaults for unbudgeted requests.
+                if (io.deadline.has_value())
+                {
+                    auto remaining = std::max(io.timeRemaining(std::chrono::milliseconds(0)), std::chrono::milliseconds(1));
+                    client.set_connection_timeout(remaining);
+                    client.set_read_timeout(remaining);
+                    client.set_write_timeout(remaining);
+                }
+                else
+                {
+                    client.set_connection_timeout(CPPHTTPLIB_CONNECTION_TIMEOUT_SECOND, CPPHTTPLIB_CONNECTION_TIMEOUT_USECOND);
+                    client.set_read_timeout(CPPHTTPLIB_READ_TIMEOUT_SECOND, CPPHTTPLIB_READ_TIMEOUT_USECOND);
+                    client.set_write_timeout(CPPHTTPLIB_WRITE_TIMEOUT_SECOND, CPPHTTPLIB_WRITE_TIMEOUT_USECOND);
+                }
+
                 auto t0 = std::chrono::steady_clock::now();
                 auto res = client.Get(path, params, headers);
                 auto t1 = std::chrono::steady_clock::now();
@@ -423,7 +994,7 @@ namespace
                             return Status(Status::ResourceUnavailable, httplib::status_message(res->status));
                         }
                     }
-                    else if (res->status != 200)
+                    else if (res->status != 200 && res->status != 304)
                     {
                         return Status(Status::GeneralError, httplib::status_message(res->status));
                     }
@@ -435,6 +1006,18 @@ namespace
 
                     response.data = std::move(res->body);
 
+                    // payloads compressed at rest decode here. httplib
+                    // buffers the whole body, so there is no download
+                    // overlap as with the curl backend, but the content
+                    // still arrives decompressed:
+                    auto decoder = makeStreamingDecompressor(response.data.data(), response.data.size());
+                    if (decoder)
+                    {
+                        std::string decoded;
+                        if (decoder->decode(response.data.data(), response.data.size(), decoded))
+                            response.data = std::move(decoded);
+                    }
+
                     break;
                 }
 
@@ -477,6 +1060,44 @@ namespace
         return Status(Status::ServiceUnavailable, "HTTP not supported without curl or httplib");
 #endif
     }
+
+    // Issues an HTTP GET without blocking the calling thread. With curl we
+    // hand the request to the multi-interface event loop; otherwise we fall
+    // back to running the blocking backend on a small dedicated I/O pool so
+    // that at least the caller's pool stays free for CPU-bound work.
+    jobs::future<IOResult<HTTPResponse>> http_get_async(const HTTPRequest& request, const IOOptions& io)
+    {
+#if defined(ROCKY_HAS_CURL)
+        return curlEventLoop().get(request, io.maxNetworkAttempts);
+#else
+        auto task = [request, io](jobs::cancelable&)
+            {
+                return http_get(request, io);
+            };
+        return jobs::dispatch(task, jobs::context{ "rocky::http", jobs::get_pool("rocky.io", 4) });
+#endif
+    }
+
+    // converts an HTTP response body into a Content object, inferring the
+    // content type when the server doesn't provide one.
+    Content contentFromHTTPResponse(const std::string& url, const HTTPResponse& response)
+    {
+        std::string contentType = findHeader(response.headers, "Content-Type");
+
+        if (contentType.empty())
+        {
+            contentType = URI::inferContentType(response.data);
+        }
+
+        if (contentType.empty())
+        {
+            auto p = url.find_first_of('?');
+            auto url_path = p != std::string::npos ? url.substr(0, p) : url;
+            contentType = inferContentTypeFromFileExtension(url_path);
+        }
+
+        return Content{ contentType, response.data };
+    }
 }
 
 //------------------------------------------------------------------------
@@ -508,7 +1129,8 @@ URI::URI(const URI& rhs) :
     _fullURI(rhs._fullURI),
     _r0(rhs._r0),
     _r1(rhs._r1),
-    _context(rhs._context)
+    _context(rhs._context),
+    _hash(rhs._hash)
 {
     //nop
 }
@@ -519,6 +1141,9 @@ URI::URI(const std::string& location)
     _fullURI = location;
 
     findRotation();
+
+    // hash once; cache lookups and shard selection reuse it per request.
+    _hash = std::hash<std::string>{}(_fullURI);
 }
 
 URI::URI(const std::string& location, const URIContext& context)
@@ -574,6 +1199,9 @@ URI::set(const std::string& location, const URIContext& context)
     }
 
     findRotation();
+
+    // hash once; cache lookups and shard selection reuse it per request.
+    _hash = std::hash<std::string>{}(_fullURI);
 }
 
 void
@@ -596,19 +1224,76 @@ URI::findRotation()
 
 IOResult<Content>
 URI::read(const IOOptions& io) const
+{
+    util::trace::Scoped span("URI::read", full());
+    util::PipelineMetrics::Scoped pm(util::PipelineMetrics::FETCH);
+
+    // replay mode: serve the archived response on its recorded timing,
+    // bypassing the live pipeline so every run sees identical inputs.
+    if (util::ioreplay::replaying())
+    {
+        return util::ioreplay::lookup(full());
+    }
+
+    auto began = std::chrono::steady_clock::now();
+
+    // if an identical request is already in flight on another thread,
+    // attach to it and share its result instead of duplicating the fetch.
+    // A leader whose own caller cancels mid-fetch resolves the entry with
+    // the fetchCanceled sentinel rather than whatever partial result the
+    // aborted fetch produced; followers that are still live re-join, and
+    // one of them becomes the new leader and performs the fetch itself.
+    if (io.uriRequests)
+    {
+        for (;;)
+        {
+            auto ticket = io.uriRequests->join(full());
+
+            if (ticket.leader)
+            {
+                auto result = readImplementation(io);
+
+                if (io.canceled() || result.status == fetchCanceled)
+                {
+                    auto canceled = canceledResult();
+                    io.uriRequests->resolve(full(), canceled);
+                    return canceled;
+                }
+
+                io.uriRequests->resolve(full(), result);
+                util::ioreplay::capture(full(), result, std::chrono::steady_clock::now() - began);
+                return result;
+            }
+
+            auto& result = ticket.result.join(io);
+            if (!ticket.result.available() || io.canceled())
+                return canceledResult();
+            if (result.status != fetchCanceled)
+                return result;
+            // the leader bailed out before completing the fetch; try again.
+        }
+    }
+
+    auto result = readImplementation(io);
+    util::ioreplay::capture(full(), result, std::chrono::steady_clock::now() - began);
+    return result;
+}
+
+IOResult<Content>
+URI::readImplementation(const IOOptions& io) const
 {
     // protect against multiple threads trying to read the same URI at the same time
     util::ScopedGate<std::string> gate(io.uriGate, full());
 
     if (io.services.contentCache)
     {
-        auto cached = io.services.contentCache->get(full());
+        auto cached = io.services.contentCache->get(*this);
         if (cached.status.ok())
         {
             if (httpDebug)
             {
                 Log()->debug(LC "Cache hit, ratio = "
-                    + std::to_string(100.0f * (float)io.services.contentCache->hits / (float)io.services.contentCache->gets)
+                    + std::to_string(100.0f * (float)io.services.contentCache->hits() / (float)io.services.contentCache->gets())
                     + "% (" + full() + ")");
             }
 
@@ -636,60 +1321,239 @@ URI::read(const IOOptions& io) const
 
     else if (isRemote())
     {
-        HTTPRequest request{ full() };
-
-        for(auto& header : _context.headers)
+        // consult the disk cache. A still-fresh entry satisfies the request
+        // with no network traffic at all; a stale one contributes validators
+        // for a conditional GET.
+        HTTPDiskCache::Entry diskEntry;
+        if (httpDiskCache.enabled())
         {
-            request.headers.push_back({ header.first, header.second });
+            diskEntry = httpDiskCache.fetch(full());
         }
 
-        // resolve a rotation:
-        static int rotator = 0;
-        if (_r0 != std::string::npos && _r1 != std::string::npos)
+        if (diskEntry.fresh())
         {
-            util::replace_in_place(
-                request.url,
-                request.url.substr(_r0, _r1 - _r0 + 1),
-                request.url.substr(_r0 + 1 + (rotator++ % (_r1 - _r0 - 1)), 1));
+            content = { diskEntry.contentType, httpDiskCache.load(diskEntry) };
         }
-
-        // make the actual request:
-        auto r = http_get(request, io);
-        if (r.status.failed())
+        else
         {
-            return IOResult<Content>::propagate(r);
+            HTTPRequest request{ full() };
+
+            for(auto& header : _context.headers)
+            {
+                request.headers.push_back({ header.first, header.second });
+            }
+
+            if (diskEntry.valid)
+            {
+                // stale entry; ask the server whether our copy is still good:
+                if (!diskEntry.etag.empty())
+                    request.headers.push_back({ "If-None-Match", diskEntry.etag });
+                else if (!diskEntry.lastModified.empty())
+                    request.headers.push_back({ "If-Modified-Since", diskEntry.lastModified });
+            }
+
+            // resolve a rotation:
+            static int rotator = 0;
+            if (_r0 != std::string::npos && _r1 != std::string::npos)
+            {
+                util::replace_in_place(
+                    request.url,
+                    request.url.substr(_r0, _r1 - _r0 + 1),
+                    request.url.substr(_r0 + 1 + (rotator++ % (_r1 - _r0 - 1)), 1));
+            }
+
+            // make the actual request:
+            auto r = http_get(request, io);
+            if (r.status.failed())
+            {
+                return IOResult<Content>::propagate(r);
+            }
+
+            if (r.value.status == 304) // NOT MODIFIED - our cached copy is still good
+            {
+                content = { diskEntry.contentType, httpDiskCache.load(diskEntry) };
+                httpDiskCache.refresh(diskEntry, r.value);
+            }
+            else
+            {
+                content = contentFromHTTPResponse(request.url, r.value);
+
+                if (httpDiskCache.enabled())
+                {
+                    httpDiskCache.store(full(), r.value, content);
+                }
+            }
         }
+    }
+    else
+    {
+        return Status(Status::ResourceUnavailable, full());
+    }
 
-        std::string contentType = findHeader(r.value.headers, "Content-Type");
+    if (io.services.contentCache)
+    {
+        io.services.contentCache->put(*this, Result<Content>(content));
+    }
 
-        if (contentType.empty())
+    return content;
+}
+
+jobs::future<IOResult<Content>>
+URI::readAsync(const IOOptions& io) const
+{
+    // if an identical request is already in flight, attach to its future
+    // instead of issuing a duplicate fetch:
+    util::Coalescer<std::string, IOResult<Content>>::Ticket ticket;
+    if (io.uriRequests)
+    {
+        ticket = io.uriRequests->join(full());
+        if (!ticket.leader)
+            return ticket.result;
+    }
+
+    // resolves an immediately available result (and the in-flight table):
+    auto immediate = [&](const IOResult<Content>& value)
+        {
+            if (io.uriRequests)
+                io.uriRequests->resolve(full(), value);
+
+            jobs::future<IOResult<Content>> result;
+            result.resolve(value);
+            return result;
+        };
+
+    // Remote requests go out on the HTTP backend's event loop so no thread
+    // sleeps on a socket while the fetch is in flight; anything that can be
+    // satisfied without the network resolves immediately.
+    if (!isRemote())
+    {
+        return immediate(readImplementation(io));
+    }
+
+    if (io.services.contentCache)
+    {
+        auto cached = io.services.contentCache->get(*this);
+        if (cached.status.ok())
         {
-            contentType = inferContentType(r.value.data);
+            IOResult<Content> hit(cached.value);
+            hit.fromCache = true;
+            return immediate(hit);
         }
+    }
 
-        if (contentType.empty())
+    // a still-fresh disk cache entry also resolves immediately:
+    HTTPDiskCache::Entry diskEntry;
+    if (httpDiskCache.enabled())
+    {
+        diskEntry = httpDiskCache.fetch(full());
+        if (diskEntry.fresh())
         {
-            auto p = request.url.find_first_of('?');
-            auto url_path = p != std::string::npos ? request.url.substr(0, p) : request.url;
-            contentType = inferContentTypeFromFileExtension(url_path);
+            Content content{ diskEntry.contentType, httpDiskCache.load(diskEntry) };
+
+            if (io.services.contentCache)
+            {
+                io.services.contentCache->put(*this, Result<Content>(content));
+            }
+
+            return immediate(IOResult<Content>(content));
         }
+    }
 
-        content = {
-            contentType,
-            r.value.data
-        };
+    HTTPRequest request{ full() };
+
+    for (auto& header : _context.headers)
+    {
+        request.headers.push_back({ header.first, header.second });
     }
-    else
+
+    if (diskEntry.valid)
     {
-        return Status(Status::ResourceUnavailable, full());
+        // stale entry; ask the server whether our copy is still good:
+        if (!diskEntry.etag.empty())
+            request.headers.push_back({ "If-None-Match", diskEntry.etag });
+        else if (!diskEntry.lastModified.empty())
+            request.headers.push_back({ "If-Modified-Since", diskEntry.lastModified });
     }
 
-    if (io.services.contentCache)
+    // resolve a rotation:
+    static int rotator = 0;
+    if (_r0 != std::string::npos && _r1 != std::string::npos)
     {
-        io.services.contentCache->put(full(), Result<Content>(content));
+        util::replace_in_place(
+            request.url,
+            request.url.substr(_r0, _r1 - _r0 + 1),
+            request.url.substr(_r0 + 1 + (rotator++ % (_r1 - _r0 - 1)), 1));
     }
 
-    return content;
+    // issue the request on the I/O event loop, then convert the response to
+    // content (and cache it) on a job-pool worker once it arrives:
+    auto cache = io.services.contentCache;
+    auto requests = io.uriRequests;
+    auto url = request.url;
+
+    auto response = http_get_async(request, io);
+
+    auto convert = [url, cache, key = *this, diskEntry](const IOResult<HTTPResponse>& r) -> IOResult<Content>
+        {
+            if (r.status.failed())
+            {
+                return IOResult<Content>::propagate(r);
+            }
+
+            Content content;
+
+            if (r.value.status == 304) // NOT MODIFIED - our cached copy is still good
+            {
+                content = { diskEntry.contentType, httpDiskCache.load(diskEntry) };
+                httpDiskCache.refresh(diskEntry, r.value);
+            }
+            else
+            {
+                content = contentFromHTTPResponse(url, r.value);
+
+                if (httpDiskCache.enabled())
+                {
+                    httpDiskCache.store(key.full(), r.value, content);
+                }
+            }
+
+            if (cache)
+            {
+                cache->put(key, Result<Content>(content));
+            }
+
+            return IOResult<Content>(content);
+        };
+
+    if (requests)
+    {
+        // Followers are (or may yet be) attached to this fetch through the
+        // in-flight table, so its completion must not hinge on the leader's
+        // caller: if that caller cancels and abandons its future, the
+        // conversion still has to run and resolve the table, or every
+        // follower inherits the leader's fate and later joiners attach to
+        // an entry that never resolves. The conversion therefore runs as a
+        // fire-and-forget continuation that resolves the table, and the
+        // leader consumes the shared in-flight future just as a follower
+        // would. (The continuation captures the response future to keep
+        // the underlying transfer alive until it completes.)
+        response.then_dispatch(std::function<void(const IOResult<HTTPResponse>&)>(
+            [response, convert, requests, uri = full()](const IOResult<HTTPResponse>& r)
+            {
+                requests->resolve(uri, convert(r));
+            }));
+
+        return ticket.result;
+    }
+
+    // The continuation captures the response future to keep the underlying
+    // transfer alive until it completes; the reference is released as soon
+    // as the continuation fires.
+    return response.then_dispatch(
+        [response, convert](const IOResult<HTTPResponse>& r, jobs::cancelable&) -> IOResult<Content>
+        {
+            return convert(r);
+        });
 }
 
 bool
@@ -7,6 +7,7 @@
 
 #include <rocky/Common.h>
 #include <rocky/IOTypes.h>
+#include <rocky/weejobs.h>
 
 #include <iostream>
 #include <string>
@@ -97,6 +98,11 @@ namespace ROCKY_NAMESPACE
         /** The dereference operator also returns the fully qualified URI, since it's a common operation. */
         const std::string& operator * () const { return _fullURI; }
 
+        //! Hash of the fully qualified location, computed once when the
+        //! URI is assembled so per-request cache lookups don't re-hash
+        //! the full URL string.
+        std::size_t hash() const { return _hash; }
+
         //! Sets a referrer string for relative path URIs
         void setReferrer(const std::string& value);
 
@@ -112,6 +118,14 @@ namespace ROCKY_NAMESPACE
         //! Reads the URI into a data buffer
         IOResult<Content> read(const IOOptions& io) const;
 
+        //! Reads the URI into a data buffer without blocking the calling
+        //! thread. Remote requests are serviced by a dedicated I/O event loop
+        //! (when built with curl) or a small I/O thread pool, so job-pool
+        //! workers stay free for CPU-bound work while the fetch is in flight.
+        //! Abandoning the returned future is safe; a fetch already in
+        //! progress simply completes in the background.
+        jobs::future<IOResult<Content>> readAsync(const IOOptions& io) const;
+
     public:
 
         bool operator < (const URI& rhs) const { 
@@ -141,9 +155,11 @@ namespace ROCKY_NAMESPACE
         std::string _fullURI;
         std::string::size_type _r0 = std::string::npos, _r1 = std::string::npos;
         URIContext _context;
+        std::size_t _hash = 0;
 
         void set(const std::string& location, const URIContext& context);
         void findRotation();
+        IOResult<Content> readImplementation(const IOOptions& io) const;
     };
 
     /**
@@ -155,3 +171,12 @@ namespace ROCKY_NAMESPACE
         URI href;
     };
 }
+
+namespace std {
+    // std::hash specialization for URI; returns the precomputed hash.
+    template<> struct hash<rocky::URI> {
+        inline size_t operator()(const rocky::URI& value) const {
+            return value.hash();
+        }
+    };
+}
@@ -59,28 +59,6 @@ namespace
 
 
 
-Units::Units( const std::string& name, const std::string& abbr, const Units::Type& type, double toBase ) :
-_name  ( name ),
-_abbr  ( abbr ),
-_type  ( type ),
-_toBase( toBase ),
-_distance(0L),
-_time(0L)
-{
-    //nop
-}
-
-Units::Units( const std::string& name, const std::string& abbr, const Units& distance, const Units& time ) :
-_name    ( name ),
-_abbr    ( abbr ),
-_type    ( TYPE_SPEED ),
-_toBase  ( 1.0 ),
-_distance( &distance ),
-_time    ( &time )
-{
-    //nop
-}
-
 bool
 Units::parse(const std::string& name, Units& output)
 {
@@ -106,8 +84,11 @@ Units::parse( const std::string& input, double& out_value, Units& out_units, con
     return parseValueAndUnits(input, out_value, out_units, defaultUnits);
 }
 
-// Factor converts unit into METERS:
-const Units Units::CENTIMETERS       ( "centimeters",    "cm",  Units::TYPE_LINEAR, 0.01 ); 
+// Factor converts unit into METERS. The constexpr constructor makes
+// these constant-initialized: compile-time data with no dynamic
+// initialization (and no init-order hazards between the speed units
+// and the units they reference).
+const Units Units::CENTIMETERS       ( "centimeters",    "cm",  Units::TYPE_LINEAR, 0.01 );
 const Units Units::FEET              ( "feet",           "ft",  Units::TYPE_LINEAR, 0.3048 );
 const Units Units::FEET_US_SURVEY    ( "feet(us)",       "ft",  Units::TYPE_LINEAR, 12.0/39.37 );
 const Units Units::KILOMETERS        ( "kilometers",     "km",  Units::TYPE_LINEAR, 1000.0 );
@@ -7,6 +7,8 @@
 
 #include <rocky/Common.h>
 #include <rocky/Utils.h>
+#include <algorithm>
+#include <cstdio>
 #include <ostream>
 
 namespace ROCKY_NAMESPACE
@@ -80,7 +82,7 @@ namespace ROCKY_NAMESPACE
         static bool parse( const std::string& input, double& out_value, Units& out_units, const Units& defaultUnits );
         static bool parse( const std::string& input, float& out_value, Units& out_units, const Units& defaultUnits );
 
-        static bool convert( const Units& from, const Units& to, double input, double& output ) {
+        static constexpr bool convert( const Units& from, const Units& to, double input, double& output ) {
             if ( canConvert(from, to) ) {
                 if ( from._type == TYPE_LINEAR || from._type == TYPE_ANGULAR || from._type == TYPE_TEMPORAL )
                     convertSimple( from, to, input, output );
@@ -91,75 +93,78 @@ namespace ROCKY_NAMESPACE
             return false;
         }
 
-        static double convert( const Units& from, const Units& to, double input ) {
+        static constexpr double convert( const Units& from, const Units& to, double input ) {
             double output = input;
             convert( from, to, input, output );
             return output;
         }
 
-        static bool canConvert( const Units& from, const Units& to ) {
+        static constexpr bool canConvert( const Units& from, const Units& to ) {
             return from._type == to._type;
         }
 
-        bool canConvert( const Units& to ) const {
+        constexpr bool canConvert( const Units& to ) const {
             return _type == to._type;
         }
 
-        bool convertTo( const Units& to, double input, double& output )  const {
+        constexpr bool convertTo( const Units& to, double input, double& output )  const {
             return convert( *this, to, input, output );
         }
 
-        double convertTo( const Units& to, double input ) const {
+        constexpr double convertTo( const Units& to, double input ) const {
             return convert( *this, to, input );
         }
-        
-        const std::string& getName() const { return _name; }
 
-        const std::string& getAbbr() const { return _abbr; }
+        constexpr const char* getName() const { return _name; }
+
+        constexpr const char* getAbbr() const { return _abbr; }
 
-        const Type& getType() const { return _type; }
+        constexpr const Type& getType() const { return _type; }
 
-        bool operator == ( const Units& rhs ) const {
+        constexpr bool operator == ( const Units& rhs ) const {
             return _type == rhs._type && _toBase == rhs._toBase; }
-        
-        bool operator != ( const Units& rhs ) const {
+
+        constexpr bool operator != ( const Units& rhs ) const {
             return _type != rhs._type || _toBase != rhs._toBase; }
 
-        bool isLinear() const { return _type == TYPE_LINEAR; }
-        bool isDistance() const { return _type == TYPE_LINEAR; }
+        constexpr bool isLinear() const { return _type == TYPE_LINEAR; }
+        constexpr bool isDistance() const { return _type == TYPE_LINEAR; }
 
-        bool isAngular() const { return _type == TYPE_ANGULAR; }
-        bool isAngle() const { return _type == TYPE_ANGULAR; }
+        constexpr bool isAngular() const { return _type == TYPE_ANGULAR; }
+        constexpr bool isAngle() const { return _type == TYPE_ANGULAR; }
 
-        bool isTemporal() const { return _type == TYPE_TEMPORAL; }
-        bool isTime() const { return _type == TYPE_TEMPORAL; }
+        constexpr bool isTemporal() const { return _type == TYPE_TEMPORAL; }
+        constexpr bool isTime() const { return _type == TYPE_TEMPORAL; }
 
-        bool isSpeed() const { return _type == TYPE_SPEED; }
+        constexpr bool isSpeed() const { return _type == TYPE_SPEED; }
 
-        bool isScreenSize() const { return _type == TYPE_SCREEN_SIZE; }
+        constexpr bool isScreenSize() const { return _type == TYPE_SCREEN_SIZE; }
 
     public:
 
         // Make a new unit definition (LINEAR, ANGULAR, TEMPORAL, SCREEN)
-        Units( const std::string& name, const std::string& abbr, const Type& type, double toBase );
+        constexpr Units( const char* name, const char* abbr, const Type& type, double toBase ) :
+            _name(name), _abbr(abbr), _type(type), _toBase(toBase), _distance(nullptr), _time(nullptr) { }
 
         // Maks a new unit definition (SPEED)
-        Units( const std::string& name, const std::string& abbr, const Units& distance, const Units& time );
+        constexpr Units( const char* name, const char* abbr, const Units& distance, const Units& time ) :
+            _name(name), _abbr(abbr), _type(TYPE_SPEED), _toBase(1.0), _distance(&distance), _time(&time) { }
 
-        Units() : _type(TYPE_INVALID), _toBase(0.0), _distance(0L), _time(0L) { }
+        constexpr Units() : _name(""), _abbr(""), _type(TYPE_INVALID), _toBase(0.0), _distance(nullptr), _time(nullptr) { }
 
     private:
 
-        static void convertSimple( const Units& from, const Units& to, double input, double& output ) {
+        static constexpr void convertSimple( const Units& from, const Units& to, double input, double& output ) {
             output = input * from._toBase / to._toBase;
         }
-        static void convertSpeed( const Units& from, const Units& to, double input, double& output ) {
+        static constexpr void convertSpeed( const Units& from, const Units& to, double input, double& output ) {
             double t = from._distance->convertTo( *to._distance, input );
             output = to._time->convertTo( *from._time, t );
         }
 
 
-        std::string _name, _abbr;
+        const char* _name;
+        const char* _abbr;
         Type _type;
         double _toBase;
         const Units* _distance;
@@ -261,6 +266,14 @@ namespace ROCKY_NAMESPACE
                 return std::to_string(_value) + _units.getAbbr();
             }
 
+            //! Formats "<value><abbr>" into a caller-provided buffer with
+            //! no allocation; returns the number of characters written,
+            //! excluding the terminator. For per-frame readouts.
+            std::size_t format(char* buf, std::size_t size, int precision = 2) const {
+                int n = std::snprintf(buf, size, "%.*f%s", precision, _value, _units.getAbbr());
+                return n <= 0 ? 0 : std::min((std::size_t)n, size > 0 ? size - 1 : std::size_t(0));
+            }
+
             virtual std::string to_parseable_string() const {
                 return to_string();
             }
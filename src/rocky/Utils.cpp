@@ -25,6 +25,11 @@
 ROCKY_ABOUT(zlib, ZLIB_VERSION)
 #endif
 
+#ifdef ROCKY_HAS_ZSTD
+#include <zstd.h>
+ROCKY_ABOUT(zstd, ZSTD_VERSION_STRING)
+#endif
+
 using namespace ROCKY_NAMESPACE;
 using namespace ROCKY_NAMESPACE::util;
 
@@ -660,4 +665,87 @@ ZLibCompressor::decompress(std::istream& fin, std::string& target) const
     return ret == Z_STREAM_END ? true : false;
 }
 
+StreamingZLibDecompressor::StreamingZLibDecompressor()
+{
+    auto strm = new z_stream;
+    strm->zalloc = Z_NULL;
+    strm->zfree = Z_NULL;
+    strm->opaque = Z_NULL;
+    strm->avail_in = 0;
+    strm->next_in = Z_NULL;
+    inflateInit2(strm,
+        15 + 32); // autodetected zlib or gzip header
+    _stream = strm;
+}
+
+StreamingZLibDecompressor::~StreamingZLibDecompressor()
+{
+    auto strm = (z_stream*)_stream;
+    (void)inflateEnd(strm);
+    delete strm;
+}
+
+bool
+StreamingZLibDecompressor::decode(const char* data, std::size_t length, std::string& out)
+{
+    auto strm = (z_stream*)_stream;
+    unsigned char buf[CHUNK];
+
+    strm->next_in = (Bytef*)data;
+    strm->avail_in = (uInt)length;
+
+    int ret = Z_OK;
+    do
+    {
+        strm->avail_out = CHUNK;
+        strm->next_out = buf;
+        ret = inflate(strm, Z_NO_FLUSH);
+
+        // Z_BUF_ERROR just means inflate needs more input; it is not fatal
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+            return false;
+
+        out.append((char*)buf, CHUNK - strm->avail_out);
+
+        if (ret == Z_STREAM_END)
+            break;
+
+    } while (strm->avail_out == 0);
+
+    return true;
+}
+
 #endif // ROCKY_HAS_ZLIB
+
+#ifdef ROCKY_HAS_ZSTD
+
+StreamingZstdDecompressor::StreamingZstdDecompressor()
+{
+    _stream = ZSTD_createDStream();
+}
+
+StreamingZstdDecompressor::~StreamingZstdDecompressor()
+{
+    ZSTD_freeDStream((ZSTD_DStream*)_stream);
+}
+
+bool
+StreamingZstdDecompressor::decode(const char* data, std::size_t length, std::string& out)
+{
+    auto stream = (ZSTD_DStream*)_stream;
+    char buf[CHUNK];
+
+    ZSTD_inBuffer input{ data, length, 0 };
+    while (input.pos < input.size)
+    {
+        ZSTD_outBuffer output{ buf, CHUNK, 0 };
+        auto ret = ZSTD_decompressStream(stream, &output, &input);
+        if (ZSTD_isError(ret))
+            return false;
+
+        out.append(buf, output.pos);
+    }
+    return true;
+}
+
+#endif // ROCKY_HAS_ZSTD
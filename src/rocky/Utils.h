@@ -476,6 +476,354 @@ namespace ROCKY_NAMESPACE
             }
         };
 
+        /**
+        * A std::map-like map with the same contiguous entry storage as
+        * vector_map, backed by an open-addressing hash index once the
+        * entry count outgrows a small threshold. Small maps keep
+        * vector_map's cache-friendly linear scan; large ones get O(1)
+        * lookups instead of the linear scan's quadratic pain at a few
+        * thousand entries. Requires std::hash (or HASH) and operator==
+        * for the key.
+        */
+        template<typename KEY, typename DATA, typename HASH = std::hash<KEY>>
+        struct flat_hash_map
+        {
+            struct ENTRY {
+                KEY first;
+                DATA second;
+            };
+
+            using value_type = DATA;
+            using container_t = std::vector<ENTRY>;
+            using iterator = typename container_t::iterator;
+            using const_iterator = typename container_t::const_iterator;
+
+            // slot markers for the hash index:
+            static constexpr std::uint32_t EMPTY = 0xffffffffu;
+            static constexpr std::uint32_t TOMBSTONE = 0xfffffffeu;
+
+            // below this entry count a linear scan wins and we keep no index
+            static constexpr std::size_t SMALL_SIZE = 16;
+
+            container_t _container;
+            std::vector<std::uint32_t> _index; // empty in small mode
+            std::size_t _tombstones = 0;
+
+            inline DATA& operator[](const KEY& key) {
+                auto i = find(key);
+                if (i != end()) {
+                    return i->second;
+                }
+                _container.resize(_container.size() + 1);
+                _container.back().first = key;
+                indexNewEntry((std::uint32_t)(_container.size() - 1));
+                return _container.back().second;
+            }
+
+            inline DATA& emplace(const KEY& key, const DATA& data) {
+                auto& entry = operator[](key);
+                entry = data;
+                return entry;
+            }
+
+            inline DATA& emplace(const KEY& key, DATA&& data) {
+                auto& entry = operator[](key);
+                entry = std::move(data);
+                return entry;
+            }
+
+            inline const_iterator begin() const { return _container.begin(); }
+            inline const_iterator end()   const { return _container.end(); }
+            inline iterator begin() { return _container.begin(); }
+            inline iterator end() { return _container.end(); }
+
+            inline iterator find(const KEY& key) {
+                auto i = indexOf(key);
+                return i >= 0 ? _container.begin() + i : _container.end();
+            }
+
+            inline const_iterator find(const KEY& key) const {
+                auto i = indexOf(key);
+                return i >= 0 ? _container.begin() + i : _container.end();
+            }
+
+            inline bool empty() const { return _container.empty(); }
+
+            inline void clear() {
+                _container.clear();
+                _index.clear();
+                _tombstones = 0;
+            }
+
+            inline void erase(const KEY& key) {
+                int i = indexOf(key);
+                if (i < 0)
+                    return;
+
+                if (!_index.empty()) {
+                    // tombstone the erased key's slot:
+                    *slotOf(key) = TOMBSTONE;
+                    ++_tombstones;
+                }
+
+                // swap-remove; re-point the last entry's slot before moving
+                // it, while its key is still findable:
+                std::uint32_t last = (std::uint32_t)(_container.size() - 1);
+                if ((std::uint32_t)i < last) {
+                    if (!_index.empty()) {
+                        *slotOf(_container[last].first) = (std::uint32_t)i;
+                    }
+                    _container[i] = std::move(_container[last]);
+                }
+                _container.resize(_container.size() - 1);
+            }
+
+            inline int indexOf(const KEY& key) const {
+                if (_index.empty()) {
+                    for (unsigned i = 0; i < _container.size(); ++i) {
+                        if (_container[i].first == key) {
+                            return (int)i;
+                        }
+                    }
+                    return -1;
+                }
+                std::size_t mask = _index.size() - 1;
+                for (std::size_t pos = HASH()(key) & mask;; pos = (pos + 1) & mask) {
+                    auto slot = _index[pos];
+                    if (slot == EMPTY)
+                        return -1;
+                    if (slot != TOMBSTONE && _container[slot].first == key)
+                        return (int)slot;
+                }
+            }
+
+            inline std::size_t size() const { return _container.size(); }
+
+            template<typename InputIterator>
+            void insert(InputIterator a, InputIterator b) {
+                for (InputIterator i = a; i != b; ++i) (*this)[i->first] = i->second;
+            }
+
+        private:
+            // slot holding the given (present) key
+            inline std::uint32_t* slotOf(const KEY& key) {
+                std::size_t mask = _index.size() - 1;
+                for (std::size_t pos = HASH()(key) & mask;; pos = (pos + 1) & mask) {
+                    auto slot = _index[pos];
+                    if (slot != EMPTY && slot != TOMBSTONE && _container[slot].first == key)
+                        return &_index[pos];
+                }
+            }
+
+            inline void indexNewEntry(std::uint32_t i) {
+                if (_index.empty() && _container.size() <= SMALL_SIZE)
+                    return; // stay in small (linear scan) mode
+
+                // grow/rebuild the index at 3/4 load (counting tombstones):
+                if (_index.empty() || (_container.size() + _tombstones) * 4 > _index.size() * 3) {
+                    std::size_t newSize = 2 * SMALL_SIZE;
+                    while (newSize * 3 < _container.size() * 4)
+                        newSize *= 2;
+                    _index.assign(newSize, EMPTY);
+                    _tombstones = 0;
+                    for (std::uint32_t e = 0; e < _container.size(); ++e)
+                        place(e);
+                }
+                else {
+                    place(i);
+                }
+            }
+
+            inline void place(std::uint32_t i) {
+                std::size_t mask = _index.size() - 1;
+                std::size_t pos = HASH()(_container[i].first) & mask;
+                while (_index[pos] != EMPTY && _index[pos] != TOMBSTONE)
+                    pos = (pos + 1) & mask;
+                if (_index[pos] == TOMBSTONE)
+                    --_tombstones;
+                _index[pos] = i;
+            }
+        };
+
+        /**
+        * A std::vector-like sequence with inline storage for its first N
+        * elements. Collections that nearly always stay small (per-tile layer
+        * lists, intersecting-key sets) live entirely inside the owning object
+        * and never touch the heap; growth beyond N spills to the heap like a
+        * normal vector. Supports the subset of the std::vector interface the
+        * engine actually uses.
+        */
+        template<typename T, std::size_t N>
+        class small_vector
+        {
+        public:
+            using value_type = T;
+            using iterator = T*;
+            using const_iterator = const T*;
+
+            small_vector() = default;
+
+            small_vector(const small_vector& rhs) {
+                reserve(rhs._size);
+                for (std::size_t i = 0; i < rhs._size; ++i)
+                    new (_data + i) T(rhs._data[i]);
+                _size = rhs._size;
+            }
+
+            small_vector(small_vector&& rhs) noexcept {
+                if (rhs.spilled()) {
+                    // steal the heap block:
+                    _data = rhs._data;
+                    _capacity = rhs._capacity;
+                    _size = rhs._size;
+                    rhs._data = rhs.inline_data();
+                    rhs._capacity = N;
+                    rhs._size = 0;
+                }
+                else {
+                    // inline elements move one by one:
+                    for (std::size_t i = 0; i < rhs._size; ++i)
+                        new (_data + i) T(std::move(rhs._data[i]));
+                    _size = rhs._size;
+                    rhs.clear();
+                }
+            }
+
+            small_vector& operator=(const small_vector& rhs) {
+                if (this != &rhs) {
+                    clear();
+                    reserve(rhs._size);
+                    for (std::size_t i = 0; i < rhs._size; ++i)
+                        new (_data + i) T(rhs._data[i]);
+                    _size = rhs._size;
+                }
+                return *this;
+            }
+
+            small_vector& operator=(small_vector&& rhs) noexcept {
+                if (this != &rhs) {
+                    clear();
+                    if (spilled()) {
+                        release();
+                        _data = inline_data();
+                        _capacity = N;
+                    }
+                    if (rhs.spilled()) {
+                        _data = rhs._data;
+                        _capacity = rhs._capacity;
+                        _size = rhs._size;
+                        rhs._data = rhs.inline_data();
+                        rhs._capacity = N;
+                        rhs._size = 0;
+                    }
+                    else {
+                        for (std::size_t i = 0; i < rhs._size; ++i)
+                            new (_data + i) T(std::move(rhs._data[i]));
+                        _size = rhs._size;
+                        rhs.clear();
+                    }
+                }
+                return *this;
+            }
+
+            ~small_vector() {
+                clear();
+                if (spilled())
+                    release();
+            }
+
+            inline T& operator[](std::size_t i) { return _data[i]; }
+            inline const T& operator[](std::size_t i) const { return _data[i]; }
+
+            inline T* data() { return _data; }
+            inline const T* data() const { return _data; }
+
+            inline iterator begin() { return _data; }
+            inline iterator end() { return _data + _size; }
+            inline const_iterator begin() const { return _data; }
+            inline const_iterator end() const { return _data + _size; }
+
+            inline T& front() { return _data[0]; }
+            inline const T& front() const { return _data[0]; }
+            inline T& back() { return _data[_size - 1]; }
+            inline const T& back() const { return _data[_size - 1]; }
+
+            inline std::size_t size() const { return _size; }
+            inline std::size_t capacity() const { return _capacity; }
+            inline bool empty() const { return _size == 0; }
+
+            inline void push_back(const T& value) {
+                emplace_back(value);
+            }
+
+            inline void push_back(T&& value) {
+                emplace_back(std::move(value));
+            }
+
+            template<typename... Args>
+            inline T& emplace_back(Args&&... args) {
+                if (_size == _capacity)
+                    grow(_capacity * 2);
+                new (_data + _size) T(std::forward<Args>(args)...);
+                return _data[_size++];
+            }
+
+            inline void pop_back() {
+                _data[--_size].~T();
+            }
+
+            inline void clear() {
+                for (std::size_t i = 0; i < _size; ++i)
+                    _data[i].~T();
+                _size = 0;
+            }
+
+            inline void reserve(std::size_t n) {
+                if (n > _capacity)
+                    grow(n);
+            }
+
+            inline void resize(std::size_t n) {
+                reserve(n);
+                while (_size < n)
+                    new (_data + _size++) T();
+                while (_size > n)
+                    _data[--_size].~T();
+            }
+
+        private:
+            inline T* inline_data() {
+                return reinterpret_cast<T*>(_buffer);
+            }
+
+            inline bool spilled() const {
+                return _data != reinterpret_cast<const T*>(_buffer);
+            }
+
+            // spill (or re-spill) to a heap block of at least n elements
+            void grow(std::size_t n) {
+                std::size_t newCapacity = std::max(n, _capacity * 2);
+                T* newData = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+                for (std::size_t i = 0; i < _size; ++i) {
+                    new (newData + i) T(std::move(_data[i]));
+                    _data[i].~T();
+                }
+                if (spilled())
+                    release();
+                _data = newData;
+                _capacity = newCapacity;
+            }
+
+            inline void release() {
+                ::operator delete(_data);
+            }
+
+            alignas(T) unsigned char _buffer[N * sizeof(T)];
+            T* _data = inline_data();
+            std::size_t _size = 0;
+            std::size_t _capacity = N;
+        };
+
         /**
         * Utility to manages loops that run in the background.
         */
@@ -565,5 +913,58 @@ namespace ROCKY_NAMESPACE
         };
 #endif // ROCKY_HAS_ZLIB
 
+        /**
+        * Incremental decompressor. Feed it compressed bytes as they arrive
+        * (e.g., from a network transfer) and it emits decompressed output as
+        * it goes, overlapping decompression with the download instead of
+        * waiting for the complete payload.
+        */
+        class StreamingDecompressor
+        {
+        public:
+            //! Decompress the next run of input bytes.
+            //! @param data Next run of compressed input
+            //! @param length Size of the input in bytes
+            //! @param out String to which to append decompressed output
+            //! @return True upon success
+            virtual bool decode(const char* data, std::size_t length, std::string& out) = 0;
+
+            virtual ~StreamingDecompressor() = default;
+        };
+
+#ifdef ROCKY_HAS_ZLIB
+        /**
+        * Streaming decompressor for zlib- and gzip-encoded data.
+        */
+        class ROCKY_EXPORT StreamingZLibDecompressor : public StreamingDecompressor
+        {
+        public:
+            StreamingZLibDecompressor();
+            ~StreamingZLibDecompressor() override;
+
+            bool decode(const char* data, std::size_t length, std::string& out) override;
+
+        private:
+            void* _stream = nullptr; // z_stream
+        };
+#endif // ROCKY_HAS_ZLIB
+
+#ifdef ROCKY_HAS_ZSTD
+        /**
+        * Streaming decompressor for zstd-encoded data.
+        */
+        class ROCKY_EXPORT StreamingZstdDecompressor : public StreamingDecompressor
+        {
+        public:
+            StreamingZstdDecompressor();
+            ~StreamingZstdDecompressor() override;
+
+            bool decode(const char* data, std::size_t length, std::string& out) override;
+
+        private:
+            void* _stream = nullptr; // ZSTD_DStream
+        };
+#endif // ROCKY_HAS_ZSTD
+
     }
 }
@@ -0,0 +1,274 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "Viewshed.h"
+#include "Ellipsoid.h"
+#include "Math.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[Viewshed] "
+
+namespace
+{
+    inline double squared(double v)
+    {
+        return v * v;
+    }
+
+    // ground height with a zero fallback for points off the data
+    float groundHeight(const GeoHeightfield& terrain, double x, double y)
+    {
+        float h = terrain.heightAtLocation(x, y, Interpolation::BILINEAR);
+        return h != NO_DATA_VALUE ? h : 0.0f;
+    }
+}
+
+bool
+Viewshed::lineOfSight(
+    const GeoHeightfield& terrain,
+    const GeoPoint& observer,
+    const GeoPoint& target,
+    const Options& options)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(terrain.valid() && observer.valid() && target.valid(), false);
+
+    auto& srs = terrain.srs();
+
+    GeoPoint eye = observer;
+    GeoPoint tgt = target;
+    if (eye.srs != srs)
+        eye.transformInPlace(srs);
+    if (tgt.srs != srs)
+        tgt.transformInPlace(srs);
+    ROCKY_SOFT_ASSERT_AND_RETURN(eye.valid() && tgt.valid(), false);
+
+    double dx = tgt.x - eye.x;
+    double dy = tgt.y - eye.y;
+    if (dx == 0.0 && dy == 0.0)
+        return true;
+
+    // meters per SRS unit along each axis; for a geodetic SRS the
+    // east-west scale shrinks with latitude, so measure it at the
+    // midpoint of the sight line.
+    Distance one_meter(1.0, Units::METERS);
+    double upm_x = SRS::transformUnits(one_meter, srs, Angle(0.5 * (eye.y + tgt.y), Units::DEGREES));
+    double upm_y = SRS::transformUnits(one_meter, srs, Angle());
+    ROCKY_SOFT_ASSERT_AND_RETURN(upm_x > 0.0 && upm_y > 0.0, false);
+
+    double total = std::sqrt(squared(dx / upm_x) + squared(dy / upm_y)); // meters
+
+    // effective heights fold the earth-curvature drop (less the standard
+    // refraction allowance) into the terrain, so the sight line itself
+    // stays straight:
+    double curvature = (1.0 - options.refraction) /
+        (2.0 * srs.ellipsoid().semiMajorAxis());
+
+    double eyeZ = groundHeight(terrain, eye.x, eye.y) + options.observerHeightAGL;
+    double tgtZ = groundHeight(terrain, tgt.x, tgt.y) + options.targetHeightAGL -
+        curvature * squared(total);
+
+    // sample interval of about half a cell:
+    auto res = terrain.resolution();
+    double n = 2.0 * std::max(std::abs(dx) / res.x, std::abs(dy) / res.y);
+    unsigned steps = (unsigned)clamp(n, 1.0, 65536.0);
+
+    // March in chunks, using the min/max pyramid (when built) to skip
+    // any chunk whose terrain cannot reach the sight line.
+    constexpr unsigned chunkSize = 64;
+
+    for (unsigned c0 = 1; c0 < steps; c0 += chunkSize)
+    {
+        unsigned c1 = std::min(c0 + chunkSize, steps);
+
+        double f0 = (double)c0 / (double)steps;
+        double f1 = (double)(c1 - 1) / (double)steps;
+
+        // the sight line is linear in effective-height space, so its
+        // minimum over the chunk is at one of the endpoints:
+        double lineMin = eyeZ + std::min(f0, f1) * (tgtZ - eyeZ);
+        if (tgtZ < eyeZ)
+            lineMin = eyeZ + std::max(f0, f1) * (tgtZ - eyeZ);
+
+        auto minmax = terrain.minMaxHeight(
+            eye.x + std::min(f0, f1) * dx - std::abs(res.x),
+            eye.y + std::min(f0 * dy, f1 * dy) - std::abs(res.y),
+            eye.x + std::max(f0, f1) * dx + std::abs(res.x),
+            eye.y + std::max(f0 * dy, f1 * dy) + std::abs(res.y));
+
+        if (minmax.x == NO_DATA_VALUE)
+            continue; // no terrain in this span
+
+        // the curvature drop only lowers the terrain, so the raw max is
+        // a conservative bound:
+        if (minmax.y < lineMin)
+            continue; // terrain cannot reach the sight line here
+
+        for (unsigned i = c0; i < c1; ++i)
+        {
+            double f = (double)i / (double)steps;
+
+            float z = terrain.heightAtLocation(eye.x + f * dx, eye.y + f * dy, Interpolation::BILINEAR);
+            if (z == NO_DATA_VALUE)
+                continue;
+
+            double d = f * total;
+            if (z - curvature * squared(d) > eyeZ + f * (tgtZ - eyeZ))
+                return false; // blocked
+        }
+    }
+
+    return true;
+}
+
+GeoImage
+Viewshed::computeViewshed(
+    const GeoHeightfield& terrain,
+    const GeoPoint& observer,
+    const Options& options)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(terrain.valid() && observer.valid(), GeoImage::INVALID);
+    ROCKY_SOFT_ASSERT_AND_RETURN(options.maskSize >= 3 && options.maxDistance > 0.0, GeoImage::INVALID);
+
+    auto& srs = terrain.srs();
+
+    GeoPoint center = observer;
+    if (center.srs != srs)
+        center.transformInPlace(srs);
+    ROCKY_SOFT_ASSERT_AND_RETURN(center.valid(), GeoImage::INVALID);
+
+    // radius in SRS units along each axis:
+    Distance radius(options.maxDistance, Units::METERS);
+    double rx = SRS::transformUnits(radius, srs, Angle(center.y, Units::DEGREES));
+    double ry = SRS::transformUnits(radius, srs, Angle());
+    ROCKY_SOFT_ASSERT_AND_RETURN(rx > 0.0 && ry > 0.0, GeoImage::INVALID);
+
+    const unsigned size = options.maskSize;
+    const double x0 = center.x - rx, y0 = center.y - ry;
+    const double cellx = 2.0 * rx / (double)size;
+    const double celly = 2.0 * ry / (double)size;
+
+    double eyeZ = groundHeight(terrain, center.x, center.y) + options.observerHeightAGL;
+
+    double curvature = (1.0 - options.refraction) /
+        (2.0 * srs.ellipsoid().semiMajorAxis());
+
+    // Radial sweep: one ray per perimeter cell, each marching outward at
+    // half-cell steps while tracking the steepest terrain angle seen so
+    // far. A sample below that angle is hidden. Rays partition across
+    // the jobs system in azimuth bands; each band sweeps into its own
+    // scratch mask and the bands merge at the end, so no two workers
+    // ever touch the same byte.
+    const unsigned numRays = size * 4;
+    const unsigned steps = size; // half-cell steps over a size/2-cell radius
+
+    unsigned numBands = std::min(numRays,
+        std::max(1u, std::thread::hardware_concurrency()));
+    unsigned raysPerBand = (numRays + numBands - 1) / numBands;
+
+    std::vector<std::vector<std::uint8_t>> masks(
+        numBands, std::vector<std::uint8_t>(size * size, NO_DATA));
+
+    auto sweep = [&](unsigned band, unsigned r0, unsigned r1)
+    {
+        auto& mask = masks[band];
+
+        for (unsigned r = r0; r < r1; ++r)
+        {
+            double azimuth = 2.0 * M_PI * (double)r / (double)numRays;
+            double dirx = std::sin(azimuth), diry = std::cos(azimuth);
+
+            double maxTan = -DBL_MAX;
+
+            for (unsigned i = 1; i <= steps; ++i)
+            {
+                double f = (double)i / (double)steps;
+                double dxu = dirx * f * rx;
+                double dyu = diry * f * ry;
+
+                double x = center.x + dxu;
+                double y = center.y + dyu;
+
+                unsigned s = (unsigned)clamp((x - x0) / cellx, 0.0, (double)size - 1.0);
+                unsigned t = (unsigned)clamp((y - y0) / celly, 0.0, (double)size - 1.0);
+
+                float z = terrain.heightAtLocation(x, y, Interpolation::BILINEAR);
+                if (z == NO_DATA_VALUE)
+                    continue;
+
+                double d = f * options.maxDistance;
+                double zeff = z - curvature * squared(d) - eyeZ;
+
+                // the target height raises the test point but never
+                // occludes anything behind it:
+                bool visible = (zeff + options.targetHeightAGL) / d >= maxTan;
+                maxTan = std::max(maxTan, zeff / d);
+
+                mask[t * size + s] = visible ? VISIBLE : HIDDEN;
+            }
+        }
+    };
+
+    if (numBands <= 1)
+    {
+        sweep(0, 0, numRays);
+    }
+    else
+    {
+        auto group = jobs::jobgroup::create();
+
+        for (unsigned band = 0; band < numBands; ++band)
+        {
+            unsigned r0 = band * raysPerBand;
+            unsigned r1 = std::min(r0 + raysPerBand, numRays);
+
+            jobs::dispatch([&sweep, band, r0, r1]()
+                {
+                    sweep(band, r0, r1);
+                },
+                jobs::context{ "rocky::viewshed", nullptr, {}, group });
+        }
+
+        group->join();
+    }
+
+    // merge the band masks; VISIBLE > HIDDEN > NO_DATA, so where rays
+    // from adjacent bands cross the same cell near the center, max()
+    // keeps the optimistic answer.
+    auto image = std::make_shared<Image>(Image::R8_UNORM, size, size);
+    auto* out = image->data<std::uint8_t>();
+    std::memset(out, NO_DATA, size * size);
+
+    for (auto& mask : masks)
+    {
+        for (unsigned i = 0; i < size * size; ++i)
+            out[i] = std::max(out[i], mask[i]);
+    }
+
+    // the observer can always see its own cell:
+    out[(size / 2) * size + (size / 2)] = VISIBLE;
+
+    return GeoImage(image,
+        GeoExtent(srs, x0, y0, center.x + rx, center.y + ry));
+}
+
+jobs::future<GeoImage>
+Viewshed::computeViewshedAsync(
+    const GeoHeightfield& terrain,
+    const GeoPoint& observer,
+    const Options& options)
+{
+    return jobs::dispatch(
+        [terrain, observer, options](jobs::cancelable&)
+        {
+            return computeViewshed(terrain, observer, options);
+        },
+        jobs::context{ "rocky::viewshed" });
+}
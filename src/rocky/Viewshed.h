@@ -0,0 +1,99 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/Common.h>
+#include <rocky/GeoHeightfield.h>
+#include <rocky/GeoImage.h>
+#include <rocky/GeoPoint.h>
+#include <rocky/weejobs.h>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Line-of-sight and viewshed analysis over a georeferenced
+     * heightfield.
+     *
+     * Both queries account for earth curvature (with a standard
+     * atmospheric refraction allowance) and treat observer and target
+     * heights as meters above ground level. Line-of-sight tests use the
+     * heightfield's min/max pyramid, when present, to skip spans of the
+     * sight line that clear the terrain by inspection; the viewshed
+     * sweep parallelizes across the jobs system, so an interactive
+     * caller can recompute a mask on drag, or use computeViewshedAsync()
+     * to keep it off the calling thread entirely.
+     */
+    class ROCKY_EXPORT Viewshed
+    {
+    public:
+        //! Mask value for cells with no data or outside the radius
+        static constexpr std::uint8_t NO_DATA = 0;
+        //! Mask value for cells hidden from the observer
+        static constexpr std::uint8_t HIDDEN = 128;
+        //! Mask value for cells visible to the observer
+        static constexpr std::uint8_t VISIBLE = 255;
+
+        //! Analysis parameters
+        struct Options
+        {
+            //! Radius of the viewshed, in meters
+            double maxDistance = 10000.0;
+
+            //! Height of the observer above the terrain, in meters
+            double observerHeightAGL = 2.0;
+
+            //! Height of the target above the terrain, in meters.
+            //! Zero tests visibility of the bare ground.
+            double targetHeightAGL = 0.0;
+
+            //! Width and height of the output visibility mask
+            unsigned maskSize = 512;
+
+            //! Fraction of the curvature drop recovered by atmospheric
+            //! refraction (0.13 is the surveyor's standard)
+            double refraction = 0.13;
+        };
+
+        //! Whether the target is visible from the observer over the
+        //! given terrain. Heights above ground come from the options;
+        //! the points' own z values are ignored.
+        //! @param terrain Elevation data to test against
+        //! @param observer Observer position (any SRS)
+        //! @param target Target position (any SRS)
+        //! @param options Analysis parameters
+        //! @return True if the sight line clears the terrain
+        static bool lineOfSight(
+            const GeoHeightfield& terrain,
+            const GeoPoint& observer,
+            const GeoPoint& target,
+            const Options& options = {});
+
+        //! Computes a visibility mask around an observer.
+        //!
+        //! The result is an R8 image (values NO_DATA, HIDDEN, or
+        //! VISIBLE) georeferenced to the square of 2 x maxDistance on a
+        //! side centered on the observer, in the terrain's SRS. Attach
+        //! it to an image layer (or stream it into a dynamic image) to
+        //! drape it over the terrain.
+        //!
+        //! @param terrain Elevation data to sweep
+        //! @param observer Observer position (any SRS)
+        //! @param options Analysis parameters
+        //! @return The visibility mask, or GeoImage::INVALID on failure
+        static GeoImage computeViewshed(
+            const GeoHeightfield& terrain,
+            const GeoPoint& observer,
+            const Options& options = {});
+
+        //! Runs computeViewshed() on the jobs system and returns
+        //! immediately. Handy for recomputing on drag without stalling
+        //! the caller.
+        static jobs::future<GeoImage> computeViewshedAsync(
+            const GeoHeightfield& terrain,
+            const GeoPoint& observer,
+            const Options& options = {});
+    };
+}
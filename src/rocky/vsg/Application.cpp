@@ -5,13 +5,18 @@
  */
 #include "Application.h"
 #include "MapManipulator.h"
+#include "GPUTimer.h"
 #include "json.h"
 
 #include "ecs/MeshSystem.h"
+#include "ecs/MeshSystem2.h"
 #include "ecs/LineSystem.h"
+#include "ecs/LineSystem2.h"
+#include "ecs/CircleSystem.h"
 #include "ecs/IconSystem.h"
 #include "ecs/IconSystem2.h"
 #include "ecs/LabelSystem.h"
+#include "ecs/LabelSystem2.h"
 #include "ecs/WidgetSystem.h"
 #include "ecs/MotionSystem.h"
 #include "ecs/TransformSystem.h"
@@ -152,6 +157,8 @@ Application::ctor(int& argc, char** argv)
             << "    [--continuous]            // render frames continuously (instead of only when needed)" << std::endl
             << "    [--log-level <level>]     // set the log level (debug, info, warn, error, critical, off)" << std::endl
             << "    [--sky]                   // install a rudimentary lighting model" << std::endl
+            << "    [--gpu-profile]           // measure per-subsystem GPU times (see VSGContext::gpuTimes)" << std::endl
+            << "    [--log-depth]             // logarithmic depth buffer (fallback for non-float depth targets)" << std::endl
             << "    [--version]               // print the version" << std::endl
             << "    [--version-all]           // print all dependency versions" << std::endl
             << "    [--debug]                 // activate the Vulkan debug validation layer" << std::endl
@@ -165,13 +172,26 @@ Application::ctor(int& argc, char** argv)
     mainScene = vsg::Group::create();
     root->addChild(mainScene);
 
+    // wrap major subgraphs in GPU timestamp queries (VSGContext::gpuTimes):
+    context->gpuProfiling = commandLine.read("--gpu-profile");
+
+    auto timed = [&](const std::string& label, vsg::ref_ptr<vsg::Node> node) -> vsg::ref_ptr<vsg::Node>
+        {
+            if (!context->gpuProfiling)
+                return node;
+
+            auto timer = GPUTimedGroup::create(label, context);
+            timer->addChild(node);
+            return timer;
+        };
+
     mapNode = rocky::MapNode::create(context);
 
     // the sun
     if (commandLine.read("--sky"))
     {
         skyNode = rocky::SkyNode::create(context);
-        mainScene->addChild(skyNode);
+        mainScene->addChild(timed("sky", skyNode));
     }
 
     // wireframe overlay
@@ -180,13 +200,23 @@ Application::ctor(int& argc, char** argv)
         context->shaderCompileSettings->defines.insert("ROCKY_WIREFRAME_OVERLAY");
     }
 
+    // logarithmic depth fallback (reverse-Z float depth is the default)
+    if (commandLine.read("--log-depth"))
+    {
+        context->setLogDepthEnabled(true);
+    }
+
     // a node to render the map/terrain
-    mainScene->addChild(mapNode);
+    mainScene->addChild(timed("terrain", mapNode));
+
+    // threaded recording starts later, once the record-and-submit tasks
+    // exist (see setupViewer); calling setupThreading() this early is a no-op.
+    _multithreaded = commandLine.read("--mt");
 
-    // No idea what this actually does :)
-    if (commandLine.read("--mt"))
+    // overlap each frame's present with the next frame's update:
+    if (commandLine.read("--pipelined"))
     {
-        viewer->setupThreading();
+        pipelinedFrames = true;
     }
 
     context->sharedObjects = vsg::SharedObjects::create();
@@ -227,21 +257,41 @@ Application::ctor(int& argc, char** argv)
     // Create the ECS system manager and all its default systems.
     ecsManager = ecs::ECSNode::create(registry);
 
+    // per-system GPU timers, when profiling is on:
+    auto timer = [&](const std::string& label) -> vsg::ref_ptr<vsg::Group>
+        {
+            return context->gpuProfiling ?
+                GPUTimedGroup::create(label, context) :
+                vsg::ref_ptr<vsg::Group>{};
+        };
+
     ecsManager->add(TransformSystem::create(registry));
 
-    ecsManager->add(MeshSystemNode::create(registry));
-    ecsManager->add(NodeSystemNode::create(registry));
-    ecsManager->add(LineSystemNode::create(registry));
+    ecsManager->add(MeshSystemNode::create(registry), timer("mesh"));
+    ecsManager->add(NodeSystemNode::create(registry), timer("node"));
 
     if (indirect)
-        ecsManager->add(IconSystem2Node::create(registry));
+        ecsManager->add(MeshSystem2Node::create(registry), timer("mesh-indirect"));
+
+    if (indirect)
+        ecsManager->add(LineSystem2Node::create(registry), timer("line-indirect"));
     else
-        ecsManager->add(IconSystemNode::create(registry));
-    
-    ecsManager->add(LabelSystemNode::create(registry));
+        ecsManager->add(LineSystemNode::create(registry), timer("line"));
+
+    ecsManager->add(CircleSystemNode::create(registry), timer("circle"));
+
+    if (indirect)
+        ecsManager->add(IconSystem2Node::create(registry), timer("icon-indirect"));
+    else
+        ecsManager->add(IconSystemNode::create(registry), timer("icon"));
+
+    if (indirect)
+        ecsManager->add(LabelSystem2Node::create(registry), timer("label-indirect"));
+    else
+        ecsManager->add(LabelSystemNode::create(registry), timer("label"));
 
 #ifdef ROCKY_HAS_IMGUI
-    ecsManager->add(WidgetSystemNode::create(registry));
+    ecsManager->add(WidgetSystemNode::create(registry), timer("widgets"));
 #endif
 
     mainScene->addChild(ecsManager);
@@ -249,10 +299,28 @@ Application::ctor(int& argc, char** argv)
 
 Application::~Application()
 {
+    waitForPendingPresent();
+
+    // persist compiled shaders (if enabled) for a faster startup next run:
+    if (context)
+    {
+        context->saveShaderCache();
+    }
+
     Log()->info("Quitting background services...");
     backgroundServices.quit();
 }
 
+void
+Application::waitForPendingPresent()
+{
+    if (_pendingPresent.working())
+    {
+        _pendingPresent.join();
+    }
+    _pendingPresent.reset();
+}
+
 void
 Application::onNextUpdate(std::function<void()> func)
 {
@@ -321,6 +389,14 @@ Application::setupViewer(vsg::ref_ptr<vsg::Viewer> viewer)
 #else
     viewer->compile();
 #endif
+
+    // with the record-and-submit tasks in place, per-window recording
+    // threads can start; the terrain engine needs its record mutex on.
+    if (_multithreaded)
+    {
+        mapNode->terrainSettings().supportMultiThreadedRecord = true;
+        displayManager->setThreadedRecording(true);
+    }
 }
 
 #if 0
@@ -444,6 +520,13 @@ Application::frame()
 
     if (context->renderingEnabled)
     {
+        // in pipelined mode, the previous frame's present may still be
+        // running in the background. It must finish before we acquire the
+        // next swapchain image: acquire and present both require external
+        // synchronization on the swapchain, and advanceToNextFrame() can
+        // even recreate it on an out-of-date result (window resize).
+        waitForPendingPresent();
+
         if (!viewer->advanceToNextFrame())
         {
             _lastFrameOK = false;
@@ -489,7 +572,24 @@ Application::frame()
 
         t_present = std::chrono::steady_clock::now();
 
-        viewer->present();
+        if (pipelinedFrames)
+        {
+            // present on a background thread, overlapping the present wait
+            // (vsync, presentation queue) with the end-of-frame work, the
+            // inter-frame gap, and any no-render frames in on-demand mode.
+            // The next rendered frame joins this job before it acquires
+            // the next swapchain image; see the wait above.
+            _pendingPresent = jobs::dispatch([viewer(this->viewer)]()
+                {
+                    viewer->present();
+                    return true;
+                },
+                jobs::context{ "rocky::present", jobs::get_pool("rocky.present", 1) });
+        }
+        else
+        {
+            viewer->present();
+        }
 
         auto t_end = std::chrono::steady_clock::now();
         stats.frame = std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start);
@@ -497,6 +597,7 @@ Application::frame()
         stats.events = std::chrono::duration_cast<std::chrono::microseconds>(t_record - t_events);
         stats.record = std::chrono::duration_cast<std::chrono::microseconds>(t_present - t_record);
         stats.present = std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_present);
+        stats.accumulate();
 
         _framesSinceLastRender = 0;
     }
@@ -531,7 +632,7 @@ Application::frame()
 
         // After not rendering for a few frames, start applying a sleep to
         // "simulate" vsync so we don't tax the CPU by running full-out.
-        if (_framesSinceLastRender >= 60 && context->renderRequests == 0)
+        if (_framesSinceLastRender >= 10 && context->renderRequests == 0)
         {
             auto max_frame_time = std::chrono::milliseconds(10);
             auto now = vsg::clock::now();
@@ -547,6 +648,93 @@ Application::frame()
     return viewer->active();
 }
 
+const char*
+Application::Stats::stageName(unsigned stage)
+{
+    static const char* names[NUM_STAGES] = { "frame", "events", "update", "record", "present" };
+    return names[stage];
+}
+
+void
+Application::Stats::accumulate()
+{
+    const std::chrono::microseconds* stages[NUM_STAGES] = {
+        &frame, &events, &update, &record, &present };
+
+    for (unsigned s = 0; s < NUM_STAGES; ++s)
+    {
+        auto& ring = _samples[s];
+        if (ring.size() < _window)
+            ring.resize(_window, 0.0f);
+        ring[_next] = 1e-3f * (float)stages[s]->count();
+    }
+
+    _next = (_next + 1) % _window;
+    _count = std::min(_count + 1, _window);
+}
+
+void
+Application::Stats::setWindow(unsigned frames)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(frames > 0, void());
+    _window = frames;
+    _next = 0, _count = 0;
+    for (auto& ring : _samples)
+        ring.clear();
+}
+
+Application::Stats::Percentiles
+Application::Stats::computePercentiles(unsigned stage) const
+{
+    Percentiles result;
+    if (_count == 0)
+        return result;
+
+    // sort a copy of the populated portion of the ring:
+    std::vector<float> sorted(_samples[stage].begin(), _samples[stage].begin() + _count);
+    std::sort(sorted.begin(), sorted.end());
+
+    auto at = [&](double p) { return (double)sorted[(std::size_t)(p * (double)(_count - 1))]; };
+    result.p50 = at(0.50);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    return result;
+}
+
+Application::Stats::Percentiles
+Application::Stats::percentiles(const std::string& stage) const
+{
+    for (unsigned s = 0; s < NUM_STAGES; ++s)
+        if (stage == stageName(s))
+            return computePercentiles(s);
+    return {};
+}
+
+std::string
+Application::Stats::to_json() const
+{
+    auto j = json::object();
+    j["window"] = _count;
+    for (unsigned s = 0; s < NUM_STAGES; ++s)
+    {
+        auto p = computePercentiles(s);
+        j[stageName(s)] = json{ {"p50_ms", p.p50}, {"p95_ms", p.p95}, {"p99_ms", p.p99} };
+    }
+    return j.dump();
+}
+
+std::string
+Application::Stats::to_csv() const
+{
+    std::stringstream buf;
+    buf << "stage,p50_ms,p95_ms,p99_ms\n";
+    for (unsigned s = 0; s < NUM_STAGES; ++s)
+    {
+        auto p = computePercentiles(s);
+        buf << stageName(s) << ',' << p.p50 << ',' << p.p95 << ',' << p.p99 << '\n';
+    }
+    return buf.str();
+}
 
 std::string
 Application::about() const
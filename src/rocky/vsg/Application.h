@@ -18,6 +18,7 @@
 #include <vsg/app/View.h>
 #include <vsg/nodes/Group.h>
 
+#include <array>
 #include <chrono>
 #include <mutex>
 #include <deque>
@@ -81,6 +82,11 @@ namespace ROCKY_NAMESPACE
             return _lastFrameOK;
         }
 
+        //! Blocks until an in-flight pipelined present (if any) completes.
+        //! Call before any operation that requires exclusive access to the
+        //! device or swapchain, like adding or removing a window.
+        void waitForPendingPresent();
+
     public: // public properties
 
         ecs::Registry registry;
@@ -97,6 +103,14 @@ namespace ROCKY_NAMESPACE
         bool autoCreateWindow = true;
         Status commandLineStatus;
 
+        //! When true, frame() presents the previous frame on a background
+        //! thread while the next frame's scene update and event handling
+        //! run, overlapping the present wait (vsync, presentation queue)
+        //! with CPU work. The pending present always completes before the
+        //! next record pass. Adds up to one frame of display latency.
+        //! Also settable with --pipelined.
+        bool pipelinedFrames = false;
+
         // user function to call during update and before event handling
         std::function<void()> updateFunction;
 
@@ -104,8 +118,12 @@ namespace ROCKY_NAMESPACE
         using NoRenderFunction = std::shared_ptr<std::function<void()>>;
         std::deque<NoRenderFunction> noRenderFunctions;
 
-        //! Runtime timing statistics
-        struct Stats
+        //! Runtime timing statistics. The instantaneous fields reflect the
+        //! most recent rendered frame; each frame also folds into per-stage
+        //! ring buffers from which rolling percentiles can be queried or
+        //! exported, so acceptance tests don't have to instrument the frame
+        //! loop themselves.
+        struct ROCKY_EXPORT Stats
         {
             std::chrono::microseconds frame;
             std::chrono::microseconds events;
@@ -114,6 +132,41 @@ namespace ROCKY_NAMESPACE
             std::chrono::microseconds present;
             double memory;
 
+            //! rolling percentile summary of one stage, in milliseconds
+            struct Percentiles
+            {
+                double p50 = 0.0, p95 = 0.0, p99 = 0.0;
+            };
+
+            //! Percentiles for one stage over the rolling window.
+            //! Stages: "frame", "events", "update", "record", "present".
+            Percentiles percentiles(const std::string& stage) const;
+
+            //! All stages' rolling percentiles as a JSON object
+            std::string to_json() const;
+
+            //! All stages' rolling percentiles as a CSV table
+            //! (stage, p50_ms, p95_ms, p99_ms)
+            std::string to_csv() const;
+
+            //! Sets the number of frames over which percentiles aggregate
+            //! (default 300) and resets the collection.
+            void setWindow(unsigned frames);
+
+            //! Called by the frame loop once per rendered frame to fold
+            //! the instantaneous timings into the rolling window.
+            void accumulate();
+
+        private:
+            static constexpr unsigned NUM_STAGES = 5;
+            static const char* stageName(unsigned stage);
+            Percentiles computePercentiles(unsigned stage) const;
+
+            // per-stage sample rings, in milliseconds
+            std::array<std::vector<float>, NUM_STAGES> _samples;
+            unsigned _window = 300;
+            unsigned _next = 0;
+            unsigned _count = 0;
         };
         Stats stats;
 
@@ -131,10 +184,11 @@ namespace ROCKY_NAMESPACE
         bool _apilayer = false;
         bool _debuglayer = false;
         bool _vsync = true;
-        bool _multithreaded = true;
+        bool _multithreaded = false;
         bool _viewerRealized = false;
         int _framesSinceLastRender = 0; // for non-continuous rendering
         bool _lastFrameOK = true;
+        jobs::future<bool> _pendingPresent; // in-flight pipelined present
 
         void ctor(int& argc, char** argv);
 
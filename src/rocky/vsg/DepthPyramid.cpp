@@ -0,0 +1,182 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "DepthPyramid.h"
+
+#include <vsg/commands/Dispatch.h>
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/io/read.h>
+#include <vsg/state/ComputePipeline.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/vk/Context.h>
+
+using namespace ROCKY_NAMESPACE;
+
+#define PYRAMID_SHADER "shaders/rocky.depth.pyramid.comp"
+
+// must match layout(local_size_x/y) in the shader
+#define LOCAL_WG_SIZE 8u
+
+DepthPyramid::DepthPyramid(
+    VSGContext& context,
+    vsg::ref_ptr<vsg::ImageInfo> depthSource,
+    const VkExtent2D& sourceExtent)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(depthSource && depthSource->imageView, void());
+
+    auto computeShader = vsg::ShaderStage::read(
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        "main",
+        vsg::findFile(PYRAMID_SHADER, context->searchPaths),
+        context->readerWriterOptions);
+
+    if (!computeShader)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Depth pyramid shader is missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        return;
+    }
+
+    // The base level is the largest power-of-two surface that fits inside
+    // the depth buffer, so every reduction after the first lands exactly
+    // on 2x2 quads.
+    std::uint32_t width = 1, height = 1;
+    while (width * 2 <= sourceExtent.width) width *= 2;
+    while (height * 2 <= sourceExtent.height) height *= 2;
+
+    std::uint32_t numLevels = 1;
+    while ((std::max(width, height) >> numLevels) > 0) ++numLevels;
+
+    // the pyramid image: written by the reducer, sampled by the cullers.
+    auto image = vsg::Image::create();
+    image->imageType = VK_IMAGE_TYPE_2D;
+    image->format = VK_FORMAT_R32_SFLOAT;
+    image->extent = VkExtent3D{ width, height, 1 };
+    image->mipLevels = numLevels;
+    image->arrayLayers = 1;
+    image->samples = VK_SAMPLE_COUNT_1_BIT;
+    image->tiling = VK_IMAGE_TILING_OPTIMAL;
+    image->usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+    image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image->flags = 0;
+    image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    auto vk = vsg::Context::create(context->device());
+    auto fullView = vsg::createImageView(*vk, image, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    // nearest sampling; filtering across depths would manufacture values
+    // that are on neither surface.
+    auto sampler = vsg::Sampler::create();
+    sampler->minFilter = VK_FILTER_NEAREST;
+    sampler->magFilter = VK_FILTER_NEAREST;
+    sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->minLod = 0.0f;
+    sampler->maxLod = (float)numLevels;
+
+    // the whole chain stays in GENERAL layout; it is both a storage image
+    // and a sampled image within the same compute graph every frame.
+    pyramid = vsg::ImageInfo::create(sampler, fullView, VK_IMAGE_LAYOUT_GENERAL);
+
+    params = vsg::vec4Value::create(
+        vsg::vec4((float)width, (float)height, (float)(numLevels - 1), 1.0f));
+
+    // compute pipeline for the reduction passes:
+    vsg::DescriptorSetLayoutBindings descriptor_bindings
+    {
+        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+    };
+
+    auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
+
+    auto pipeline_layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts{ descriptor_set_layout },
+        vsg::PushConstantRanges{});
+
+    auto pipeline = vsg::ComputePipeline::create(pipeline_layout, computeShader);
+
+    // contents from the previous frame are overwritten wholesale, so the
+    // per-frame transition can discard them (UNDEFINED -> GENERAL):
+    addChild(vsg::PipelineBarrier::create(
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        vsg::ImageMemoryBarrier::create(
+            VkAccessFlags{ 0 },
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            image,
+            VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, numLevels, 0, 1 })));
+
+    addChild(vsg::BindComputePipeline::create(pipeline));
+
+    // one reduction pass per level. Level 0 reads the depth buffer; each
+    // later level reads the one before it.
+    for (std::uint32_t level = 0; level < numLevels; ++level)
+    {
+        vsg::ref_ptr<vsg::ImageInfo> source;
+
+        if (level == 0)
+        {
+            // the depth source may arrive without a sampler (RTT leaves it
+            // null), so bind it with our own:
+            source = vsg::ImageInfo::create(sampler, depthSource->imageView, depthSource->imageLayout);
+        }
+        else
+        {
+            auto sourceView = vsg::ImageView::create(image, VK_IMAGE_ASPECT_COLOR_BIT);
+            sourceView->subresourceRange.baseMipLevel = level - 1;
+            sourceView->subresourceRange.levelCount = 1;
+            sourceView->compile(*vk);
+            source = vsg::ImageInfo::create(sampler, sourceView, VK_IMAGE_LAYOUT_GENERAL);
+        }
+
+        auto destView = vsg::ImageView::create(image, VK_IMAGE_ASPECT_COLOR_BIT);
+        destView->subresourceRange.baseMipLevel = level;
+        destView->subresourceRange.levelCount = 1;
+        destView->compile(*vk);
+        auto dest = vsg::ImageInfo::create(nullptr, destView, VK_IMAGE_LAYOUT_GENERAL);
+
+        addChild(vsg::BindDescriptorSet::create(
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            pipeline_layout,
+            vsg::DescriptorSet::create(
+                descriptor_set_layout,
+                vsg::Descriptors{
+                    vsg::DescriptorImage::create(vsg::ImageInfoList{ source }, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER),
+                    vsg::DescriptorImage::create(vsg::ImageInfoList{ dest }, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE) })));
+
+        std::uint32_t levelWidth = std::max(width >> level, 1u);
+        std::uint32_t levelHeight = std::max(height >> level, 1u);
+
+        addChild(vsg::Dispatch::create(
+            (levelWidth + LOCAL_WG_SIZE - 1) / LOCAL_WG_SIZE,
+            (levelHeight + LOCAL_WG_SIZE - 1) / LOCAL_WG_SIZE,
+            1));
+
+        // this level's writes must land before the next pass (or a culler
+        // later in the compute graph) samples it:
+        addChild(vsg::PipelineBarrier::create(
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            vsg::ImageMemoryBarrier::create(
+                VK_ACCESS_SHADER_WRITE_BIT,
+                VK_ACCESS_SHADER_READ_BIT,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_QUEUE_FAMILY_IGNORED,
+                VK_QUEUE_FAMILY_IGNORED,
+                image,
+                VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 })));
+    }
+}
@@ -0,0 +1,52 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/VSGContext.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/state/ImageInfo.h>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Hierarchical depth (Hi-Z) pyramid, rebuilt each frame by compute from
+    * a sampled depth texture. Level 0 is a power-of-two reduction of the
+    * depth buffer and each coarser level halves it again, keeping the
+    * farthest depth (the minimum, under VSG's reverse-depth convention)
+    * over its footprint. A GPU culler can then test an instance against a
+    * single texel at the level matching its screen size and reject
+    * geometry hidden behind terrain.
+    *
+    * Add this node to the compute command graph, feed it the depth
+    * attachment of an offscreen pass (see RTT::createOffScreenRenderGraph),
+    * and hand the node to a culler (e.g. IconSystem2Node::depthPyramid).
+    * The compute graph runs ahead of the graphics graph, so the pyramid
+    * holds the previous frame's depth; cull tests against it should keep
+    * a small depth margin to absorb camera motion.
+    */
+    class ROCKY_EXPORT DepthPyramid : public vsg::Inherit<vsg::Group, DepthPyramid>
+    {
+    public:
+        //! Construct a pyramid builder.
+        //! @param context Runtime context
+        //! @param depthSource Depth texture to reduce; its image must have
+        //!   been created with sampled usage
+        //! @param sourceExtent Dimensions of the depth texture
+        DepthPyramid(
+            VSGContext& context,
+            vsg::ref_ptr<vsg::ImageInfo> depthSource,
+            const VkExtent2D& sourceExtent);
+
+        //! The pyramid texture: R32_SFLOAT, full mip chain, nearest sampler.
+        vsg::ref_ptr<vsg::ImageInfo> pyramid;
+
+        //! (width, height, coarsest level, valid flag) of the pyramid, in
+        //! the layout the cull shaders expect for their params uniform.
+        vsg::ref_ptr<vsg::vec4Value> params;
+
+        //! OK if construction succeeded.
+        Status status;
+    };
+}
@@ -167,6 +167,41 @@ DisplayManager::initialize(VSGContext& in_context)
     }
 }
 
+void
+DisplayManager::setThreadedRecording(bool value)
+{
+    if (value != _threadedRecording)
+    {
+        _threadedRecording = value;
+
+        if (_threadedRecording)
+            resumeRecordingThreads();
+        else
+            suspendRecordingThreads();
+    }
+}
+
+void
+DisplayManager::suspendRecordingThreads()
+{
+    if (_recordingThreadsActive && context && context->viewer)
+    {
+        context->viewer->stopThreading();
+        _recordingThreadsActive = false;
+    }
+}
+
+void
+DisplayManager::resumeRecordingThreads()
+{
+    if (_threadedRecording && !_recordingThreadsActive && context && context->viewer &&
+        !context->viewer->recordAndSubmitTasks.empty())
+    {
+        context->viewer->setupThreading();
+        _recordingThreadsActive = true;
+    }
+}
+
 vsg::ref_ptr<vsg::Device>
 DisplayManager::sharedDevice()
 {
@@ -180,6 +215,12 @@ DisplayManager::addWindow(vsg::ref_ptr<vsg::Window> window, vsg::ref_ptr<vsg::Vi
     ROCKY_SOFT_ASSERT_AND_RETURN(context && context->viewer, void());
     ROCKY_SOFT_ASSERT_AND_RETURN(window, void());
 
+    // a pipelined present still in flight needs the swapchain:
+    if (app)
+    {
+        app->waitForPendingPresent();
+    }
+
     // Share device with existing windows.
     if (window->getDevice() == nullptr)
     {
@@ -218,10 +259,15 @@ DisplayManager::addWindow(vsg::ref_ptr<vsg::Window> window, vsg::ref_ptr<vsg::Vi
         app->mapNode->terrainSettings().supportMultiThreadedRecord = true;
     }
 
-    // add the new window to our viewer
+    // add the new window to our viewer. recording threads (if active)
+    // must stop while the record-and-submit tasks change underneath them.
+    suspendRecordingThreads();
+
     context->viewer->addWindow(window);
     context->viewer->addRecordAndSubmitTaskAndPresentation({ commandgraph });
 
+    resumeRecordingThreads();
+
     // install a manipulator for the new view:
     if (!user_provied_view && app)
     {
@@ -258,6 +304,12 @@ DisplayManager::addWindow(vsg::ref_ptr<vsg::WindowTraits> traits)
     ROCKY_SOFT_ASSERT_AND_RETURN(context && context->viewer, {});
     ROCKY_SOFT_ASSERT_AND_RETURN(traits, {});
 
+    // a pipelined present still in flight needs the swapchain:
+    if (app)
+    {
+        app->waitForPendingPresent();
+    }
+
     // wait until the device is idle to avoid changing state while it's being used.
     if (compiled(context->viewer))
     {
@@ -277,6 +329,12 @@ DisplayManager::addWindow(vsg::ref_ptr<vsg::WindowTraits> traits)
     // This will install the debug messaging callback so we can capture validation errors
     traits->instanceExtensionNames.push_back("VK_EXT_debug_utils");
 
+    if (vsg::isExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+    {
+        // Lets the GPU memory governor poll the driver's per-heap budgets
+        traits->deviceExtensionNames.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
     if (vsg::isExtensionSupported(VK_NV_FRAGMENT_SHADER_BARYCENTRIC_EXTENSION_NAME))
     {
         // This is required to use the NVIDIA barycentric extension without validation errors
@@ -305,12 +363,24 @@ DisplayManager::removeWindow(vsg::ref_ptr<vsg::Window> window)
     ROCKY_SOFT_ASSERT_AND_RETURN(context && context->viewer, void());
     ROCKY_SOFT_ASSERT_AND_RETURN(window, void());
 
+    // a pipelined present still in flight needs the swapchain:
+    if (app)
+    {
+        app->waitForPendingPresent();
+    }
+
     // wait until the device is idle to avoid changing state while it's being used.
     context->viewer->deviceWaitIdle();
 
+    // removing a window removes its record-and-submit task, so recording
+    // threads (if active) must stop while that happens.
+    suspendRecordingThreads();
+
     // remove the window from the viewer
     context->viewer->removeWindow(window);
 
+    resumeRecordingThreads();
+
     // remove the window from our tracking tables
     auto& views = windowsAndViews[window];
     for (auto& view : views)
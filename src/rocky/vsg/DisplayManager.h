@@ -117,6 +117,16 @@ namespace ROCKY_NAMESPACE
         //! on a command graph.
         void compileRenderGraph(vsg::ref_ptr<vsg::RenderGraph> renderGraph, vsg::ref_ptr<vsg::Window> window);
 
+        //! Enables or disables threaded command-buffer recording. When
+        //! enabled, VSG records each command graph (one per window) on its
+        //! own thread, so multi-window displays record in parallel instead
+        //! of serially on the frame loop. Recording threads stop and restart
+        //! automatically around window additions and removals.
+        void setThreadedRecording(bool value);
+
+        //! Whether threaded recording is enabled (see setThreadedRecording)
+        bool threadedRecording() const { return _threadedRecording; }
+
     public:
 
         using WindowsAndViews = std::map<vsg::ref_ptr<vsg::Window>, std::list<vsg::ref_ptr<vsg::View>>>;
@@ -140,6 +150,13 @@ namespace ROCKY_NAMESPACE
         bool _debugCallbackInstalled = false;
         std::map<vsg::ref_ptr<vsg::Window>, vsg::ref_ptr<vsg::CommandGraph>> _commandGraphByWindow;
 
+        // threaded recording state; the viewer's record threads must stop
+        // before the record-and-submit tasks change and restart afterwards
+        bool _threadedRecording = false;
+        bool _recordingThreadsActive = false;
+        void suspendRecordingThreads();
+        void resumeRecordingThreads();
+
         friend class Application;
         friend struct ImGuiIntegration;
     };
@@ -0,0 +1,149 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "GPUMemoryGovernor.h"
+
+#include <vsg/vk/Extensions.h>
+#include <vsg/vk/PhysicalDevice.h>
+
+#include <algorithm>
+
+using namespace ROCKY_NAMESPACE;
+
+std::shared_ptr<GPUMemoryGovernor::Registration>
+GPUMemoryGovernor::add(
+    const std::string& name,
+    std::function<std::size_t()> size,
+    std::function<void(float)> shrink)
+{
+    auto reg = std::make_shared<Registration>(Registration{ name, size, shrink });
+    std::scoped_lock L(_mutex);
+    _registrations.emplace_back(reg);
+    return reg;
+}
+
+float
+GPUMemoryGovernor::update(vsg::ref_ptr<vsg::Device> device)
+{
+    if (!device)
+        return 0.0f;
+
+    // the budget query is cheap but the numbers move slowly; once a
+    // second matches the pressure cadence below.
+    auto now = std::chrono::steady_clock::now();
+    if (_queried && now - _lastPollTime < std::chrono::seconds(1))
+        return 0.0f;
+    _lastPollTime = now;
+
+    if (!_queried)
+    {
+        // DisplayManager enables VK_EXT_memory_budget when the driver
+        // offers it; without it we have consumer attribution but no
+        // budget to govern against.
+        _available = vsg::isExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        _queried = true;
+    }
+
+    if (!_available)
+        return 0.0f;
+
+    auto physicalDevice = device->getPhysicalDevice();
+    if (!physicalDevice)
+        return 0.0f;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProps = {};
+    budgetProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2 memProps2 = {};
+    memProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memProps2.pNext = &budgetProps;
+
+    vkGetPhysicalDeviceMemoryProperties2(*physicalDevice, &memProps2);
+
+    // the worst-off device-local heap drives the pressure; the usage
+    // numbers cover the whole process, which is what we want, since a
+    // failed allocation doesn't care who filled the heap.
+    double worstRatio = 0.0;
+    std::uint64_t deviceLocalUsage = 0;
+    {
+        std::scoped_lock L(_mutex);
+        _heaps.clear();
+        auto& props = memProps2.memoryProperties;
+        for (std::uint32_t i = 0; i < props.memoryHeapCount; ++i)
+        {
+            Heap heap;
+            heap.budget = budgetProps.heapBudget[i];
+            heap.usage = budgetProps.heapUsage[i];
+            heap.deviceLocal = (props.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+            _heaps.emplace_back(heap);
+
+            if (heap.deviceLocal && heap.budget > 0)
+            {
+                worstRatio = std::max(worstRatio, (double)heap.usage / (double)heap.budget);
+                deviceLocalUsage += heap.usage;
+            }
+        }
+    }
+
+    if (deviceLocalUsage > _peakUsage)
+        _peakUsage = deviceLocalUsage;
+
+    if (worstRatio <= (double)pressureThreshold)
+        return 0.0f;
+
+    // don't hammer the consumers; once a second is plenty for evicted
+    // objects to clear the deferred-deletion queue and the driver's
+    // usage numbers to catch up.
+    if (now - _lastPressureTime < std::chrono::seconds(1))
+        return 0.0f;
+    _lastPressureTime = now;
+
+    // pressure ramps from 0 at the threshold to 1 at the full budget:
+    float pressure = (float)std::min(1.0,
+        (worstRatio - (double)pressureThreshold) / std::max(0.001, 1.0 - (double)pressureThreshold));
+
+    std::scoped_lock L(_mutex);
+    for (auto it = _registrations.begin(); it != _registrations.end(); )
+    {
+        auto reg = it->lock();
+        if (!reg)
+        {
+            it = _registrations.erase(it);
+            continue;
+        }
+        if (reg->shrink)
+        {
+            reg->shrink(pressure);
+        }
+        ++it;
+    }
+
+    return pressure;
+}
+
+std::vector<GPUMemoryGovernor::Heap>
+GPUMemoryGovernor::heaps() const
+{
+    std::scoped_lock L(_mutex);
+    return _heaps;
+}
+
+std::vector<GPUMemoryGovernor::Snapshot>
+GPUMemoryGovernor::snapshot() const
+{
+    std::vector<Snapshot> result;
+    std::scoped_lock L(_mutex);
+    for (auto& entry : _registrations)
+    {
+        auto reg = entry.lock();
+        if (reg && reg->size)
+        {
+            auto size = reg->size();
+            reg->peak = std::max(reg->peak, size);
+            result.emplace_back(Snapshot{ reg->name, size, reg->peak });
+        }
+    }
+    return result;
+}
@@ -0,0 +1,104 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/Common.h>
+#include <vsg/vk/Device.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Device-memory counterpart to the process MemoryGovernor. When VRAM
+     * fills, allocations fail deep inside vsg with no warning and no way
+     * to attribute the usage. GPU consumers (terrain tile textures, the
+     * geometry pool, ECS buffers) register here with a byte-estimating
+     * function and an optional shrink function; update() polls the
+     * driver's per-heap budgets through VK_EXT_memory_budget and, as
+     * device-local usage approaches the budget, applies eviction
+     * pressure to every registered consumer. Without the extension the
+     * governor still tracks registered consumers for the diagnostics
+     * displays, but applies no pressure.
+     */
+    class ROCKY_EXPORT GPUMemoryGovernor
+    {
+    public:
+        //! A registered device-memory consumer. Hold the token returned
+        //! by add() for as long as the consumer exists; the registration
+        //! expires with it.
+        struct Registration
+        {
+            std::string name;
+            std::function<std::size_t()> size;  //! estimated resident device bytes
+            std::function<void(float)> shrink;  //! release device memory under pressure [0..1]; empty = informational only
+            std::size_t peak = 0;               //! high-water mark of size(); maintained by snapshot()
+        };
+
+        //! Fraction of the driver-reported device-local budget at which
+        //! eviction pressure begins.
+        float pressureThreshold = 0.9f;
+
+        //! Register a device-memory consumer with the governor.
+        std::shared_ptr<Registration> add(
+            const std::string& name,
+            std::function<std::size_t()> size,
+            std::function<void(float)> shrink = {});
+
+        //! Polls the driver's heap budgets (at most once per second) and
+        //! applies eviction pressure if device-local usage approaches the
+        //! budget. Call once per frame.
+        //! @return The pressure applied, [0..1] (zero when under budget)
+        float update(vsg::ref_ptr<vsg::Device> device);
+
+        //! Whether budget data is flowing, i.e. the device supports and
+        //! enabled VK_EXT_memory_budget.
+        bool available() const { return _available; }
+
+        //! One memory heap's driver-reported budget and usage, from the
+        //! most recent poll. Usage covers the whole process, not just
+        //! this library's allocations.
+        struct Heap
+        {
+            std::uint64_t budget = 0;
+            std::uint64_t usage = 0;
+            bool deviceLocal = false;
+        };
+
+        //! Heap budgets from the most recent poll (empty until the first
+        //! update() on a device with VK_EXT_memory_budget).
+        std::vector<Heap> heaps() const;
+
+        //! One registered consumer's current size and high-water mark,
+        //! for diagnostics displays.
+        struct Snapshot
+        {
+            std::string name;
+            std::size_t size = 0;
+            std::size_t peak = 0;
+        };
+
+        //! Samples each registered consumer, updating its high-water mark.
+        std::vector<Snapshot> snapshot() const;
+
+        //! Highest device-local usage seen by update(), in bytes.
+        std::uint64_t peakUsage() const { return _peakUsage; }
+
+    private:
+        mutable std::mutex _mutex;
+        std::vector<std::weak_ptr<Registration>> _registrations;
+        std::vector<Heap> _heaps;
+        std::chrono::steady_clock::time_point _lastPollTime;
+        std::chrono::steady_clock::time_point _lastPressureTime;
+        std::uint64_t _peakUsage = 0;
+        bool _available = false;
+        bool _queried = false;
+    };
+}
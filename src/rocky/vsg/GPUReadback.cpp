@@ -0,0 +1,175 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "GPUReadback.h"
+#include <rocky/Log.h>
+#include <vsg/vk/Context.h>
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[GPUReadback] "
+
+namespace
+{
+    // generous upper bound for a copy that is normally a frame or two out:
+    constexpr std::uint64_t FENCE_TIMEOUT_NS = 30ull * 1000000000ull;
+}
+
+jobs::future<std::shared_ptr<Image>>
+GPUReadback::readImage(vsg::ref_ptr<vsg::ImageInfo> source, vsg::ref_ptr<vsg::Device> device)
+{
+    jobs::future<std::shared_ptr<Image>> result;
+
+    ROCKY_SOFT_ASSERT_AND_RETURN(source && source->imageView && source->imageView->image, result);
+    ROCKY_SOFT_ASSERT_AND_RETURN(device, result);
+
+    auto image = source->imageView->image;
+
+    ROCKY_SOFT_ASSERT_AND_RETURN(image->format == VK_FORMAT_R8G8B8A8_UNORM, result,
+        "GPUReadback only supports R8G8B8A8_UNORM sources");
+
+    ROCKY_SOFT_ASSERT_AND_RETURN((image->usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) != 0, result,
+        "GPUReadback source image needs VK_IMAGE_USAGE_TRANSFER_SRC_BIT");
+
+    auto width = image->extent.width;
+    auto height = image->extent.height;
+    VkDeviceSize size = (VkDeviceSize)width * (VkDeviceSize)height * 4u;
+
+    // grab a free slot from the ring:
+    Slot* slot = nullptr;
+    {
+        std::unique_lock lock(_mutex);
+
+        if (_slots.empty())
+        {
+            _queueFamily = (std::uint32_t)device->getPhysicalDevice()->getQueueFamily(VK_QUEUE_GRAPHICS_BIT);
+            _slots.resize(std::max(1u, depth));
+        }
+
+        for (auto& s : _slots)
+        {
+            if (!s.busy)
+            {
+                s.busy = true;
+                slot = &s;
+                break;
+            }
+        }
+    }
+
+    if (!slot)
+    {
+        // every slot is in flight; fail fast rather than block the frame.
+        Log()->warn(LC "all {} readback slots are in flight; dropping a capture", _slots.size());
+        result.resolve(nullptr);
+        return result;
+    }
+
+    // lazy per-slot setup, reused across captures:
+    if (!slot->commandPool)
+    {
+        slot->commandPool = vsg::CommandPool::create(device, _queueFamily);
+        slot->fence = vsg::Fence::create(device);
+    }
+
+    if (!slot->buffer || slot->capacity < size)
+    {
+        slot->buffer = vsg::createBufferAndMemory(
+            device,
+            size,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        slot->capacity = size;
+    }
+
+    // record the copy. The command buffer returns to the pool when the
+    // completion job drops its reference.
+    auto commandBuffer = slot->commandPool->allocate();
+    VkCommandBuffer cb = commandBuffer->vk();
+
+    VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cb, &begin);
+
+    auto vk_image = image->vk(device->deviceID);
+
+    // transition the attachment to a transfer source:
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.oldLayout = source->imageLayout;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = vk_image;
+    barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+    vkCmdPipelineBarrier(cb,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageExtent = { width, height, 1 };
+    vkCmdCopyImageToBuffer(cb, vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        slot->buffer->vk(device->deviceID), 1, &region);
+
+    // and back to its steady-state layout:
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = source->imageLayout;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+    vkCmdPipelineBarrier(cb,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    vkEndCommandBuffer(cb);
+
+    // submit on the graphics queue so the copy executes after the frame
+    // that rendered the image. vsg::Queue::submit is thread-safe.
+    auto queue = device->getQueue(_queueFamily);
+
+    VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &cb;
+    queue->submit(std::vector<VkSubmitInfo>{ submit }, slot->fence.get());
+
+    // a pool thread waits on the fence and delivers the pixels:
+    jobs::dispatch([this, slot, commandBuffer, result, device, width, height, size]() mutable
+        {
+            std::shared_ptr<Image> output;
+
+            if (slot->fence->wait(FENCE_TIMEOUT_NS) == VK_SUCCESS)
+            {
+                auto* memory = slot->buffer->getDeviceMemory(device->deviceID);
+                void* ptr = nullptr;
+                if (memory && memory->map(0, size, 0, &ptr) == VK_SUCCESS)
+                {
+                    output = Image::create(Image::R8G8B8A8_UNORM, width, height);
+                    std::memcpy(output->data<std::uint8_t>(), ptr, (std::size_t)size);
+                    memory->unmap();
+                }
+            }
+            else
+            {
+                Log()->warn(LC "timed out waiting for a readback fence");
+            }
+
+            result.resolve(output);
+
+            // release the command buffer before recycling the slot:
+            commandBuffer = {};
+
+            std::unique_lock lock(_mutex);
+            slot->fence->reset();
+            slot->busy = false;
+        });
+
+    return result;
+}
@@ -0,0 +1,69 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/Common.h>
+#include <rocky/Image.h>
+#include <rocky/Utils.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/vk/Device.h>
+#include <vsg/vk/CommandPool.h>
+#include <vsg/vk/Fence.h>
+#include <mutex>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Asynchronous GPU-to-CPU image readback service.
+     *
+     * Copies a rendered attachment (like an RTT color texture) into a
+     * host-visible staging buffer and delivers the pixels on a
+     * background jobs thread once the copy's fence signals, so the
+     * frame loop never waits on the device. A fixed ring of staging
+     * slots - each with its own command buffer and fence - lets that
+     * many captures overlap in flight; when every slot is busy the
+     * next request resolves empty instead of stalling.
+     *
+     * Access through VSGContext::gpuReadback. Readable sources need
+     * VK_IMAGE_USAGE_TRANSFER_SRC_BIT; RTT::createOffScreenRenderGraph
+     * color attachments already carry it.
+     */
+    class ROCKY_EXPORT GPUReadback
+    {
+    public:
+        //! Queue an asynchronous readback of a rendered image.
+        //! The copy is recorded and submitted immediately on the calling
+        //! thread (cheap); the wait happens on a jobs pool thread.
+        //! @param source Image to read; must be R8G8B8A8_UNORM with
+        //!   transfer-source usage, in its steady-state layout
+        //! @param device Device the image lives on (VSGContext::device())
+        //! @return Future resolving to the pixels once the copy lands,
+        //!   or to nullptr on failure or when every slot is in flight
+        jobs::future<std::shared_ptr<Image>> readImage(
+            vsg::ref_ptr<vsg::ImageInfo> source,
+            vsg::ref_ptr<vsg::Device> device);
+
+        //! Number of staging slots (maximum overlapping readbacks).
+        //! Takes effect on the first readImage() call.
+        unsigned depth = 3;
+
+    private:
+        struct Slot
+        {
+            vsg::ref_ptr<vsg::CommandPool> commandPool;
+            vsg::ref_ptr<vsg::Fence> fence;
+            vsg::ref_ptr<vsg::Buffer> buffer; // host-visible staging
+            VkDeviceSize capacity = 0;
+            bool busy = false;
+        };
+
+        // the slot vector is sized once and never reallocates, so slot
+        // pointers stay valid for the service's lifetime.
+        std::vector<Slot> _slots;
+        std::uint32_t _queueFamily = 0;
+        std::mutex _mutex;
+    };
+}
@@ -0,0 +1,96 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "GPUTimer.h"
+
+using namespace ROCKY_NAMESPACE;
+
+GPUTimedGroup::GPUTimedGroup(const std::string& in_label, VSGContext context) :
+    label(in_label),
+    _context(context)
+{
+    //nop
+}
+
+GPUTimedGroup::~GPUTimedGroup()
+{
+    if (_device)
+    {
+        for (auto& query : _queries)
+        {
+            if (query.pool != VK_NULL_HANDLE)
+            {
+                vkDestroyQueryPool(_device->vk(), query.pool, nullptr);
+            }
+        }
+    }
+}
+
+void
+GPUTimedGroup::traverse(vsg::RecordTraversal& rv) const
+{
+    if (!_context->gpuProfiling || _failed)
+    {
+        Inherit::traverse(rv);
+        return;
+    }
+
+    auto& commandBuffer = *rv.getState()->_commandBuffer;
+
+    // one-time setup against the device we are recording for:
+    if (!_device)
+    {
+        _device = vsg::ref_ptr<vsg::Device>(commandBuffer.getDevice());
+        _timestampPeriod = _device->getPhysicalDevice()->getProperties().limits.timestampPeriod;
+
+        VkQueryPoolCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        info.queryCount = 2; // start and end
+
+        for (auto& query : _queries)
+        {
+            if (vkCreateQueryPool(_device->vk(), &info, nullptr, &query.pool) != VK_SUCCESS)
+            {
+                Log()->warn("GPUTimedGroup \"{}\": failed to create a timestamp query pool", label);
+                _failed = true;
+                Inherit::traverse(rv);
+                return;
+            }
+        }
+    }
+
+    // recycle the oldest pool, harvesting its result first:
+    auto& query = _queries[_next];
+    _next = (_next + 1) % (unsigned)_queries.size();
+
+    if (query.submitted)
+    {
+        std::uint64_t ticks[2] = { 0, 0 };
+
+        auto result = vkGetQueryPoolResults(
+            _device->vk(), query.pool, 0, 2,
+            sizeof(ticks), ticks, sizeof(ticks[0]),
+            VK_QUERY_RESULT_64_BIT);
+
+        if (result == VK_SUCCESS && ticks[1] >= ticks[0])
+        {
+            auto ms = (float)((double)(ticks[1] - ticks[0]) * (double)_timestampPeriod * 1.0e-6);
+
+            std::scoped_lock lock(_context->gpuTimesMutex);
+            _context->gpuTimes[label] = ms;
+        }
+
+        query.submitted = false;
+    }
+
+    vkCmdResetQueryPool(commandBuffer, query.pool, 0, 2);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query.pool, 0);
+
+    Inherit::traverse(rv);
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query.pool, 1);
+    query.submitted = true;
+}
@@ -0,0 +1,53 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/Common.h>
+#include <rocky/vsg/VSGContext.h>
+#include <vsg/nodes/Group.h>
+#include <array>
+#include <string>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Group node that measures the GPU time its subgraph spends on the
+    * graphics queue, using Vulkan timestamp queries, and publishes the
+    * result to VSGContext::gpuTimes under a label. Queries are issued
+    * only while VSGContext::gpuProfiling is true; otherwise the node is
+    * a plain pass-through group.
+    *
+    * Place at most one instance of a timer on any record path per frame;
+    * the query pools assume a single record per frame.
+    */
+    class ROCKY_EXPORT GPUTimedGroup : public vsg::Inherit<vsg::Group, GPUTimedGroup>
+    {
+    public:
+        GPUTimedGroup(const std::string& label, VSGContext context);
+
+        ~GPUTimedGroup();
+
+        //! Name under which this subgraph reports its GPU time
+        std::string label;
+
+        void traverse(vsg::RecordTraversal&) const override;
+
+    private:
+        // one query pool per potentially in-flight frame, recycled
+        // round-robin; a pool's result is harvested just before reuse so
+        // the CPU never waits on the GPU.
+        struct TimerQuery
+        {
+            VkQueryPool pool = VK_NULL_HANDLE;
+            bool submitted = false;
+        };
+        mutable std::array<TimerQuery, 3> _queries;
+        mutable unsigned _next = 0;
+        mutable vsg::ref_ptr<vsg::Device> _device;
+        mutable float _timestampPeriod = 0.0f; // nanoseconds per tick
+        mutable bool _failed = false;
+        VSGContext _context;
+    };
+}
@@ -1180,6 +1180,16 @@ MapManipulator::apply(vsg::FrameEvent& frame)
 
     bool camera_changed = updateCamera();
 
+    // extrapolate the camera's motion and warm the tile caches for
+    // imagery about to come into view:
+    if (camera_changed)
+    {
+        if (auto mapNode = getMapNode())
+        {
+            prefetcher.update(mapNode, viewpoint(), frame.time, _context);
+        }
+    }
+
     _previousTime = frame.time;
 
     // if anything caused the camera's matrix to change, dirty the instance to
@@ -1307,27 +1317,61 @@ MapManipulator::recalculateCenterFromLookVector()
     bool ok = false;
     vsg::dvec3 intersection;
 
-    if (intersect(lookat.eye, lookat.eye + look * _state.distance * 1.5, intersection))
+    // The terrain intersection walks the entire tile graph, which is too
+    // expensive to repeat every frame during continuous motion at high
+    // refresh rates. Refresh it at a fixed rate and cache the terrain
+    // height at the anchor; the frames in between use the closed-form
+    // ellipsoid/plane intersection below, raised by the cached height.
+    constexpr auto anchorRefreshPeriod = std::chrono::milliseconds(100);
+    auto now = std::chrono::steady_clock::now();
+
+    bool refreshAnchor =
+        !_anchorHeightValid ||
+        (now - _lastAnchorRefresh) >= anchorRefreshPeriod;
+
+    if (refreshAnchor)
     {
-        ok = true;
+        _lastAnchorRefresh = now;
+
+        if (intersect(lookat.eye, lookat.eye + look * _state.distance * 1.5, intersection))
+        {
+            ok = true;
+
+            // remember the terrain height here for the cheap path:
+            if (_worldSRS.isGeocentric())
+                _anchorHeight = _worldSRS.ellipsoid().geocentricToGeodetic(to_glm(intersection)).z;
+            else
+                _anchorHeight = intersection.z;
+
+            _anchorHeightValid = true;
+        }
     }
 
-    // backup plan, intersect the ellipsoid or the ground plane
-    else if (_worldSRS.isGeocentric())
+    // cheap path (and backup plan): intersect the ellipsoid or the
+    // ground plane, offset by the cached terrain height.
+    if (!ok && _worldSRS.isGeocentric())
     {
         glm::dvec3 i;
         auto target = lookat.eye + look * 1e10;
         if (_worldSRS.ellipsoid().intersectGeocentricLine(to_glm(lookat.eye), to_glm(target), i))
         {
             intersection = to_vsg(i);
+
+            if (_anchorHeightValid && _anchorHeight != 0.0)
+            {
+                // raise the point radially to the cached terrain height:
+                double len = vsg::length(intersection);
+                intersection *= (len + _anchorHeight) / len;
+            }
+
             ok = true;
         }
     }
 
-    else
+    else if (!ok)
     {
         // simple line/plane intersection
-        vsg::dvec3 P0(0, 0, 0); // point on the plane
+        vsg::dvec3 P0(0, 0, _anchorHeightValid ? _anchorHeight : 0.0); // point on the plane
         vsg::dvec3 N(0, 0, 1); // normal to the plane
         vsg::dvec3 L = look; // unit direction of the line
         vsg::dvec3 L0 = lookat.eye; // point on the line
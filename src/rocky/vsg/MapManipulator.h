@@ -6,6 +6,7 @@
 #pragma once
 
 #include <rocky/vsg/VSGContext.h>
+#include <rocky/vsg/TilePrefetcher.h>
 
 #include <rocky/GeoPoint.h>
 #include <rocky/Math.h>
@@ -79,6 +80,11 @@ namespace ROCKY_NAMESPACE
         //! Fetches the current viewpoint
         Viewpoint viewpoint() const;
 
+        //! Predictive tile prefetcher. As the camera moves this warms the
+        //! tile caches for imagery about to enter the view. Set its
+        //! lookAheadSeconds to zero to disable prefetching.
+        TilePrefetcher prefetcher;
+
         //! Clears the current viewpoint (if tethered or transitioning)
         void clearViewpoint();
 
@@ -551,6 +557,14 @@ namespace ROCKY_NAMESPACE
         // rendering required b/c something changed.
         bool _dirty;
 
+        // cached terrain height at the center anchor. Continuous motion
+        // refreshes the (expensive) terrain intersection at a fixed rate
+        // and applies a closed-form intersection raised by this height on
+        // the frames in between.
+        double _anchorHeight = 0.0;
+        bool _anchorHeightValid = false;
+        std::chrono::steady_clock::time_point _lastAnchorRefresh;
+
         bool withinRenderArea(const vsg::PointerEvent& pointerEvent) const;
 
         vsg::dvec2 ndc(const vsg::PointerEvent&) const;
@@ -6,6 +6,8 @@
 #include "MapNode.h"
 #include "Utils.h"
 #include "json.h"
+#include "terrain/TerrainEngine.h"
+#include <rocky/Heightfield.h>
 #include <rocky/Horizon.h>
 #include <rocky/ImageLayer.h>
 #include <rocky/ElevationLayer.h>
@@ -127,16 +129,93 @@ MapNode::update(VSGContext context)
         }
     }
 
-    // on our first update, open any layers that are marked to automatic opening.
+    // On our first update, kick off the layers marked for automatic
+    // opening. The opens run in parallel on the job system so the first
+    // frame renders right away instead of waiting out every layer's
+    // network or disk I/O; when the last open lands, one terrain reset
+    // brings the new layers into the tile models.
     if (!_openedLayers)
     {
-        map->openAllLayers(context->io);
+        _layerReadiness = map->openAllLayersAsync(context->io);
         _openedLayers = true;
     }
+    else if (_layerReadiness.working())
+    {
+        // keep frames flowing while the map comes up
+        context->requestFrame();
+    }
+    else if (_layerReadiness.available())
+    {
+        if (_layerReadiness.value().failed())
+        {
+            Log()->warn("One or more map layers failed to open");
+        }
+        _layerReadiness.reset();
+        terrainNode->reset(context);
+        context->requestFrame();
+    }
+
+    // a data model change (layer added, removed, or moved) needs a render
+    // even when the camera is still:
+    auto mapRevision = map->revision();
+    if (mapRevision != _lastMapRevision)
+    {
+        _lastMapRevision = mapRevision;
+        context->requestFrame();
+    }
 
     return terrainNode->update(context);
 }
 
+jobs::future<std::vector<glm::dvec3>>
+MapNode::elevationAsync(std::vector<glm::dvec3> points, const SRS& srs, const IOOptions& io) const
+{
+    // fast path: resolve whatever the resident terrain tiles cover, right
+    // here on the calling thread - a table lookup and a bilinear sample,
+    // no I/O and no job dispatch.
+    unsigned resolved = 0;
+
+    if (terrainNode && terrainNode->engine)
+    {
+        resolved = terrainNode->engine->tiles.sampleResidentElevation(points, srs);
+    }
+
+    if (resolved == points.size())
+    {
+        jobs::future<std::vector<glm::dvec3>> result;
+        result.resolve(std::move(points));
+        return result;
+    }
+
+    // the rest needs layer queries; hand the misses to the map on the
+    // jobs pool and splice the answers back in.
+    std::vector<std::size_t> missing;
+    std::vector<glm::dvec3> subset;
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        if (points[i].z == NO_DATA_VALUE)
+        {
+            missing.emplace_back(i);
+            subset.emplace_back(points[i]);
+        }
+    }
+
+    auto map(this->map);
+    const IOOptions local_io(io);
+
+    return jobs::dispatch(
+        [map, points(std::move(points)), subset(std::move(subset)), missing(std::move(missing)), srs, local_io](Cancelable&) mutable
+        {
+            map->elevation(subset, srs, local_io);
+
+            for (std::size_t j = 0; j < missing.size(); ++j)
+                points[missing[j]].z = subset[j].z;
+
+            return std::move(points);
+        },
+        jobs::context{ "map elevation query", jobs::get_pool("rocky.io", 4) });
+}
+
 void
 MapNode::traverse(vsg::RecordTraversal& rv) const
 {
@@ -179,7 +258,12 @@ MapNode::create(VSGContext context)
         auto update = [mapNode, context]()
             {
                 context->update();
-                mapNode->update(context);
+
+                // terrain changes need a render even in on-demand mode:
+                if (mapNode->update(context))
+                {
+                    context->requestFrame();
+                }
             };
 
         context->viewer->updateOperations->add(LambdaOperation::create(update), vsg::UpdateOperations::ALL_FRAMES);
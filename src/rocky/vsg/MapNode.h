@@ -65,6 +65,20 @@ namespace ROCKY_NAMESPACE
         //! @return true if updates happened
         bool update(VSGContext context);
 
+        //! Asynchronously samples the terrain elevation at a batch of
+        //! points. Points covered by resident terrain tiles resolve
+        //! immediately from in-memory data - zero I/O, and no duplicate
+        //! fetches of tiles the terrain already paged - and only the
+        //! remainder falls back to elevation-layer queries on the jobs
+        //! pool. Each point's z is replaced with its height, or
+        //! NO_DATA_VALUE where the map has no data.
+        //! @param points Points to sample
+        //! @param srs Spatial reference of the points
+        //! @param io I/O options for any fallback layer reads
+        //! @return Future resolving to the sampled points
+        jobs::future<std::vector<glm::dvec3>> elevationAsync(
+            std::vector<glm::dvec3> points, const SRS& srs, const IOOptions& io) const;
+
     public:
 
         void traverse(vsg::RecordTraversal&) const override;
@@ -76,6 +90,8 @@ namespace ROCKY_NAMESPACE
 
         vsg::ref_ptr<vsg::Group> _layerNodes;
         bool _openedLayers = false;
+        jobs::future<Status> _layerReadiness;
+        Revision _lastMapRevision = -1;
 
         struct ViewLocalData {
             std::shared_ptr<Horizon> horizon;
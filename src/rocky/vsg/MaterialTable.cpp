@@ -0,0 +1,91 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "MaterialTable.h"
+#include <rocky/Log.h>
+
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[MaterialTable] "
+
+MaterialTable::MaterialTable()
+{
+    buffer = StreamingGPUBuffer::create(
+        BUFFER_BINDING,
+        sizeof(MaterialGPU) * MAX_MATERIALS,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    // index 0 is the default material:
+    auto* table = buffer->data<MaterialGPU>();
+    table[0] = MaterialGPU{};
+    buffer->dirty(0, sizeof(MaterialGPU));
+    _count = 1u;
+}
+
+std::uint32_t
+MaterialTable::getOrAdd(const MaterialGPU& material)
+{
+    std::unique_lock lock(_mutex);
+
+    auto* table = buffer->data<MaterialGPU>();
+
+    // linear scan; the table stays small since styles deduplicate,
+    // and repeat lookups hit their entry early.
+    for (std::uint32_t i = 0; i < _count; ++i)
+    {
+        if (std::memcmp(&table[i], &material, sizeof(MaterialGPU)) == 0)
+            return i;
+    }
+
+    if (_count >= MAX_MATERIALS)
+    {
+        if (!_warnedFull)
+        {
+            Log()->warn(LC "table is full ({} materials); falling back to the default material", MAX_MATERIALS);
+            _warnedFull = true;
+        }
+        return 0u;
+    }
+
+    auto index = _count++;
+    table[index] = material;
+
+    // dirty the whole used prefix; the buffer tracks a single dirty
+    // region, so per-entry regions would drop all but the last append
+    // in a frame. The table is small and appends are rare.
+    buffer->dirty(0, _count * sizeof(MaterialGPU));
+
+    return index;
+}
+
+std::uint32_t
+MaterialTable::getOrAdd(MaterialGPU material, std::shared_ptr<Image> image)
+{
+    if (image)
+    {
+        auto placement = atlas.getOrAdd(image);
+        if (placement.valid())
+        {
+            material.uvrect = placement.uvrect;
+            material.layer = (float)placement.layer;
+        }
+    }
+
+    return getOrAdd(material);
+}
+
+void
+MaterialTable::install(vsg::ref_ptr<vsg::CommandGraph> commandGraph)
+{
+    std::unique_lock lock(_mutex);
+
+    if (!_installed && commandGraph)
+    {
+        commandGraph->addChild(buffer);
+        _installed = true;
+    }
+}
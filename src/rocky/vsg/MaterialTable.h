@@ -0,0 +1,86 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/Common.h>
+#include <rocky/vsg/PipelineState.h>
+#include <rocky/vsg/TextureAtlas.h>
+
+#include <mutex>
+
+namespace ROCKY_NAMESPACE
+{
+    //! One material record as mirrored in the rendering shaders
+    //! (rocky.material.glsl). Fields a given system does not use keep
+    //! their defaults, so styles that differ only in the fields they
+    //! care about still deduplicate to one entry.
+    struct MaterialGPU
+    {
+        vsg::vec4 color = { 1, 1, 1, 1 };
+        vsg::vec4 outline = { 0, 0, 0, 0 }; // rgb = outline color, a = width (0 = none)
+        vsg::vec4 uvrect = { 0, 0, 1, 1 };  // atlas placement (see TextureAtlas)
+        float layer = -1.0f;                // atlas layer; -1 = no texture
+        float width = 2.0f;                 // line width, pixels
+        std::int32_t stipple_pattern = ~0;
+        std::int32_t stipple_factor = 1;
+        float depth_offset = 0.0f;          // meters
+
+        float padding[3] = { 0, 0, 0 };
+        // keep me 16-byte aligned, and the padding zeroed -
+        // getOrAdd deduplicates records bytewise.
+    };
+
+    /**
+     * Shared material table for the indirect ECS rendering systems.
+     *
+     * Styles from every Line/Mesh/Icon/Label entity collapse into one
+     * deduplicated MaterialGPU array (an SSBO at BUFFER_BINDING) plus one
+     * texture atlas, each bound once per pipeline; instances carry just a
+     * uint index into the table. A mixed annotation scene therefore
+     * renders from a handful of descriptor sets total, instead of the one
+     * bind per style the classic systems record.
+     *
+     * Access through VSGContext::materials.
+     */
+    class ROCKY_EXPORT MaterialTable : public vsg::Inherit<vsg::Object, MaterialTable>
+    {
+    public:
+        //! SSBO binding slot the table occupies in each render descriptor
+        //! set; the slots below it belong to the systems' own buffers.
+        static constexpr std::uint32_t BUFFER_BINDING = 5;
+
+        //! Table capacity. getOrAdd falls back to the default material
+        //! (index 0) when the table fills up.
+        static constexpr std::uint32_t MAX_MATERIALS = 1024;
+
+        //! Construct the table. Index 0 holds a default material so a
+        //! zeroed instance record still renders sanely.
+        MaterialTable();
+
+        //! Find or append a material and return its index. Thread-safe.
+        std::uint32_t getOrAdd(const MaterialGPU& material);
+
+        //! Find or append a textured material; packs the image into the
+        //! shared atlas and records its placement first. Thread-safe.
+        std::uint32_t getOrAdd(MaterialGPU material, std::shared_ptr<Image> image);
+
+        //! Adds the streaming material buffer to the command graph that
+        //! will upload it. Idempotent; each consuming system calls this
+        //! from its initialize().
+        void install(vsg::ref_ptr<vsg::CommandGraph> commandGraph);
+
+        //! Shared texture atlas holding every textured material's image
+        TextureAtlas atlas;
+
+        //! The material array itself (MaterialGPU records)
+        vsg::ref_ptr<StreamingGPUBuffer> buffer;
+
+    private:
+        std::uint32_t _count = 0u;
+        bool _installed = false;
+        bool _warnedFull = false;
+        mutable std::mutex _mutex;
+    };
+}
@@ -0,0 +1,58 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/Common.h>
+#include <rocky/Image.h>
+
+#include <vsg/core/Data.h>
+
+#include <algorithm>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * An Image whose pixels live in a GPU-native vsg::Data payload - for
+     * example a KTX2 tile that its readerwriter transcoded straight to a
+     * block-compressed format - rather than in a CPU pixel buffer.
+     *
+     * A native image travels the tile pipeline like any other Image and
+     * uploads as-is, with no RGBA intermediate. The trade-off is that it
+     * has no CPU pixels: Image::valid() is false, pixel reads and writes
+     * are unsupported, and the resampling and compositing paths skip it.
+     * Use it for layers whose tiling scheme matches the map profile, where
+     * tiles pass through to the GPU untouched.
+     *
+     * Dimension queries report the decoded extent; sizeInBytes() and
+     * friends describe the nominal (uncompressed) pixel format, not the
+     * payload.
+     */
+    class NativeImage : public Inherit<Image, NativeImage>
+    {
+    public:
+        //! Construct an image around a GPU-format payload.
+        explicit NativeImage(vsg::ref_ptr<vsg::Data> in_native) :
+            native(in_native)
+        {
+            if (native)
+            {
+                _width = native->width() * native->properties.blockWidth;
+                _height = native->height() * native->properties.blockHeight;
+                _depth = std::max(native->depth(), 1u);
+                _mipLevels = std::max((unsigned)native->properties.maxNumMipmaps, 1u);
+            }
+        }
+
+        //! The GPU-format payload.
+        vsg::ref_ptr<vsg::Data> native;
+
+        //! The payload is immutable, so a clone shares it.
+        std::shared_ptr<Image> clone() const override
+        {
+            return NativeImage::create(native);
+        }
+    };
+}
@@ -45,10 +45,10 @@ StreamingGPUBuffer::compile(vsg::Context& context)
         ssbo->offset = 0;
         ssbo->range = _data->dataSize();
 
-        // the CPU-mapped staging buffer:
+        // the CPU-mapped staging ring; one slot per frame in flight:
         staging = vsg::createBufferAndMemory(
             context.device,
-            _data->dataSize(),
+            _data->dataSize() * RING_SIZE,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             sharing_mode,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
@@ -68,29 +68,38 @@ StreamingGPUBuffer::record(vsg::CommandBuffer& commandBuffer) const
         auto* dm = staging->getDeviceMemory(commandBuffer.deviceID);
         if (dm)
         {
-            void* mapped_data = nullptr;
+            // map the whole staging ring once and keep it mapped; the
+            // memory is host-coherent so writes flush automatically.
+            if (_mapped == nullptr)
+            {
+                VkResult result = dm->map(
+                    staging->getMemoryOffset(commandBuffer.deviceID),
+                    _data->dataSize() * RING_SIZE,
+                    0, // flags
+                    &_mapped);
 
-            VkResult result = dm->map(
-                staging->getMemoryOffset(commandBuffer.deviceID) + dirty_region.srcOffset,
-                dirty_region.size,
-                0, // flags
-                &mapped_data);
+                ROCKY_SOFT_ASSERT_AND_RETURN(result == 0, void());
+            }
 
-            ROCKY_SOFT_ASSERT_AND_RETURN(result == 0, void());
+            // write into the next ring slot, so we never touch a region
+            // that a previous in-flight frame is still transferring from:
+            VkDeviceSize slot = (VkDeviceSize)_ringIndex * _data->dataSize();
+            _ringIndex = (_ringIndex + 1) % RING_SIZE;
 
-            char* dst = reinterpret_cast<char*>(mapped_data);
+            char* dst = reinterpret_cast<char*>(_mapped) + slot + dirty_region.srcOffset;
             const char* src = reinterpret_cast<const char*>(_data->dataPointer()) + dirty_region.srcOffset;
 
             std::memcpy(dst, src, dirty_region.size);
 
-            dm->unmap();
-        }
+            VkBufferCopy copy = dirty_region;
+            copy.srcOffset += slot;
 
-        vkCmdCopyBuffer(
-            commandBuffer,
-            staging->vk(commandBuffer.deviceID),
-            ssbo->buffer->vk(commandBuffer.deviceID),
-            1, &dirty_region);
+            vkCmdCopyBuffer(
+                commandBuffer,
+                staging->vk(commandBuffer.deviceID),
+                ssbo->buffer->vk(commandBuffer.deviceID),
+                1, &copy);
+        }
 
         dirty_region = VkBufferCopy{ 0, 0, 0 };
     }
@@ -89,6 +89,10 @@ namespace ROCKY_NAMESPACE
 
     /**
     * A dynamic buffer that you can update on the GPU from CPU memory.
+    * Uploads stage through a persistently-mapped ring buffer: each dirty
+    * region lands in the next ring slot, so the CPU never overwrites a
+    * region that a previous in-flight frame is still transferring from,
+    * and there is no vkMapMemory round trip per update.
     */
     class ROCKY_EXPORT StreamingGPUBuffer : public vsg::Inherit<vsg::Command, StreamingGPUBuffer>
     {
@@ -132,10 +136,16 @@ namespace ROCKY_NAMESPACE
         void record(vsg::CommandBuffer& commandBuffer) const override;
 
     protected:
+        // number of staging ring slots; covers the maximum number of
+        // frames in flight so slot reuse never races an active transfer
+        static constexpr unsigned RING_SIZE = 3;
+
         vsg::ref_ptr<vsg::Data> _data;
         VkBufferUsageFlags usage_flags;
         VkSharingMode sharing_mode;
         vsg::ref_ptr<vsg::Buffer> staging;
         mutable VkBufferCopy dirty_region = VkBufferCopy{ 0, 0, 0 };
+        mutable void* _mapped = nullptr;
+        mutable unsigned _ringIndex = 0;
     };
 }
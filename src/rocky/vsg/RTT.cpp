@@ -1,6 +1,10 @@
 #include "RTT.h"
+#include "MapNode.h"
+#include "Utils.h"
+#include "terrain/TerrainEngine.h"
 
 using namespace ROCKY_NAMESPACE;
+using namespace ROCKY_NAMESPACE::util;
 
 
 // adapted from vsgExamples/vsgrendertotexture.cpp
@@ -36,7 +40,9 @@ vsg::ref_ptr<vsg::RenderGraph> RTT::createOffScreenRenderGraph(
         colorImage->arrayLayers = 1;
         colorImage->samples = VK_SAMPLE_COUNT_1_BIT;
         colorImage->tiling = VK_IMAGE_TILING_OPTIMAL;
-        colorImage->usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        // TRANSFER_SRC so the rendered texture can be captured with
+        // VSGContext::gpuReadback (e.g. for map exports):
+        colorImage->usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
         colorImage->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         colorImage->flags = 0;
         colorImage->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -92,15 +98,14 @@ vsg::ref_ptr<vsg::RenderGraph> RTT::createOffScreenRenderGraph(
         depthImage->samples = VK_SAMPLE_COUNT_1_BIT;
         depthImage->format = depthFormat;
         depthImage->tiling = VK_IMAGE_TILING_OPTIMAL;
-        depthImage->usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        depthImage->usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
         depthImage->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         depthImage->flags = 0;
         depthImage->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        // XXX Does layout matter?
         depthImageInfo->sampler = nullptr;
         depthImageInfo->imageView = vsg::createImageView(context, depthImage, VK_IMAGE_ASPECT_DEPTH_BIT);
-        depthImageInfo->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; // VK_IMAGE_LAYOUT_GENERAL;
+        depthImageInfo->imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 
         // Depth attachment
         attachments.emplace_back(vsg::AttachmentDescription{});
@@ -108,11 +113,13 @@ vsg::ref_ptr<vsg::RenderGraph> RTT::createOffScreenRenderGraph(
         attachment.format = depthFormat;
         attachment.samples = VK_SAMPLE_COUNT_1_BIT;
         attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        // store the depth and leave it readable so a consumer like
+        // DepthPyramid can sample it after the pass:
+        attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 
         vsg::AttachmentReference depthReference = { 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
         subpassDescription[0].depthStencilAttachments.emplace_back(depthReference);
@@ -163,3 +170,137 @@ vsg::ref_ptr<vsg::RenderGraph> RTT::createOffScreenRenderGraph(
 
     return rendergraph;
 }
+
+
+vsg::ref_ptr<OverviewRTT>
+OverviewRTT::create(VSGContext context, vsg::ref_ptr<MapNode> mapNode, const VkExtent2D& extent)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(context && mapNode, {});
+
+    auto node = vsg::ref_ptr<OverviewRTT>(new OverviewRTT(context, mapNode, extent));
+
+    // change detection runs as an update operation, like MapNode's:
+    if (context->viewer && context->viewer->updateOperations)
+    {
+        auto update = [node]() { node->update(); };
+        context->viewer->updateOperations->add(LambdaOperation::create(update), vsg::UpdateOperations::ALL_FRAMES);
+    }
+
+    return node;
+}
+
+OverviewRTT::OverviewRTT(VSGContext context, vsg::ref_ptr<MapNode> mapNode, const VkExtent2D& extent) :
+    _context(context),
+    _mapNode(mapNode)
+{
+    colorImage = vsg::ImageInfo::create();
+    auto depthImage = vsg::ImageInfo::create();
+
+    auto vk = vsg::Context::create(context->device());
+    auto renderGraph = RTT::createOffScreenRenderGraph(*vk, extent, colorImage, depthImage);
+
+    // the overview looks best against a plain background:
+    renderGraph->clearValues[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+
+    camera = vsg::Camera::create(
+        vsg::Orthographic::create(),
+        vsg::LookAt::create(),
+        vsg::ViewportState::create(0, 0, extent.width, extent.height));
+
+    view = vsg::View::create(camera);
+    view->addChild(mapNode);
+
+    renderGraph->addChild(view);
+    addChild(renderGraph);
+
+    // start with the whole map:
+    setExtent(mapNode->profile.extent());
+}
+
+void
+OverviewRTT::setExtent(const GeoExtent& extent)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(extent.valid(), void());
+
+    _extent = extent;
+
+    // ortho volume sized to the extent, in meters:
+    double halfWidth = 0.5 * _extent.width(Units::METERS);
+    double halfHeight = 0.5 * _extent.height(Units::METERS);
+
+    // the camera sits above the centroid looking straight down, far
+    // enough out that the terrain lies inside the ortho volume:
+    double distance = 2.0 * std::max(halfWidth, halfHeight);
+
+    auto& worldSRS = _mapNode->worldSRS();
+    GeoPoint centroid = _extent.centroid().transform(worldSRS);
+
+    vsg::dvec3 center = to_vsg(glm::dvec3(centroid));
+    vsg::dvec3 up, north;
+
+    if (worldSRS.isGeocentric())
+    {
+        up = vsg::normalize(center);
+        auto east = vsg::cross(vsg::dvec3(0.0, 0.0, 1.0), up);
+        north = vsg::normalize(vsg::cross(up, east));
+    }
+    else
+    {
+        up = vsg::dvec3(0.0, 0.0, 1.0);
+        north = vsg::dvec3(0.0, 1.0, 0.0);
+    }
+
+    camera->viewMatrix = vsg::LookAt::create(center + up * distance, center, north);
+    camera->projectionMatrix = vsg::Orthographic::create(
+        -halfWidth, halfWidth, -halfHeight, halfHeight, 0.0, 2.0 * distance);
+
+    refresh();
+}
+
+void
+OverviewRTT::refresh()
+{
+    // apply the LOD override for our view:
+    if (view->viewID < ROCKY_MAX_NUMBER_OF_VIEWS)
+    {
+        _mapNode->terrainSettings().screenSpaceErrorScale[view->viewID] = lodScale;
+    }
+
+    _framesToRender = 1;
+    _context->requestFrame();
+}
+
+void
+OverviewRTT::update()
+{
+    // the map's layer configuration changed:
+    auto mapRevision = _mapNode->map->revision();
+    if (mapRevision != _lastMapRevision)
+    {
+        _lastMapRevision = mapRevision;
+        refresh();
+    }
+
+    // the resident terrain tiles changed (paged in or out, new data merged):
+    if (_mapNode->terrainNode->engine)
+    {
+        auto terrainRevision = _mapNode->terrainNode->engine->tiles.dataRevision;
+        if (terrainRevision != _lastTerrainRevision)
+        {
+            _lastTerrainRevision = terrainRevision;
+            refresh();
+        }
+    }
+}
+
+void
+OverviewRTT::traverse(vsg::RecordTraversal& rv) const
+{
+    // record the offscreen pass only when a refresh is pending; otherwise
+    // the texture keeps its last contents and the pass costs nothing.
+    if (_framesToRender > 0)
+    {
+        --_framesToRender;
+        Inherit::traverse(rv);
+    }
+}
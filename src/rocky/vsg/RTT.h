@@ -5,6 +5,8 @@
  */
 #pragma once
 #include <rocky/vsg/Common.h>
+#include <rocky/vsg/MapNode.h>
+#include <rocky/GeoExtent.h>
 #include <vsg/app/RenderGraph.h>
 #include <vsg/state/ImageInfo.h>
 #include <vsg/vk/Context.h>
@@ -24,11 +26,73 @@ namespace ROCKY_NAMESPACE
         //! @param colorImageInfo If not null, RTT will generate a color texture in this object
         //! @param depthImageInfo If not null, RTT will generate a depth texture in this object.
         //!   Note, you still need a depth texture even if you only want color but still need
-        //!   the render to use depth testing!
+        //!   the render to use depth testing! The depth texture is stored and sampleable
+        //!   after the pass (e.g. to feed a DepthPyramid for occlusion culling).
         static vsg::ref_ptr<vsg::RenderGraph> createOffScreenRenderGraph(
             vsg::Context& context,
             const VkExtent2D& extent,
             vsg::ref_ptr<vsg::ImageInfo> colorImageInfo,
             vsg::ref_ptr<vsg::ImageInfo> depthImageInfo);
     };
+
+    /**
+    * Managed top-down overview of the map rendered to a texture, for use
+    * as a picture-in-picture inset. The offscreen pass records only when
+    * something it shows actually changed - the viewed extent, the map's
+    * layer configuration, or the resident terrain tiles - so an idle
+    * inset adds no per-frame draw load. The overview renders the terrain
+    * only, not ECS entities.
+    */
+    class ROCKY_EXPORT OverviewRTT : public vsg::Inherit<vsg::Group, OverviewRTT>
+    {
+    public:
+        //! Creates an overview node. Insert it under a window's command
+        //! graph ahead of the main render graph so the texture is ready
+        //! when the main pass samples it.
+        //! @param context Runtime context
+        //! @param mapNode Map node to render
+        //! @param extent Dimensions of the overview texture
+        static vsg::ref_ptr<OverviewRTT> create(
+            VSGContext context,
+            vsg::ref_ptr<MapNode> mapNode,
+            const VkExtent2D& extent);
+
+        //! Texture holding the rendered overview. Sample this from a GUI
+        //! widget or from geometry to display the inset.
+        vsg::ref_ptr<vsg::ImageInfo> colorImage;
+
+        //! View rendering the overview.
+        vsg::ref_ptr<vsg::View> view;
+
+        //! Camera for the overview view (top-down orthographic).
+        vsg::ref_ptr<vsg::Camera> camera;
+
+        //! Multiplier on the terrain screen-space error for the overview
+        //! view. Values above 1 page coarser LODs into the inset than the
+        //! main view would use. Takes effect on the next refresh.
+        float lodScale = 4.0f;
+
+        //! Sets the map extent the overview covers and schedules a re-render.
+        void setExtent(const GeoExtent& extent);
+
+        //! Schedules a re-render. Extent, map, and terrain changes are
+        //! detected automatically; call this after changing anything else
+        //! that affects the picture (like lodScale).
+        void refresh();
+
+        void traverse(vsg::RecordTraversal&) const override;
+
+    protected:
+        OverviewRTT(VSGContext context, vsg::ref_ptr<MapNode> mapNode, const VkExtent2D& extent);
+
+        //! Per-frame change detection; runs as a viewer update operation.
+        void update();
+
+        VSGContext _context;
+        vsg::ref_ptr<MapNode> _mapNode;
+        GeoExtent _extent;
+        Revision _lastMapRevision = -1;
+        Revision _lastTerrainRevision = -1;
+        mutable std::atomic_int _framesToRender = { 0 };
+    };
 }
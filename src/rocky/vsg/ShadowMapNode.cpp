@@ -0,0 +1,293 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "ShadowMapNode.h"
+#include "RTT.h"
+#include "Utils.h"
+#include "terrain/TerrainEngine.h"
+
+#include <rocky/Ephemeris.h>
+
+using namespace ROCKY_NAMESPACE;
+using namespace ROCKY_NAMESPACE::util;
+
+#define LC "[ShadowMapNode] "
+
+namespace
+{
+    // shadowData uniform layout, in vec4 slots; must match the ShadowData
+    // block in rocky.lighting.frag.glsl.
+    constexpr unsigned SHADOW_DATA_MATRICES = 0;  // mat4[NUM_CASCADES], eye space -> light clip
+    constexpr unsigned SHADOW_DATA_SPLITS = 16;   // eye-space distance where each cascade ends
+    constexpr unsigned SHADOW_DATA_PARAMS = 17;   // x = cascade count, y = depth bias, z = max distance
+    constexpr unsigned SHADOW_DATA_SIZE = 18;
+
+    // Snap a direction to a fine grid. The ephemeris sun creeps
+    // continuously; quantizing it keeps the fitted light matrices bitwise
+    // stable between frames so the cascade cache can compare them exactly,
+    // at an angular error well under a shadow-map texel.
+    vsg::dvec3 quantize(const vsg::dvec3& dir)
+    {
+        const double steps = 8192.0;
+        return vsg::normalize(vsg::dvec3(
+            std::round(dir.x * steps) / steps,
+            std::round(dir.y * steps) / steps,
+            std::round(dir.z * steps) / steps));
+    }
+}
+
+vsg::ref_ptr<ShadowMapNode>
+ShadowMapNode::create(VSGContext context, vsg::ref_ptr<MapNode> mapNode, vsg::ref_ptr<vsg::Camera> camera,
+    vsg::ref_ptr<vsg::Node> casters, vsg::ref_ptr<SkyNode> sky, unsigned resolution)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(context && mapNode && camera && casters, {});
+
+    auto node = vsg::ref_ptr<ShadowMapNode>(new ShadowMapNode(context, mapNode, camera, casters, sky, resolution));
+
+    // cascade fitting and change detection run as an update operation,
+    // like MapNode's:
+    if (context->viewer && context->viewer->updateOperations)
+    {
+        auto update = [node]() { node->update(); };
+        context->viewer->updateOperations->add(LambdaOperation::create(update), vsg::UpdateOperations::ALL_FRAMES);
+    }
+
+    return node;
+}
+
+ShadowMapNode::ShadowMapNode(VSGContext context, vsg::ref_ptr<MapNode> mapNode, vsg::ref_ptr<vsg::Camera> camera,
+    vsg::ref_ptr<vsg::Node> casters, vsg::ref_ptr<SkyNode> sky, unsigned resolution) :
+
+    _context(context),
+    _mapNode(mapNode),
+    _camera(camera),
+    _sky(sky),
+    _resolution(resolution)
+{
+    auto vk = vsg::Context::create(context->device());
+
+    // one sampler shared by all the cascade depth maps. The comparison
+    // happens in the shader, so this samples raw depth; the border color
+    // reads as "no occluder" (far, under reverse-Z) for lookups that land
+    // outside a cascade.
+    auto sampler = vsg::Sampler::create();
+    sampler->minFilter = VK_FILTER_NEAREST;
+    sampler->magFilter = VK_FILTER_NEAREST;
+    sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+
+    for (auto& cascade : _cascades)
+    {
+        // Each cascade renders through the scene's ordinary pipelines into
+        // an offscreen pass whose attachments match the main pass, and we
+        // keep the depth. The color target is ballast, but it spares us a
+        // depth-only variant of every pipeline in the app, and the cascade
+        // cache means a steady view stops recording these passes entirely.
+        auto colorImage = vsg::ImageInfo::create();
+        cascade.depth = vsg::ImageInfo::create();
+
+        cascade.renderGraph = RTT::createOffScreenRenderGraph(
+            *vk, VkExtent2D{ resolution, resolution }, colorImage, cascade.depth);
+
+        cascade.depth->sampler = sampler;
+
+        cascade.camera = vsg::Camera::create(
+            vsg::Orthographic::create(),
+            vsg::LookAt::create(),
+            vsg::ViewportState::create(0, 0, resolution, resolution));
+
+        cascade.view = vsg::View::create(cascade.camera);
+        cascade.view->addChild(casters);
+
+        cascade.renderGraph->addChild(cascade.view);
+        addChild(cascade.renderGraph);
+    }
+
+    // publish the resources so the terrain state can bind them; this must
+    // precede the terrain's first pipeline compile (see TerrainState).
+    _context->shadowData = vsg::vec4Array::create(SHADOW_DATA_SIZE);
+    _context->shadowData->properties.dataVariance = vsg::DYNAMIC_DATA;
+    for (auto& cascade : _cascades)
+        _context->shadowMaps.push_back(cascade.depth);
+
+    refresh();
+}
+
+void
+ShadowMapNode::refresh()
+{
+    for (auto& cascade : _cascades)
+    {
+        // shadow casting tolerates coarser terrain than the main view:
+        if (cascade.view->viewID < ROCKY_MAX_NUMBER_OF_VIEWS)
+        {
+            _mapNode->terrainSettings().screenSpaceErrorScale[cascade.view->viewID] = lodScale;
+        }
+
+        cascade.framesToRender = 1;
+    }
+
+    _context->requestFrame();
+}
+
+void
+ShadowMapNode::update()
+{
+    // re-render everything when the map's content changed, since new
+    // layers or freshly paged terrain tiles change what casts:
+    auto mapRevision = _mapNode->map->revision();
+    if (mapRevision != _lastMapRevision)
+    {
+        _lastMapRevision = mapRevision;
+        refresh();
+    }
+
+    if (_mapNode->terrainNode->engine)
+    {
+        auto terrainRevision = _mapNode->terrainNode->engine->tiles.dataRevision;
+        if (terrainRevision != _lastTerrainRevision)
+        {
+            _lastTerrainRevision = terrainRevision;
+            refresh();
+        }
+    }
+
+    // the sun, from the sky if we have one:
+    vsg::dvec3 sunPosition;
+    if (_sky && _sky->sun)
+    {
+        sunPosition = vsg::dvec3(_sky->sun->position);
+    }
+    else
+    {
+        auto sun = rocky::Ephemeris().sunPosition(rocky::DateTime());
+        sunPosition = vsg::dvec3(sun.geocentric.x, sun.geocentric.y, sun.geocentric.z);
+    }
+
+    auto mainView = _camera->viewMatrix->transform();
+    auto mainViewInverse = vsg::inverse(mainView);
+    auto mainProj = _camera->projectionMatrix->transform();
+
+    vsg::dvec3 eyeWorld(mainViewInverse[3][0], mainViewInverse[3][1], mainViewInverse[3][2]);
+
+    // the sun is far enough away to treat as directional; quantizing keeps
+    // the fit stable so the cache below can compare matrices exactly.
+    vsg::dvec3 L = quantize(vsg::normalize(sunPosition - eyeWorld));
+
+    vsg::dvec3 up = std::abs(vsg::dot(L, vsg::dvec3(0.0, 0.0, 1.0))) > 0.99 ?
+        vsg::dvec3(0.0, 1.0, 0.0) : vsg::dvec3(0.0, 0.0, 1.0);
+
+    // practical split scheme: blend of uniform and logarithmic splits over
+    // the shadowed range.
+    const double lambda = 0.5;
+    const double range0 = 1.0;
+    double splits[NUM_CASCADES + 1];
+    splits[0] = range0;
+    for (unsigned i = 1; i <= NUM_CASCADES; ++i)
+    {
+        double s = (double)i / (double)NUM_CASCADES;
+        double logSplit = range0 * std::pow((double)maxShadowDistance / range0, s);
+        double uniformSplit = range0 + ((double)maxShadowDistance - range0) * s;
+        splits[i] = lambda * logSplit + (1.0 - lambda) * uniformSplit;
+    }
+
+    // half-extents of the view frustum at distance d. Perspective cameras
+    // have w == 0 in the last column; orthographic extents are constant.
+    bool perspective = (mainProj[3][3] == 0.0);
+    auto halfWidth = [&](double d) { return perspective ? d / mainProj[0][0] : 1.0 / mainProj[0][0]; };
+    auto halfHeight = [&](double d) { return perspective ? d / mainProj[1][1] : 1.0 / mainProj[1][1]; };
+
+    bool dataChanged = false;
+    auto setData = [&](unsigned index, const vsg::vec4& value)
+        {
+            if (_context->shadowData->at(index) != value)
+            {
+                _context->shadowData->set(index, value);
+                dataChanged = true;
+            }
+        };
+
+    for (unsigned i = 0; i < NUM_CASCADES; ++i)
+    {
+        auto& cascade = _cascades[i];
+
+        double dn = splits[i], df = splits[i + 1];
+
+        // bounding sphere of the frustum slice, on the view axis:
+        double zc = 0.5 * (dn + df);
+        double wn = halfWidth(dn), hn = halfHeight(dn);
+        double wf = halfWidth(df), hf = halfHeight(df);
+        double radius = std::sqrt(std::max(
+            wn * wn + hn * hn + (zc - dn) * (zc - dn),
+            wf * wf + hf * hf + (df - zc) * (df - zc)));
+
+        vsg::dvec3 centerWorld = mainViewInverse * vsg::dvec3(0.0, 0.0, -zc);
+
+        // snap the slice center to the shadow map's texel grid in light
+        // space; this kills shimmer when the camera translates, and makes
+        // a stationary view reproduce the identical matrix every frame.
+        double worldPerTexel = (2.0 * radius) / (double)_resolution;
+        auto lightSpace = vsg::lookAt(vsg::dvec3(0.0, 0.0, 0.0), -L, up);
+        vsg::dvec3 centerLight = lightSpace * centerWorld;
+        centerLight.x = std::round(centerLight.x / worldPerTexel) * worldPerTexel;
+        centerLight.y = std::round(centerLight.y / worldPerTexel) * worldPerTexel;
+        centerWorld = vsg::inverse(lightSpace) * centerLight;
+
+        vsg::dvec3 lightEye = centerWorld + L * ((double)casterReach + radius);
+
+        auto lookAt = vsg::LookAt::create(lightEye, centerWorld, up);
+        auto ortho = vsg::Orthographic::create(
+            -radius, radius, -radius, radius,
+            0.0, (double)casterReach + 2.0 * radius);
+
+        auto lightViewProj = ortho->transform() * lookAt->transform();
+
+        // the cache: re-record this cascade only if its light-space
+        // frustum actually moved.
+        if (lightViewProj != cascade.lightViewProj)
+        {
+            cascade.lightViewProj = lightViewProj;
+            cascade.camera->viewMatrix = lookAt;
+            cascade.camera->projectionMatrix = ortho;
+            cascade.framesToRender = 1;
+            _context->requestFrame();
+        }
+
+        // the eye-to-light-clip matrix updates every frame the camera
+        // moves, whether or not the cascade re-renders:
+        vsg::mat4 eyeToLight(lightViewProj * mainViewInverse);
+        for (unsigned col = 0; col < 4; ++col)
+            setData(SHADOW_DATA_MATRICES + i * 4 + col, eyeToLight[col]);
+    }
+
+    setData(SHADOW_DATA_SPLITS, vsg::vec4(
+        (float)splits[1], (float)splits[2], (float)splits[3], (float)splits[4]));
+
+    setData(SHADOW_DATA_PARAMS, vsg::vec4(
+        (float)NUM_CASCADES, depthBias, maxShadowDistance, 0.0f));
+
+    if (dataChanged)
+    {
+        _context->shadowData->dirty();
+    }
+}
+
+void
+ShadowMapNode::traverse(vsg::RecordTraversal& rv) const
+{
+    // record only the invalidated cascades; the rest keep their depth
+    // contents and cost nothing.
+    for (auto& cascade : _cascades)
+    {
+        if (cascade.framesToRender > 0)
+        {
+            --cascade.framesToRender;
+            cascade.renderGraph->accept(rv);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/Common.h>
+#include <rocky/vsg/MapNode.h>
+#include <rocky/vsg/SkyNode.h>
+#include <vsg/app/Camera.h>
+#include <vsg/app/RenderGraph.h>
+#include <vsg/state/ImageInfo.h>
+#include <array>
+#include <atomic>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Cascaded shadow maps for sun shadows on the terrain.
+    *
+    * Each cascade is an offscreen depth pass over a slice of the main
+    * camera's frustum, rendered from the sun's point of view. The terrain
+    * fragment shader samples the cascade depth maps to attenuate the sun's
+    * contribution (see rocky.lighting.frag.glsl).
+    *
+    * Cascades cache aggressively, in the manner of OverviewRTT: a cascade
+    * re-records only when its light-space frustum actually moved (the sun
+    * or the camera changed) or when the map's content changed (layers, or
+    * terrain tiles paging in). With a static camera and a static sun - the
+    * fixed-view installation case - the steady-state cost of every cascade
+    * rounds to zero; only the per-frame shadow-matrix uniform updates.
+    *
+    * The caster scene you pass in renders through its ordinary pipelines,
+    * so the terrain and the ECS systems cast without any shadow-specific
+    * pipeline variants; typically you pass the same group your main view
+    * renders.
+    *
+    * Install this under the window's command graph AHEAD of the main
+    * render graph, and create it before the first frame so the terrain
+    * pipeline compiles with shadow support.
+    */
+    class ROCKY_EXPORT ShadowMapNode : public vsg::Inherit<vsg::Group, ShadowMapNode>
+    {
+    public:
+        //! Number of cascades rendered and bound.
+        static constexpr unsigned NUM_CASCADES = 4;
+
+        //! Creates a shadow map node.
+        //! @param context Runtime context
+        //! @param mapNode Map node (for terrain LOD control and revision tracking)
+        //! @param camera Main camera whose frustum the cascades cover
+        //! @param casters Scene to render into the shadow maps (terrain and
+        //!   any shadow-casting ECS content; typically your main scene group)
+        //! @param sky Optional sky node supplying the live sun position;
+        //!   without one the sun comes from the default ephemeris
+        //! @param resolution Dimensions of each cascade's depth map
+        static vsg::ref_ptr<ShadowMapNode> create(
+            VSGContext context,
+            vsg::ref_ptr<MapNode> mapNode,
+            vsg::ref_ptr<vsg::Camera> camera,
+            vsg::ref_ptr<vsg::Node> casters,
+            vsg::ref_ptr<SkyNode> sky = {},
+            unsigned resolution = 2048);
+
+        //! Farthest distance from the camera, in meters, that receives
+        //! shadows. Also the range the cascade splits subdivide.
+        float maxShadowDistance = 25000.0f;
+
+        //! How far beyond a cascade's frustum slice, in meters, to reach
+        //! toward the sun for occluders, so that terrain outside the slice
+        //! (a mountain behind the camera) still casts into it.
+        float casterReach = 10000.0f;
+
+        //! Depth-comparison bias in normalized light-clip depth; raise it
+        //! if you see shadow acne, lower it if shadows detach ("peter-pan").
+        float depthBias = 0.0015f;
+
+        //! Multiplier on the terrain screen-space error for the shadow
+        //! views; values above 1 page coarser LODs for shadow casting than
+        //! the main view uses.
+        float lodScale = 2.0f;
+
+        //! Schedules a re-render of every cascade. Sun, camera, map, and
+        //! terrain changes are detected automatically; call this after
+        //! changing anything else (like depthBias or lodScale).
+        void refresh();
+
+        void traverse(vsg::RecordTraversal&) const override;
+
+    protected:
+        ShadowMapNode(
+            VSGContext context,
+            vsg::ref_ptr<MapNode> mapNode,
+            vsg::ref_ptr<vsg::Camera> camera,
+            vsg::ref_ptr<vsg::Node> casters,
+            vsg::ref_ptr<SkyNode> sky,
+            unsigned resolution);
+
+        //! Per-frame cascade fitting and change detection; runs as a
+        //! viewer update operation.
+        void update();
+
+        struct Cascade
+        {
+            vsg::ref_ptr<vsg::RenderGraph> renderGraph;
+            vsg::ref_ptr<vsg::View> view;
+            vsg::ref_ptr<vsg::Camera> camera;
+            vsg::ref_ptr<vsg::ImageInfo> depth;
+            vsg::dmat4 lightViewProj;
+            mutable std::atomic_int framesToRender = { 0 };
+        };
+
+        VSGContext _context;
+        vsg::ref_ptr<MapNode> _mapNode;
+        vsg::ref_ptr<vsg::Camera> _camera;
+        vsg::ref_ptr<SkyNode> _sky;
+        unsigned _resolution;
+        std::array<Cascade, NUM_CASCADES> _cascades;
+        Revision _lastMapRevision = -1;
+        Revision _lastTerrainRevision = -1;
+    };
+}
@@ -16,6 +16,7 @@
 #include <vsg/utils/ShaderSet.h>
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
 #include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/DescriptorImage.h>
 #include <vsg/state/ViewDependentState.h>
 #include <vsg/io/Options.h>
 
@@ -114,6 +115,97 @@ namespace
 #define ATMOSPHERE_VERT_SHADER "shaders/rocky.atmo.sky.vert"
 #define ATMOSPHERE_FRAG_SHADER "shaders/rocky.atmo.sky.frag"
 
+#define ATMOS_LUT_SET 0
+#define ATMOS_LUT_BINDING 0
+
+    // Precomputes the in-scattering integral that rocky.atmo.sky.vert used
+    // to evaluate per vertex, into a 3D table indexed by (cos view angle,
+    // cos sun angle, camera height). The shader reduces to a single fetch.
+    // The sun is assumed to lie in the plane of the view ray, which is the
+    // standard simplification for this parameterization and is visually
+    // indistinguishable on the sky dome.
+    // The constants here must match those in rocky.atmo.sky.vert.
+    vsg::ref_ptr<vsg::vec4Array3D> makeScatteringLUT()
+    {
+        const double polarRadius = 6356752.0;
+        const double atmosThickness = 50000.0;
+        const double innerRadius = polarRadius;
+        const double outerRadius = polarRadius + atmosThickness;
+        const double PI = 3.1415927;
+        const double Kr = 0.0025;
+        const double Km = 0.0015;
+        const double Kr4PI = Kr * 4.0 * PI;
+        const double Km4PI = Km * 4.0 * PI;
+        const double raleighScaleDepth = 0.25;
+        const glm::dvec3 invWavelength(5.6020447, 9.4732844, 19.6438026);
+        const double scale = 1.0 / (outerRadius - innerRadius);
+        const double scaleOverScaleDepth = scale / raleighScaleDepth;
+
+        // same polynomial approximation the shader used:
+        auto scaleFunc = [&](double fCos)
+            {
+                double x = 1.0 - fCos;
+                return raleighScaleDepth * exp(-0.00287 + x * (0.459 + x * (3.83 + x * (-6.80 + x * 5.25))));
+            };
+
+        const int width = 128;   // cos of the view angle from zenith
+        const int height = 64;   // cos of the sun angle from zenith
+        const int depth = 32;    // camera height within the atmosphere
+        const int numSamples = 32;
+
+        auto lut = vsg::vec4Array3D::create(width, height, depth);
+        lut->properties.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+
+        for (int z = 0; z < depth; ++z)
+        {
+            double h = innerRadius + (outerRadius - innerRadius) * ((double)z / (double)(depth - 1));
+            glm::dvec3 start(0.0, 0.0, h);
+            double startDepth = exp(scaleOverScaleDepth * (innerRadius - h));
+
+            for (int y = 0; y < height; ++y)
+            {
+                double cosSun = 2.0 * ((double)y / (double)(height - 1)) - 1.0;
+                glm::dvec3 light(sqrt(std::max(0.0, 1.0 - cosSun * cosSun)), 0.0, cosSun);
+
+                for (int x = 0; x < width; ++x)
+                {
+                    double cosView = 2.0 * ((double)x / (double)(width - 1)) - 1.0;
+                    glm::dvec3 ray(sqrt(std::max(0.0, 1.0 - cosView * cosView)), 0.0, cosView);
+
+                    // distance to the ray's exit from the outer atmosphere:
+                    double B = 2.0 * h * cosView;
+                    double C = h * h - outerRadius * outerRadius;
+                    double det = std::max(0.0, B * B - 4.0 * C);
+                    double far = 0.5 * (-B + sqrt(det));
+
+                    double startOffset = startDepth * scaleFunc(cosView);
+
+                    double sampleLength = far / (double)numSamples;
+                    double scaledLength = sampleLength * scale;
+                    glm::dvec3 sampleRay = ray * sampleLength;
+                    glm::dvec3 samplePoint = start + sampleRay * 0.5;
+
+                    glm::dvec3 frontColor(0.0);
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        double fHeight = glm::length(samplePoint);
+                        double fDepth = exp(scaleOverScaleDepth * (innerRadius - fHeight));
+                        double lightAngle = glm::dot(light, samplePoint) / fHeight;
+                        double cameraAngle = glm::dot(ray, samplePoint) / fHeight;
+                        double scatter = startOffset + fDepth * (scaleFunc(lightAngle) - scaleFunc(cameraAngle));
+                        glm::dvec3 attenuate = glm::exp(-scatter * (invWavelength * Kr4PI + Km4PI));
+                        frontColor += attenuate * (fDepth * scaledLength);
+                        samplePoint += sampleRay;
+                    }
+
+                    lut->set(x, y, z, vsg::vec4((float)frontColor.x, (float)frontColor.y, (float)frontColor.z, 1.0f));
+                }
+            }
+        }
+
+        return lut;
+    }
+
     vsg::ref_ptr<vsg::ShaderSet> makeAtmoShaderSet()
     {
         // set up search paths to SPIRV shaders and textures
@@ -144,6 +236,12 @@ namespace
 
         shaderSet->addAttributeBinding("in_vertex", "", 0, VK_FORMAT_R32G32B32_SFLOAT, vsg::vec3Array::create(1));
 
+        // precomputed in-scattering lookup table
+        shaderSet->addDescriptorBinding(
+            "atmos_lut", "",
+            ATMOS_LUT_SET, ATMOS_LUT_BINDING,
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
+
         // need VSG view-dependent data (lights)
         PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_VERTEX_BIT);
 
@@ -170,6 +268,9 @@ namespace
         // enable the arrays we think we need
         pipelineConfig->enableArray("in_vertex", VK_VERTEX_INPUT_RATE_VERTEX, 12);
 
+        // the scattering lookup table
+        pipelineConfig->enableTexture("atmos_lut");
+
         // activate the packed lights uniform
         PipelineUtils::enableViewDependentData(pipelineConfig);
 
@@ -205,9 +306,30 @@ namespace
         // --- end pipelineconfig setup ---
 
 
+        // bake the scattering integral into a 3D texture and bind it:
+        auto sampler = vsg::Sampler::create();
+        sampler->minFilter = VK_FILTER_LINEAR;
+        sampler->magFilter = VK_FILTER_LINEAR;
+        sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+        if (runtime->sharedObjects)
+            runtime->sharedObjects->share(sampler);
+
+        auto lutDescriptor = vsg::DescriptorImage::create(
+            sampler, makeScatteringLUT(),
+            ATMOS_LUT_BINDING, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+        auto lutDescriptorSet = vsg::DescriptorSet::create(
+            pipelineConfig->layout->setLayouts[ATMOS_LUT_SET],
+            vsg::Descriptors{ lutDescriptor });
+
         // set up the state group that will select the new pipeline:
         auto stategroup = vsg::StateGroup::create();
         stategroup->add(pipelineConfig->bindGraphicsPipeline);
+        stategroup->add(vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineConfig->layout, ATMOS_LUT_SET, lutDescriptorSet));
         //stategroup->add(PipelineUtils::createViewDependentBindCommand(pipelineConfig, VK_PIPELINE_BIND_POINT_GRAPHICS));
         stategroup->add(vsg::BindViewDescriptorSets::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineConfig->layout, VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX));
 
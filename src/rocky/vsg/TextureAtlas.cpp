@@ -0,0 +1,128 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "TextureAtlas.h"
+#include <rocky/Log.h>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[TextureAtlas] "
+
+namespace
+{
+    // gutter between entries so linear filtering at an entry's edge
+    // never samples its neighbor:
+    constexpr unsigned PADDING = 1;
+}
+
+TextureAtlas::TextureAtlas(unsigned width, unsigned height, unsigned layers)
+{
+    _data = vsg::ubvec4Array3D::create(width, height, layers,
+        vsg::ubvec4(0, 0, 0, 0),
+        vsg::Data::Properties(VK_FORMAT_R8G8B8A8_UNORM));
+
+    // the contents grow at runtime as new symbols arrive:
+    _data->properties.dataVariance = vsg::DYNAMIC_DATA;
+    _data->properties.imageViewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+
+    auto sampler = vsg::Sampler::create();
+    sampler->minFilter = VK_FILTER_LINEAR;
+    sampler->magFilter = VK_FILTER_LINEAR;
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+    imageInfo = vsg::ImageInfo::create(sampler, _data, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    _layers.resize(layers);
+}
+
+TextureAtlas::Placement
+TextureAtlas::getOrAdd(std::shared_ptr<Image> image)
+{
+    if (!image || !image->valid())
+        return {};
+
+    std::scoped_lock lock(_mutex);
+
+    auto iter = _placements.find(image);
+    if (iter != _placements.end())
+        return iter->second;
+
+    unsigned w = image->width() + 2 * PADDING;
+    unsigned h = image->height() + 2 * PADDING;
+
+    if (w > _data->width() || h > _data->height())
+    {
+        Log()->warn(LC "Image ({}x{}) is too large for the atlas; skipped",
+            image->width(), image->height());
+        return _placements[image] = {};
+    }
+
+    // shelf packing: find the first shelf (in any layer) tall enough with
+    // room left, preferring to reuse a shelf before opening a new one.
+    for (unsigned layer = 0; layer < _layers.size(); ++layer)
+    {
+        auto& L = _layers[layer];
+
+        Shelf* shelf = nullptr;
+
+        for (auto& s : L.shelves)
+        {
+            if (h <= s.height && s.next_x + w <= _data->width())
+            {
+                shelf = &s;
+                break;
+            }
+        }
+
+        if (!shelf && L.next_y + h <= _data->height())
+        {
+            L.shelves.push_back(Shelf{ L.next_y, h });
+            L.next_y += h;
+            shelf = &L.shelves.back();
+        }
+
+        if (shelf)
+        {
+            unsigned x = shelf->next_x + PADDING;
+            unsigned y = shelf->y + PADDING;
+            shelf->next_x += w;
+
+            // copy the pixels, converting to RGBA8 as we go:
+            Image::Pixel pixel;
+            for (unsigned t = 0; t < image->height(); ++t)
+            {
+                for (unsigned s = 0; s < image->width(); ++s)
+                {
+                    image->read(pixel, s, t);
+                    _data->set(x + s, y + t, layer, vsg::ubvec4(
+                        (std::uint8_t)(glm::clamp(pixel.r, 0.0f, 1.0f) * 255.0f),
+                        (std::uint8_t)(glm::clamp(pixel.g, 0.0f, 1.0f) * 255.0f),
+                        (std::uint8_t)(glm::clamp(pixel.b, 0.0f, 1.0f) * 255.0f),
+                        (std::uint8_t)(glm::clamp(pixel.a, 0.0f, 1.0f) * 255.0f)));
+                }
+            }
+
+            // note, this re-transfers the whole atlas; additions usually
+            // arrive in bursts during load, so in practice the uploads
+            // coalesce into a few frames.
+            _data->dirty();
+
+            Placement placement;
+            placement.uvrect = vsg::vec4(
+                (float)x / (float)_data->width(),
+                (float)y / (float)_data->height(),
+                (float)image->width() / (float)_data->width(),
+                (float)image->height() / (float)_data->height());
+            placement.layer = (int)layer;
+
+            return _placements[image] = placement;
+        }
+    }
+
+    Log()->warn(LC "Atlas is full; image skipped");
+    return _placements[image] = {};
+}
@@ -0,0 +1,74 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/Common.h>
+#include <rocky/Image.h>
+
+#include <vsg/core/Array3D.h>
+#include <vsg/state/ImageInfo.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Runtime texture atlas with automatic shelf packing.
+    *
+    * Images are packed into the layers of an RGBA8 2D-array texture as
+    * they arrive, so a renderer can bind the atlas once and draw any mix
+    * of symbols in a single batch; when a layer fills up, packing spills
+    * into the next one. Each placement reports the UV sub-rectangle and
+    * layer to sample. Entries are deduplicated by image, so styles that
+    * share a symbol share its pixels.
+    */
+    class ROCKY_EXPORT TextureAtlas
+    {
+    public:
+        //! Construct an atlas with the given per-layer dimensions and
+        //! layer count. The texture memory is allocated up front.
+        TextureAtlas(unsigned width = 1024, unsigned height = 1024, unsigned layers = 4);
+
+        //! Where an image landed in the atlas.
+        struct Placement
+        {
+            vsg::vec4 uvrect = { 0.0f, 0.0f, 1.0f, 1.0f }; // x,y = UV offset; z,w = UV scale
+            int layer = -1;
+
+            bool valid() const { return layer >= 0; }
+        };
+
+        //! Place an image in the atlas, or find its existing placement.
+        //! Thread-safe. Returns an invalid placement if the image is null,
+        //! too large for a layer, or the atlas is full.
+        Placement getOrAdd(std::shared_ptr<Image> image);
+
+        //! The atlas texture: dynamic RGBA8 2D-array data with a shared
+        //! non-mipmapped sampler (mipmapping an atlas would bleed between
+        //! neighboring entries). Bind this once, renderer-wide.
+        vsg::ref_ptr<vsg::ImageInfo> imageInfo;
+
+    private:
+        // a shelf is a row of entries sharing a vertical extent:
+        struct Shelf
+        {
+            unsigned y, height;
+            unsigned next_x = 0;
+        };
+
+        struct Layer
+        {
+            std::vector<Shelf> shelves;
+            unsigned next_y = 0;
+        };
+
+        vsg::ref_ptr<vsg::ubvec4Array3D> _data;
+        std::vector<Layer> _layers;
+        std::unordered_map<std::shared_ptr<Image>, Placement> _placements;
+        mutable std::mutex _mutex;
+    };
+}
@@ -0,0 +1,180 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "TextureCompression.h"
+
+#include <vsg/core/Array2D.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    inline std::uint16_t to565(const std::uint8_t* c)
+    {
+        return (std::uint16_t)(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+    }
+
+    // Encodes one 4x4 block of pixels as a BC1 color block (8 bytes).
+    // Range fit: the endpoints are the channel-wise bounding box of the
+    // block and each pixel picks the nearest of the four palette entries
+    // along that axis.
+    void encodeBC1(const std::uint8_t* px[16], std::uint8_t* out)
+    {
+        std::uint8_t minc[3] = { 255, 255, 255 };
+        std::uint8_t maxc[3] = { 0, 0, 0 };
+
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                minc[c] = std::min(minc[c], px[i][c]);
+                maxc[c] = std::max(maxc[c], px[i][c]);
+            }
+        }
+
+        // c0 >= c1 selects the opaque 4-color mode.
+        std::uint16_t c0 = to565(maxc);
+        std::uint16_t c1 = to565(minc);
+
+        std::uint32_t indices = 0;
+
+        if (c0 != c1)
+        {
+            int dr = (int)maxc[0] - (int)minc[0];
+            int dg = (int)maxc[1] - (int)minc[1];
+            int db = (int)maxc[2] - (int)minc[2];
+            int len2 = dr * dr + dg * dg + db * db;
+
+            // palette order is c0, c1, 2/3*c0+1/3*c1, 1/3*c0+2/3*c1, so a
+            // pixel's rounded third along the axis maps to its index:
+            static const std::uint32_t remap[4] = { 1, 3, 2, 0 };
+
+            for (int i = 0; i < 16; ++i)
+            {
+                int dot =
+                    ((int)px[i][0] - (int)minc[0]) * dr +
+                    ((int)px[i][1] - (int)minc[1]) * dg +
+                    ((int)px[i][2] - (int)minc[2]) * db;
+
+                int t = (dot * 3 + (len2 >> 1)) / len2;
+                indices |= remap[t] << (2 * i);
+            }
+        }
+
+        out[0] = (std::uint8_t)(c0 & 0xff);
+        out[1] = (std::uint8_t)(c0 >> 8);
+        out[2] = (std::uint8_t)(c1 & 0xff);
+        out[3] = (std::uint8_t)(c1 >> 8);
+        out[4] = (std::uint8_t)(indices & 0xff);
+        out[5] = (std::uint8_t)((indices >> 8) & 0xff);
+        out[6] = (std::uint8_t)((indices >> 16) & 0xff);
+        out[7] = (std::uint8_t)((indices >> 24) & 0xff);
+    }
+
+    // Encodes the alpha channel of one 4x4 block as a BC3/BC4 alpha
+    // block (8 bytes), using the 8-value interpolated mode.
+    void encodeBC3Alpha(const std::uint8_t* px[16], std::uint8_t* out)
+    {
+        std::uint8_t amin = 255, amax = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            amin = std::min(amin, px[i][3]);
+            amax = std::max(amax, px[i][3]);
+        }
+
+        out[0] = amax;
+        out[1] = amin;
+
+        // palette is a0, a1, then six interpolants descending from a0 to
+        // a1; a pixel's rounded seventh q along the range lands on entry
+        // 8-q (with q=7 -> a0 and q=0 -> a1).
+        int range = (int)amax - (int)amin;
+
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            int q = range > 0 ?
+                (((int)px[i][3] - (int)amin) * 7 + (range >> 1)) / range : 7;
+
+            std::uint64_t index = q == 7 ? 0 : q == 0 ? 1 : (std::uint64_t)(8 - q);
+            bits |= index << (3 * i);
+        }
+
+        for (int b = 0; b < 6; ++b)
+            out[2 + b] = (std::uint8_t)((bits >> (8 * b)) & 0xff);
+    }
+}
+
+vsg::ref_ptr<vsg::Data>
+util::compressImageToBC(std::shared_ptr<Image> image)
+{
+    if (!image || image->depth() > 1)
+        return {};
+
+    auto format = image->pixelFormat();
+    if (format != Image::R8G8B8_UNORM && format != Image::R8G8B8A8_UNORM)
+        return {};
+
+    unsigned width = image->width();
+    unsigned height = image->height();
+    if (width < 4 || height < 4 || (width % 4) != 0 || (height % 4) != 0)
+        return {};
+
+    const bool alpha = (format == Image::R8G8B8A8_UNORM);
+    const unsigned stride = alpha ? 4u : 3u;
+    const unsigned blocksWide = width / 4;
+    const unsigned blocksHigh = height / 4;
+
+    const std::uint8_t* pixels = image->data<std::uint8_t>();
+
+    vsg::Data::Properties props;
+    props.format = alpha ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+    props.blockWidth = 4;
+    props.blockHeight = 4;
+    props.origin = vsg::TOP_LEFT;
+    props.maxNumMipmaps = 1;
+
+    vsg::ref_ptr<vsg::Data> data;
+    if (alpha)
+        data = vsg::block128Array2D::create(blocksWide, blocksHigh, props);
+    else
+        data = vsg::block64Array2D::create(blocksWide, blocksHigh, props);
+
+    auto* out = reinterpret_cast<std::uint8_t*>(data->dataPointer());
+
+    const std::uint8_t* px[16];
+
+    for (unsigned by = 0; by < blocksHigh; ++by)
+    {
+        for (unsigned bx = 0; bx < blocksWide; ++bx)
+        {
+            for (unsigned row = 0; row < 4; ++row)
+            {
+                const std::uint8_t* scanline = pixels +
+                    ((std::size_t)(by * 4 + row) * width + bx * 4) * stride;
+
+                for (unsigned col = 0; col < 4; ++col)
+                    px[row * 4 + col] = scanline + col * stride;
+            }
+
+            if (alpha)
+            {
+                encodeBC3Alpha(px, out);
+                encodeBC1(px, out + 8);
+                out += 16;
+            }
+            else
+            {
+                encodeBC1(px, out);
+                out += 8;
+            }
+        }
+    }
+
+    return data;
+}
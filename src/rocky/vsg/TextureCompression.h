@@ -0,0 +1,28 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/Common.h>
+#include <rocky/Image.h>
+#include <vsg/core/Data.h>
+#include <memory>
+
+namespace ROCKY_NAMESPACE
+{
+    namespace util
+    {
+        //! Compresses an 8-bit RGB(A) image into a BC-compressed VSG data
+        //! object ready for GPU upload: BC1 for RGB, BC3 for RGBA. That is
+        //! a quarter of the device memory and transfer bandwidth of an
+        //! uncompressed RGBA8 upload. The encoder is a fast range-fit
+        //! meant to run on the tile load job, not an exhaustive one.
+        //! Returns nullptr if the image is not compressible (wrong pixel
+        //! format, 3D, or dimensions not multiples of 4); the caller
+        //! should then fall back to the uncompressed upload path.
+        extern ROCKY_EXPORT vsg::ref_ptr<vsg::Data> compressImageToBC(
+            std::shared_ptr<Image> image);
+    }
+}
@@ -0,0 +1,162 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "TilePrefetcher.h"
+#include "MapNode.h"
+#include "terrain/TerrainNode.h"
+#include "terrain/TerrainEngine.h"
+#include <rocky/Map.h>
+#include <rocky/ImageLayer.h>
+#include <rocky/ElevationLayer.h>
+
+using namespace ROCKY_NAMESPACE;
+
+void
+TilePrefetcher::update(vsg::ref_ptr<MapNode> mapNode, const Viewpoint& vp, const vsg::time_point& now, VSGContext& context)
+{
+    if (lookAheadSeconds <= 0.0f || !mapNode || !mapNode->map || !vp.valid())
+        return;
+
+    auto& profile = mapNode->profile;
+    if (!profile.valid())
+        return;
+
+    // the focal point in the map profile's SRS:
+    GeoPoint position = vp.position().transform(profile.srs());
+    if (!position.valid())
+        return;
+
+    if (!_hasPrevious)
+    {
+        _previousPosition = position;
+        _previousTime = now;
+        _hasPrevious = true;
+        return;
+    }
+
+    double dt = std::chrono::duration<double>(now - _previousTime).count();
+    if (dt <= 0.0)
+        return;
+
+    // focal point velocity, in profile units per second:
+    double vx = (position.x - _previousPosition.x) / dt;
+    double vy = (position.y - _previousPosition.y) / dt;
+
+    _previousPosition = position;
+    _previousTime = now;
+
+    if (vx == 0.0 && vy == 0.0)
+        return;
+
+    // where will the focal point be in lookAheadSeconds?
+    GeoPoint predicted(profile.srs(),
+        position.x + vx * lookAheadSeconds,
+        position.y + vy * lookAheadSeconds,
+        position.z);
+
+    // Estimate the LOD the pager will want at the current range, treating
+    // the viewing range as (roughly) the on-screen ground width:
+    const auto& settings = mapNode->terrainSettings();
+
+    double range = std::max(1.0, vp.range->as(Units::METERS));
+    double resolution = range / 1024.0; // ~meters per pixel
+    if (profile.srs().isGeodetic())
+        resolution /= 111320.0; // meters to degrees at the equator
+
+    unsigned level = profile.getLevelOfDetailForHorizResolution(resolution, settings.tileSize);
+    level = util::clamp(level, settings.minLevelOfDetail.value(), settings.maxLevelOfDetail.value());
+
+    TileKey centerKey = TileKey::createTileKeyContainingPoint(predicted, level, profile);
+    if (!centerKey.valid())
+        return;
+
+    // the predicted tile plus its ring of neighbors:
+    std::vector<TileKey> keys;
+    keys.reserve(9);
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            TileKey key = centerKey.createNeighborKey(dx, dy);
+            if (key.valid())
+                keys.push_back(key);
+        }
+    }
+
+    // Prefetch jobs run on the terrain loader pool, but at a priority far
+    // below any real tile load, so they only consume loader threads that
+    // would otherwise sit idle.
+    auto low_priority = []() { return -FLT_MAX / 2.0f; };
+
+    std::string poolName = (mapNode->terrainNode && mapNode->terrainNode->engine) ?
+        mapNode->terrainNode->engine->loadSchedulerName :
+        "rocky::terrain_loader";
+
+    IOOptions io = context->io;
+
+    // gather the whole sweep and submit it as one batch, so we pay the
+    // scheduler lock and worker wakeup once instead of per key:
+    std::vector<std::function<void()>> batch;
+
+    for (auto& layer : mapNode->map->layers().ofType<ImageLayer>())
+    {
+        if (!layer->isOpen())
+            continue;
+
+        for (auto& key : keys)
+        {
+            if (!layer->mayHaveData(key))
+                continue;
+
+            // skip anything we queued recently:
+            std::string id = std::to_string(layer->uid()) + '/' + key.str();
+            if (_recentlyQueued.get(id))
+                continue;
+            _recentlyQueued.put(id, true);
+
+            batch.emplace_back([layer, key, io]()
+                {
+                    // the result is discarded; this read exists to warm
+                    // the memory and disk caches for the pager.
+                    layer->createImage(key, io);
+                });
+        }
+    }
+
+    for (auto& layer : mapNode->map->layers().ofType<ElevationLayer>())
+    {
+        if (!layer->isOpen())
+            continue;
+
+        for (auto& key : keys)
+        {
+            if (!layer->mayHaveData(key))
+                continue;
+
+            std::string id = std::to_string(layer->uid()) + '/' + key.str();
+            if (_recentlyQueued.get(id))
+                continue;
+            _recentlyQueued.put(id, true);
+
+            batch.emplace_back([layer, key, io]()
+                {
+                    layer->createHeightfield(key, io);
+                });
+        }
+    }
+
+    if (!batch.empty())
+    {
+        jobs::dispatch_batch(
+            std::move(batch),
+            jobs::context{
+                "prefetch batch",
+                jobs::get_pool(poolName),
+                low_priority,
+                nullptr,
+                false
+            });
+    }
+}
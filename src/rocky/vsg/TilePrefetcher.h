@@ -0,0 +1,57 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/VSGContext.h>
+#include <rocky/Viewpoint.h>
+#include <rocky/GeoPoint.h>
+#include <rocky/LRUCache.h>
+#include <vsg/ui/UIEvent.h>
+
+namespace ROCKY_NAMESPACE
+{
+    class MapNode;
+
+    /**
+    * Predictive tile prefetcher.
+    *
+    * Extrapolates the motion of the camera's focal point from frame to
+    * frame and issues low-priority background fetches for the tiles it
+    * expects to enter the view shortly, warming the IO caches so that
+    * fast pans and scripted flyovers hit warm data instead of waiting
+    * on the network.
+    */
+    class ROCKY_EXPORT TilePrefetcher
+    {
+    public:
+        //! How far ahead (in seconds) to extrapolate the camera's motion.
+        //! Set to zero to disable prefetching.
+        float lookAheadSeconds = 2.0f;
+
+        //! Construct a prefetcher.
+        TilePrefetcher() = default;
+
+        //! Call once per frame when the camera moves. Measures the focal
+        //! point's velocity against the previous call and dispatches
+        //! background fetches for the predicted tile neighborhood. The
+        //! fetches run at a priority below any actual tile load, so they
+        //! only consume otherwise-idle loader threads.
+        void update(
+            vsg::ref_ptr<MapNode> mapNode,
+            const Viewpoint& vp,
+            const vsg::time_point& now,
+            VSGContext& context);
+
+    private:
+        GeoPoint _previousPosition;
+        vsg::time_point _previousTime;
+        bool _hasPrevious = false;
+
+        // keys already dispatched recently, so a steady pan doesn't queue
+        // the same tiles frame after frame:
+        util::LRUCache<std::string, bool> _recentlyQueued{ 256 };
+    };
+}
@@ -0,0 +1,563 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "TilesetNode.h"
+#include "Utils.h"
+
+#include <rocky/json.h>
+#include <rocky/Log.h>
+#include <rocky/Math.h>
+#include <rocky/SRS.h>
+
+#include <vsg/io/read.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/vk/State.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <sstream>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[TilesetNode] "
+
+namespace
+{
+    // rotates glTF content (y-up) into the 3D Tiles z-up world frame
+    const vsg::dmat4 Y_UP_TO_Z_UP(
+        1, 0, 0, 0,
+        0, 0, 1, 0,
+        0, -1, 0, 0,
+        0, 0, 0, 1);
+
+    inline std::uint32_t read_u32(const char* p)
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    // transforms a direction (w=0) by a matrix
+    inline vsg::dvec3 xformVector(const vsg::dmat4& m, const vsg::dvec3& v)
+    {
+        auto r = m * vsg::dvec4(v.x, v.y, v.z, 0.0);
+        return { r.x, r.y, r.z };
+    }
+
+    // world-space bounding sphere for a tile's boundingVolume object
+    vsg::dsphere parseBoundingVolume(const json& j, const vsg::dmat4& transform)
+    {
+        vsg::dsphere result;
+
+        if (j.contains("sphere") && j["sphere"].size() == 4)
+        {
+            auto& s = j["sphere"];
+            vsg::dvec3 center(s[0].get<double>(), s[1].get<double>(), s[2].get<double>());
+
+            // scale the radius by the longest basis vector, in case the
+            // transform is not rigid:
+            double scale = std::max(
+                vsg::length(xformVector(transform, { 1, 0, 0 })), std::max(
+                vsg::length(xformVector(transform, { 0, 1, 0 })),
+                vsg::length(xformVector(transform, { 0, 0, 1 }))));
+
+            result.set(transform * center, s[3].get<double>() * scale);
+        }
+
+        else if (j.contains("box") && j["box"].size() == 12)
+        {
+            auto& b = j["box"];
+            auto value = [&](int i) { return b[i].get<double>(); };
+
+            vsg::dvec3 center(value(0), value(1), value(2));
+
+            // sum of the transformed half-axis lengths circumscribes
+            // every corner:
+            double radius =
+                vsg::length(xformVector(transform, { value(3), value(4), value(5) })) +
+                vsg::length(xformVector(transform, { value(6), value(7), value(8) })) +
+                vsg::length(xformVector(transform, { value(9), value(10), value(11) }));
+
+            result.set(transform * center, radius);
+        }
+
+        else if (j.contains("region") && j["region"].size() == 6)
+        {
+            // regions are always geodetic (radians); the tile transform
+            // does not apply:
+            auto& r = j["region"];
+            double west = util::rad2deg(r[0].get<double>()), south = util::rad2deg(r[1].get<double>());
+            double east = util::rad2deg(r[2].get<double>()), north = util::rad2deg(r[3].get<double>());
+            double minh = r[4].get<double>(), maxh = r[5].get<double>();
+
+            auto xform = SRS::WGS84.to(SRS::ECEF);
+
+            vsg::dbox box;
+            for (int i = 0; i < 8; ++i)
+            {
+                double x = (i & 0x1) ? east : west;
+                double y = (i & 0x2) ? north : south;
+                double z = (i & 0x4) ? maxh : minh;
+                if (xform.transform(x, y, z))
+                    box.add(vsg::dvec3(x, y, z));
+            }
+
+            vsg::dvec3 center = (box.min + box.max) * 0.5;
+            result.set(center, vsg::length(box.max - center));
+        }
+
+        return result;
+    }
+
+    // recursively parses a tile and its subtiles from the tileset JSON
+    vsg::ref_ptr<TilesetTileNode> parseTile(
+        const json& j,
+        const vsg::dmat4& parentTransform,
+        const std::string& referrer,
+        TilesetNode* host,
+        bool parentAdditive)
+    {
+        auto tile = TilesetTileNode::create();
+        tile->host = host;
+
+        vsg::dmat4 local; // identity
+        if (j.contains("transform") && j["transform"].size() == 16)
+        {
+            // both 3D Tiles and vsg store matrices column-major:
+            auto& m = j["transform"];
+            double* out = local.data();
+            for (int i = 0; i < 16; ++i)
+                out[i] = m[i].get<double>();
+        }
+        tile->transform = parentTransform * local;
+
+        tile->geometricError = j.value("geometricError", 0.0);
+
+        // refine mode inherits from the parent when unspecified:
+        auto refine = j.value("refine", "");
+        tile->additiveRefine = refine.empty() ? parentAdditive : (refine == "ADD");
+
+        if (j.contains("boundingVolume"))
+            tile->bound = parseBoundingVolume(j["boundingVolume"], tile->transform);
+
+        if (j.contains("content"))
+        {
+            auto& content = j["content"];
+            auto location = content.value("uri", content.value("url", ""));
+            if (!location.empty())
+            {
+                tile->contentURI = URI(location, referrer);
+                tile->externalTileset = util::endsWith(location, ".json");
+            }
+        }
+
+        if (j.contains("children"))
+        {
+            for (auto& child : j["children"])
+            {
+                auto subtile = parseTile(child, tile->transform, referrer, host, tile->additiveRefine);
+                if (subtile)
+                    tile->subtiles.emplace_back(subtile);
+            }
+        }
+
+        return tile;
+    }
+
+    // parses a complete tileset document, returning its root tile
+    vsg::ref_ptr<TilesetTileNode> parseTileset(
+        const std::string& text,
+        const std::string& referrer,
+        TilesetNode* host,
+        const vsg::dmat4& baseTransform)
+    {
+        auto j = json::parse(text, nullptr, false);
+        if (j.is_discarded() || !j.contains("root"))
+            return {};
+
+        return parseTile(j["root"], baseTransform, referrer, host, false);
+    }
+
+    // Decodes a content payload (b3dm or glTF) into a ready-to-compile
+    // subgraph positioned by the tile transform.
+    vsg::ref_ptr<vsg::Node> decodeContent(
+        const std::string& data,
+        const URI& uri,
+        const vsg::dmat4& transform,
+        vsg::ref_ptr<const vsg::Options> readerWriterOptions)
+    {
+        std::size_t offset = 0;
+        vsg::dvec3 rtc(0.0, 0.0, 0.0);
+
+        if (data.size() >= 28 && data.compare(0, 4, "b3dm") == 0)
+        {
+            // 28-byte header, then the feature/batch tables, then glTF:
+            auto featureTableJSONLength = read_u32(data.data() + 12);
+            auto featureTableBinaryLength = read_u32(data.data() + 16);
+            auto batchTableJSONLength = read_u32(data.data() + 20);
+            auto batchTableBinaryLength = read_u32(data.data() + 24);
+
+            offset = 28ull + featureTableJSONLength + featureTableBinaryLength +
+                batchTableJSONLength + batchTableBinaryLength;
+
+            if (offset >= data.size())
+            {
+                Log()->warn(LC "malformed b3dm at {}", uri.full());
+                return {};
+            }
+
+            if (featureTableJSONLength > 0)
+            {
+                auto ft = json::parse(
+                    data.begin() + 28, data.begin() + 28 + featureTableJSONLength,
+                    nullptr, false);
+
+                if (!ft.is_discarded() && ft.contains("RTC_CENTER") && ft["RTC_CENTER"].size() == 3)
+                {
+                    rtc.set(
+                        ft["RTC_CENTER"][0].get<double>(),
+                        ft["RTC_CENTER"][1].get<double>(),
+                        ft["RTC_CENTER"][2].get<double>());
+                }
+            }
+        }
+        else if (data.size() >= 4 && (
+            data.compare(0, 4, "cmpt") == 0 ||
+            data.compare(0, 4, "i3dm") == 0 ||
+            data.compare(0, 4, "pnts") == 0))
+        {
+            Log()->warn(LC "unsupported content format '{}' at {}", data.substr(0, 4), uri.full());
+            return {};
+        }
+
+        auto options = vsg::Options::create(*readerWriterOptions);
+        options->extensionHint =
+            (data.size() >= offset + 4 && data.compare(offset, 4, "glTF") == 0) ?
+            ".glb" : ".gltf";
+
+        std::istringstream in(offset > 0 ? data.substr(offset) : data);
+        auto node = vsg::read_cast<vsg::Node>(in, options);
+        if (!node)
+        {
+            Log()->warn(LC "failed to decode content at {}", uri.full());
+            return {};
+        }
+
+        auto root = vsg::MatrixTransform::create(
+            transform * vsg::translate(rtc) * Y_UP_TO_Z_UP);
+        root->addChild(node);
+        return root;
+    }
+}
+
+
+void
+TilesetTileNode::accept(vsg::RecordTraversal& rv) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(host != nullptr, void());
+
+    auto* state = rv.getState();
+
+    // frustum cull against the world bounding sphere:
+    if (bound.radius > 0.0)
+    {
+        auto& frustum = state->_frustumStack.top();
+        for (int f = 0; f < POLYTOPE_SIZE; ++f)
+        {
+            if (vsg::distance(frustum.face[f], bound.center) < -bound.radius)
+                return;
+        }
+    }
+
+    auto d = distanceTo(bound.center, state);
+    lastTraversalRange = (float)d;
+
+    // Screen-space error, in pixels, of rendering this tile's own
+    // simplification from the current distance (the standard 3D Tiles
+    // formulation; proj[1][1] is cot(fovy/2)):
+    double sse = DBL_MAX;
+    double margin = std::max(1.0, d - bound.radius);
+    if (geometricError > 0.0)
+    {
+        auto& vp = state->_commandBuffer->viewDependentState->viewportData->at(0);
+        auto& proj = state->projectionMatrixStack.top();
+        sse = geometricError * (double)vp[3] * proj[1][1] / (2.0 * margin);
+    }
+    else
+    {
+        sse = 0.0; // leaf; never refines
+    }
+
+    bool refine = !subtiles.empty() && sse > (double)host->maxScreenSpaceError;
+
+    if (refine && subtilesReady())
+    {
+        for (auto& subtile : subtiles)
+            subtile->accept(rv);
+
+        // additive tilesets draw the coarse content under the fine:
+        if (content && additiveRefine)
+            content->accept(rv);
+    }
+    else
+    {
+        // draw this tile's own content (or request it):
+        if (content)
+            content->accept(rv);
+        else if (!contentURI.empty())
+            needsContent = true;
+
+        if (refine)
+        {
+            // keep drawing this tile while the subtiles stream in:
+            for (auto& subtile : subtiles)
+            {
+                if (!subtile->content && !subtile->contentURI.empty())
+                    subtile->needsContent = true;
+
+                host->ping(subtile.get(), rv);
+            }
+        }
+    }
+
+    host->ping(const_cast<TilesetTileNode*>(this), rv);
+}
+
+bool
+TilesetTileNode::subtilesReady() const
+{
+    for (auto& subtile : subtiles)
+    {
+        if (subtile->externalTileset)
+        {
+            if (subtile->subtiles.empty())
+                return false; // not yet expanded
+        }
+        else if (!subtile->contentURI.empty() && !subtile->content)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+Status
+TilesetNode::open(VSGContext context)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(context, Status(Status::AssertionFailure));
+
+    if (!uri.has_value())
+        return Status(Status::ConfigurationError, "missing required uri");
+
+    auto r = uri->read(context->io);
+    if (r.status.failed())
+        return r.status;
+
+    _root = parseTileset(r->data, uri->full(), this, {});
+    if (!_root)
+        return Status(Status::GeneralError, "invalid tileset at " + uri->full());
+
+    // the pool that will load and decode content payloads:
+    jobs::get_pool(loadSchedulerName, 0u)->set_concurrency(4u);
+
+    return StatusOK;
+}
+
+void
+TilesetNode::traverse(vsg::RecordTraversal& rv) const
+{
+    if (_root)
+        _root->accept(rv);
+
+    Inherit::traverse(rv);
+}
+
+void
+TilesetNode::ping(TilesetTileNode* tile, vsg::RecordTraversal& rv)
+{
+    std::scoped_lock lock(_mutex);
+
+    auto frame = (int)rv.getFrameStamp()->frameCount;
+    if (tile->lastPingFrame == frame)
+        return; // another view already pinged this tile this frame
+    tile->lastPingFrame = frame;
+
+    // content-bearing tiles participate in expiry; structural tiles and
+    // expanded external tilesets stay resident with the tree:
+    if (!tile->contentURI.empty() && !tile->externalTileset)
+    {
+        tile->trackerToken = _tracker.use(tile, tile->trackerToken, 1.0f);
+    }
+
+    if (tile->needsContent.exchange(false))
+    {
+        if (tile->contentLoader.empty() && !tile->content)
+        {
+            _needContent.push_back(tile);
+        }
+    }
+}
+
+void
+TilesetNode::requestContent(TilesetTileNode* tile, VSGContext& context)
+{
+    if (tile->contentLoader.working() || tile->contentLoader.available())
+        return;
+
+    auto uri = tile->contentURI;
+    auto transform = tile->transform;
+    bool external = tile->externalTileset;
+    const IOOptions io(context->io);
+    auto readerWriterOptions = context->readerWriterOptions;
+
+    // holding this reference keeps the whole structural tree (and the
+    // tile) alive for the life of the job:
+    vsg::ref_ptr<TilesetNode> host(this);
+
+    auto load = [uri, transform, external, io, readerWriterOptions, host](Cancelable& p)
+        -> vsg::ref_ptr<vsg::Node>
+    {
+        if (p.canceled())
+            return {};
+
+        auto r = uri.read(IOOptions(io, p));
+        if (r.status.failed())
+        {
+            Log()->warn(LC "failed to fetch {}: {}", uri.full(), r.status.message);
+            return {};
+        }
+
+        if (external)
+        {
+            // an external tileset expands into subtiles of this tile:
+            return parseTileset(r->data, uri.full(), host.get(), transform);
+        }
+
+        return decodeContent(r->data, uri, transform, readerWriterOptions);
+    };
+
+    // nearer tiles decode first:
+    vsg::observer_ptr<TilesetTileNode> tile_weak(tile);
+    auto priority_func = [tile_weak]() -> float
+    {
+        auto safe = tile_weak.ref_ptr();
+        return safe ? -safe->lastTraversalRange : -FLT_MAX;
+    };
+
+    jobs::context job_context{
+        "load " + uri.base(),
+        jobs::get_pool(loadSchedulerName),
+        priority_func,
+        nullptr };
+
+    tile->contentLoader = jobs::dispatch(load, job_context);
+}
+
+bool
+TilesetNode::update(VSGContext context)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(context, false);
+
+    bool changes = false;
+
+    // dispatch the content requests collected during record:
+    std::vector<TilesetTileNode*> requests;
+    {
+        std::scoped_lock lock(_mutex);
+        requests.swap(_needContent);
+    }
+
+    for (auto* tile : requests)
+    {
+        if (tile->contentLoader.empty() && !tile->content)
+        {
+            requestContent(tile, context);
+            _inFlight.push_back(tile);
+            changes = true;
+        }
+    }
+
+    // merge decoded content, a few tiles per frame:
+    unsigned merges = 0u;
+
+    for (auto it = _inFlight.begin(); it != _inFlight.end() && merges < maxMergesPerFrame; )
+    {
+        auto* tile = *it;
+        bool done = false;
+
+        if (tile->contentLoader.empty() && !tile->pendingContent)
+        {
+            done = true; // expired while in flight
+        }
+
+        if (tile->contentLoader.available() && !tile->pendingContent && tile->contentCompiler.empty())
+        {
+            auto node = tile->contentLoader.value();
+
+            if (!node)
+            {
+                done = true; // failed; the loader stays resolved so we don't retry every frame
+            }
+            else if (tile->externalTileset)
+            {
+                // splice the external tileset's root in as a subtile:
+                auto root = node->cast<TilesetTileNode>();
+                if (root)
+                    tile->subtiles.emplace_back(vsg::ref_ptr<TilesetTileNode>(root));
+                done = true;
+                changes = true;
+                ++merges;
+            }
+            else
+            {
+                // send it through the budgeted compile queue:
+                tile->pendingContent = node;
+                tile->contentCompiler = context->compile(node, CompileClass::ENTITY);
+                ++merges;
+            }
+        }
+
+        if (tile->pendingContent && tile->contentCompiler.available())
+        {
+            if (tile->contentCompiler.value())
+            {
+                tile->content = tile->pendingContent;
+                context->requestFrame();
+                changes = true;
+            }
+            tile->pendingContent = {};
+            done = true;
+            ++merges;
+        }
+
+        it = done ? _inFlight.erase(it) : it + 1;
+    }
+
+    // expire content the traversal stopped visiting:
+    const auto dispose = [&](TilesetTileNode* tile)
+    {
+        if (tile->content)
+        {
+            context->dispose(tile->content);
+            tile->content = {};
+        }
+        tile->contentLoader.reset();
+        tile->contentCompiler.reset();
+        tile->pendingContent = {};
+        tile->trackerToken = nullptr;
+        changes = true;
+        return true;
+    };
+
+    {
+        std::scoped_lock lock(_mutex);
+        constexpr unsigned maxExpirationsPerFrame = 64u;
+        _tracker.flushWeighted(maxExpirationsPerFrame, dispose);
+    }
+
+    return changes;
+}
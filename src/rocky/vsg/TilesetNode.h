@@ -0,0 +1,139 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/VSGContext.h>
+#include <rocky/SentryTracker.h>
+#include <rocky/Status.h>
+#include <rocky/URI.h>
+#include <vsg/nodes/Group.h>
+
+#include <atomic>
+#include <cfloat>
+#include <mutex>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    class TilesetNode;
+
+    /**
+     * One tile in a 3D Tiles hierarchy. The structural tree (bounds,
+     * geometric errors, content URIs) parses up front and stays
+     * resident; only the content payloads page in and out.
+     */
+    class ROCKY_EXPORT TilesetTileNode : public vsg::Inherit<vsg::Group, TilesetTileNode>
+    {
+    public:
+        //! World-space bounding sphere of this tile
+        vsg::dsphere bound;
+
+        //! Error (in meters) of the tile's simplification of its subtree
+        double geometricError = 0.0;
+
+        //! Whether content renders alongside the subtiles (refine = ADD)
+        //! instead of being replaced by them
+        bool additiveRefine = false;
+
+        //! Location of the tile's content payload; empty for a
+        //! structural tile
+        URI contentURI;
+
+        //! Whether the content is an external tileset (.json) that
+        //! expands into subtiles instead of renderable content
+        bool externalTileset = false;
+
+        //! Cumulative tile transform (tileset to world)
+        vsg::dmat4 transform;
+
+        //! Subtiles, refined from this tile
+        std::vector<vsg::ref_ptr<TilesetTileNode>> subtiles;
+
+        //! Merged, compiled content payload (when resident)
+        vsg::ref_ptr<vsg::Node> content;
+
+        //! Record traversal with screen-space-error refinement
+        void accept(vsg::RecordTraversal&) const override;
+
+    public:
+        // the tileset node that pages this tile
+        TilesetNode* host = nullptr;
+
+        // paging state; see TilesetNode::update()
+        jobs::future<vsg::ref_ptr<vsg::Node>> contentLoader;
+        jobs::future<bool> contentCompiler;
+        vsg::ref_ptr<vsg::Node> pendingContent;
+        void* trackerToken = nullptr;
+        int lastPingFrame = -1;
+        mutable std::atomic<bool> needsContent = { false };
+        mutable std::atomic<float> lastTraversalRange = { FLT_MAX };
+
+    private:
+        // whether every subtile needed to replace this tile's content
+        // has its own content resident
+        bool subtilesReady() const;
+
+        friend class TilesetNode;
+    };
+
+    /**
+     * Renders a 3D Tiles tileset - streamed mesh content like
+     * photogrammetry cities - with the same paging discipline the
+     * terrain uses: screen-space-error refinement during the record
+     * traversal, content fetch and decode (b3dm or glTF) on the jobs
+     * pool, merges on the update thread, and a sentry tracker that
+     * expires content the traversal stops visiting.
+     *
+     * Add the node to the scene (e.g. under the MapNode), call open()
+     * once, and call update() once per frame on the update thread.
+     */
+    class ROCKY_EXPORT TilesetNode : public vsg::Inherit<vsg::Group, TilesetNode>
+    {
+    public:
+        //! Construct an (unopened) tileset node
+        TilesetNode() = default;
+
+        //! Location of the root tileset.json
+        option<URI> uri;
+
+        //! Refinement threshold, in pixels of screen-space error.
+        //! Smaller = more detail resident.
+        float maxScreenSpaceError = 16.0f;
+
+        //! Name of the job pool that loads content
+        std::string loadSchedulerName = "rocky::tileset_loader";
+
+        //! Maximum content payloads merged per update() pass
+        unsigned maxMergesPerFrame = 8u;
+
+        //! Fetch and parse the root tileset.
+        Status open(VSGContext context);
+
+        //! Per-frame maintenance on the update thread: dispatches
+        //! content requests collected during the record traversal,
+        //! merges decoded content, and expires content that is no
+        //! longer being visited.
+        //! @return true if anything changed
+        bool update(VSGContext context);
+
+        void traverse(vsg::RecordTraversal&) const override;
+
+    public:
+        // called by TilesetTileNode during the record traversal
+        void ping(TilesetTileNode* tile, vsg::RecordTraversal& rv);
+
+    private:
+        vsg::ref_ptr<TilesetTileNode> _root;
+        util::SentryTracker<TilesetTileNode*> _tracker;
+        mutable std::mutex _mutex;
+        std::vector<TilesetTileNode*> _needContent;
+        std::vector<TilesetTileNode*> _inFlight;
+
+        void requestContent(TilesetTileNode* tile, VSGContext& context);
+
+        friend class TilesetTileNode;
+    };
+}
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <rocky/vsg/Common.h>
+#include <rocky/vsg/NativeImage.h>
 #include <rocky/Threading.h>
 #include <rocky/Image.h>
 #include <rocky/Math.h>
@@ -180,7 +181,96 @@ namespace ROCKY_NAMESPACE
 
             auto data = wrapImageData(image);
             data->properties.origin = vsg::TOP_LEFT;
-            data->properties.maxNumMipmaps = 1;
+            data->properties.maxNumMipmaps = image->mipLevels();
+
+            return data;
+        }
+
+        //! vsg array that shares ownership of a rocky Image's pixel buffer.
+        //! The Image stays alive for as long as VSG references the data, so
+        //! the buffer is never copied and the caller has no lifetime duties.
+        template<typename ArrayType>
+        class SharedImageArray : public vsg::Inherit<ArrayType, SharedImageArray<ArrayType>>
+        {
+        public:
+            template<typename... Args>
+            SharedImageArray(std::shared_ptr<Image> image, Args&&... args) :
+                vsg::Inherit<ArrayType, SharedImageArray<ArrayType>>(std::forward<Args>(args)...),
+                _image(image) { }
+
+        protected:
+            std::shared_ptr<Image> _image;
+        };
+
+        //! Returns a vsg::Data structure sharing ownership of an image's
+        //! pixel buffer with the image itself.
+        template<typename T>
+        vsg::ref_ptr<vsg::Data> share(std::shared_ptr<Image> image, VkFormat format)
+        {
+            vsg::Data::Properties props;
+            props.format = format;
+
+            // the adapter holds a reference to the Image, and the Image owns
+            // the buffer; vsg must never try to free it.
+            props.allocatorType = vsg::ALLOCATOR_TYPE_NO_DELETE;
+
+            if (image->depth() == 1)
+            {
+                return SharedImageArray<vsg::Array2D<T>>::create(
+                    image, image->width(), image->height(), image->data<T>(), props);
+            }
+            else
+            {
+                return SharedImageArray<vsg::Array3D<T>>::create(
+                    image, image->width(), image->height(), image->depth(), image->data<T>(), props);
+            }
+        }
+
+        //! Wraps a rocky Image object in a VSG Data object that shares
+        //! ownership of the pixel buffer with the image.
+        inline vsg::ref_ptr<vsg::Data> shareImageData(std::shared_ptr<Image> image)
+        {
+            if (!image) return { };
+
+            switch (image->pixelFormat())
+            {
+            case Image::R8_UNORM:
+                return share<unsigned char>(image, VK_FORMAT_R8_UNORM);
+                break;
+            case Image::R8G8_UNORM:
+                return share<vsg::ubvec2>(image, VK_FORMAT_R8G8_UNORM);
+                break;
+            case Image::R8G8B8_UNORM:
+                return share<vsg::ubvec3>(image, VK_FORMAT_R8G8B8_UNORM);
+                break;
+            case Image::R8G8B8A8_UNORM:
+                return share<vsg::ubvec4>(image, VK_FORMAT_R8G8B8A8_UNORM);
+                break;
+            case Image::R16_UNORM:
+                return share<unsigned short>(image, VK_FORMAT_R16_UNORM);
+                break;
+            case Image::R32_SFLOAT:
+                return share<float>(image, VK_FORMAT_R32_SFLOAT);
+                break;
+            case Image::R64_SFLOAT:
+                return share<double>(image, VK_FORMAT_R64_SFLOAT);
+                break;
+            };
+
+            return { };
+        }
+
+        //! Hands a rocky Image off to VSG without copying its pixel buffer.
+        //! The Image remains valid, and the buffer is freed only when both
+        //! sides are done with it.
+        inline vsg::ref_ptr<vsg::Data> shareImageToVSG(std::shared_ptr<Image> image)
+        {
+            if (!image)
+                return {};
+
+            auto data = shareImageData(image);
+            data->properties.origin = vsg::TOP_LEFT;
+            data->properties.maxNumMipmaps = image->mipLevels();
 
             return data;
         }
@@ -265,9 +355,12 @@ namespace ROCKY_NAMESPACE
             if (!image)
                 return {};
 
+            // NB: read this before moveImageData() invalidates the image
+            auto mipLevels = image->mipLevels();
+
             auto data = moveImageData(image);
             data->properties.origin = vsg::TOP_LEFT;
-            data->properties.maxNumMipmaps = 1;
+            data->properties.maxNumMipmaps = mipLevels;
 
             return data;
         }
@@ -293,6 +386,16 @@ namespace ROCKY_NAMESPACE
 
             if (format == Image::UNDEFINED)
             {
+                // Block-compressed data (e.g. a KTX2 payload that its
+                // readerwriter transcoded to a BC or ASTC format) has no
+                // rocky pixel format. Pass it through as a NativeImage so
+                // it uploads as-is instead of failing the read.
+                if (data->properties.blockWidth > 1)
+                {
+                    std::shared_ptr<Image> image = NativeImage::create(data);
+                    return Result(image);
+                }
+
                 return Status(Status::ResourceUnavailable, "Unsupported image format");
             }
 
@@ -7,9 +7,11 @@
 #include "MapNode.h"
 #include "Utils.h"
 #include <rocky/Image.h>
+#include <rocky/PipelineMetrics.h>
 #include <rocky/URI.h>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <iterator>
 
 ROCKY_ABOUT(vulkanscenegraph, VSG_VERSION_STRING)
 
@@ -26,6 +28,11 @@ using namespace ROCKY_NAMESPACE;
 
 namespace
 {
+    // Cache-file suffix for persisted shader sets. Bump the revision
+    // whenever a shader interface changes (descriptor sets/bindings,
+    // push constants) so stale entries from older builds are ignored.
+    const char* SHADER_CACHE_SUFFIX = ".r2.vsgb";
+
     // custom VSG logger that redirects to spdlog.
     class VSG_to_Spdlog_Logger : public Inherit<vsg::Logger, VSG_to_Spdlog_Logger>
     {
@@ -291,6 +298,8 @@ VSGContextImpl::ctor(int& argc, char** argv)
 
     shaderCompileSettings = vsg::ShaderCompileSettings::create();
 
+    materials = MaterialTable::create();
+
     _priorityUpdateQueue = PriorityUpdateQueue::create();
 
     // initialize the deferred deletion collection.
@@ -359,6 +368,10 @@ VSGContextImpl::ctor(int& argc, char** argv)
         Log()->warn("Cannot load font \"" + font_file + "\"");
     }
 
+    // optional on-disk shader cache; compiled shader sets persist here
+    // so subsequent runs skip shader compilation at startup:
+    shaderCachePath = util::getEnvVar("ROCKY_SHADER_CACHE_PATH");
+
     // establish search paths for shaders and data:
     auto vsgPaths = vsg::getEnvPaths("VSG_FILE_PATH");
     searchPaths.insert(searchPaths.end(), vsgPaths.begin(), vsgPaths.end());
@@ -418,6 +431,8 @@ VSGContextImpl::ctor(int& argc, char** argv)
         { "image/gif", ".gif" },
         { "image/jpg", ".jpg" },
         { "image/jpeg", ".jpg" },
+        { "image/ktx", ".ktx" },
+        { "image/ktx2", ".ktx2" },
         { "image/png", ".png" },
         { "image/tga", ".tga" },
         { "image/tif", ".tif" },
@@ -430,6 +445,24 @@ VSGContextImpl::ctor(int& argc, char** argv)
     // extension in the options structure as a hint.
     io.services.readImageFromStream = [options(readerWriterOptions)](std::istream& location, std::string contentType, const rocky::IOOptions& io) -> Result<std::shared_ptr<Image>>
         {
+            util::PipelineMetrics::Scoped pm(util::PipelineMetrics::DECODE);
+
+            // a registered codec (e.g. a turbo-class decoder) takes
+            // precedence over the readerwriter search. Codecs decode from
+            // memory, so slurp the stream; it is an in-memory buffer on
+            // every tile path that gets here.
+            if (auto* codec = io.services.imageCodec(contentType))
+            {
+                std::string data(std::istreambuf_iterator<char>(location), {});
+                auto result = (*codec)(data.data(), data.size(), io);
+                if (result.status.ok())
+                    return result;
+
+                // codec declined; fall through to the default readers.
+                location.clear();
+                location.seekg(0);
+            }
+
             // try the mime-type mapping:
             auto i = ext_for_mime_type.find(contentType);
             if (i != ext_for_mime_type.end())
@@ -462,6 +495,17 @@ VSGContextImpl::ctor(int& argc, char** argv)
             auto decudedContentType = deduceContentTypeFromStream(location);
             if (!decudedContentType.empty())
             {
+                if (auto* codec = io.services.imageCodec(decudedContentType))
+                {
+                    std::string data(std::istreambuf_iterator<char>(location), {});
+                    auto result = (*codec)(data.data(), data.size(), io);
+                    if (result.status.ok())
+                        return result;
+
+                    location.clear();
+                    location.seekg(0);
+                }
+
                 auto i = ext_for_mime_type.find(decudedContentType);
                 if (i != ext_for_mime_type.end())
                 {
@@ -479,9 +523,26 @@ VSGContextImpl::ctor(int& argc, char** argv)
             return Status(Status::ServiceUnavailable, "No image reader for \"" + contentType + "\"");
         };
 
-    io.services.contentCache = std::make_shared<ContentCache>(128);
+    // budget the content cache in bytes, since entry sizes vary wildly:
+    io.services.contentCache = std::make_shared<ContentCache>(32 * 1024 * 1024);
+    io.services.contentCache->sizeOf = [](const Result<Content>& r)
+        {
+            return sizeof(Result<Content>) +
+                (r.status.ok() ? r.value.contentType.size() + r.value.data.size() : 0);
+        };
+
+    // let the memory governor shed cached content under memory pressure:
+    auto contentCache = io.services.contentCache;
+    _contentCacheMemoryReg = memory.add(
+        "URI content cache",
+        [contentCache]() { return contentCache->size(); },
+        [contentCache](float pressure) { contentCache->shrink(pressure); });
+
+    _contentCacheTelemetryReg = contentCache->telemetry("URI content cache");
 
     io.uriGate = std::make_shared<util::Gate<std::string>>();
+
+    io.uriRequests = std::make_shared<util::Coalescer<std::string, IOResult<Content>>>();
 }
 
 vsg::ref_ptr<vsg::Device>
@@ -551,6 +612,73 @@ VSGContextImpl::compile(vsg::ref_ptr<vsg::Object> compilable)
     }
 }
 
+jobs::future<bool>
+VSGContextImpl::compile(vsg::ref_ptr<vsg::Object> compilable, CompileClass compileClass)
+{
+    jobs::future<bool> result;
+
+    ROCKY_SOFT_ASSERT_AND_RETURN(compilable.valid(), result);
+
+    {
+        std::unique_lock lock(_compileQueueMutex);
+        _compileQueues[(int)compileClass].emplace_back(QueuedCompile{ compilable, result });
+    }
+
+    // wake the frame loop so the queue gets serviced:
+    requestFrame();
+
+    return result;
+}
+
+void
+VSGContextImpl::serviceCompileQueue()
+{
+    auto start = std::chrono::steady_clock::now();
+    bool more = false;
+
+    for (;;)
+    {
+        QueuedCompile next;
+
+        {
+            std::unique_lock lock(_compileQueueMutex);
+
+            // take the front of the highest-priority non-empty class:
+            for (auto& queue : _compileQueues)
+            {
+                if (!queue.empty())
+                {
+                    next = std::move(queue.front());
+                    queue.pop_front();
+                    break;
+                }
+            }
+        }
+
+        if (!next.object)
+            break; // queue is drained
+
+        compile(next.object);
+        next.result.resolve(true);
+
+        // stop once the budget is spent; anything left waits for the
+        // next frame. (at least one object compiles per pass.)
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ms >= (double)compileTimeBudgetMS)
+        {
+            std::unique_lock lock(_compileQueueMutex);
+            for (auto& queue : _compileQueues)
+                more = more || !queue.empty();
+            break;
+        }
+    }
+
+    if (more)
+    {
+        requestFrame();
+    }
+}
+
 void
 VSGContextImpl::dispose(vsg::ref_ptr<vsg::Object> object)
 {
@@ -577,19 +705,193 @@ VSGContextImpl::dirtyShaders()
     ++shaderSettingsRevision;
 }
 
+void
+VSGContextImpl::setLogDepthEnabled(bool value)
+{
+    if (value != logDepthEnabled())
+    {
+        if (value)
+            shaderCompileSettings->defines.insert("ROCKY_LOG_DEPTH");
+        else
+            shaderCompileSettings->defines.erase("ROCKY_LOG_DEPTH");
+
+        dirtyShaders();
+    }
+}
+
+bool
+VSGContextImpl::logDepthEnabled() const
+{
+    return shaderCompileSettings->defines.count("ROCKY_LOG_DEPTH") > 0;
+}
+
+vsg::ref_ptr<vsg::ShaderSet>
+VSGContextImpl::getOrCreateShaderSet(const std::string& name, std::function<vsg::ref_ptr<vsg::ShaderSet>()> create)
+{
+    std::unique_lock lock(_shaderSetCacheMutex);
+
+    auto iter = _shaderSetCache.find(name);
+    if (iter != _shaderSetCache.end())
+    {
+        return iter->second;
+    }
+
+    vsg::ref_ptr<vsg::ShaderSet> shaderSet;
+
+    // try the on-disk cache first; a set saved there already carries the
+    // SPIR-V compiled on a previous run, so loading it skips GLSL
+    // compilation entirely.
+    if (!shaderCachePath.empty())
+    {
+        auto path = std::filesystem::path(shaderCachePath) / (name + SHADER_CACHE_SUFFIX);
+        if (std::filesystem::exists(path))
+        {
+            shaderSet = vsg::read_cast<vsg::ShaderSet>(vsg::Path(path.generic_string()), readerWriterOptions);
+            if (!shaderSet)
+            {
+                Log()->warn("Ignoring unreadable shader cache entry \"{}\"", path.string());
+            }
+        }
+    }
+
+    if (!shaderSet && create)
+    {
+        shaderSet = create();
+    }
+
+    if (shaderSet)
+    {
+        _shaderSetCache[name] = shaderSet;
+    }
+
+    return shaderSet;
+}
+
+void
+VSGContextImpl::saveShaderCache()
+{
+    if (shaderCachePath.empty())
+        return;
+
+    std::unique_lock lock(_shaderSetCacheMutex);
+
+    std::error_code ec;
+    std::filesystem::create_directories(shaderCachePath, ec);
+
+    for (auto& [name, shaderSet] : _shaderSetCache)
+    {
+        auto path = std::filesystem::path(shaderCachePath) / (name + SHADER_CACHE_SUFFIX);
+        if (!vsg::write(shaderSet, vsg::Path(path.generic_string()), readerWriterOptions))
+        {
+            Log()->warn("Failed to write shader cache entry \"{}\"", path.string());
+        }
+    }
+}
+
 void
 VSGContextImpl::requestFrame()
 {
     ++renderRequests;
 }
 
+void
+VSGContextImpl::governJobPools()
+{
+    // the time between update passes approximates the frame time.
+    auto now = std::chrono::steady_clock::now();
+    if (_lastUpdateTime.time_since_epoch().count() == 0)
+    {
+        _lastUpdateTime = now;
+        return;
+    }
+    double ms = std::chrono::duration<double, std::milli>(now - _lastUpdateTime).count();
+    _lastUpdateTime = now;
+
+    // ignore pathological stalls (window drags, breakpoints, suspends)
+    if (ms > 1000.0)
+        return;
+
+    // an exponential moving average smooths out single-frame spikes:
+    _smoothedFrameTimeMS = _smoothedFrameTimeMS == 0.0 ?
+        ms :
+        _smoothedFrameTimeMS * 0.9 + ms * 0.1;
+
+    if (_governorCooldown > 0)
+        --_governorCooldown;
+
+    if (_smoothedFrameTimeMS > (double)frameTimeBudgetMS * 1.25 && _governorCooldown == 0)
+    {
+        // frames at risk: shed half the workers from every pool that
+        // still has more than one, remembering the configured size.
+        std::lock_guard<std::mutex> lock(jobs::instance()._pools_mutex);
+        for (auto pool : jobs::instance()._pools)
+        {
+            unsigned c = pool->concurrency();
+            if (c > 1)
+            {
+                if (_configuredConcurrency.find(pool) == _configuredConcurrency.end())
+                    _configuredConcurrency[pool] = c;
+
+                pool->set_concurrency(c / 2);
+            }
+        }
+
+        // let the change take effect before acting again:
+        _governorCooldown = 30;
+        _recoveryStreak = 0;
+    }
+    else if (_smoothedFrameTimeMS < (double)frameTimeBudgetMS * 0.9 && !_configuredConcurrency.empty())
+    {
+        // frames healthy: after a sustained stretch, win workers back
+        // one doubling at a time up to the configured size.
+        if (++_recoveryStreak >= 60)
+        {
+            std::lock_guard<std::mutex> lock(jobs::instance()._pools_mutex);
+            for (auto iter = _configuredConcurrency.begin(); iter != _configuredConcurrency.end(); )
+            {
+                auto pool = iter->first;
+                unsigned next = std::min(iter->second, pool->concurrency() * 2);
+                pool->set_concurrency(next);
+
+                if (next >= iter->second)
+                    iter = _configuredConcurrency.erase(iter);
+                else
+                    ++iter;
+            }
+            _recoveryStreak = 0;
+        }
+    }
+    else
+    {
+        _recoveryStreak = 0;
+    }
+}
+
 bool
 VSGContextImpl::update()
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(viewer.valid(), false, "Developer: failure to set VSGContext->viewer");
 
+    // adaptive concurrency: yield background workers when frames run long
+    if (adaptiveConcurrency)
+    {
+        governJobPools();
+    }
+
+    // apply eviction pressure to registered caches when the process
+    // approaches its memory budget (no-op when no budget is set)
+    memory.update();
+
+    // likewise for device memory, against the driver-reported heap
+    // budgets (no-op without VK_EXT_memory_budget)
+    gpuMemory.update(device());
+
     bool updates_occurred = false;
 
+    // service the prioritized compile queue under its frame budget; any
+    // results land in _compileResult and integrate just below.
+    serviceCompileQueue();
+
     if (_compileResult)
     {
         std::unique_lock lock(_compileMutex);
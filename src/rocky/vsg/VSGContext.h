@@ -6,14 +6,31 @@
 #pragma once
 #include <rocky/Context.h>
 #include <rocky/vsg/Common.h>
+#include <rocky/vsg/GPUMemoryGovernor.h>
+#include <rocky/vsg/GPUReadback.h>
+#include <rocky/vsg/MaterialTable.h>
 #include <vsg/all.h>
+#include <array>
+#include <chrono>
 #include <deque>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ROCKY_NAMESPACE
 {
     class MapNode;
 
+    //! Priority classes for the budgeted compile queue, serviced in
+    //! descending order of urgency
+    enum class CompileClass
+    {
+        TERRAIN = 0,   // visible terrain tiles
+        ENTITY = 1,    // ECS entity subgraphs
+        PREFETCH = 2,  // speculative or prefetched content
+        NUM_CLASSES = 3
+    };
+
     /**
      * Rocky runtime context to use with a VSG-based application.
      * Use VSGContextFactory::create to VSGContext instance.
@@ -61,10 +78,64 @@ namespace ROCKY_NAMESPACE
         //! poll this to see if it needs to regenerate its pipeline.
         Revision shaderSettingsRevision = 0;
 
+        //! Cascaded shadow-map resources, published by a ShadowMapNode when
+        //! one is installed (which must happen before the first frame).
+        //! When present, the terrain render state binds them and compiles
+        //! its pipeline with shadow sampling. shadowData holds the cascade
+        //! matrices and parameters; shadowMaps holds one depth map per
+        //! cascade. See ShadowMapNode.
+        vsg::ref_ptr<vsg::vec4Array> shadowData;
+        vsg::ImageInfoList shadowMaps;
+
         //! Custom vsg object disposer (optional)
         //! By default Runtime uses its own round-robin object disposer
         std::function<void(vsg::ref_ptr<vsg::Object>)> disposer;
 
+        //! When true, update() monitors the frame time and adaptively
+        //! throttles background job pool concurrency when frames run over
+        //! budget, so heavy paging yields to the render thread. Worker
+        //! counts restore automatically once the frame rate recovers.
+        bool adaptiveConcurrency = false;
+
+        //! Frame time budget, in milliseconds, for the adaptive concurrency
+        //! governor. Frames consistently over this budget cause the job
+        //! pools to shed workers; frames well under it win them back.
+        float frameTimeBudgetMS = 16.7f;
+
+        //! When true, GPUTimedGroup nodes issue Vulkan timestamp queries
+        //! around their subgraphs and publish per-subgraph GPU times to
+        //! gpuTimes. Safe to toggle at runtime. Also settable with
+        //! --gpu-profile, which additionally wraps the terrain, sky, and
+        //! each ECS render system in a timer.
+        bool gpuProfiling = false;
+
+        //! Latest available GPU time, in milliseconds, for each
+        //! instrumented subgraph, keyed by timer label. Results lag the
+        //! CPU by a few frames, since a query is harvested when its pool
+        //! recycles. Guarded by gpuTimesMutex; copy it out to chart or log.
+        std::map<std::string, float> gpuTimes;
+        mutable std::mutex gpuTimesMutex;
+
+        //! Device memory budget governor; the terrain registers its
+        //! textures and geometry here, and update() polls the driver's
+        //! heap budgets and applies eviction pressure as VRAM fills.
+        //! See GPUMemoryGovernor.
+        GPUMemoryGovernor gpuMemory;
+
+        //! Asynchronous GPU-to-CPU readback service. Captures (RTT
+        //! exports, screenshots) copy into a ring of staging buffers and
+        //! deliver their pixels on a jobs thread when the copy's fence
+        //! signals, instead of blocking the frame on the device.
+        //! See GPUReadback.
+        GPUReadback gpuReadback;
+
+        //! Shared material table for the indirect ECS rendering systems.
+        //! Line/Mesh/Icon/Label styles deduplicate into one SSBO plus one
+        //! texture atlas, indexed per instance, so a mixed annotation
+        //! scene renders from a handful of descriptor sets total.
+        //! See MaterialTable.
+        vsg::ref_ptr<MaterialTable> materials;
+
         //! List of viewIDs that are active.
         std::vector<std::uint32_t> activeViewIDs = { 0 };
 
@@ -93,6 +164,39 @@ namespace ROCKY_NAMESPACE
         //! performance.
         void compile(vsg::ref_ptr<vsg::Object> object);
 
+        //! Queues an object for compilation by priority class. Each update
+        //! pass services the queue in class order (terrain before entities
+        //! before prefetch) until compileTimeBudgetMS elapses, carrying any
+        //! remainder into subsequent frames so a burst of new subgraphs
+        //! amortizes instead of stalling a single frame. Thread-safe.
+        //! @return Future that resolves to true once the object compiles
+        jobs::future<bool> compile(vsg::ref_ptr<vsg::Object> object, CompileClass compileClass);
+
+        //! Per-frame time budget, in milliseconds, for the prioritized
+        //! compile queue. At least one queued object compiles per frame
+        //! regardless of the budget, so the queue always drains.
+        float compileTimeBudgetMS = 4.0f;
+
+        //! Returns the context-wide shared ShaderSet under the given name,
+        //! invoking the factory only on a cache miss. When shaderCachePath
+        //! is set, a miss first tries to load "<name>.vsgb" from that
+        //! folder; a set loaded this way already carries its compiled
+        //! SPIR-V variants and skips GLSL compilation entirely.
+        vsg::ref_ptr<vsg::ShaderSet> getOrCreateShaderSet(
+            const std::string& name,
+            std::function<vsg::ref_ptr<vsg::ShaderSet>()> create);
+
+        //! Folder holding the on-disk shader cache; empty disables
+        //! persistence. Defaults to the ROCKY_SHADER_CACHE_PATH
+        //! environment variable.
+        std::string shaderCachePath;
+
+        //! Writes every cached ShaderSet to shaderCachePath. Call this
+        //! after the pipelines have compiled (e.g., at shutdown) so the
+        //! saved sets include the SPIR-V variants generated for each
+        //! pipeline configuration.
+        void saveShaderCache();
+
         //! Destroys a VSG object, eventually. 
         //! Call this to get rid of descriptor sets you plan to replace.
         //! You can't just let them go since they recycle internally and 
@@ -102,6 +206,19 @@ namespace ROCKY_NAMESPACE
         //! https://github.com/vsg-dev/VulkanSceneGraph/discussions/949
         void dispose(vsg::ref_ptr<vsg::Object> object);
 
+        //! Enables or disables the logarithmic-depth shader path (the
+        //! ROCKY_LOG_DEPTH define in the terrain/mesh/line shaders).
+        //! By default rendering relies on VSG's reverse-Z convention with a
+        //! floating-point depth buffer, which covers the full orbital-to-
+        //! street depth range in a single pass with no shader support;
+        //! enable this only as a fallback for targets without a
+        //! floating-point depth attachment. Clients pick up the change
+        //! through shaderSettingsRevision.
+        void setLogDepthEnabled(bool value);
+
+        //! Whether the logarithmic-depth shader path is active
+        bool logDepthEnabled() const;
+
         //! TODO: Signal that something has changed that requires shader regen.
         //! When we implement this, it will probably fire off a callback that
         //! signals listeners to recreate their graphics pipelines so they
@@ -124,6 +241,10 @@ namespace ROCKY_NAMESPACE
         // for (some) update operations
         vsg::ref_ptr<vsg::Operation> _priorityUpdateQueue;
 
+        // keeps the content cache registered with the memory governor
+        std::shared_ptr<MemoryGovernor::Registration> _contentCacheMemoryReg;
+        std::shared_ptr<util::CacheTelemetry::Registration> _contentCacheTelemetryReg;
+
         // containers for compilation and integrating the results
         struct ToCompile
         {
@@ -135,6 +256,20 @@ namespace ROCKY_NAMESPACE
         mutable std::mutex _compileMutex;
         vsg::CompileResult _compileResult;
 
+        // prioritized compile queue state (see compile(object, class))
+        struct QueuedCompile
+        {
+            vsg::ref_ptr<vsg::Object> object;
+            jobs::future<bool> result;
+        };
+        std::array<std::deque<QueuedCompile>, (int)CompileClass::NUM_CLASSES> _compileQueues;
+        mutable std::mutex _compileQueueMutex;
+        void serviceCompileQueue();
+
+        // context-wide shader set cache (see getOrCreateShaderSet)
+        std::unordered_map<std::string, vsg::ref_ptr<vsg::ShaderSet>> _shaderSetCache;
+        mutable std::mutex _shaderSetCacheMutex;
+
         // deferred deletion container (garbage collector)
         mutable std::mutex _gc_mutex;
         std::deque<std::vector<vsg::ref_ptr<vsg::Object>>> _gc;
@@ -143,6 +278,14 @@ namespace ROCKY_NAMESPACE
 
         vsg::ref_ptr<vsg::CommandGraph> _computeCommandGraph;
 
+        // adaptive concurrency governor state (see update())
+        void governJobPools();
+        std::chrono::steady_clock::time_point _lastUpdateTime;
+        double _smoothedFrameTimeMS = 0.0;
+        int _governorCooldown = 0;
+        int _recoveryStreak = 0;
+        std::unordered_map<jobs::jobpool*, unsigned> _configuredConcurrency;
+
     private:
         //! Construct a new VSG-based application instance
         VSGContextImpl(vsg::ref_ptr<vsg::Viewer> viewer);
@@ -7,6 +7,7 @@
 
 #include <rocky/vsg/ecs/Registry.h>
 #include <rocky/vsg/ecs/Line.h>
+#include <rocky/vsg/ecs/Circle.h>
 #include <rocky/vsg/ecs/Mesh.h>
 #include <rocky/vsg/ecs/Icon.h>
 #include <rocky/vsg/ecs/Label.h>
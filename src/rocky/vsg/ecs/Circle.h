@@ -0,0 +1,59 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Line.h>
+#include <rocky/GeoCircle.h>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Circle component - renders a range ring as a parametric primitive.
+    * The vertex shader sweeps the geodesic circle from center and radius
+    * uniforms, so each ring costs a few hundred bytes of uniform data and
+    * a radius change never re-tessellates or re-uploads vertex buffers.
+    */
+    class ROCKY_EXPORT Circle : public RevisionedComponent
+    {
+    public:
+        //! Geodesic circle to render (center point + radius in meters)
+        GeoCircle circle;
+
+        //! Dynamic line styling, shared with the Line primitive
+        LineStyle style;
+
+        //! Number of line segments used to sweep the circle
+        unsigned segments = 128;
+
+        //! Whether the ring should write to the depth buffer
+        bool write_depth = false;
+
+        //! Marks the entire circle dirty
+        inline void dirty() override
+        {
+            styleDirty = true;
+            circleDirty = true;
+            ++revision;
+        }
+
+        inline void dirtyStyle()
+        {
+            styleDirty = true;
+            ++revision;
+        }
+
+        //! Call after changing the center, radius, or segment count
+        inline void dirtyCircle()
+        {
+            circleDirty = true;
+            ++revision;
+        }
+
+    private:
+        bool styleDirty = true;
+        bool circleDirty = true;
+        friend class CircleSystemNode;
+    };
+}
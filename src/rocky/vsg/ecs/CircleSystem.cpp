@@ -0,0 +1,354 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "CircleSystem.h"
+#include "../PipelineState.h"
+#include "../Utils.h"
+
+#include <vsg/state/ViewDependentState.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/StateGroup.h>
+
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+#define CIRCLE_VERT_SHADER "shaders/rocky.circle.vert"
+#define CIRCLE_FRAG_SHADER "shaders/rocky.line.frag" // same raster path as lines
+
+#define CIRCLE_BUFFER_SET 0 // must match layout(set=X) in the shader UBOs
+#define STYLE_BUFFER_BINDING 1 // must match layout(binding=X) of the LineData UBO
+#define CIRCLE_BUFFER_BINDING 2 // must match layout(binding=X) of the CircleData UBO
+
+namespace
+{
+    // GPU-side mirror of the parametric circle uniforms.
+    // Note, alignment rules apply!
+    struct CircleRenderData
+    {
+        vsg::vec4 up;       // unit vector from the geocenter through the circle center
+        vsg::vec4 east;     // world-space unit east vector at the center
+        vsg::vec4 north;    // world-space unit north vector at the center
+        float world_radius; // distance from the geocenter to the circle center
+        float radius;       // geodesic radius of the circle, meters
+        int segments;       // number of line segments in the sweep
+        float padding;
+    };
+
+    // computes the circle's world-space center along with the orientation
+    // frame the vertex shader sweeps around:
+    vsg::dvec3 computeRenderData(const Circle& component, CircleRenderData& out)
+    {
+        auto ecef = component.circle.center().transform(SRS::ECEF);
+        vsg::dvec3 world(ecef.x, ecef.y, ecef.z);
+
+        auto geo = component.circle.center().transform(component.circle.srs().geodeticSRS());
+        double lon = deg2rad(geo.x), lat = deg2rad(geo.y);
+        double sin_lon = sin(lon), cos_lon = cos(lon);
+        double sin_lat = sin(lat), cos_lat = cos(lat);
+
+        double world_radius = vsg::length(world);
+        auto up = world / world_radius;
+
+        out.up = vsg::vec4((float)up.x, (float)up.y, (float)up.z, 0.0f);
+        out.east = vsg::vec4((float)-sin_lon, (float)cos_lon, 0.0f, 0.0f);
+        out.north = vsg::vec4((float)(-sin_lat * cos_lon), (float)(-sin_lat * sin_lon), (float)cos_lat, 0.0f);
+        out.world_radius = (float)world_radius;
+        out.radius = (float)component.circle.radius();
+        out.segments = (int)std::max(8u, component.segments);
+        out.padding = 0.0f;
+
+        return world;
+    }
+
+    vsg::ref_ptr<vsg::ShaderSet> createCircleShaderSet(VSGContext& runtime)
+    {
+        vsg::ref_ptr<vsg::ShaderSet> shaderSet;
+
+        // load shaders
+        auto vertexShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_VERTEX_BIT,
+            "main",
+            vsg::findFile(CIRCLE_VERT_SHADER, runtime->searchPaths),
+            runtime->readerWriterOptions);
+
+        auto fragmentShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+            "main",
+            vsg::findFile(CIRCLE_FRAG_SHADER, runtime->searchPaths),
+            runtime->readerWriterOptions);
+
+        if (!vertexShader || !fragmentShader)
+        {
+            return { };
+        }
+
+        vsg::ShaderStages shaderStages{ vertexShader, fragmentShader };
+
+        shaderSet = vsg::ShaderSet::create(shaderStages);
+
+        // Note: no attribute bindings at all; the vertex shader derives
+        // everything from gl_VertexIndex and the uniforms below.
+
+        // line style uniform buffer (width, stipple, etc.)
+        shaderSet->addDescriptorBinding("line", "", CIRCLE_BUFFER_SET, STYLE_BUFFER_BINDING,
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
+
+        // parametric circle uniform buffer (center frame, radius, segments)
+        shaderSet->addDescriptorBinding("circle", "", CIRCLE_BUFFER_SET, CIRCLE_BUFFER_BINDING,
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
+
+        // We need VSG's view-dependent data:
+        PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_VERTEX_BIT);
+
+        // Note: 128 is the maximum size required by the Vulkan spec so don't increase it
+        shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+        return shaderSet;
+    }
+}
+
+CircleSystemNode::CircleSystemNode(ecs::Registry& registry) :
+    Inherit(registry)
+{
+    //nop
+}
+
+void
+CircleSystemNode::initialize(VSGContext& runtime)
+{
+    // Now create the pipeline and stategroup to bind it
+    auto shaderSet = runtime->getOrCreateShaderSet("rocky.circle",
+        [&]() { return createCircleShaderSet(runtime); });
+
+    if (!shaderSet)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Circle shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        return;
+    }
+
+    pipelines.resize(NUM_PIPELINES);
+
+    for (int feature_mask = 0; feature_mask < NUM_PIPELINES; ++feature_mask)
+    {
+        auto& c = pipelines[feature_mask];
+
+        c.config = vsg::GraphicsPipelineConfig::create(shaderSet);
+
+        // Apply any custom compile settings / defines:
+        c.config->shaderHints = runtime->shaderCompileSettings;
+
+        // Uniforms we will need:
+        c.config->enableDescriptor("line");
+        c.config->enableDescriptor("circle");
+
+        // always both
+        PipelineUtils::enableViewDependentData(c.config);
+
+        struct SetPipelineStates : public vsg::Visitor
+        {
+            int feature_mask;
+            SetPipelineStates(int feature_mask_) : feature_mask(feature_mask_) { }
+            void apply(vsg::Object& object) override {
+                object.traverse(*this);
+            }
+            void apply(vsg::RasterizationState& state) override {
+                state.cullMode = VK_CULL_MODE_NONE;
+            }
+            void apply(vsg::DepthStencilState& state) override {
+                if ((feature_mask & WRITE_DEPTH) == 0) {
+                    state.depthWriteEnable = (feature_mask & WRITE_DEPTH) ? VK_TRUE : VK_FALSE;
+                }
+            }
+            void apply(vsg::ColorBlendState& state) override {
+                state.attachments = vsg::ColorBlendState::ColorBlendAttachments
+                {
+                    { true,
+                      VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_OP_ADD,
+                      VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_OP_ADD,
+                      VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT }
+                };
+            }
+        };
+        SetPipelineStates visitor(feature_mask);
+        c.config->accept(visitor);
+
+        c.config->init();
+
+        // Assemble the commands required to activate this pipeline:
+        c.commands = vsg::Commands::create();
+        c.commands->children.push_back(c.config->bindGraphicsPipeline);
+        c.commands->children.push_back(vsg::BindViewDescriptorSets::create(VK_PIPELINE_BIND_POINT_GRAPHICS, c.config->layout, VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX));
+    }
+}
+
+void
+CircleSystemNode::createOrUpdateNode(Circle& circle, ecs::BuildInfo& data, VSGContext& runtime) const
+{
+    if (!data.existing_node)
+    {
+        auto bindCommand = BindCircleDescriptors::create();
+        bindCommand->updateStyle(circle.style);
+        bindCommand->updateCircle(circle);
+        bindCommand->init(getPipelineLayout(circle));
+
+        auto stategroup = vsg::StateGroup::create();
+        stategroup->stateCommands.push_back(bindCommand);
+
+        // the shader works relative to the circle's center for precision:
+        CircleRenderData ignored;
+        auto center_world = computeRenderData(circle, ignored);
+
+        auto localizer = vsg::MatrixTransform::create(vsg::translate(center_world));
+
+        // 6 vertices per segment (two triangles of the extruded quad);
+        // no vertex buffers at all.
+        auto draw = vsg::Draw::create(std::max(8u, circle.segments) * 6, 1, 0, 0);
+        localizer->addChild(draw);
+
+        stategroup->addChild(localizer);
+
+        auto cull = vsg::CullNode::create();
+        cull->child = stategroup;
+
+        // the ring plus some slack for the screen-space line width:
+        cull->bound = vsg::dsphere(center_world, circle.circle.radius() * 1.1);
+
+        data.new_node = cull;
+    }
+
+    else // existing node -- update:
+    {
+        auto* bind = util::find<BindCircleDescriptors>(data.existing_node);
+
+        // style changed?
+        if (circle.styleDirty && bind)
+        {
+            bind->updateStyle(circle.style);
+        }
+
+        // center, radius, or segment count changed? just refresh the
+        // uniforms and bookkeeping; there is no geometry to rebuild.
+        if (circle.circleDirty)
+        {
+            if (bind)
+            {
+                bind->updateCircle(circle);
+            }
+
+            CircleRenderData ignored;
+            auto center_world = computeRenderData(circle, ignored);
+
+            auto* mt = util::find<vsg::MatrixTransform>(data.existing_node);
+            if (mt)
+            {
+                mt->matrix = vsg::translate(center_world);
+            }
+
+            auto* draw = util::find<vsg::Draw>(data.existing_node);
+            if (draw)
+            {
+                draw->vertexCount = std::max(8u, circle.segments) * 6;
+            }
+
+            auto* cull = util::find<vsg::CullNode>(data.existing_node);
+            if (cull)
+            {
+                cull->bound = vsg::dsphere(center_world, circle.circle.radius() * 1.1);
+            }
+        }
+    }
+
+    circle.styleDirty = false;
+    circle.circleDirty = false;
+}
+
+int
+CircleSystemNode::featureMask(const Circle& c) const
+{
+    int mask = 0;
+    if (c.write_depth) mask |= WRITE_DEPTH;
+    return mask;
+}
+
+
+BindCircleDescriptors::BindCircleDescriptors()
+{
+    //nop
+}
+
+void
+BindCircleDescriptors::updateStyle(const LineStyle& value)
+{
+    bool force = false;
+
+    if (!_styleData)
+    {
+        _styleData = vsg::ubyteArray::create(sizeof(LineStyle));
+
+        // tells VSG that the contents can change, and if they do, the data should be
+        // transfered to the GPU before or during recording.
+        _styleData->properties.dataVariance = vsg::DYNAMIC_DATA;
+
+        force = true;
+    }
+
+    LineStyle& my_style = *static_cast<LineStyle*>(_styleData->dataPointer());
+
+    if (force || (std::memcmp(&my_style, &value, sizeof(LineStyle)) != 0))
+    {
+        my_style = value;
+        _styleData->dirty();
+    }
+}
+
+void
+BindCircleDescriptors::updateCircle(const Circle& value)
+{
+    bool force = false;
+
+    if (!_circleData)
+    {
+        _circleData = vsg::ubyteArray::create(sizeof(CircleRenderData));
+        _circleData->properties.dataVariance = vsg::DYNAMIC_DATA;
+        force = true;
+    }
+
+    CircleRenderData data;
+    computeRenderData(value, data);
+
+    CircleRenderData& my_data = *static_cast<CircleRenderData*>(_circleData->dataPointer());
+
+    if (force || (std::memcmp(&my_data, &data, sizeof(CircleRenderData)) != 0))
+    {
+        my_data = data;
+        _circleData->dirty();
+    }
+}
+
+void
+BindCircleDescriptors::init(vsg::ref_ptr<vsg::PipelineLayout> layout)
+{
+    vsg::Descriptors descriptors;
+
+    // the style buffer:
+    auto style_ubo = vsg::DescriptorBuffer::create(_styleData, STYLE_BUFFER_BINDING, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    descriptors.push_back(style_ubo);
+
+    // the parametric circle buffer:
+    auto circle_ubo = vsg::DescriptorBuffer::create(_circleData, CIRCLE_BUFFER_BINDING, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    descriptors.push_back(circle_ubo);
+
+    if (!descriptors.empty())
+    {
+        this->pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        this->firstSet = 0;
+        this->layout = layout;
+        this->descriptorSet = vsg::DescriptorSet::create(layout->setLayouts.front(), descriptors);
+    }
+}
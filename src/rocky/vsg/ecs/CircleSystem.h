@@ -0,0 +1,63 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Circle.h>
+#include <rocky/vsg/ecs/ECSNode.h>
+
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/commands/Draw.h>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * ECS system that renders Circle components as parametric primitives.
+     * The pipeline has no vertex arrays at all; the vertex shader evaluates
+     * the geodesic circle from uniform data (center frame + radius).
+     */
+    class ROCKY_EXPORT CircleSystemNode : public vsg::Inherit<ecs::SystemNode<Circle>, CircleSystemNode>
+    {
+    public:
+        //! Construct the system
+        CircleSystemNode(ecs::Registry& registry);
+
+        enum Features
+        {
+            DEFAULT = 0x0,
+            WRITE_DEPTH = 1 << 0,
+            NUM_PIPELINES = 2
+        };
+
+        //! Returns a mask of supported features for the given circle
+        int featureMask(const Circle&) const override;
+
+        //! One-time initialization of the system
+        void initialize(VSGContext&) override;
+
+        void createOrUpdateNode(Circle&, ecs::BuildInfo&, VSGContext&) const override;
+    };
+
+    /**
+    * Applies a circle's line style and parametric circle uniforms.
+    */
+    class ROCKY_EXPORT BindCircleDescriptors : public vsg::Inherit<vsg::BindDescriptorSet, BindCircleDescriptors>
+    {
+    public:
+        //! Construct a circle descriptor-binding node
+        BindCircleDescriptors();
+
+        //! Initialize this command with the associated layout
+        void init(vsg::ref_ptr<vsg::PipelineLayout> layout);
+
+        //! Refresh the style buffer contents on the GPU
+        void updateStyle(const LineStyle&);
+
+        //! Refresh the parametric circle buffer contents on the GPU
+        void updateCircle(const Circle&);
+
+        vsg::ref_ptr<vsg::ubyteArray> _styleData;
+        vsg::ref_ptr<vsg::ubyteArray> _circleData;
+    };
+}
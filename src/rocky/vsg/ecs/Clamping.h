@@ -0,0 +1,36 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Component.h>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Component that keeps an entity's Transform clamped to the terrain.
+    * Attach it (alongside a Transform) and the ClampingSystem maintains
+    * the transform's height: queries batch against the resident terrain
+    * tiles and re-run only when the terrain data or the entity's own
+    * position changes, never per frame.
+    */
+    struct Clamping
+    {
+        //! Height to maintain above the terrain surface, in meters
+        float offset = 0.0f;
+    };
+
+    /**
+    * Internal bookkeeping the ClampingSystem attaches next to each
+    * Clamping component.
+    */
+    struct ClampingData
+    {
+        //! Transform revision the entity was last clamped at
+        int transformRevision = -1;
+
+        //! Index into the in-flight query batch, or -1 if none
+        int pending = -1;
+    };
+}
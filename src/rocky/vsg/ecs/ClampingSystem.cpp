@@ -0,0 +1,169 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "ClampingSystem.h"
+#include "Transform.h"
+#include "../terrain/TerrainEngine.h"
+
+#include <glm/glm.hpp>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[ClampingSystem] "
+
+namespace
+{
+    void on_construct_Clamping(entt::registry& r, entt::entity e)
+    {
+        r.emplace<ClampingData>(e);
+    }
+
+    void on_destroy_Clamping(entt::registry& r, entt::entity e)
+    {
+        r.remove<ClampingData>(e);
+    }
+}
+
+ClampingSystem::ClampingSystem(ecs::Registry& r, vsg::ref_ptr<MapNode> mapNode) :
+    ecs::System(r),
+    _mapNode(mapNode)
+{
+    // attach the bookkeeping component alongside each Clamping:
+    auto [lock, registry] = _registry.write();
+
+    registry.on_construct<Clamping>().connect<&on_construct_Clamping>();
+    registry.on_destroy<Clamping>().connect<&on_destroy_Clamping>();
+}
+
+void
+ClampingSystem::update(VSGContext& runtime)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(_mapNode && _mapNode->terrainNode, void());
+
+    auto engine = _mapNode->terrainNode->engine;
+    if (!engine)
+        return;
+
+    auto& picker = engine->picker;
+
+    auto& world_srs = _mapNode->worldSRS();
+    bool geocentric = world_srs.isGeocentric();
+
+    // per-entity SRS operations, rebuilt only when the SRS changes
+    // (entities overwhelmingly share one):
+    SRS cached_srs;
+    SRSOperation pos_to_world, world_to_pos;
+
+    auto bind = [&](const SRS& srs)
+        {
+            if (srs != cached_srs)
+            {
+                cached_srs = srs;
+                pos_to_world = srs.to(world_srs);
+                world_to_pos = world_srs.to(srs);
+            }
+        };
+
+    if (_batch.working())
+        return; // results are still cooking; check again next frame
+
+    // merge the results of a completed batch into the transforms:
+    if (_batch.available())
+    {
+        auto& hits = _batch.value();
+
+        auto [lock, registry] = _registry.write();
+
+        for (std::size_t i = 0; i < _batchEntities.size() && i < hits.size(); ++i)
+        {
+            auto entity = _batchEntities[i];
+            if (!registry.valid(entity))
+                continue;
+
+            auto* transform = registry.try_get<Transform>(entity);
+            auto* clamping = registry.try_get<Clamping>(entity);
+            auto* data = registry.try_get<ClampingData>(entity);
+            if (!transform || !clamping || !data)
+                continue;
+
+            data->pending = -1;
+
+            // the entity moved while the query was in flight; let the
+            // next pass re-queue it against its new position:
+            if (transform->revision != _batchRevisions[i])
+                continue;
+
+            if (hits[i].valid() && transform->position.srs.valid())
+            {
+                bind(transform->position.srs);
+
+                glm::dvec3 local = hits[i].point;
+                if (world_to_pos.transform(local.x, local.y, local.z))
+                {
+                    transform->position.z = local.z + clamping->offset;
+                    transform->dirty();
+                }
+            }
+
+            // either way this terrain answer is now consumed:
+            data->transformRevision = transform->revision;
+        }
+
+        _batch.reset();
+        _batchEntities.clear();
+        _batchRevisions.clear();
+
+        runtime->requestFrame();
+    }
+
+    // gather the entities that need (re)clamping: all of them when the
+    // terrain data changed, otherwise just the ones that moved.
+    auto terrainRevision = picker.revision();
+    bool terrainChanged = terrainRevision != _terrainRevision;
+
+    if (picker.size() == 0)
+        return; // nothing resident to clamp against yet
+
+    std::vector<TerrainPicker::Ray> rays;
+
+    {
+        auto [lock, registry] = _registry.read();
+
+        for (auto&& [entity, transform, clamping, data] :
+            registry.view<Transform, Clamping, ClampingData>().each())
+        {
+            if (data.pending >= 0)
+                continue; // already queried
+
+            if (!terrainChanged && data.transformRevision == transform.revision)
+                continue; // stationary on stable terrain
+
+            if (!transform.position.srs.valid())
+                continue;
+
+            bind(transform.position.srs);
+
+            glm::dvec3 world = transform.position;
+            if (!pos_to_world.transform(world.x, world.y, world.z))
+                continue;
+
+            // cast straight down through the position:
+            glm::dvec3 up = geocentric ?
+                glm::normalize(world) : glm::dvec3(0.0, 0.0, 1.0);
+
+            data.pending = (int)rays.size();
+            rays.emplace_back(TerrainPicker::Ray{ world + up * rayHeight, -up });
+            _batchEntities.emplace_back(entity);
+            _batchRevisions.emplace_back(transform.revision);
+        }
+    }
+
+    _terrainRevision = terrainRevision;
+
+    if (!rays.empty())
+    {
+        _batch = picker.intersectBatch(std::move(rays));
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Clamping.h>
+#include <rocky/vsg/ecs/Registry.h>
+#include <rocky/vsg/MapNode.h>
+#include <rocky/vsg/terrain/TerrainPicker.h>
+#include <rocky/weejobs.h>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * ECS system that keeps Clamping-tagged entities on the terrain.
+    *
+    * Each update pass gathers the entities whose transform moved - or
+    * every registered entity, when the resident terrain data itself
+    * changed - and casts their height queries as one batch against the
+    * terrain picker's resident-tile mesh on the jobs system. Results
+    * merge back into the Transform components on a later pass, so a
+    * query never blocks the update thread and a stationary entity on
+    * stable terrain costs nothing per frame.
+    */
+    class ROCKY_EXPORT ClampingSystem : public ecs::System
+    {
+    public:
+        ClampingSystem(ecs::Registry& registry, vsg::ref_ptr<MapNode> mapNode);
+
+        static std::shared_ptr<ClampingSystem> create(ecs::Registry& registry, vsg::ref_ptr<MapNode> mapNode) {
+            return std::make_shared<ClampingSystem>(registry, mapNode);
+        }
+
+        //! Height above the entity's position from which to cast each
+        //! clamping ray, in meters
+        double rayHeight = 25000.0;
+
+        //! Apply results and dispatch new queries; called once per frame
+        void update(VSGContext& runtime) override;
+
+    private:
+        vsg::ref_ptr<MapNode> _mapNode;
+
+        //! terrain-data revision the current entity set was clamped at
+        int _terrainRevision = -1;
+
+        //! in-flight query batch and the entities awaiting its results
+        jobs::future<std::vector<TerrainPicker::Hit>> _batch;
+        std::vector<entt::entity> _batchEntities;
+        std::vector<int> _batchRevisions;
+    };
+}
@@ -0,0 +1,250 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "DeclutterSystem.h"
+#include "TransformData.h"
+#include "Visibility.h"
+#include "../VSGContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    // pack a grid cell coordinate into a map key
+    inline std::int64_t cellKey(int cx, int cy)
+    {
+        return ((std::int64_t)cy << 32) ^ (std::int64_t)(std::uint32_t)cx;
+    }
+
+    inline bool overlaps(const Rect& a, const Rect& b)
+    {
+        return !(a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin);
+    }
+}
+
+DeclutterSystem::DeclutterSystem(ecs::Registry& registry) :
+    ecs::System(registry)
+{
+    //nop
+}
+
+void
+DeclutterSystem::update(VSGContext& context)
+{
+    if (!enabled)
+        return;
+
+    auto viewIDs = context->activeViewIDs; // copy
+    if (viewIDs.empty())
+        return;
+
+    // Process a single view per pass, round-robin, so the cost spreads
+    // across frames when multiple views are active.
+    auto viewID = viewIDs[_viewCursor++ % viewIDs.size()];
+
+    total = 0, visible = 0;
+
+    // First collect all declutter-able entities and their buffered
+    // screen-space rectangles.
+    struct Candidate
+    {
+        int tier;           // priority tier; higher always outranks lower
+        bool sticky;        // visible after the last pass (hysteresis)
+        bool moved;         // screen position moved > epsilon since last solve
+        double key;         // rank among competitors
+        entt::entity entity;
+        Rect rect;
+        vsg::dvec2 window;
+    };
+    std::vector<Candidate> sorted;
+    sorted.reserve(_lastMaxSize);
+
+    auto [lock, registry] = _registry.read();
+
+    auto& state = _views[viewID];
+    auto& wasVisible = state.visible;
+
+    const double e2 = epsilon_px * epsilon_px;
+    bool anyMoved = false;
+    int maxMovedTier = std::numeric_limits<int>::min();
+
+    auto view = registry.view<ActiveState, Declutter, TransformData>();
+
+    for (auto&& [entity, active, declutter, transformData] : view.each())
+    {
+        auto& viewData = transformData[viewID];
+
+        auto clip = viewData.mvp[3] / viewData.mvp[3][3];
+        vsg::dvec2 window((clip.x + 1.0) * 0.5 * (double)viewData.viewport[2], (clip.y + 1.0) * 0.5 * (double)viewData.viewport[3]);
+
+        Rect rect = declutter.rect;
+        rect.xmin += window.x - buffer_px;
+        rect.ymin += window.y - buffer_px;
+        rect.xmax += window.x + buffer_px;
+        rect.ymax += window.y + buffer_px;
+
+        double key = sorting == Sorting::Priority ? (double)declutter.priority : -clip.z;
+
+        int tier = tierSize > 0.0f ? (int)std::floor(declutter.priority / tierSize) : 0;
+
+        bool sticky = hysteresis && wasVisible.count(entity) > 0;
+
+        // moved relative to the position we last solved at (new entities
+        // count as moved):
+        bool moved = true;
+        auto last = state.positions.find(entity);
+        if (last != state.positions.end())
+        {
+            auto d = window - last->second;
+            moved = (d.x * d.x + d.y * d.y) > e2;
+        }
+
+        if (moved)
+        {
+            anyMoved = true;
+            maxMovedTier = std::max(maxMovedTier, tier);
+        }
+
+        sorted.emplace_back(Candidate{ tier, sticky, moved, key, entity, rect, window });
+    }
+
+    _lastMaxSize = sorted.size();
+
+    // Cache hit: nothing moved and nothing appeared or disappeared, so
+    // the visibility written by the last pass still stands - this is the
+    // common case with a static camera and costs only the scan above.
+    if (!anyMoved && sorted.size() == state.positions.size())
+    {
+        visible = state.visibleCount;
+        total = state.totalCount;
+        return;
+    }
+
+    // Higher tiers claim their space before lower tiers regardless of
+    // hysteresis, so a high-value label can never flicker out in favor
+    // of a lesser sticky one. Within a tier, previously-visible entities
+    // go first so the result stays stable during pans; then rank by key.
+    std::sort(sorted.begin(), sorted.end(), [](const Candidate& lhs, const Candidate& rhs)
+        {
+            if (lhs.tier != rhs.tier)
+                return lhs.tier > rhs.tier;
+            if (lhs.sticky != rhs.sticky)
+                return lhs.sticky;
+            return lhs.key > rhs.key;
+        });
+
+    // Next, walk the candidates in order and accept each one that does
+    // not conflict with an already-accepted rectangle. The uniform grid
+    // limits each conflict test to the cells the rectangle covers.
+    std::unordered_map<std::int64_t, std::vector<std::uint32_t>> grid;
+    std::vector<Rect> accepted;
+    accepted.reserve(sorted.size());
+
+    std::set<entt::entity> nowVisible;
+
+    const double cell = std::max(1.0, cellSize_px);
+
+    for (auto& candidate : sorted)
+    {
+        ++total;
+
+        auto& visibility = registry.get<Visibility>(candidate.entity);
+        if (visibility.parent != nullptr)
+            continue;
+
+        auto& rect = candidate.rect;
+
+        int cx0 = (int)std::floor(rect.xmin / cell), cx1 = (int)std::floor(rect.xmax / cell);
+        int cy0 = (int)std::floor(rect.ymin / cell), cy1 = (int)std::floor(rect.ymax / cell);
+
+        // Incremental repair: an unmoved previously-visible entity keeps
+        // its claimed space without retesting (its rectangle was conflict-
+        // free last pass and hasn't moved) - unless a higher-tier entity
+        // moved this pass, in which case it re-enters the solver so it
+        // can be displaced.
+        bool seeded = candidate.sticky && !candidate.moved && candidate.tier >= maxMovedTier;
+
+        bool conflict = false;
+        for (int cy = cy0; cy <= cy1 && !conflict && !seeded; ++cy)
+        {
+            for (int cx = cx0; cx <= cx1 && !conflict; ++cx)
+            {
+                auto iter = grid.find(cellKey(cx, cy));
+                if (iter != grid.end())
+                {
+                    for (auto index : iter->second)
+                    {
+                        if (overlaps(rect, accepted[index]))
+                        {
+                            conflict = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (!conflict)
+        {
+            auto index = (std::uint32_t)accepted.size();
+            accepted.emplace_back(rect);
+
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx)
+                    grid[cellKey(cx, cy)].emplace_back(index);
+
+            visibility[viewID] = true;
+            nowVisible.insert(candidate.entity);
+            ++visible;
+        }
+        else
+        {
+            visibility[viewID] = false;
+        }
+    }
+
+    // refresh the cache. An unmoved entity keeps the position it was
+    // last solved at, so sub-epsilon drift accumulates against that
+    // snapshot instead of resetting every pass.
+    std::unordered_map<entt::entity, vsg::dvec2> newPositions;
+    newPositions.reserve(sorted.size());
+    for (auto& candidate : sorted)
+    {
+        if (!candidate.moved)
+        {
+            auto last = state.positions.find(candidate.entity);
+            if (last != state.positions.end())
+            {
+                newPositions.emplace(candidate.entity, last->second);
+                continue;
+            }
+        }
+        newPositions.emplace(candidate.entity, candidate.window);
+    }
+    state.positions = std::move(newPositions);
+    state.visibleCount = visible;
+    state.totalCount = total;
+
+    wasVisible = std::move(nowVisible);
+}
+
+void
+DeclutterSystem::resetVisibility()
+{
+    auto [lock, registry] = _registry.read();
+
+    auto view = registry.view<Declutter, Visibility>();
+    for (auto&& [entity, declutter, visibility] : view.each())
+    {
+        visibility.fill(true);
+    }
+
+    _views.clear();
+}
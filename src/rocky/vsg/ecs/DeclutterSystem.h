@@ -0,0 +1,104 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Declutter.h>
+#include <rocky/vsg/ecs/Registry.h>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * ECS System that resolves screen-space conflicts between entities
+    * carrying a Declutter component by toggling their per-view Visibility.
+    *
+    * Conflict testing uses a uniform screen-space grid, so each candidate
+    * only tests against neighbors in the cells its rectangle covers -
+    * linear in the entity count rather than quadratic. Each update call
+    * processes one view (round-robin over the active views), spreading the
+    * work across frames. Previously-visible entities claim their screen
+    * space first, which keeps the result stable while the camera pans.
+    *
+    * Results are cached between passes: when no entity's screen position
+    * has moved more than epsilon_px since the last pass, the pass is a
+    * no-op, and when some have, only the moved (and previously hidden)
+    * entities re-enter the solver - unmoved visible entities keep their
+    * claimed space without retesting.
+    *
+    * Run update() from a background thread or on whatever cadence suits
+    * the scene; see the decluttering demo.
+    */
+    class ROCKY_EXPORT DeclutterSystem : public ecs::System
+    {
+    public:
+        DeclutterSystem(ecs::Registry& registry);
+
+        static std::shared_ptr<DeclutterSystem> create(ecs::Registry& registry) {
+            return std::make_shared<DeclutterSystem>(registry);
+        }
+
+        //! Whether decluttering is active
+        bool enabled = true;
+
+        //! Screen-space padding around each entity's rectangle, in pixels
+        double buffer_px = 25.0;
+
+        //! Uniform grid cell size, in pixels
+        double cellSize_px = 64.0;
+
+        //! How to rank competing entities; Priority uses Declutter::priority,
+        //! Distance prefers entities closer to the camera
+        enum class Sorting { Priority, Distance };
+        Sorting sorting = Sorting::Priority;
+
+        //! Whether previously-visible entities win conflicts against
+        //! equal-or-lower ranked newcomers, stabilizing the result during pans
+        bool hysteresis = true;
+
+        //! Screen-space movement (in pixels) below which an entity is
+        //! considered stationary and keeps its cached declutter verdict
+        double epsilon_px = 1.0;
+
+        //! Width of a priority tier. Entities in a higher tier
+        //! (floor(priority / tierSize)) always outrank lower tiers, even
+        //! sticky previously-visible ones, so high-value labels never
+        //! flicker out in favor of a lesser label that got there first.
+        //! Zero (the default) disables tiering.
+        float tierSize = 0.0f;
+
+        //! Stats from the most recent pass
+        unsigned visible = 1u;
+        unsigned total = 0u;
+
+        //! Run one declutter pass for the next active view.
+        void update(VSGContext& context) override;
+
+        //! Restore visibility to every decluttered entity.
+        void resetVisibility();
+
+    private:
+        std::size_t _viewCursor = 0;
+        std::size_t _lastMaxSize = 32;
+
+        //! cached results of the last pass in each view
+        struct ViewState
+        {
+            //! entities visible after the last pass
+            std::set<entt::entity> visible;
+            //! screen position of each entity when it was last solved;
+            //! deliberately NOT refreshed for sub-epsilon moves, so slow
+            //! drift accumulates against the solved snapshot and
+            //! eventually triggers a repair instead of going unnoticed
+            std::unordered_map<entt::entity, vsg::dvec2> positions;
+            //! stats to report on a cache hit
+            unsigned visibleCount = 0u;
+            unsigned totalCount = 0u;
+        };
+        std::unordered_map<int, ViewState> _views;
+    };
+}
@@ -72,8 +72,18 @@ ecs::EntityNodeFactory::start()
                         // compile everything (creates any new vulkan objects)
                         if (group->children.size() > 0)
                         {
-                            // compile all the results at once:
-                            (*batch.context)->compile(group);
+                            // compile all the results at once, through the
+                            // budgeted ENTITY-class queue so entity bursts
+                            // amortize across frames:
+                            auto compiled = (*batch.context)->compile(group, CompileClass::ENTITY);
+
+                            // wait for an update pass to service the compile,
+                            // bailing out if shutdown arrives first:
+                            while (compiled.working() && buffers.use_count() > 1)
+                                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                            if (!compiled.available())
+                                continue;
 
                             // queue the results so the merger will pick em up
                             // (in SystemsManagerGroup::update)
@@ -109,6 +119,7 @@ ecs::EntityNodeFactory::mergeResults(Registry& r, VSGContext& runtime)
     if (buffers)
     {
         BuildBatch batch;
+        bool merged = false;
 
         while (buffers->output.pop(batch))
         {
@@ -118,6 +129,15 @@ ecs::EntityNodeFactory::mergeResults(Registry& r, VSGContext& runtime)
             {
                 batch.system->mergeCreateOrUpdateResults(registry, item, runtime);
             }
+
+            merged = true;
+        }
+
+        // new or updated entity geometry needs a render, even in
+        // on-demand mode:
+        if (merged)
+        {
+            runtime->requestFrame();
         }
     }
 }
@@ -155,11 +155,16 @@ namespace ROCKY_NAMESPACE
 
             void mergeCreateOrUpdateResults(entt::registry& registry, BuildItem& item, VSGContext& runtime) override;
 
-        private:
+        protected:
 
-            // list of entities whose components are out of date and need updating
+            // list of entities whose components are out of date and need updating.
+            // Subclasses may intercept this in update() to service cheap changes
+            // (e.g. style-only rewrites of a dynamic buffer) without the
+            // component-copy-and-rebuild round trip through the node factory.
             mutable std::vector<entt::entity> entities_to_update;
 
+        private:
+
             // internal structure used when sorting components (by pipeline) for rendering
             struct RenderLeaf
             {
@@ -169,6 +174,22 @@ namespace ROCKY_NAMESPACE
 
             // re-usable collection to minimize re-allocation
             mutable std::vector<std::vector<RenderLeaf>> pipelineRenderLeaves;
+
+            // Self-contained copy of one render leaf, retained per view so the
+            // record traversal can replay the previous frame when the registry
+            // is write-locked by another thread.
+            struct SnapshotLeaf
+            {
+                vsg::ref_ptr<vsg::Node> node;
+                bool hasMatrix = false;
+                vsg::dmat4 modelview;
+            };
+
+            // per-view, per-pipeline snapshot of the last successful traversal
+            mutable detail::ViewLocal<std::vector<std::vector<SnapshotLeaf>>> renderSnapshots;
+
+            // records the retained snapshot for a view instead of visiting the registry
+            void replaySnapshot(vsg::RecordTraversal&, std::uint32_t viewID) const;
         };
 
         /**
@@ -187,11 +208,21 @@ namespace ROCKY_NAMESPACE
 
             //! Add a system node instance to the group.
             //! @param system The system node instance to add
+            //! @param wrapper Optional group (e.g. a GPUTimedGroup) to interpose
+            //!   between this node and the system in the scene graph
             template<class T>
-            void add(vsg::ref_ptr<T> system)
+            void add(vsg::ref_ptr<T> system, vsg::ref_ptr<vsg::Group> wrapper = {})
             {
                 //static_assert(std::is_base_of<SystemNodeBase, T>::value, "T must be a subclass of SystemNodeBase");
-                addChild(system);
+                if (wrapper)
+                {
+                    wrapper->addChild(system);
+                    addChild(wrapper);
+                }
+                else
+                {
+                    addChild(system);
+                }
                 systems.emplace_back(system.get());
             }
 
@@ -212,6 +243,16 @@ namespace ROCKY_NAMESPACE
                 for (auto& child : children)
                 {
                     auto systemNode = child->cast<SystemNodeBase>();
+
+                    // the system may sit under a wrapper group (see add):
+                    if (!systemNode)
+                    {
+                        if (auto group = child->cast<vsg::Group>(); group && !group->children.empty())
+                        {
+                            systemNode = group->children.front()->cast<SystemNodeBase>();
+                        }
+                    }
+
                     if (systemNode)
                     {
                         systemNode->factory = &factory;
@@ -431,7 +472,15 @@ namespace ROCKY_NAMESPACE
             pipelineRenderLeaves.resize(!pipelines.empty() ? pipelines.size() : 1);
         }
 
-        auto [lock, registry] = _registry.read();
+        // Non-blocking read. If another thread holds the write lock (e.g., a
+        // burst of entity updates), replay the immutable snapshot from the
+        // last successful traversal instead of stalling the record thread.
+        auto [lock, registry] = _registry.tryRead();
+        if (!lock.owns_lock())
+        {
+            replaySnapshot(rt, viewID);
+            return;
+        }
 
         // Get an optimized view of all this system's components:
         registry.view<T, ActiveState, Visibility>().each([&](const entt::entity entity, auto& component, auto& active, auto& visibility)
@@ -448,7 +497,7 @@ namespace ROCKY_NAMESPACE
                         if (transformData)
                         {
                             auto& view = (*transformData)[viewID];
-                            if (view.passesCull())
+                            if (!view.culled) // verdict cached by the TransformSystem cull pass
                             {
                                 leaves.emplace_back(RenderLeaf{ renderable, &view });
                             }
@@ -467,9 +516,24 @@ namespace ROCKY_NAMESPACE
                 }
             });
 
+        // Refresh this view's snapshot so a future lock-contended traversal
+        // can replay it. Each leaf is copied by value (node ref + matrix) so
+        // the snapshot stays valid even if entities are later destroyed.
+        auto& snapshot = renderSnapshots[viewID];
+        snapshot.resize(pipelineRenderLeaves.size());
+
         // Time to record all visible components. For each pipeline:
         for (int p = 0; p < pipelineRenderLeaves.size(); ++p)
         {
+            snapshot[p].clear();
+            for (auto& leaf : pipelineRenderLeaves[p])
+            {
+                if (leaf.transformViewData)
+                    snapshot[p].emplace_back(SnapshotLeaf{ leaf.renderable.node, true, leaf.transformViewData->modelview });
+                else
+                    snapshot[p].emplace_back(SnapshotLeaf{ leaf.renderable.node, false });
+            }
+
             if (!pipelineRenderLeaves[p].empty())
             {
                 // Bind the Graphics Pipeline for this render set, if there is one:
@@ -500,6 +564,44 @@ namespace ROCKY_NAMESPACE
         }
     }
 
+    template<class T>
+    inline void ecs::SystemNode<T>::replaySnapshot(vsg::RecordTraversal& rt, std::uint32_t viewID) const
+    {
+        auto& snapshot = renderSnapshots[viewID];
+        auto* state = rt.getState();
+
+        for (std::size_t p = 0; p < snapshot.size(); ++p)
+        {
+            if (snapshot[p].empty())
+                continue;
+
+            if (!pipelines.empty())
+            {
+                pipelines[p].commands->accept(rt);
+            }
+
+            for (auto& leaf : snapshot[p])
+            {
+                if (leaf.hasMatrix)
+                {
+                    // replicates TransformViewData::push with the snapshotted matrix:
+                    state->modelviewMatrixStack.push(leaf.modelview);
+                    state->dirty = true;
+                    state->pushFrustum();
+                }
+
+                leaf.node->accept(rt);
+
+                if (leaf.hasMatrix)
+                {
+                    state->popFrustum();
+                    state->modelviewMatrixStack.pop();
+                    state->dirty = true;
+                }
+            }
+        }
+    }
+
 
     template<class T>
     inline void ecs::SystemNode<T>::update(VSGContext& context)
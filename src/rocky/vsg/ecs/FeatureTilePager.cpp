@@ -0,0 +1,307 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "FeatureTilePager.h"
+#include "Visibility.h"
+#include "../VSGContext.h"
+
+#include <set>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    // Liang-Barsky clip of one segment against an axis-aligned rectangle.
+    // Returns false if the segment lies entirely outside; otherwise outputs
+    // the clip parameters [t0, t1] of the surviving sub-segment.
+    bool clip_segment(const glm::dvec3& a, const glm::dvec3& b,
+        double xmin, double ymin, double xmax, double ymax,
+        double& t0, double& t1)
+    {
+        double dx = b.x - a.x;
+        double dy = b.y - a.y;
+        t0 = 0.0, t1 = 1.0;
+
+        auto test = [&](double p, double q)
+            {
+                if (p == 0.0)
+                    return q >= 0.0;
+                double r = q / p;
+                if (p < 0.0)
+                {
+                    if (r > t1) return false;
+                    if (r > t0) t0 = r;
+                }
+                else
+                {
+                    if (r < t0) return false;
+                    if (r < t1) t1 = r;
+                }
+                return true;
+            };
+
+        return
+            test(-dx, a.x - xmin) && test(dx, xmax - a.x) &&
+            test(-dy, a.y - ymin) && test(dy, ymax - a.y);
+    }
+
+    // Clips one linestring to a rectangle, dropping interior points closer
+    // together than "tolerance" along the way, and appends the surviving
+    // runs to "parts" as separate linestrings.
+    void clip_linestring(const std::vector<glm::dvec3>& points,
+        double xmin, double ymin, double xmax, double ymax,
+        double tolerance, std::vector<Geometry>& parts)
+    {
+        if (points.size() < 2)
+            return;
+
+        double t2 = tolerance * tolerance;
+
+        Geometry run(Geometry::Type::LineString);
+
+        auto flush = [&]()
+            {
+                if (run.points.size() >= 2)
+                    parts.emplace_back(std::move(run));
+                run = Geometry(Geometry::Type::LineString);
+            };
+
+        for (unsigned i = 0; i < points.size() - 1; ++i)
+        {
+            auto& a = points[i];
+            auto& b = points[i + 1];
+
+            double t0, t1;
+            if (!clip_segment(a, b, xmin, ymin, xmax, ymax, t0, t1))
+            {
+                // segment entirely outside; break the run
+                flush();
+                continue;
+            }
+
+            auto ca = a + (b - a) * t0;
+            auto cb = a + (b - a) * t1;
+
+            if (t0 > 0.0 || run.points.empty())
+            {
+                // (re)entering the rectangle; start a new run exactly at
+                // the entry point
+                flush();
+                run.points.emplace_back(ca);
+            }
+
+            if (t1 < 1.0)
+            {
+                // exiting the rectangle; keep the exit point exact
+                run.points.emplace_back(cb);
+                flush();
+            }
+            else
+            {
+                // interior point; keep it only if it moved at least the
+                // generalization tolerance, or is the last point
+                auto& last = run.points.back();
+                double dx = cb.x - last.x;
+                double dy = cb.y - last.y;
+                if (dx * dx + dy * dy >= t2 || i + 1 == points.size() - 1)
+                    run.points.emplace_back(cb);
+            }
+        }
+
+        flush();
+    }
+}
+
+void
+FeatureTilePager::buildIndex()
+{
+    _index.RemoveAll();
+
+    for (unsigned i = 0; i < features.size(); ++i)
+    {
+        auto& extent = features[i].extent;
+        if (extent.valid())
+        {
+            double LL[2]{ extent.xmin(), extent.ymin() };
+            double UR[2]{ extent.xmax(), extent.ymax() };
+            _index.Insert(LL, UR, i);
+        }
+    }
+
+    _indexed = true;
+}
+
+void
+FeatureTilePager::setCacheCapacity(int tiles)
+{
+    _cutCache.setCapacity(tiles);
+}
+
+FeatureTilePager::CutFeatures
+FeatureTilePager::cutTile(const TileKey& key)
+{
+    auto result = std::make_shared<std::vector<Feature>>();
+
+    auto extent = key.extent();
+
+    double LL[2]{ extent.xmin(), extent.ymin() };
+    double UR[2]{ extent.xmax(), extent.ymax() };
+
+    // points closer together than this collapse during generalization:
+    double tolerance = (double)pixelError * (extent.width() / (double)tileSize);
+
+    _index.Search(LL, UR, [&](const unsigned& i)
+        {
+            auto& feature = features[i];
+
+            if (feature.geometry.type == Geometry::Type::LineString ||
+                feature.geometry.type == Geometry::Type::MultiLineString)
+            {
+                Geometry cut(Geometry::Type::MultiLineString);
+
+                Geometry::const_iterator iter(feature.geometry);
+                while (iter.hasMore())
+                {
+                    auto& part = iter.next();
+                    clip_linestring(part.points, extent.xmin(), extent.ymin(),
+                        extent.xmax(), extent.ymax(), tolerance, cut.parts);
+                }
+
+                if (!cut.parts.empty())
+                {
+                    auto& f = result->emplace_back(feature);
+                    f.geometry = std::move(cut);
+                    f.dirtyExtent();
+                }
+            }
+            else
+            {
+                // polygons and points: anchor each feature to the tile holding
+                // its centroid, so a feature spanning tiles compiles exactly once
+                double x, y;
+                feature.extent.getCentroid(x, y);
+                if (extent.contains(x, y))
+                {
+                    result->emplace_back(feature);
+                }
+            }
+            return true; // keep searching
+        });
+
+    return result;
+}
+
+unsigned
+FeatureTilePager::update(entt::registry& registry, const GeoExtent& visible, double resolution,
+    const SRS& geom_srs, VSGContext& runtime)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(_indexed, 0);
+    ROCKY_SOFT_ASSERT_AND_RETURN(visible.valid() && resolution > 0.0, 0);
+
+    // register with the memory governor so feature residency shows up
+    // in the attribution display; pressure evicts cold cut-tiles.
+    if (!_memoryReg)
+    {
+        _memoryReg = runtime->memory.add(
+            "feature cut-tile cache",
+            [this]() { return _cutCache.size(); },
+            [this](float pressure) { _cutCache.shrink(pressure); });
+
+        _telemetryReg = _cutCache.telemetry("feature cut-tile cache");
+    }
+
+    unsigned changes = 0;
+
+    // match the view's ground resolution to a level of the profile:
+    unsigned level = profile.getLevelOfDetailForHorizResolution(resolution, (int)tileSize);
+    level = std::min(std::max(level, minLevel), maxLevel);
+
+    // the tiles touching the visible extent at that level:
+    TileKey::Vector keys;
+    TileKey::getIntersectingKeys(visible, level, profile, keys);
+
+    std::set<TileKey> wanted(keys.begin(), keys.end());
+
+    // release the geometry of tiles that left the working set (because the
+    // camera moved, or because the level changed):
+    for (auto iter = _tiles.begin(); iter != _tiles.end(); )
+    {
+        if (wanted.count(iter->first) == 0)
+        {
+            auto& tile = iter->second;
+
+            for (auto tile_entity : tile.view.line_entities)
+                registry.destroy(tile_entity);
+
+            for (auto tile_entity : tile.view.mesh_entities)
+                registry.destroy(tile_entity);
+
+            iter = _tiles.erase(iter);
+            ++changes;
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    // compile the tiles that entered it:
+    for (auto& key : keys)
+    {
+        if (_tiles.count(key) > 0)
+            continue;
+
+        // fetch this tile's cut features, cutting on a cache miss:
+        auto cut = _cutCache.get(key);
+        if (!cut)
+        {
+            cut = cutTile(key);
+            _cutCache.put(key, cut);
+        }
+
+        // record the tile even when empty, so the key does not re-fetch
+        // on every update:
+        auto& tile = _tiles[key];
+        ++changes;
+
+        if (cut->empty())
+            continue;
+
+        if (entity == entt::null)
+        {
+            entity = registry.create();
+            registry.emplace<Visibility>(entity);
+        }
+
+        // compile through a per-tile FeatureView parented to our shared
+        // host entity, so one visibility flag governs every tile:
+        tile.view.entity = entity;
+        tile.view.styles = styles;
+        tile.view.features = *cut; // copy; the cache keeps the original
+        tile.view.generate(registry, geom_srs, runtime);
+    }
+
+    if (changes > 0)
+    {
+        runtime->requestFrame();
+    }
+
+    return changes;
+}
+
+void
+FeatureTilePager::clear(entt::registry& registry)
+{
+    for (auto& [key, tile] : _tiles)
+    {
+        for (auto tile_entity : tile.view.line_entities)
+            registry.destroy(tile_entity);
+
+        for (auto tile_entity : tile.view.mesh_entities)
+            registry.destroy(tile_entity);
+    }
+    _tiles.clear();
+    _cutCache.clear();
+}
@@ -0,0 +1,110 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/Context.h>
+#include <rocky/Profile.h>
+#include <rocky/TileKey.h>
+#include <rocky/LRUCache.h>
+#include <rocky/vsg/ecs/FeatureView.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * FeatureTilePager pages feature geometry through a tiling profile, the
+    * way the engine pages raster data through TileKeys. Source features are
+    * cut to the profile's tile grid and generalized to each level's ground
+    * resolution on demand; update() matches the view's resolution to a level
+    * of detail, compiles the tiles entering the visible extent, and releases
+    * the tiles leaving it. Cut results go through an LRU cache so tiles
+    * re-entering the view skip the cutting pass.
+    */
+    class ROCKY_EXPORT FeatureTilePager
+    {
+    public:
+        //! Source features; must remain resident (see buildIndex)
+        std::vector<Feature> features;
+
+        //! Styles to use when compiling features
+        StyleSheet styles;
+
+        //! Tiling scheme to page against; the features must be expressed
+        //! in this profile's SRS
+        Profile profile = Profile("global-geodetic");
+
+        //! Level-of-detail limits for paging
+        unsigned minLevel = 0;
+        unsigned maxLevel = 14;
+
+        //! Virtual tile size (pixels) used to match the view's ground
+        //! resolution to a level of detail
+        unsigned tileSize = 256;
+
+        //! Screen-space error (pixels) to tolerate when generalizing
+        //! linework to a level's resolution
+        float pixelError = 2.0f;
+
+        //! Host entity; set visibility on it to toggle the whole set
+        entt::entity entity = entt::null;
+
+        //! Build the spatial index over "features". Call after populating
+        //! (or changing) the features vector.
+        void buildIndex();
+
+        //! Page tiles in and out for the given view.
+        //! @param registry Entity registry, locked for writing
+        //! @param visible Extent of interest, in the profile's SRS
+        //! @param resolution View ground resolution at the area of interest,
+        //!   in profile SRS units per pixel
+        //! @param srs SRS of resulting geometry
+        //! @param runtime Runtime operations interface
+        //! @return Number of tiles built or released (zero = no change)
+        unsigned update(entt::registry& registry, const GeoExtent& visible, double resolution,
+            const SRS& srs, VSGContext& runtime);
+
+        //! Number of cut-feature tiles to retain after their geometry pages
+        //! out (default 512)
+        void setCacheCapacity(int tiles);
+
+        //! Release all geometry created by update()
+        //! @param registry Entity registry, locked for writing
+        void clear(entt::registry& registry);
+
+        //! Number of tiles currently holding geometry
+        unsigned residentTiles() const { return (unsigned)_tiles.size(); }
+
+    private:
+        // spatial index over "features", keyed by extent (see buildIndex)
+        RTree<unsigned, double, 2> _index;
+        bool _indexed = false;
+
+        // compiles one resident tile's worth of cut features
+        struct Tile
+        {
+            FeatureView view;
+        };
+        std::map<TileKey, Tile> _tiles;
+
+        using CutFeatures = std::shared_ptr<std::vector<Feature>>;
+
+        // cut-and-generalized features by tile key
+        util::LRUCache<TileKey, CutFeatures> _cutCache{ 512 };
+
+        // cuts the source features to one tile, generalizing line work
+        // to the tile's resolution
+        CutFeatures cutTile(const TileKey& key);
+
+        // memory governor registration; established on the first update()
+        // so the ops display can attribute this subsystem's residency
+        std::shared_ptr<MemoryGovernor::Registration> _memoryReg;
+
+        // cache telemetry registration, established alongside _memoryReg
+        std::shared_ptr<util::CacheTelemetry::Registration> _telemetryReg;
+    };
+}
@@ -54,59 +54,62 @@ namespace
         }
     }
 
+    // Appends the left endpoint (and any midpoints needed to keep every
+    // span under max_span) directly to the output buffer, left to right.
+    // Recursion depth is logarithmic in the subdivision count.
     template<class T>
-    void tessellate_line_segment(const T& from, const T& to, const SRS& srs, const GeodeticInterpolation interp, float max_span, std::vector<T>& output, bool add_last_point)
+    void subdivide_and_emit(const T& from, const T& to, const Ellipsoid& ellipsoid, const GeodeticInterpolation interp, float max_span, std::vector<T>& output)
     {
-        //TODO: make it work for projected SRS?
-        ROCKY_SOFT_ASSERT_AND_RETURN(srs.isGeodetic(), void());
-
-        auto& ellipsoid = srs.ellipsoid();
-        std::list<T> list{ from, to };
-        auto iter = list.begin();
-        for (;;)
+        if (ellipsoid.geodesicGroundDistance(from, to) > max_span)
         {
-            auto save = iter;
-            auto& p1 = *iter++;
-            if (iter == list.end())
-                break;
-            auto& p2 = *iter;
+            T midpoint;
 
-            if (ellipsoid.geodesicGroundDistance(p1, p2) > max_span)
+            if (interp == GeodeticInterpolation::GreatCircle)
             {
-                T midpoint;
-
-                if (interp == GeodeticInterpolation::GreatCircle)
-                {
-                    midpoint = ellipsoid.geodesicInterpolate(p1, p2, 0.5);
-                }
-                else // GeodeticInterpolation::RhumbLine
-                {
-                    midpoint = (p1 + p2) * 0.5;
-                }
-                list.insert(iter, midpoint);
-                iter = save;
+                midpoint = ellipsoid.geodesicInterpolate(from, to, 0.5);
+            }
+            else // GeodeticInterpolation::RhumbLine
+            {
+                midpoint = (from + to) * 0.5;
             }
-        }
 
-        for (auto iter = list.begin(); iter != list.end(); ++iter) {
-            auto next = iter; next++;
-            if (add_last_point || next != list.end())
-                output.push_back(*iter);
+            subdivide_and_emit(from, midpoint, ellipsoid, interp, max_span, output);
+            subdivide_and_emit(midpoint, to, ellipsoid, interp, max_span, output);
+        }
+        else
+        {
+            output.push_back(from);
         }
     }
 
-    std::vector<glm::dvec3> tessellate_linestring(const std::vector<glm::dvec3>& input, const SRS& srs, GeodeticInterpolation interp, float max_span)
+    template<class T>
+    void tessellate_line_segment(const T& from, const T& to, const SRS& srs, const GeodeticInterpolation interp, float max_span, std::vector<T>& output, bool add_last_point)
     {
-        std::vector<glm::dvec3> output;
+        //TODO: make it work for projected SRS?
+        ROCKY_SOFT_ASSERT_AND_RETURN(srs.isGeodetic(), void());
+
+        subdivide_and_emit(from, to, srs.ellipsoid(), interp, max_span, output);
+
+        if (add_last_point)
+            output.push_back(to);
+    }
+
+    // Tessellates a linestring into "output" (cleared first). The caller
+    // owns the buffer and can reuse it across parts and features, so a
+    // loop over many parts performs no per-part allocation once the buffer
+    // reaches its steady-state size.
+    void tessellate_linestring(const std::vector<glm::dvec3>& input, const SRS& srs, GeodeticInterpolation interp, float max_span, std::vector<glm::dvec3>& output)
+    {
+        output.clear();
         if (input.size() > 0)
         {
+            output.reserve(input.size());
             for (unsigned i = 1; i < input.size(); ++i)
             {
                 tessellate_line_segment(input[i - 1], input[i], srs, interp, max_span, output, false);
             }
             output.push_back(input.back());
         }
-        return output;
     }
 
     float get_max_segment_length(const std::vector<glm::dvec3>& input)
@@ -119,7 +122,7 @@ namespace
         return m;
     }
 
-    void compile_feature_to_lines(const Feature& feature, const StyleSheet& styles, const SRS& geom_srs, Line& line)
+    void compile_feature_to_lines(const Feature& feature, const StyleSheet& styles, const SRS& geom_srs, Line& line, double tolerance = 0.0)
     {
         float max_span = 100000.0f;
 
@@ -128,16 +131,21 @@ namespace
 
         float final_max_span = max_span;
 
-        Geometry::const_iterator iter(feature.geometry);
+        // one transform and one scratch buffer, reused across all parts:
+        auto feature_to_world = feature.srs.to(geom_srs);
+        std::vector<glm::dvec3> tessellated;
+
+        Geometry::const_iterator iter(feature.geometryForTolerance(tolerance));
         while (iter.hasMore())
         {
             auto& part = iter.next();
 
             // tessellate:
-            auto tessellated = tessellate_linestring(part.points, feature.srs, feature.interpolation, max_span);
+            tessellate_linestring(part.points, feature.srs, feature.interpolation, max_span, tessellated);
+            if (tessellated.size() < 2)
+                continue;
 
             // transform:
-            auto feature_to_world = feature.srs.to(geom_srs);
             feature_to_world.transformRange(tessellated.begin(), tessellated.end());
 
             // Populate the line component based on the topology.
@@ -174,6 +182,98 @@ namespace
         }
     }
 
+    // Tessellates and transforms the selected line-type features in parallel
+    // across the jobs pool, returning one point buffer per feature in the
+    // requested topology. Results come back in input order, so the caller can
+    // concatenate them into a shared Line component deterministically.
+    std::vector<std::vector<vsg::dvec3>> tessellate_features_parallel(
+        const std::vector<Feature>& features,
+        const std::vector<unsigned>& indices,
+        const StyleSheet& styles,
+        const SRS& geom_srs,
+        Line::Topology topology,
+        double tolerance)
+    {
+        std::vector<std::vector<vsg::dvec3>> results(indices.size());
+
+        float max_span = 100000.0f;
+        if (styles.line.has_value())
+            max_span = styles.line->resolution;
+
+        // "tessellated" is a per-job scratch buffer, reused across every
+        // part the job processes:
+        auto tessellate_one = [&](std::size_t k, std::vector<glm::dvec3>& tessellated)
+            {
+                auto& feature = features[indices[k]];
+                auto& output = results[k];
+
+                // PROJ contexts are thread-local, so each job needs its own
+                // copy of the transform:
+                auto feature_to_world = feature.srs.to(geom_srs);
+
+                Geometry::const_iterator iter(feature.geometryForTolerance(tolerance));
+                while (iter.hasMore())
+                {
+                    auto& part = iter.next();
+
+                    tessellate_linestring(part.points, feature.srs, feature.interpolation, max_span, tessellated);
+                    if (tessellated.size() < 2)
+                        continue;
+
+                    feature_to_world.transformRange(tessellated.begin(), tessellated.end());
+
+                    if (topology == Line::Topology::Strip)
+                    {
+                        output.reserve(output.size() + tessellated.size());
+                        for (auto& p : tessellated)
+                            output.emplace_back(p.x, p.y, p.z);
+                    }
+                    else // Line::Topology::Segments
+                    {
+                        output.reserve(output.size() + tessellated.size() * 2 - 2);
+                        for (std::size_t i = 0; i < tessellated.size() - 1; ++i)
+                        {
+                            output.emplace_back(tessellated[i].x, tessellated[i].y, tessellated[i].z);
+                            output.emplace_back(tessellated[i + 1].x, tessellated[i + 1].y, tessellated[i + 1].z);
+                        }
+                    }
+                }
+            };
+
+        // below this count the dispatch overhead exceeds the work:
+        constexpr std::size_t parallel_threshold = 8;
+
+        if (indices.size() < parallel_threshold)
+        {
+            std::vector<glm::dvec3> scratch;
+            for (std::size_t k = 0; k < indices.size(); ++k)
+                tessellate_one(k, scratch);
+        }
+        else
+        {
+            auto concurrency = std::max(1u, jobs::get_pool()->concurrency());
+            std::size_t perChunk = (indices.size() + concurrency - 1) / concurrency;
+            auto group = jobs::jobgroup::create();
+
+            for (std::size_t k0 = 0; k0 < indices.size(); k0 += perChunk)
+            {
+                std::size_t k1 = std::min(k0 + perChunk, indices.size());
+
+                jobs::dispatch([&, k0, k1]()
+                    {
+                        std::vector<glm::dvec3> scratch;
+                        for (std::size_t k = k0; k < k1; ++k)
+                            tessellate_one(k, scratch);
+                    },
+                    jobs::context{ "FeatureView::tessellate", nullptr, {}, group });
+            }
+
+            group->join();
+        }
+
+        return results;
+    }
+
     void compile_polygon_feature_with_weemesh(const Feature& feature, const Geometry& geom, const StyleSheet& styles, const SRS& geom_srs, Mesh& mesh)
     {
         // scales our local gnomonic coordinates so they are the same order of magnitude as
@@ -247,16 +347,19 @@ namespace
         }
 
         // next, apply the segments of the polygon to slice the mesh into triangles.
+        std::vector<weemesh::segment_t> segments;
         Geometry::const_iterator segment_iter(local_geom);
         while (segment_iter.hasMore())
         {
             auto& part = segment_iter.next();
+            segments.reserve(segments.size() + part.points.size());
             for (unsigned i = 0; i < part.points.size(); ++i)
             {
                 unsigned j = (i == part.points.size() - 1) ? 0 : i + 1;
-                m.insert(weemesh::segment_t{ part.points[i], part.points[j] }, marker);
+                segments.emplace_back(part.points[i], part.points[j]);
             }
         }
+        m.insert(segments, marker);
 
         // next we need to remove all the exterior triangles.
         std::unordered_set<weemesh::triangle_t*> insiders;
@@ -318,6 +421,132 @@ namespace
             mesh.triangles.emplace_back(temp);
         }
     }
+
+    // Fast polygon fill for features that need no interior vertices:
+    // triangulates the rings directly with weemesh's ear clipper, skipping
+    // the constrained grid meshing entirely. Returns false on degenerate
+    // input, in which case the caller should use the weemesh path.
+    bool compile_polygon_feature_with_earcut(const Feature& feature, const Geometry& geom, const StyleSheet& styles, const SRS& geom_srs, Mesh& mesh)
+    {
+        if (geom.points.size() < 3)
+            return false;
+
+        // lightweight view of one ring, so the triangulator can walk the
+        // rings without copying them:
+        struct RingRef
+        {
+            const std::vector<glm::dvec3>* points;
+            std::size_t size() const { return points->size(); }
+            const glm::dvec3& operator[](std::size_t i) const { return (*points)[i]; }
+        };
+
+        std::vector<RingRef> rings;
+        rings.push_back(RingRef{ &geom.points }); // outer ring
+        for (auto& hole : geom.parts)
+        {
+            if (hole.points.size() >= 3)
+                rings.push_back(RingRef{ &hole.points });
+        }
+
+        std::vector<unsigned> indices;
+        weemesh::triangulator_t triangulator;
+        if (!triangulator.triangulate(rings, indices))
+            return false;
+
+        // transform the ring vertices to world coordinates, concatenated in
+        // the same order the triangulator indexed them:
+        std::vector<glm::dvec3> world;
+        world.reserve(geom.points.size() + geom.parts.size());
+        for (auto& ring : rings)
+            world.insert(world.end(), ring.points->begin(), ring.points->end());
+
+        auto feature_to_world = feature.srs.to(geom_srs);
+        feature_to_world.transformRange(world.begin(), world.end());
+
+        auto color =
+            styles.mesh_function ? styles.mesh_function(feature).color :
+            styles.mesh.has_value() ? styles.mesh->color :
+            vsg::vec4(1, 1, 1, 1);
+
+        auto depth_offset =
+            styles.mesh_function ? styles.mesh_function(feature).depth_offset :
+            styles.mesh.has_value() ? styles.mesh->depth_offset :
+            0.0f;
+
+        Triangle temp = {
+            {}, // we'll fill in the verts below
+            {color, color, color},
+            {}, // uvs - don't need them
+            {depth_offset, depth_offset, depth_offset} }; // depth offset values
+
+        mesh.triangles.reserve(mesh.triangles.size() + indices.size() / 3);
+
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                auto& p = world[indices[i + k]];
+                temp.verts[k] = vsg::dvec3(p.x, p.y, p.z);
+            }
+            mesh.triangles.emplace_back(temp);
+        }
+
+        return true;
+    }
+
+    // Compiles a polygon feature, picking the fast ear-clipping path when
+    // the feature is small enough not to need earth-curvature subdivision,
+    // and falling back to constrained weemesh triangulation otherwise.
+    void compile_polygon_feature(const Feature& feature, const Geometry& geom, const StyleSheet& styles, const SRS& geom_srs, Mesh& mesh)
+    {
+        // matches the curvature resolution of the weemesh grid; polygons
+        // within it gain nothing from interior subdivision:
+        const double resolution_degrees = 0.25;
+
+        bool earcut_eligible =
+            feature.srs.isGeodetic() &&
+            feature.extent.valid() &&
+            feature.extent.width() <= resolution_degrees &&
+            feature.extent.height() <= resolution_degrees;
+
+        if (earcut_eligible && compile_polygon_feature_with_earcut(feature, geom, styles, geom_srs, mesh))
+            return;
+
+        compile_polygon_feature_with_weemesh(feature, geom, styles, geom_srs, mesh);
+    }
+
+    // Compiles one feature into a shared line component and/or a mesh collection.
+    void compile_feature(const Feature& feature, const StyleSheet& styles, const SRS& geom_srs, Line& line, std::vector<Mesh>& meshes, double tolerance = 0.0)
+    {
+        if (feature.geometry.type == Geometry::Type::LineString ||
+            feature.geometry.type == Geometry::Type::MultiLineString)
+        {
+            compile_feature_to_lines(feature, styles, geom_srs, line, tolerance);
+        }
+        else if (feature.geometry.type == Geometry::Type::Polygon)
+        {
+            auto& mesh = meshes.emplace_back();
+            compile_polygon_feature(feature, feature.geometryForTolerance(tolerance), styles, geom_srs, mesh);
+        }
+        else if (feature.geometry.type == Geometry::Type::MultiPolygon)
+        {
+            auto& mesh = meshes.emplace_back();
+            for (auto& part : feature.geometryForTolerance(tolerance).parts)
+            {
+                compile_polygon_feature(feature, part, styles, geom_srs, mesh);
+            }
+        }
+        else
+        {
+            Log()->warn("FeatureView no support for " + Geometry::typeToString(feature.geometry.type));
+        }
+    }
+
+    // packs a spatial cell coordinate into a map key
+    inline std::int64_t cellKey(int cx, int cy)
+    {
+        return ((std::int64_t)cy << 32) | (std::int64_t)(std::uint32_t)cx;
+    }
 }
 
 
@@ -356,6 +585,150 @@ FeatureView::clear(entt::registry& registry)
         }
     }
     mesh_entities.clear();
+
+    for (auto& [key, cell] : _cells)
+    {
+        if (cell.line_entity != entt::null)
+            registry.destroy(cell.line_entity);
+
+        for (auto entity : cell.mesh_entities)
+            registry.destroy(entity);
+    }
+    _cells.clear();
+
+    _compiled.clear();
+    _dirtyFeatures.clear();
+}
+
+void
+FeatureView::buildIndex()
+{
+    _index.RemoveAll();
+
+    for (unsigned i = 0; i < features.size(); ++i)
+    {
+        auto& extent = features[i].extent;
+        if (extent.valid())
+        {
+            double LL[2]{ extent.xmin(), extent.ymin() };
+            double UR[2]{ extent.xmax(), extent.ymax() };
+            _index.Insert(LL, UR, i);
+        }
+    }
+
+    _indexed = true;
+}
+
+unsigned
+FeatureView::update(entt::registry& registry, const GeoExtent& visible, const SRS& geom_srs, VSGContext& runtime)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(_indexed, 0);
+    ROCKY_SOFT_ASSERT_AND_RETURN(visible.valid() && cellSize > 0.0, 0);
+
+    unsigned changes = 0;
+
+    // the range of cells touching the visible extent:
+    int cx0 = (int)std::floor(visible.xmin() / cellSize);
+    int cx1 = (int)std::floor(visible.xmax() / cellSize);
+    int cy0 = (int)std::floor(visible.ymin() / cellSize);
+    int cy1 = (int)std::floor(visible.ymax() / cellSize);
+
+    // release the geometry of cells that left the visible extent:
+    for (auto iter = _cells.begin(); iter != _cells.end(); )
+    {
+        int cx = (int)(std::int32_t)(iter->first & 0xffffffff);
+        int cy = (int)(std::int32_t)(iter->first >> 32);
+
+        if (cx < cx0 || cx > cx1 || cy < cy0 || cy > cy1)
+        {
+            auto& cell = iter->second;
+
+            if (cell.line_entity != entt::null)
+                registry.destroy(cell.line_entity);
+
+            for (auto mesh_entity : cell.mesh_entities)
+                registry.destroy(mesh_entity);
+
+            iter = _cells.erase(iter);
+            ++changes;
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    // compile the cells that entered it:
+    for (int cy = cy0; cy <= cy1; ++cy)
+    {
+        for (int cx = cx0; cx <= cx1; ++cx)
+        {
+            auto key = cellKey(cx, cy);
+            if (_cells.count(key) > 0)
+                continue;
+
+            Line cell_line;
+            cell_line.topology = Line::Topology::Segments;
+
+            std::vector<Mesh> cell_meshes;
+
+            double LL[2]{ (double)cx * cellSize, (double)cy * cellSize };
+            double UR[2]{ LL[0] + cellSize, LL[1] + cellSize };
+
+            _index.Search(LL, UR, [&](const unsigned& i)
+                {
+                    auto& feature = features[i];
+
+                    // anchor each feature to the cell holding its centroid, so a
+                    // feature spanning several cells compiles exactly once:
+                    double x, y;
+                    feature.extent.getCentroid(x, y);
+
+                    if ((int)std::floor(x / cellSize) == cx && (int)std::floor(y / cellSize) == cy)
+                    {
+                        compile_feature(feature, styles, geom_srs, cell_line, cell_meshes, generalizeTolerance);
+                    }
+                    return true; // keep searching
+                });
+
+            // record the cell even when empty, so we don't re-search it
+            // every time the camera moves within the same cell range:
+            auto& cell = _cells[key];
+            ++changes;
+
+            if (entity == entt::null)
+            {
+                entity = registry.create();
+                registry.emplace<Visibility>(entity);
+            }
+
+            auto& host_visibility = registry.get<Visibility>(entity);
+
+            if (!cell_line.points.empty())
+            {
+                cell.line_entity = registry.create();
+                registry.emplace<Line>(cell.line_entity, std::move(cell_line));
+                registry.get<Visibility>(cell.line_entity).parent = &host_visibility;
+            }
+
+            for (auto& mesh : cell_meshes)
+            {
+                if (!mesh.triangles.empty())
+                {
+                    auto mesh_entity = cell.mesh_entities.emplace_back(registry.create());
+                    registry.emplace<Mesh>(mesh_entity, std::move(mesh));
+                    registry.get<Visibility>(mesh_entity).parent = &host_visibility;
+                }
+            }
+        }
+    }
+
+    if (changes > 0)
+    {
+        runtime->requestFrame();
+    }
+
+    return changes;
 }
 
 void
@@ -369,39 +742,83 @@ FeatureView::generate(entt::registry& registry, const SRS& geom_srs, VSGContext&
 
     auto& host_visibility = registry.get<Visibility>(entity);
 
-    for (auto& feature : features)
+    // record where each feature's output lands, for updateFeatures():
+    _compiled.assign(features.size(), {});
+    _dirtyFeatures.clear();
+
+    // fan the per-feature line tessellation out across the jobs pool, then
+    // gather the results into a single pre-sized Line component:
+    std::vector<unsigned> line_features;
+    for (unsigned i = 0; i < features.size(); ++i)
     {
-        if (feature.geometry.type == Geometry::Type::LineString ||
-            feature.geometry.type == Geometry::Type::MultiLineString)
+        if (features[i].geometry.type == Geometry::Type::LineString ||
+            features[i].geometry.type == Geometry::Type::MultiLineString)
         {
-            if (line_entities.empty())
-                line_entities.emplace_back(registry.create());
+            line_features.emplace_back(i);
+        }
+    }
+
+    if (!line_features.empty())
+    {
+        if (line_entities.empty())
+            line_entities.emplace_back(registry.create());
 
-            auto& entity = line_entities.front();
-            auto& geom = registry.get_or_emplace<Line>(entity);
-            geom.topology = Line::Topology::Segments;
+        auto& line_entity = line_entities.front();
+        auto& geom = registry.get_or_emplace<Line>(line_entity);
+        geom.topology = Line::Topology::Segments;
 
-            registry.get<Visibility>(entity).parent = &host_visibility;
+        registry.get<Visibility>(line_entity).parent = &host_visibility;
+
+        auto buffers = tessellate_features_parallel(features, line_features, styles, geom_srs, geom.topology, generalizeTolerance);
+
+        std::size_t total = geom.points.size();
+        for (auto& buffer : buffers)
+            total += buffer.size();
+        geom.points.reserve(total);
+
+        for (unsigned k = 0; k < buffers.size(); ++k)
+        {
+            auto& record = _compiled[line_features[k]];
+            record.line_first = geom.points.size();
+            record.line_count = buffers[k].size();
+
+            geom.points.insert(geom.points.end(), buffers[k].begin(), buffers[k].end());
+        }
 
-            compile_feature_to_lines(feature, styles, geom_srs, geom);
+        if (styles.line.has_value())
+        {
+            geom.style = styles.line.value();
+        }
+    }
+
+    for (unsigned i = 0; i < features.size(); ++i)
+    {
+        auto& feature = features[i];
+
+        if (feature.geometry.type == Geometry::Type::LineString ||
+            feature.geometry.type == Geometry::Type::MultiLineString)
+        {
+            continue; // compiled above
         }
         else if (feature.geometry.type == Geometry::Type::Polygon)
         {
             auto entity = mesh_entities.emplace_back(registry.create());
             auto& geom = registry.get_or_emplace<Mesh>(entity);
             registry.get<Visibility>(entity).parent = &host_visibility;
+            _compiled[i].mesh_entity = entity;
 
-            compile_polygon_feature_with_weemesh(feature, feature.geometry, styles, geom_srs, geom);
+            compile_polygon_feature(feature, feature.geometryForTolerance(generalizeTolerance), styles, geom_srs, geom);
         }
         else if (feature.geometry.type == Geometry::Type::MultiPolygon)
         {
             auto entity = mesh_entities.emplace_back(registry.create());
             auto& geom = registry.get_or_emplace<Mesh>(entity);
             registry.get<Visibility>(entity).parent = &host_visibility;
+            _compiled[i].mesh_entity = entity;
 
-            for (auto& part : feature.geometry.parts)
+            for (auto& part : feature.geometryForTolerance(generalizeTolerance).parts)
             {
-                compile_polygon_feature_with_weemesh(feature, part, styles, geom_srs, geom);
+                compile_polygon_feature(feature, part, styles, geom_srs, geom);
             }
         }
         else
@@ -413,9 +830,201 @@ FeatureView::generate(entt::registry& registry, const SRS& geom_srs, VSGContext&
     if (!keep_features)
     {
         features.clear();
+        _compiled.clear();
     }
 }
 
+void
+FeatureView::dirtyFeature(std::size_t index)
+{
+    _dirtyFeatures.insert(index);
+}
+
+unsigned
+FeatureView::updateFeatures(entt::registry& registry, const SRS& geom_srs, VSGContext& runtime)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(_compiled.size() == features.size(), 0,
+        "updateFeatures() requires a prior generate() with keep_features=true");
+
+    unsigned count = 0;
+
+    for (auto index : _dirtyFeatures)
+    {
+        if (index >= features.size())
+            continue;
+
+        auto& feature = features[index];
+        auto& record = _compiled[index];
+
+        if (feature.geometry.type == Geometry::Type::LineString ||
+            feature.geometry.type == Geometry::Type::MultiLineString)
+        {
+            if (line_entities.empty())
+                continue;
+
+            auto* line = registry.try_get<Line>(line_entities.front());
+            if (!line)
+                continue;
+
+            // retessellate just this feature:
+            std::vector<unsigned> one{ (unsigned)index };
+            auto buffers = tessellate_features_parallel(features, one, styles, geom_srs, line->topology, generalizeTolerance);
+            auto& fresh = buffers.front();
+
+            if (fresh.size() == record.line_count)
+            {
+                // same vertex count - overwrite the range in place:
+                std::copy(fresh.begin(), fresh.end(), line->points.begin() + record.line_first);
+            }
+            else
+            {
+                // splice the new range in and shift the ranges that follow:
+                auto delta = (std::ptrdiff_t)fresh.size() - (std::ptrdiff_t)record.line_count;
+
+                auto at = line->points.erase(
+                    line->points.begin() + record.line_first,
+                    line->points.begin() + record.line_first + record.line_count);
+
+                line->points.insert(at, fresh.begin(), fresh.end());
+
+                for (auto& other : _compiled)
+                {
+                    if (&other != &record && other.line_first > record.line_first)
+                        other.line_first += delta;
+                }
+
+                record.line_count = fresh.size();
+            }
+
+            line->dirtyPoints();
+            ++count;
+        }
+        else if (
+            feature.geometry.type == Geometry::Type::Polygon ||
+            feature.geometry.type == Geometry::Type::MultiPolygon)
+        {
+            if (record.mesh_entity == entt::null || !registry.valid(record.mesh_entity))
+                continue;
+
+            auto* mesh = registry.try_get<Mesh>(record.mesh_entity);
+            if (!mesh)
+                continue;
+
+            mesh->triangles.clear();
+
+            if (feature.geometry.type == Geometry::Type::Polygon)
+            {
+                compile_polygon_feature(feature, feature.geometryForTolerance(generalizeTolerance), styles, geom_srs, *mesh);
+            }
+            else
+            {
+                for (auto& part : feature.geometryForTolerance(generalizeTolerance).parts)
+                {
+                    compile_polygon_feature(feature, part, styles, geom_srs, *mesh);
+                }
+            }
+
+            mesh->dirty();
+            ++count;
+        }
+    }
+
+    _dirtyFeatures.clear();
+
+    if (count > 0)
+    {
+        runtime->requestFrame();
+    }
+
+    return count;
+}
+
+jobs::future<int>
+FeatureView::generate(std::shared_ptr<FeatureSource> source, ecs::Registry& registry, const SRS& geom_srs,
+    VSGContext& runtime, IOOptions& io, std::function<bool(Feature&)> prepare, unsigned batchSize)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(source, {});
+
+    return jobs::dispatch([this, source, &registry, geom_srs, runtime, io, prepare, batchSize](jobs::cancelable& cancelable) mutable
+        {
+            int count = 0;
+
+            std::vector<Feature> batch;
+            batch.reserve(batchSize);
+
+            // Compiles the pending batch outside the registry lock, then
+            // merges the results under a short write lock so readers (and
+            // the record traversal) never wait out a tessellation.
+            auto flush = [&]()
+                {
+                    if (batch.empty())
+                        return;
+
+                    Line batch_line;
+                    batch_line.topology = Line::Topology::Segments;
+
+                    std::vector<Mesh> batch_meshes;
+
+                    for (auto& feature : batch)
+                    {
+                        compile_feature(feature, styles, geom_srs, batch_line, batch_meshes, generalizeTolerance);
+                    }
+
+                    count += (int)batch.size();
+                    batch.clear();
+
+                    auto [lock, reg] = registry.write();
+
+                    if (entity == entt::null)
+                    {
+                        entity = reg.create();
+                        reg.emplace<Visibility>(entity);
+                    }
+
+                    auto& host_visibility = reg.get<Visibility>(entity);
+
+                    if (!batch_line.points.empty())
+                    {
+                        auto line_entity = line_entities.emplace_back(reg.create());
+                        reg.emplace<Line>(line_entity, std::move(batch_line));
+                        reg.get<Visibility>(line_entity).parent = &host_visibility;
+                    }
+
+                    for (auto& mesh : batch_meshes)
+                    {
+                        if (!mesh.triangles.empty())
+                        {
+                            auto mesh_entity = mesh_entities.emplace_back(reg.create());
+                            reg.emplace<Mesh>(mesh_entity, std::move(mesh));
+                            reg.get<Visibility>(mesh_entity).parent = &host_visibility;
+                        }
+                    }
+
+                    // show what we have so far:
+                    runtime->requestFrame();
+                };
+
+            auto iter = source->iterate(io);
+            while (iter.hasMore() && !cancelable.canceled())
+            {
+                auto feature = iter.next();
+                if (!feature.valid())
+                    continue;
+
+                if (prepare && !prepare(feature))
+                    continue;
+
+                batch.emplace_back(std::move(feature));
+
+                if (batch.size() >= batchSize)
+                    flush();
+            }
+
+            flush();
+            return count;
+        });
+}
+
 void
 FeatureView::dirtyStyles(entt::registry& registry)
 {
@@ -429,7 +1038,7 @@ FeatureView::dirtyStyles(entt::registry& registry)
             if (auto* line = registry.try_get<Line>(entity))
             {
                 line->style = styles.line.value();
-                line->dirty();
+                line->dirtyStyle();
             }
         }
     }
@@ -441,7 +1050,7 @@ FeatureView::dirtyStyles(entt::registry& registry)
             if (auto* mesh = registry.try_get<Mesh>(entity))
             {
                 mesh->style = styles.mesh.value();
-                mesh->dirty();
+                mesh->dirtyStyle();
             }
         }
     }
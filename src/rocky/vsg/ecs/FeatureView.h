@@ -5,13 +5,19 @@
  */
 #pragma once
 #include <rocky/Feature.h>
+#include <rocky/rtree.h>
+#include <rocky/weejobs.h>
 #include <rocky/vsg/ecs/Line.h>
 #include <rocky/vsg/ecs/Mesh.h>
 #include <rocky/vsg/ecs/Icon.h>
+#include <rocky/vsg/ecs/Registry.h>
 #include <rocky/vsg/VSGContext.h>
 
+#include <cstdint>
 #include <optional>
 #include <functional>
+#include <set>
+#include <unordered_map>
 
 namespace ROCKY_NAMESPACE
 {
@@ -40,6 +46,12 @@ namespace ROCKY_NAMESPACE
         //! Styles to use when compiling features
         StyleSheet styles;
 
+        //! Simplification tolerance (in feature SRS units) for selecting a
+        //! precomputed generalization level of each feature when compiling;
+        //! zero compiles full-resolution geometry. Levels must exist on the
+        //! features (see Feature::generalize)
+        double generalizeTolerance = 0.0;
+
         //! Create VSG geometry from the feature list
         //! @param registry Entity registry, locked for writing
         //! @param srs SRS or resulting geometry
@@ -52,6 +64,71 @@ namespace ROCKY_NAMESPACE
             VSGContext& runtime,
             bool keep_features = false);
 
+        //! Create VSG geometry by streaming features from a source in batches,
+        //! on a background job, without ever materializing the whole dataset.
+        //! Each batch is tessellated outside the registry lock and merged under
+        //! a short write lock, so the first geometry appears while the source
+        //! is still reading and peak memory is bounded by the batch size.
+        //!
+        //! Do not touch this object (other than polling the returned future)
+        //! until the job finishes. The registry must outlive the job.
+        //!
+        //! @param source Feature source to read from; must already be open
+        //! @param registry Entity registry (unlocked)
+        //! @param srs SRS of resulting geometry
+        //! @param runtime Runtime operations interface
+        //! @param io I/O options for the feature source
+        //! @param prepare Optional callable applied to each feature before
+        //!   compilation; return false to skip the feature
+        //! @param batchSize Number of features to compile per merge
+        //! @return Future number of features compiled
+        jobs::future<int> generate(
+            std::shared_ptr<FeatureSource> source,
+            ecs::Registry& registry,
+            const SRS& srs,
+            VSGContext& runtime,
+            IOOptions& io,
+            std::function<bool(Feature&)> prepare = {},
+            unsigned batchSize = 512);
+
+        //! Build a spatial index over the "features" vector, keyed by feature
+        //! extent, enabling the view-dependent update() below. Call again if
+        //! the features change.
+        void buildIndex();
+
+        //! Create and destroy geometry per spatial cell so that only features
+        //! near the visible extent hold tessellated geometry. Call whenever the
+        //! camera moves; cells entering the extent compile and cells leaving it
+        //! release their entities. Requires buildIndex() first, and keeps the
+        //! "features" vector resident.
+        //! @param registry Entity registry, locked for writing
+        //! @param visible Extent of interest, in the SRS of the features
+        //! @param srs SRS of resulting geometry
+        //! @param runtime Runtime operations interface
+        //! @return Number of cells built or released (zero = no change)
+        unsigned update(entt::registry& registry, const GeoExtent& visible, const SRS& srs, VSGContext& runtime);
+
+        //! Size of one spatial cell, in feature SRS units (e.g. degrees),
+        //! for the view-dependent update()
+        double cellSize = 10.0;
+
+        //! Mark a single feature (an index into "features") as edited, so the
+        //! next updateFeatures() recompiles just that feature instead of
+        //! regenerating the whole view
+        void dirtyFeature(std::size_t index);
+
+        //! Recompile only the features marked with dirtyFeature(), replacing
+        //! their geometry in place: a line feature's vertex range is spliced
+        //! into the shared Line component, and a polygon feature's Mesh is
+        //! re-triangulated on its existing entity. Requires a prior generate()
+        //! with keep_features=true, and a feature's geometry family (line vs.
+        //! polygon) must not change between updates.
+        //! @param registry Entity registry, locked for writing
+        //! @param srs SRS of resulting geometry
+        //! @param runtime Runtime operations interface
+        //! @return Number of features recompiled
+        unsigned updateFeatures(entt::registry& registry, const SRS& srs, VSGContext& runtime);
+
         //! Deletes any geometries previously created by generate()
         //! @param registry Entity registry, locked for writing
         void clear(entt::registry& registry);
@@ -74,5 +151,29 @@ namespace ROCKY_NAMESPACE
         entt::entity entity = entt::null;
         std::vector<entt::entity> mesh_entities;
         std::vector<entt::entity> line_entities;
+
+    private:
+        // spatial index over "features", keyed by extent (see buildIndex)
+        RTree<unsigned, double, 2> _index;
+        bool _indexed = false;
+
+        // entities holding the geometry of one resident spatial cell
+        struct Cell
+        {
+            entt::entity line_entity = entt::null;
+            std::vector<entt::entity> mesh_entities;
+        };
+        std::unordered_map<std::int64_t, Cell> _cells;
+
+        // where each feature's compiled output lives, recorded by generate()
+        // so updateFeatures() can replace it in place
+        struct CompiledFeature
+        {
+            entt::entity mesh_entity = entt::null; // polygon features
+            std::size_t line_first = 0;            // line features: vertex range
+            std::size_t line_count = 0;            //   in the shared Line component
+        };
+        std::vector<CompiledFeature> _compiled;
+        std::set<std::size_t> _dirtyFeatures;
     };
 }
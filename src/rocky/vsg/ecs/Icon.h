@@ -15,9 +15,28 @@ namespace ROCKY_NAMESPACE
      */
     struct IconStyle
     {
+        //! How the icon's rotation is anchored (indirect renderer only).
+        enum Alignment
+        {
+            //! rotation is fixed relative to the screen (the default)
+            ALIGN_SCREEN = 0,
+            //! rotation is measured from the world +X axis as projected
+            //! on screen, so the icon turns with the view heading
+            ALIGN_WORLD = 1
+        };
+
         float size_pixels = 256.0f;
         float rotation_radians = 0.0f;
-        float padding[2];
+
+        //! Continuous spin rate in radians per second, evaluated against
+        //! the frame clock on the GPU (indirect renderer only). A
+        //! steadily rotating icon (radar sweep, spinner) animates with
+        //! no per-frame component updates at all.
+        float rotation_rate = 0.0f;
+
+        //! Alignment mode; one of the Alignment values above.
+        //! (Stored as float to keep the UBO layout trivial.)
+        float alignment = (float)ALIGN_SCREEN;
     };
 
     /**
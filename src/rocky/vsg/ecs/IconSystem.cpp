@@ -26,6 +26,17 @@ using namespace ROCKY_NAMESPACE;
 
 namespace
 {
+    // GPU layout of the icon style UBO, including the image's placement
+    // in the shared texture atlas. Must match the "icon" block in the
+    // shaders.
+    struct IconStyleGPU
+    {
+        IconStyle style;
+        vsg::vec4 uvrect;
+        float layer;
+        float padding[3];
+    };
+
     vsg::ref_ptr<vsg::ShaderSet> createShaderSet(VSGContext& context)
     {
         vsg::ref_ptr<vsg::ShaderSet> shaderSet;
@@ -85,7 +96,8 @@ IconSystemNode::IconSystemNode(ecs::Registry& registry) :
 void
 IconSystemNode::initialize(VSGContext& context)
 {
-    auto shaderSet = createShaderSet(context);
+    auto shaderSet = context->getOrCreateShaderSet("rocky.icon",
+        [&]() { return createShaderSet(context); });
 
     if (!shaderSet)
     {
@@ -152,20 +164,13 @@ IconSystemNode::initialize(VSGContext& context)
         c.commands->addChild(vsg::BindViewDescriptorSets::create(VK_PIPELINE_BIND_POINT_GRAPHICS, c.config->layout, VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX));
 
     }
-}
 
-namespace
-{
-    template<typename CACHE, typename MUTEX, typename CREATE>
-    vsg::ref_ptr<vsg::DescriptorImage>& getOrCreate(CACHE& cache, MUTEX& mutex, std::shared_ptr<Image> key, CREATE&& create)
-    {
-        std::scoped_lock L(mutex);
-        auto iter = cache.find(key);
-        if (iter != cache.end())
-            return iter->second;
-        else
-            return cache[key] = create();
-    }
+    // one descriptor for the shared atlas texture; every icon's
+    // descriptor set reuses it, so VSG can share the sets and the
+    // icon pass never rebinds a texture.
+    atlasDescriptor = vsg::DescriptorImage::create(
+        vsg::ImageInfoList{ atlas.imageInfo },
+        TEXTURE_BINDING, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 }
 
 void
@@ -199,40 +204,25 @@ IconSystemNode::createOrUpdateNode(Icon& icon, ecs::BuildInfo& data, VSGContext&
         auto ubo = vsg::DescriptorBuffer::create(bindCommand->_styleData, BUFFER_BINDING, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
         descriptors.emplace_back(ubo);
 
-        // make a default image if we don't have one
+        // fall back on a shared default image if we don't have one
+        // (shared so every imageless icon maps to the same atlas entry)
         auto image = icon.image;
         if (!image)
         {
-            image = Image::create(Image::R8G8B8A8_UNORM, 1, 1);
-            image->write(Color::Red, 0, 0);
+            static std::shared_ptr<Image> default_image = []()
+                {
+                    auto i = Image::create(Image::R8G8B8A8_UNORM, 1, 1);
+                    i->write(Color::Red, 0, 0);
+                    return i;
+                }();
+            image = default_image;
         }
 
-        // check the cache.
-        auto& descriptorImage = getOrCreate(descriptorImage_cache, mutex, icon.image, [&]()
-            {
-                auto imageData = util::moveImageToVSG(image);
-
-                // A sampler for the texture:
-                auto sampler = vsg::Sampler::create();
-                sampler->maxLod = 5; // this alone will prompt mipmap generation!
-                sampler->minFilter = VK_FILTER_LINEAR;
-                sampler->magFilter = VK_FILTER_LINEAR;
-                sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-                sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-                sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-                sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-                sampler->anisotropyEnable = VK_TRUE; // don't need this for a billboarded icon
-                sampler->maxAnisotropy = 4.0f;
-
-                return vsg::DescriptorImage::create(
-                    sampler,
-                    imageData,
-                    TEXTURE_BINDING,
-                    0, // array element (TODO: increment when we change to an array)
-                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-            });
-
-        descriptors.emplace_back(descriptorImage);
+        // pack the image into the shared atlas (or find it there if
+        // another icon already added it):
+        bindCommand->updatePlacement(atlas.getOrAdd(image));
+
+        descriptors.emplace_back(atlasDescriptor);
 
         auto layout = getPipelineLayout(icon);
 
@@ -266,15 +256,31 @@ BindIconStyle::updateStyle(const IconStyle& value)
 {
     if (!_styleData)
     {
-        _styleData = vsg::ubyteArray::create(sizeof(IconStyle));
+        _styleData = vsg::ubyteArray::create(sizeof(IconStyleGPU));
 
         // tells VSG that the contents can change, and if they do, the data should be
         // transfered to the GPU before or during recording.
         _styleData->properties.dataVariance = vsg::DYNAMIC_DATA;
+
+        // no placement until updatePlacement runs:
+        auto& gpu = *static_cast<IconStyleGPU*>(_styleData->dataPointer());
+        gpu.uvrect = vsg::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        gpu.layer = -1.0f;
     }
 
-    IconStyle& my_style = *static_cast<IconStyle*>(_styleData->dataPointer());
-    my_style = value;
+    auto& gpu = *static_cast<IconStyleGPU*>(_styleData->dataPointer());
+    gpu.style = value;
+    _styleData->dirty();
+}
+
+void
+BindIconStyle::updatePlacement(const TextureAtlas::Placement& value)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(_styleData, void());
+
+    auto& gpu = *static_cast<IconStyleGPU*>(_styleData->dataPointer());
+    gpu.uvrect = value.uvrect;
+    gpu.layer = (float)value.layer;
     _styleData->dirty();
 }
 
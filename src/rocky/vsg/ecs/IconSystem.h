@@ -6,6 +6,7 @@
 #pragma once
 #include <rocky/vsg/ecs/Icon.h>
 #include <rocky/vsg/ecs/ECSNode.h>
+#include <rocky/vsg/TextureAtlas.h>
 
 namespace ROCKY_NAMESPACE
 {
@@ -21,6 +22,9 @@ namespace ROCKY_NAMESPACE
         //! Refresh the data buffer contents on the GPU
         void updateStyle(const IconStyle&);
 
+        //! Set the icon's location in the shared texture atlas
+        void updatePlacement(const TextureAtlas::Placement&);
+
         vsg::ref_ptr<vsg::Data> _image;
         vsg::ref_ptr<vsg::ubyteArray> _styleData;
         vsg::ref_ptr<vsg::Data> _imageData;
@@ -70,8 +74,9 @@ namespace ROCKY_NAMESPACE
         //! Called by the helper to initialize a new node component.
         void createOrUpdateNode(Icon&, ecs::BuildInfo&, VSGContext&) const override;
 
-        // cache of image descriptors so we can re-use textures & samplers
-        mutable std::unordered_map<std::shared_ptr<Image>, vsg::ref_ptr<vsg::DescriptorImage>> descriptorImage_cache;
-        mutable std::mutex mutex;
+        // shared atlas holding every icon image, so all icons render with
+        // one bound texture regardless of symbol diversity
+        mutable TextureAtlas atlas;
+        vsg::ref_ptr<vsg::DescriptorImage> atlasDescriptor;
     };
 }
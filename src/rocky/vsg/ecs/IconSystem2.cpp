@@ -6,6 +6,7 @@
  */
 #include "IconSystem2.h"
 #include "../VSGContext.h"
+#include "../MaterialTable.h"
 #include "../PipelineState.h"
 #include "../Utils.h"
 #include <rocky/Color.h>
@@ -26,8 +27,11 @@ using namespace ROCKY_NAMESPACE;
 #define INDIRECT_COMMAND_BUFFER_BINDING  0  // indirect command buffer
 #define CULL_LIST_BUFFER_BINDING 1  // input instance buffer
 #define DRAW_LIST_BUFFER_BINDING 2  // output draw_list buffer
-#define SAMPLER_BINDING  3  // shared sampler uniform 
+#define HZB_BINDING 3  // depth pyramid sampler (cull set only)
+#define HZB_PARAMS_BINDING 4  // depth pyramid params UBO (cull set only)
+#define SAMPLER_BINDING  3  // shared sampler uniform
 #define TEXTURES_BINDING 4  // array of textures uniform
+#define CLOCK_BINDING 6  // frame clock UBO (render set only; 5 is the material table)
 
 #define INDIRECT_COMMAND_BUFFER_NAME "command"
 #define CULL_LIST_BUFFER_NAME "cull_list"
@@ -37,7 +41,6 @@ using namespace ROCKY_NAMESPACE;
 
 #define MAX_CULL_LIST_SIZE 16384
 #define GPU_CULLING_LOCAL_WG_SIZE 32 // TODO UP THIS TO 32 or 64
-#define MAX_NUM_TEXTURES 1
 
 namespace
 {
@@ -120,14 +123,12 @@ namespace
     }
 
 
-    vsg::ref_ptr<vsg::ImageInfo> makeDefaultImageInfo(IOOptions& io, vsg::ref_ptr<vsg::Sampler> sampler = {})
+    std::shared_ptr<Image> makeDefaultImage(IOOptions& io)
     {
 #if 1
         const char* icon_location = "https://readymap.org/readymap/filemanager/download/public/icons/airport.png";
         auto image = io.services.readImageFromURI(icon_location, io);
-        auto imageData = util::moveImageToVSG(image.value);
-        auto imageInfo = vsg::ImageInfo::create(sampler, imageData, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        return imageInfo;
+        return image.value;
 #else
         const int d = 16;
         auto image = Image::create(Image::R8G8B8A8_UNORM, d, d);
@@ -137,9 +138,7 @@ namespace
             image->write(Color::Red, i, i);
             image->write(Color::Red, i, d - i - 1);
         }
-
-        auto imageData = util::moveImageToVSG(image);
-        return vsg::ImageInfo::create(sampler, imageData, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        return image;
 #endif
     }
 }
@@ -183,20 +182,14 @@ IconSystem2Node::initialize(VSGContext& context)
         sizeof(IconInstanceGPU) * MAX_CULL_LIST_SIZE,
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
 
-    // A shared sampler for our texture arena
-    auto sampler = vsg::Sampler::create();
-    sampler->maxLod = 5; // this alone will prompt mipmap generation!
-    sampler->minFilter = VK_FILTER_LINEAR;
-    sampler->magFilter = VK_FILTER_LINEAR;
-    sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    sampler->anisotropyEnable = VK_TRUE; // don't need this for a billboarded icon
-    sampler->maxAnisotropy = 4.0f;
-
-    // Place a default texture in the arena for now.
-    textures.emplace_back(makeDefaultImageInfo(context->io, sampler));
+    // default icon for entities with no image of their own.
+    default_image = makeDefaultImage(context->io);
+
+    // frame clock; per-instance rotation rates animate against this in
+    // the vertex shader.
+    clock_start = std::chrono::steady_clock::now();
+    clock_data = vsg::vec4Value::create(vsg::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    clock_data->properties.dataVariance = vsg::DYNAMIC_DATA;
 
     buildCullStage(context);
 
@@ -221,7 +214,9 @@ IconSystem2Node::buildCullStage(VSGContext& context)
     {
         {INDIRECT_COMMAND_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
         {CULL_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
-        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {HZB_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {HZB_PARAMS_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
     };
 
     auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
@@ -256,6 +251,33 @@ IconSystem2Node::buildCullStage(VSGContext& context)
         VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
 
 
+    // Depth-pyramid descriptors. When no pyramid is wired in, bind a 1x1
+    // far-depth placeholder with the valid flag cleared so the shader's
+    // occlusion test passes everything; either way the pipeline layout
+    // stays the same.
+    vsg::ref_ptr<vsg::ImageInfo> hzb_image;
+    vsg::ref_ptr<vsg::vec4Value> hzb_params;
+
+    if (depthPyramid && depthPyramid->status.ok())
+    {
+        hzb_image = depthPyramid->pyramid;
+        hzb_params = depthPyramid->params;
+    }
+    else
+    {
+        auto placeholder = vsg::floatArray2D::create(1, 1, 0.0f); // 0 = far plane (reverse depth)
+        placeholder->properties.format = VK_FORMAT_R32_SFLOAT;
+        hzb_image = vsg::ImageInfo::create(vsg::Sampler::create(), placeholder, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        hzb_params = vsg::vec4Value::create(vsg::vec4(1.0f, 1.0f, 0.0f, 0.0f));
+    }
+
+    auto hzb_descriptor = vsg::DescriptorImage::create(
+        vsg::ImageInfoList{ hzb_image },
+        HZB_BINDING, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+    auto hzb_params_descriptor = vsg::DescriptorBuffer::create(
+        hzb_params, HZB_PARAMS_BINDING);
+
     // bind all our descriptors to the pipeline.
     auto bind_descriptors = vsg::BindDescriptorSet::create(
         VK_PIPELINE_BIND_POINT_COMPUTE,
@@ -263,12 +285,16 @@ IconSystem2Node::buildCullStage(VSGContext& context)
         vsg::DescriptorSet::create(
             descriptor_set_layout,
             vsg::Descriptors{
-                indirect_command->descriptor, cull_list->descriptor, draw_list_descriptor }));
+                indirect_command->descriptor, cull_list->descriptor, draw_list_descriptor,
+                hzb_descriptor, hzb_params_descriptor }));
 
 
-    // stick it all under the compute graph.
+    // stick it all under the compute graph. The shared material table
+    // streams here too (a no-op if another system already installed it).
     auto cg = context->getComputeCommandGraph();
 
+    context->materials->install(cg);
+
     cg->addChild(indirect_command);
     cg->addChild(cull_list);
     cg->addChild(bind_pipeline);
@@ -279,7 +305,8 @@ IconSystem2Node::buildCullStage(VSGContext& context)
 void
 IconSystem2Node::buildRenderStage(VSGContext& context)
 {
-    auto shader_set = createRenderingShaderSet(context);
+    auto shader_set = context->getOrCreateShaderSet("rocky.icon.indirect",
+        [&]() { return createRenderingShaderSet(context); });
     if (!shader_set)
     {
         status = Status(Status::ResourceUnavailable,
@@ -303,7 +330,9 @@ IconSystem2Node::buildRenderStage(VSGContext& context)
     {
         {INDIRECT_COMMAND_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
         {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
-        {TEXTURES_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_NUM_TEXTURES, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}
+        {TEXTURES_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},
+        {MaterialTable::BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {CLOCK_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr}
     };
 
     // PC's hold the projection and modelview matrices from VSG.
@@ -363,17 +392,24 @@ IconSystem2Node::buildRenderStage(VSGContext& context)
     auto pipeline = vsg::GraphicsPipeline::create(pipeline_layout, shader_set->getShaderStages(), pipeline_states);
     auto bind_pipeline = vsg::BindGraphicsPipeline::create(pipeline);
 
+    // the shared material atlas holds every icon image:
     auto textures_descriptor = vsg::DescriptorImage::create(
-        vsg::ImageInfoList{ textures },
+        vsg::ImageInfoList{ context->materials->atlas.imageInfo },
         TEXTURES_BINDING, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
+    auto clock_descriptor = vsg::DescriptorBuffer::create(
+        clock_data, CLOCK_BINDING);
+
     auto bind_descriptor_sets = vsg::BindDescriptorSet::create(
         VK_PIPELINE_BIND_POINT_GRAPHICS,
         pipeline_layout,
         DESCRIPTOR_SET_INDEX,
         vsg::DescriptorSet::create(
             descriptor_set_layout,
-            vsg::Descriptors{ draw_list_descriptor, textures_descriptor }));
+            vsg::Descriptors{
+                draw_list_descriptor, textures_descriptor,
+                context->materials->buffer->descriptor,
+                clock_descriptor }));
 
     auto bind_view_dependent_descriptor_sets = view_dependent_binding->createStateCommand(pipeline_layout);
 
@@ -431,20 +467,6 @@ IconSystem2Node::buildRenderStage(VSGContext& context)
     this->addChild(geometry);
 }
 
-namespace
-{
-    template<typename CACHE, typename MUTEX, typename CREATE>
-    vsg::ref_ptr<vsg::DescriptorImage>& getOrCreate(CACHE& cache, MUTEX& mutex, std::shared_ptr<Image> key, CREATE&& create)
-    {
-        std::scoped_lock L(mutex);
-        auto iter = cache.find(key);
-        if (iter != cache.end())
-            return iter->second;
-        else
-            return cache[key] = create();
-    }
-}
-
 void
 IconSystem2Node::update(VSGContext& context)
 {
@@ -459,10 +481,17 @@ IconSystem2Node::update(VSGContext& context)
     cmd = VkDrawIndexedIndirectCommand{ 6, 0, 0, 0, 0 };
     indirect_command->dirty();
 
+    // advance the frame clock; the vertex shader animates per-instance
+    // rotation rates against it.
+    clock_data->value().x = std::chrono::duration<float>(
+        std::chrono::steady_clock::now() - clock_start).count();
+    clock_data->dirty();
+
     // update the cull list
     auto* instances = cull_list->data<IconInstanceGPU>();
 
     int count = 0;
+    bool animating = false;
 
     auto [lock, registry] = _registry.read();
 
@@ -473,6 +502,10 @@ IconSystem2Node::update(VSGContext& context)
 
     view.each([&](auto& icon, auto& active, auto& visibility, auto& transformData)
         {
+            // shared material; packs the image into the atlas on first sight:
+            auto material_index = context->materials->getOrAdd(
+                MaterialGPU{}, icon.image ? icon.image : default_image);
+
             for (auto viewID : context->activeViewIDs)
             {
                 if (ecs::visible(visibility, viewID))
@@ -485,11 +518,21 @@ IconSystem2Node::update(VSGContext& context)
                     instance.viewport = view.viewport;
                     instance.size = icon.style.size_pixels;
                     instance.rotation = icon.style.rotation_radians;
-                    instance.texture_index = 0;
+                    instance.material = material_index;
+                    instance.rotation_rate = icon.style.rotation_rate;
+                    instance.alignment = icon.style.alignment;
+
+                    if (icon.style.rotation_rate != 0.0f)
+                        animating = true;
                 }
             }
         });
 
+    // a continuously rotating icon needs frames even though nothing on
+    // the CPU side is changing:
+    if (animating)
+        context->requestFrame();
+
 
     // configure the culling shader for 'count' instances
     unsigned workgroups = (count + (GPU_CULLING_LOCAL_WG_SIZE - 1)) / GPU_CULLING_LOCAL_WG_SIZE;
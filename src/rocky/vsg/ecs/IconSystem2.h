@@ -6,11 +6,15 @@
 #pragma once
 #include <rocky/vsg/ecs/Icon.h>
 #include <rocky/vsg/ecs/ECSNode.h>
+#include <rocky/vsg/DepthPyramid.h>
 #include <rocky/vsg/PipelineState.h>
+#include <chrono>
 
 namespace ROCKY_NAMESPACE
 {
-    //! Instance buffer as mirrored in the culling compute shader
+    //! Instance buffer as mirrored in the culling compute shader.
+    //! The atlas placement lives in the shared MaterialTable; the
+    //! instance carries just an index into it.
     struct IconInstanceGPU
     {
         vsg::mat4 proj;
@@ -18,9 +22,11 @@ namespace ROCKY_NAMESPACE
         vsg::vec4 viewport = { 0,0,0,0 };   // x,y = lower left, z,w = width, height
         float rotation = 0.0f;              // radians
         float size = 0.0f;                  // pixels
-        std::int32_t texture_index = 0;     // texture array index
+        std::uint32_t material = 0;         // index into the shared MaterialTable
+        float rotation_rate = 0.0f;         // radians/second, applied against the frame clock
+        float alignment = 0.0f;             // IconStyle::Alignment
 
-        float padding[1];
+        float padding[3];
         // keep me 16-byte aligned with padding please
     };
 
@@ -40,15 +46,18 @@ namespace ROCKY_NAMESPACE
         //! Update pass (called once per frame before recording starts)
         void update(VSGContext&) override;
 
+        //! Optional depth pyramid for GPU occlusion culling. When set
+        //! before the system initializes, the culler tests each instance
+        //! against the pyramid and drops icons hidden behind terrain. When
+        //! null (the default), a far-depth placeholder is bound and the
+        //! occlusion test passes everything.
+        vsg::ref_ptr<DepthPyramid> depthPyramid;
+
     protected:
         virtual ~IconSystem2Node();
 
     private:
 
-        // cache of image descriptors so we can re-use textures & samplers
-        mutable std::unordered_map<std::shared_ptr<Image>, vsg::ref_ptr<vsg::DescriptorImage>> descriptorImage_cache;
-        mutable std::mutex mutex;
-
         // dispatch command for the GPU culler
         vsg::ref_ptr<vsg::Dispatch> cull_dispatch;
 
@@ -62,9 +71,15 @@ namespace ROCKY_NAMESPACE
         // GPU-side draw list binding
         vsg::ref_ptr<vsg::DescriptorBuffer> draw_list_descriptor;
 
-        // array of textures
-        vsg::ref_ptr<vsg::Sampler> sampler;
-        vsg::ImageInfoList textures;
+        // image for entities with no icon of their own; packed into the
+        // shared material atlas on first use
+        std::shared_ptr<Image> default_image;
+
+        // frame clock UBO (seconds since system start); the vertex shader
+        // evaluates per-instance rotation rates against it so animating
+        // icons need no CPU-side updates
+        vsg::ref_ptr<vsg::vec4Value> clock_data;
+        std::chrono::steady_clock::time_point clock_start;
 
         mutable int dirtyCount = 0;
 
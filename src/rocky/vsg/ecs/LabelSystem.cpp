@@ -26,12 +26,62 @@
 
 using namespace ROCKY_NAMESPACE;
 
+#define VERT_SHADER "shaders/rocky.label.vert"
+#define FRAG_SHADER "shaders/rocky.label.frag"
+
+#define TEXTURE_SET 0 // must match layout(set=X) in the fragment shader
+#define TEXTURE_BINDING 0 // must match layout(binding=X) in the fragment shader
 
 #define LABEL_MAX_NUM_CHARS 255
 
 
 namespace
 {
+    //! Shader set for SDF text rendering. The font atlas is a signed-distance
+    //! field, so one atlas serves every label size and the fragment shader
+    //! evaluates fill, antialiasing, and the outline halo from the distance
+    //! value. The attribute names and locations match the vertex arrays that
+    //! vsg::CpuLayoutTechnique produces.
+    vsg::ref_ptr<vsg::ShaderSet> createShaderSet(VSGContext& context)
+    {
+        auto vertexShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_VERTEX_BIT,
+            "main",
+            vsg::findFile(VERT_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        auto fragmentShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+            "main",
+            vsg::findFile(FRAG_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (!vertexShader || !fragmentShader)
+        {
+            return { };
+        }
+
+        auto shaderSet = vsg::ShaderSet::create(vsg::ShaderStages{ vertexShader, fragmentShader });
+
+        // "binding" (3rd param) must match "layout(location=X) in" in the vertex shader
+        shaderSet->addAttributeBinding("inPosition", "", 0, VK_FORMAT_R32G32B32_SFLOAT, {});
+        shaderSet->addAttributeBinding("inColor", "", 1, VK_FORMAT_R32G32B32A32_SFLOAT, {});
+        shaderSet->addAttributeBinding("inOutlineColor", "", 2, VK_FORMAT_R32G32B32A32_SFLOAT, {});
+        shaderSet->addAttributeBinding("inOutlineWidth", "", 3, VK_FORMAT_R32_SFLOAT, {});
+        shaderSet->addAttributeBinding("inTexCoord", "", 4, VK_FORMAT_R32G32B32_SFLOAT, {});
+
+        // the font's SDF glyph atlas
+        shaderSet->addDescriptorBinding(
+            "textureAtlas", "",
+            TEXTURE_SET, TEXTURE_BINDING,
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
+
+        // Note: 128 is the maximum size required by the Vulkan spec so don't increase it
+        shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+        return shaderSet;
+    }
+
     /**
     * Custom layout technique that only issues the geometry drawing commands
     * and skips the decriptor and pipeline binds. When grouping lots of text draws together
@@ -210,9 +260,22 @@ LabelSystemNode::LabelSystemNode(ecs::Registry& registry) :
 void
 LabelSystemNode::initialize(VSGContext& runtime)
 {
-    // use the VSG stock shaders for text:
+    // vsg::Text::setup still resolves the stock "text" shader set internally,
+    // so register it even though our custom technique ignores its commands:
     auto& options = runtime->readerWriterOptions;
-    auto shaderSet = options->shaderSets["text"] = vsg::createTextShaderSet(options);
+    options->shaderSets["text"] = vsg::createTextShaderSet(options);
+
+    // our own SDF text shaders (one atlas, every size, GPU outline/halo):
+    auto shaderSet = runtime->getOrCreateShaderSet("rocky.label",
+        [&]() { return createShaderSet(runtime); });
+
+    if (!shaderSet)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Label shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        return;
+    }
 
     // Configure the text shader set to turn off depth testing
     auto depthStencilState = vsg::DepthStencilState::create();
@@ -222,6 +285,9 @@ LabelSystemNode::initialize(VSGContext& runtime)
 
     auto config = vsg::GraphicsPipelineConfigurator::create(shaderSet);
 
+    // Apply any custom compile settings / defines:
+    config->shaderHints = runtime->shaderCompileSettings;
+
     // Taken from vsg::CpuLayoutTechnique
     config->enableArray("inPosition", VK_VERTEX_INPUT_RATE_VERTEX, 12);
     config->enableArray("inColor", VK_VERTEX_INPUT_RATE_INSTANCE, 16);
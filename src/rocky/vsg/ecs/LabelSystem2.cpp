@@ -0,0 +1,548 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "LabelSystem2.h"
+#include "../VSGContext.h"
+#include "../MaterialTable.h"
+#include "../PipelineState.h"
+#include "../Utils.h"
+
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ViewDependentState.h>
+#include <vsg/commands/DrawIndexed.h>
+#include <vsg/text/Font.h>
+
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+#define VERT_SHADER "shaders/rocky.label.indirect.vert"
+#define FRAG_SHADER "shaders/rocky.label.indirect.frag"
+#define CULL_SHADER "shaders/rocky.label.indirect.cull.comp"
+
+// these must match the layout() defs in the shaders.
+#define DESCRIPTOR_SET_INDEX 0  // must match layout(set=X) in the shaders
+
+#define INDIRECT_COMMAND_BUFFER_BINDING 0  // indirect command buffer
+#define CULL_LIST_BUFFER_BINDING 1  // input instance buffer
+#define DRAW_LIST_BUFFER_BINDING 2  // output draw_list buffer
+#define GLYPH_BUFFER_BINDING 3  // shared laid-out glyph buffer
+#define ATLAS_BINDING 4  // shared glyph atlas texture
+
+#define MAX_CULL_LIST_SIZE 16384
+#define MAX_GLYPH_LIST_SIZE 262144
+#define GPU_CULLING_LOCAL_WG_SIZE 32
+
+namespace
+{
+    //! Create a shader set for the culling compute shader.
+    vsg::ref_ptr<vsg::ShaderStage> createCullingShader(VSGContext& context)
+    {
+        auto computeShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            "main",
+            vsg::findFile(CULL_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (computeShader)
+        {
+            // Specializations to pass to the shader
+            computeShader->specializationConstants = vsg::ShaderStage::SpecializationConstants{
+                {0, vsg::intValue::create(GPU_CULLING_LOCAL_WG_SIZE)} }; // layout(load_size_x_id, 0) in
+        }
+
+        return computeShader;
+    }
+
+    //! Load and configure the shader stages for rendering.
+    vsg::ref_ptr<vsg::ShaderSet> createRenderingShaderSet(VSGContext& context)
+    {
+        auto vertexShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_VERTEX_BIT,
+            "main",
+            vsg::findFile(VERT_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        auto fragmentShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+            "main",
+            vsg::findFile(FRAG_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (!vertexShader || !fragmentShader)
+        {
+            return { };
+        }
+
+        auto shaderSet = vsg::ShaderSet::create(vsg::ShaderStages{ vertexShader, fragmentShader });
+
+        // We need VSG's view-dependent data:
+        PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_VERTEX_BIT);
+
+        // Note: 128 is the maximum size required by the Vulkan spec so don't increase it
+        shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+        return shaderSet;
+    }
+}
+
+LabelSystem2Node::LabelSystem2Node(ecs::Registry& registry) :
+    ecs::System(registry)
+{
+    auto [lock, r] = registry.write();
+
+    r.on_construct<Label>().template connect<&ecs::detail::SystemNode_on_construct<Label>>();
+    r.on_update<Label>().template connect<&ecs::detail::SystemNode_on_update<Label>>();
+    r.on_destroy<Label>().template connect<&ecs::detail::SystemNode_on_destroy<Label>>();
+}
+
+LabelSystem2Node::~LabelSystem2Node()
+{
+    auto [lock, registry] = _registry.write();
+
+    registry.on_construct<Label>().template disconnect<&ecs::detail::SystemNode_on_construct<Label>>();
+    registry.on_update<Label>().template disconnect<&ecs::detail::SystemNode_on_update<Label>>();
+    registry.on_destroy<Label>().template disconnect<&ecs::detail::SystemNode_on_destroy<Label>>();
+}
+
+void
+LabelSystem2Node::initialize(VSGContext& context)
+{
+    // a dynamic SSBO that holds the draw-indirect command. The compute shader will write to this
+    // and the rendering shader will read from it.
+    indirect_command = StreamingGPUBuffer::create(
+        INDIRECT_COMMAND_BUFFER_BINDING,
+        sizeof(VkDrawIndexedIndirectCommand),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+    // a dynamic SSBO holding one instance record per label entity per view.
+    // The CPU populates it each frame; the compute shader culls from it and
+    // the vertex shader reads style and matrices from it.
+    cull_list = StreamingGPUBuffer::create(
+        CULL_LIST_BUFFER_BINDING,
+        sizeof(LabelInstanceGPU) * MAX_CULL_LIST_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    // a dynamic SSBO with the laid-out glyph quads for every label.
+    // Only re-streamed when some label actually changes.
+    glyphs = StreamingGPUBuffer::create(
+        GLYPH_BUFFER_BINDING,
+        sizeof(LabelGlyphGPU) * MAX_GLYPH_LIST_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    buildCullStage(context);
+
+    buildRenderStage(context);
+}
+
+void
+LabelSystem2Node::buildCullStage(VSGContext& context)
+{
+    // Configure the compute pipeline for culling:
+    auto compute_shader = createCullingShader(context);
+    if (!compute_shader)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Label compute shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+
+        return;
+    }
+
+    vsg::DescriptorSetLayoutBindings descriptor_bindings
+    {
+        {INDIRECT_COMMAND_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {CULL_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+    };
+
+    auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
+
+    auto pipeline_layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts{ descriptor_set_layout }, // set 0
+        vsg::PushConstantRanges{}); // no push constants
+
+    // the pipeline itself, and its binder:
+    auto pipeline = vsg::ComputePipeline::create(pipeline_layout, compute_shader);
+    auto bind_pipeline = vsg::BindComputePipeline::create(pipeline);
+
+    // the draw list is the output of the GPU culler and the input to the renderer;
+    // each entry is a uvec2 referencing one visible glyph.
+    auto draw_list_size = MAX_GLYPH_LIST_SIZE * 2 * sizeof(std::uint32_t);
+
+    // GPU-only SSBO that will hold the final draw list.
+    auto draw_list_buffer_info = vsg::BufferInfo::create(
+        vsg::createBufferAndMemory(
+            context->device(),
+            draw_list_size,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT), // visible to GPU only!
+        0,
+        draw_list_size);
+
+    draw_list_descriptor = vsg::DescriptorBuffer::create(
+        vsg::BufferInfoList{ draw_list_buffer_info },
+        DRAW_LIST_BUFFER_BINDING,
+        0,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // bind all our descriptors to the pipeline.
+    auto bind_descriptors = vsg::BindDescriptorSet::create(
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipeline_layout,
+        vsg::DescriptorSet::create(
+            descriptor_set_layout,
+            vsg::Descriptors{
+                indirect_command->descriptor, cull_list->descriptor, draw_list_descriptor }));
+
+    // stick it all under the compute graph. The glyph buffer streams
+    // here too, even though only the render stage reads it, and so does
+    // the shared material table (a no-op if another system already
+    // installed it).
+    auto cg = context->getComputeCommandGraph();
+
+    context->materials->install(cg);
+
+    cg->addChild(indirect_command);
+    cg->addChild(cull_list);
+    cg->addChild(glyphs);
+    cg->addChild(bind_pipeline);
+    cg->addChild(bind_descriptors);
+    cg->addChild(cull_dispatch = vsg::Dispatch::create(0, 1, 1)); // will be updated later
+}
+
+void
+LabelSystem2Node::buildRenderStage(VSGContext& context)
+{
+    auto shader_set = context->getOrCreateShaderSet("rocky.label.indirect",
+        [&]() { return createRenderingShaderSet(context); });
+    if (!shader_set)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Label shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        return;
+    }
+
+    vsg::VertexInputState::Bindings vertex_bindings
+    {
+        VkVertexInputBindingDescription{0, sizeof(vsg::vec3), VK_VERTEX_INPUT_RATE_VERTEX}  // "in_vertex"
+    };
+
+    vsg::VertexInputState::Attributes vertex_attributes
+    {
+        VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0}  // "in_vertex"
+    };
+
+    // Define the draw pipeline template.
+    vsg::DescriptorSetLayoutBindings descriptor_bindings
+    {
+        {CULL_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {GLYPH_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {ATLAS_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},
+        {MaterialTable::BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr}
+    };
+
+    // PC's hold the projection and modelview matrices from VSG.
+    vsg::PushConstantRanges push_constant_ranges
+    {
+        {VK_SHADER_STAGE_VERTEX_BIT, 0, 128}
+    };
+
+    // Assemble all the pipeline states:
+    auto ia_state = vsg::InputAssemblyState::create();
+    ia_state->topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    auto rasterization_state = vsg::RasterizationState::create();
+    rasterization_state->cullMode = VK_CULL_MODE_NONE;
+
+    // match the classic label pipeline: text draws over everything.
+    auto depth_stencil_state = vsg::DepthStencilState::create();
+    depth_stencil_state->depthTestEnable = VK_FALSE;
+    depth_stencil_state->depthWriteEnable = VK_FALSE;
+
+    VkPipelineColorBlendAttachmentState blend;
+    blend.blendEnable = true;
+    blend.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blend.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blend.colorBlendOp = VK_BLEND_OP_ADD;
+    blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blend.alphaBlendOp = VK_BLEND_OP_ADD;
+    blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    auto color_blend_state = vsg::ColorBlendState::create();
+    color_blend_state->attachments = vsg::ColorBlendState::ColorBlendAttachments{ blend };
+
+    vsg::GraphicsPipelineStates pipeline_states
+    {
+        vsg::VertexInputState::create(vertex_bindings, vertex_attributes),
+        ia_state,
+        rasterization_state,
+        vsg::MultisampleState::create(),
+        color_blend_state,
+        depth_stencil_state
+    };
+
+    // our layout:
+    auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
+
+    // VSG's view-dependent stuff:
+    auto view_dependent_binding = vsg::ViewDependentStateBinding::create(VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX);
+    auto view_dependent_descriptor_set_layout = view_dependent_binding->createDescriptorSetLayout();
+
+    auto pipeline_layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts {
+            descriptor_set_layout, // set 0
+            view_dependent_descriptor_set_layout,    // set 1 (vsg_viewport, vsg_lights, etc)
+        },
+        push_constant_ranges);
+
+    auto pipeline = vsg::GraphicsPipeline::create(pipeline_layout, shader_set->getShaderStages(), pipeline_states);
+    auto bind_pipeline = vsg::BindGraphicsPipeline::create(pipeline);
+
+    // set up sampler for the font's texture atlas (same as the classic system).
+    auto sampler = vsg::Sampler::create();
+    sampler->magFilter = VK_FILTER_LINEAR;
+    sampler->minFilter = VK_FILTER_LINEAR;
+    sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->borderColor = VK_BORDER_COLOR_INT_TRANSPARENT_BLACK;
+    sampler->anisotropyEnable = VK_FALSE; // don't need it since we're "billboarding"
+    sampler->maxLod = 12.0; // generate mipmaps up to level 12
+
+    if (context->sharedObjects)
+        context->sharedObjects->share(sampler);
+
+    // the one and only glyph atlas, from the default font:
+    auto atlas_descriptor = vsg::DescriptorImage::create(
+        sampler,
+        context->defaultFont->atlas,
+        ATLAS_BINDING, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+    auto bind_descriptor_sets = vsg::BindDescriptorSet::create(
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipeline_layout,
+        DESCRIPTOR_SET_INDEX,
+        vsg::DescriptorSet::create(
+            descriptor_set_layout,
+            vsg::Descriptors{
+                cull_list->descriptor, draw_list_descriptor, glyphs->descriptor, atlas_descriptor,
+                context->materials->buffer->descriptor }));
+
+    auto bind_view_dependent_descriptor_sets = view_dependent_binding->createStateCommand(pipeline_layout);
+
+    // Add our binders to the scene graph.
+    this->addChild(bind_pipeline);
+    this->addChild(bind_descriptor_sets);
+    this->addChild(bind_view_dependent_descriptor_sets);
+
+    // the actual rendering command, finally.
+    auto draw = vsg::DrawIndexedIndirect::create();
+    draw->bufferInfo = indirect_command->ssbo;
+    draw->drawCount = 1;
+    draw->stride = 0;
+
+    // one quad per glyph instance (with dummy vertex positions; shader
+    // generates them).
+    auto geometry = vsg::Geometry::create();
+    geometry->assignIndices(vsg::ushortArray::create({ 0, 1, 2, 2, 3, 0 }));
+    geometry->assignArrays(vsg::DataList{ vsg::vec3Array::create(4) });
+    geometry->commands.emplace_back(draw);
+
+    this->addChild(geometry);
+}
+
+void
+LabelSystem2Node::packGlyphs(entt::registry& registry, VSGContext& context)
+{
+    auto font = context->defaultFont;
+    if (!font || !font->glyphMetrics)
+        return;
+
+    auto& metrics = *font->glyphMetrics;
+
+    auto* out = glyphs->data<LabelGlyphGPU>();
+    std::uint32_t next = 0u;
+
+    _ranges.clear();
+
+    registry.view<Label>().each([&](auto entity, Label& label)
+        {
+            GlyphRange range;
+            range.first = next;
+            range.revision = label.revision;
+
+            // lay the glyphs out along the baseline, in em units:
+            vsg::vec2 pen{ 0.0f, 0.0f };
+            vsg::vec2 lo{ 0.0f, 0.0f }, hi{ 0.0f, 0.0f };
+
+            for (unsigned char c : label.text)
+            {
+                if (c == '\n')
+                {
+                    pen.x = 0.0f;
+                    pen.y -= 1.0f;
+                    continue;
+                }
+
+                auto glyph_index = font->glyphIndexForCharcode(c);
+                if (glyph_index == 0 || glyph_index >= metrics.size())
+                {
+                    pen.x += 0.5f; // missing glyph; advance anyway
+                    continue;
+                }
+
+                auto& gm = metrics[glyph_index];
+
+                if (gm.width > 0.0f && gm.height > 0.0f && next < MAX_GLYPH_LIST_SIZE)
+                {
+                    auto& quad = out[next++];
+                    quad.rect = vsg::vec4(
+                        pen.x + gm.horiBearingX,
+                        pen.y + gm.horiBearingY - gm.height,
+                        gm.width,
+                        gm.height);
+                    quad.uvrect = gm.uvrect;
+
+                    lo.x = std::min(lo.x, quad.rect.x), lo.y = std::min(lo.y, quad.rect.y);
+                    hi.x = std::max(hi.x, quad.rect.x + quad.rect.z), hi.y = std::max(hi.y, quad.rect.y + quad.rect.w);
+                }
+
+                pen.x += gm.horiAdvance;
+            }
+
+            range.count = next - range.first;
+
+            // alignment: shift the laid-out extents relative to the anchor
+            // (mirrors vsg::StandardLayout's alignment modes)
+            vsg::vec2 shift{ 0.0f, 0.0f };
+
+            if (label.style.horizontalAlignment == vsg::StandardLayout::CENTER_ALIGNMENT)
+                shift.x = -(lo.x + hi.x) * 0.5f;
+            else if (label.style.horizontalAlignment == vsg::StandardLayout::RIGHT_ALIGNMENT)
+                shift.x = -hi.x;
+
+            if (label.style.verticalAlignment == vsg::StandardLayout::CENTER_ALIGNMENT)
+                shift.y = -(lo.y + hi.y) * 0.5f;
+            else if (label.style.verticalAlignment == vsg::StandardLayout::TOP_ALIGNMENT)
+                shift.y = -hi.y;
+            else if (label.style.verticalAlignment == vsg::StandardLayout::BOTTOM_ALIGNMENT)
+                shift.y = -lo.y;
+
+            if (shift.x != 0.0f || shift.y != 0.0f)
+            {
+                for (auto i = range.first; i < range.first + range.count; ++i)
+                {
+                    out[i].rect.x += shift.x;
+                    out[i].rect.y += shift.y;
+                }
+            }
+
+            _ranges[entity] = range;
+        });
+
+    _totalGlyphs = next;
+
+    if (_totalGlyphs > 0)
+    {
+        glyphs->dirty(0, _totalGlyphs * sizeof(LabelGlyphGPU));
+    }
+}
+
+void
+LabelSystem2Node::update(VSGContext& context)
+{
+    if (!status.ok())
+        return;
+
+    if (!context->renderingEnabled)
+        return;
+
+    // reset the indirect command buffer
+    auto& cmd = indirect_command->data<VkDrawIndexedIndirectCommand>()[0];
+    cmd = VkDrawIndexedIndirectCommand{ 6, 0, 0, 0, 0 };
+    indirect_command->dirty();
+
+    // update the cull list
+    auto* instances = cull_list->data<LabelInstanceGPU>();
+
+    int count = 0;
+
+    auto [lock, registry] = _registry.read();
+
+    // re-run layout if any label changed:
+    bool repack = false;
+    std::size_t labels = 0;
+    registry.view<Label>().each([&](auto entity, Label& label)
+        {
+            ++labels;
+            auto iter = _ranges.find(entity);
+            if (iter == _ranges.end() || iter->second.revision != label.revision)
+                repack = true;
+        });
+
+    if (repack || labels != _ranges.size())
+    {
+        packGlyphs(registry, context);
+    }
+
+    // This will build a draw list that applies to all active views.
+    auto view = registry.view<Label, ActiveState, Visibility, TransformData>();
+
+    view.each([&](auto entity, auto& label, auto& active, auto& visibility, auto& transformData)
+        {
+            auto iter = _ranges.find(entity);
+            if (iter == _ranges.end() || iter->second.count == 0)
+                return;
+
+            // resolve the style into a shared material, once per entity:
+            MaterialGPU material;
+            material.outline = label.style.outlineSize > 0.0f ?
+                vsg::vec4(0.0f, 0.0f, 0.0f, 0.5f * label.style.outlineSize) :
+                vsg::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+            auto material_index = context->materials->getOrAdd(material);
+
+            for (auto viewID : context->activeViewIDs)
+            {
+                if (ecs::visible(visibility, viewID) && count < MAX_CULL_LIST_SIZE)
+                {
+                    auto& view = transformData[viewID];
+
+                    auto& instance = instances[count++];
+                    instance.proj = view.proj;
+                    instance.modelview = view.modelview;
+                    instance.viewport = view.viewport;
+                    instance.material = material_index;
+                    instance.pixel_offset = { label.style.pixelOffset.x, label.style.pixelOffset.y };
+                    instance.scale = label.style.pointSize;
+                    instance.first_glyph = iter->second.first;
+                    instance.num_glyphs = iter->second.count;
+                }
+            }
+        });
+
+    // configure the culling shader for 'count' instances
+    unsigned workgroups = (count + (GPU_CULLING_LOCAL_WG_SIZE - 1)) / GPU_CULLING_LOCAL_WG_SIZE;
+    cull_dispatch->groupCountX = workgroups;
+
+    // zero from the end of the cull list to the padding boundary;
+    // this sets the "num_glyphs" entries to zero, indicating a
+    // blank/padding entry
+    std::size_t padding_count = (workgroups * GPU_CULLING_LOCAL_WG_SIZE) - count;
+
+    if (padding_count > 0)
+    {
+        auto offset = count * sizeof(LabelInstanceGPU);
+        auto bytes = std::min(padding_count * sizeof(LabelInstanceGPU), MAX_CULL_LIST_SIZE * sizeof(LabelInstanceGPU) - offset);
+        std::memset(&instances[count], 0, bytes);
+    }
+
+    auto total_cull_list_bytes_to_dirty = (count + padding_count) * sizeof(LabelInstanceGPU);
+    cull_list->dirty(0, total_cull_list_bytes_to_dirty);
+}
@@ -0,0 +1,109 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Label.h>
+#include <rocky/vsg/ecs/ECSNode.h>
+#include <rocky/vsg/PipelineState.h>
+
+namespace ROCKY_NAMESPACE
+{
+    //! Per-label instance record as mirrored in the culling compute shader.
+    //! The fill and outline colors live in the shared MaterialTable; the
+    //! instance carries just an index into it.
+    struct LabelInstanceGPU
+    {
+        vsg::mat4 proj;
+        vsg::mat4 modelview;
+        vsg::vec4 viewport = { 0,0,0,0 };   // x,y = lower left, z,w = width, height
+        vsg::vec2 pixel_offset = { 0,0 };
+        float scale = 0.0f;                 // pixels per em (the style's pointSize)
+        std::uint32_t material = 0;         // index into the shared MaterialTable
+
+        std::uint32_t first_glyph = 0;      // offset into the glyph buffer
+        std::uint32_t num_glyphs = 0;       // 0 = blank/padding entry
+
+        float padding[2];
+        // keep me 16-byte aligned with padding please
+    };
+
+    //! One laid-out glyph quad in the shared glyph buffer, in em units
+    //! relative to the label's anchor. Layout runs once on the CPU when a
+    //! label's revision changes; rendering just scales and billboards.
+    struct LabelGlyphGPU
+    {
+        vsg::vec4 rect;     // x,y = lower-left corner, z,w = size (ems)
+        vsg::vec4 uvrect;   // atlas texture coords; x,y = min, z,w = max
+    };
+
+    /**
+     * Renders all Label entities with a single indirect draw from the
+     * shared glyph atlas - the same GPU-culled architecture as
+     * IconSystem2Node. The CPU lays each label's glyphs out once (on
+     * revision change) into a shared SSBO; per frame it streams one small
+     * instance record per label per view, the culling shader appends each
+     * visible label's glyphs to the draw list, and the vertex shader
+     * expands each surviving glyph into a screen-space quad. No per-label
+     * subgraphs, no vsg::Text layout in the frame loop, and no compile
+     * stalls when labels churn.
+     *
+     * Every label renders with the context's default font, since a single
+     * atlas is bound for the whole batch.
+     */
+    class ROCKY_EXPORT LabelSystem2Node : public vsg::Inherit<vsg::Group, LabelSystem2Node>,
+        public ecs::System
+    {
+    public:
+        //! Construct the label renderer
+        LabelSystem2Node(ecs::Registry& r);
+
+        //! Initialize the system (called once at startup)
+        void initialize(VSGContext&) override;
+
+        //! Update pass (called once per frame before recording starts)
+        void update(VSGContext&) override;
+
+    protected:
+        virtual ~LabelSystem2Node();
+
+    private:
+
+        // dispatch command for the GPU culler
+        vsg::ref_ptr<vsg::Dispatch> cull_dispatch;
+
+        // The VkDrawIndexedIndirect command, which the GPU culler will
+        // write to and the rendering will read from
+        vsg::ref_ptr<StreamingGPUBuffer> indirect_command;
+
+        // The list of LabelInstanceGPU records the GPU culler reads and
+        // the vertex shader indexes for style and matrices
+        vsg::ref_ptr<StreamingGPUBuffer> cull_list;
+
+        // Laid-out LabelGlyphGPU records for every label; re-streamed only
+        // when some label's revision changes
+        vsg::ref_ptr<StreamingGPUBuffer> glyphs;
+
+        // GPU-side draw list binding (uvec2 = instance index, glyph index)
+        vsg::ref_ptr<vsg::DescriptorBuffer> draw_list_descriptor;
+
+        // CPU-side glyph packing, per entity
+        struct GlyphRange
+        {
+            std::uint32_t first = 0;
+            std::uint32_t count = 0;
+            int revision = -1;
+        };
+        std::unordered_map<entt::entity, GlyphRange> _ranges;
+        std::uint32_t _totalGlyphs = 0u;
+
+        void buildCullStage(VSGContext& context);
+
+        void buildRenderStage(VSGContext& context);
+
+        //! Re-run glyph layout for every label into the shared buffer.
+        //! Called when an entity's revision changes.
+        void packGlyphs(entt::registry& registry, VSGContext& context);
+    };
+}
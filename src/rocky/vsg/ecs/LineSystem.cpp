@@ -24,6 +24,7 @@ using namespace ROCKY_NAMESPACE;
 
 #define LINE_BUFFER_SET 0 // must match layout(set=X) in the shader UBO
 #define LINE_BUFFER_BINDING 1 // must match the layout(binding=X) in the shader UBO (set=0)
+#define LINE_POINTS_BUFFER_BINDING 2 // must match the layout(binding=X) of the points SSBO (set=0)
 
 namespace
 {
@@ -53,16 +54,16 @@ namespace
 
         shaderSet = vsg::ShaderSet::create(shaderStages);
 
-        // "binding" (3rd param) must match "layout(location=X) in" in the vertex shader
-        shaderSet->addAttributeBinding("in_vertex", "", 0, VK_FORMAT_R32G32B32_SFLOAT, { });
-        shaderSet->addAttributeBinding("in_vertex_prev", "", 1, VK_FORMAT_R32G32B32_SFLOAT, {});
-        shaderSet->addAttributeBinding("in_vertex_next", "", 2, VK_FORMAT_R32G32B32_SFLOAT, {});
-        shaderSet->addAttributeBinding("in_color", "", 3, VK_FORMAT_R32G32B32A32_SFLOAT, {});
-
         // line data uniform buffer (width, stipple, etc.)
         shaderSet->addDescriptorBinding("line", "", LINE_BUFFER_SET, LINE_BUFFER_BINDING,
             VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
 
+        // point data storage buffer. The vertex shader pulls each point
+        // from here and expands the segment quads itself, so there are no
+        // vertex attribute arrays at all.
+        shaderSet->addDescriptorBinding("points", "", LINE_BUFFER_SET, LINE_POINTS_BUFFER_BINDING,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
+
         // We need VSG's view-dependent data:
         PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_VERTEX_BIT);
 
@@ -83,7 +84,8 @@ void
 LineSystemNode::initialize(VSGContext& runtime)
 {
     // Now create the pipeline and stategroup to bind it
-    auto shaderSet = createLineShaderSet(runtime);
+    auto shaderSet = runtime->getOrCreateShaderSet("rocky.line",
+        [&]() { return createLineShaderSet(runtime); });
 
     if (!shaderSet)
     {
@@ -106,15 +108,12 @@ LineSystemNode::initialize(VSGContext& runtime)
         // Apply any custom compile settings / defines:
         c.config->shaderHints = runtime->shaderCompileSettings;
 
-        // activate the arrays we intend to use
-        c.config->enableArray("in_vertex", VK_VERTEX_INPUT_RATE_VERTEX, 12);
-        c.config->enableArray("in_vertex_prev", VK_VERTEX_INPUT_RATE_VERTEX, 12);
-        c.config->enableArray("in_vertex_next", VK_VERTEX_INPUT_RATE_VERTEX, 12);
-        c.config->enableArray("in_color", VK_VERTEX_INPUT_RATE_VERTEX, 16);
-
         // Uniforms we will need:
         c.config->enableDescriptor("line");
 
+        // per-geometry point buffer (pull-model vertex expansion):
+        c.config->enableDescriptor("points");
+
         // always both
         PipelineUtils::enableViewDependentData(c.config);
 
@@ -156,17 +155,71 @@ LineSystemNode::initialize(VSGContext& runtime)
 }
 
 void
-LineSystemNode::createOrUpdateNode(Line& line, ecs::BuildInfo& data, VSGContext& runtime) const
+LineSystemNode::update(VSGContext& context)
 {
-    if (!data.existing_node)
+    // Fast path for style-only changes: rewrite the line's dynamic style
+    // buffer right here and drop the entity from the rebuild queue.
+    // Restyling many lines per frame (e.g., flashing highlights) then
+    // costs one small buffer transfer apiece, with zero geometry or
+    // descriptor churn and no component copies through the node factory.
+    if (!entities_to_update.empty())
     {
-        auto bindCommand = BindLineDescriptors::create();
-        bindCommand->updateStyle(line.style);
-        bindCommand->init(getPipelineLayout(line));
+        auto [lock, registry] = _registry.read();
 
-        auto stategroup = vsg::StateGroup::create();
-        stategroup->stateCommands.push_back(bindCommand);
+        std::vector<entt::entity> needs_rebuild;
+        needs_rebuild.reserve(entities_to_update.size());
+
+        for (auto& entity : entities_to_update)
+        {
+            if (!registry.valid(entity))
+                continue;
+
+            auto& line = registry.get<Line>(entity);
+            auto& renderable = registry.get<ecs::Renderable>(line.attach_point);
+
+            if (renderable.node && line.styleDirty && !line.pointsDirty)
+            {
+                if (auto* bind = util::find<BindLineDescriptors>(renderable.node))
+                {
+                    bind->updateStyle(line.style);
+                    line.styleDirty = false;
+                    continue;
+                }
+            }
+
+            needs_rebuild.emplace_back(entity);
+        }
+
+        entities_to_update.swap(needs_rebuild);
+    }
+
+    // everything left takes the normal build path. That path works on a
+    // copy of the component, so clear the live flags afterwards; the
+    // copy carries them into createOrUpdateNode.
+    auto rebuilt = entities_to_update;
 
+    Inherit::update(context);
+
+    if (!rebuilt.empty())
+    {
+        auto [lock, registry] = _registry.read();
+        for (auto& entity : rebuilt)
+        {
+            if (registry.valid(entity))
+            {
+                auto& line = registry.get<Line>(entity);
+                line.styleDirty = false;
+                line.pointsDirty = false;
+            }
+        }
+    }
+}
+
+void
+LineSystemNode::createOrUpdateNode(Line& line, ecs::BuildInfo& data, VSGContext& runtime) const
+{
+    if (!data.existing_node)
+    {
         vsg::ref_ptr<LineGeometry> geometry;
         vsg::ref_ptr<vsg::Node> geom_root;
         vsg::dmat4 localizer_matrix;
@@ -202,6 +255,15 @@ LineSystemNode::createOrUpdateNode(Line& line, ecs::BuildInfo& data, VSGContext&
             geom_root = geometry;
         }
 
+        // bind the style and the geometry's point buffer; the descriptor
+        // set is per-line since each geometry has its own point buffer.
+        auto bindCommand = BindLineDescriptors::create();
+        bindCommand->updateStyle(line.style);
+        bindCommand->init(getPipelineLayout(line), geometry->_points);
+
+        auto stategroup = vsg::StateGroup::create();
+        stategroup->stateCommands.push_back(bindCommand);
+
         auto cull = vsg::CullNode::create();
         if (stategroup)
         {
@@ -318,7 +380,7 @@ BindLineDescriptors::updateStyle(const LineStyle& value)
 }
 
 void
-BindLineDescriptors::init(vsg::ref_ptr<vsg::PipelineLayout> layout)
+BindLineDescriptors::init(vsg::ref_ptr<vsg::PipelineLayout> layout, vsg::ref_ptr<vsg::Data> points)
 {
     vsg::Descriptors descriptors;
 
@@ -326,6 +388,13 @@ BindLineDescriptors::init(vsg::ref_ptr<vsg::PipelineLayout> layout)
     auto ubo = vsg::DescriptorBuffer::create(_styleData, LINE_BUFFER_BINDING, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
     descriptors.push_back(ubo);
 
+    // the geometry's point buffer:
+    if (points)
+    {
+        auto ssbo = vsg::DescriptorBuffer::create(points, LINE_POINTS_BUFFER_BINDING, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        descriptors.push_back(ssbo);
+    }
+
     if (!descriptors.empty())
     {
         this->pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
@@ -370,7 +439,8 @@ LineGeometry::calcBound(vsg::dsphere& output, const vsg::dmat4& matrix) const
     output.reset();
     for(int i = first; i < count; ++i)
     {
-        expandBy(output, matrix * vsg::dvec3(_current->at(i * 4)));
+        auto& p = _points->at(i * 2);
+        expandBy(output, matrix * vsg::dvec3(p.x, p.y, p.z));
     }
 }
 
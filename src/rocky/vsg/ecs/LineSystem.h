@@ -32,9 +32,14 @@ namespace ROCKY_NAMESPACE
         //! Returns a mask of supported features for the given mesh
         int featureMask(const Line&) const override;
 
-        //! One-time initialization of the system    
+        //! One-time initialization of the system
         void initialize(VSGContext&) override;
 
+        //! Per-frame update. Style-only changes take a fast path that
+        //! rewrites the line's dynamic style buffer in place, skipping
+        //! the rebuild round trip through the node factory.
+        void update(VSGContext&) override;
+
         void createOrUpdateNode(Line&, ecs::BuildInfo&, VSGContext&) const override;
     };
 
@@ -61,10 +66,11 @@ namespace ROCKY_NAMESPACE
 
         //protected:
         vsg::ref_ptr<vsg::DrawIndexed> _drawCommand;
-        vsg::ref_ptr<vsg::vec3Array> _current;
-        vsg::ref_ptr<vsg::vec3Array> _previous;
-        vsg::ref_ptr<vsg::vec3Array> _next;
-        vsg::ref_ptr<vsg::vec4Array> _colors;
+
+        // two vec4s per point: [position.xyz, flags] and [color]. Bound as
+        // a storage buffer; the vertex shader expands the segment quads
+        // from gl_VertexIndex so no per-corner vertex arrays exist.
+        vsg::ref_ptr<vsg::vec4Array> _points;
         vsg::ref_ptr<vsg::uintArray> _indices;
 
         void calcBound(vsg::dsphere& out, const vsg::dmat4& matrix) const;
@@ -79,8 +85,9 @@ namespace ROCKY_NAMESPACE
         //! Construct a line style node
         BindLineDescriptors();
 
-        //! Initialize this command with the associated layout
-        void init(vsg::ref_ptr<vsg::PipelineLayout> layout);
+        //! Initialize this command with the associated layout and the
+        //! point buffer of the geometry it will render
+        void init(vsg::ref_ptr<vsg::PipelineLayout> layout, vsg::ref_ptr<vsg::Data> points);
 
         //! Refresh the data buffer contents on the GPU
         void updateStyle(const LineStyle&);
@@ -96,36 +103,26 @@ namespace ROCKY_NAMESPACE
     {
         const vsg::vec4 defaultColor = { 1.0f, 1.0f, 1.0f, 1.0f };
 
-        if (!_current)
+        // flags live in the w component of each point's position;
+        // must match the constants in rocky.line.vert.
+        const float FLAG_FIRST = 1.0f;
+        const float FLAG_LAST = 2.0f;
+
+        if (!_points)
         {
             std::size_t verts_to_allocate = (staticStorage > 0 ? staticStorage : verts.size());
-            std::size_t indices_to_allocate =
-                topology == Line::Topology::Strip ? (verts_to_allocate - 1) * 6 :
-                (verts_to_allocate / 2) * 6; // Segments
-
-            _current = vsg::vec3Array::create(verts_to_allocate * 4);
-            _current->properties.dataVariance = vsg::DYNAMIC_DATA;
 
-            _previous = vsg::vec3Array::create(verts_to_allocate * 4);
-            _previous->properties.dataVariance = vsg::DYNAMIC_DATA;
-            
-            _next = vsg::vec3Array::create(verts_to_allocate * 4);
-            _next->properties.dataVariance = vsg::DYNAMIC_DATA;
-
-            _colors = vsg::vec4Array::create(verts_to_allocate * 4);
-            _colors->properties.dataVariance = vsg::DYNAMIC_DATA;
-
-            assignArrays({ _current, _previous, _next, _colors });
+            // each point is stored once; the index buffer addresses four
+            // virtual corners per point that the vertex shader expands.
+            _points = vsg::vec4Array::create(verts_to_allocate * 2);
+            _points->properties.dataVariance = vsg::DYNAMIC_DATA;
 
             _indices = vsg::uintArray::create((verts_to_allocate - 1) * 6);
             _indices->properties.dataVariance = vsg::DYNAMIC_DATA;
             assignIndices(_indices);
         }
 
-        auto* current = (_current->data());
-        auto* prev = (_previous->data());
-        auto* next = (_next->data());
-        auto* color = (_colors->data());
+        auto* points = (_points->data());
         auto* indicies = (_indices->data());
         int i_ptr = 0;
 
@@ -136,23 +133,20 @@ namespace ROCKY_NAMESPACE
                 bool first = i == 0;
                 bool last = (i == verts.size() - 1);
 
-                for (int n = 0; n < 4; ++n)
-                {
-                    (_previous->data())[i * 4 + n] = first ? verts[i] : verts[i - 1];
-                    (_next->data())[i * 4 + n] = last ? verts[i] : verts[i + 1];
-                    (_current->data())[i * 4 + n] = verts[i];
-                    (_colors->data())[i * 4 + n] = defaultColor;
-                }
+                vsg::vec3 v = verts[i];
+                float flags = (first ? FLAG_FIRST : 0.0f) + (last ? FLAG_LAST : 0.0f);
+                points[i * 2] = vsg::vec4(v.x, v.y, v.z, flags);
+                points[i * 2 + 1] = defaultColor;
 
                 if (!first)
                 {
                     auto e = (i - 1) * 4 + 2;
-                    (_indices->data())[i_ptr++] = e + 3;
-                    (_indices->data())[i_ptr++] = e + 1;
-                    (_indices->data())[i_ptr++] = e + 0; // provoking vertex
-                    (_indices->data())[i_ptr++] = e + 2;
-                    (_indices->data())[i_ptr++] = e + 3;
-                    (_indices->data())[i_ptr++] = e + 0; // provoking vertex
+                    indicies[i_ptr++] = e + 3;
+                    indicies[i_ptr++] = e + 1;
+                    indicies[i_ptr++] = e + 0; // provoking vertex
+                    indicies[i_ptr++] = e + 2;
+                    indicies[i_ptr++] = e + 3;
+                    indicies[i_ptr++] = e + 0; // provoking vertex
                 }
             }
         }
@@ -164,22 +158,9 @@ namespace ROCKY_NAMESPACE
             {
                 bool even = (i & 0x1) == 0;
 
-                for (int n = 0; n < 4; ++n)
-                {
-                    if (even) // beginning of segment
-                    {
-                        prev[i * 4 + n] = verts[i];
-                        next[i * 4 + n] = verts[i + 1];
-                    }
-                    else // end of segment
-                    {
-                        prev[i * 4 + n] = verts[i - 1];
-                        next[i * 4 + n] = verts[i];
-                    }
-
-                    current[i * 4 + n] = verts[i];
-                    color[i * 4 + n] = defaultColor;
-                }
+                vsg::vec3 v = verts[i];
+                points[i * 2] = vsg::vec4(v.x, v.y, v.z, even ? FLAG_FIRST : FLAG_LAST);
+                points[i * 2 + 1] = defaultColor;
 
                 if (even)
                 {
@@ -197,10 +178,7 @@ namespace ROCKY_NAMESPACE
         _drawCommand->firstIndex = 0;
         _drawCommand->indexCount = i_ptr;
 
-        _current->dirty();
-        _previous->dirty();
-        _next->dirty();
-        _colors->dirty();
+        _points->dirty();
         _indices->dirty();
     }
 }
@@ -0,0 +1,555 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "LineSystem2.h"
+#include "../VSGContext.h"
+#include "../MaterialTable.h"
+#include "../PipelineState.h"
+#include "../Utils.h"
+
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ViewDependentState.h>
+#include <vsg/commands/DrawIndexed.h>
+
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+#define VERT_SHADER "shaders/rocky.line.indirect.vert"
+#define FRAG_SHADER "shaders/rocky.line.frag" // same fragment interface as the classic pipeline
+#define CULL_SHADER "shaders/rocky.line.indirect.cull.comp"
+
+// these must match the layout() defs in the shaders.
+#define DESCRIPTOR_SET_INDEX 0  // must match layout(set=X) in the shaders
+
+#define INDIRECT_COMMAND_BUFFER_BINDING 0  // indirect command buffer
+#define CULL_LIST_BUFFER_BINDING 1  // input instance buffer
+#define DRAW_LIST_BUFFER_BINDING 2  // output draw_list buffer
+#define SEGMENT_BUFFER_BINDING 3  // shared segment geometry buffer
+
+#define MAX_CULL_LIST_SIZE 16384
+#define MAX_SEGMENT_LIST_SIZE 262144
+#define GPU_CULLING_LOCAL_WG_SIZE 32
+
+namespace
+{
+    //! Create a shader set for the culling compute shader.
+    vsg::ref_ptr<vsg::ShaderStage> createCullingShader(VSGContext& context)
+    {
+        auto computeShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            "main",
+            vsg::findFile(CULL_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (computeShader)
+        {
+            // Specializations to pass to the shader
+            computeShader->specializationConstants = vsg::ShaderStage::SpecializationConstants{
+                {0, vsg::intValue::create(GPU_CULLING_LOCAL_WG_SIZE)} }; // layout(load_size_x_id, 0) in
+        }
+
+        return computeShader;
+    }
+
+    //! Load and configure the shader stages for rendering.
+    vsg::ref_ptr<vsg::ShaderSet> createRenderingShaderSet(VSGContext& context)
+    {
+        auto vertexShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_VERTEX_BIT,
+            "main",
+            vsg::findFile(VERT_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        auto fragmentShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+            "main",
+            vsg::findFile(FRAG_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (!vertexShader || !fragmentShader)
+        {
+            return { };
+        }
+
+        auto shaderSet = vsg::ShaderSet::create(vsg::ShaderStages{ vertexShader, fragmentShader });
+
+        // We need VSG's view-dependent data:
+        PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_VERTEX_BIT);
+
+        // Note: 128 is the maximum size required by the Vulkan spec so don't increase it
+        shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+        return shaderSet;
+    }
+
+    //! Same localization the classic LineSystem performs in
+    //! createOrUpdateNode: an SRS op into the world SRS plus an offset
+    //! for floating-point precision.
+    bool parseReferencePoint(const GeoPoint& point, SRSOperation& out_xform, vsg::dvec3& out_offset)
+    {
+        if (point.srs.valid())
+        {
+            SRS worldSRS = point.srs;
+
+            if (point.srs.isGeodetic())
+            {
+                worldSRS = point.srs.geocentricSRS();
+                GeoPoint world = point.transform(worldSRS);
+                if (world.valid())
+                {
+                    out_offset = vsg::dvec3{ world.x, world.y, world.z };
+                }
+            }
+            else
+            {
+                out_offset = vsg::dvec3{ point.x, point.y, point.z };
+            }
+
+            out_xform = SRSOperation(point.srs, worldSRS);
+            return true;
+        }
+        return false;
+    }
+}
+
+LineSystem2Node::LineSystem2Node(ecs::Registry& registry) :
+    ecs::System(registry)
+{
+    auto [lock, r] = registry.write();
+
+    r.on_construct<Line>().template connect<&ecs::detail::SystemNode_on_construct<Line>>();
+    r.on_update<Line>().template connect<&ecs::detail::SystemNode_on_update<Line>>();
+    r.on_destroy<Line>().template connect<&ecs::detail::SystemNode_on_destroy<Line>>();
+}
+
+LineSystem2Node::~LineSystem2Node()
+{
+    auto [lock, registry] = _registry.write();
+
+    registry.on_construct<Line>().template disconnect<&ecs::detail::SystemNode_on_construct<Line>>();
+    registry.on_update<Line>().template disconnect<&ecs::detail::SystemNode_on_update<Line>>();
+    registry.on_destroy<Line>().template disconnect<&ecs::detail::SystemNode_on_destroy<Line>>();
+}
+
+void
+LineSystem2Node::initialize(VSGContext& context)
+{
+    // a dynamic SSBO that holds the draw-indirect command. The compute shader will write to this
+    // and the rendering shader will read from it.
+    indirect_command = StreamingGPUBuffer::create(
+        INDIRECT_COMMAND_BUFFER_BINDING,
+        sizeof(VkDrawIndexedIndirectCommand),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+    // a dynamic SSBO holding one instance record per line entity per view.
+    // The CPU populates it each frame; the compute shader culls from it and
+    // the vertex shader reads style and matrices from it.
+    cull_list = StreamingGPUBuffer::create(
+        CULL_LIST_BUFFER_BINDING,
+        sizeof(LineInstanceGPU) * MAX_CULL_LIST_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    // a dynamic SSBO with the packed segment geometry for every line.
+    // Only re-streamed when some line's geometry actually changes.
+    segments = StreamingGPUBuffer::create(
+        SEGMENT_BUFFER_BINDING,
+        sizeof(LineSegmentGPU) * MAX_SEGMENT_LIST_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    buildCullStage(context);
+
+    buildRenderStage(context);
+}
+
+void
+LineSystem2Node::buildCullStage(VSGContext& context)
+{
+    // Configure the compute pipeline for culling:
+    auto compute_shader = createCullingShader(context);
+    if (!compute_shader)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Line compute shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+
+        return;
+    }
+
+    vsg::DescriptorSetLayoutBindings descriptor_bindings
+    {
+        {INDIRECT_COMMAND_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {CULL_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+    };
+
+    auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
+
+    auto pipeline_layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts{ descriptor_set_layout }, // set 0
+        vsg::PushConstantRanges{}); // no push constants
+
+    // the pipeline itself, and its binder:
+    auto pipeline = vsg::ComputePipeline::create(pipeline_layout, compute_shader);
+    auto bind_pipeline = vsg::BindComputePipeline::create(pipeline);
+
+    // the draw list is the output of the GPU culler and the input to the renderer;
+    // each entry is a uvec2 referencing one visible segment.
+    auto draw_list_size = MAX_SEGMENT_LIST_SIZE * 2 * sizeof(std::uint32_t);
+
+    // GPU-only SSBO that will hold the final draw list.
+    auto draw_list_buffer_info = vsg::BufferInfo::create(
+        vsg::createBufferAndMemory(
+            context->device(),
+            draw_list_size,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT), // visible to GPU only!
+        0,
+        draw_list_size);
+
+    draw_list_descriptor = vsg::DescriptorBuffer::create(
+        vsg::BufferInfoList{ draw_list_buffer_info },
+        DRAW_LIST_BUFFER_BINDING,
+        0,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // bind all our descriptors to the pipeline.
+    auto bind_descriptors = vsg::BindDescriptorSet::create(
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipeline_layout,
+        vsg::DescriptorSet::create(
+            descriptor_set_layout,
+            vsg::Descriptors{
+                indirect_command->descriptor, cull_list->descriptor, draw_list_descriptor }));
+
+    // stick it all under the compute graph. The segment buffer streams
+    // here too, even though only the render stage reads it, and so does
+    // the shared material table (a no-op if another system already
+    // installed it).
+    auto cg = context->getComputeCommandGraph();
+
+    context->materials->install(cg);
+
+    cg->addChild(indirect_command);
+    cg->addChild(cull_list);
+    cg->addChild(segments);
+    cg->addChild(bind_pipeline);
+    cg->addChild(bind_descriptors);
+    cg->addChild(cull_dispatch = vsg::Dispatch::create(0, 1, 1)); // will be updated later
+}
+
+void
+LineSystem2Node::buildRenderStage(VSGContext& context)
+{
+    auto shader_set = context->getOrCreateShaderSet("rocky.line.indirect",
+        [&]() { return createRenderingShaderSet(context); });
+    if (!shader_set)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Line shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        return;
+    }
+
+    vsg::VertexInputState::Bindings vertex_bindings
+    {
+        VkVertexInputBindingDescription{0, sizeof(vsg::vec3), VK_VERTEX_INPUT_RATE_VERTEX}  // "in_vertex"
+    };
+
+    vsg::VertexInputState::Attributes vertex_attributes
+    {
+        VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0}  // "in_vertex"
+    };
+
+    // Define the draw pipeline template.
+    vsg::DescriptorSetLayoutBindings descriptor_bindings
+    {
+        {CULL_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {SEGMENT_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {MaterialTable::BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr}
+    };
+
+    // PC's hold the projection and modelview matrices from VSG.
+    vsg::PushConstantRanges push_constant_ranges
+    {
+        {VK_SHADER_STAGE_VERTEX_BIT, 0, 128}
+    };
+
+    // Assemble all the pipeline states:
+    auto ia_state = vsg::InputAssemblyState::create();
+    ia_state->topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    auto rasterization_state = vsg::RasterizationState::create();
+    rasterization_state->cullMode = VK_CULL_MODE_NONE;
+
+    auto depth_stencil_state = vsg::DepthStencilState::create();
+    depth_stencil_state->depthWriteEnable = VK_FALSE; // match the classic line pipeline default
+
+    VkPipelineColorBlendAttachmentState blend;
+    blend.blendEnable = true;
+    blend.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blend.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blend.colorBlendOp = VK_BLEND_OP_ADD;
+    blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blend.alphaBlendOp = VK_BLEND_OP_ADD;
+    blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    auto color_blend_state = vsg::ColorBlendState::create();
+    color_blend_state->attachments = vsg::ColorBlendState::ColorBlendAttachments{ blend };
+
+    vsg::GraphicsPipelineStates pipeline_states
+    {
+        vsg::VertexInputState::create(vertex_bindings, vertex_attributes),
+        ia_state,
+        rasterization_state,
+        vsg::MultisampleState::create(),
+        color_blend_state,
+        depth_stencil_state
+    };
+
+    // our layout:
+    auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
+
+    // VSG's view-dependent stuff:
+    auto view_dependent_binding = vsg::ViewDependentStateBinding::create(VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX);
+    auto view_dependent_descriptor_set_layout = view_dependent_binding->createDescriptorSetLayout();
+
+    auto pipeline_layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts {
+            descriptor_set_layout, // set 0
+            view_dependent_descriptor_set_layout,    // set 1 (vsg_viewport, vsg_lights, etc)
+        },
+        push_constant_ranges);
+
+    auto pipeline = vsg::GraphicsPipeline::create(pipeline_layout, shader_set->getShaderStages(), pipeline_states);
+    auto bind_pipeline = vsg::BindGraphicsPipeline::create(pipeline);
+
+    auto bind_descriptor_sets = vsg::BindDescriptorSet::create(
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipeline_layout,
+        DESCRIPTOR_SET_INDEX,
+        vsg::DescriptorSet::create(
+            descriptor_set_layout,
+            vsg::Descriptors{
+                cull_list->descriptor, draw_list_descriptor, segments->descriptor,
+                context->materials->buffer->descriptor }));
+
+    auto bind_view_dependent_descriptor_sets = view_dependent_binding->createStateCommand(pipeline_layout);
+
+    // Add our binders to the scene graph.
+    this->addChild(bind_pipeline);
+    this->addChild(bind_descriptor_sets);
+    this->addChild(bind_view_dependent_descriptor_sets);
+
+    // the actual rendering command, finally.
+    auto draw = vsg::DrawIndexedIndirect::create();
+    draw->bufferInfo = indirect_command->ssbo;
+    draw->drawCount = 1;
+    draw->stride = 0;
+
+    // one quad per segment instance (with dummy vertex positions; shader
+    // generates them). Both triangles lead with a segment-start vertex so
+    // the flat varyings take the provoking vertex the stippling expects.
+    auto geometry = vsg::Geometry::create();
+    geometry->assignIndices(vsg::ushortArray::create({ 0, 1, 2, 0, 2, 3 }));
+    geometry->assignArrays(vsg::DataList{ vsg::vec3Array::create(4) });
+    geometry->commands.emplace_back(draw);
+
+    this->addChild(geometry);
+}
+
+void
+LineSystem2Node::packSegments(entt::registry& registry)
+{
+    auto* segs = segments->data<LineSegmentGPU>();
+    std::uint32_t next = 0u;
+
+    _ranges.clear();
+
+    registry.view<Line>().each([&](auto entity, Line& line)
+        {
+            SegmentRange range;
+            range.first = next;
+            range.revision = line.revision;
+
+            if (line.points.size() >= 2)
+            {
+                // localize the points the same way the classic system does:
+                std::vector<vsg::dvec3> verts;
+                verts.reserve(line.points.size());
+
+                if (line.referencePoint.valid())
+                {
+                    SRSOperation xform;
+                    vsg::dvec3 offset, temp;
+                    parseReferencePoint(line.referencePoint, xform, offset);
+
+                    for (auto& point : line.points)
+                    {
+                        xform(point, temp);
+                        temp -= offset;
+                        verts.emplace_back(temp);
+                    }
+
+                    range.offset = offset;
+                }
+                else
+                {
+                    verts.assign(line.points.begin(), line.points.end());
+                }
+
+                auto emit = [&](const vsg::dvec3& prev, const vsg::dvec3& c0, const vsg::dvec3& c1, const vsg::dvec3& nxt)
+                    {
+                        if (next >= MAX_SEGMENT_LIST_SIZE)
+                            return;
+                        auto& seg = segs[next++];
+                        seg.prev = vsg::vec4(vsg::vec3(prev), 0.0f);
+                        seg.curr0 = vsg::vec4(vsg::vec3(c0), 0.0f);
+                        seg.curr1 = vsg::vec4(vsg::vec3(c1), 0.0f);
+                        seg.next = vsg::vec4(vsg::vec3(nxt), 0.0f);
+                    };
+
+                if (line.topology == Line::Topology::Strip)
+                {
+                    for (std::size_t i = 0; i + 1 < verts.size(); ++i)
+                    {
+                        emit(
+                            i > 0 ? verts[i - 1] : verts[i],
+                            verts[i],
+                            verts[i + 1],
+                            i + 2 < verts.size() ? verts[i + 2] : verts[i + 1]);
+                    }
+                }
+                else // Topology::Segments
+                {
+                    for (std::size_t i = 0; i + 1 < verts.size(); i += 2)
+                    {
+                        emit(verts[i], verts[i], verts[i + 1], verts[i + 1]);
+                    }
+                }
+
+                // local bounding sphere for the GPU culler:
+                vsg::dvec3 lo = verts.front(), hi = verts.front();
+                for (auto& v : verts)
+                {
+                    lo.x = std::min(lo.x, v.x), lo.y = std::min(lo.y, v.y), lo.z = std::min(lo.z, v.z);
+                    hi.x = std::max(hi.x, v.x), hi.y = std::max(hi.y, v.y), hi.z = std::max(hi.z, v.z);
+                }
+                auto center = (lo + hi) * 0.5;
+                double radius = 0.0;
+                for (auto& v : verts)
+                    radius = std::max(radius, vsg::length(v - center));
+
+                range.bsphere = vsg::vec4(vsg::vec3(center), (float)radius);
+            }
+
+            range.count = next - range.first;
+            _ranges[entity] = range;
+        });
+
+    _totalSegments = next;
+
+    if (_totalSegments > 0)
+    {
+        segments->dirty(0, _totalSegments * sizeof(LineSegmentGPU));
+    }
+}
+
+void
+LineSystem2Node::update(VSGContext& context)
+{
+    if (!status.ok())
+        return;
+
+    if (!context->renderingEnabled)
+        return;
+
+    // reset the indirect command buffer
+    auto& cmd = indirect_command->data<VkDrawIndexedIndirectCommand>()[0];
+    cmd = VkDrawIndexedIndirectCommand{ 6, 0, 0, 0, 0 };
+    indirect_command->dirty();
+
+    // update the cull list
+    auto* instances = cull_list->data<LineInstanceGPU>();
+
+    int count = 0;
+
+    auto [lock, registry] = _registry.read();
+
+    // re-pack the shared segment buffer if any line's geometry changed:
+    bool repack = false;
+    std::size_t lines = 0;
+    registry.view<Line>().each([&](auto entity, Line& line)
+        {
+            ++lines;
+            auto iter = _ranges.find(entity);
+            if (iter == _ranges.end() || iter->second.revision != line.revision)
+                repack = true;
+        });
+
+    if (repack || lines != _ranges.size())
+    {
+        packSegments(registry);
+    }
+
+    // This will build a draw list that applies to all active views.
+    auto view = registry.view<Line, ActiveState, Visibility, TransformData>();
+
+    view.each([&](auto entity, auto& line, auto& active, auto& visibility, auto& transformData)
+        {
+            auto iter = _ranges.find(entity);
+            if (iter == _ranges.end() || iter->second.count == 0)
+                return;
+
+            // resolve the style into a shared material, once per entity:
+            MaterialGPU material;
+            material.color = line.style.color;
+            material.width = line.style.width;
+            material.stipple_pattern = line.style.stipple_pattern;
+            material.stipple_factor = line.style.stipple_factor;
+            material.depth_offset = line.style.depth_offset;
+            auto material_index = context->materials->getOrAdd(material);
+
+            for (auto viewID : context->activeViewIDs)
+            {
+                if (ecs::visible(visibility, viewID) && count < MAX_CULL_LIST_SIZE)
+                {
+                    auto& view = transformData[viewID];
+
+                    auto& instance = instances[count++];
+                    instance.proj = view.proj;
+                    // compose the referencePoint localizer (the classic system's
+                    // MatrixTransform) into the modelview in double precision:
+                    instance.modelview = view.modelview * vsg::translate(iter->second.offset);
+                    instance.viewport = view.viewport;
+                    instance.bsphere = iter->second.bsphere;
+                    instance.material = material_index;
+                    instance.first_segment = iter->second.first;
+                    instance.num_segments = iter->second.count;
+                }
+            }
+        });
+
+    // configure the culling shader for 'count' instances
+    unsigned workgroups = (count + (GPU_CULLING_LOCAL_WG_SIZE - 1)) / GPU_CULLING_LOCAL_WG_SIZE;
+    cull_dispatch->groupCountX = workgroups;
+
+    // zero from the end of the cull list to the padding boundary;
+    // this sets the "num_segments" entries to zero, indicating a
+    // blank/padding entry
+    std::size_t padding_count = (workgroups * GPU_CULLING_LOCAL_WG_SIZE) - count;
+
+    if (padding_count > 0)
+    {
+        auto offset = count * sizeof(LineInstanceGPU);
+        auto bytes = std::min(padding_count * sizeof(LineInstanceGPU), MAX_CULL_LIST_SIZE * sizeof(LineInstanceGPU) - offset);
+        std::memset(&instances[count], 0, bytes);
+    }
+
+    auto total_cull_list_bytes_to_dirty = (count + padding_count) * sizeof(LineInstanceGPU);
+    cull_list->dirty(0, total_cull_list_bytes_to_dirty);
+}
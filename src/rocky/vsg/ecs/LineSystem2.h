@@ -0,0 +1,106 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Line.h>
+#include <rocky/vsg/ecs/ECSNode.h>
+#include <rocky/vsg/PipelineState.h>
+
+namespace ROCKY_NAMESPACE
+{
+    //! Per-entity instance record as mirrored in the culling compute shader.
+    //! The style lives in the shared MaterialTable; the instance carries
+    //! just an index into it.
+    struct LineInstanceGPU
+    {
+        vsg::mat4 proj;
+        vsg::mat4 modelview;
+        vsg::vec4 viewport = { 0,0,0,0 };   // x,y = lower left, z,w = width, height
+        vsg::vec4 bsphere = { 0,0,0,0 };    // local bounding sphere; xyz = center, w = radius
+
+        std::uint32_t material = 0;         // index into the shared MaterialTable
+        std::uint32_t first_segment = 0;    // offset into the segment buffer
+        std::uint32_t num_segments = 0;     // 0 = blank/padding entry
+
+        float padding[1];
+        // keep me 16-byte aligned with padding please
+    };
+
+    //! One line segment in the shared segment buffer. The quad is expanded
+    //! in the vertex shader; prev/next feed the miter joins.
+    struct LineSegmentGPU
+    {
+        vsg::vec4 prev;     // point before the segment (== curr0 at a string start)
+        vsg::vec4 curr0;    // segment start
+        vsg::vec4 curr1;    // segment end
+        vsg::vec4 next;     // point after the segment (== curr1 at a string end)
+    };
+
+    /**
+     * Renders all Line entities with a single indirect draw, GPU-culled by
+     * a compute shader - the same architecture as IconSystem2Node. The CPU
+     * streams one instance record per entity per view; the culling shader
+     * appends each visible entity's segments to the draw list and bumps the
+     * indirect instance count; the vertex shader expands each surviving
+     * segment into a screen-space quad. Record time is constant in the
+     * entity count.
+     */
+    class ROCKY_EXPORT LineSystem2Node : public vsg::Inherit<vsg::Group, LineSystem2Node>,
+        public ecs::System
+    {
+    public:
+        //! Construct the line renderer
+        LineSystem2Node(ecs::Registry& r);
+
+        //! Initialize the system (called once at startup)
+        void initialize(VSGContext&) override;
+
+        //! Update pass (called once per frame before recording starts)
+        void update(VSGContext&) override;
+
+    protected:
+        virtual ~LineSystem2Node();
+
+    private:
+
+        // dispatch command for the GPU culler
+        vsg::ref_ptr<vsg::Dispatch> cull_dispatch;
+
+        // The VkDrawIndexedIndirect command, which the GPU culler will
+        // write to and the rendering will read from
+        vsg::ref_ptr<StreamingGPUBuffer> indirect_command;
+
+        // The list of LineInstanceGPU records the GPU culler reads and
+        // the vertex shader indexes for style and matrices
+        vsg::ref_ptr<StreamingGPUBuffer> cull_list;
+
+        // Packed LineSegmentGPU records for every entity; re-streamed only
+        // when some line's geometry changes
+        vsg::ref_ptr<StreamingGPUBuffer> segments;
+
+        // GPU-side draw list binding (uvec2 = instance index, segment index)
+        vsg::ref_ptr<vsg::DescriptorBuffer> draw_list_descriptor;
+
+        // CPU-side segment packing, per entity
+        struct SegmentRange
+        {
+            std::uint32_t first = 0;
+            std::uint32_t count = 0;
+            vsg::vec4 bsphere = { 0,0,0,0 };
+            vsg::dvec3 offset = { 0,0,0 }; // referencePoint localizer offset
+            int revision = -1;
+        };
+        std::unordered_map<entt::entity, SegmentRange> _ranges;
+        std::uint32_t _totalSegments = 0u;
+
+        void buildCullStage(VSGContext& context);
+
+        void buildRenderStage(VSGContext& context);
+
+        //! Repack the shared segment buffer from every Line entity.
+        //! Called when an entity's geometry revision changes.
+        void packSegments(entt::registry& registry);
+    };
+}
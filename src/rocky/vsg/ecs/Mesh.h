@@ -59,10 +59,52 @@ namespace ROCKY_NAMESPACE
 
         //! Reference point for absolute coordinate localization (optional)
         GeoPoint referencePoint;
+
+        //! Marks the entire mesh dirty
+        inline void dirty() override
+        {
+            styleDirty = true;
+            trianglesDirty = true;
+            ++revision;
+        }
+
+        inline void dirtyStyle()
+        {
+            styleDirty = true;
+            ++revision;
+        }
+
+        inline void dirtyTriangles()
+        {
+            trianglesDirty = true;
+            ++revision;
+        }
+
+    private:
+        bool styleDirty = true;
+        bool trianglesDirty = true;
+        friend class MeshSystemNode;
     };
 
 
 
+    /**
+    * Instance of a shared mesh. Attach this (plus a Transform) to each
+    * entity and point it at a single "prototype" entity holding the Mesh
+    * itself; the instanced renderer (MeshSystem2Node) draws every instance
+    * of a prototype with one indirect draw command instead of one draw
+    * per entity.
+    */
+    struct MeshInstance : public RevisionedComponent
+    {
+        //! Entity holding the shared Mesh geometry
+        entt::entity prototype = entt::null;
+
+        //! Optional per-instance style; overrides the prototype's style
+        std::optional<MeshStyle> style;
+    };
+
+
     struct NodeGraph : public RevisionedComponent
     {
         vsg::ref_ptr<vsg::Node> node;
@@ -6,6 +6,7 @@
  */
 #include "MeshSystem.h"
 #include "../PipelineState.h"
+#include "../Utils.h"
 
 #include <vsg/state/BindDescriptorSet.h>
 #include <vsg/state/ViewDependentState.h>
@@ -87,7 +88,8 @@ MeshSystemNode::MeshSystemNode(ecs::Registry& registry) :
 void
 MeshSystemNode::initialize(VSGContext& context)
 {
-    auto shaderSet = createShaderSet(context);
+    auto shaderSet = context->getOrCreateShaderSet("rocky.mesh",
+        [&]() { return createShaderSet(context); });
 
     if (!shaderSet)
     {
@@ -170,6 +172,66 @@ MeshSystemNode::initialize(VSGContext& context)
     }
 }
 
+void
+MeshSystemNode::update(VSGContext& context)
+{
+    // Fast path for style-only changes: rewrite the mesh's dynamic style
+    // buffer right here and drop the entity from the rebuild queue,
+    // avoiding a component copy (including the full triangle set) and a
+    // complete geometry rebuild through the node factory.
+    if (!entities_to_update.empty())
+    {
+        auto [lock, registry] = _registry.read();
+
+        std::vector<entt::entity> needs_rebuild;
+        needs_rebuild.reserve(entities_to_update.size());
+
+        for (auto& entity : entities_to_update)
+        {
+            if (!registry.valid(entity))
+                continue;
+
+            auto& mesh = registry.get<Mesh>(entity);
+            auto& renderable = registry.get<ecs::Renderable>(mesh.attach_point);
+
+            if (renderable.node && mesh.style.has_value() && mesh.styleDirty && !mesh.trianglesDirty)
+            {
+                if (auto* bind = util::find<BindMeshDescriptors>(renderable.node))
+                {
+                    bind->updateStyle(mesh.style.value());
+                    mesh.styleDirty = false;
+                    continue;
+                }
+            }
+
+            needs_rebuild.emplace_back(entity);
+        }
+
+        entities_to_update.swap(needs_rebuild);
+    }
+
+    // everything left takes the normal build path. That path works on a
+    // copy of the component, so clear the live flags afterwards; the
+    // copy carries them into createOrUpdateNode.
+    auto rebuilt = entities_to_update;
+
+    Inherit::update(context);
+
+    if (!rebuilt.empty())
+    {
+        auto [lock, registry] = _registry.read();
+        for (auto& entity : rebuilt)
+        {
+            if (registry.valid(entity))
+            {
+                auto& mesh = registry.get<Mesh>(entity);
+                mesh.styleDirty = false;
+                mesh.trianglesDirty = false;
+            }
+        }
+    }
+}
+
 void
 MeshSystemNode::createOrUpdateNode(Mesh& mesh, ecs::BuildInfo& data, VSGContext& runtime) const
 {
@@ -101,13 +101,15 @@ namespace ROCKY_NAMESPACE
         //! Returns a mask of supported features for the given mesh
         int featureMask(const Mesh& mesh) const override;
 
-        //! One-time initialization of the system        
+        //! One-time initialization of the system
         void initialize(VSGContext&) override;
 
-        void createOrUpdateNode(Mesh&, ecs::BuildInfo&, VSGContext&) const override;
-    protected:
+        //! Per-frame update. Style-only changes take a fast path that
+        //! rewrites the mesh's dynamic style buffer in place, skipping
+        //! the rebuild round trip through the node factory.
+        void update(VSGContext&) override;
 
-        //bool update(entt::entity, VSGContext&) override;
+        void createOrUpdateNode(Mesh&, ecs::BuildInfo&, VSGContext&) const override;
     };
 
 
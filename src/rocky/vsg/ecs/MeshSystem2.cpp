@@ -0,0 +1,563 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "MeshSystem2.h"
+#include "../VSGContext.h"
+#include "../MaterialTable.h"
+#include "../PipelineState.h"
+#include "../Utils.h"
+
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ViewDependentState.h>
+#include <vsg/commands/DrawIndirect.h>
+
+#include <array>
+#include <cstring>
+
+using namespace ROCKY_NAMESPACE;
+
+#define VERT_SHADER "shaders/rocky.mesh.indirect.vert"
+#define FRAG_SHADER "shaders/rocky.mesh.frag" // same fragment interface as the classic pipeline
+#define CULL_SHADER "shaders/rocky.mesh.indirect.cull.comp"
+
+// these must match the layout() defs in the shaders.
+#define DESCRIPTOR_SET_INDEX 0  // must match layout(set=X) in the shaders
+
+#define INDIRECT_COMMAND_BUFFER_BINDING 0  // indirect command array
+#define CULL_LIST_BUFFER_BINDING 1  // input instance buffer
+#define DRAW_LIST_BUFFER_BINDING 2  // output draw_list buffer
+#define VERTEX_BUFFER_BINDING 3  // shared vertex buffer
+
+#define MAX_CULL_LIST_SIZE 16384
+#define MAX_COMMAND_LIST_SIZE 64 // distinct prototypes
+#define MAX_INSTANCES_PER_COMMAND MAX_CULL_LIST_SIZE
+#define MAX_VERTEX_LIST_SIZE 262144
+#define GPU_CULLING_LOCAL_WG_SIZE 32
+
+namespace
+{
+    //! Create a shader set for the culling compute shader.
+    vsg::ref_ptr<vsg::ShaderStage> createCullingShader(VSGContext& context)
+    {
+        auto computeShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            "main",
+            vsg::findFile(CULL_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (computeShader)
+        {
+            // Specializations to pass to the shader
+            computeShader->specializationConstants = vsg::ShaderStage::SpecializationConstants{
+                {0, vsg::intValue::create(GPU_CULLING_LOCAL_WG_SIZE)},   // layout(load_size_x_id, 0) in
+                {1, vsg::intValue::create(MAX_INSTANCES_PER_COMMAND)} }; // draw list slice per command
+        }
+
+        return computeShader;
+    }
+
+    //! Load and configure the shader stages for rendering.
+    vsg::ref_ptr<vsg::ShaderSet> createRenderingShaderSet(VSGContext& context)
+    {
+        auto vertexShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_VERTEX_BIT,
+            "main",
+            vsg::findFile(VERT_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        auto fragmentShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+            "main",
+            vsg::findFile(FRAG_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (!vertexShader || !fragmentShader)
+        {
+            return { };
+        }
+
+        auto shaderSet = vsg::ShaderSet::create(vsg::ShaderStages{ vertexShader, fragmentShader });
+
+        // We need VSG's view-dependent data:
+        PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_VERTEX_BIT);
+
+        // Note: 128 is the maximum size required by the Vulkan spec so don't increase it
+        shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+        return shaderSet;
+    }
+
+    //! Same localization the classic MeshSystem performs in
+    //! createOrUpdateNode: an SRS op into the world SRS plus an offset
+    //! for floating-point precision.
+    bool parseReferencePoint(const GeoPoint& point, SRSOperation& out_xform, vsg::dvec3& out_offset)
+    {
+        if (point.srs.valid())
+        {
+            SRS worldSRS = point.srs;
+
+            if (point.srs.isGeodetic())
+            {
+                worldSRS = point.srs.geocentricSRS();
+                GeoPoint world = point.transform(worldSRS);
+                if (world.valid())
+                {
+                    out_offset = vsg::dvec3{ world.x, world.y, world.z };
+                }
+            }
+            else
+            {
+                out_offset = vsg::dvec3{ point.x, point.y, point.z };
+            }
+
+            out_xform = SRSOperation(point.srs, worldSRS);
+            return true;
+        }
+        return false;
+    }
+}
+
+MeshSystem2Node::MeshSystem2Node(ecs::Registry& registry) :
+    ecs::System(registry)
+{
+    auto [lock, r] = registry.write();
+
+    r.on_construct<MeshInstance>().template connect<&ecs::detail::SystemNode_on_construct<MeshInstance>>();
+    r.on_update<MeshInstance>().template connect<&ecs::detail::SystemNode_on_update<MeshInstance>>();
+    r.on_destroy<MeshInstance>().template connect<&ecs::detail::SystemNode_on_destroy<MeshInstance>>();
+}
+
+MeshSystem2Node::~MeshSystem2Node()
+{
+    auto [lock, registry] = _registry.write();
+
+    registry.on_construct<MeshInstance>().template disconnect<&ecs::detail::SystemNode_on_construct<MeshInstance>>();
+    registry.on_update<MeshInstance>().template disconnect<&ecs::detail::SystemNode_on_update<MeshInstance>>();
+    registry.on_destroy<MeshInstance>().template disconnect<&ecs::detail::SystemNode_on_destroy<MeshInstance>>();
+}
+
+void
+MeshSystem2Node::initialize(VSGContext& context)
+{
+    // a dynamic SSBO that holds one draw-indirect command per prototype.
+    // The compute shader bumps the instance counts and the rendering
+    // consumes the whole array with a single vkCmdDrawIndirect.
+    indirect_commands = StreamingGPUBuffer::create(
+        INDIRECT_COMMAND_BUFFER_BINDING,
+        sizeof(VkDrawIndirectCommand) * MAX_COMMAND_LIST_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+    // a dynamic SSBO holding one instance record per entity per view.
+    // The CPU populates it each frame; the compute shader culls from it and
+    // the vertex shader reads style and matrices from it.
+    cull_list = StreamingGPUBuffer::create(
+        CULL_LIST_BUFFER_BINDING,
+        sizeof(MeshInstanceGPU) * MAX_CULL_LIST_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    // a dynamic SSBO with the packed vertices of every prototype mesh.
+    // Only re-streamed when some prototype's geometry actually changes.
+    vertices = StreamingGPUBuffer::create(
+        VERTEX_BUFFER_BINDING,
+        sizeof(MeshVertexGPU) * MAX_VERTEX_LIST_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    buildCullStage(context);
+
+    buildRenderStage(context);
+}
+
+void
+MeshSystem2Node::buildCullStage(VSGContext& context)
+{
+    // Configure the compute pipeline for culling:
+    auto compute_shader = createCullingShader(context);
+    if (!compute_shader)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Mesh compute shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+
+        return;
+    }
+
+    vsg::DescriptorSetLayoutBindings descriptor_bindings
+    {
+        {INDIRECT_COMMAND_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {CULL_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+    };
+
+    auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
+
+    auto pipeline_layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts{ descriptor_set_layout }, // set 0
+        vsg::PushConstantRanges{}); // no push constants
+
+    // the pipeline itself, and its binder:
+    auto pipeline = vsg::ComputePipeline::create(pipeline_layout, compute_shader);
+    auto bind_pipeline = vsg::BindComputePipeline::create(pipeline);
+
+    // the draw list is the output of the GPU culler and the input to the
+    // renderer; each command owns a fixed-size slice.
+    auto draw_list_size = MAX_COMMAND_LIST_SIZE * MAX_INSTANCES_PER_COMMAND * sizeof(std::uint32_t);
+
+    // GPU-only SSBO that will hold the final draw list.
+    auto draw_list_buffer_info = vsg::BufferInfo::create(
+        vsg::createBufferAndMemory(
+            context->device(),
+            draw_list_size,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT), // visible to GPU only!
+        0,
+        draw_list_size);
+
+    draw_list_descriptor = vsg::DescriptorBuffer::create(
+        vsg::BufferInfoList{ draw_list_buffer_info },
+        DRAW_LIST_BUFFER_BINDING,
+        0,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // bind all our descriptors to the pipeline.
+    auto bind_descriptors = vsg::BindDescriptorSet::create(
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipeline_layout,
+        vsg::DescriptorSet::create(
+            descriptor_set_layout,
+            vsg::Descriptors{
+                indirect_commands->descriptor, cull_list->descriptor, draw_list_descriptor }));
+
+    // stick it all under the compute graph. The vertex buffer streams
+    // here too, even though only the render stage reads it, and so does
+    // the shared material table (a no-op if another system already
+    // installed it).
+    auto cg = context->getComputeCommandGraph();
+
+    context->materials->install(cg);
+
+    cg->addChild(indirect_commands);
+    cg->addChild(cull_list);
+    cg->addChild(vertices);
+    cg->addChild(bind_pipeline);
+    cg->addChild(bind_descriptors);
+    cg->addChild(cull_dispatch = vsg::Dispatch::create(0, 1, 1)); // will be updated later
+}
+
+void
+MeshSystem2Node::buildRenderStage(VSGContext& context)
+{
+    auto shader_set = context->getOrCreateShaderSet("rocky.mesh.indirect",
+        [&]() { return createRenderingShaderSet(context); });
+    if (!shader_set)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Mesh shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        return;
+    }
+
+    vsg::VertexInputState::Bindings vertex_bindings
+    {
+        VkVertexInputBindingDescription{0, sizeof(vsg::vec3), VK_VERTEX_INPUT_RATE_VERTEX}  // "in_vertex"
+    };
+
+    vsg::VertexInputState::Attributes vertex_attributes
+    {
+        VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0}  // "in_vertex"
+    };
+
+    // Define the draw pipeline template.
+    vsg::DescriptorSetLayoutBindings descriptor_bindings
+    {
+        {CULL_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {DRAW_LIST_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {VERTEX_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {MaterialTable::BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr}
+    };
+
+    // PC's hold the projection and modelview matrices from VSG.
+    vsg::PushConstantRanges push_constant_ranges
+    {
+        {VK_SHADER_STAGE_VERTEX_BIT, 0, 128}
+    };
+
+    // Assemble all the pipeline states:
+    auto ia_state = vsg::InputAssemblyState::create();
+    ia_state->topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    auto rasterization_state = vsg::RasterizationState::create();
+    rasterization_state->cullMode = VK_CULL_MODE_BACK_BIT; // match the classic mesh pipeline default
+
+    auto depth_stencil_state = vsg::DepthStencilState::create();
+
+    VkPipelineColorBlendAttachmentState blend;
+    blend.blendEnable = true;
+    blend.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blend.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blend.colorBlendOp = VK_BLEND_OP_ADD;
+    blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blend.alphaBlendOp = VK_BLEND_OP_ADD;
+    blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    auto color_blend_state = vsg::ColorBlendState::create();
+    color_blend_state->attachments = vsg::ColorBlendState::ColorBlendAttachments{ blend };
+
+    vsg::GraphicsPipelineStates pipeline_states
+    {
+        vsg::VertexInputState::create(vertex_bindings, vertex_attributes),
+        ia_state,
+        rasterization_state,
+        vsg::MultisampleState::create(),
+        color_blend_state,
+        depth_stencil_state
+    };
+
+    // our layout:
+    auto descriptor_set_layout = vsg::DescriptorSetLayout::create(descriptor_bindings);
+
+    // VSG's view-dependent stuff:
+    auto view_dependent_binding = vsg::ViewDependentStateBinding::create(VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX);
+    auto view_dependent_descriptor_set_layout = view_dependent_binding->createDescriptorSetLayout();
+
+    auto pipeline_layout = vsg::PipelineLayout::create(
+        vsg::DescriptorSetLayouts {
+            descriptor_set_layout, // set 0
+            view_dependent_descriptor_set_layout,    // set 1 (vsg_viewport, vsg_lights, etc)
+        },
+        push_constant_ranges);
+
+    auto pipeline = vsg::GraphicsPipeline::create(pipeline_layout, shader_set->getShaderStages(), pipeline_states);
+    auto bind_pipeline = vsg::BindGraphicsPipeline::create(pipeline);
+
+    auto bind_descriptor_sets = vsg::BindDescriptorSet::create(
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipeline_layout,
+        DESCRIPTOR_SET_INDEX,
+        vsg::DescriptorSet::create(
+            descriptor_set_layout,
+            vsg::Descriptors{
+                cull_list->descriptor, draw_list_descriptor, vertices->descriptor,
+                context->materials->buffer->descriptor }));
+
+    auto bind_view_dependent_descriptor_sets = view_dependent_binding->createStateCommand(pipeline_layout);
+
+    // Add our binders to the scene graph.
+    this->addChild(bind_pipeline);
+    this->addChild(bind_descriptor_sets);
+    this->addChild(bind_view_dependent_descriptor_sets);
+
+    // the actual rendering command, finally. drawCount is updated each
+    // frame to the number of active prototypes.
+    draw_indirect = vsg::DrawIndirect::create();
+    draw_indirect->bufferInfo = indirect_commands->ssbo;
+    draw_indirect->drawCount = 0;
+    draw_indirect->stride = sizeof(VkDrawIndirectCommand);
+
+    // geometry with dummy vertex positions; the shader fetches the real
+    // vertices from the shared SSBO.
+    auto geometry = vsg::Geometry::create();
+    geometry->assignArrays(vsg::DataList{ vsg::vec3Array::create(3) });
+    geometry->commands.emplace_back(draw_indirect);
+
+    this->addChild(geometry);
+}
+
+void
+MeshSystem2Node::packPrototypes(entt::registry& registry)
+{
+    auto* verts = vertices->data<MeshVertexGPU>();
+    std::uint32_t next = 0u;
+    std::uint32_t command = 0u;
+
+    _prototypes.clear();
+
+    registry.view<MeshInstance>().each([&](auto entity, MeshInstance& instance)
+        {
+            if (instance.prototype == entt::null || !registry.valid(instance.prototype))
+                return;
+
+            if (_prototypes.count(instance.prototype) > 0 || command >= MAX_COMMAND_LIST_SIZE)
+                return;
+
+            auto* mesh = registry.try_get<Mesh>(instance.prototype);
+            if (!mesh || mesh->triangles.empty())
+                return;
+
+            PrototypeRange range;
+            range.command = command++;
+            range.first_vertex = next;
+            range.revision = mesh->revision;
+
+            SRSOperation xform;
+            vsg::dvec3 offset{ 0, 0, 0 };
+            bool localize = mesh->referencePoint.valid() &&
+                parseReferencePoint(mesh->referencePoint, xform, offset);
+            range.offset = offset;
+
+            vsg::dvec3 lo, hi;
+            bool first = true;
+
+            for (auto& tri : mesh->triangles)
+            {
+                if (next + 3 > MAX_VERTEX_LIST_SIZE)
+                    break;
+
+                for (int v = 0; v < 3; ++v)
+                {
+                    vsg::dvec3 vert = tri.verts[v];
+                    if (localize)
+                    {
+                        vsg::dvec3 temp;
+                        xform(tri.verts[v], temp);
+                        vert = temp - offset;
+                    }
+
+                    auto& out = verts[next++];
+                    out.position = vsg::vec4(vsg::vec3(vert), tri.depthoffsets[v]);
+                    out.color = tri.colors[v];
+                    out.uv = vsg::vec4(tri.uvs[v].x, tri.uvs[v].y, 0.0f, 0.0f);
+
+                    if (first)
+                        lo = hi = vert, first = false;
+                    else
+                    {
+                        lo.x = std::min(lo.x, vert.x), lo.y = std::min(lo.y, vert.y), lo.z = std::min(lo.z, vert.z);
+                        hi.x = std::max(hi.x, vert.x), hi.y = std::max(hi.y, vert.y), hi.z = std::max(hi.z, vert.z);
+                    }
+                }
+            }
+
+            range.num_vertices = next - range.first_vertex;
+
+            if (!first)
+            {
+                auto center = (lo + hi) * 0.5;
+                range.bsphere = vsg::vec4(vsg::vec3(center), (float)(vsg::length(hi - lo) * 0.5));
+            }
+
+            _prototypes[instance.prototype] = range;
+        });
+
+    _totalVertices = next;
+
+    if (_totalVertices > 0)
+    {
+        vertices->dirty(0, _totalVertices * sizeof(MeshVertexGPU));
+    }
+}
+
+void
+MeshSystem2Node::update(VSGContext& context)
+{
+    if (!status.ok())
+        return;
+
+    if (!context->renderingEnabled)
+        return;
+
+    auto [lock, registry] = _registry.read();
+
+    // re-pack the shared vertex buffer if any prototype's geometry changed:
+    bool repack = false;
+    registry.view<MeshInstance>().each([&](auto entity, MeshInstance& instance)
+        {
+            if (instance.prototype == entt::null)
+                return;
+            auto iter = _prototypes.find(instance.prototype);
+            auto* mesh = registry.try_get<Mesh>(instance.prototype);
+            if (mesh && (iter == _prototypes.end() || iter->second.revision != mesh->revision))
+                repack = true;
+        });
+
+    if (repack)
+    {
+        packPrototypes(registry);
+    }
+
+    // reset the indirect command array; the culler will bump the instance counts.
+    auto* cmds = indirect_commands->data<VkDrawIndirectCommand>();
+    std::memset(cmds, 0, sizeof(VkDrawIndirectCommand) * MAX_COMMAND_LIST_SIZE);
+    for (auto& [entity, range] : _prototypes)
+    {
+        cmds[range.command] = VkDrawIndirectCommand{
+            range.num_vertices,
+            0, // instanceCount; written by the culling shader
+            range.first_vertex,
+            range.command * MAX_INSTANCES_PER_COMMAND }; // firstInstance = draw list slice
+    }
+    indirect_commands->dirty();
+
+    draw_indirect->drawCount = (std::uint32_t)_prototypes.size();
+
+    // update the cull list
+    auto* instances = cull_list->data<MeshInstanceGPU>();
+
+    int count = 0;
+    std::array<std::uint32_t, MAX_COMMAND_LIST_SIZE> per_command = { };
+
+    // This will build a draw list that applies to all active views.
+    auto view = registry.view<MeshInstance, ActiveState, Visibility, TransformData>();
+
+    view.each([&](auto entity, auto& mesh_instance, auto& active, auto& visibility, auto& transformData)
+        {
+            auto iter = _prototypes.find(mesh_instance.prototype);
+            if (iter == _prototypes.end() || iter->second.num_vertices == 0)
+                return;
+
+            auto& range = iter->second;
+
+            for (auto viewID : context->activeViewIDs)
+            {
+                // cap each command's population so its draw list slice cannot overflow:
+                if (ecs::visible(visibility, viewID) &&
+                    count < MAX_CULL_LIST_SIZE &&
+                    per_command[range.command] < MAX_INSTANCES_PER_COMMAND)
+                {
+                    auto& view = transformData[viewID];
+
+                    auto& instance = instances[count++];
+                    per_command[range.command]++;
+
+                    instance.proj = view.proj;
+                    // compose the referencePoint localizer (the classic system's
+                    // MatrixTransform) into the modelview in double precision:
+                    instance.modelview = view.modelview * vsg::translate(range.offset);
+                    instance.bsphere = range.bsphere;
+                    instance.command = range.command;
+
+                    auto& style = mesh_instance.style.has_value() ? mesh_instance.style :
+                        registry.get<Mesh>(mesh_instance.prototype).style;
+
+                    MaterialGPU material;
+                    material.color = { 1, 1, 1, 0 }; // alpha 0 = use vertex colors
+                    if (style.has_value())
+                    {
+                        material.color = style->color;
+                        material.depth_offset = style->depth_offset;
+                    }
+                    instance.material = context->materials->getOrAdd(material);
+                }
+            }
+        });
+
+    // configure the culling shader for 'count' instances
+    unsigned workgroups = (count + (GPU_CULLING_LOCAL_WG_SIZE - 1)) / GPU_CULLING_LOCAL_WG_SIZE;
+    cull_dispatch->groupCountX = workgroups;
+
+    // zero from the end of the cull list to the padding boundary;
+    // this sets the "radius" entries to zero, indicating a blank/padding entry
+    std::size_t padding_count = (workgroups * GPU_CULLING_LOCAL_WG_SIZE) - count;
+
+    if (padding_count > 0)
+    {
+        auto offset = count * sizeof(MeshInstanceGPU);
+        auto bytes = std::min(padding_count * sizeof(MeshInstanceGPU), MAX_CULL_LIST_SIZE * sizeof(MeshInstanceGPU) - offset);
+        std::memset(&instances[count], 0, bytes);
+    }
+
+    auto total_cull_list_bytes_to_dirty = (count + padding_count) * sizeof(MeshInstanceGPU);
+    cull_list->dirty(0, total_cull_list_bytes_to_dirty);
+}
@@ -0,0 +1,111 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Mesh.h>
+#include <rocky/vsg/ecs/ECSNode.h>
+#include <rocky/vsg/PipelineState.h>
+
+namespace ROCKY_NAMESPACE
+{
+    //! Per-entity instance record as mirrored in the culling compute shader.
+    //! The style lives in the shared MaterialTable; the instance carries
+    //! just an index into it.
+    struct MeshInstanceGPU
+    {
+        vsg::mat4 proj;
+        vsg::mat4 modelview;
+        vsg::vec4 bsphere = { 0,0,0,0 };    // local bounding sphere; xyz = center, w = radius (0 = padding entry)
+
+        std::uint32_t material = 0;         // index into the shared MaterialTable
+        std::uint32_t command = 0;          // indirect command (prototype) index
+
+        float padding[2];
+        // keep me 16-byte aligned with padding please
+    };
+
+    //! One vertex in the shared mesh vertex buffer. The instanced path
+    //! fetches vertices from an SSBO instead of vertex attributes so that
+    //! every prototype can live in the same buffer.
+    struct MeshVertexGPU
+    {
+        vsg::vec4 position; // xyz = position, w = depth offset (meters)
+        vsg::vec4 color;
+        vsg::vec4 uv;       // xy = texture coordinate
+    };
+
+    /**
+     * Renders all MeshInstance entities with a single multi-command
+     * indirect draw, GPU-culled by a compute shader - the same architecture
+     * as IconSystem2Node. Each distinct prototype Mesh gets one
+     * VkDrawIndirectCommand pointing into a shared vertex buffer; the CPU
+     * streams one instance record per entity per view, and the culling
+     * shader appends survivors to the prototype's slice of the draw list
+     * and bumps that command's instance count. Record time is a handful of
+     * commands regardless of how many entities share each model.
+     */
+    class ROCKY_EXPORT MeshSystem2Node : public vsg::Inherit<vsg::Group, MeshSystem2Node>,
+        public ecs::System
+    {
+    public:
+        //! Construct the mesh renderer
+        MeshSystem2Node(ecs::Registry& r);
+
+        //! Initialize the system (called once at startup)
+        void initialize(VSGContext&) override;
+
+        //! Update pass (called once per frame before recording starts)
+        void update(VSGContext&) override;
+
+    protected:
+        virtual ~MeshSystem2Node();
+
+    private:
+
+        // dispatch command for the GPU culler
+        vsg::ref_ptr<vsg::Dispatch> cull_dispatch;
+
+        // the indirect rendering command; drawCount tracks the number of
+        // active prototypes
+        vsg::ref_ptr<vsg::DrawIndirect> draw_indirect;
+
+        // The VkDrawIndirectCommand array, one entry per prototype, which
+        // the GPU culler will write to and the rendering will read from
+        vsg::ref_ptr<StreamingGPUBuffer> indirect_commands;
+
+        // The list of MeshInstanceGPU records the GPU culler reads and
+        // the vertex shader indexes for style and matrices
+        vsg::ref_ptr<StreamingGPUBuffer> cull_list;
+
+        // Packed MeshVertexGPU records for every prototype; re-streamed
+        // only when some prototype's geometry changes
+        vsg::ref_ptr<StreamingGPUBuffer> vertices;
+
+        // GPU-side draw list binding (one instance index per visible entity,
+        // sliced per command)
+        vsg::ref_ptr<vsg::DescriptorBuffer> draw_list_descriptor;
+
+        // CPU-side vertex packing, per prototype entity
+        struct PrototypeRange
+        {
+            std::uint32_t command = 0;      // indirect command index
+            std::uint32_t first_vertex = 0; // offset into the vertex buffer
+            std::uint32_t num_vertices = 0;
+            vsg::vec4 bsphere = { 0,0,0,0 };
+            vsg::dvec3 offset = { 0,0,0 };  // referencePoint localizer offset
+            int revision = -1;
+        };
+        std::unordered_map<entt::entity, PrototypeRange> _prototypes;
+        std::uint32_t _totalVertices = 0u;
+
+        void buildCullStage(VSGContext& context);
+
+        void buildRenderStage(VSGContext& context);
+
+        //! Repack the shared vertex buffer from every referenced prototype.
+        //! Called when a prototype's geometry revision changes.
+        void packPrototypes(entt::registry& registry);
+    };
+}
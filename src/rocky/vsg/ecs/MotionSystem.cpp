@@ -0,0 +1,188 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "MotionSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ROCKY_NAMESPACE;
+
+void
+MotionSystem::update(VSGContext& context)
+{
+    auto time = context->viewer->getFrameStamp()->time;
+
+    if (last_time != ecs::time_point::min())
+    {
+        // accumulate frame time, to be consumed in whole fixed steps:
+        _accumulated += 1e-9 * (double)(time - last_time).count();
+
+        // don't let a long hitch trigger a runaway catch-up:
+        _accumulated = std::min(_accumulated, 10.0 * timestep);
+
+        const double n = std::floor(_accumulated / timestep);
+        _accumulated -= n * timestep;
+
+        if (n > 0.0)
+        {
+            const double h = timestep;
+            const double T = n * h; // total time to integrate this frame
+
+            // Closed form for n explicit-Euler steps under constant
+            // acceleration: position moves by v*T + a*accel_term, and the
+            // velocity by a*T. Identical to stepping n times, without the
+            // per-step loop.
+            const double accel_term = h * h * n * (n - 1.0) * 0.5;
+
+            auto [lock, registry] = _registry.read();
+
+            const glm::dvec3 zero{ 0.0, 0.0, 0.0 };
+
+            _pos.clear();
+            _disp.clear();
+            _motions.clear();
+            _transforms.clear();
+
+            // SRS shared by the batched entities; set from the first
+            // geodetic entity we encounter. (In practice every mover shares
+            // one geodetic SRS; stragglers take the per-entity path.)
+            SRS batch_srs;
+
+            // Join query all motions + transform pairs:
+            for (auto&& [entity, motion, transform] : registry.view<Motion, Transform>().each())
+            {
+                if (motion.velocity == zero && motion.acceleration == zero)
+                    continue;
+
+                GeoPoint& pos = transform.position;
+
+                if (pos.srs.isGeodetic() && (!batch_srs.valid() || pos.srs == batch_srs))
+                {
+                    // batch path: pack the position and the local-tangent
+                    // displacement for this frame's steps.
+                    if (!batch_srs.valid())
+                        batch_srs = pos.srs;
+
+                    _pos.emplace_back(pos.x, pos.y, pos.z);
+                    _disp.emplace_back(motion.velocity * T + motion.acceleration * accel_term);
+                    _motions.emplace_back(&motion);
+                    _transforms.emplace_back(&transform);
+                }
+                else
+                {
+                    // per-entity path for geocentric or projected positions.
+                    if (motion.velocity != zero)
+                    {
+                        double save_z = pos.z;
+
+                        SRSOperation pos_to_world;
+                        if (!pos.srs.isGeocentric())
+                            pos_to_world = pos.srs.to(pos.srs.geocentricSRS());
+
+                        // move the entity using a velocity vector in the local tangent plane
+                        glm::dvec3 world;
+                        pos_to_world((glm::dvec3)pos, world);
+                        auto l2w = pos.srs.ellipsoid().topocentricToGeocentricMatrix(world);
+
+                        world = l2w * (motion.velocity * T + motion.acceleration * accel_term);
+
+                        vsg::dvec3 coord(world.x, world.y, world.z);
+                        pos_to_world.inverse(coord, coord);
+
+                        pos.x = coord.x, pos.y = coord.y;
+                        pos.z = save_z;
+                        transform.dirty();
+                    }
+
+                    motion.velocity += motion.acceleration * T;
+                }
+            }
+
+            const std::size_t count = _pos.size();
+            if (count > 0)
+            {
+                auto& ellipsoid = batch_srs.ellipsoid();
+
+                _alt.resize(count);
+
+                // Rotate each local-tangent displacement into the world frame
+                // using the geodetic ENU basis at the entity's location. Pure
+                // math over flat arrays - the compiler can vectorize it.
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    double lon = deg2rad(_pos[i].x);
+                    double lat = deg2rad(_pos[i].y);
+
+                    double sin_lon = sin(lon), cos_lon = cos(lon);
+                    double sin_lat = sin(lat), cos_lat = cos(lat);
+
+                    glm::dvec3 d = _disp[i];
+
+                    _disp[i] = glm::dvec3(
+                        -sin_lon * d.x - sin_lat * cos_lon * d.y + cos_lat * cos_lon * d.z,
+                         cos_lon * d.x - sin_lat * sin_lon * d.y + cos_lat * sin_lon * d.z,
+                                         cos_lat * d.y           + sin_lat * d.z);
+
+                    _alt[i] = _pos[i].z;
+                }
+
+                // to geocentric, advance, and back - the geodetic wrap at the
+                // antimeridian and poles falls out of the round trip:
+                ellipsoid.geodeticToGeocentricArray(_pos.data(), count);
+
+                for (std::size_t i = 0; i < count; ++i)
+                    _pos[i] += _disp[i];
+
+                ellipsoid.geocentricToGeodeticArray(_pos.data(), count);
+
+                // write back, preserving each entity's altitude as the
+                // per-entity path does:
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    GeoPoint& pos = _transforms[i]->position;
+                    pos.x = _pos[i].x;
+                    pos.y = _pos[i].y;
+                    pos.z = _alt[i];
+
+                    _motions[i]->velocity += _motions[i]->acceleration * T;
+                    _transforms[i]->dirty();
+                }
+            }
+
+            for (auto&& [entity, motion, transform] : registry.view<MotionGreatCircle, Transform>().each())
+            {
+                // Note. For this demo, we just use the length of the velocity and acceleration
+                // vectors and ignore direction.
+                if (motion.velocity != zero)
+                {
+                    GeoPoint& pos = transform.position;
+
+                    SRSOperation pos_to_world;
+                    if (!pos.srs.isGeocentric())
+                        pos_to_world = pos.srs.to(pos.srs.geocentricSRS());
+
+                    glm::dvec3 world;
+                    pos_to_world((glm::dvec3)pos, world);
+                    double distance = glm::length(motion.velocity * T);
+                    double R = glm::length(world);
+                    double circ = 2.0 * glm::pi<double>() * R;
+                    double angle = 360.0 * distance / circ;
+
+                    glm::dquat rot = glm::angleAxis(deg2rad(angle), motion.normalAxis);
+                    auto temp = rot * world;
+                    pos_to_world.inverse(temp, temp);
+                    pos.x = temp.x, pos.y = temp.y, pos.z = temp.z;
+
+                    transform.dirty();
+
+                    motion.velocity += motion.acceleration * T;
+                }
+            }
+        }
+    }
+
+    last_time = time;
+}
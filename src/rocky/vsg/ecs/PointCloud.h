@@ -0,0 +1,63 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/Component.h>
+#include <rocky/GeoPoint.h>
+#include <optional>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Render settings for a point cloud.
+     */
+    struct PointCloudStyle
+    {
+        // if alpha is zero, use the per-point color instead
+        vsg::vec4 color = { 1, 1, 1, 0 };
+
+        // size of each point in pixels; zero = use the default
+        float pointSize = 0.0f;
+    };
+
+    /**
+    * Point cloud component. Holds packed 16-byte point records (position
+    * plus an RGBA8 color, which survey pipelines typically fill from RGB
+    * imagery or a colorized intensity ramp).
+    *
+    * The renderer splits the points into chunks and gives each chunk its
+    * own cull volume and a level-of-detail budget, so clouds far larger
+    * than the screen can afford only pay for the points their chunks
+    * contribute at the current view. Points are drawn in a shuffled
+    * order, which makes every budget-limited prefix of a chunk a uniform
+    * subsample of it.
+    */
+    struct PointCloud : public RevisionedComponent
+    {
+        //! One packed point record
+        struct Point
+        {
+            vsg::vec3 position;
+            vsg::ubvec4 color = { 255, 255, 255, 255 };
+        };
+
+        //! The points. Positions are either absolute (see referencePoint)
+        //! or in a local frame supplied by a Transform on the entity.
+        std::vector<Point> points;
+
+        //! Number of points per cull/LOD chunk
+        unsigned chunkSize = 262144;
+
+        //! Maximum points a chunk renders at full detail; each coarser
+        //! detail level renders a quarter of the previous one
+        unsigned pointBudget = 262144;
+
+        //! Optional dynamic style data
+        std::optional<PointCloudStyle> style;
+
+        //! Reference point for absolute coordinate localization (optional)
+        GeoPoint referencePoint;
+    };
+}
@@ -0,0 +1,335 @@
+
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "PointCloudSystem.h"
+#include "../PipelineState.h"
+
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ViewDependentState.h>
+#include <vsg/commands/Draw.h>
+
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/LOD.h>
+#include <vsg/nodes/MatrixTransform.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace ROCKY_NAMESPACE;
+
+#define POINTCLOUD_VERT_SHADER "shaders/rocky.pointcloud.vert"
+#define POINTCLOUD_FRAG_SHADER "shaders/rocky.pointcloud.frag"
+
+#define POINTCLOUD_UNIFORM_SET 0 // must match layout(set=X) in the shader UBO
+#define POINTCLOUD_STYLE_BUFFER_BINDING 1 // must match the layout(binding=X) in the shader UBO (set=0)
+
+namespace
+{
+    vsg::ref_ptr<vsg::ShaderSet> createShaderSet(VSGContext& context)
+    {
+        vsg::ref_ptr<vsg::ShaderSet> shaderSet;
+
+        // load shaders
+        auto vertexShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_VERTEX_BIT,
+            "main",
+            vsg::findFile(POINTCLOUD_VERT_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        auto fragmentShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+            "main",
+            vsg::findFile(POINTCLOUD_FRAG_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (!vertexShader || !fragmentShader)
+        {
+            return { };
+        }
+
+        vsg::ShaderStages shaderStages{ vertexShader, fragmentShader };
+
+        shaderSet = vsg::ShaderSet::create(shaderStages);
+
+        // "binding" (3rd param) must match "layout(location=X) in" in the vertex shader
+        shaderSet->addAttributeBinding("in_vertex", "", 0, VK_FORMAT_R32G32B32_SFLOAT, {});
+        shaderSet->addAttributeBinding("in_color",  "", 1, VK_FORMAT_R8G8B8A8_UNORM, {});
+
+        // point cloud style uniform buffer (color override, point size)
+        shaderSet->addDescriptorBinding("pointcloud", "USE_POINTCLOUD_STYLE",
+            POINTCLOUD_UNIFORM_SET, POINTCLOUD_STYLE_BUFFER_BINDING,
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
+
+        // Note: 128 is the maximum size required by the Vulkan spec so don't increase it
+        shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+        return shaderSet;
+    }
+}
+
+
+PointCloudSystemNode::PointCloudSystemNode(ecs::Registry& registry) :
+    Inherit(registry)
+{
+    //nop
+}
+
+void
+PointCloudSystemNode::initialize(VSGContext& context)
+{
+    auto shaderSet = context->getOrCreateShaderSet("rocky.pointcloud",
+        [&]() { return createShaderSet(context); });
+
+    if (!shaderSet)
+    {
+        status = Status(Status::ResourceUnavailable,
+            "Point cloud shaders are missing or corrupt. "
+            "Did you set ROCKY_FILE_PATH to point at the rocky share folder?");
+        return;
+    }
+
+    pipelines.resize(NUM_PIPELINES);
+
+    // create all pipeline permutations.
+    for (int feature_mask = 0; feature_mask < NUM_PIPELINES; ++feature_mask)
+    {
+        auto& c = pipelines[feature_mask];
+
+        c.config = vsg::GraphicsPipelineConfig::create(shaderSet);
+
+        // Compile settings / defines. We need to clone this since it may be
+        // different defines for each configuration permutation.
+        c.config->shaderHints = context->shaderCompileSettings ?
+            vsg::ShaderCompileSettings::create(*context->shaderCompileSettings) :
+            vsg::ShaderCompileSettings::create();
+
+        // activate the arrays we intend to use
+        c.config->enableArray("in_vertex", VK_VERTEX_INPUT_RATE_VERTEX, 12);
+        c.config->enableArray("in_color", VK_VERTEX_INPUT_RATE_VERTEX, 4);
+
+        if (feature_mask & DYNAMIC_STYLE)
+        {
+            c.config->enableDescriptor("pointcloud");
+            c.config->shaderHints->defines.insert("USE_POINTCLOUD_STYLE");
+        }
+
+        struct SetPipelineStates : public vsg::Visitor
+        {
+            void apply(vsg::Object& object) override {
+                object.traverse(*this);
+            }
+            void apply(vsg::InputAssemblyState& state) override {
+                state.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+            }
+            void apply(vsg::RasterizationState& state) override {
+                state.cullMode = VK_CULL_MODE_NONE;
+            }
+        };
+        SetPipelineStates visitor;
+        c.config->accept(visitor);
+
+        // Initialize GraphicsPipeline from the data in the configuration.
+        c.config->init();
+
+        c.commands = vsg::Commands::create();
+        c.commands->addChild(c.config->bindGraphicsPipeline);
+    }
+}
+
+void
+PointCloudSystemNode::createOrUpdateNode(PointCloud& pointcloud, ecs::BuildInfo& data, VSGContext& runtime) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(!pointcloud.points.empty(), void());
+
+    const unsigned chunkSize = std::max(1u, pointcloud.chunkSize);
+    const unsigned budget = std::max(1u, pointcloud.pointBudget);
+    const auto numPoints = pointcloud.points.size();
+
+    // Draw the points in a shuffled order so that any prefix of a chunk
+    // is a uniform subsample of it; the LOD levels below then simply
+    // draw shorter prefixes of the same arrays. The seed is fixed so a
+    // style-only revision rebuilds an identical graph.
+    std::vector<std::uint32_t> order(numPoints);
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), std::mt19937(0));
+
+    // optional localization for absolute coordinates:
+    SRSOperation xform;
+    vsg::dvec3 offset;
+    bool localize = pointcloud.referencePoint.valid() ?
+        parseReferencePoint(pointcloud.referencePoint, xform, offset) : false;
+
+    auto chunks = vsg::Group::create();
+
+    for (std::size_t first = 0; first < numPoints; first += chunkSize)
+    {
+        auto count = std::min((std::size_t)chunkSize, numPoints - first);
+
+        auto verts = vsg::vec3Array::create(count);
+        auto colors = vsg::ubvec4Array::create(count);
+
+        vsg::dsphere bound;
+        vsg::dbox box;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto& point = pointcloud.points[order[first + i]];
+
+            if (localize)
+            {
+                vsg::dvec3 world;
+                xform(vsg::dvec3(point.position), world);
+                verts->set(i, vsg::vec3(world - offset));
+            }
+            else
+            {
+                verts->set(i, point.position);
+            }
+
+            colors->set(i, point.color);
+            box.add(vsg::dvec3(verts->at(i)));
+        }
+
+        vsg::dvec3 center = (box.min + box.max) * 0.5;
+        bound.set(center, vsg::length(box.max - center));
+
+        // Detail levels share the chunk's arrays and draw progressively
+        // shorter prefixes; each level covers a screen-height band and
+        // renders a quarter of the previous one's points.
+        auto lod = vsg::LOD::create();
+        lod->bound = bound;
+
+        unsigned drawCount = std::min((unsigned)count, budget);
+        double screenHeightRatio = 0.5;
+
+        while (true)
+        {
+            auto geometry = PointCloudGeometry::create();
+            geometry->set(verts, colors, drawCount);
+
+            bool last = (drawCount <= 1u) || (drawCount >> 2) == 0u;
+            lod->addChild(vsg::LOD::Child{ last ? 0.0 : screenHeightRatio, geometry });
+
+            if (last)
+                break;
+
+            drawCount >>= 2;
+            screenHeightRatio *= 0.5;
+        }
+
+        vsg::ref_ptr<vsg::Node> chunk = lod;
+        if (localize)
+        {
+            auto localizer = vsg::MatrixTransform::create(vsg::translate(offset));
+            localizer->addChild(lod);
+            chunk = localizer;
+        }
+
+        auto cull = vsg::CullNode::create();
+        cull->child = chunk;
+        cull->bound = localize ? vsg::dsphere(bound.center + offset, bound.radius) : bound;
+        chunks->addChild(cull);
+    }
+
+    if (pointcloud.style.has_value())
+    {
+        auto bindCommand = BindPointCloudDescriptors::create();
+        bindCommand->updateStyle(pointcloud.style.value());
+        bindCommand->init(getPipelineLayout(pointcloud));
+
+        auto stategroup = vsg::StateGroup::create();
+        stategroup->stateCommands.push_back(bindCommand);
+        stategroup->addChild(chunks);
+        data.new_node = stategroup;
+    }
+    else
+    {
+        data.new_node = chunks;
+    }
+}
+
+int
+PointCloudSystemNode::featureMask(const PointCloud& pointcloud) const
+{
+    int feature_set = 0;
+    if (pointcloud.style.has_value()) feature_set |= DYNAMIC_STYLE;
+    return feature_set;
+}
+
+
+BindPointCloudDescriptors::BindPointCloudDescriptors()
+{
+    //nop
+}
+
+void
+BindPointCloudDescriptors::updateStyle(const PointCloudStyle& value)
+{
+    if (!_styleData)
+    {
+        _styleData = vsg::ubyteArray::create(sizeof(PointCloudStyle));
+
+        // tells VSG that the contents can change, and if they do, the data should be
+        // transfered to the GPU before or during recording.
+        _styleData->properties.dataVariance = vsg::DYNAMIC_DATA;
+    }
+
+    PointCloudStyle& my_style = *static_cast<PointCloudStyle*>(_styleData->dataPointer());
+    my_style = value;
+    _styleData->dirty();
+}
+
+void
+BindPointCloudDescriptors::init(vsg::ref_ptr<vsg::PipelineLayout> layout)
+{
+    if (_styleData)
+    {
+        auto ubo = vsg::DescriptorBuffer::create(_styleData, POINTCLOUD_STYLE_BUFFER_BINDING, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+
+        this->pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        this->firstSet = 0;
+        this->layout = layout;
+        this->descriptorSet = vsg::DescriptorSet::create(
+            layout->setLayouts.front(),
+            vsg::Descriptors{ ubo });
+    }
+}
+
+
+PointCloudGeometry::PointCloudGeometry()
+{
+    _drawCommand = vsg::Draw::create(
+        0, // vertex count
+        1, // instance count
+        0, // first vertex
+        0  // first instance
+    );
+}
+
+void
+PointCloudGeometry::set(
+    vsg::ref_ptr<vsg::vec3Array> verts,
+    vsg::ref_ptr<vsg::ubvec4Array> colors,
+    unsigned drawCount)
+{
+    assignArrays({ verts, colors });
+    _drawCommand->vertexCount = drawCount;
+}
+
+void
+PointCloudGeometry::compile(vsg::Context& context)
+{
+    if (commands.empty())
+    {
+        if (_drawCommand->vertexCount == 0)
+            return;
+
+        commands.push_back(_drawCommand);
+    }
+
+    vsg::Geometry::compile(context);
+}
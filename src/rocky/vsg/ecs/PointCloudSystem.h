@@ -0,0 +1,78 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+#include <rocky/vsg/ecs/PointCloud.h>
+#include <rocky/vsg/ecs/ECSNode.h>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Command to render one detail level of a point cloud chunk. The
+    * levels of a chunk share the same vertex arrays and differ only in
+    * how many points they draw.
+    */
+    class ROCKY_EXPORT PointCloudGeometry : public vsg::Inherit<vsg::Geometry, PointCloudGeometry>
+    {
+    public:
+        //! Construct a point cloud geometry node
+        PointCloudGeometry();
+
+        //! Assign the (shared) arrays and the number of points this
+        //! level draws from them
+        void set(
+            vsg::ref_ptr<vsg::vec3Array> verts,
+            vsg::ref_ptr<vsg::ubvec4Array> colors,
+            unsigned drawCount);
+
+        void compile(vsg::Context&) override;
+
+        vsg::ref_ptr<vsg::Draw> _drawCommand;
+    };
+
+    /**
+    * Command to bind any descriptors associated with PointCloud.
+    */
+    class ROCKY_EXPORT BindPointCloudDescriptors : public vsg::Inherit<vsg::BindDescriptorSet, BindPointCloudDescriptors>
+    {
+    public:
+        //! Construct a default styling command
+        BindPointCloudDescriptors();
+
+        //! Initialize this command with the associated layout
+        void init(vsg::ref_ptr<vsg::PipelineLayout> layout);
+
+        //! Refresh the data buffer contents on the GPU
+        void updateStyle(const PointCloudStyle&);
+
+        vsg::ref_ptr<vsg::ubyteArray> _styleData;
+    };
+
+    /**
+    * VSG node that renders PointCloud components.
+    */
+    class ROCKY_EXPORT PointCloudSystemNode : public vsg::Inherit<ecs::SystemNode<PointCloud>, PointCloudSystemNode>
+    {
+    public:
+        //! Construct the point cloud renderer
+        PointCloudSystemNode(ecs::Registry& registry);
+
+        //! Supported features in a mask format
+        enum Features
+        {
+            NONE          = 0,
+            DYNAMIC_STYLE = 1 << 0,
+            NUM_PIPELINES = 2
+        };
+
+        //! Returns a mask of supported features for the given point cloud
+        int featureMask(const PointCloud& pointcloud) const override;
+
+        //! One-time initialization of the system
+        void initialize(VSGContext&) override;
+
+        void createOrUpdateNode(PointCloud&, ecs::BuildInfo&, VSGContext&) const override;
+    };
+}
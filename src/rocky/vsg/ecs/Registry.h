@@ -7,6 +7,7 @@
 #include <rocky/vsg/VSGContext.h>
 #include <rocky/vsg/ViewLocal.h>
 #include <vector>
+#include <atomic>
 #include <chrono>
 #include <type_traits>
 #include <shared_mutex>
@@ -23,6 +24,87 @@ namespace ROCKY_NAMESPACE
         //! Alias for time_point
         using time_point = std::chrono::steady_clock::time_point;
 
+        /**
+        * Wait-free single-producer/single-consumer ring buffer of packed
+        * update records, for feeding component changes into the ECS from an
+        * external data source (a telemetry link, a simulation bridge).
+        *
+        * The producer thread push()es records with no lock and no
+        * allocation; a system drains them with consume() once per frame,
+        * applying the whole batch under a single registry lock instead of
+        * locking per message. When the buffer fills (the consumer stalled
+        * or the feed burst past capacity) push() drops the record and
+        * returns false - for a telemetry stream the next sample supersedes
+        * the lost one anyway.
+        *
+        * One producer thread and one consumer thread only; serialize
+        * multiple feeds upstream.
+        */
+        template<typename RECORD>
+        class ChangeStream
+        {
+        public:
+            //! Construct with a capacity, rounded up to a power of two.
+            explicit ChangeStream(std::size_t capacity = 16384)
+            {
+                std::size_t size = 1;
+                while (size < capacity)
+                    size <<= 1;
+                _buffer.resize(size);
+                _mask = size - 1;
+            }
+
+            //! Queue one record (producer thread). Returns false if the
+            //! buffer is full and the record was dropped.
+            bool push(const RECORD& record)
+            {
+                auto head = _head.load(std::memory_order_relaxed);
+                if (head - _tail.load(std::memory_order_acquire) > _mask)
+                    return false;
+                _buffer[head & _mask] = record;
+                _head.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            //! Drain all queued records (consumer thread), invoking
+            //! apply(const RECORD&) on each. Returns the number applied.
+            template<typename APPLY>
+            std::size_t consume(APPLY&& apply)
+            {
+                auto tail = _tail.load(std::memory_order_relaxed);
+                auto head = _head.load(std::memory_order_acquire);
+                for (auto i = tail; i != head; ++i)
+                    apply(_buffer[i & _mask]);
+                _tail.store(head, std::memory_order_release);
+                return (std::size_t)(head - tail);
+            }
+
+            //! Number of records currently queued (approximate).
+            std::size_t size() const
+            {
+                return (std::size_t)(_head.load(std::memory_order_acquire) -
+                    _tail.load(std::memory_order_acquire));
+            }
+
+        private:
+            std::vector<RECORD> _buffer;
+            std::size_t _mask = 0;
+            std::atomic<std::uint64_t> _head = { 0 };
+            std::atomic<std::uint64_t> _tail = { 0 };
+        };
+
+        /**
+        * Packed position-update record for the registry's transform change
+        * stream. Coordinates are in the SRS the entity's Transform already
+        * uses, so the record stays plain data and applying it touches no
+        * SRS machinery.
+        */
+        struct TransformUpdate
+        {
+            entt::entity entity = entt::null;
+            double x = 0.0, y = 0.0, z = 0.0;
+        };
+
         /**
         * Wraps the ECS registry with a read-write lock for thread safety.
         *
@@ -66,6 +148,57 @@ namespace ROCKY_NAMESPACE
                 return { std::unique_lock(_mutex), _registry };
             }
 
+            //! Bulk-creates a batch of entities, each carrying one component from
+            //! each of the supplied arrays, under a single write lock.
+            //!
+            //! Component storage is preallocated up front so a large batch (e.g., a
+            //! startup track table) performs a handful of allocations instead of
+            //! growing each pool entity by entity. Components are range-inserted,
+            //! so construction signals (and any system hooks attached to them)
+            //! still fire for every entity, just as with emplace().
+            //!
+            //! usage:
+            //!   std::vector<Icon> icons(count);
+            //!   std::vector<Transform> transforms(count);
+            //!   ... populate the arrays ...
+            //!   auto entities = ecs_registry.create(count, icons.data(), transforms.data());
+            //!
+            //! @param count Number of entities to create
+            //! @param components One array per component type, each holding count elements
+            //! @return The newly created entities, in the same order as the arrays
+            template<typename... T>
+            std::vector<entt::entity> create(std::size_t count, const T*... components)
+            {
+                std::vector<entt::entity> entities(count);
+
+                auto [lock, registry] = write();
+
+                (registry.storage<T>().reserve(registry.storage<T>().size() + count), ...);
+
+                registry.create(entities.begin(), entities.end());
+
+                (registry.insert<T>(entities.begin(), entities.end(), components), ...);
+
+                return entities;
+            }
+
+            //! Attempts to read-lock the EnTT registry without blocking.
+            //!
+            //! Check the returned lock with owns_lock() before touching the registry;
+            //! when a writer holds the lock the caller should fall back to data it
+            //! snapshotted on a previous pass instead of waiting. This keeps the
+            //! record traversal from ever stalling behind a burst of entity updates.
+            //!
+            //! usage:
+            //!   auto [lock, registry] = ecs_registry.tryRead();
+            //!   if (lock.owns_lock()) { ... }
+            //!
+            //! @return A tuple including a scoped shared lock (possibly unowned) and
+            //!   a reference to the underlying registry
+            std::pair<std::shared_lock<std::shared_mutex>, entt::registry&> tryRead() {
+                return { std::shared_lock(_mutex, std::try_to_lock), _registry };
+            }
+
             //! Convenience function to invoke a lambda with a read-locked registry reference.
             //! The signature of CALLABLE must match void(entt::registry&).
             template<typename CALLABLE>
@@ -84,6 +217,13 @@ namespace ROCKY_NAMESPACE
                 func(registry);
             }
 
+            //! Change stream for high-rate external position feeds. A feed
+            //! thread push()es TransformUpdate records here instead of
+            //! locking the registry per message; the TransformSystem drains
+            //! the stream once per frame and applies the whole batch under
+            //! one lock. See ChangeStream for the threading contract.
+            ChangeStream<TransformUpdate> transformUpdates;
+
         private:
             std::shared_mutex _mutex;
             entt::registry _registry;
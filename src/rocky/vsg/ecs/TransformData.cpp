@@ -9,7 +9,7 @@
 using namespace ROCKY_NAMESPACE;
 
 void
-TransformViewData::update(vsg::RecordTraversal& record)
+TransformViewData::update(vsg::RecordTraversal& record, int cameraRevision)
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(transform, void());
 
@@ -18,8 +18,10 @@ TransformViewData::update(vsg::RecordTraversal& record)
 
     auto* state = record.getState();
 
+    bool transform_dirty = (revision != transform->revision);
+
     // only if something has changed since last time:
-    if (revision != transform->revision)
+    if (transform_dirty)
     {
         revision = transform->revision;
 
@@ -66,6 +68,12 @@ TransformViewData::update(vsg::RecordTraversal& record)
         //local = to_vsg(transform->localMatrix);
     }
 
+    // a stationary entity under an unchanged camera keeps last frame's matrices:
+    if (!transform_dirty && cameraRevision >= 0 && cameraRevision == camera_revision)
+        return;
+
+    camera_revision = cameraRevision;
+
     proj = state->projectionMatrixStack.top();
     auto& mvm = state->modelviewMatrixStack.top();
     ROCKY_FAST_MAT4_MULT(modelview, mvm, model);
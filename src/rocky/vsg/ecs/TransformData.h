@@ -18,6 +18,7 @@ namespace ROCKY_NAMESPACE
     {
         Transform* transform = nullptr; // pointer to the Transform component
         int revision = -1;    // revision of this data for syncing
+        int camera_revision = -1; // revision of the camera this data was computed for
         vsg::dmat4 model;     // model matrix
         vsg::dmat4 proj;      // projection matrix
         vsg::dmat4 modelview; // modelview matrix
@@ -28,7 +29,15 @@ namespace ROCKY_NAMESPACE
         SRSOperation pos_to_world;
         std::shared_ptr<Horizon> horizon;
 
-        void update(vsg::RecordTraversal&);
+        //! Cull verdict, computed by the TransformSystem's streaming cull
+        //! pass each frame. Record paths read this instead of calling
+        //! passesCull() so they never touch the Transform component.
+        bool culled = false;
+
+        //! Recompute this view's matrices. Pass the owning view's camera
+        //! revision to let a stationary entity under an unchanged camera
+        //! keep last frame's matrices; the default always recomputes.
+        void update(vsg::RecordTraversal&, int cameraRevision = -1);
 
         bool passesCull() const;
 
@@ -6,11 +6,23 @@
 #include "TransformSystem.h"
 #include "TransformData.h"
 #include <rocky/vsg/Utils.h>
+#include <rocky/Math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 using namespace ROCKY_NAMESPACE;
 
 namespace
 {
+    // cull-input flag bits in the SoA mirror
+    constexpr std::uint8_t FRUSTUM_CULLED = 1;
+    constexpr std::uint8_t HORIZON_CULLED = 2;
+
+    // cull-verdict bit, set by the cull kernel and read by pick()
+    constexpr std::uint8_t CULLED_OUT = 4;
+
     void on_construct_Transform(entt::registry& r, entt::entity e)
     {
         auto& views = r.emplace<TransformData>(e);
@@ -42,3 +54,341 @@ TransformSystem::TransformSystem(ecs::Registry& r) : ecs::System(r)
     registry.on_update<Transform>().connect<&on_update_Transform>();
     registry.on_destroy<Transform>().connect<&on_destroy_Transform>();
 }
+
+void
+TransformSystem::update(VSGContext& runtime)
+{
+    // In on-demand rendering mode, a transform edit needs a render even
+    // when the camera is still. Revisions only ever increase, so a sum
+    // over the view detects any movement, addition, or removal:
+    long long checksum = 0;
+
+    auto [lock, registry] = _registry.read();
+
+    // Drain the external position feed, applying the whole batch under
+    // this one lock. In-place component updates only need a read lock;
+    // the coordinates are in the SRS each entity's position already
+    // uses, so this is a plain store plus a revision bump.
+    _registry.transformUpdates.consume([&](const ecs::TransformUpdate& u)
+        {
+            if (!registry.valid(u.entity))
+                return;
+
+            auto* transform = registry.try_get<Transform>(u.entity);
+            if (transform)
+            {
+                transform->position.x = u.x;
+                transform->position.y = u.y;
+                transform->position.z = u.z;
+                transform->dirty();
+            }
+        });
+
+    for (auto&& [entity, transform] : registry.view<Transform>().each())
+    {
+        checksum += 1 + transform.revision;
+    }
+
+    if (checksum != _lastTransformChecksum)
+    {
+        _lastTransformChecksum = checksum;
+        runtime->requestFrame();
+    }
+}
+
+void
+TransformSystem::traverse(vsg::RecordTraversal& record) const
+{
+    auto* state = record.getState();
+    const auto viewID = state->_commandBuffer->viewID;
+
+    // bump this view's camera revision when its matrices change, so
+    // stationary entities can skip their matrix recompute entirely:
+    auto& camera = _cameras[viewID];
+    if (camera.revision < 0 ||
+        camera.proj != state->projectionMatrixStack.top() ||
+        camera.view != state->modelviewMatrixStack.top())
+    {
+        camera.proj = state->projectionMatrixStack.top();
+        camera.view = state->modelviewMatrixStack.top();
+        ++camera.revision;
+    }
+
+    // Non-blocking read; when a writer holds the lock, skip the pass and
+    // let downstream record paths reuse last frame's matrices and cull
+    // verdicts rather than stalling the record thread.
+    auto [lock, registry] = _registry.tryRead();
+    if (!lock.owns_lock())
+        return;
+
+    // collect this view's data pointers so we can iterate in chunks:
+    auto& soa = _cullData[viewID];
+
+    _scratch.clear();
+    soa.entity.clear();
+    registry.view<TransformData>().each([&](entt::entity entity, auto& transformData)
+        {
+            _scratch.emplace_back(&transformData[viewID]);
+            soa.entity.emplace_back(entity);
+        });
+
+    const std::size_t num = _scratch.size();
+
+    soa.clip.resize(num);
+    soa.center.resize(num);
+    soa.radius.resize(num);
+    soa.flags.resize(num);
+
+    // Run a range over [0..num) either inline or carved into one chunk
+    // per worker with a jobgroup join. Each entity's per-view data is
+    // independent so the chunks share nothing; the registry read-lock is
+    // held across the join.
+    auto runChunked = [](std::size_t count, auto&& fn)
+        {
+            // below this count the dispatch overhead exceeds the work:
+            constexpr std::size_t parallel_threshold = 4096;
+
+            if (count < parallel_threshold)
+            {
+                fn(std::size_t(0), count);
+                return;
+            }
+
+            auto concurrency = std::max(1u, jobs::get_pool()->concurrency());
+            std::size_t perChunk = (count + concurrency - 1) / concurrency;
+            auto group = jobs::jobgroup::create();
+
+            for (std::size_t i0 = 0; i0 < count; i0 += perChunk)
+            {
+                std::size_t i1 = std::min(i0 + perChunk, count);
+
+                jobs::dispatch([&fn, i0, i1]() { fn(i0, i1); },
+                    jobs::context{ "TransformSystem::traverse", nullptr, {}, group });
+            }
+
+            group->join();
+        };
+
+    // pass 1: update the matrices and mirror the cull inputs into the
+    // SoA while the entity's data is hot in cache:
+    runChunked(num, [&](std::size_t i0, std::size_t i1)
+        {
+            for (std::size_t i = i0; i < i1; ++i)
+            {
+                auto* data = _scratch[i];
+                data->update(record, camera.revision);
+
+                soa.clip[i] = data->mvp[3];
+                soa.center[i] = vsg::dvec3(data->model[3][0], data->model[3][1], data->model[3][2]);
+                soa.radius[i] = data->transform ? data->transform->radius : 0.0;
+                soa.flags[i] =
+                    (data->transform && data->transform->frustumCulled ? FRUSTUM_CULLED : 0) |
+                    (data->transform && data->transform->horizonCulled ? HORIZON_CULLED : 0);
+            }
+        });
+
+    // the horizon and world SRS are shared by every entity in a view:
+    std::shared_ptr<Horizon> horizon;
+    record.getValue("rocky.horizon", horizon);
+
+    SRS world_srs;
+    bool geocentric = record.getValue("rocky.worldsrs", world_srs) && world_srs.isGeocentric();
+
+    // The cull kernel for one entity. The cell hints let a settled cell
+    // skip the per-entity geometry: frustumRel is -1 (cell wholly
+    // outside), 0 (straddling; test the entity), or +1 (wholly inside),
+    // and cellHidden means the cell's whole sphere is below the horizon.
+    auto cullEntity = [&](std::size_t i, int frustumRel, bool cellHidden)
+        {
+            bool culled = false;
+
+            // Frustum cull (by center point)
+            if (soa.flags[i] & FRUSTUM_CULLED)
+            {
+                if (frustumRel < 0)
+                {
+                    culled = true;
+                }
+                else if (frustumRel == 0)
+                {
+                    auto clip = soa.clip[i] / soa.clip[i].w;
+                    const double t = 1.0;
+                    culled = (clip.x < -t || clip.x > t || clip.y < -t || clip.y > t || clip.z < -t || clip.z > t);
+                }
+            }
+
+            // horizon cull, if active (geocentric only)
+            if (!culled && (soa.flags[i] & HORIZON_CULLED) && horizon && geocentric)
+            {
+                culled = cellHidden ||
+                    !horizon->isVisible(soa.center[i].x, soa.center[i].y, soa.center[i].z, soa.radius[i]);
+            }
+
+            _scratch[i]->culled = culled;
+
+            if (culled)
+                soa.flags[i] |= CULLED_OUT;
+        };
+
+    // Below this count the per-entity pass is cheaper than maintaining
+    // the grid:
+    constexpr std::size_t grid_threshold = 4096;
+
+    if (num < grid_threshold)
+    {
+        // pass 2: the cull kernel, streaming linearly over the flat arrays:
+        runChunked(num, [&](std::size_t i0, std::size_t i1)
+            {
+                for (std::size_t i = i0; i < i1; ++i)
+                    cullEntity(i, 0, false);
+            });
+
+        return;
+    }
+
+    // Bin the entities into a coarse world-space grid so visibility
+    // resolves per cell. The grid keys on the transform checksum (see
+    // update()), so it only rebuilds when something actually moved.
+    auto& grid = _cullGrids[viewID];
+
+    if (grid.checksum != _lastTransformChecksum || grid.count != num)
+    {
+        grid.checksum = _lastTransformChecksum;
+        grid.count = num;
+
+        vsg::dbox bbox;
+        for (std::size_t i = 0; i < num; ++i)
+            bbox.add(soa.center[i]);
+
+        // aim for a few dozen entities per occupied cell:
+        auto dim = (std::uint32_t)clamp(std::cbrt((double)num / 32.0), 1.0, 64.0);
+        auto extent = bbox.max - bbox.min;
+        vsg::dvec3 scale(
+            extent.x > 0.0 ? (double)dim / extent.x : 0.0,
+            extent.y > 0.0 ? (double)dim / extent.y : 0.0,
+            extent.z > 0.0 ? (double)dim / extent.z : 0.0);
+
+        auto cellOf = [&](const vsg::dvec3& p) -> std::uint32_t
+            {
+                auto cx = (std::uint32_t)clamp((p.x - bbox.min.x) * scale.x, 0.0, (double)dim - 1.0);
+                auto cy = (std::uint32_t)clamp((p.y - bbox.min.y) * scale.y, 0.0, (double)dim - 1.0);
+                auto cz = (std::uint32_t)clamp((p.z - bbox.min.z) * scale.z, 0.0, (double)dim - 1.0);
+                return (cz * dim + cy) * dim + cx;
+            };
+
+        // group the entity indices by cell:
+        grid.order.resize(num);
+        std::iota(grid.order.begin(), grid.order.end(), 0u);
+        std::sort(grid.order.begin(), grid.order.end(),
+            [&](std::uint32_t lhs, std::uint32_t rhs)
+            {
+                return cellOf(soa.center[lhs]) < cellOf(soa.center[rhs]);
+            });
+
+        // one bounding sphere per occupied cell, covering each member
+        // center plus its object radius:
+        grid.cellStart.clear();
+        grid.cellSphere.clear();
+
+        for (std::size_t i = 0; i < num; )
+        {
+            auto cell = cellOf(soa.center[grid.order[i]]);
+
+            vsg::dbox cellbox;
+            auto begin = i;
+            for (; i < num && cellOf(soa.center[grid.order[i]]) == cell; ++i)
+                cellbox.add(soa.center[grid.order[i]]);
+
+            auto center = (cellbox.min + cellbox.max) * 0.5;
+            double radius = 0.0;
+            for (auto j = begin; j < i; ++j)
+            {
+                radius = std::max(radius,
+                    vsg::length(soa.center[grid.order[j]] - center) + soa.radius[grid.order[j]]);
+            }
+
+            grid.cellStart.push_back((std::uint32_t)begin);
+            grid.cellSphere.push_back(vsg::dvec4(center.x, center.y, center.z, radius));
+        }
+        grid.cellStart.push_back((std::uint32_t)num);
+    }
+
+    // pass 2: classify each cell against the frustum and horizon, then
+    // refine only the entities in boundary cells:
+    auto& frustum = state->_frustumStack.top();
+
+    runChunked(grid.cellSphere.size(), [&](std::size_t c0, std::size_t c1)
+        {
+            for (std::size_t c = c0; c < c1; ++c)
+            {
+                auto& sphere = grid.cellSphere[c];
+                vsg::dvec3 center(sphere.x, sphere.y, sphere.z);
+
+                int frustumRel = 1;
+                for (int f = 0; f < POLYTOPE_SIZE && frustumRel >= 0; ++f)
+                {
+                    double d = vsg::distance(frustum.face[f], center);
+                    if (d < -sphere.w)
+                        frustumRel = -1;
+                    else if (d < sphere.w)
+                        frustumRel = 0;
+                }
+
+                bool cellHidden = horizon && geocentric &&
+                    !horizon->isVisible(sphere.x, sphere.y, sphere.z, sphere.w);
+
+                for (auto i = grid.cellStart[c]; i < grid.cellStart[c + 1]; ++i)
+                    cullEntity(grid.order[i], frustumRel, cellHidden);
+            }
+        });
+}
+
+TransformSystem::PickResult
+TransformSystem::pick(std::uint32_t viewID, double ndc_x, double ndc_y, double pad) const
+{
+    PickResult result;
+
+    auto& soa = _cullData[viewID];
+    auto& camera = _cameras[viewID];
+
+    if (camera.revision < 0)
+        return result; // view has not recorded yet
+
+    const std::size_t num = std::min(soa.entity.size(), soa.clip.size());
+
+    for (std::size_t i = 0; i < num; ++i)
+    {
+        if (soa.flags[i] & CULLED_OUT)
+            continue;
+
+        auto& clip = soa.clip[i];
+        if (clip.w <= 0.0)
+            continue; // behind the eye
+
+        const double inv_w = 1.0 / clip.w;
+        const double z = clip.z * inv_w;
+        if (z < 0.0 || z > 1.0)
+            continue;
+
+        // projected extent of the bounding sphere, padded so point-sized
+        // entities stay clickable. proj[1][1] is negative under Vulkan's
+        // flipped Y, hence the abs.
+        const double rx = std::abs(soa.radius[i] * camera.proj[0][0] * inv_w) + pad;
+        const double ry = std::abs(soa.radius[i] * camera.proj[1][1] * inv_w) + pad;
+        if (rx <= 0.0 || ry <= 0.0)
+            continue;
+
+        const double dx = (ndc_x - clip.x * inv_w) / rx;
+        const double dy = (ndc_y - clip.y * inv_w) / ry;
+        if (dx * dx + dy * dy > 1.0)
+            continue;
+
+        if (z < result.depth)
+        {
+            result.depth = z;
+            result.entity = soa.entity[i];
+        }
+    }
+
+    return result;
+}
@@ -8,6 +8,9 @@
 #include <rocky/vsg/Common.h>
 #include <rocky/vsg/ecs/Registry.h>
 #include <rocky/vsg/ecs/TransformData.h>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 namespace ROCKY_NAMESPACE
 {
@@ -20,15 +23,80 @@ namespace ROCKY_NAMESPACE
         TransformSystem(ecs::Registry& r);
 
         //! Called periodically to update the transforms
-        void traverse(vsg::RecordTraversal& record) const override
+        void traverse(vsg::RecordTraversal& record) const override;
+
+        //! Called once per frame; requests a render when any transform
+        //! changed since the last update (for on-demand rendering)
+        void update(VSGContext& runtime) override;
+
+        //! Result of a screen-space pick (see pick())
+        struct PickResult
+        {
+            entt::entity entity = entt::null;
+
+            //! normalized depth of the picked entity's center
+            double depth = std::numeric_limits<double>::max();
+
+            bool valid() const { return entity != entt::null; }
+        };
+
+        //! Picks the frontmost visible entity whose projected bounding
+        //! sphere covers the given point, in normalized device
+        //! coordinates [-1..1]. This scans the flat cull mirror the
+        //! record pass already maintains - no scene graph traversal - so
+        //! it stays cheap enough to run per mouse-move for hover
+        //! highlighting at any entity count.
+        //!
+        //! "pad" expands every projected sphere by that NDC margin, so
+        //! point-sized entities (icons, labels) stay clickable; pass
+        //! e.g. 2.0 * pixels / viewportHeight.
+        //!
+        //! Call between frames (e.g. from the update phase); the mirror
+        //! holds the verdicts of the most recent record pass for the view.
+        PickResult pick(std::uint32_t viewID, double ndc_x, double ndc_y, double pad = 0.0) const;
+
+    private:
+        //! Per-view camera state, for skipping stationary entities when
+        //! the camera hasn't moved either
+        struct CameraState
         {
-            auto [lock, registry] = _registry.read();
-
-            registry.view<TransformData>().each([&](auto& transformData)
-                {
-                    auto& view = transformData[record.getState()->_commandBuffer->viewID];
-                    view.update(record);
-                });
-        }
+            vsg::dmat4 proj;
+            vsg::dmat4 view;
+            int revision = -1;
+        };
+        mutable detail::ViewLocal<CameraState> _cameras;
+
+        //! Packed SoA mirror of the per-view cull inputs, so the cull pass
+        //! streams memory linearly instead of chasing component storage
+        struct CullSoA
+        {
+            std::vector<entt::entity> entity;
+            std::vector<vsg::dvec4> clip;   // clip-space position (mvp[3])
+            std::vector<vsg::dvec3> center; // world position (model[3])
+            std::vector<double> radius;
+            std::vector<std::uint8_t> flags;
+        };
+        mutable detail::ViewLocal<CullSoA> _cullData;
+
+        //! Coarse world-space grid over the entity centers. The cull pass
+        //! resolves visibility per cell - a cell wholly outside the frustum
+        //! or below the horizon settles every member at once - and only
+        //! cells straddling a boundary refine per entity.
+        struct CullGrid
+        {
+            long long checksum = -1;  // transform checksum the grid was built for
+            std::size_t count = 0;    // entity count the grid was built for
+            std::vector<std::uint32_t> order;     // entity indices, grouped by cell
+            std::vector<std::uint32_t> cellStart; // offset of each cell's run in 'order' (+ end sentinel)
+            std::vector<vsg::dvec4> cellSphere;   // per-cell bounding sphere (xyz = center, w = radius)
+        };
+        mutable detail::ViewLocal<CullGrid> _cullGrids;
+
+        //! scratch list for chunked parallel iteration
+        mutable std::vector<TransformViewData*> _scratch;
+
+        //! aggregate of all transform revisions from the last update pass,
+        //! for detecting movement in on-demand rendering mode
+        long long _lastTransformChecksum = -1;
     };
 }
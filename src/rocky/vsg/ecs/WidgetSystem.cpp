@@ -23,6 +23,7 @@ namespace
     {
         const std::string uid = std::to_string((std::uintptr_t)this);
         detail::ViewLocal<ImVec2> screen;
+        detail::ViewLocal<bool> onScreen = { }; // virtualization verdict, computed in update()
         ImVec2 windowSize = { 0, 0 };
     };
 
@@ -66,7 +67,7 @@ WidgetSystemNode::initialize(VSGContext& context)
             auto view = registry.view<Widget, WidgetRenderable, TransformData, Visibility>();
             for (auto&& [entity, widget, renderable, xdata, visibility] : view.each())
             {
-                if (ecs::visible(visibility, viewID) && xdata[viewID].passesCull())
+                if (ecs::visible(visibility, viewID) && !xdata[viewID].culled && renderable.onScreen[viewID])
                 {
                     WidgetInstance i{
                         widget,
@@ -112,15 +113,41 @@ WidgetSystemNode::update(VSGContext& context)
 {
     auto [lock, registry] = _registry.read();
 
-    // calculate the screen position of the widget in each view
+    const double max_range_squared = maxRange > 0.0 ? maxRange * maxRange : 0.0;
+
+    // calculate the screen position of the widget in each view, along with
+    // the virtualization verdict the render callback uses to skip ImGui
+    // work for widgets that cannot appear on screen.
     registry.view<WidgetRenderable, TransformData>().each([&](auto& renderable, auto& xdata)
         {
             for(auto& viewID : context->activeViewIDs)
             {
                 auto& view = xdata[viewID];
                 auto clip = view.mvp[3] / view.mvp[3][3];
-                renderable.screen[viewID].x = (clip.x + 1.0) * 0.5 * (double)view.viewport[2];
-                renderable.screen[viewID].y = (clip.y + 1.0) * 0.5 * (double)view.viewport[3];
+                auto& screen = renderable.screen[viewID];
+                screen.x = (clip.x + 1.0) * 0.5 * (double)view.viewport[2];
+                screen.y = (clip.y + 1.0) * 0.5 * (double)view.viewport[3];
+
+                // behind the camera?
+                bool onScreen = view.mvp[3][3] > 0.0;
+
+                // outside the viewport (plus a margin for the window extent)?
+                if (onScreen)
+                {
+                    onScreen =
+                        screen.x >= -screenMargin && screen.x <= (float)view.viewport[2] + screenMargin &&
+                        screen.y >= -screenMargin && screen.y <= (float)view.viewport[3] + screenMargin;
+                }
+
+                // beyond the maximum range?
+                if (onScreen && max_range_squared > 0.0)
+                {
+                    auto& eye = view.modelview[3];
+                    double d2 = eye[0] * eye[0] + eye[1] * eye[1] + eye[2] * eye[2];
+                    onScreen = d2 <= max_range_squared;
+                }
+
+                renderable.onScreen[viewID] = onScreen;
             }
         });
 }
@@ -21,6 +21,14 @@ namespace ROCKY_NAMESPACE
         //! Construct the mesh renderer
         WidgetSystemNode(ecs::Registry& registry);
 
+        //! Screen-space margin (pixels) past the viewport edge within which
+        //! a widget still renders, to cover windows anchored near the edge
+        float screenMargin = 96.0f;
+
+        //! Maximum eye distance (meters) at which to render widgets;
+        //! zero or less means unlimited
+        double maxRange = 0.0;
+
         //! One time setup of the system
         void initialize(VSGContext& context) override;
 
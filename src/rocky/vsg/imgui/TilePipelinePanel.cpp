@@ -0,0 +1,69 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "TilePipelinePanel.h"
+#include <rocky/PipelineMetrics.h>
+
+#include <cstdio>
+
+using namespace ROCKY_NAMESPACE;
+
+void
+TilePipelinePanel::render(ImGuiContext* imguiContext) const
+{
+    if (!visible)
+        return;
+
+    ImGui::SetCurrentContext(imguiContext);
+
+    if (ImGui::Begin("Tile Pipeline"))
+    {
+        using PM = util::PipelineMetrics;
+
+        for (unsigned s = 0; s < PM::NUM_STAGES; ++s)
+        {
+            auto stage = (PM::Stage)s;
+            auto histogram = PM::histogram(stage);
+            auto total = PM::count(stage);
+
+            float values[PM::NUM_BUCKETS];
+            float peak = 1.0f;
+            for (unsigned b = 0; b < PM::NUM_BUCKETS; ++b)
+            {
+                values[b] = (float)histogram[b];
+                peak = std::max(peak, values[b]);
+            }
+
+            // approximate median from the log-scale buckets; bucket N
+            // covers [0.1ms * 2^N, 0.1ms * 2^(N+1))
+            double p50 = 0.0;
+            std::uint64_t running = 0;
+            for (unsigned b = 0; b < PM::NUM_BUCKETS; ++b)
+            {
+                running += histogram[b];
+                if (running * 2 >= total && total > 0)
+                {
+                    p50 = b == 0 ? 0.05 : 0.1 * (double)(1u << (b - 1)) * 1.5;
+                    break;
+                }
+            }
+
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "%llu samples, ~%.1f ms p50",
+                (unsigned long long)total, p50);
+
+            ImGui::PlotHistogram(PM::name(stage), values, PM::NUM_BUCKETS, 0,
+                overlay, 0.0f, peak, ImVec2(0, 48));
+        }
+
+        ImGui::TextDisabled("log scale: bucket N covers 0.1ms x 2^N");
+
+        if (ImGui::Button("Reset"))
+        {
+            PM::reset();
+        }
+    }
+    ImGui::End();
+}
@@ -0,0 +1,30 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/imgui/ImGuiIntegration.h>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+    * Built-in diagnostics panel charting the tile pipeline's per-stage
+    * latency histograms (queue wait, fetch, decode, composite, compile,
+    * merge) as fed by the pager and I/O layers - a quick read on whether
+    * a slow site is network-bound or CPU-bound, no profiler required.
+    *
+    * Add it to an ImGuiContextGroup like any other ImGuiNode:
+    *
+    *   contextGroup->add(TilePipelinePanel::create(), app);
+    */
+    class ROCKY_EXPORT TilePipelinePanel : public vsg::Inherit<ImGuiNode, TilePipelinePanel>
+    {
+    public:
+        //! Whether the panel draws
+        bool visible = true;
+
+        void render(ImGuiContext*) const override;
+    };
+}
@@ -26,24 +26,22 @@ layout(set = 1, binding = 0) uniform VSG_Lights {
     vec4 pack[64];
 } vsg_lights;
 
+// precomputed in-scattering table, generated by SkyNode.cpp;
+// indexed by (cos view angle, cos sun angle, normalized camera height)
+layout(set = 0, binding = 0) uniform sampler3D atmos_lut;
+
 // Earth constants
 const float polarRadius = 6356752.0;
 const float atmosThickness = 50000.0; // 96560.0;
 const float atmos_fInnerRadius = polarRadius;
 const float atmos_fOuterRadius = polarRadius + atmosThickness;
 
-const float PI = 3.1415927;
 const float Kr = 0.0025;
 const float Km = 0.0015;
 const float ESun = 15.0;
-const float RaleighScaleDepth = 0.25;
 const float atmos_fKrESun = Kr * ESun;
 const float atmos_fKmESun = Km * ESun;
-const float atmos_fKr4PI = Kr * 4 * PI;
-const float atmos_fKm4PI = Km * 4 * PI;
 const vec3 atmos_v3InvWavelength = vec3(5.6020447, 9.4732844, 19.6438026);
-#define N_SAMPLES 2
-#define F_SAMPLES 2.0
 
 // stage locals
 vec3 vertex_view;
@@ -53,103 +51,46 @@ float atmos_fCameraHeight;
 float atmos_fCameraHeight2;
 float atmos_fOuterRadius2;
 float atmos_fScale;
-float atmos_fScaleOverScaleDepth;
-
-float atmos_scale(float fCos)
-{
-    float x = 1.0 - fCos;
-    return RaleighScaleDepth * exp(-0.00287 + x * (0.459 + x * (3.83 + x * (-6.80 + x * 5.25))));
-}
 
-void atmos_SkyFromSpace(void)
+// Looks up the precomputed in-scattering integral for the ray from the
+// camera to the vertex. A camera in space first advances to its entry
+// point into the atmosphere, which reduces it to the in-atmosphere case.
+void atmos_SkyFromLUT(void)
 {
-    // Get the ray from the camera to the vertex and its length (which is the far point of the ray passing through the atmosphere) 
+    // Get the ray from the camera to the vertex, and its length (which is
+    // the far point of the ray passing through the atmosphere)
     vec3 v3Pos = (vertex_view + view_to_ecef);
     vec3 v3Ray = v3Pos - atmos_vVec;
     float fFar = length(v3Ray);
     v3Ray /= fFar;
-    // Calculate the closest intersection of the ray with the outer atmosphere 
-    // (which is the near point of the ray passing through the atmosphere) 
-    float B = 2.0 * dot(atmos_vVec, v3Ray);
-    float C = atmos_fCameraHeight2 - atmos_fOuterRadius2;
-    float fDet = max(0.0, B * B - 4.0 * C);
-    float fNear = 0.5 * (-B - sqrt(fDet));
-
-
-    // Calculate the ray's starting position, then calculate its scattering offset 
-    vec3 v3Start = atmos_vVec + v3Ray * fNear;
-    fFar -= fNear;
-    float fStartAngle = dot(v3Ray, v3Start) / atmos_fOuterRadius;
-    float fStartDepth = exp(-1.0 / RaleighScaleDepth);
-    float fStartOffset = fStartDepth * atmos_scale(fStartAngle);
-
-    // Initialize the atmos_ing loop variables 	
-    float fSampleLength = fFar / F_SAMPLES;
-    float fScaledLength = fSampleLength * atmos_fScale;
-    vec3 v3SampleRay = v3Ray * fSampleLength;
-    vec3 v3SamplePoint = v3Start + v3SampleRay * 0.5;
-
-    // Now loop through the sample rays 
-    vec3 v3FrontColor = vec3(0.0, 0.0, 0.0);
-    vec3 v3Attenuate;
-    for (int i = 0; i < N_SAMPLES; i++)
+
+    vec3 v3Start = atmos_vVec;
+    float fHeight = atmos_fCameraHeight;
+
+    if (atmos_fCameraHeight >= atmos_fOuterRadius)
     {
-        float fHeight = length(v3SamplePoint);
-        float fDepth = exp(atmos_fScaleOverScaleDepth * (atmos_fInnerRadius - fHeight));
-        float fLightAngle = dot(atmos_lightDir, v3SamplePoint) / fHeight;
-        float fCameraAngle = dot(v3Ray, v3SamplePoint) / fHeight;
-        float fscatter = (fStartOffset + fDepth * (atmos_scale(fLightAngle) - atmos_scale(fCameraAngle)));
-        v3Attenuate = exp(-fscatter * (atmos_v3InvWavelength * atmos_fKr4PI + atmos_fKm4PI));
-        v3FrontColor += v3Attenuate * (fDepth * fScaledLength);
-        v3SamplePoint += v3SampleRay;
+        // Calculate the closest intersection of the ray with the outer atmosphere
+        // (which is the near point of the ray passing through the atmosphere)
+        float B = 2.0 * dot(atmos_vVec, v3Ray);
+        float C = atmos_fCameraHeight2 - atmos_fOuterRadius2;
+        float fDet = max(0.0, B * B - 4.0 * C);
+        float fNear = 0.5 * (-B - sqrt(fDet));
+        v3Start = atmos_vVec + v3Ray * fNear;
+        fHeight = atmos_fOuterRadius;
     }
 
-    // Finally, scale the Mie and Rayleigh colors and set up the varying 			
-    // variables for the pixel shader 	
-    atmos_mieColor = v3FrontColor * atmos_fKmESun;
-    atmos_rayleighColor = v3FrontColor * (atmos_v3InvWavelength * atmos_fKrESun);
-    atmos_v3Direction = atmos_vVec - v3Pos;
-}
+    float fCosView = dot(v3Ray, v3Start) / fHeight;
+    float fCosSun = dot(atmos_lightDir, v3Start) / fHeight;
 
-void atmos_SkyFromAtmosphere(void)
-{
-    // Get the ray from the camera to the vertex, and its length (which is the far 
-    // point of the ray passing through the atmosphere) 
-    vec3 v3Pos = (vertex_view + view_to_ecef.xyz);
-    vec3 v3Ray = v3Pos - atmos_vVec;
-    float fFar = length(v3Ray);
-    v3Ray /= fFar;
+    vec3 uvw = vec3(
+        fCosView * 0.5 + 0.5,
+        fCosSun * 0.5 + 0.5,
+        (fHeight - atmos_fInnerRadius) * atmos_fScale);
 
-    // Calculate the ray's starting position, then calculate its atmos_ing offset 
-    vec3 v3Start = atmos_vVec;
-    float fHeight = length(v3Start);
-    float fDepth = exp(atmos_fScaleOverScaleDepth * (atmos_fInnerRadius - atmos_fCameraHeight));
-    float fStartAngle = dot(v3Ray, v3Start) / fHeight;
-    float fStartOffset = fDepth * atmos_scale(fStartAngle);
-
-    // Initialize the atmos_ing loop variables 		
-    float fSampleLength = fFar / F_SAMPLES;
-    float fScaledLength = fSampleLength * atmos_fScale;
-    vec3 v3SampleRay = v3Ray * fSampleLength;
-    vec3 v3SamplePoint = v3Start + v3SampleRay * 0.5;
-
-    // Now loop through the sample rays 		
-    vec3 v3FrontColor = vec3(0.0, 0.0, 0.0);
-    vec3 v3Attenuate;
-    for (int i = 0; i < N_SAMPLES; i++)
-    {
-        float fHeight = length(v3SamplePoint);
-        float fDepth = exp(atmos_fScaleOverScaleDepth * (atmos_fInnerRadius - fHeight));
-        float fLightAngle = dot(atmos_lightDir, v3SamplePoint) / fHeight;
-        float fCameraAngle = dot(v3Ray, v3SamplePoint) / fHeight;
-        float fscatter = (fStartOffset + fDepth * (atmos_scale(fLightAngle) - atmos_scale(fCameraAngle)));
-        v3Attenuate = exp(-fscatter * (atmos_v3InvWavelength * atmos_fKr4PI + atmos_fKm4PI));
-        v3FrontColor += v3Attenuate * (fDepth * fScaledLength);
-        v3SamplePoint += v3SampleRay;
-    }
+    vec3 v3FrontColor = texture(atmos_lut, clamp(uvw, 0.0, 1.0)).rgb;
 
-    // Finally, scale the Mie and Rayleigh colors and set up the varying 
-    // variables for the pixel shader 					
+    // Finally, scale the Mie and Rayleigh colors and set up the varying
+    // variables for the pixel shader
     atmos_mieColor = v3FrontColor * atmos_fKmESun;
     atmos_rayleighColor = v3FrontColor * (atmos_v3InvWavelength * atmos_fKrESun);
     atmos_v3Direction = atmos_vVec - v3Pos;
@@ -159,7 +100,7 @@ void atmos_vertex_main(in vec3 in_vertex)
 {
     vertex_view = (pc.modelview * vec4(in_vertex, 1.0)).xyz;
 
-    // Get camera position and height 
+    // Get camera position and height
     view_to_ecef = -(pc.modelview * vec4(0, 0, 0, 1)).xyz;
 
     atmos_fCameraHeight = length(view_to_ecef);
@@ -177,16 +118,8 @@ void atmos_vertex_main(in vec3 in_vertex)
 
     atmos_fOuterRadius2 = atmos_fOuterRadius * atmos_fOuterRadius;
     atmos_fScale = 1.0 / (atmos_fOuterRadius - atmos_fInnerRadius);
-    atmos_fScaleOverScaleDepth = atmos_fScale / RaleighScaleDepth;
 
-    if (atmos_fCameraHeight >= atmos_fOuterRadius)
-    {
-        atmos_SkyFromSpace();
-    }
-    else
-    {
-        atmos_SkyFromAtmosphere();
-    }
+    atmos_SkyFromLUT();
 
     // Transition from space to atmosphere
     atmos_renderFromSpace = 1.0 - clamp(
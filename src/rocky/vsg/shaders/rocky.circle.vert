@@ -0,0 +1,167 @@
+#version 450
+
+// vsg push constants
+layout(push_constant) uniform PushConstants {
+    mat4 projection;
+    mat4 modelview;
+} pc;
+
+// see rocky::LineStyle
+layout(set = 0, binding = 1) uniform LineData {
+    vec4 color;
+    float width;
+    int stipple_pattern;
+    int stipple_factor;
+    float resolution;
+    float depth_offset;
+} line;
+
+// parametric circle data (see rocky::CircleSystemNode)
+layout(set = 0, binding = 2) uniform CircleData {
+    vec4 up;            // unit vector from the geocenter through the circle center
+    vec4 east;          // world-space unit east vector at the center
+    vec4 north;         // world-space unit north vector at the center
+    float world_radius; // distance from the geocenter to the circle center
+    float radius;       // geodesic radius of the circle, meters
+    int segments;       // number of line segments in the sweep
+} circle;
+
+// vsg viewport data
+layout(set = 1, binding = 1) readonly buffer VSG_Viewports {
+    vec4 viewport[1]; // x, y, width, height
+} vsg_viewports;
+
+// inter-stage interface block
+struct Varyings {
+    vec4 color;
+    vec2 stipple_dir;
+    int stipple_pattern;
+    int stipple_factor;
+};
+layout(location = 0) out float lateral;
+layout(location = 1) flat out Varyings rk;
+
+// GL built-ins
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+// Evaluates the geodesic circle at parameter t (radians), relative to the
+// circle's center (which is the model origin, for precision), by rotating
+// the center direction by the arc angle on the local sphere.
+vec3 evaluate(float t)
+{
+    vec3 u = circle.up.xyz;
+    vec3 d = circle.east.xyz * cos(t) + circle.north.xyz * sin(t);
+    d = normalize(d - u * dot(d, u));
+    float arc = circle.radius / circle.world_radius;
+    return circle.world_radius * (u * cos(arc) + d * sin(arc)) - circle.world_radius * u;
+}
+
+void main()
+{
+    rk.color = line.color.a > 0.0 ? line.color : vec4(1.0);
+    rk.stipple_pattern = line.stipple_pattern;
+    rk.stipple_factor = line.stipple_factor;
+
+    float thickness = max(0.5, floor(line.width));
+    float len = thickness;
+
+    // There are no vertex attributes at all; the segment, quad corner,
+    // and lateral side all derive from the vertex index. Each segment is
+    // two triangles over the corners (start/end) x (right/left).
+    int segment = gl_VertexIndex / 6;
+    int k = gl_VertexIndex % 6;
+    int corner = k == 0 ? 0 : (k == 1 || k == 4) ? 2 : (k == 2 || k == 3) ? 1 : 3;
+    bool is_start = corner <= 1;
+    lateral = (corner & 1) == 0 ? -1.0 : 1.0;
+
+    const float TWO_PI = 6.28318530718;
+    float dt = TWO_PI / float(circle.segments);
+    float t = dt * float(is_start ? segment : segment + 1);
+
+    vec3 curr = evaluate(t);
+    vec3 prev = evaluate(t - dt);
+    vec3 next = evaluate(t + dt);
+
+    vec2 viewport_size = vsg_viewports.viewport[0].zw;
+
+    float bias = line.depth_offset;
+
+    vec4 curr_view = pc.modelview * vec4(curr, 1);
+    curr_view.xyz -= normalize(curr_view.xyz) * bias;
+    vec4 curr_clip = pc.projection * curr_view;
+
+    vec4 prev_view = pc.modelview * vec4(prev, 1);
+    prev_view.xyz -= normalize(prev_view.xyz) * bias;
+    vec4 prev_clip = pc.projection * prev_view;
+
+    vec4 next_view = pc.modelview * vec4(next, 1);
+    next_view.xyz -= normalize(next_view.xyz) * bias;
+    vec4 next_clip = pc.projection * next_view;
+
+    vec2 curr_pixel = (curr_clip.xy / curr_clip.w) * viewport_size;
+    vec2 prev_pixel = (prev_clip.xy / prev_clip.w) * viewport_size;
+    vec2 next_pixel = (next_clip.xy / next_clip.w) * viewport_size;
+
+    // a closed loop has no endpoints, so every vertex is mitered:
+    vec2 dir_in = normalize(curr_pixel - prev_pixel);
+    vec2 dir_out = normalize(next_pixel - curr_pixel);
+    vec2 dir;
+
+    if (dot(dir_in, dir_out) < -0.999999)
+    {
+        dir = is_start ? dir_out : dir_in;
+    }
+    else
+    {
+        vec2 tangent = normalize(dir_in + dir_out);
+        vec2 perp = vec2(-dir_in.y, dir_in.x);
+        vec2 miter = vec2(-tangent.y, tangent.x);
+        dir = tangent;
+        len = thickness / dot(miter, perp);
+
+        // limit the length of a mitered corner, to prevent unsightly spikes
+        const float limit = 2.0;
+        if (len > thickness * limit)
+        {
+            len = thickness;
+            dir = is_start ? dir_out : dir_in;
+        }
+    }
+    rk.stipple_dir = dir_out;
+
+    // calculate the extrusion vector in pixels
+    // note: seems like it should be len/2, BUT remember we are in [-w..w] space
+    vec2 extrude_pixel = vec2(-dir.y, dir.x) * len;
+
+    // and convert to unit space:
+    vec2 extrude_unit = extrude_pixel / viewport_size;
+
+    // calculate the offset in clip space and apply it.
+    vec2 offset = extrude_unit * lateral;
+    curr_clip.xy += (offset * curr_clip.w);
+
+    if (line.stipple_pattern != 0xffff)
+    {
+        const float quantize = 8.0;
+
+        // Calculate the (quantized) rotation angle that will project the
+        // fragment coord onto the X-axis for stipple pattern sampling.
+
+        const float r2d = 57.29577951;
+        const float d2r = 1.0 / r2d;
+        int a = int(r2d * (atan(rk.stipple_dir.y, rk.stipple_dir.x)) + 180.0);
+        int q = int(360.0 / quantize);
+        int r = a % q;
+        int qa = (r > q / 2) ? a + q - r : a - r;
+        float qangle = d2r * (float(qa) - 180.0);
+        rk.stipple_dir = vec2(cos(qangle), sin(qangle));
+    }
+
+    // apply a static clip-space offset for z-flight mitigation.
+    const float clip_offset = 1e-7;
+    curr_clip.z += clip_offset * curr_clip.w;
+
+    gl_Position = curr_clip;
+}
@@ -0,0 +1,29 @@
+#pragma import_defines(ROCKY_LOG_DEPTH)
+
+// Depth mapping for the huge eye-to-surface ranges a globe traverses.
+//
+// By default VSG renders with reverse-Z (near = 1, far = 0, compare =
+// GREATER) into a floating-point depth buffer, which already spends its
+// precision near the far plane where reverse-Z needs it; that is the
+// preferred single-pass path and needs no shader support. Define
+// ROCKY_LOG_DEPTH (see VSGContext::setLogDepthEnabled) to remap clip
+// depth logarithmically instead, as a fallback for targets without a
+// floating-point depth attachment.
+//
+// The far plane falls out of the projection matrix itself (for VSG's
+// reverse-Z perspective, clip.z = A*z + B with far = B/A), so no extra
+// uniforms are needed. Orthographic projections pass through untouched.
+vec4 apply_log_depth(in mat4 projection, in vec4 clip)
+{
+#if defined(ROCKY_LOG_DEPTH)
+    if (projection[2][3] != 0.0) // perspective only
+    {
+        float far = projection[3][2] / projection[2][2];
+
+        // keep the reverse-Z orientation: near = 1, far = 0.
+        float depth = 1.0 - log2(max(1e-6, 1.0 + clip.w)) / log2(1.0 + far);
+        clip.z = depth * clip.w;
+    }
+#endif
+    return clip;
+}
@@ -1,15 +1,21 @@
 #version 450
 
-// uniforms
-layout(set = 0, binding = 2) uniform sampler2D icon_texture;
+// shared texture atlas (see rocky::TextureAtlas)
+layout(set = 0, binding = 2) uniform sampler2DArray icon_texture;
 
 // inputs
 layout(location = 0) in vec2 uv;
+layout(location = 1) flat in float layer;
 
 // outputs
 layout(location = 0) out vec4 out_color;
 
 void main()
 {
-    out_color = texture(icon_texture, uv);
+    const vec4 error_color = vec4(1, 0, 0, 1);
+
+    if (layer < 0.0)
+        out_color = error_color;
+    else
+        out_color = texture(icon_texture, vec3(uv, layer));
 }
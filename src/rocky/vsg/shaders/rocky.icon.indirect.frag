@@ -1,12 +1,11 @@
 #version 460
 
-// Texture arena (fixed size)
-//layout(set = 0, binding = 3) uniform sampler samp;
-layout(set = 0, binding = 4) uniform sampler2D textures[1];
+// shared texture atlas (see rocky::TextureAtlas)
+layout(set = 0, binding = 4) uniform sampler2DArray atlas;
 
 // input varyings
 layout(location = 0) in vec2 uv;
-layout(location = 1) flat in int texture_index;
+layout(location = 1) flat in float layer;
 
 // outputs
 layout(location = 0) out vec4 out_color;
@@ -15,13 +14,13 @@ void main()
 {
     const vec4 error_color = vec4(1,0,0,1);
 
-    if (texture_index < 0)
+    if (layer < 0.0)
     {
         out_color = error_color;
     }
     else
     {
-        out_color = texture(textures[texture_index], uv);
+        out_color = texture(atlas, vec3(uv, layer));
     }
 
     if (out_color.a < 0.15)
@@ -7,6 +7,8 @@ layout(push_constant) uniform PushConstants
     mat4 modelview;
 } pc;
 
+#include "rocky.material.glsl"
+
 struct Instance
 {
     mat4 proj;
@@ -14,8 +16,10 @@ struct Instance
     vec4 viewport;          // viewport x,y,w,h
     float rotation;         // rotation, radians
     float size;             // size in pixels; 0 = not visible
-    int texture_index;      // ID of icon texture, -1 = error
-    float padding[1];       // pad to 16 bytes
+    uint material;          // index into the shared material table
+    float rotation_rate;    // radians/second, applied against the frame clock
+    float alignment;        // 0 = screen-aligned, 1 = world-oriented
+    float padding[3];       // pad to 16 bytes
 };
 
 // draw buffer, output from the culling shader
@@ -24,6 +28,13 @@ layout(set = 0, binding = 2) buffer DrawBuffer
     Instance drawList[];
 };
 
+// frame clock, seconds since system start; rotation rates and billboard
+// modes evaluate against this so animating icons never touch the CPU
+layout(set = 0, binding = 6) uniform Clock
+{
+    vec4 clock; // x = elapsed seconds
+};
+
 // vsg viewport data
 layout(set = 1, binding = 1) readonly buffer VSG_Viewports
 {
@@ -35,7 +46,7 @@ layout(location = 0) in vec3 in_vertex;
 
 // output varyings
 layout(location = 0) out vec2 uv;
-layout(location = 1) flat out int texture_index;
+layout(location = 1) flat out float layer;
 
 // GL built-ins
 out gl_PerVertex
@@ -46,7 +57,7 @@ out gl_PerVertex
 void main()
 {    
     int i = gl_InstanceIndex;
-    texture_index = -1;
+    layer = -1.0;
 
     vec4 clip = drawList[i].proj * drawList[i].modelview * vec4(0,0,0,1);
 
@@ -58,17 +69,34 @@ void main()
         gl_VertexIndex == 0 || gl_VertexIndex == 1 ? -1 : 1);
         
     float size = abs(drawList[i].size);
-    float sr = sin(drawList[i].rotation);
-    float cr = cos(drawList[i].rotation);
+
+    // continuous spin, evaluated against the frame clock:
+    float angle = drawList[i].rotation + drawList[i].rotation_rate * clock.x;
+
+    // world-oriented mode anchors the rotation to the world +X axis as
+    // projected on screen, so the icon turns with the view heading:
+    if (drawList[i].alignment != 0.0)
+    {
+        vec4 ref = drawList[i].proj * drawList[i].modelview * vec4(1, 0, 0, 1);
+        vec2 dir = (ref.xy / ref.w - clip.xy / clip.w) * viewport_size;
+        if (dot(dir, dir) > 0.0)
+            angle += atan(dir.y, dir.x);
+    }
+
+    float sr = sin(angle);
+    float cr = cos(angle);
     vec2 offset = mat2(cr, sr, -sr, cr) * (size * signs * 0.5);
 
     clip.xy += offset * pixel_size * clip.w;
 
-    uv = vec2(signs.x + 1.0, -signs.y + 1.0) * 0.5;
+    // remap the corner UV into the icon's atlas sub-rectangle:
+    Material material = materials[drawList[i].material];
+    vec2 base_uv = vec2(signs.x + 1.0, -signs.y + 1.0) * 0.5;
+    uv = material.uvrect.xy + base_uv * material.uvrect.zw;
 
     if (drawList[i].size > 0.0)
     {
-        texture_index = drawList[i].texture_index;
+        layer = material.layer;
     }
 
     gl_Position = clip;
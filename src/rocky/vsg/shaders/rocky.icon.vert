@@ -6,11 +6,15 @@ layout(push_constant) uniform PushConstants {
     mat4 modelview;
 } pc;
 
-// rocky::IconStyle
+// rocky::IconStyle, plus the image's placement in the texture atlas
 layout(set = 0, binding = 1) uniform IconStyle {
     float size;
     float rotation;
-    float padding[2];
+    float rotation_rate; // unused here; the indirect renderer animates this
+    float alignment;     // unused here
+
+    vec4 uvrect;    // x,y = UV offset; z,w = UV scale
+    float layer;    // atlas layer; -1 = no image
 } icon;
 
 // vsg viewport data
@@ -23,6 +27,7 @@ layout(location = 0) in vec3 in_vertex;
 
 // output varyings
 layout(location = 0) out vec2 uv;
+layout(location = 1) flat out float layer;
 
 // GL built-ins
 out gl_PerVertex {
@@ -47,7 +52,10 @@ void main()
 
     clip.xy += (offset * pixel_size * clip.w);
 
-    uv = vec2(signs.x + 1.0, -signs.y + 1.0) * 0.5;
+    // remap the corner UV into the icon's atlas sub-rectangle:
+    vec2 base_uv = vec2(signs.x + 1.0, -signs.y + 1.0) * 0.5;
+    uv = icon.uvrect.xy + base_uv * icon.uvrect.zw;
+    layer = icon.layer;
 
     gl_Position = clip;
 }
@@ -0,0 +1,36 @@
+#version 450
+
+// font glyph atlas (a signed-distance field)
+layout(set = 0, binding = 0) uniform sampler2D textureAtlas;
+
+// input varyings
+layout(location = 0) in vec2 uv;
+layout(location = 1) in vec4 fill_color;
+layout(location = 2) in vec4 outline; // rgb = outline color, a = halo width in SDF units (0 = none)
+
+// outputs
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+    float distance = texture(textureAtlas, uv).r;
+
+    // antialiasing width from the distance field's screen-space gradient;
+    // this is what keeps one atlas crisp at every label scale:
+    float aa = fwidth(distance);
+
+    const float edge = 0.5;
+    float fill = smoothstep(edge - aa, edge + aa, distance);
+
+    out_color = fill_color;
+    out_color.a *= fill;
+
+    if (outline.a > 0.0)
+    {
+        float halo = smoothstep(edge - outline.a - aa, edge - outline.a + aa, distance);
+        out_color = mix(vec4(outline.rgb, fill_color.a * halo), out_color, fill);
+    }
+
+    if (out_color.a < 0.01)
+        discard;
+}
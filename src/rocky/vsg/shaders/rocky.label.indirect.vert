@@ -0,0 +1,82 @@
+#version 460
+
+#include "rocky.material.glsl"
+
+struct Instance
+{
+    mat4 proj;
+    mat4 modelview;
+    vec4 viewport;          // viewport x,y,w,h
+    vec2 pixel_offset;
+    float scale;            // pixels per em
+    uint material;          // index into the shared material table
+    uint first_glyph;       // offset into the glyph buffer
+    uint num_glyphs;        // 0 = blank/padding entry
+    float padding[2];       // pad to 16 bytes
+};
+
+struct Glyph
+{
+    vec4 rect;              // x,y = lower-left corner, z,w = size (ems)
+    vec4 uvrect;            // atlas texture coords; x,y = min, z,w = max
+};
+
+layout(set = 0, binding = 1) readonly buffer CullList
+{
+    Instance instances[];
+};
+
+// draw buffer, output from the culling shader:
+// x = instance (cull list) index, y = glyph buffer index
+layout(set = 0, binding = 2) readonly buffer DrawList
+{
+    uvec2 drawList[];
+};
+
+layout(set = 0, binding = 3) readonly buffer Glyphs
+{
+    Glyph glyphs[];
+};
+
+// input vertex attributes (dummy positions; shader generates the quad)
+layout(location = 0) in vec3 in_vertex;
+
+// output varyings
+layout(location = 0) out vec2 uv;
+layout(location = 1) flat out vec4 fill_color;
+layout(location = 2) flat out vec4 outline;
+
+// GL built-ins
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+void main()
+{
+    uvec2 ref = drawList[gl_InstanceIndex];
+
+    vec4 clip = instances[ref.x].proj * instances[ref.x].modelview * vec4(0,0,0,1);
+
+    vec2 viewport_size = instances[ref.x].viewport.zw;
+    vec2 pixel_size = 2.0 / viewport_size;
+
+    // quad corners: 0 = lower left, 1 = lower right, 2 = upper right, 3 = upper left
+    vec2 corner = vec2(
+        gl_VertexIndex == 0 || gl_VertexIndex == 3 ? 0.0 : 1.0,
+        gl_VertexIndex == 0 || gl_VertexIndex == 1 ? 0.0 : 1.0);
+
+    vec4 rect = glyphs[ref.y].rect;
+    vec2 offset = (rect.xy + corner * rect.zw) * instances[ref.x].scale + instances[ref.x].pixel_offset;
+
+    clip.xy += offset * pixel_size * clip.w;
+
+    vec4 uvrect = glyphs[ref.y].uvrect;
+    uv = mix(uvrect.xy, uvrect.zw, corner);
+
+    Material material = materials[instances[ref.x].material];
+    fill_color = material.color;
+    outline = material.outline;
+
+    gl_Position = clip;
+}
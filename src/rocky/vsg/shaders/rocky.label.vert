@@ -0,0 +1,39 @@
+#version 450
+
+// vsg push constants
+layout(push_constant) uniform PushConstants
+{
+    mat4 projection;
+    mat4 modelview;
+} pc;
+
+// vertex arrays as laid out by vsg::CpuLayoutTechnique
+// (see RockysCpuLayoutTechnique in LabelSystem.cpp)
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) in vec4 inOutlineColor;
+layout(location = 3) in float inOutlineWidth;
+layout(location = 4) in vec3 inTexCoord;
+
+// output varyings
+layout(location = 0) out vec2 uv;
+layout(location = 1) out vec4 fill_color;
+layout(location = 2) out vec4 outline;
+
+// GL built-ins
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+void main()
+{
+    gl_Position = pc.projection * pc.modelview * vec4(inPosition, 1.0);
+
+    uv = inTexCoord.xy; // z is a depth-tilt term we don't use (no depth test)
+    fill_color = inColor;
+
+    // map the style's outline width into signed-distance units,
+    // same convention as the indirect label pipeline:
+    outline = vec4(inOutlineColor.rgb, 0.5 * inOutlineWidth);
+}
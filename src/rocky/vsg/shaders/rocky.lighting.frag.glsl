@@ -1,4 +1,5 @@
 #pragma import_defines(ROCKY_ATMOSPHERE)
+#pragma import_defines(ROCKY_SHADOWS)
 
 // from VSG's view-dependent state
 layout(set = 1, binding = 0) uniform VSG_Lights {
@@ -9,6 +10,63 @@ layout(set = 1, binding = 0) uniform VSG_Lights {
 layout(location = 15) in vec3 atmos_color;
 #endif
 
+#ifdef ROCKY_SHADOWS
+
+// cascaded shadow maps; see rocky::ShadowMapNode
+#define SHADOW_CASCADES 4
+
+layout(set = 3, binding = 16) uniform ShadowData {
+    mat4 light_matrix[SHADOW_CASCADES]; // eye space -> light clip space
+    vec4 splits; // eye-space distance where each cascade ends
+    vec4 params; // x = cascade count, y = depth bias, z = max shadow distance
+} shadow;
+
+layout(set = 3, binding = 17) uniform sampler2D shadow_map[SHADOW_CASCADES];
+
+// constant-index fetch; indexing a sampler array with a varying index
+// is not legal in GLSL 4.50.
+float shadow_depth(in int c, in vec2 uv)
+{
+    if (c == 0) return texture(shadow_map[0], uv).r;
+    if (c == 1) return texture(shadow_map[1], uv).r;
+    if (c == 2) return texture(shadow_map[2], uv).r;
+    return texture(shadow_map[3], uv).r;
+}
+
+float shadow_factor(in vec3 vertex_view)
+{
+    int count = int(shadow.params.x);
+    float dist = length(vertex_view);
+    if (count == 0 || dist >= shadow.params.z)
+        return 1.0;
+
+    // tightest cascade covering this fragment:
+    int c = count - 1;
+    for (int i = count - 1; i >= 0; --i)
+        if (dist <= shadow.splits[i])
+            c = i;
+
+    vec4 lp = shadow.light_matrix[c] * vec4(vertex_view, 1.0);
+    vec3 ndc = lp.xyz / lp.w;
+    vec2 uv = ndc.xy * 0.5 + 0.5;
+    if (clamp(uv, 0.0, 1.0) != uv || ndc.z < 0.0 || ndc.z > 1.0)
+        return 1.0;
+
+    // reverse-Z: the map holds the occluder nearest the light, so a
+    // stored depth greater than ours means something is in the way.
+    // 3x3 PCF softens the edge.
+    float reference = ndc.z + shadow.params.y;
+    vec2 texel = 1.0 / vec2(textureSize(shadow_map[0], 0));
+    float lit = 0.0;
+    for (int y = -1; y <= 1; ++y)
+        for (int x = -1; x <= 1; ++x)
+            lit += shadow_depth(c, uv + vec2(x, y) * texel) > reference ? 0.0 : 1.0;
+
+    return lit / 9.0;
+}
+
+#endif // ROCKY_SHADOWS
+
 // TODO - this will eventually come from a material map
 struct PBR {
     float roughness;
@@ -75,6 +133,13 @@ void apply_lighting(inout vec4 color, in vec3 vertex_view, in vec3 normal)
     vec3 Lo = vec3(0.0);
     vec3 ambient = vec3(0.0); // vec3(0.013);
 
+    // sun occlusion from the cascaded shadow maps; the ambient term is
+    // deliberately left unshadowed.
+    float shadowing = 1.0;
+#ifdef ROCKY_SHADOWS
+    shadowing = shadow_factor(vertex_view);
+#endif
+
     vec4 light_counts = vsg_lights.pack[0];
     int ambient_count = int(light_counts[0]);
     int directional_count = int(light_counts[1]);
@@ -120,7 +185,7 @@ void apply_lighting(inout vec4 color, in vec3 vertex_view, in vec3 normal)
         vec3 kD = vec3(1.0) - kS;
         kD *= 1.0 - pbr.metal;
 
-        Lo += (kD * albedo / PI + specular) * radiance * NdotL;
+        Lo += (kD * albedo / PI + specular) * radiance * NdotL * shadowing;
     }
 
 #if 0
@@ -0,0 +1,184 @@
+#version 460
+
+#include "rocky.material.glsl"
+
+struct Instance
+{
+    mat4 proj;
+    mat4 modelview;
+    vec4 viewport;          // viewport x,y,w,h
+    vec4 bsphere;           // local bounding sphere; xyz = center, w = radius
+    uint material;          // index into the shared material table
+    uint first_segment;     // offset into the segment buffer
+    uint num_segments;      // 0 = blank/padding entry
+    float padding[1];       // pad to 16 bytes
+};
+
+struct Segment
+{
+    vec4 prev;              // point before the segment (== curr0 at a string start)
+    vec4 curr0;             // segment start
+    vec4 curr1;             // segment end
+    vec4 next;              // point after the segment (== curr1 at a string end)
+};
+
+layout(set = 0, binding = 1) readonly buffer CullList
+{
+    Instance instances[];
+};
+
+// draw buffer, output from the culling shader:
+// x = instance (cull list) index, y = segment buffer index
+layout(set = 0, binding = 2) readonly buffer DrawList
+{
+    uvec2 drawList[];
+};
+
+layout(set = 0, binding = 3) readonly buffer Segments
+{
+    Segment segments[];
+};
+
+// input vertex attributes (dummy positions; shader generates the quad)
+layout(location = 0) in vec3 in_vertex;
+
+// inter-stage interface block (must match rocky.line.frag)
+struct Varyings {
+    vec4 color;
+    vec2 stipple_dir;
+    int stipple_pattern;
+    int stipple_factor;
+};
+layout(location = 0) out float lateral;
+layout(location = 1) flat out Varyings rk;
+
+// GL built-ins
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main()
+{
+    uvec2 ref = drawList[gl_InstanceIndex];
+
+    // quad corners: 0 = start/left, 1 = start/right, 2 = end/right, 3 = end/left
+    bool is_start = gl_VertexIndex == 0 || gl_VertexIndex == 1;
+    bool is_right = gl_VertexIndex == 1 || gl_VertexIndex == 2;
+    lateral = is_right ? -1.0 : 1.0;
+
+    vec3 curr = is_start ? segments[ref.y].curr0.xyz : segments[ref.y].curr1.xyz;
+    vec3 prev = is_start ? segments[ref.y].prev.xyz : segments[ref.y].curr0.xyz;
+    vec3 next = is_start ? segments[ref.y].curr1.xyz : segments[ref.y].next.xyz;
+
+    Material material = materials[instances[ref.x].material];
+
+    rk.color = material.color;
+    rk.stipple_pattern = material.stipple_pattern;
+    rk.stipple_factor = material.stipple_factor;
+
+    float thickness = max(0.5, floor(material.width));
+    float len = thickness;
+
+    vec2 viewport_size = instances[ref.x].viewport.zw;
+
+    float bias = material.depth_offset;
+
+    vec4 curr_view = instances[ref.x].modelview * vec4(curr, 1);
+    curr_view.xyz -= normalize(curr_view.xyz) * bias;
+    vec4 curr_clip = instances[ref.x].proj * curr_view;
+
+    vec4 prev_view = instances[ref.x].modelview * vec4(prev, 1);
+    prev_view.xyz -= normalize(prev_view.xyz) * bias;
+    vec4 prev_clip = instances[ref.x].proj * prev_view;
+
+    vec4 next_view = instances[ref.x].modelview * vec4(next, 1);
+    next_view.xyz -= normalize(next_view.xyz) * bias;
+    vec4 next_clip = instances[ref.x].proj * next_view;
+
+    vec2 curr_pixel = (curr_clip.xy / curr_clip.w) * viewport_size;
+    vec2 prev_pixel = (prev_clip.xy / prev_clip.w) * viewport_size;
+    vec2 next_pixel = (next_clip.xy / next_clip.w) * viewport_size;
+
+    vec2 dir;
+
+    // The following vertex comparisons must be done in model
+    // space because the equivalency gets mashed after projection.
+
+    // string start uses (next - current)
+    if (curr == prev)
+    {
+        dir = normalize(next_pixel - curr_pixel);
+        rk.stipple_dir = dir;
+    }
+
+    // string end uses (current - previous)
+    else if (curr == next)
+    {
+        dir = normalize(curr_pixel - prev_pixel);
+        rk.stipple_dir = dir;
+    }
+
+    else
+    {
+        vec2 dir_in = normalize(curr_pixel - prev_pixel);
+        vec2 dir_out = normalize(next_pixel - curr_pixel);
+
+        if (dot(dir_in, dir_out) < -0.999999)
+        {
+            dir = is_start ? dir_out : dir_in;
+        }
+        else
+        {
+            vec2 tangent = normalize(dir_in + dir_out);
+            vec2 perp = vec2(-dir_in.y, dir_in.x);
+            vec2 miter = vec2(-tangent.y, tangent.x);
+            dir = tangent;
+            len = thickness / dot(miter, perp);
+
+            // limit the length of a mitered corner, to prevent unsightly spikes
+            const float limit = 2.0;
+            if (len > thickness * limit)
+            {
+                len = thickness;
+                dir = is_start ? dir_out : dir_in;
+            }
+        }
+        rk.stipple_dir = dir_out;
+    }
+
+    // calculate the extrusion vector in pixels
+    // note: seems like it should be len/2, BUT remember we are in [-w..w] space
+    vec2 extrude_pixel = vec2(-dir.y, dir.x) * len;
+
+    // and convert to unit space:
+    vec2 extrude_unit = extrude_pixel / viewport_size;
+
+    // calculate the offset in clip space and apply it.
+    vec2 offset = extrude_unit * lateral;
+    curr_clip.xy += (offset * curr_clip.w);
+
+    if (rk.stipple_pattern != 0xffff)
+    {
+        const float quantize = 8.0;
+
+        // Calculate the (quantized) rotation angle that will project the
+        // fragment coord onto the X-axis for stipple pattern sampling.
+        // Note: this relies on the GLSL "provoking vertex" being at the
+        // beginning of the line segment!
+
+        const float r2d = 57.29577951;
+        const float d2r = 1.0 / r2d;
+        int a = int(r2d * (atan(rk.stipple_dir.y, rk.stipple_dir.x)) + 180.0);
+        int q = int(360.0 / quantize);
+        int r = a % q;
+        int qa = (r > q / 2) ? a + q - r : a - r;
+        float qangle = d2r * (float(qa) - 180.0);
+        rk.stipple_dir = vec2(cos(qangle), sin(qangle));
+    }
+
+    // apply a static clip-space offset for z-flight mitigation.
+    const float clip_offset = 1e-7;
+    curr_clip.z += clip_offset * curr_clip.w;
+
+    gl_Position = curr_clip;
+}
@@ -16,17 +16,23 @@ layout(set = 0, binding = 1) uniform LineData {
     float depth_offset;
 } line;
 
+// Per-point data, two vec4s per point: [position.xyz, flags] and [color].
+// The segment quads are expanded here from gl_VertexIndex (four virtual
+// corners per point, addressed by the index buffer but never stored), so
+// line memory holds each point once instead of four times.
+layout(set = 0, binding = 2) readonly buffer PointData {
+    vec4 points[];
+};
+
+// flags stored in points[2i].w; must match LineGeometry::set.
+const int FLAG_FIRST = 1; // first point in a line (no previous point)
+const int FLAG_LAST = 2;  // last point in a line (no next point)
+
 // vsg viewport data
 layout(set = 1, binding = 1) readonly buffer VSG_Viewports {
     vec4 viewport[1]; // x, y, width, height
 } vsg_viewports;
 
-// input vertex attributes
-layout(location = 0) in vec3 in_vertex;
-layout(location = 1) in vec3 in_vertex_prev;
-layout(location = 2) in vec3 in_vertex_next;
-layout(location = 3) in vec4 in_color;
-
 // inter-stage interface block
 struct Varyings {
     vec4 color;
@@ -42,8 +48,19 @@ out gl_PerVertex {
     vec4 gl_Position;
 };
 
+#include "rocky.depth.vert.glsl"
+
 void main()
 {
+    // pull the point for this virtual vertex, and its neighbors:
+    int point_index = gl_VertexIndex >> 2;
+    int flags = int(points[point_index * 2].w);
+
+    vec3 in_vertex = points[point_index * 2].xyz;
+    vec3 in_vertex_prev = (flags & FLAG_FIRST) != 0 ? in_vertex : points[(point_index - 1) * 2].xyz;
+    vec3 in_vertex_next = (flags & FLAG_LAST) != 0 ? in_vertex : points[(point_index + 1) * 2].xyz;
+    vec4 in_color = points[point_index * 2 + 1];
+
     rk.color = line.color.a > 0.0 ? line.color : in_color;
     rk.stipple_pattern = line.stipple_pattern;
     rk.stipple_factor = line.stipple_factor;
@@ -55,19 +72,6 @@ void main()
     bool is_right = code == 0 || code == 2;
     lateral = is_right ? -1.0 : 1.0;
 
-#if 0
-    // Enforce the start/end limits on the line:
-    if (line.first >= 0 && line.last >= 0)
-    {
-        if (gl_VertexIndex < line.first || (line.last > 0 && gl_VertexIndex > line.last))
-        {
-            // no draw
-            lateral = 0.0;
-            return;
-        }
-    }
-#endif
-
     vec2 viewport_size = vsg_viewports.viewport[0].zw;
 
     float bias = line.depth_offset;
@@ -90,18 +94,15 @@ void main()
 
     vec2 dir;
 
-    // The following vertex comparisons must be done in model 
-    // space because the equivalency gets mashed after projection.
-
     // starting point uses (next - current)
-    if (in_vertex == in_vertex_prev)
+    if ((flags & FLAG_FIRST) != 0)
     {
         dir = normalize(next_pixel - curr_pixel);
         rk.stipple_dir = dir;
     }
 
     // ending point uses (current - previous)
-    if (in_vertex == in_vertex_next)
+    else if ((flags & FLAG_LAST) != 0)
     {
         dir = normalize(curr_pixel - prev_pixel);
         rk.stipple_dir = dir;
@@ -152,7 +153,7 @@ void main()
 
         // Calculate the (quantized) rotation angle that will project the
         // fragment coord onto the X-axis for stipple pattern sampling.
-        // Note: this relies on the GLSL "provoking vertex" being at the 
+        // Note: this relies on the GLSL "provoking vertex" being at the
         // beginning of the line segment!
 
         const float r2d = 57.29577951;
@@ -165,7 +166,10 @@ void main()
         rk.stipple_dir = vec2(cos(qangle), sin(qangle));
     }
 
-    // apply a static clip-space offset for z-flight mitigation.
+    curr_clip = apply_log_depth(pc.projection, curr_clip);
+
+    // apply a static clip-space offset for z-flight mitigation
+    // (after the depth mapping, which rewrites clip z):
     const float clip_offset = 1e-7;
     curr_clip.z += clip_offset * curr_clip.w;
 
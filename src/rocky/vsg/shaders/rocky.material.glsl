@@ -0,0 +1,22 @@
+// Shared material table (see rocky::MaterialTable). Styles from every
+// indirect ECS system deduplicate into this one array; each instance
+// record carries just an index into it. Bound once at binding 5 of every
+// indirect render descriptor set.
+
+struct Material
+{
+    vec4 color;
+    vec4 outline;           // rgb = outline color, a = width (0 = none)
+    vec4 uvrect;            // atlas placement (see TextureAtlas)
+    float layer;            // atlas layer; -1 = no texture
+    float width;            // line width, pixels
+    int stipple_pattern;
+    int stipple_factor;
+    float depth_offset;     // meters
+    float padding[3];       // pad to 16 bytes
+};
+
+layout(set = 0, binding = 5) readonly buffer Materials
+{
+    Material materials[];
+};
@@ -0,0 +1,76 @@
+#version 460
+
+#include "rocky.material.glsl"
+
+struct Instance
+{
+    mat4 proj;
+    mat4 modelview;
+    vec4 bsphere;           // local bounding sphere; xyz = center, w = radius
+    uint material;          // index into the shared material table
+    uint command;           // indirect command (prototype) index
+    float padding[2];       // pad to 16 bytes
+};
+
+struct Vertex
+{
+    vec4 position;          // xyz = position, w = depth offset (meters)
+    vec4 color;
+    vec4 uv;                // xy = texture coordinate
+};
+
+layout(set = 0, binding = 1) readonly buffer CullList
+{
+    Instance instances[];
+};
+
+// draw buffer, output from the culling shader. gl_InstanceIndex already
+// includes the command's firstInstance, which the CPU points at the
+// command's slice of this list.
+layout(set = 0, binding = 2) readonly buffer DrawList
+{
+    uint drawList[];
+};
+
+layout(set = 0, binding = 3) readonly buffer Vertices
+{
+    Vertex vertices[];
+};
+
+// input vertex attributes (dummy positions; real data comes from the SSBO)
+layout(location = 0) in vec3 in_vertex;
+
+// inter-stage interface block (must match rocky.mesh.frag)
+struct Varyings {
+    vec4 color;
+};
+layout(location = 1) out vec2 uv;
+layout(location = 2) flat out Varyings vary;
+
+// GL built-ins
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main()
+{
+    uint i = drawList[gl_InstanceIndex];
+
+    // gl_VertexIndex already includes the command's firstVertex:
+    Vertex v = vertices[gl_VertexIndex];
+
+    Material material = materials[instances[i].material];
+
+    vary.color = material.color.a > 0.0 ? material.color : v.color;
+
+    float depthoffset = material.depth_offset != 0.0 ? material.depth_offset : v.position.w;
+
+    uv = v.uv.xy;
+
+    // Depth offset (view-space approach):
+    vec4 view = instances[i].modelview * vec4(v.position.xyz, 1);
+    view.xyz -= normalize(view.xyz) * depthoffset;
+    vec4 clip = instances[i].proj * view;
+
+    gl_Position = clip;
+}
@@ -34,6 +34,8 @@ out gl_PerVertex {
     vec4 gl_Position;
 };
 
+#include "rocky.depth.vert.glsl"
+
 void main()
 {
     float depthoffset = in_depthoffset;
@@ -55,5 +57,5 @@ void main()
     view.xyz -= normalize(view.xyz) * depthoffset;
     vec4 clip = pc.projection * view;
 
-    gl_Position = clip;
+    gl_Position = apply_log_depth(pc.projection, clip);
 }
@@ -0,0 +1,15 @@
+#version 450
+
+// inter-stage interface block
+struct Varyings {
+    vec4 color;
+};
+layout(location = 1) flat in Varyings vary;
+
+// outputs
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+    out_color = vary.color;
+}
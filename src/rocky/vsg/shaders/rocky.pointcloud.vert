@@ -0,0 +1,53 @@
+#version 450
+#pragma import_defines(USE_POINTCLOUD_STYLE)
+
+// vsg push constants
+layout(push_constant) uniform PushConstants {
+    mat4 projection;
+    mat4 modelview;
+} pc;
+
+#ifdef USE_POINTCLOUD_STYLE
+// see rocky::PointCloudStyle
+layout(set = 0, binding = 1) uniform PointCloudData {
+    vec4 color;
+    float pointSize;
+} pointcloud;
+#endif
+
+// input vertex attributes
+layout(location = 0) in vec3 in_vertex;
+layout(location = 1) in vec4 in_color;
+
+// inter-stage interface block
+struct Varyings {
+    vec4 color;
+};
+layout(location = 1) flat out Varyings vary;
+
+// GL built-ins
+out gl_PerVertex {
+    vec4 gl_Position;
+    float gl_PointSize;
+};
+
+#include "rocky.depth.vert.glsl"
+
+void main()
+{
+    float pointSize = 2.0;
+
+#ifdef USE_POINTCLOUD_STYLE
+    vary.color = pointcloud.color.a > 0.0 ? pointcloud.color : in_color;
+    if (pointcloud.pointSize > 0.0)
+        pointSize = pointcloud.pointSize;
+#else
+    vary.color = in_color;
+#endif
+
+    vec4 view = pc.modelview * vec4(in_vertex, 1);
+    vec4 clip = pc.projection * view;
+
+    gl_Position = apply_log_depth(pc.projection, clip);
+    gl_PointSize = pointSize;
+}
@@ -0,0 +1,16 @@
+// Samples the elevation data at a UV tile coordinate.
+// Requires the elevation_tex sampler and the TileData "tile" block.
+float terrain_get_elevation(in vec2 uv)
+{
+    float size = float(textureSize(elevation_tex, 0).x);
+    vec2 coeff = vec2((size - 1.0) / size, 0.5 / size);
+
+    // Texel-level scale and bias allow us to sample the elevation texture
+    // on texel center instead of edge.
+    vec2 elevc = uv
+        * coeff.x * tile.elevation_matrix[0][0] // scale
+        + coeff.x * tile.elevation_matrix[3].st // bias
+        + coeff.y;
+
+    return texture(elevation_tex, elevc).r;
+}
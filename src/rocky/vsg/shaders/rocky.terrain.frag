@@ -2,6 +2,7 @@
 
 #pragma import_defines(ROCKY_LIGHTING)
 #pragma import_defines(ROCKY_WIREFRAME_OVERLAY)
+#pragma import_defines(ROCKY_DETAIL_TEXTURING)
 
 layout(push_constant) uniform PushConstants {
     mat4 projection;
@@ -23,6 +24,26 @@ layout(location = 0) in RockyVaryings varyings;
 layout(set = 0, binding = 11) uniform sampler2D color_tex;
 //layout(set = 0, binding = 12) uniform sampler2D normal_tex;
 
+// timestep slices of a time-series color layer (placeholder when the
+// tile is static; see tile_params.z)
+layout(set = 0, binding = 15) uniform sampler2DArray color_frames_tex;
+
+// see rocky::TerrainTileDescriptors
+layout(set = 2, binding = 13) uniform TileData
+{
+    mat4 elevation_matrix;
+    mat4 color_matrix;
+    vec4 tile_params; // x = skirt extrusion height (meters), y = layer control index (-1 = none), z = time-series frame count (0 = static)
+} tile;
+
+// map-wide layer controls (x = opacity, y = visible, z = animation
+// clock), written once per update pass; see
+// rocky::TerrainState::updateLayerControls
+layout(set = 3, binding = 14) uniform LayerControls
+{
+    vec4 layer[16];
+} layers;
+
 #if defined(ROCKY_LIGHTING)
 #include "rocky.lighting.frag.glsl"
 #endif
@@ -30,6 +51,68 @@ layout(set = 0, binding = 11) uniform sampler2D color_tex;
 // outputs
 layout(location = 0) out vec4 out_color;
 
+#if defined(ROCKY_DETAIL_TEXTURING)
+
+// procedural close-range ground detail
+// (see TerrainSettings::detailTexturing)
+const float DETAIL_REPEATS = 16.0;    // noise tiles per terrain tile
+const float DETAIL_DISTANCE = 4000.0; // meters; fully faded beyond this
+const float DETAIL_INTENSITY = 0.35;
+
+// value noise with an integer period, so the pattern wraps seamlessly
+// at tile borders (every tile repeats the identical pattern)
+float detail_hash(vec2 cell, float period)
+{
+    cell = mod(cell, period);
+    return fract(sin(dot(cell, vec2(127.1, 311.7))) * 43758.5453);
+}
+
+float detail_noise(vec2 uv, float period)
+{
+    vec2 cell = floor(uv);
+    vec2 f = uv - cell;
+    f = f * f * (3.0 - 2.0 * f);
+    float a = detail_hash(cell, period);
+    float b = detail_hash(cell + vec2(1.0, 0.0), period);
+    float c = detail_hash(cell + vec2(0.0, 1.0), period);
+    float d = detail_hash(cell + vec2(1.0, 1.0), period);
+    return mix(mix(a, b, f.x), mix(c, d, f.x), f.y);
+}
+
+// Coarse land-cover weights (vegetation, bare rock/soil, snow) derived
+// from the composited imagery color. A dedicated classification texture
+// can replace this heuristic without touching the blending below.
+vec3 classify(vec3 rgb)
+{
+    float brightness = dot(rgb, vec3(0.333));
+    float vegetation = clamp((rgb.g - max(rgb.r, rgb.b)) * 4.0 + 0.5, 0.0, 1.0);
+    float snow = clamp((brightness - 0.75) * 4.0, 0.0, 1.0) * (1.0 - vegetation);
+    float rock = max(1.0 - vegetation - snow, 0.0);
+    return vec3(vegetation, rock, snow);
+}
+
+void apply_detail(inout vec4 color)
+{
+    float dist = length(varyings.vertex_view);
+    float fade = 1.0 - smoothstep(DETAIL_DISTANCE * 0.5, DETAIL_DISTANCE, dist);
+    if (fade <= 0.0)
+        return;
+
+    vec2 uv = varyings.uv * DETAIL_REPEATS;
+    float broad = detail_noise(uv, DETAIL_REPEATS);
+    float fine = detail_noise(uv * 4.0, DETAIL_REPEATS * 4.0);
+
+    vec3 w = classify(color.rgb);
+
+    // vegetation reads clumpy and fine, rock broad, snow barely at all:
+    float n = mix(broad, fine, 0.35 + 0.4 * w.x);
+    float strength = DETAIL_INTENSITY * (w.x + 0.8 * w.y + 0.25 * w.z);
+
+    color.rgb *= 1.0 + strength * (n - 0.5) * fade;
+}
+
+#endif // ROCKY_DETAIL_TEXTURING
+
 vec3 get_normal()
 {
     // temporary! until we support normal maps
@@ -41,7 +124,37 @@ vec3 get_normal()
 
 void main()
 {
-    vec4 texel = texture(color_tex, varyings.uv);
+    int layer_index = int(tile.tile_params.y);
+
+    vec4 texel;
+    int frame_count = int(tile.tile_params.z);
+    if (frame_count > 1)
+    {
+        // time-series tile: blend the two timestep slices adjacent to
+        // the layer's animation clock. Scrubbing the clock is a single
+        // uniform write; the slices themselves never re-upload.
+        float clock = layer_index >= 0 ? layers.layer[layer_index].z : 0.0;
+        clock = clamp(clock, 0.0, float(frame_count - 1));
+        float frame = floor(clock);
+        texel = mix(
+            texture(color_frames_tex, vec3(varyings.uv, frame)),
+            texture(color_frames_tex, vec3(varyings.uv, min(frame + 1.0, float(frame_count - 1)))),
+            clock - frame);
+    }
+    else
+    {
+        texel = texture(color_tex, varyings.uv);
+    }
+
+    // apply the bound layer's live opacity and visibility. Composited
+    // tiles carry index -1; their opacities are baked in already.
+    if (layer_index >= 0)
+        texel.a *= layers.layer[layer_index].x * layers.layer[layer_index].y;
+
+#if defined(ROCKY_DETAIL_TEXTURING)
+    apply_detail(texel);
+#endif
+
     out_color = mix(varyings.color, clamp(texel, 0, 1), texel.a);
 
     if (gl_FrontFacing == false)
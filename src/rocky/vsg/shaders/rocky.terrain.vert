@@ -1,6 +1,7 @@
 #version 450
 #pragma import_defines(ROCKY_LIGHTING)
 #pragma import_defines(ROCKY_ATMOSPHERE)
+#pragma import_defines(ROCKY_TESSELLATE)
 
 layout(set = 0, binding = 10) uniform sampler2D elevation_tex;
 
@@ -10,13 +11,19 @@ layout(push_constant) uniform PushConstants
     mat4 modelview;
 } pc;
 
-// see rocky::TerrainTileDescriptors
-layout(set = 0, binding = 13) uniform TileData
+// see rocky::TerrainTileDescriptors. The tile buffer sits in its own
+// set so the texture set (set 0) can be shared across tiles that
+// inherit an ancestor's imagery.
+layout(set = 2, binding = 13) uniform TileData
 {
     mat4 elevation_matrix;
     mat4 color_matrix;
+    vec4 tile_params; // x = skirt extrusion height (meters), y = layer control index (-1 = none)
 } tile;
 
+// vertex marker bits; see GeometryPool.h
+#define VERTEX_SKIRT 8
+
 // input vertex attributes
 layout(location = 0) in vec3 in_vertex;
 layout(location = 1) in vec3 in_normal;
@@ -30,38 +37,49 @@ struct RockyVaryings {
     vec3 vertex_view;
 };
 
-// output varyings
-layout(location = 0) out RockyVaryings varyings;
-
-#if defined(ROCKY_ATMOSPHERE)
-#include "rocky.atmo.ground.vert.glsl"
-#endif
-
 // GL built-ins
 out gl_PerVertex {
     vec4 gl_Position;
 };
 
-// sample the elevation data at a UV tile coordinate
-float terrain_get_elevation(in vec2 uv)
-{
-    float size = float(textureSize(elevation_tex, 0).x);
-    vec2 coeff = vec2((size - 1.0) / size, 0.5 / size);
+#include "rocky.depth.vert.glsl"
+
+#if defined(ROCKY_TESSELLATE)
 
-    // Texel-level scale and bias allow us to sample the elevation texture
-    // on texel center instead of edge.
-    vec2 elevc = uv
-        * coeff.x * tile.elevation_matrix[0][0] // scale
-        + coeff.x * tile.elevation_matrix[3].st // bias
-        + coeff.y;
+// Tessellation path: emit the raw control points and defer elevation
+// sampling, skirting, and the view transform to rocky.terrain.tese.
+layout(location = 5) out vec3 tess_normal;
+layout(location = 6) out vec3 tess_uvw;
+layout(location = 7) out float tess_skirt;
 
-    return texture(elevation_tex, elevc).r;
+void main()
+{
+    tess_normal = in_normal;
+    tess_uvw = in_uvw;
+    tess_skirt = ((int(in_uvw.z) & VERTEX_SKIRT) != 0) ? 1.0 : 0.0;
+    gl_Position = vec4(in_vertex, 1.0);
 }
 
+#else // !ROCKY_TESSELLATE
+
+// output varyings
+layout(location = 0) out RockyVaryings varyings;
+
+#if defined(ROCKY_ATMOSPHERE)
+#include "rocky.atmo.ground.vert.glsl"
+#endif
+
+#include "rocky.terrain.elevation.glsl"
+
 void main()
 {
     float elevation = terrain_get_elevation(in_uvw.st);
     vec3 position = in_vertex + in_normal*elevation;
+
+    // skirt vertices are stored at the surface position and extruded here:
+    if ((int(in_uvw.z) & VERTEX_SKIRT) != 0)
+        position -= in_normal * tile.tile_params.x;
+
     vec4 position_view = pc.modelview * vec4(position, 1.0);
 
 #if defined(ROCKY_ATMOSPHERE)
@@ -74,6 +92,8 @@ void main()
     varyings.color = vec4(0.5); // placeholder
     varyings.uv = (tile.color_matrix * vec4(in_uvw.st, 0, 1)).st;
     varyings.vertex_view = position_view.xyz / position_view.w;
-    
-    gl_Position = pc.projection * position_view;
+
+    gl_Position = apply_log_depth(pc.projection, pc.projection * position_view);
 }
+
+#endif // !ROCKY_TESSELLATE
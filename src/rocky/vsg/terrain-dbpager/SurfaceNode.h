@@ -107,13 +107,17 @@ namespace ROCKY_NAMESPACE
             }
             else
             {
+                // no single culling point; test the four corner points
+                // in one batched pass:
+                glm::dvec4 corners[4];
+                bool cornerVisible[4];
                 for (int p = 0; p < 4; ++p)
                 {
                     auto& wp = _worldPoints[p];
-                    if (viewlocal.horizon->isVisible(wp.x, wp.y, wp.z))
-                        return true;
+                    corners[p] = glm::dvec4(wp.x, wp.y, wp.z, 0.0);
                 }
-                return false;
+                viewlocal.horizon->isVisible(corners, cornerVisible, 4);
+                return cornerVisible[0] || cornerVisible[1] || cornerVisible[2] || cornerVisible[3];
             }
         }
 
@@ -38,13 +38,17 @@ GeometryPool::getPooledGeometry(const TileKey& tileKey, const Settings& settings
     GeometryKey geomKey;
     createKeyForTileKey(tileKey, settings.tileSize, geomKey);
 
-    // make our globally shared EBO if we need it
+    // make our globally shared EBO and texcoord VBO if we need them
     {
         std::scoped_lock lock(_mutex);
         if (_defaultIndices == nullptr)
         {
             _defaultIndices = createIndices(settings);
         }
+        if (_defaultUVs == nullptr)
+        {
+            _defaultUVs = createUVs(settings);
+        }
     }
 
     ROCKY_TODO("MeshEditor meshEditor(tileKey, tileSize, map, nullptr);");
@@ -124,20 +128,20 @@ namespace
     }
 }
 
-#define addSkirtDataForIndex(P, INDEX, HEIGHT) \
+// Both skirt verts are stored at the surface position; the second one
+// carries the VERTEX_SKIRT marker and is extruded downward in
+// rocky.terrain.vert, so the skirt length can change per tile without
+// regenerating the pooled geometry.
+#define addSkirtDataForIndex(P, INDEX) \
 { \
     verts->set(P, verts->at(INDEX)); \
     normals->set(P, normals->at(INDEX)); \
-    uvs->set(P, uvs->at(INDEX)); \
-    uvs->at(P).z = (float)((int)uvs->at(P).z | VERTEX_SKIRT); \
     if ( neighbors ) neighbors->set(P, neighbors->at(INDEX)); \
     if ( neighborNormals ) neighborNormals->set(P, neighborNormals->at(INDEX)); \
     ++P; \
-    verts->set(P, verts->at(INDEX) - (normals->at(INDEX)*(HEIGHT))); \
+    verts->set(P, verts->at(INDEX)); \
     normals->set(P, normals->at(INDEX)); \
-    uvs->set(P, uvs->at(INDEX)); \
-    uvs->at(P).z = (float)((int)uvs->at(P).z | VERTEX_SKIRT); \
-    if ( neighbors ) neighbors->set(P, neighbors->at(INDEX) - (normals->at(INDEX)*(HEIGHT))); \
+    if ( neighbors ) neighbors->set(P, neighbors->at(INDEX)); \
     if ( neighborNormals ) neighborNormals->set(P, neighborNormals->at(INDEX)); \
     ++P; \
 }
@@ -153,7 +157,7 @@ namespace
 }
 
 vsg::ref_ptr<vsg::ushortArray>
-GeometryPool::createIndices(const Settings& settings) const
+GeometryPool::createIndices(const Settings& settings, int poleEdge) const
 {
     // Attempt to calculate the number of verts in the surface geometry.
     bool needsSkirt = settings.skirtRatio > 0.0f;
@@ -163,6 +167,13 @@ GeometryPool::createIndices(const Settings& settings) const
     unsigned numVertsInSkirt = needsSkirt ? (tileSize - 1) * 2u * 4u : 0;
     unsigned numVerts = numVertsInSurface + numVertsInSkirt;
     unsigned numIndicesInSurface = (tileSize - 1) * (tileSize - 1) * 6;
+
+    // a pole-adjacent tile's pole-side row of verts all coincide at the
+    // pole, so one triangle of each cell in that strip is degenerate;
+    // the pole-cap variant fans to the pole and leaves those out.
+    if (poleEdge != 0)
+        numIndicesInSurface -= (tileSize - 1) * 3;
+
     unsigned numIncidesInSkirt = getNumSkirtElements(settings);
     unsigned numIndices = numIndicesInSurface + numIncidesInSkirt;
 
@@ -172,6 +183,11 @@ GeometryPool::createIndices(const Settings& settings) const
     unsigned p = 0;
     for (unsigned j = 0; j < tileSize - 1; ++j)
     {
+        // in the strip abutting a pole, only the triangle with two verts
+        // off the pole survives:
+        bool northCap = (poleEdge > 0 && j == tileSize - 2);
+        bool southCap = (poleEdge < 0 && j == 0);
+
         for (unsigned i = 0; i < tileSize - 1; ++i)
         {
             int i00 = j * tileSize + i;
@@ -181,13 +197,19 @@ GeometryPool::createIndices(const Settings& settings) const
 
             unsigned k = j * tileSize + i;
 
-            indices->set(p++, i01);
-            indices->set(p++, i00);
-            indices->set(p++, i11);
+            if (!northCap)
+            {
+                indices->set(p++, i01);
+                indices->set(p++, i00);
+                indices->set(p++, i11);
+            }
 
-            indices->set(p++, i00);
-            indices->set(p++, i10);
-            indices->set(p++, i11);
+            if (!southCap)
+            {
+                indices->set(p++, i00);
+                indices->set(p++, i10);
+                indices->set(p++, i11);
+            }
         }
     }
 
@@ -207,6 +229,62 @@ GeometryPool::createIndices(const Settings& settings) const
     return indices;
 }
 
+vsg::ref_ptr<vsg::vec3Array>
+GeometryPool::createUVs(const Settings& settings) const
+{
+    // The texcoord/marker array depends only on the settings, never on the
+    // tile location, so every tile in the pool can bind the same buffer.
+    bool needsSkirt = settings.skirtRatio > 0.0f;
+    uint32_t tileSize = std::max(settings.tileSize, 2u);
+
+    unsigned numVertsInSurface = (tileSize*tileSize);
+    unsigned numVertsInSkirt = needsSkirt ? (tileSize - 1) * 2u * 4u : 0;
+
+    auto uvs = vsg::vec3Array::create(numVertsInSurface + numVertsInSkirt);
+
+    for (unsigned row = 0; row < tileSize; ++row)
+    {
+        float ny = (float)row / (float)(tileSize - 1);
+        for (unsigned col = 0; col < tileSize; ++col)
+        {
+            float nx = (float)col / (float)(tileSize - 1);
+            uvs->set(row * tileSize + col, vsg::vec3(nx, ny, VERTEX_VISIBLE));
+        }
+    }
+
+    if (needsSkirt)
+    {
+        // skirt verts copy their source vert's texcoords, tagged as skirt.
+        // Ordering must match the skirt construction in createGeometry.
+        unsigned p = numVertsInSurface;
+
+        auto addSkirtUVsForIndex = [&](unsigned index)
+        {
+            // the anchor copy stays a surface vertex; only the second
+            // copy is marked as a skirt vertex, which the vertex shader
+            // extrudes downward by the tile's skirt height.
+            vsg::vec3 uv = uvs->at(index);
+            uvs->set(p++, uv);
+            uv.z = (float)((int)uv.z | VERTEX_SKIRT);
+            uvs->set(p++, uv);
+        };
+
+        for (int c = 0; c < (int)tileSize - 1; ++c)
+            addSkirtUVsForIndex(c); //south
+
+        for (int r = 0; r < (int)tileSize - 1; ++r)
+            addSkirtUVsForIndex(r*tileSize + (tileSize - 1)); //east
+
+        for (int c = tileSize - 1; c > 0; --c)
+            addSkirtUVsForIndex((tileSize - 1)*tileSize + c); //north
+
+        for (int r = tileSize - 1; r > 0; --r)
+            addSkirtUVsForIndex(r*tileSize); //west
+    }
+
+    return uvs;
+}
+
 namespace
 {
     struct Locator
@@ -252,6 +330,20 @@ namespace
 vsg::ref_ptr<SharedGeometry>
 GeometryPool::createGeometry(const TileKey& tileKey, const Settings& settings, Cancelable* progress) const
 {
+    // Pole-adjacent tiles in a geocentric map collapse one edge to the
+    // pole point; they get a pole-cap index variant that fans to the pole
+    // instead of rendering a strip of degenerate triangles. (A projected
+    // map - polar stereographic included - has no such collapse.)
+    int poleEdge = 0;
+    if (tileKey.profile.srs().isGeodetic())
+    {
+        auto key_extent = tileKey.extent();
+        if (key_extent.ymax() >= 90.0 - 1e-9)
+            poleEdge = 1;
+        else if (key_extent.ymin() <= -90.0 + 1e-9)
+            poleEdge = -1;
+    }
+
     // Establish a local reference frame for the tile:
     GeoPoint centroid = tileKey.extent().centroid();
     centroid.transformInPlace(_worldSRS);
@@ -276,7 +368,10 @@ GeometryPool::createGeometry(const TileKey& tileKey, const Settings& settings, C
     // the initial vertex locations:
     auto verts = vsg::vec3Array::create(numVerts);
     auto normals = vsg::vec3Array::create(numVerts);
-    auto uvs = vsg::vec3Array::create(numVerts);
+
+    // texcoords/markers are tile-independent, so all pooled tiles
+    // share a single array (and thus a single GPU buffer):
+    auto uvs = (_enabled && _defaultUVs) ? _defaultUVs : createUVs(settings);
 
     vsg::ref_ptr<vsg::vec3Array> neighbors;
     vsg::ref_ptr<vsg::vec3Array> neighborNormals;
@@ -312,10 +407,6 @@ GeometryPool::createGeometry(const TileKey& tileKey, const Settings& settings, C
 
                 expandSphereToInclude(tileBound, vsg::dvec3(local.x, local.y, local.z));
 
-                // Use the Z coord as a type marker
-                float marker = VERTEX_VISIBLE;
-                uvs->set(i, vsg::vec3(nx, ny, marker));
-
                 unit.z = 1.0;
                 world_plus_one = locator.unitToWorld(unit);
                 normal = glm::normalize((world2local*world_plus_one) - local);
@@ -338,28 +429,41 @@ GeometryPool::createGeometry(const TileKey& tileKey, const Settings& settings, C
 
         if (needsSkirt)
         {
-            // calculate the skirt extrusion height
-            float height = (float)tileBound.radius * settings.skirtRatio;
-
             // Normal tile skirt first:
             unsigned skirtIndex = numVertsInSurface; // verts->size();
 
             // first, create all the skirt verts, normals, and texcoords.
             for (int c = 0; c < (int)tileSize - 1; ++c)
-                addSkirtDataForIndex(skirtIndex, c, height); //south
+                addSkirtDataForIndex(skirtIndex, c); //south
 
             for (int r = 0; r < (int)tileSize - 1; ++r)
-                addSkirtDataForIndex(skirtIndex, r*tileSize + (tileSize - 1), height); //east
+                addSkirtDataForIndex(skirtIndex, r*tileSize + (tileSize - 1)); //east
 
             for (int c = tileSize - 1; c > 0; --c)
-                addSkirtDataForIndex(skirtIndex, (tileSize - 1)*tileSize + c, height); //north
+                addSkirtDataForIndex(skirtIndex, (tileSize - 1)*tileSize + c); //north
 
             for (int r = tileSize - 1; r > 0; --r)
-                addSkirtDataForIndex(skirtIndex, r*tileSize, height); //west
+                addSkirtDataForIndex(skirtIndex, r*tileSize); //west
         }
 
-        auto indices =
-            _enabled ? _defaultIndices : createIndices(settings);
+        vsg::ref_ptr<vsg::ushortArray> indices;
+        if (_enabled)
+        {
+            // indices depend only on the settings and the pole edge, so
+            // each variant is built once and shared by every matching
+            // tile at every LOD:
+            std::scoped_lock lock(_mutex);
+            auto& cached =
+                poleEdge > 0 ? _northPoleIndices :
+                poleEdge < 0 ? _southPoleIndices : _defaultIndices;
+            if (!cached)
+                cached = createIndices(settings, poleEdge);
+            indices = cached;
+        }
+        else
+        {
+            indices = createIndices(settings, poleEdge);
+        }
 
         // the geometry:
         auto geom = SharedGeometry::create();
@@ -116,7 +116,9 @@ namespace ROCKY_NAMESPACE
      * more sharing is possible.
      *
      * This object creates and returns geometries based on TileKeys, sharing instances
-     * whenever possible.
+     * whenever possible. Geocentric tiles abutting a pole use a pole-cap index
+     * variant (built once, shared across LODs) that fans to the pole point rather
+     * than emitting a strip of degenerate triangles.
      */
     class GeometryPool
     {
@@ -158,6 +160,12 @@ namespace ROCKY_NAMESPACE
         mutable std::mutex _mutex;
         mutable SharedGeometries _sharedGeometries;
         mutable vsg::ref_ptr<vsg::ushortArray> _defaultIndices;
+        // pole-cap index variants for geocentric tiles abutting a pole;
+        // indices depend only on the settings, so each variant is built
+        // once and shared by every pole tile at every LOD.
+        mutable vsg::ref_ptr<vsg::ushortArray> _northPoleIndices;
+        mutable vsg::ref_ptr<vsg::ushortArray> _southPoleIndices;
+        mutable vsg::ref_ptr<vsg::vec3Array> _defaultUVs;
         Settings _defaultIndicesSettings;
 
         void createKeyForTileKey(
@@ -170,8 +178,18 @@ namespace ROCKY_NAMESPACE
             const Settings& settings,
             Cancelable* progress) const;
 
-        // builds a primitive set to use for any tile without a mask
+        // builds a primitive set to use for any tile without a mask.
+        // poleEdge is +1 for a tile whose top edge lies on the north pole,
+        // -1 for one whose bottom edge lies on the south pole, and 0
+        // otherwise; pole-cap variants fan to the pole vertex instead of
+        // emitting a strip of degenerate triangles.
         vsg::ref_ptr<vsg::ushortArray> createIndices(
+            const Settings& settings,
+            int poleEdge = 0) const;
+
+        // builds the texcoord/marker array, which is identical for every
+        // tile sharing the same settings and can live in a single GPU buffer
+        vsg::ref_ptr<vsg::vec3Array> createUVs(
             const Settings& settings) const;
 
         bool _enabled = true;
@@ -49,6 +49,12 @@ namespace ROCKY_NAMESPACE
         //! Force a recompute of the bounding box and culling information
         const vsg::dsphere& recomputeBound();
 
+        //! Tile-local proxy mesh (the grid verts displaced by the
+        //! current elevation raster), computed by recomputeBound()
+        const std::vector<vsg::vec3>& proxyMesh() const {
+            return _proxyMesh;
+        }
+
         vsg::dsphere worldBoundingSphere;
         vsg::dbox localbbox;
 
@@ -75,22 +81,40 @@ namespace ROCKY_NAMESPACE
     {
         auto* state = rv.getState();
 
-        // bounding box visibility check; this is much tighter than the bounding
-        // sphere. _frustumStack.top() contains the frustum in world coordinates.
+        // _frustumStack.top() contains the frustum in world coordinates.
         // https://github.com/vsg-dev/VulkanSceneGraph/blob/master/include/vsg/vk/State.h#L267
-        // The first 8 points in _worldPoints are the 8 corners of the bounding box
-        // in world coordinates.
         // Note: POLYTOPE_SIZE is defined in vsg plane.h
         auto& frustum = state->_frustumStack.top();
-        int p;
+
+        // cheap conclusive test against the precomputed bounding sphere first.
+        // A tile entirely inside (or outside) every frustum plane resolves in
+        // 6 plane tests; only tiles straddling a plane fall through to the
+        // tighter (but 8x more expensive) bounding box test below.
+        bool conclusive = true;
         for (int f = 0; f < POLYTOPE_SIZE; ++f)
         {
-            for (p = 0; p < 8; ++p)
-                if (vsg::distance(frustum.face[f], _worldPoints[p]) > 0.0) // visible?
-                    break;
+            double d = vsg::distance(frustum.face[f], worldBoundingSphere.center);
+            if (d < -worldBoundingSphere.radius)
+                return false; // entirely outside this plane
+            if (d < worldBoundingSphere.radius)
+                conclusive = false; // straddles; the box test must decide
+        }
+
+        if (!conclusive)
+        {
+            // bounding box visibility check; this is much tighter than the
+            // bounding sphere. The first 8 points in _worldPoints are the 8
+            // corners of the bounding box in world coordinates.
+            int p;
+            for (int f = 0; f < POLYTOPE_SIZE; ++f)
+            {
+                for (p = 0; p < 8; ++p)
+                    if (vsg::distance(frustum.face[f], _worldPoints[p]) > 0.0) // visible?
+                        break;
 
-            if (p == 8)
-                return false;
+                if (p == 8)
+                    return false;
+            }
         }
 
         // Horizon culling:
@@ -107,13 +131,17 @@ namespace ROCKY_NAMESPACE
             }
             else
             {
+                // no single culling point; test the four corner points
+                // in one batched pass:
+                glm::dvec4 corners[4];
+                bool cornerVisible[4];
                 for (int p = 0; p < 4; ++p)
                 {
                     auto& wp = _worldPoints[p];
-                    if (viewlocal.horizon->isVisible(wp.x, wp.y, wp.z))
-                        return true;
+                    corners[p] = glm::dvec4(wp.x, wp.y, wp.z, 0.0);
                 }
-                return false;
+                viewlocal.horizon->isVisible(corners, cornerVisible, 4);
+                return cornerVisible[0] || cornerVisible[1] || cornerVisible[2] || cornerVisible[3];
             }
         }
 
@@ -10,6 +10,7 @@
 #include "GeometryPool.h"
 #include <rocky/Map.h>
 #include <rocky/TerrainTileModelFactory.h>
+#include <rocky/Threading.h>
 
 #include <vsg/state/ShaderStage.h>
 
@@ -34,9 +35,52 @@ TerrainEngine::TerrainEngine(
     ROCKY_SOFT_ASSERT(map, "Map is required");
     ROCKY_SOFT_ASSERT(profile.valid(), "Valid profile required");
 
+    stateFactory.compressColorTextures = settings.compressColorTextures;
+    stateFactory.gpuTessellation = settings.gpuTessellation;
+    stateFactory.detailTexturing = settings.detailTexturing;
+
     worldSRS = profile.srs().isGeodetic() ? profile.srs().geocentricSRS() : profile.srs();
 
-    jobs::get_pool(loadSchedulerName)->set_concurrency(settings.concurrency);
+    // Create the loader pool with zero threads so the background
+    // scheduling class applies to every worker it starts; loader jobs
+    // then never compete with the render thread for CPU time.
+    auto* loaderPool = jobs::get_pool(loadSchedulerName, 0u);
+    util::setJobPoolThreadPriority(loaderPool, util::ThreadPriority::Background);
+    loaderPool->set_concurrency(settings.concurrency);
+
+    // Register the terrain caches with the memory governor. Pressure on
+    // the geometry pool releases geometries no live tile references;
+    // pressure on the tile registry lifts the pager's per-frame
+    // expiration cap so every unpinged tile releases at once.
+    _geometryPoolMemoryReg = context->memory.add(
+        "terrain geometry pool",
+        [this]() { return geometryPool.size(); },
+        [this](float) { geometryPool.sweep(context); });
+
+    _tilesMemoryReg = context->memory.add(
+        "terrain tile registry",
+        [this]() { return tiles.size(); },
+        [this](float) { tiles.expireAllNextUpdate = true; });
+
+    // Register the terrain's device-memory consumers with the GPU memory
+    // governor. Pressure there means VRAM is running short, so the pager
+    // responds by lowering the deepest resident level of detail, which
+    // sheds the finest (and most numerous) tile textures first.
+    _tileTexturesGpuReg = context->gpuMemory.add(
+        "terrain tile textures",
+        [this]() { return tiles.residentTextureBytes(); },
+        [this](float) { tiles.lowerResidentLevelCap(); });
+
+    _geometryPoolGpuReg = context->gpuMemory.add(
+        "terrain geometry pool",
+        [this]()
+        {
+            // three vec3 arrays plus 16-bit indices per pooled geometry;
+            // informational only, since the process-memory registration
+            // above already sweeps the pool under pressure.
+            std::size_t verts = (std::size_t)settings.tileSize * (std::size_t)settings.tileSize;
+            return geometryPool.size() * verts * (9 * sizeof(float) + 6 * sizeof(std::uint16_t));
+        });
 }
 
 
@@ -72,11 +116,17 @@ TerrainEngine::createTile(const TileKey& key, vsg::ref_ptr<TerrainTileNode> pare
     // update the bounding sphere for culling
     tile->bound = tile->surface->recomputeBound();
 
+    // skirt length scales with the tile's radius, applied in the vertex
+    // shader so it can vary per LOD without regenerating pooled geometry
+    tile->renderModel.skirtHeight = settings.skirtRatio * (float)tile->bound.radius;
+
     // Generate its state objects:
     tile->renderModel = stateFactory.updateRenderModel(tile->renderModel, {}, context);
 
-    // install the bind command.
-    tile->stategroup->add(tile->renderModel.descriptors.bind);
+    // install the bind commands. The texture bind may be shared with the
+    // parent; the uniform bind is always this tile's own.
+    tile->stategroup->add(tile->renderModel.descriptors.bindTextures);
+    tile->stategroup->add(tile->renderModel.descriptors.bindUniforms);
 
     return tile;
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <rocky/vsg/terrain/TerrainSettings.h>
 #include <rocky/vsg/terrain/GeometryPool.h>
 #include <rocky/vsg/terrain/TerrainState.h>
+#include <rocky/vsg/terrain/TerrainPicker.h>
 #include <rocky/vsg/terrain/TerrainTilePager.h>
 
 namespace ROCKY_NAMESPACE
@@ -53,6 +54,9 @@ namespace ROCKY_NAMESPACE
         //! Creates the state group objects for terrain rendering
         TerrainState stateFactory;
 
+        //! Casts rays against the resident tiles' proxy meshes
+        TerrainPicker picker;
+
         //! name of job arena used to load data
         std::string loadSchedulerName = "rocky::terrain_loader";
 
@@ -60,5 +64,14 @@ namespace ROCKY_NAMESPACE
         vsg::ref_ptr<TerrainTileNode> createTile(
             const TileKey& key,
             vsg::ref_ptr<TerrainTileNode> parent);
+
+    private:
+        // keep the terrain caches registered with the memory governor
+        std::shared_ptr<MemoryGovernor::Registration> _geometryPoolMemoryReg;
+        std::shared_ptr<MemoryGovernor::Registration> _tilesMemoryReg;
+
+        // and the terrain's device memory with the GPU memory governor
+        std::shared_ptr<GPUMemoryGovernor::Registration> _tileTexturesGpuReg;
+        std::shared_ptr<GPUMemoryGovernor::Registration> _geometryPoolGpuReg;
     };
 }
@@ -11,6 +11,9 @@
 #include <rocky/IOTypes.h>
 #include <rocky/Map.h>
 #include <rocky/TileKey.h>
+#include <rocky/TerrainTileModelFactory.h>
+
+#include <thread>
 
 #include <vsg/all.h>
 
@@ -135,7 +138,12 @@ TerrainNode::update(VSGContext context)
 
             if (engine->tiles.update(context->viewer->getFrameStamp(), context->io, engine))
                 changes = true;
-            
+
+            // push any layer opacity/visibility changes into the shared
+            // uniform buffer (a single write; no tile state rebuilds)
+            if (engine->stateFactory.updateLayerControls(map.get(), context))
+                changes = true;
+
             engine->geometryPool.sweep(engine->context);
         }
     }
@@ -143,6 +151,97 @@ TerrainNode::update(VSGContext context)
     return changes;
 }
 
+jobs::future<bool>
+TerrainNode::seed(const GeoExtent& extent, unsigned minLevel, unsigned maxLevel, const IOOptions& io, SeedProgress::Ptr progress) const
+{
+    jobs::future<bool> promise;
+
+    ROCKY_SOFT_ASSERT_AND_RETURN(map && profile.valid(), promise);
+    ROCKY_SOFT_ASSERT_AND_RETURN(extent.valid() && minLevel <= maxLevel, promise);
+
+    // enumerate every key touching the AOI at each level:
+    TileKey::Vector keys;
+    for (unsigned lod = minLevel; lod <= maxLevel; ++lod)
+    {
+        TileKey::getIntersectingKeys(extent, lod, profile, keys);
+    }
+
+    if (keys.empty())
+    {
+        promise.resolve(true);
+        return promise;
+    }
+
+    if (progress)
+        progress->total = (unsigned)keys.size();
+
+    // Seeding runs on its own pool sized to the machine, so a bulk
+    // pre-warm can saturate the cores without crowding the interactive
+    // loader pool's priority queue.
+    auto pool = jobs::get_pool("rocky::terrain_seeder");
+    pool->set_concurrency(std::max(2u, std::thread::hardware_concurrency()));
+
+    // the last key to finish resolves the future.
+    struct InFlight
+    {
+        std::atomic_int remaining;
+        std::atomic_bool canceled = { false };
+    };
+    auto inflight = std::make_shared<InFlight>();
+    inflight->remaining = (int)keys.size();
+
+    auto map = this->map;
+    bool discardFlat = this->discardFlatElevation;
+    std::string cachePath = this->tileCachePath;
+
+    for (auto& key : keys)
+    {
+        const IOOptions local_io(io);
+
+        auto seed_one = [key, map, discardFlat, cachePath, inflight, progress, promise, local_io](Cancelable& c) mutable
+            {
+                if (c.canceled() || (progress && progress->canceled))
+                {
+                    inflight->canceled = true;
+                }
+
+                if (!inflight->canceled)
+                {
+                    // loading the model pulls every layer's data for this
+                    // key through its caches; the result itself is discarded.
+                    TerrainTileModelFactory factory;
+                    factory.compositeColorLayers = true;
+                    factory.discardFlatHeightfields = discardFlat;
+                    factory.diskCachePath = cachePath;
+
+                    factory.createTileModel(map.get(), key, {}, IOOptions(local_io, c));
+                }
+
+                if (progress)
+                    progress->completed++;
+
+                if (--inflight->remaining == 0)
+                    promise.resolve(!inflight->canceled);
+
+                return true;
+            };
+
+        // seed shallow levels first so coarse coverage lands before detail.
+        // can_cancel must be false since we discard the per-job futures.
+        jobs::dispatch(
+            seed_one,
+            jobs::context {
+                "seed " + key.str(),
+                pool,
+                [level = key.level]() { return -(float)level; },
+                nullptr,
+                false
+            });
+    }
+
+    return promise;
+}
+
 void
 TerrainNode::ping(TerrainTileNode* tile, const TerrainTileNode* parent, vsg::RecordTraversal& nv)
 {
@@ -11,6 +11,7 @@
 #include <rocky/Status.h>
 #include <rocky/Profile.h>
 #include <vsg/nodes/Group.h>
+#include <atomic>
 
 namespace ROCKY_NAMESPACE
 {
@@ -46,6 +47,31 @@ namespace ROCKY_NAMESPACE
         //! @return true if any updates were applied
         bool update(VSGContext context);
 
+        //! Live progress of a seed() pre-warming run. Poll the counters
+        //! from any thread; set "canceled" to abandon the remaining work.
+        struct SeedProgress
+        {
+            using Ptr = std::shared_ptr<SeedProgress>;
+            std::atomic<unsigned> total = { 0u };
+            std::atomic<unsigned> completed = { 0u };
+            std::atomic<bool> canceled = { false };
+        };
+
+        //! Pre-warms the terrain data caches over an area of interest so
+        //! its tiles page in from cache instead of raw I/O when a camera
+        //! first visits. Enumerates every tile key intersecting "extent"
+        //! from minLevel through maxLevel and pulls each key's full data
+        //! model through the map's layers on a dedicated job pool sized
+        //! to the machine. The returned future resolves true when the run
+        //! completes (false if canceled); pass a SeedProgress to watch or
+        //! abort it. Call any time after setMap().
+        jobs::future<bool> seed(
+            const GeoExtent& extent,
+            unsigned minLevel,
+            unsigned maxLevel,
+            const IOOptions& io,
+            SeedProgress::Ptr progress = nullptr) const;
+
         //! Status of this node; check that's it OK before using
         Status status;
 
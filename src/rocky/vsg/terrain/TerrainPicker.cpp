@@ -0,0 +1,349 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#include "TerrainPicker.h"
+#include "GeometryPool.h"
+#include <rocky/vsg/Utils.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <functional>
+#include <numeric>
+
+using namespace ROCKY_NAMESPACE;
+
+#define LC "[TerrainPicker] "
+
+namespace
+{
+    // slab test against an axis-aligned box; invdir may hold infinities
+    // for axis-parallel rays, which the comparisons handle.
+    bool intersectsBox(const vsg::dvec3& origin, const vsg::dvec3& invdir, const vsg::dbox& box)
+    {
+        double t0 = 0.0, t1 = DBL_MAX;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            double tn = (box.min[axis] - origin[axis]) * invdir[axis];
+            double tf = (box.max[axis] - origin[axis]) * invdir[axis];
+            if (tn > tf)
+                std::swap(tn, tf);
+            t0 = std::max(t0, tn);
+            t1 = std::min(t1, tf);
+            if (t0 > t1)
+                return false;
+        }
+        return true;
+    }
+
+    // Moller-Trumbore, in tile-local coordinates
+    bool intersectsTriangle(
+        const vsg::dvec3& origin, const vsg::dvec3& dir,
+        const vsg::vec3& a, const vsg::vec3& b, const vsg::vec3& c,
+        double& t)
+    {
+        constexpr double EPSILON = 1e-9;
+
+        vsg::dvec3 A(a.x, a.y, a.z), B(b.x, b.y, b.z), C(c.x, c.y, c.z);
+        auto e1 = B - A;
+        auto e2 = C - A;
+
+        auto p = vsg::cross(dir, e2);
+        double det = vsg::dot(e1, p);
+        if (std::abs(det) < EPSILON)
+            return false; // parallel to the triangle plane
+
+        double inv_det = 1.0 / det;
+        auto s = origin - A;
+        double u = vsg::dot(s, p) * inv_det;
+        if (u < 0.0 || u > 1.0)
+            return false;
+
+        auto q = vsg::cross(s, e1);
+        double v = vsg::dot(dir, q) * inv_det;
+        if (v < 0.0 || u + v > 1.0)
+            return false;
+
+        double tt = vsg::dot(e2, q) * inv_det;
+        if (tt < 0.0)
+            return false; // behind the origin
+
+        t = tt;
+        return true;
+    }
+}
+
+void
+TerrainPicker::updateTile(const TileKey& key, vsg::ref_ptr<SurfaceNode> surface)
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(surface && !surface->children.empty(), void());
+
+    // the shared geometry lives where recomputeBound() finds it:
+    auto geom = static_cast<vsg::Group*>(surface->children.front().get())->children.front()->cast<SharedGeometry>();
+    ROCKY_SOFT_ASSERT_AND_RETURN(geom && geom->proxy_indices && geom->proxy_uvs, void());
+
+    auto& mesh = surface->proxyMesh();
+    if (mesh.empty())
+        return;
+
+    auto leaf = std::make_shared<Leaf>();
+    leaf->key = key;
+    leaf->matrix = surface->matrix;
+    leaf->inverse = vsg::inverse(surface->matrix);
+    leaf->verts = mesh;
+
+    // copy the triangles, skipping skirts; a skirt hit would report a
+    // point hanging below the tile edge instead of on the surface.
+    auto& indices = *geom->proxy_indices;
+    auto& uvs = *geom->proxy_uvs;
+    leaf->indices.reserve(indices.size());
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        auto i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+        if ((((int)uvs[i0].z | (int)uvs[i1].z | (int)uvs[i2].z) & VERTEX_SKIRT) != 0)
+            continue;
+
+        leaf->indices.insert(leaf->indices.end(), { i0, i1, i2 });
+    }
+
+    // world-space bound from the local bbox corners:
+    auto& b = surface->localbbox;
+    for (int i = 0; i < 8; ++i)
+    {
+        leaf->worldBound.add(leaf->matrix * vsg::dvec3(
+            (i & 0x1) ? b.max.x : b.min.x,
+            (i & 0x2) ? b.max.y : b.min.y,
+            (i & 0x4) ? b.max.z : b.min.z));
+    }
+
+    std::scoped_lock lock(_mutex);
+    _leaves[key] = std::move(leaf);
+    _dirty = true;
+    ++_revision;
+}
+
+void
+TerrainPicker::removeTile(const TileKey& key)
+{
+    std::scoped_lock lock(_mutex);
+    if (_leaves.erase(key) > 0)
+    {
+        _dirty = true;
+        ++_revision;
+    }
+}
+
+std::size_t
+TerrainPicker::size() const
+{
+    std::scoped_lock lock(_mutex);
+    return _leaves.size();
+}
+
+std::shared_ptr<const TerrainPicker::Index>
+TerrainPicker::snapshot() const
+{
+    std::scoped_lock lock(_mutex);
+
+    if (!_index || _dirty)
+    {
+        auto index = std::make_shared<Index>();
+        index->leaves.reserve(_leaves.size());
+        for (auto& [key, leaf] : _leaves)
+            index->leaves.push_back(leaf);
+
+        if (!index->leaves.empty())
+        {
+            index->nodes.reserve(index->leaves.size() * 2);
+
+            std::vector<std::int32_t> order(index->leaves.size());
+            std::iota(order.begin(), order.end(), 0);
+
+            // recursive median split over the leaf bounds. A full rebuild
+            // on change is cheap relative to the merges that trigger it -
+            // a few thousand resident tiles sort in well under a
+            // millisecond, and it happens at most once per query burst.
+            std::function<std::int32_t(std::size_t, std::size_t)> build =
+                [&](std::size_t begin, std::size_t end) -> std::int32_t
+            {
+                auto n = (std::int32_t)index->nodes.size();
+                index->nodes.emplace_back();
+
+                vsg::dbox bound;
+                for (auto i = begin; i < end; ++i)
+                {
+                    bound.add(index->leaves[order[i]]->worldBound.min);
+                    bound.add(index->leaves[order[i]]->worldBound.max);
+                }
+                index->nodes[n].bound = bound;
+
+                if (end - begin == 1)
+                {
+                    index->nodes[n].leaf = order[begin];
+                }
+                else
+                {
+                    // partition at the median along the widest axis:
+                    auto extent = bound.max - bound.min;
+                    int axis =
+                        extent.x > extent.y ?
+                        (extent.x > extent.z ? 0 : 2) :
+                        (extent.y > extent.z ? 1 : 2);
+
+                    auto mid = begin + (end - begin) / 2;
+                    std::nth_element(
+                        order.begin() + begin, order.begin() + mid, order.begin() + end,
+                        [&](std::int32_t lhs, std::int32_t rhs)
+                        {
+                            auto& lb = index->leaves[lhs]->worldBound;
+                            auto& rb = index->leaves[rhs]->worldBound;
+                            return (lb.min[axis] + lb.max[axis]) < (rb.min[axis] + rb.max[axis]);
+                        });
+
+                    auto left = build(begin, mid);
+                    auto right = build(mid, end);
+                    index->nodes[n].left = left;
+                    index->nodes[n].right = right;
+                }
+
+                return n;
+            };
+
+            build(0, index->leaves.size());
+        }
+
+        _index = index;
+        _dirty = false;
+    }
+
+    return _index;
+}
+
+void
+TerrainPicker::Index::intersect(const Ray& ray, Hit& best) const
+{
+    best = {};
+
+    if (nodes.empty())
+        return;
+
+    double dirlen = glm::length(ray.direction);
+    if (!(dirlen > 0.0))
+        return;
+
+    auto& origin = to_vsg(ray.origin);
+    auto& dir = to_vsg(ray.direction);
+    vsg::dvec3 invdir(1.0 / dir.x, 1.0 / dir.y, 1.0 / dir.z);
+
+    // the nearest hit in each tile the ray touches:
+    std::vector<Hit> candidates;
+
+    std::vector<std::int32_t> stack{ 0 };
+    while (!stack.empty())
+    {
+        auto& node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!intersectsBox(origin, invdir, node.bound))
+            continue;
+
+        if (node.leaf < 0)
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        auto& leaf = *leaves[node.leaf];
+
+        // cast in tile-local coordinates; the tile matrix is rigid, so
+        // ray parameters carry back to world space unchanged.
+        auto local_origin = leaf.inverse * origin;
+        auto d = leaf.inverse * vsg::dvec4(dir.x, dir.y, dir.z, 0.0);
+        vsg::dvec3 local_dir(d.x, d.y, d.z);
+
+        double nearest = DBL_MAX;
+        for (std::size_t i = 0; i + 2 < leaf.indices.size(); i += 3)
+        {
+            double t;
+            if (intersectsTriangle(local_origin, local_dir,
+                leaf.verts[leaf.indices[i]],
+                leaf.verts[leaf.indices[i + 1]],
+                leaf.verts[leaf.indices[i + 2]],
+                t))
+            {
+                nearest = std::min(nearest, t);
+            }
+        }
+
+        if (nearest < DBL_MAX)
+        {
+            Hit hit;
+            hit.point = ray.origin + ray.direction * nearest;
+            hit.distance = nearest * dirlen;
+            hit.key = leaf.key;
+            candidates.emplace_back(std::move(hit));
+        }
+    }
+
+    // Where a tile and a resident descendant both hit, the descendant
+    // re-models the same surface at finer resolution, so drop the
+    // coarser hit. The nearest survivor wins.
+    for (auto& hit : candidates)
+    {
+        bool refined = false;
+        for (auto& other : candidates)
+        {
+            if (other.key.level > hit.key.level &&
+                other.key.createAncestorKey(hit.key.level) == hit.key)
+            {
+                refined = true;
+                break;
+            }
+        }
+
+        if (!refined && (!best.valid() || hit.distance < best.distance))
+        {
+            best = hit;
+        }
+    }
+}
+
+TerrainPicker::Hit
+TerrainPicker::intersect(const Ray& ray) const
+{
+    Hit best;
+    snapshot()->intersect(ray, best);
+    return best;
+}
+
+jobs::future<std::vector<TerrainPicker::Hit>>
+TerrainPicker::intersectBatch(std::vector<Ray> rays) const
+{
+    if (rays.empty())
+    {
+        jobs::future<std::vector<Hit>> empty;
+        empty.resolve(std::vector<Hit>());
+        return empty;
+    }
+
+    // capture the snapshot here so the job needs no reference back to
+    // the picker (and no lock) while it runs.
+    auto index = snapshot();
+
+    auto task = [index, rays(std::move(rays))](jobs::cancelable& cancelable) -> std::vector<Hit>
+    {
+        std::vector<Hit> hits(rays.size());
+        for (std::size_t i = 0; i < rays.size() && !cancelable.canceled(); ++i)
+        {
+            index->intersect(rays[i], hits[i]);
+        }
+        return hits;
+    };
+
+    jobs::context job_context;
+    job_context.name = "rocky::terrain_picker";
+
+    return jobs::dispatch(task, job_context);
+}
@@ -0,0 +1,131 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ */
+#pragma once
+
+#include <rocky/vsg/Common.h>
+#include <rocky/vsg/terrain/SurfaceNode.h>
+#include <rocky/TileKey.h>
+#include <rocky/weejobs.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ROCKY_NAMESPACE
+{
+    /**
+     * Intersects world-space rays with the resident terrain.
+     *
+     * The picker keeps a record of each resident tile's proxy mesh (the
+     * same elevation-displaced grid that SurfaceNode builds for its
+     * bounds) plus a bounding-volume hierarchy over the tile bounds.
+     * TerrainTilePager maintains it incrementally: a tile's record
+     * refreshes when its data merges and drops when the tile expires, so
+     * queries always see the loaded resolution without sampling
+     * heightfields tile by tile.
+     *
+     * Queries are thread-safe and run against an immutable snapshot of
+     * the hierarchy, so they never contend with the update thread. The
+     * batched overload dispatches to the jobs system, letting a caller
+     * fan out thousands of rays at once instead of burning a core
+     * casting them one at a time.
+     */
+    class TerrainPicker
+    {
+    public:
+        //! A world-space (geocentric) ray to cast at the terrain
+        struct Ray
+        {
+            glm::dvec3 origin;
+            glm::dvec3 direction; // need not be normalized
+        };
+
+        //! Result of a single ray query
+        struct Hit
+        {
+            glm::dvec3 point = { 0.0, 0.0, 0.0 }; // world-space intersection
+            double distance = -1.0; // from the origin, in world units
+            TileKey key;            // tile that produced the hit
+
+            //! True if the ray struck the terrain
+            bool valid() const {
+                return distance >= 0.0;
+            }
+        };
+
+        //! Intersect one ray with the terrain, synchronously. Where a
+        //! tile and its subtiles are both resident, the deepest tile
+        //! covering the hit wins since it carries the finest data.
+        Hit intersect(const Ray& ray) const;
+
+        //! Intersect a batch of rays on the jobs system. Results appear
+        //! in the same order as the input rays, and the whole batch runs
+        //! against the snapshot current at call time.
+        jobs::future<std::vector<Hit>> intersectBatch(std::vector<Ray> rays) const;
+
+        //! Number of tiles in the hierarchy
+        std::size_t size() const;
+
+        //! Revision of the resident terrain data; bumps whenever a tile
+        //! record merges or expires. Services that derive state from the
+        //! terrain (like clamping) can poll this to re-query only when
+        //! the data actually changed.
+        int revision() const {
+            return _revision;
+        }
+
+
+        // Maintenance. TerrainTilePager calls these on the update thread.
+
+        //! Add or refresh the record for a tile whose data merged
+        void updateTile(const TileKey& key, vsg::ref_ptr<SurfaceNode> surface);
+
+        //! Drop the record for an expired tile
+        void removeTile(const TileKey& key);
+
+    private:
+        // One resident tile: its displaced grid in tile-local
+        // coordinates plus the transforms to and from world space.
+        // Immutable once built; an update replaces the whole record.
+        struct Leaf
+        {
+            TileKey key;
+            vsg::dmat4 matrix;  // tile-local -> world
+            vsg::dmat4 inverse; // world -> tile-local
+            vsg::dbox worldBound;
+            std::vector<vsg::vec3> verts;       // local, elevation applied
+            std::vector<std::uint32_t> indices; // skirt-free triangles
+        };
+
+        // Flattened hierarchy over the leaf world bounds, rebuilt lazily
+        // on the first query after a change. Snapshots are immutable and
+        // shared, so traversals never hold the lock.
+        struct Node
+        {
+            vsg::dbox bound;
+            std::int32_t left = -1, right = -1; // interior children
+            std::int32_t leaf = -1;             // leaf index, if terminal
+        };
+
+        struct Index
+        {
+            std::vector<Node> nodes;
+            std::vector<std::shared_ptr<const Leaf>> leaves;
+
+            void intersect(const Ray& ray, Hit& best) const;
+        };
+
+        //! Current index, rebuilding it first if leaves changed
+        std::shared_ptr<const Index> snapshot() const;
+
+        mutable std::mutex _mutex;
+        std::atomic<int> _revision = { 0 };
+        std::map<TileKey, std::shared_ptr<const Leaf>> _leaves;
+        mutable std::shared_ptr<const Index> _index;
+        mutable bool _dirty = false;
+    };
+}
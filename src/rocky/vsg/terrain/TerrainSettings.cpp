@@ -22,6 +22,13 @@ TerrainSettings::from_json(const std::string& JSON)
     get_to(j, "skirt_ratio", skirtRatio);
     get_to(j, "color", color);
     get_to(j, "concurrency", concurrency);
+    get_to(j, "tile_cache_path", tileCachePath);
+    get_to(j, "discard_flat_elevation", discardFlatElevation);
+    get_to(j, "compress_color_textures", compressColorTextures);
+    get_to(j, "gpu_tessellation", gpuTessellation);
+    get_to(j, "detail_texturing", detailTexturing);
+    get_to(j, "merge_budget_ms", mergeBudgetMS);
+    get_to(j, "tile_load_timeout_ms", tileLoadTimeoutMS);
 
     return Status_OK;
 }
@@ -39,5 +46,12 @@ TerrainSettings::to_json() const
     set(j, "skirt_ratio", skirtRatio);
     set(j, "color", color);
     set(j, "concurrency", concurrency);
+    set(j, "tile_cache_path", tileCachePath);
+    set(j, "discard_flat_elevation", discardFlatElevation);
+    set(j, "compress_color_textures", compressColorTextures);
+    set(j, "gpu_tessellation", gpuTessellation);
+    set(j, "detail_texturing", detailTexturing);
+    set(j, "merge_budget_ms", mergeBudgetMS);
+    set(j, "tile_load_timeout_ms", tileLoadTimeoutMS);
     return j.dump();
 }
@@ -8,6 +8,7 @@
 #include <rocky/Color.h>
 #include <rocky/Status.h>
 #include <rocky/vsg/Common.h>
+#include <rocky/vsg/ViewLocal.h>
 
 namespace ROCKY_NAMESPACE
 {
@@ -17,7 +18,9 @@ namespace ROCKY_NAMESPACE
     class TerrainSettings
     {
     public:
-        TerrainSettings() = default;
+        TerrainSettings() {
+            screenSpaceErrorScale.fill(1.0f);
+        }
 
         //! deserialize from JSON
         Status from_json(const std::string& JSON);
@@ -57,11 +60,69 @@ namespace ROCKY_NAMESPACE
         //! Number of threads dedicated to loading terrain data
         option<unsigned> concurrency = 4;
 
+        //! Optional folder for a persistent on-disk tile cache. When set,
+        //! composited tile models (imagery + elevation) are stored as raw
+        //! pixel data keyed by tile key and map revision, so subsequent
+        //! runs page tiles from disk instead of recomputing them from the
+        //! source layers. Empty (the default) disables the cache.
+        option<std::string> tileCachePath = {};
+
+        //! When true, discard loaded heightfields that are entirely at zero
+        //! elevation (e.g. open ocean). Such tiles render identically with
+        //! the default flat elevation and skip the texture upload and
+        //! bounds recomputation, which adds up in mostly-ocean views.
+        option<bool> discardFlatElevation = false;
+
+        //! When true, transcode each tile's color texture to a
+        //! BC-compressed format (BC1 for RGB, BC3 for RGBA) on the load
+        //! job before upload. A quarter of the device memory and transfer
+        //! bandwidth of uncompressed RGBA8, at the cost of some encode
+        //! time per tile and BC-class quality. Dynamic (region-updating)
+        //! images stay uncompressed.
+        option<bool> compressColorTextures = false;
+
+        //! When true, render terrain through a tessellation-shader
+        //! pipeline that subdivides each triangle per-edge by its apparent
+        //! size on screen: silhouettes and near terrain get more detail,
+        //! flat interiors less, without paging finer tile LODs. Matching
+        //! per-edge levels keep shared edges crack-free within a tile.
+        //! Requires a device with the tessellationShader feature enabled;
+        //! falls back to the fixed-grid path otherwise.
+        option<bool> gpuTessellation = false;
+
+        //! When true, apply procedural detail texturing to close-range
+        //! terrain in the fragment shader: tiling detail noise blended
+        //! by a coarse land-cover classification of the composited
+        //! imagery, fading out with distance. Adds visual density up
+        //! close without paging finer image LODs - the detail is
+        //! generated per fragment, so it costs no tile loads, no memory,
+        //! and no bandwidth.
+        option<bool> detailTexturing = false;
+
+        //! Maximum time (in milliseconds) to spend merging loaded tile data
+        //! into the scene graph each frame. Merges that don't make the cut
+        //! stay queued (in screen-space priority order) for a later frame,
+        //! amortizing the cost across frames instead of spiking when a whole
+        //! subtree finishes loading at once.
+        option<float> mergeBudgetMS = 2.0f;
+
+        //! Maximum time (in milliseconds) a tile-load job may spend before
+        //! its IO is canceled at the next stage boundary. Bounds the time
+        //! any loader thread can be held by a hung network read; the pager
+        //! re-requests timed-out tiles as long as they stay in view.
+        //! Zero (the default) means no limit.
+        option<unsigned> tileLoadTimeoutMS = 0u;
+
     public: // internal runtime settings, not serialized.
 
         //! TEMPORARY.
         //! To deal with multi-threaded Record (b/c of multiple command graphs)
         //! without using an unnecessary lock in the single-threaded case
         bool supportMultiThreadedRecord = false;
+
+        //! Per-view multiplier on screenSpaceError, indexed by viewID.
+        //! An overview or inset view can raise its entry to page coarser
+        //! LODs than the main view without affecting it.
+        detail::ViewLocal<float> screenSpaceErrorScale;
     };
 }
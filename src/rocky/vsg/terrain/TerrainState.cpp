@@ -5,17 +5,27 @@
  */
 #include "TerrainState.h"
 #include "TerrainTileNode.h"
+#include "../ShadowMapNode.h"
 #include "../Utils.h"
+#include "../NativeImage.h"
 #include "../PipelineState.h"
+#include "../TextureCompression.h"
 
 #include <rocky/Color.h>
 #include <rocky/Heightfield.h>
 #include <rocky/Image.h>
+#include <rocky/ImageLayer.h>
+#include <rocky/Map.h>
+#include <rocky/TimeSeriesImageLayer.h>
 
 #include <vsg/state/BindDescriptorSet.h>
 #include <vsg/state/ViewDependentState.h>
 
+#define LC "[TerrainState] "
+
 #define TERRAIN_VERT_SHADER "shaders/rocky.terrain.vert"
+#define TERRAIN_TESC_SHADER "shaders/rocky.terrain.tesc"
+#define TERRAIN_TESE_SHADER "shaders/rocky.terrain.tese"
 #define TERRAIN_FRAG_SHADER "shaders/rocky.terrain.frag"
 
 #define ELEVATION_TEX_NAME "elevation_tex"
@@ -24,12 +34,36 @@
 #define COLOR_TEX_NAME "color_tex"
 #define COLOR_TEX_BINDING 11
 
+#define COLOR_FRAMES_TEX_NAME "color_frames_tex"
+#define COLOR_FRAMES_TEX_BINDING 15
+
 #define NORMAL_TEX_NAME "normal_tex"
 #define NORMAL_TEX_BINDING 12
 
 #define TILE_BUFFER_NAME "tile"
 #define TILE_BUFFER_BINDING 13
 
+#define LAYER_BUFFER_NAME "layers"
+#define LAYER_BUFFER_BINDING 14
+#define MAX_LAYER_CONTROLS 16
+
+// cascaded shadow maps, bound map-wide alongside the layer controls when
+// a ShadowMapNode publishes them (see VSGContext::shadowMaps)
+#define SHADOW_BUFFER_NAME "shadow"
+#define SHADOW_BUFFER_BINDING 16
+#define SHADOW_MAPS_NAME "shadow_map"
+#define SHADOW_MAPS_BINDING 17
+
+// textures live in their own set so tiles that borrow an ancestor's
+// imagery can share one compiled descriptor set; the per-tile uniform
+// buffer gets a separate set. (set 1 is vsg's view-dependent state.)
+#define TEXTURE_SET 0
+#define TILE_BUFFER_SET 2
+
+// map-wide layer controls (opacity, visibility) bound once in the
+// terrain state group; see updateLayerControls.
+#define LAYER_BUFFER_SET 3
+
 #define ATTR_VERTEX "in_vertex"
 #define ATTR_NORMAL "in_normal"
 #define ATTR_UV "in_uvw"
@@ -46,7 +80,8 @@ TerrainState::TerrainState(VSGContext& context)
     createDefaultDescriptors(context);
 
     // shader set prototype for use with a GraphicsPipelineConfig.
-    shaderSet = createShaderSet(context);
+    shaderSet = context->getOrCreateShaderSet("rocky.terrain",
+        [&]() { return createShaderSet(context); });
     if (!shaderSet)
     {
         status = Status(Status::ResourceUnavailable,
@@ -79,6 +114,9 @@ TerrainState::createDefaultDescriptors(VSGContext& context)
     if (context->sharedObjects)
         context->sharedObjects->share(texturedefs.color.sampler);
 
+    // time-series color slices share the color sampler:
+    texturedefs.colorFrames = { COLOR_FRAMES_TEX_NAME, COLOR_FRAMES_TEX_BINDING, texturedefs.color.sampler, {} };
+
     texturedefs.elevation = { ELEVATION_TEX_NAME, ELEVATION_TEX_BINDING, vsg::Sampler::create(), {} };
     texturedefs.elevation.sampler->maxLod = 16;
     texturedefs.elevation.sampler->minFilter = VK_FILTER_LINEAR;
@@ -111,6 +149,22 @@ TerrainState::createDefaultDescriptors(VSGContext& context)
         0, // array element (TODO: increment when we change to an array)
         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
+    // time-series placeholder: a 1-slice array so the binding is always
+    // satisfied. The shader only reads it when tile_params.z says the
+    // tile actually carries timestep data.
+    auto frames_data = vsg::ubvec4Array3D::create(
+        1, 1, 1,
+        vsg::ubvec4(255, 255, 255, 255),
+        vsg::Data::Properties(VK_FORMAT_R8G8B8A8_UNORM));
+    frames_data->properties.imageViewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    texturedefs.colorFrames.defaultData = frames_data;
+    this->defaultTileDescriptors.colorFrames = vsg::DescriptorImage::create(
+        texturedefs.colorFrames.sampler,
+        texturedefs.colorFrames.defaultData,
+        texturedefs.colorFrames.uniform_binding,
+        0, // array element
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
     auto elev_image = Heightfield::create(1, 1);
     elev_image->fill(0.0f);
     texturedefs.elevation.defaultData = util::moveImageToVSG(elev_image);
@@ -174,6 +228,36 @@ TerrainState::createShaderSet(VSGContext& context) const
 
     vsg::ShaderStages shaderStages{ vertexShader, fragmentShader };
 
+    // stages that need the tile uniforms, push constants, and elevation
+    // texture; the tessellation stages join in when that path is active.
+    VkShaderStageFlags vertexStages = VK_SHADER_STAGE_VERTEX_BIT;
+
+    if (gpuTessellation)
+    {
+        auto tessControlShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+            "main",
+            vsg::findFile(TERRAIN_TESC_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        auto tessEvalShader = vsg::ShaderStage::read(
+            VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+            "main",
+            vsg::findFile(TERRAIN_TESE_SHADER, context->searchPaths),
+            context->readerWriterOptions);
+
+        if (!tessControlShader || !tessEvalShader)
+        {
+            return { };
+        }
+
+        shaderStages = { vertexShader, tessControlShader, tessEvalShader, fragmentShader };
+
+        vertexStages |=
+            VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT |
+            VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    }
+
     shaderSet = vsg::ShaderSet::create(shaderStages);
 
     // "binding" (3rd param) must match "layout(location=X) in" in the vertex shader
@@ -184,16 +268,20 @@ TerrainState::createShaderSet(VSGContext& context) const
     //shaderSet->addAttributeBinding(ATTR_NORMAL_NEIGHBOR, "", 4, VK_FORMAT_R32G32B32A32_SFLOAT, vsg::vec3Array::create(1));
 
     // "binding" (4th param) must match "layout(location=X) uniform" in the shader
-    shaderSet->addDescriptorBinding(texturedefs.elevation.name, "", 0, texturedefs.elevation.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_VERTEX_BIT, {});
+    shaderSet->addDescriptorBinding(texturedefs.elevation.name, "", 0, texturedefs.elevation.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, vertexStages, {});
     shaderSet->addDescriptorBinding(texturedefs.color.name, "", 0, texturedefs.color.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
+    shaderSet->addDescriptorBinding(texturedefs.colorFrames.name, "", 0, texturedefs.colorFrames.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
     //shaderSet->addDescriptorBinding(texturedefs.normal.name, "", 0, texturedefs.normal.uniform_binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
-    shaderSet->addDescriptorBinding(TILE_BUFFER_NAME, "", 0, TILE_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, {});
-    
+    shaderSet->addDescriptorBinding(TILE_BUFFER_NAME, "", TILE_BUFFER_SET, TILE_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, vertexStages | VK_SHADER_STAGE_FRAGMENT_BIT, {});
+    shaderSet->addDescriptorBinding(LAYER_BUFFER_NAME, "", LAYER_BUFFER_SET, LAYER_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
+    shaderSet->addDescriptorBinding(SHADOW_BUFFER_NAME, "", LAYER_BUFFER_SET, SHADOW_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, {});
+    shaderSet->addDescriptorBinding(SHADOW_MAPS_NAME, "", LAYER_BUFFER_SET, SHADOW_MAPS_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, ShadowMapNode::NUM_CASCADES, VK_SHADER_STAGE_FRAGMENT_BIT, {});
+
     PipelineUtils::addViewDependentData(shaderSet, VK_SHADER_STAGE_FRAGMENT_BIT);
 
-    // Note: 128 is the maximum size required by the Vulkan spec, 
+    // Note: 128 is the maximum size required by the Vulkan spec,
     // so don't increase it :)
-    shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+    shaderSet->addPushConstantRange("pc", "", vertexStages, 0, 128);
 
     return shaderSet;
 }
@@ -219,12 +307,60 @@ TerrainState::createPipelineConfig(VSGContext& context) const
     // activate the descriptors we intend to use
     config->enableTexture(texturedefs.elevation.name);
     config->enableTexture(texturedefs.color.name);
+    config->enableTexture(texturedefs.colorFrames.name);
     //config->enableTexture(texturedefs.normal.name);
 
     config->enableDescriptor(TILE_BUFFER_NAME);
+    config->enableDescriptor(LAYER_BUFFER_NAME);
+
+    // shadow resources exist when a ShadowMapNode is installed:
+    bool shadows = context->shadowData.valid() && !context->shadowMaps.empty();
+    if (shadows)
+    {
+        config->enableDescriptor(SHADOW_BUFFER_NAME);
+        config->enableTexture(SHADOW_MAPS_NAME);
+    }
 
     PipelineUtils::enableViewDependentData(config);
 
+    if (gpuTessellation || detailTexturing || shadows)
+    {
+        // clone the compile settings so the terrain-only defines stay
+        // local to the terrain pipeline:
+        config->shaderHints = context->shaderCompileSettings ?
+            vsg::ShaderCompileSettings::create(*context->shaderCompileSettings) :
+            vsg::ShaderCompileSettings::create();
+    }
+
+    if (shadows)
+    {
+        config->shaderHints->defines.insert("ROCKY_SHADOWS");
+    }
+
+    if (detailTexturing)
+    {
+        config->shaderHints->defines.insert("ROCKY_DETAIL_TEXTURING");
+    }
+
+    if (gpuTessellation)
+    {
+        config->shaderHints->defines.insert("ROCKY_TESSELLATE");
+
+        // terrain triangles feed the tessellator as 3-point patches:
+        struct SetPipelineStates : public vsg::Visitor
+        {
+            void apply(vsg::Object& object) override {
+                object.traverse(*this);
+            }
+            void apply(vsg::InputAssemblyState& state) override {
+                state.topology = VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+            }
+        };
+        vsg::visit<SetPipelineStates>(config);
+
+        config->pipelineStates.push_back(vsg::TessellationState::create(3));
+    }
+
     // Initialize GraphicsPipeline from the data in the configuration.
     if (context->sharedObjects)
         context->sharedObjects->share(config, [](auto gpc) { gpc->init(); });
@@ -239,6 +375,33 @@ TerrainState::createTerrainStateGroup(VSGContext& context)
 {
     ROCKY_SOFT_ASSERT_AND_RETURN(status.ok(), { });
 
+    // The adaptive tessellation path needs its own shader set (the extra
+    // stages) and a device that can run it; fall back to the fixed path
+    // when either is missing.
+    if (gpuTessellation)
+    {
+        auto device = context->device();
+        if (device && device->getPhysicalDevice()->getFeatures().tessellationShader == VK_FALSE)
+        {
+            Log()->warn(LC "GPU tessellation requested, but the device does not support it");
+            gpuTessellation = false;
+        }
+        else
+        {
+            auto tessShaderSet = context->getOrCreateShaderSet("rocky.terrain.tess",
+                [&]() { return createShaderSet(context); });
+            if (tessShaderSet)
+            {
+                shaderSet = tessShaderSet;
+            }
+            else
+            {
+                Log()->warn(LC "Terrain tessellation shaders are missing or corrupt");
+                gpuTessellation = false;
+            }
+        }
+    }
+
     // create the configurator object:
     pipelineConfig = createPipelineConfig(context);
 
@@ -251,9 +414,101 @@ TerrainState::createTerrainStateGroup(VSGContext& context)
     stateGroup->add(pipelineConfig->bindGraphicsPipeline);
     stateGroup->add(vsg::BindViewDescriptorSets::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineConfig->layout, VSG_VIEW_DEPENDENT_DESCRIPTOR_SET_INDEX));
 
+    // The layer-controls buffer binds once here for the whole map. It is
+    // dynamic data: updateLayerControls() rewrites it in place and a
+    // dirty() re-transfers it, with no per-tile descriptor work.
+    layerControls = vsg::vec4Array::create(MAX_LAYER_CONTROLS);
+    for (unsigned i = 0; i < MAX_LAYER_CONTROLS; ++i)
+        layerControls->set(i, vsg::vec4(1.0f, 1.0f, 0.0f, 0.0f));
+    layerControls->properties.dataVariance = vsg::DYNAMIC_DATA;
+
+    auto layerControlsBuffer = vsg::DescriptorBuffer::create(layerControls, LAYER_BUFFER_BINDING);
+
+    vsg::Descriptors mapWideDescriptors{ layerControlsBuffer };
+
+    // when a ShadowMapNode published cascade resources, they ride the same
+    // map-wide set; the cascade matrices are dynamic data that the shadow
+    // node rewrites as the camera and sun move.
+    if (context->shadowData.valid() && !context->shadowMaps.empty())
+    {
+        mapWideDescriptors.push_back(vsg::DescriptorBuffer::create(
+            context->shadowData, SHADOW_BUFFER_BINDING));
+
+        mapWideDescriptors.push_back(vsg::DescriptorImage::create(
+            context->shadowMaps, SHADOW_MAPS_BINDING, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER));
+    }
+
+    auto mapWideSet = vsg::DescriptorSet::create(
+        pipelineConfig->layout->setLayouts[LAYER_BUFFER_SET],
+        mapWideDescriptors);
+
+    stateGroup->add(vsg::BindDescriptorSet::create(
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipelineConfig->layout,
+        LAYER_BUFFER_SET,
+        mapWideSet));
+
     return stateGroup;
 }
 
+int
+TerrainState::controlIndexFor(UID uid) const
+{
+    std::scoped_lock L(_layerIndexMutex);
+
+    auto i = _layerIndex.find(uid);
+    if (i != _layerIndex.end())
+        return i->second;
+
+    if (_layerIndex.size() >= MAX_LAYER_CONTROLS)
+        return -1;
+
+    int index = (int)_layerIndex.size();
+    _layerIndex[uid] = index;
+    return index;
+}
+
+bool
+TerrainState::updateLayerControls(const Map* map, VSGContext& context)
+{
+    if (!map || !layerControls)
+        return false;
+
+    bool changed = false;
+
+    for (auto& layer : map->layers().ofType<ImageLayer>())
+    {
+        int index = controlIndexFor(layer->uid());
+        if (index < 0)
+            continue;
+
+        // a time-series layer drives its animation clock through the
+        // same buffer; one uniform write scrubs every resident tile.
+        float clock = 0.0f;
+        if (auto timeSeries = std::dynamic_pointer_cast<TimeSeriesImageLayer>(layer))
+            clock = timeSeries->framePosition();
+
+        vsg::vec4 controls(
+            layer->opacity.value(),
+            layer->visible.value() ? 1.0f : 0.0f,
+            clock, 0.0f);
+
+        if (layerControls->at(index) != controls)
+        {
+            layerControls->set(index, controls);
+            changed = true;
+        }
+    }
+
+    if (changed)
+    {
+        layerControls->dirty();
+        context->requestFrame();
+    }
+
+    return changed;
+}
+
 TerrainTileRenderModel
 TerrainState::updateRenderModel(
     const TerrainTileRenderModel& oldRenderModel,
@@ -267,36 +522,123 @@ TerrainState::updateRenderModel(
     TerrainTileRenderModel renderModel = oldRenderModel;
     TerrainTileDescriptors& descriptors = renderModel.descriptors;
 
+    // track what actually changes so we only rebuild those descriptors;
+    // anything untouched is carried over from the previous render model.
+    const glm::dmat4 oldColorMatrix = renderModel.color.matrix;
+    const glm::dmat4 oldElevationMatrix = renderModel.elevation.matrix;
+    bool colorChanged = false;
+    bool elevationChanged = false;
+
     if (dataModel.colorLayers.size() > 0 && dataModel.colorLayers[0].image.valid())
     {
         auto& layer = dataModel.colorLayers[0];
 
-        renderModel.color.name = "color " + layer.key.str();
-        renderModel.color.image = layer.image.image();
-        renderModel.color.matrix = layer.matrix;
+        if (descriptors.color &&
+            renderModel.color.image == layer.image.image() &&
+            renderModel.color.image->dynamic() &&
+            !renderModel.color.image->dirtyRegion().empty())
+        {
+            // partial refresh: the same image object is already bound and
+            // only a subregion changed. The texture shares the image's
+            // pixel buffer, so the new pixels are already in place; just
+            // queue a re-transfer instead of building and compiling a new
+            // descriptor.
+            for (auto& imageInfo : descriptors.color->imageInfoList)
+            {
+                if (imageInfo->imageView && imageInfo->imageView->image && imageInfo->imageView->image->data)
+                    imageInfo->imageView->image->data->dirty();
+            }
 
-        // TODO: evaluate this 'clone' operation...
-        auto data = util::wrapImageInVSG(renderModel.color.image); // ->clone());
-        //auto data = util::moveImageToVSG(renderModel.color.image->clone());
-        if (data)
+            renderModel.color.image->clearDirty();
+            runtime->requestFrame();
+        }
+        else
         {
-            // queue the old data for safe disposal
-            if (descriptors.color)
-                runtime->dispose(descriptors.color);
+            renderModel.color.name = "color " + layer.key.str();
+            renderModel.color.image = layer.image.image();
+            renderModel.color.matrix = layer.matrix;
+
+            // layer-controls slot for the bound layer; -1 for a CPU
+            // composite, whose opacities are already baked in.
+            renderModel.colorLayerControl = layer.layer ?
+                (float)controlIndexFor(layer.layer->uid()) : -1.0f;
+
+            // a stacked raster (depth > 1) is a time-series layer: its
+            // slices upload once as a texture array, and the shader
+            // blends between them driven by the layer-controls clock.
+            bool isTimeSeries = renderModel.color.image->depth() > 1;
+            renderModel.colorFrameCount = isTimeSeries ?
+                (float)renderModel.color.image->depth() : 0.0f;
+
+            vsg::ref_ptr<vsg::Data> data;
+
+            // a native image (e.g. a KTX2 tile transcoded to a GPU block
+            // format by its reader) already is vsg data; upload it as-is.
+            if (auto native = NativeImage::cast(renderModel.color.image))
+            {
+                data = native->native;
+            }
 
-            // tell vsg to remove the image from CPU memory after sending it to the GPU
-            // note, since we're using wrap() above, only the buffer will get deleted
-            // and not the actual image data.
-            data->properties.dataVariance = vsg::STATIC_DATA_UNREF_AFTER_TRANSFER;
+            // BC transcode runs here on the load job, so the encode cost
+            // never touches the frame. Dynamic images stay uncompressed
+            // since block-compressed data can't take region updates.
+            else if (compressColorTextures && !renderModel.color.image->dynamic() && !isTimeSeries)
+            {
+                data = util::compressImageToBC(renderModel.color.image);
+            }
 
-            descriptors.color = vsg::DescriptorImage::create(
-                texturedefs.color.sampler,
-                data,
-                texturedefs.color.uniform_binding,
-                0, // array element (TODO: increment if we change to an array)
-                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+            // zero-copy handoff; the Data shares ownership of the pixel buffer
+            if (!data)
+                data = util::shareImageToVSG(renderModel.color.image);
+
+            if (data)
+            {
+                // queue the old data for safe disposal
+                if (descriptors.color)
+                    runtime->dispose(descriptors.color);
+                if (descriptors.colorFrames && descriptors.colorFrames != defaultTileDescriptors.colorFrames)
+                    runtime->dispose(descriptors.colorFrames);
+
+                // tell vsg to remove the image from CPU memory after sending it
+                // to the GPU - unless the image is dynamic, in which case it
+                // sticks around for region updates.
+                // note, since we're sharing ownership, only the vsg wrapper gets
+                // released and not the actual image data.
+                data->properties.dataVariance = renderModel.color.image->dynamic() ?
+                    vsg::DYNAMIC_DATA :
+                    vsg::STATIC_DATA_UNREF_AFTER_TRANSFER;
+
+                if (isTimeSeries)
+                {
+                    // slices bind to the texture-array slot; the plain
+                    // color slot reverts to its placeholder.
+                    data->properties.imageViewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+
+                    descriptors.colorFrames = vsg::DescriptorImage::create(
+                        texturedefs.colorFrames.sampler,
+                        data,
+                        texturedefs.colorFrames.uniform_binding,
+                        0, // array element
+                        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+                    descriptors.colorFrames->setValue("name", renderModel.color.name);
+                    descriptors.color = defaultTileDescriptors.color;
+                }
+                else
+                {
+                    descriptors.color = vsg::DescriptorImage::create(
+                        texturedefs.color.sampler,
+                        data,
+                        texturedefs.color.uniform_binding,
+                        0, // array element (TODO: increment if we change to an array)
+                        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+                    descriptors.color->setValue("name", renderModel.color.name);
+                    descriptors.colorFrames = defaultTileDescriptors.colorFrames;
+                }
 
-            descriptors.color->setValue("name", renderModel.color.name);
+                colorChanged = true;
+            }
         }
     }
 
@@ -306,8 +648,7 @@ TerrainState::updateRenderModel(
         renderModel.elevation.image = dataModel.elevation.heightfield.heightfield();
         renderModel.elevation.matrix = dataModel.elevation.matrix;
 
-        auto data = util::wrapImageInVSG(renderModel.elevation.image); // ->clone());
-        //auto data = util::moveImageToVSG(renderModel.elevation.image->clone());
+        auto data = util::shareImageToVSG(renderModel.elevation.image);
         if (data)
         {
             // queue the old data for safe disposal
@@ -315,8 +656,8 @@ TerrainState::updateRenderModel(
                 runtime->dispose(descriptors.elevation);
 
             // tell vsg to remove the image from CPU memory after sending it to the GPU
-            // note, since we're using wrap() above, only the buffer will get deleted
-            // and not the actual image data.
+            // note, since we're sharing ownership, only the vsg wrapper gets
+            // released and not the actual image data.
             data->properties.dataVariance = vsg::STATIC_DATA_UNREF_AFTER_TRANSFER;
 
             descriptors.elevation = vsg::DescriptorImage::create(
@@ -327,42 +668,81 @@ TerrainState::updateRenderModel(
                 VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
             descriptors.elevation->setValue("name", renderModel.elevation.name);
+
+            elevationChanged = true;
         }
     }
 
-    // the per-tile uniform block:
-    auto ubo = vsg::ubyteArray::create(sizeof(TerrainTileDescriptors::Uniforms));
-    auto& uniforms = *static_cast<TerrainTileDescriptors::Uniforms*>(ubo->dataPointer());
-    uniforms.elevation_matrix = renderModel.elevation.matrix;
-    uniforms.color_matrix = renderModel.color.matrix;
-    descriptors.uniforms = vsg::DescriptorBuffer::create(ubo, TILE_BUFFER_BINDING);
-
-    // make the descriptor set. 
-    // TODO: consider whether to separate the sampler binds from the uniform binds
-    // because of tile inheritance.
-    auto descriptorSet = vsg::DescriptorSet::create(
-        pipelineConfig->layout->setLayouts[0],
-        vsg::Descriptors{ descriptors.elevation, descriptors.color, descriptors.uniforms }
-    );
-
-    //if (sharedObjects) sharedObjects->share(descriptorSet);
-
-    // binds the descriptor set to the pipeline
-    descriptors.bind = vsg::BindDescriptorSet::create(
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipelineConfig->layout,
-        0, // first set
-        descriptorSet
-    );
+    // the per-tile uniform block; only rebuild it if a matrix changed
+    // (e.g. scale/bias inheritance) or it doesn't exist yet:
+    bool uniformsChanged =
+        !descriptors.uniforms ||
+        renderModel.color.matrix != oldColorMatrix ||
+        renderModel.elevation.matrix != oldElevationMatrix ||
+        renderModel.colorLayerControl != oldRenderModel.colorLayerControl ||
+        renderModel.colorFrameCount != oldRenderModel.colorFrameCount;
+
+    if (uniformsChanged)
+    {
+        if (descriptors.uniforms)
+            runtime->dispose(descriptors.uniforms);
+
+        auto ubo = vsg::ubyteArray::create(sizeof(TerrainTileDescriptors::Uniforms));
+        auto& uniforms = *static_cast<TerrainTileDescriptors::Uniforms*>(ubo->dataPointer());
+        uniforms.elevation_matrix = renderModel.elevation.matrix;
+        uniforms.color_matrix = renderModel.color.matrix;
+        uniforms.tile_params = glm::fvec4(renderModel.skirtHeight, renderModel.colorLayerControl, renderModel.colorFrameCount, 0.0f);
+        descriptors.uniforms = vsg::DescriptorBuffer::create(ubo, TILE_BUFFER_BINDING);
+    }
 
-    // Compile the objects. Everything should be under the bind command.
-    runtime->compile(descriptors.bind);
+    // The texture set is shared: a descendant that inherits an ancestor's
+    // imagery carries the ancestor's compiled bind command and skips this
+    // block entirely, so deep zooms add no descriptors beyond the one the
+    // ancestor already owns.
+    if (colorChanged || elevationChanged || !descriptors.bindTextures)
+    {
+        auto textureSet = vsg::DescriptorSet::create(
+            pipelineConfig->layout->setLayouts[TEXTURE_SET],
+            vsg::Descriptors{ descriptors.elevation, descriptors.color, descriptors.colorFrames }
+        );
+
+        descriptors.bindTextures = vsg::BindDescriptorSet::create(
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineConfig->layout,
+            TEXTURE_SET,
+            textureSet
+        );
+
+        // Compile the objects. Everything should be under the bind
+        // command; descriptors reused from the previous model are already
+        // compiled and cost nothing here.
+        runtime->compile(descriptors.bindTextures);
+    }
+
+    // The uniform set (scale/bias matrices, tile params) is the only
+    // per-tile state.
+    if (uniformsChanged || !descriptors.bindUniforms)
+    {
+        auto uniformsSet = vsg::DescriptorSet::create(
+            pipelineConfig->layout->setLayouts[TILE_BUFFER_SET],
+            vsg::Descriptors{ descriptors.uniforms }
+        );
+
+        descriptors.bindUniforms = vsg::BindDescriptorSet::create(
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineConfig->layout,
+            TILE_BUFFER_SET,
+            uniformsSet
+        );
+
+        runtime->compile(descriptors.bindUniforms);
+    }
 
 #if 0
     // Temporary:
     // Delete the CPU memory assocaited with the rasters
     // now that they are compiled to the GPU.
-    for (auto& dd : descriptors.bind->descriptorSet->descriptors)
+    for (auto& dd : descriptors.bindTextures->descriptorSet->descriptors)
     {
         auto di = dd->cast<vsg::DescriptorImage>();
         if (di)
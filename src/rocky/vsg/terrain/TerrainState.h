@@ -14,8 +14,12 @@
 #include <vsg/utils/SharedObjects.h>
 #include <vsg/nodes/StateGroup.h>
 
+#include <mutex>
+#include <unordered_map>
+
 namespace ROCKY_NAMESPACE
 {
+    class Map;
     class TerrainTileNode;
     class TerrainTileRenderModel;
 
@@ -46,9 +50,31 @@ namespace ROCKY_NAMESPACE
             const TerrainTileModel& newDataModel,
             VSGContext& runtime) const;
 
+        //! Pushes the current opacity and visibility of the map's image
+        //! layers into the shared layer-controls uniform buffer. Call once
+        //! per update pass; when a value changed, the buffer re-transfers
+        //! and a frame is requested, so animating a layer fade is a single
+        //! buffer write instead of per-tile state reconstruction.
+        //! @return true if anything changed
+        bool updateLayerControls(const Map* map, VSGContext& context);
+
         //! Status of the factory.
         Status status;
 
+        //! When set, tile color textures transcode to a BC-compressed
+        //! format on the load job before upload (see
+        //! TerrainSettings::compressColorTextures).
+        bool compressColorTextures = false;
+
+        //! When set, terrain renders through the adaptive tessellation
+        //! pipeline (see TerrainSettings::gpuTessellation). Cleared at
+        //! state-group creation if the device or shaders can't support it.
+        bool gpuTessellation = false;
+
+        //! When set, the fragment shader applies procedural close-range
+        //! detail texturing (see TerrainSettings::detailTexturing).
+        bool detailTexturing = false;
+
     public:
 
         //! Config object for creating the terrain's graphics pipeline
@@ -58,6 +84,11 @@ namespace ROCKY_NAMESPACE
         //! state group for each tile.
         vsg::ref_ptr<vsg::ShaderSet> shaderSet;
 
+        //! Per-layer controls (x = opacity, y = visible), indexed by the
+        //! slot that controlIndexFor() assigns to each image layer. Bound
+        //! once, map-wide, in the terrain state group as dynamic data.
+        vsg::ref_ptr<vsg::vec4Array> layerControls;
+
         //! Default state descriptors for a terrain tile.
         //! This holds the "default" (i.e. empty) textures and uniforms
         //! that will populate a descriptor set when no other textures are available.
@@ -100,8 +131,18 @@ namespace ROCKY_NAMESPACE
         struct
         {
             TextureDef color;
+            TextureDef colorFrames;
             TextureDef elevation;
         }
         texturedefs;
+
+        //! Layer-controls slot for a layer, assigned on first use;
+        //! -1 once the slots are exhausted.
+        int controlIndexFor(UID uid) const;
+
+    private:
+
+        mutable std::mutex _layerIndexMutex;
+        mutable std::unordered_map<UID, int> _layerIndex;
     };
 }
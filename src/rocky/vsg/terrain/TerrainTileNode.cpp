@@ -69,7 +69,8 @@ TerrainTileNode::accept(vsg::RecordTraversal& rv) const
 
         // should we subdivide?
         auto& vp = state->_commandBuffer->viewDependentState->viewportData->at(0);
-        auto min_screen_height_ratio = (host->settings().tilePixelSize + host->settings().screenSpaceError) / vp[3];
+        auto sse = host->settings().screenSpaceError * host->settings().screenSpaceErrorScale[state->_commandBuffer->viewID];
+        auto min_screen_height_ratio = (host->settings().tilePixelSize + sse) / vp[3];
         auto d = state->lodDistance(bound);
         bool subtilesInRange = (d > 0.0) && (bound.r > (d * min_screen_height_ratio));
 
@@ -134,6 +135,11 @@ TerrainTileNode::inheritFrom(vsg::ref_ptr<TerrainTileNode> parent)
     renderModel = parent->renderModel;
     renderModel.applyScaleBias(sb);
 
+    // keep sharing the parent's texture bind, but drop its uniform set;
+    // this tile needs its own, built from the scale-biased matrices.
+    renderModel.descriptors.uniforms = {};
+    renderModel.descriptors.bindUniforms = {};
+
     revision = parent->revision;
 
     // copy the parent's elevation data and recompute the bounding sphere
@@ -52,11 +52,23 @@ namespace ROCKY_NAMESPACE
         {
             glm::fmat4 elevation_matrix;
             glm::fmat4 color_matrix;
+            glm::fvec4 tile_params; // x = skirt extrusion height (meters), y = layer control index (-1 = none), z = time-series frame count (0 = static)
         };
         vsg::ref_ptr<vsg::DescriptorImage> color;
         vsg::ref_ptr<vsg::DescriptorImage> elevation;
+
+        // texture array holding the timestep slices of a time-series
+        // color layer; a 1x1x1 placeholder everywhere else
+        vsg::ref_ptr<vsg::DescriptorImage> colorFrames;
+
         vsg::ref_ptr<vsg::DescriptorBuffer> uniforms;
-        vsg::ref_ptr<vsg::BindDescriptorSet> bind;
+
+        // The texture bind is shared: every descendant borrowing an
+        // ancestor's imagery reuses the ancestor's compiled descriptor
+        // set. Only the small uniform set (scale/bias, tile params) is
+        // per-tile.
+        vsg::ref_ptr<vsg::BindDescriptorSet> bindTextures;
+        vsg::ref_ptr<vsg::BindDescriptorSet> bindUniforms;
     };
 
     class TerrainTileRenderModel
@@ -66,6 +78,19 @@ namespace ROCKY_NAMESPACE
         TextureData color;
         TextureData elevation;
 
+        // skirt extrusion length, applied in the vertex shader to verts
+        // carrying the VERTEX_SKIRT marker
+        float skirtHeight = 0.0f;
+
+        // slot in the map-wide layer-controls buffer for the bound color
+        // layer, or -1 when there is none (or it is a CPU composite with
+        // opacities already baked in)
+        float colorLayerControl = -1.0f;
+
+        // number of timestep slices when the bound color data is a
+        // time-series texture array; 0 for a plain 2D color texture
+        float colorFrameCount = 0.0f;
+
         TerrainTileDescriptors descriptors;
 
         void applyScaleBias(const glm::dmat4& sb)
@@ -93,6 +118,12 @@ namespace ROCKY_NAMESPACE
         vsg::ref_ptr<vsg::StateGroup> stategroup;
         
         mutable jobs::future<bool> subtilesLoader;
+
+        //! Set by the data loader when its model skipped layers that were
+        //! at their concurrent-request quota; the pager schedules a retry
+        //! after the merge (see TerrainTilePager).
+        mutable std::atomic<bool> dataIncomplete = { false };
+
         mutable std::atomic<uint64_t> lastTraversalFrame = { 0 };
         mutable std::atomic<vsg::time_point> lastTraversalTime;
         mutable std::atomic<float> lastTraversalRange = { FLT_MAX };
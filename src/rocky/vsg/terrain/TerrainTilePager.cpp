@@ -9,12 +9,20 @@
 #include "../Utils.h"
 
 #include <rocky/ElevationLayer.h>
+#include <rocky/Heightfield.h>
 #include <rocky/ImageLayer.h>
 #include <rocky/Map.h>
+#include <rocky/PipelineMetrics.h>
 #include <rocky/TerrainTileModelFactory.h>
+#include <rocky/Trace.h>
 
 #include <vsg/nodes/QuadGroup.h>
 #include <vsg/ui/FrameStamp.h>
+#include <vsg/vk/State.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 using namespace ROCKY_NAMESPACE;
 
@@ -22,6 +30,22 @@ using namespace ROCKY_NAMESPACE;
 
 #define RP_DEBUG if(false) Log()->info
 
+namespace
+{
+    // Rough resident byte size of a tile's texture data. Inherited
+    // (scale/biased) parent imagery counts against the child too, which
+    // overestimates, but it's only used to rank tiles against each other.
+    std::size_t residentBytes(const TerrainTileRenderModel& renderModel)
+    {
+        std::size_t total = 0;
+        if (renderModel.color.image)
+            total += renderModel.color.image->sizeInBytes();
+        if (renderModel.elevation.image)
+            total += renderModel.elevation.image->sizeInBytes();
+        return total;
+    }
+}
+
 //----------------------------------------------------------------------------
 
 TerrainTilePager::TerrainTilePager(
@@ -29,7 +53,8 @@ TerrainTilePager::TerrainTilePager(
     VSGContext& runtime, TerrainTileHost* in_host) :
     _host(in_host),
     _settings(settings),
-    _context(runtime)
+    _context(runtime),
+    _profile(profile)
 {
     _firstLOD = settings.minLevelOfDetail;
 }
@@ -52,22 +77,105 @@ TerrainTilePager::releaseAll()
     _updateData.clear();
 }
 
+void
+TerrainTilePager::lowerResidentLevelCap()
+{
+    std::scoped_lock lock(_mutex);
+
+    // the first lowering starts from the deepest level actually resident:
+    unsigned cap = residentLevelCap;
+    if (cap == ~0u)
+    {
+        cap = _firstLOD;
+        for (auto& [key, info] : _tiles)
+            cap = std::max(cap, key.level);
+    }
+
+    residentLevelCap = std::max(cap > 0u ? cap - 1u : 0u, _firstLOD);
+    _lastCapChange = std::chrono::steady_clock::now();
+
+    Log()->info(LC "device memory pressure; capping resident terrain at level {}", residentLevelCap);
+}
+
+std::size_t
+TerrainTilePager::residentTextureBytes() const
+{
+    std::scoped_lock lock(_mutex);
+
+    std::size_t total = 0;
+    for (auto& [key, info] : _tiles)
+    {
+        if (info.tile)
+            total += residentBytes(info.tile->renderModel);
+    }
+    return total;
+}
+
 void
 TerrainTilePager::ping(TerrainTileNode* tile, const TerrainTileNode* parent, vsg::RecordTraversal& rv)
 {
     if (_settings.supportMultiThreadedRecord)
         _mutex.lock();
 
+    auto frame = rv.getFrameStamp()->frameCount;
+
+    // Sample the camera once per frame (first view wins) for the
+    // predicted-reuse expiry scoring in update(). The velocity is lightly
+    // smoothed so one hitchy frame doesn't whip the prediction around.
+    if (frame != _cameraFrame)
+    {
+        auto eye = to_glm(vsg::inverse(rv.getState()->modelviewMatrixStack.top()) * vsg::dvec3(0, 0, 0));
+        auto now = std::chrono::steady_clock::now();
+
+        if (_cameraFrame != ~0ull)
+        {
+            double dt = std::chrono::duration<double>(now - _cameraTime).count();
+            if (dt > 0.0)
+            {
+                _cameraVel = (_cameraVel + (eye - _cameraPos) / dt) * 0.5;
+            }
+        }
+
+        _cameraPos = eye;
+        _cameraTime = now;
+        _cameraFrame = frame;
+    }
+
     // first, update the tracker to keep this tile alive.
     auto& info = _tiles[tile->key];
     if (!info.tile)
     {
         info.tile = tile;
-        info.trackerToken = _tracker.use(tile, nullptr);
+        info.trackerToken = _tracker.use(tile, nullptr, info.evictionWeight);
+    }
+    else if (info.lastPingFrame != frame)
+    {
+        _tracker.use(tile, info.trackerToken, info.evictionWeight);
+    }
+
+    // With multiple views, every view pings the same resident tiles each
+    // frame. The keep-alive and queueing decisions below are per-frame,
+    // not per-view, so process them for the first view that gets here and
+    // let the others return early instead of pushing duplicate requests.
+    if (info.lastPingFrame == frame)
+    {
+        if (_settings.supportMultiThreadedRecord)
+            _mutex.unlock();
+        return;
     }
-    else
+    info.lastPingFrame = frame;
+
+    // when a previous load skipped an over-quota layer, queue a fresh
+    // load once the backoff expires; the reset loader falls into the
+    // normal load-request logic below. (_cameraTime was sampled above,
+    // saving a clock read per tile.)
+    if (info.retryLoadAfter != std::chrono::steady_clock::time_point{} &&
+        info.dataMerger.available() &&
+        _cameraTime >= info.retryLoadAfter)
     {
-        _tracker.use(tile, info.trackerToken);
+        info.retryLoadAfter = {};
+        info.dataLoader.reset();
+        info.dataMerger.reset();
     }
 
     // next, see if the tile needs anything.
@@ -76,8 +184,9 @@ TerrainTilePager::ping(TerrainTileNode* tile, const TerrainTileNode* parent, vsg
     const bool progressive = true;
     if (progressive)
     {
-        // If this tile is fully merged, and it needs children, queue them up to load.
-        if (info.dataMerger.available() && tile->needsSubtiles)
+        // If this tile is fully merged, and it needs children, queue them up
+        // to load (unless the subtiles would land past the resident-level cap).
+        if (info.dataMerger.available() && tile->needsSubtiles && tile->key.level < residentLevelCap)
         {
             _createChildren.push_back(tile->key);
         }
@@ -137,6 +246,9 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
         !_loadData.empty() ||
         !_mergeData.empty();
 
+    // reload any resident tiles that a layer dirtied since the last pass:
+    invalidateDirtyTiles(engine);
+
     //Log::info()
     //    << "Frame " << fs->frameCount << ": "
     //    << "tiles=" << _tracker._list.size()-1 << " "
@@ -183,18 +295,68 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     }
     _loadData.clear();
 
-    // schedule any data merging requests
-    for (auto& key : _mergeData)
+    // merge any loaded data models, highest screen-space priority first,
+    // until we exhaust the per-frame merge budget. Tiles that miss the
+    // cut will re-queue themselves via ping() on a later frame, which
+    // amortizes merges across frames when a whole subtree loads at once.
+    if (!_mergeData.empty())
     {
-        auto iter = _tiles.find(key);
-        if (iter != _tiles.end())
+        auto tilePriority = [this](const TileKey& key) -> float
         {
-            requestMergeData(iter->second, io, engine);
-        }
+            auto iter = _tiles.find(key);
+            return iter != _tiles.end() && iter->second.tile.valid() ?
+                -(sqrt(iter->second.tile->lastTraversalRange) * key.level) :
+                -FLT_MAX;
+        };
 
-        changes = true;
+        std::sort(_mergeData.begin(), _mergeData.end(),
+            [&tilePriority](const TileKey& lhs, const TileKey& rhs)
+            {
+                return tilePriority(lhs) > tilePriority(rhs);
+            });
+
+        const std::chrono::duration<float, std::milli> budget(_settings.mergeBudgetMS.value());
+        auto start = std::chrono::steady_clock::now();
+
+        for (auto& key : _mergeData)
+        {
+            auto iter = _tiles.find(key);
+            if (iter != _tiles.end())
+            {
+                auto& info = iter->second;
+
+                // How long the data took to produce, end to end. A tile
+                // sourced over the network costs far more to rebuild than
+                // one composited from local data, and should expire later.
+                if (info.rebuildCostMS == 0.0f)
+                {
+                    info.rebuildCostMS = std::chrono::duration<float, std::milli>(
+                        std::chrono::steady_clock::now() - info.loadStart).count();
+                }
+
+                requestMergeData(info, io, engine);
+
+                // Eviction weight favors dropping tiles that hold a lot of
+                // texture memory but were cheap to produce.
+                info.evictionWeight = (float)residentBytes(info.tile->renderModel) /
+                    (1.0f + info.rebuildCostMS);
+
+                // a load that skipped over-quota layers retries after a
+                // backoff (see ping), so a degraded source trickles back
+                // in instead of hammering its quota:
+                if (info.tile->dataIncomplete.exchange(false))
+                {
+                    info.retryLoadAfter = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                }
+            }
+
+            changes = true;
+
+            if (std::chrono::steady_clock::now() - start >= budget)
+                break;
+        }
+        _mergeData.clear();
     }
-    _mergeData.clear();
 
     // Flush unused tiles (i.e., tiles that failed to ping) out of the system.
     // Tiles ping their children all at once; this should in theory prevent
@@ -202,10 +364,40 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
     // Only do this is the frame advanced - otherwise just leave it be.
     if (fs->frameCount > _lastUpdate)
     {
+        // Predicted re-use: how far outside its own paging range this tile
+        // will be after projecting the camera's motion ahead a few seconds.
+        // < 1 means the camera is inside (or about to re-enter) the range
+        // at which the tile's LOD pages in - an orbit-and-stare camera
+        // sweeps such tiles out of the frustum every revolution only to
+        // re-request them on the next one, so we keep them resident.
+        constexpr double lookAheadSeconds = 3.0;
+        auto coldness = [&](TerrainTileNode* tile) -> double
+        {
+            // no camera sampled yet? fall back to pure weight-based expiry.
+            if (_cameraFrame == ~0ull || !tile)
+                return DBL_MAX;
+
+            glm::dvec3 center(tile->bound.center.x, tile->bound.center.y, tile->bound.center.z);
+            double dNow = glm::length(center - _cameraPos) - tile->bound.radius;
+            double dAhead = glm::length(center - (_cameraPos + _cameraVel * lookAheadSeconds)) - tile->bound.radius;
+            double dNearest = std::max(0.0, std::min(dNow, dAhead));
+
+            double pageInRange = tile->bound.radius * (double)_settings.minTileRangeFactor.value();
+            return dNearest / std::max(pageInRange, 1.0);
+        };
+
+        const bool expireAll = expireAllNextUpdate;
+
         const auto dispose = [&](TerrainTileNode* tile)
         {
             if (!tile->doNotExpire)
             {
+                // a warm tile survives unless the memory governor demands
+                // everything; it stays behind the sentry and becomes an
+                // expiry candidate again next frame.
+                if (!expireAll && coldness(tile) < 1.0)
+                    return false;
+
                 auto key = tile->key;
                 auto parent_iter = _tiles.find(key.createParentKey());
                 if (parent_iter != _tiles.end())
@@ -223,18 +415,73 @@ TerrainTilePager::update(const vsg::FrameStamp* fs, const IOOptions& io, std::sh
                         tile->needsSubtiles = false;
                     }
                 }
+                engine->picker.removeTile(key);
                 _tiles.erase(key);
                 return true;
             }
             return false;
         };
 
-        _tracker.flush(~0, dispose);
+        // Rescore each candidate at flush time: the byte-per-rebuild-cost
+        // weight stored at merge time, scaled by how cold the tile is now.
+        // The stored tracker weight goes stale the moment a tile stops
+        // pinging, and coldness depends on where the camera is headed.
+        auto weigh = [&](TerrainTileNode* tile) -> float
+        {
+            auto iter = _tiles.find(tile->key);
+            float base = iter != _tiles.end() ? iter->second.evictionWeight : FLT_MAX;
+            if (base == FLT_MAX)
+                return base;
+
+            return base * (float)std::clamp(coldness(tile), 0.01, 100.0);
+        };
+
+        // Expire the coldest, cheapest-to-rebuild tiles first, capped per
+        // frame so tiles that were expensive to produce (e.g. fetched over
+        // the network) linger a few extra frames and survive a quick
+        // camera return. Memory pressure lifts the cap (see TerrainEngine's
+        // registration with the memory governor).
+        constexpr unsigned maxExpirationsPerFrame = 64u;
+        unsigned maxCount = expireAll ? ~0u : maxExpirationsPerFrame;
+        expireAllNextUpdate = false;
+
+        _tracker.flushWeighted(maxCount, weigh, dispose);
+    }
+
+    // resident-level cap, set by the GPU memory governor: detach the
+    // quads sitting at the cap so their subtiles stop pinging and expire
+    // through the tracker, then relax the cap one level at a time once
+    // the pressure has been quiet for a while.
+    if (residentLevelCap != ~0u)
+    {
+        for (auto& [key, info] : _tiles)
+        {
+            if (key.level == residentLevelCap && info.tile && info.tile->children.size() > 1)
+            {
+                engine->context->dispose(info.tile->children[1]);
+                info.tile->children.resize(1);
+                info.tile->subtilesLoader.reset();
+                info.tile->needsSubtiles = false;
+                changes = true;
+            }
+        }
+
+        if (std::chrono::steady_clock::now() - _lastCapChange > std::chrono::seconds(10))
+        {
+            if (++residentLevelCap >= _settings.maxLevelOfDetail.value())
+                residentLevelCap = ~0u;
+            _lastCapChange = std::chrono::steady_clock::now();
+        }
     }
 
     // synchronize
     _lastUpdate = fs->frameCount;
 
+    if (changes)
+    {
+        ++dataRevision;
+    }
+
     return changes;
 }
 
@@ -248,6 +495,107 @@ TerrainTilePager::getTile(const TileKey& key) const
         vsg::ref_ptr<TerrainTileNode>(nullptr);
 }
 
+unsigned
+TerrainTilePager::sampleResidentElevation(std::vector<glm::dvec3>& points, const SRS& srs) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(_profile.valid() && srs.valid(), 0);
+
+    auto toProfile = srs.to(_profile.srs());
+    if (!toProfile.valid())
+        return 0;
+
+    unsigned resolved = 0;
+
+    std::scoped_lock lock(_mutex);
+
+    for (auto& p : points)
+    {
+        p.z = NO_DATA_VALUE;
+
+        glm::dvec3 m;
+        if (!toProfile.transform(glm::dvec3(p.x, p.y, 0.0), m))
+            continue;
+
+        // walk down the quadtree to the deepest resident tile containing
+        // the point; a resident tile's ancestors are always resident too,
+        // so the walk stops at the first gap.
+        vsg::ref_ptr<TerrainTileNode> tile;
+        for (unsigned lod = _firstLOD; ; ++lod)
+        {
+            auto key = TileKey::createTileKeyContainingPoint(m.x, m.y, lod, _profile);
+            if (!key.valid())
+                break;
+
+            auto iter = _tiles.find(key);
+            if (iter == _tiles.end() || !iter->second.tile)
+                break;
+
+            tile = iter->second.tile;
+        }
+
+        if (!tile || !tile->renderModel.elevation.image)
+            continue;
+
+        auto* hf = Heightfield::cast_from(tile->renderModel.elevation.image.get());
+        if (!hf)
+            continue;
+
+        // normalized location within the tile, pushed through the tile's
+        // scale/bias matrix since the data may live on an ancestor's
+        // texture:
+        auto extent = tile->key.extent();
+        glm::dvec4 uv =
+            tile->renderModel.elevation.matrix *
+            glm::dvec4(
+                (m.x - extent.xmin()) / extent.width(),
+                (m.y - extent.ymin()) / extent.height(),
+                0.0, 1.0);
+
+        float h = hf->heightAtUV(uv.x, uv.y, Interpolation::BILINEAR);
+        if (h != NO_DATA_VALUE)
+        {
+            p.z = h;
+            ++resolved;
+        }
+    }
+
+    return resolved;
+}
+
+GeoHeightfield
+TerrainTilePager::snapshotResidentElevation(const GeoExtent& extent, unsigned width, unsigned height) const
+{
+    ROCKY_SOFT_ASSERT_AND_RETURN(extent.valid() && width >= 2 && height >= 2, GeoHeightfield());
+
+    // lay out the sample grid across the extent (row 0 = south edge,
+    // matching Heightfield's UV convention):
+    std::vector<glm::dvec3> points;
+    points.reserve(width * height);
+    for (unsigned row = 0; row < height; ++row)
+    {
+        double y = extent.ymin() + extent.height() * (double)row / (double)(height - 1);
+        for (unsigned col = 0; col < width; ++col)
+        {
+            double x = extent.xmin() + extent.width() * (double)col / (double)(width - 1);
+            points.emplace_back(x, y, 0.0);
+        }
+    }
+
+    // one pass under the pager lock resolves every sample:
+    sampleResidentElevation(points, extent.srs());
+
+    auto hf = Heightfield::create(width, height);
+    for (unsigned row = 0; row < height; ++row)
+    {
+        for (unsigned col = 0; col < width; ++col)
+        {
+            hf->heightAt(col, row) = (float)points[row * width + col].z;
+        }
+    }
+
+    return GeoHeightfield(hf, extent);
+}
+
 void
 TerrainTilePager::requestCreateChildren(TileInfo& info, std::shared_ptr<TerrainEngine> engine) const
 {
@@ -261,68 +609,90 @@ TerrainTilePager::requestCreateChildren(TileInfo& info, std::shared_ptr<TerrainE
 
     vsg::observer_ptr<TerrainTileNode> weak_parent(info.tile);
 
-    // function that will create all 4 children and compile them
-    auto create_children = [engine, weak_parent](Cancelable& p)
+    // Each subtile is created in its own job so the four builds run in
+    // parallel across the loader pool. The last one to finish assembles
+    // the quad, compiles it, and queues it for attachment.
+    struct InFlightQuad
     {
-        vsg::ref_ptr<vsg::Node> result;
-        auto parent = weak_parent.ref_ptr();
-        if (parent)
-        {
-            auto quad = vsg::QuadGroup::create();
+        vsg::ref_ptr<vsg::QuadGroup> quad = vsg::QuadGroup::create();
+        std::atomic_int remaining = { 4 };
+    };
+    auto inflight = std::make_shared<InFlightQuad>();
 
-            for (unsigned quadrant = 0; quadrant < 4; ++quadrant)
-            {
-                if (p.canceled())
-                    return result;
+    // promise that the last child job will resolve with the finished quad
+    jobs::future<vsg::ref_ptr<vsg::Node>> promise;
 
+    // a callback that will return the loading priority of a tile
+    auto priority_func = [weak_parent]() -> float
+    {
+        auto tile = weak_parent.ref_ptr();
+        return tile ? -(sqrt(tile->lastTraversalRange) * tile->key.level) : -FLT_MAX;
+    };
+
+    for (unsigned quadrant = 0; quadrant < 4; ++quadrant)
+    {
+        auto create_child = [engine, weak_parent, inflight, quadrant, promise](Cancelable& p) mutable
+        {
+            auto parent = weak_parent.ref_ptr();
+            if (parent && !p.canceled())
+            {
                 TileKey childkey = parent->key.createChildKey(quadrant);
 
                 auto tile = engine->createTile(childkey, parent);
+                ROCKY_SOFT_ASSERT(tile != nullptr);
 
-                ROCKY_SOFT_ASSERT_AND_RETURN(tile != nullptr, result);
-
-                quad->children[quadrant] = tile;
+                inflight->quad->children[quadrant] = tile;
             }
 
-            // assign the result once all 4 children are added
-            result = quad;
-        }
+            // last one out assembles the quad:
+            if (inflight->remaining.fetch_sub(1) == 1)
+            {
+                vsg::ref_ptr<vsg::Node> result;
 
-        if (result)
-        {
-            engine->context->compile(result);
+                bool complete = true;
+                for (auto& child : inflight->quad->children)
+                    if (!child)
+                        complete = false;
 
-            engine->context->onNextUpdate([result, engine, weak_parent]()
+                if (complete)
                 {
-                    auto parent = weak_parent.ref_ptr();
-                    if (parent)
-                    {
-                        parent->addChild(result);
-                    }
+                    result = inflight->quad;
+
+                    engine->context->compile(result);
+
+                    engine->context->onNextUpdate([result, engine, weak_parent]()
+                        {
+                            auto parent = weak_parent.ref_ptr();
+                            if (parent)
+                            {
+                                parent->addChild(result);
+                            }
+                            engine->context->requestFrame();
+                        });
+
                     engine->context->requestFrame();
-                });
+                }
 
-            engine->context->requestFrame();
-        }
+                promise.resolve(result);
+            }
 
-        return result;
-    };
+            return true;
+        };
 
-    // a callback that will return the loading priority of a tile
-    auto priority_func = [weak_parent]() -> float
-    {
-        auto tile = weak_parent.ref_ptr();
-        return tile ? -(sqrt(tile->lastTraversalRange) * tile->key.level) : -FLT_MAX;
-    };
+        // can_cancel must be false since we discard the per-job futures;
+        // abandoned parents make each job a cheap no-op instead.
+        jobs::dispatch(
+            create_child,
+            jobs::context {
+                "create child " + info.tile->key.str(),
+                jobs::get_pool(engine->loadSchedulerName),
+                priority_func,
+                nullptr,
+                false
+            });
+    }
 
-    info.childrenCreator = jobs::dispatch(
-        create_children,
-        jobs::context {
-            "create child " + info.tile->key.str(),
-            jobs::get_pool(engine->loadSchedulerName),
-            priority_func,
-            nullptr
-        });
+    info.childrenCreator = promise;
 }
 
 void
@@ -339,27 +709,54 @@ TerrainTilePager::requestLoadData(TileInfo& info, const IOOptions& in_io, std::s
     auto key = info.tile->key;
     auto tile = info.tile;
 
+    // stamp the load start so update() can measure the rebuild cost
+    info.loadStart = std::chrono::steady_clock::now();
+
+    // one async span tracks this tile from load request to merge:
+    util::trace::asyncBegin("tile paging", std::hash<TileKey>{}(key), key.str());
+
     //RP_DEBUG("requestLoadData -> {}", key.str());
 
     CreateTileManifest manifest;
     const IOOptions io(in_io);
 
-    auto load = [key, tile, manifest, engine, io](Cancelable& p) -> bool
+    auto load = [key, tile, manifest, engine, io, requested = info.loadStart](Cancelable& p) -> bool
     {
+        util::PipelineMetrics::insert(util::PipelineMetrics::QUEUE_WAIT,
+            1e-6 * (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - requested).count());
+
         if (p.canceled())
+        {
+            util::trace::asyncEnd("tile paging", std::hash<TileKey>{}(key));
             return false;
+        }
 
         TerrainTileModelFactory factory;
         factory.compositeColorLayers = true;
+        factory.discardFlatHeightfields = engine->settings.discardFlatElevation;
+        factory.diskCachePath = engine->settings.tileCachePath;
+
+        // cap this job's IO at the configured time budget so a hung
+        // read cannot hold the loader thread indefinitely:
+        IOOptions local(io, p);
+        if (engine->settings.tileLoadTimeoutMS > 0u)
+            local = local.withBudget(std::chrono::milliseconds(engine->settings.tileLoadTimeoutMS.value()));
 
         auto dataModel = factory.createTileModel(
             engine->map.get(),
             key,
             manifest,
-            IOOptions(io, p));
+            local);
+
+        // a model that skipped over-quota layers is missing data; flag
+        // the tile so the pager schedules a retry after the merge.
+        tile->dataIncomplete = !dataModel.skippedLayers.empty();
 
         if (!dataModel.empty())
         {
+            util::PipelineMetrics::Scoped pm(util::PipelineMetrics::COMPILE);
+
             auto newRenderModel = engine->stateFactory.updateRenderModel(
                 tile->renderModel,
                 dataModel,
@@ -372,6 +769,7 @@ TerrainTilePager::requestLoadData(TileInfo& info, const IOOptions& in_io, std::s
             return true;
         }
 
+        util::trace::asyncEnd("tile paging", std::hash<TileKey>{}(key));
         return false;
     };
 
@@ -384,14 +782,19 @@ TerrainTilePager::requestLoadData(TileInfo& info, const IOOptions& in_io, std::s
         return tile ? -(sqrt(tile->lastTraversalRange) * tile->key.level) : -FLT_MAX;
     };
 
-    info.dataLoader = jobs::dispatch(
-        load, 
-        jobs::context {
-            "load data " + key.str(),
-            jobs::get_pool(engine->loadSchedulerName),
-            priority_func,
-            nullptr
-        } );
+    jobs::context job_context{
+        "load data " + key.str(),
+        jobs::get_pool(engine->loadSchedulerName),
+        priority_func,
+        nullptr };
+
+    // This tile pinged during record traversal, so it is in view right
+    // now. The deadline lets a load that languishes behind bulk work
+    // (like a prefetch sweep) jump the queue as the deadline nears,
+    // instead of waiting out every job ahead of it.
+    job_context.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+    info.dataLoader = jobs::dispatch(load, job_context);
 }
 
 void
@@ -405,8 +808,6 @@ TerrainTilePager::requestMergeData(TileInfo& info, const IOOptions& in_io, std::
         return;
     }
 
-    auto key = info.tile->key;
-
     // if the loader didn't load anything, we're done.
     if (info.dataLoader.value() == false)
     {
@@ -414,33 +815,89 @@ TerrainTilePager::requestMergeData(TileInfo& info, const IOOptions& in_io, std::
         return;
     }
 
-    // operation to dispose of the old state command and replace it with a new one:
-    auto merge = [key, engine](Cancelable& c)
+    // dispose of the old state command and replace it with a new one.
+    // This runs right here on the update thread (update() is the only
+    // caller) so the pager's merge budget measures the actual work.
+    util::PipelineMetrics::Scoped pm(util::PipelineMetrics::MERGE);
+
+    auto tile = info.tile;
+
+    for (auto c : tile->stategroup->stateCommands)
+        engine->context->dispose(c);
+
+    tile->stategroup->stateCommands.clear();
+    tile->stategroup->stateCommands.emplace_back(tile->renderModel.descriptors.bindTextures);
+    tile->stategroup->stateCommands.emplace_back(tile->renderModel.descriptors.bindUniforms);
+
+    // apply the merged elevation to the surface so its proxy mesh and
+    // bounds reflect the tile's own data rather than the values it
+    // inherited from its parent, and refresh the picker's record:
+    tile->surface->setElevation(tile->renderModel.elevation.image, tile->renderModel.elevation.matrix);
+    tile->bound = tile->surface->recomputeBound();
+    engine->picker.updateTile(tile->key, tile->surface);
+
+    engine->context->requestFrame();
+
+    util::trace::asyncEnd("tile paging", std::hash<TileKey>{}(tile->key));
+
+    info.dataMerger.resolve(true);
+}
+
+void
+TerrainTilePager::invalidateDirtyTiles(std::shared_ptr<TerrainEngine> engine)
+{
+    for (auto& layer : engine->map->layers().ofType<TileLayer>())
     {
-        auto tile = engine->tiles.getTile(key);
-        if (tile)
+        if (!layer->isOpen())
+            continue;
+
+        auto revision = layer->revision();
+
+        auto [iter, isNew] = _layerRevisions.try_emplace(layer->uid(), revision);
+        if (isNew || iter->second == revision)
+            continue;
+
+        // collect the extents this layer dirtied since we last looked;
+        // if it was dirtied without extent information, everything
+        // resident is suspect.
+        std::vector<GeoExtent> dirtyExtents;
+        bool scoped = layer->getDirtyExtents(iter->second, dirtyExtents);
+        iter->second = revision;
+
+        unsigned count = 0;
+
+        for (auto& [key, info] : _tiles)
         {
-            for (auto c : tile->stategroup->stateCommands)
-                engine->context->dispose(c);
+            if (!info.tile)
+                continue;
 
-            tile->stategroup->stateCommands.clear();
-            tile->stategroup->stateCommands.emplace_back(tile->renderModel.descriptors.bind);
+            bool dirty = !scoped;
+            for (auto& extent : dirtyExtents)
+            {
+                if (dirty)
+                    break;
+                dirty = extent.intersects(key.extent());
+            }
 
-            engine->context->requestFrame();
-            return true;
+            if (dirty)
+            {
+                // clearing the futures makes the tile's next ping()
+                // re-queue a data load, exactly as if it had never
+                // loaded; the stale model keeps rendering until the
+                // fresh one merges.
+                info.dataLoader.reset();
+                info.dataMerger.reset();
+                ++count;
+            }
         }
-        return false;
-    };
-
-    auto merge_operation = util::PromiseOperation<bool>::create(merge);
-    info.dataMerger = merge_operation->future();
 
-    vsg::observer_ptr<TerrainTileNode> weak_tile(info.tile);
-    auto priority_func = [weak_tile]() -> float
-    {
-        auto tile = weak_tile.ref_ptr();
-        return tile ? -(sqrt(tile->lastTraversalRange) * tile->key.level) : -FLT_MAX;
-    };
+        if (count > 0)
+        {
+            RP_DEBUG(LC "layer '{}' dirty: invalidated {} of {} resident tiles",
+                layer->name().value(), count, _tiles.size());
 
-    engine->context->onNextUpdate(merge_operation, priority_func);
+            // keep frames flowing so the invalidated tiles ping
+            _context->requestFrame();
+        }
+    }
 }
@@ -7,9 +7,11 @@
 
 #include <rocky/vsg/VSGContext.h>
 #include <rocky/vsg/terrain/TerrainTileNode.h>
+#include <rocky/GeoHeightfield.h>
 #include <rocky/SentryTracker.h>
 #include <chrono>
 #include <map>
+#include <unordered_map>
 
 namespace ROCKY_NAMESPACE
 {
@@ -34,9 +36,22 @@ namespace ROCKY_NAMESPACE
             // be removed anyway, but we need to keep it alive in the meantime...
             vsg::ref_ptr<TerrainTileNode> tile;
             void* trackerToken = nullptr;
+            std::uint64_t lastPingFrame = ~0ull;
             jobs::future<vsg::ref_ptr<vsg::Node>> childrenCreator;
             jobs::future<bool> dataLoader;
             jobs::future<bool> dataMerger;
+
+            // eviction policy inputs: when the data load started, what it
+            // ended up costing, and the resulting eviction weight (higher =
+            // drop sooner; see update()). A tile with no merged data is
+            // free to rebuild, so it starts maximally evictable.
+            std::chrono::steady_clock::time_point loadStart;
+            float rebuildCostMS = 0.0f;
+            float evictionWeight = FLT_MAX;
+
+            // when a load skipped over-quota layers (see
+            // TerrainTileModel::skippedLayers), retry it after this time.
+            std::chrono::steady_clock::time_point retryLoadAfter;
         };
 
         using TileTable = std::map<TileKey, TileInfo>;
@@ -62,6 +77,33 @@ namespace ROCKY_NAMESPACE
         //! Number of tiles in the registry.
         std::size_t size() const { return _tiles.size(); }
 
+        //! Bumped whenever an update pass changes the resident tile set
+        //! or merges new tile data. Poll this to know when the rendered
+        //! terrain picture changed (e.g., to refresh an overview texture).
+        Revision dataRevision = 0;
+
+        //! When set, the next update() expires every unpinged tile at once
+        //! instead of honoring the per-frame expiration cap. The memory
+        //! governor sets this under memory pressure.
+        bool expireAllNextUpdate = false;
+
+        //! Deepest level of detail currently allowed to stay resident
+        //! (~0 = uncapped). The GPU memory governor lowers this under
+        //! device-memory pressure (see lowerResidentLevelCap); update()
+        //! raises it back one level at a time once the pressure subsides.
+        unsigned residentLevelCap = ~0u;
+
+        //! Lowers the resident-level cap by one. Subdivision past the cap
+        //! stops, and the next update() detaches the quads already below
+        //! it, so their tiles stop pinging and expire through the tracker.
+        //! The GPU memory governor calls this when device memory runs short.
+        void lowerResidentLevelCap();
+
+        //! Estimated device bytes held by resident tile textures. Counts
+        //! inherited parent imagery against each child, so it overestimates,
+        //! but it tracks the real usage closely enough to attribute it.
+        std::size_t residentTextureBytes() const;
+
         //! Empty the registry, releasing all tiles.
         void releaseAll();
 
@@ -77,6 +119,29 @@ namespace ROCKY_NAMESPACE
         //! @return The tile, if it exists
         vsg::ref_ptr<TerrainTileNode> getTile(const TileKey& key) const;
 
+        //! Samples the terrain elevation at a batch of points from
+        //! resident tile data only - zero I/O. Each point's z is replaced
+        //! with the height from the deepest resident tile containing it,
+        //! or NO_DATA_VALUE when no resident tile covers it.
+        //! @param points Points to sample; z is replaced in place
+        //! @param srs Spatial reference of the points
+        //! @return Number of points that yielded a valid height
+        unsigned sampleResidentElevation(std::vector<glm::dvec3>& points, const SRS& srs) const;
+
+        //! Builds a CPU-side snapshot of the rendered elevation surface
+        //! over an extent, sampled from resident tile data only - zero
+        //! I/O and the same post-composite rasters the GPU displaces the
+        //! terrain with. The returned heightfield is a private copy, so
+        //! physics/collision consumers can query it at simulation rate
+        //! without touching the pager's lock; poll dataRevision to know
+        //! when to take a fresh one. Cells no resident tile covers hold
+        //! NO_DATA_VALUE.
+        //! @param extent Area to snapshot, in any SRS
+        //! @param width Number of columns to sample (>= 2)
+        //! @param height Number of rows to sample (>= 2)
+        //! @return The snapshot, or an invalid object on bad input
+        GeoHeightfield snapshotResidentElevation(const GeoExtent& extent, unsigned width, unsigned height) const;
+
         TileTable _tiles;
         Tracker _tracker;
         std::uint64_t _lastUpdate = 0;
@@ -92,9 +157,20 @@ namespace ROCKY_NAMESPACE
         std::vector<TileKey> _updateData;
 
         unsigned _firstLOD = 0u;
+        Profile _profile;
 
     private:
 
+        // camera state sampled once per frame in ping(), feeding the
+        // predicted-reuse expiry scoring in update()
+        glm::dvec3 _cameraPos = {};
+        glm::dvec3 _cameraVel = {};
+        std::uint64_t _cameraFrame = ~0ull;
+        std::chrono::steady_clock::time_point _cameraTime;
+
+        // when the resident-level cap last moved (see update())
+        std::chrono::steady_clock::time_point _lastCapChange;
+
         //! Loads the geometry for 4 new subtiles, and inherits their data models from a parent.
         void requestCreateChildren(
             TileInfo& info,
@@ -111,5 +187,14 @@ namespace ROCKY_NAMESPACE
             TileInfo& info,
             const IOOptions& io,
             std::shared_ptr<TerrainEngine> terrain) const;
+
+        //! Detects tile layers whose revision changed since the last pass
+        //! and invalidates the resident tiles intersecting their recorded
+        //! dirty extents, so they reload on their next ping. A layer
+        //! dirtied without extent information invalidates everything.
+        void invalidateDirtyTiles(std::shared_ptr<TerrainEngine> engine);
+
+        // revision of each tile layer at the last invalidation check
+        std::unordered_map<UID, Revision> _layerRevisions;
     };
 }
@@ -5,15 +5,18 @@
  * MIT License
  */
 #pragma once
+#include <array>
 #include <atomic>
 #include <cfloat>
 #include <chrono>
+#include <cstdint>
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
 #include <mutex>
 #include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -44,6 +47,16 @@
 #define WEEJOBS_NO_DISCARD
 #endif
 
+// OPTIONAL: C++20 coroutine integration. When this header is compiled
+// as C++20 or later, future<T> is awaitable with co_await and can serve
+// as a coroutine return type, so multi-stage pipelines can be written
+// as coroutines that resume directly on worker threads.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#define WEEJOBS_HAS_COROUTINES
+#endif
+
 /**
 * weejobs is an API for scheduling a task to run in the background.
 * Please read the README.md file for more information.
@@ -271,6 +284,11 @@ namespace WEEJOBS_NAMESPACE
         std::function<float()> priority = {}; // priority of the job
         std::shared_ptr<jobgroup> group = nullptr; // join group for this job
         bool can_cancel = true; // if true, the job will cancel if its future goes out of scope
+        std::chrono::steady_clock::time_point deadline = {}; // optional completion deadline; see job::current_priority()
+
+        bool has_deadline() const {
+            return deadline.time_since_epoch().count() != 0;
+        }
     };
 
     /**
@@ -463,6 +481,100 @@ namespace WEEJOBS_NAMESPACE
         //! return value (fire and forget).
         inline void then_dispatch(std::function<void(const T&)> func, const context& con = {});
 
+        //! Add a continuation to this future, to run on the given pool when
+        //! the result becomes available. This is the non-blocking alternative
+        //! to parking a worker thread on join(): the completion schedules the
+        //! next stage instead of a thread waiting for it. Returns the future
+        //! result of the continuation so calls can chain.
+        //! @param func Continuation; prototype is R(const T&, cancelable&)
+        //! @param pool Pool to run the continuation on (default pool if null)
+        template<typename F, typename R = typename detail::result_of_t<F, const T&, cancelable&>>
+        WEEJOBS_NO_DISCARD inline future<R> then(F func, class jobpool* pool = nullptr)
+        {
+            context con;
+            con.pool = pool;
+            return then_dispatch(func, con);
+        }
+
+        //! Add a fire-and-forget continuation to this future, to run on the
+        //! given pool when the result becomes available.
+        //! @param func Continuation; prototype is void(const T&)
+        //! @param pool Pool to run the continuation on (default pool if null)
+        inline void then(std::function<void(const T&)> func, class jobpool* pool = nullptr)
+        {
+            context con;
+            con.pool = pool;
+            then_dispatch(func, con);
+        }
+
+#ifdef WEEJOBS_HAS_COROUTINES
+        //! Awaiter that suspends a coroutine until this future resolves,
+        //! resuming it on the thread that resolves it. It occupies the
+        //! same continuation slot as then_dispatch, so a future may have
+        //! one awaiter or one continuation, but not both.
+        struct awaiter
+        {
+            future<T> _future;
+
+            bool await_ready() const
+            {
+                return _future.available() || _future.empty();
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                // Hold the shared state through a local: the moment the
+                // continuation is installed, another thread may resume
+                // (and even finish) the awaiting coroutine, taking this
+                // awaiter with it. Touch nothing of *this after that.
+                auto shared = _future._shared;
+
+                std::lock_guard<std::mutex> lock(shared->_continuation_mutex);
+
+                // the result arrived before we could suspend; keep running.
+                if (shared->_ev.isSet())
+                    return false;
+
+                shared->_continuation = [handle]() { handle.resume(); };
+                return true;
+            }
+
+            const T& await_resume() const
+            {
+                return _future.value();
+            }
+        };
+
+        //! co_await support. The coroutine suspends until the result is
+        //! available and resumes on the resolving thread, so multi-stage
+        //! pipelines chain stage to stage without polling.
+        //!
+        //! NOTE: some GCC releases mis-place non-trivial temporaries that
+        //! live across a co_await in the same statement (for example an
+        //! inline-constructed jobs::context argument). Dispatch from a
+        //! helper function or use a named context variable to stay clear
+        //! of that.
+        awaiter operator co_await() const
+        {
+            return awaiter{ *this };
+        }
+
+        //! Coroutine promise, letting a coroutine declare future<T> as
+        //! its return type. The coroutine body starts eagerly on the
+        //! calling thread, hops to worker threads at each co_await, and
+        //! co_return resolves the future handed back to the caller.
+        struct promise_type
+        {
+            future<T> _future;
+
+            future<T> get_return_object() { return _future; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_value(T value) { _future.resolve(std::move(value)); }
+            void unhandled_exception() { std::terminate(); }
+        };
+#endif
+
     private:
         std::shared_ptr<shared_t> _shared;
 
@@ -490,12 +602,33 @@ namespace WEEJOBS_NAMESPACE
         {
             context ctx;
             std::function<bool()> _delegate;
+            std::chrono::steady_clock::time_point queued = std::chrono::steady_clock::now();
+
+            //! Priority of this job as the scheduler sees it right now.
+            //! A deadline, when set, lifts the job into a band above any
+            //! static priority once the deadline is within a quarter
+            //! second, ordered earliest-deadline-first; until then the
+            //! static priority function governs. So a deadline job that
+            //! is being serviced promptly sorts normally, but one that
+            //! languishes behind bulk work jumps the queue as its
+            //! deadline nears.
+            float current_priority() const
+            {
+                float p = ctx.priority ? ctx.priority() : -FLT_MAX;
+                if (ctx.has_deadline())
+                {
+                    float remaining = std::chrono::duration<float>(
+                        ctx.deadline - std::chrono::steady_clock::now()).count();
+
+                    if (remaining < 0.25f)
+                        p = FLT_MAX / 4.0f - remaining;
+                }
+                return p;
+            }
 
             bool operator < (const job& rhs) const
             {
-                float lp = ctx.priority ? ctx.priority() : -FLT_MAX;
-                float rp = rhs.ctx.priority ? rhs.ctx.priority() : -FLT_MAX;
-                return lp < rp;
+                return current_priority() < rhs.current_priority();
             }
         };
 
@@ -509,6 +642,50 @@ namespace WEEJOBS_NAMESPACE
     class jobpool
     {
     public:
+        /**
+        * Point-in-time copy of a latency histogram, safe to read at leisure.
+        */
+        struct histogram_snapshot_t
+        {
+            static constexpr unsigned num_buckets = 16u;
+            unsigned buckets[num_buckets] = { 0u };
+            std::uint64_t count = 0;
+            double mean_ms = 0.0;
+        };
+
+        /**
+        * Lock-free histogram of millisecond durations in power-of-two
+        * buckets: bucket 0 counts samples under 1ms, bucket i counts
+        * [2^(i-1), 2^i) ms, and the last bucket collects everything longer.
+        */
+        struct histogram_t
+        {
+            static constexpr unsigned num_buckets = histogram_snapshot_t::num_buckets;
+            std::atomic_uint buckets[num_buckets] = {};
+            std::atomic<std::uint64_t> total_us = { 0 };
+            std::atomic<std::uint64_t> count = { 0 };
+
+            void insert(double ms)
+            {
+                unsigned b = 0;
+                while (b < num_buckets - 1 && ms >= (double)(1u << b))
+                    ++b;
+                buckets[b]++;
+                total_us += (std::uint64_t)(ms * 1000.0);
+                count++;
+            }
+
+            histogram_snapshot_t snapshot() const
+            {
+                histogram_snapshot_t out;
+                for (unsigned i = 0; i < num_buckets; ++i)
+                    out.buckets[i] = buckets[i];
+                out.count = count;
+                out.mean_ms = out.count > 0 ? 0.001 * (double)total_us / (double)out.count : 0.0;
+                return out;
+            }
+        };
+
         /**
         * Metrics of a thread pool.
         */
@@ -521,6 +698,19 @@ namespace WEEJOBS_NAMESPACE
             std::atomic_uint postprocessing = { 0u };
             std::atomic_uint canceled = { 0u };
             std::atomic_uint total = { 0u };
+            histogram_t queue_wait; // time from dispatch to execution start
+            histogram_t run_time;   // execution time of the job delegate
+        };
+
+        /**
+        * Latency snapshot for one job type (keyed by context::name),
+        * as returned by sample_stages().
+        */
+        struct stage_snapshot_t
+        {
+            std::string name;
+            histogram_snapshot_t queue_wait;
+            histogram_snapshot_t run_time;
         };
 
     public:
@@ -541,6 +731,24 @@ namespace WEEJOBS_NAMESPACE
             return &_metrics;
         }
 
+        //! Copies out the queue-wait and execution-time histograms for each
+        //! job type (context::name) this pool has run, so a monitoring
+        //! thread can poll latencies without perturbing the workers.
+        std::vector<stage_snapshot_t> sample_stages() const
+        {
+            std::vector<stage_snapshot_t> out;
+            std::lock_guard<std::mutex> lock(_stages_mutex);
+            out.reserve(_stages.size());
+            for (auto& iter : _stages)
+            {
+                out.emplace_back(stage_snapshot_t{
+                    iter.first,
+                    iter.second.queue_wait.snapshot(),
+                    iter.second.run_time.snapshot() });
+            }
+            return out;
+        }
+
         //! Set the concurrency of this job scheduler
         void set_concurrency(unsigned value)
         {
@@ -565,11 +773,31 @@ namespace WEEJOBS_NAMESPACE
             _can_steal_work = value;
         }
 
+        //! Function to call from each newly started worker thread, before it
+        //! begins processing jobs. Use this to apply platform-specific thread
+        //! placement - e.g., pinning this pool's workers to one NUMA node or
+        //! CPU set - so memory the workers touch stays local to the socket
+        //! that processes it. The function receives the worker's index within
+        //! the pool. Only affects threads started after the call, so create
+        //! the pool with zero threads, set this, then set_concurrency().
+        //! Combine with set_can_steal_work(false) to keep all of a pool's
+        //! work on the node that owns it.
+        void set_thread_init_function(std::function<void(unsigned)> f)
+        {
+            _thread_init = f;
+        }
+
         //! Discard all queued jobs
         void cancel_all()
         {
             std::lock_guard<std::mutex> lock(_queue_mutex);
             _queue.clear();
+            _queue_size = 0;
+            for (auto& shard : _shards)
+            {
+                std::lock_guard<std::mutex> shard_lock(shard.mutex);
+                shard.jobs.clear();
+            }
             _metrics.canceled += _metrics.pending;
             _metrics.pending = 0;
         }
@@ -590,13 +818,52 @@ namespace WEEJOBS_NAMESPACE
 
                 if (_target_concurrency > 0)
                 {
-                    std::lock_guard<std::mutex> lock(_queue_mutex);
+                    if (context.priority || context.has_deadline())
+                    {
+                        // prioritized (urgent) jobs go to the sorted lane so the
+                        // highest-priority one always runs next:
+                        std::lock_guard<std::mutex> lock(_queue_mutex);
+
+                        _queue.emplace_back(detail::job{ context, delegate });
+                        _queue_size++;
+
+                        _metrics.pending++;
+                        _metrics.total++;
+                        _block.notify_one();
+                    }
+                    else
+                    {
+                        // everything else distributes across the sharded FIFO
+                        // lanes; start at the round-robin cursor and settle on
+                        // the first shard whose lock is uncontended.
+                        unsigned start = _next_shard++;
+                        bool pushed = false;
+                        for (unsigned i = 0; i < num_shards && !pushed; ++i)
+                        {
+                            auto& shard = _shards[(start + i) % num_shards];
+                            if (shard.mutex.try_lock())
+                            {
+                                shard.jobs.emplace_back(detail::job{ context, delegate });
+                                shard.mutex.unlock();
+                                pushed = true;
+                            }
+                        }
+                        if (!pushed)
+                        {
+                            auto& shard = _shards[start % num_shards];
+                            std::lock_guard<std::mutex> lock(shard.mutex);
+                            shard.jobs.emplace_back(detail::job{ context, delegate });
+                        }
 
-                    _queue.emplace_back(detail::job{ context, delegate });
+                        _metrics.pending++;
+                        _metrics.total++;
 
-                    _metrics.pending++;
-                    _metrics.total++;
-                    _block.notify_one();
+                        // take the waiter lock briefly so the pending increment
+                        // cannot slip between a waiter's predicate check and
+                        // its sleep (a lost wakeup):
+                        std::lock_guard<std::mutex> lock(_queue_mutex);
+                        _block.notify_one();
+                    }
                 }
                 else
                 {
@@ -611,6 +878,82 @@ namespace WEEJOBS_NAMESPACE
             }
         }
 
+        //! Schedule a batch of jobs in one shot. The whole batch enqueues
+        //! under a single lock acquisition per lane and the workers wake
+        //! once, amortizing the overhead _dispatch_delegate pays per job.
+        //! Use jobs::dispatch_batch (usually no need to call this directly)
+        //! @param batch Jobs to enqueue; consumed by this call
+        void _dispatch_batch(std::vector<detail::job>& batch)
+        {
+            if (_done || batch.empty())
+                return;
+
+            // If jobs have group semaphores, acquire them BEFORE queuing
+            for (auto& each : batch)
+            {
+                if (each.ctx.group)
+                {
+                    each.ctx.group->acquire();
+                }
+            }
+
+            if (_target_concurrency > 0)
+            {
+                unsigned count = (unsigned)batch.size();
+
+                // partition into the two lanes, taking each lock once:
+                auto mid = std::partition(batch.begin(), batch.end(),
+                    [](const detail::job& j) { return j.ctx.priority != nullptr || j.ctx.has_deadline(); });
+
+                if (batch.begin() != mid)
+                {
+                    std::lock_guard<std::mutex> lock(_queue_mutex);
+                    for (auto iter = batch.begin(); iter != mid; ++iter)
+                        _queue.emplace_back(std::move(*iter));
+                    _queue_size += (std::size_t)std::distance(batch.begin(), mid);
+                }
+
+                if (mid != batch.end())
+                {
+                    auto& shard = _shards[_next_shard++ % num_shards];
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    for (auto iter = mid; iter != batch.end(); ++iter)
+                        shard.jobs.emplace_back(std::move(*iter));
+                }
+
+                _metrics.pending += count;
+                _metrics.total += count;
+
+                // wake enough workers for the whole batch in one pass
+                // (under the waiter lock; see _dispatch_delegate):
+                std::lock_guard<std::mutex> lock(_queue_mutex);
+                if (count >= _target_concurrency)
+                {
+                    _block.notify_all();
+                }
+                else
+                {
+                    for (unsigned i = 0; i < count; ++i)
+                        _block.notify_one();
+                }
+            }
+            else
+            {
+                // no threads? run synchronously.
+                for (auto& each : batch)
+                {
+                    each._delegate();
+
+                    if (each.ctx.group)
+                    {
+                        each.ctx.group->release();
+                    }
+                }
+            }
+
+            batch.clear();
+        }
+
         //! removes the highest priority job from the queue and places it
         //! in output. Returns true if a job was taken, false if the queue
         //! was empty.
@@ -627,9 +970,7 @@ namespace WEEJOBS_NAMESPACE
                 float highest_priority = -FLT_MAX;
                 for (auto iter = _queue.begin(); iter != _queue.end(); ++iter)
                 {
-                    float priority = iter->ctx.priority != nullptr ?
-                        iter->ctx.priority() :
-                        0.0f;
+                    float priority = iter->current_priority();
 
                     if (ptr == _queue.end() || priority > highest_priority)
                     {
@@ -645,6 +986,7 @@ namespace WEEJOBS_NAMESPACE
                 if (_queue.size() > 1)
                     *ptr = std::move(_queue.back());
                 _queue.resize(_queue.size() - 1);
+                _queue_size--;
 
                 _metrics.pending--;
                 return true;
@@ -652,6 +994,45 @@ namespace WEEJOBS_NAMESPACE
             return false;
         }
 
+        //! Takes the next job for a worker whose home shard is "home".
+        //! The priority lane always goes first so urgent jobs preempt
+        //! bulk work; then the worker's own shard newest-first, then a
+        //! sweep of the sibling shards oldest-first (stealing order).
+        //! Returns true if a job was taken.
+        inline bool _next_job(detail::job& output, unsigned home)
+        {
+            // lock-free peek at the atomic lane size (reading the vector
+            // itself without the lock would race the dispatchers);
+            // _take_job re-checks under the lock.
+            if (_queue_size.load(std::memory_order_relaxed) > 0)
+            {
+                if (_take_job(output, true))
+                    return true;
+            }
+
+            for (unsigned i = 0; i < num_shards; ++i)
+            {
+                auto& shard = _shards[(home + i) % num_shards];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                if (!shard.jobs.empty())
+                {
+                    if (i == 0)
+                    {
+                        output = std::move(shard.jobs.back());
+                        shard.jobs.pop_back();
+                    }
+                    else
+                    {
+                        output = std::move(shard.jobs.front());
+                        shard.jobs.erase(shard.jobs.begin());
+                    }
+                    _metrics.pending--;
+                    return true;
+                }
+            }
+            return false;
+        }
+
         //! Construct a new job pool.
         //! Do not call this directly - call getPool(name) instead.
         jobpool(const std::string& name, unsigned concurrency) :
@@ -660,6 +1041,8 @@ namespace WEEJOBS_NAMESPACE
             _metrics.name = name;
             _metrics.concurrency = 0;
             _queue.reserve(256);
+            for (auto& shard : _shards)
+                shard.jobs.reserve(64);
         }
 
         //! Pulls queued jobs and runs them in whatever thread run() is called from.
@@ -675,15 +1058,49 @@ namespace WEEJOBS_NAMESPACE
         //! Wait for all threads to exit (after calling stop_threads)
         inline void join_threads();
 
+        //! Number of sharded FIFO lanes for unprioritized jobs. Workers
+        //! favor their home shard and sweep the others when it is empty,
+        //! so push/pop traffic spreads across num_shards locks instead of
+        //! serializing on the priority-lane mutex.
+        static constexpr unsigned num_shards = 8u;
+
+        struct shard_t
+        {
+            std::mutex mutex;
+            std::vector<detail::job> jobs;
+        };
+
         bool _can_steal_work = true;
-        std::vector<detail::job> _queue;
+        std::vector<detail::job> _queue; // priority lane (jobs with a priority function or deadline)
+        std::atomic<std::size_t> _queue_size = { 0 }; // priority-lane size, for lock-free peeks
+        std::array<shard_t, num_shards> _shards; // FIFO lanes for everything else
+        std::atomic<unsigned> _next_shard = { 0u }; // round-robin push cursor
         mutable std::mutex _queue_mutex; // protect access to the queue
         mutable std::mutex _quit_mutex; // protects access to _done
         std::atomic<unsigned> _target_concurrency; // target number of concurrent threads in the pool
         std::condition_variable_any _block; // thread waiter block
         bool _done = false; // set to true when threads should exit
+        std::function<void(unsigned)> _thread_init; // placement hook for new worker threads
         std::vector<std::thread> _threads; // threads in the pool
         metrics_t _metrics; // metrics for this pool
+
+        struct stage_t
+        {
+            histogram_t queue_wait;
+            histogram_t run_time;
+        };
+
+        // finds (or creates) the latency records for a job type. The map is
+        // node-based, so the returned pointer stays valid after the lock is
+        // released.
+        stage_t* _stage(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(_stages_mutex);
+            return &_stages[name];
+        }
+
+        mutable std::mutex _stages_mutex; // protects _stages lookups
+        std::unordered_map<std::string, stage_t> _stages; // per-job-type latencies
     };
 
     class metrics
@@ -731,6 +1148,7 @@ namespace WEEJOBS_NAMESPACE
             std::vector<jobpool*> _pools;
             metrics _metrics;
             std::function<void(const char*)> _set_thread_name;
+            std::function<void(const char*, std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point)> _job_trace;
         };
     }
 
@@ -791,6 +1209,40 @@ namespace WEEJOBS_NAMESPACE
         detail::pool_dispatch(delegate, context);
     }
 
+    //! Dispatches a batch of jobs with no return values, all sharing one
+    //! context. The batch enqueues under a single lock acquisition and
+    //! wakes the workers once, which is cheaper than calling dispatch()
+    //! in a loop when submitting several related jobs at once.
+    //! @param tasks Functions to run in threads. Prototype is void(void).
+    //! @param context Optional configuration shared by every job in the batch
+    inline void dispatch_batch(std::vector<std::function<void()>> tasks, const context& context = {})
+    {
+        std::vector<detail::job> batch;
+        batch.reserve(tasks.size());
+        for (auto& task : tasks)
+        {
+            std::function<bool()> delegate = [task = std::move(task)]() mutable -> bool { task(); return true; };
+            batch.emplace_back(detail::job{ context, delegate });
+        }
+
+        auto pool = context.pool ? context.pool : get_pool({});
+        if (pool)
+        {
+            pool->_dispatch_batch(batch);
+
+            // if work stealing is enabled, wake up all pools
+            if (instance()._stealing_allowed)
+            {
+                std::lock_guard<std::mutex> lock(instance()._pools_mutex);
+
+                for (auto pool : instance()._pools)
+                {
+                    pool->_block.notify_all();
+                }
+            }
+        }
+    }
+
     //! Dispatches a job and immediately returns a future result.
     //! @param task Function to run in a thread. Prototype is T(cancelable&)
     //! @param context Optional configuration for the asynchronous function call
@@ -873,6 +1325,15 @@ namespace WEEJOBS_NAMESPACE
         instance()._set_thread_name = f;
     }
 
+    //! Install a function to be called with the name, start time, and end
+    //! time of every job a pool executes - e.g. to feed a profiler or a
+    //! trace-event capture. Pass nullptr to uninstall. The function runs on
+    //! the worker thread that ran the job.
+    inline void set_job_trace_function(std::function<void(const char*, std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point)> f)
+    {
+        instance()._job_trace = f;
+    }
+
     //! Whether to allow jobpools to steal work from other jobpools when they are idle.
     inline void set_allow_work_stealing(bool value)
     {
@@ -906,6 +1367,11 @@ namespace WEEJOBS_NAMESPACE
 
     inline void jobpool::run()
     {
+        // spread the workers across the shards so their fast-path pops
+        // rarely touch the same lock:
+        unsigned home_shard = (unsigned)
+            (std::hash<std::thread::id>()(std::this_thread::get_id()) % num_shards);
+
         while (!_done)
         {
             detail::job next;
@@ -918,28 +1384,30 @@ namespace WEEJOBS_NAMESPACE
 
                         // work-stealing enabled: wait until any queue is non-empty
                         _block.wait(lock, [this]() { return get_metrics()->total_pending() > 0 || _done; });
-
-                        if (!_done && !_queue.empty())
-                        {
-                            have_next = _take_job(next, false);
-                        }
                     }
 
-                    if (!_done && !have_next)
+                    if (!_done)
                     {
-                        have_next = detail::steal_job(this, next);
+                        have_next = _next_job(next, home_shard);
+
+                        if (!have_next)
+                        {
+                            have_next = detail::steal_job(this, next);
+                        }
                     }
                 }
                 else
                 {
-                    std::unique_lock<std::mutex> lock(_queue_mutex);
+                    {
+                        std::unique_lock<std::mutex> lock(_queue_mutex);
 
-                    // wait until just our local queue is non-empty
-                    _block.wait(lock, [this] { return !_queue.empty() || _done; });
+                        // wait until this pool has pending work
+                        _block.wait(lock, [this] { return _metrics.pending > 0u || _done; });
+                    }
 
-                    if (!_done && !_queue.empty())
+                    if (!_done)
                     {
-                        have_next = _take_job(next, false);
+                        have_next = _next_job(next, home_shard);
                     }
                 }
             }
@@ -952,12 +1420,32 @@ namespace WEEJOBS_NAMESPACE
 
                 bool job_executed = next._delegate();
 
-                auto duration = std::chrono::steady_clock::now() - t0;
+                auto t1 = std::chrono::steady_clock::now();
 
                 if (job_executed == false)
                 {
                     _metrics.canceled++;
                 }
+                else
+                {
+                    double wait_ms = std::chrono::duration<double, std::milli>(t0 - next.queued).count();
+                    double run_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+                    _metrics.queue_wait.insert(wait_ms);
+                    _metrics.run_time.insert(run_ms);
+
+                    if (!next.ctx.name.empty())
+                    {
+                        auto* stage = _stage(next.ctx.name);
+                        stage->queue_wait.insert(wait_ms);
+                        stage->run_time.insert(run_ms);
+                    }
+
+                    if (instance()._job_trace)
+                    {
+                        instance()._job_trace(next.ctx.name.c_str(), t0, t1);
+                    }
+                }
 
                 // release the group semaphore if necessary
                 if (next.ctx.group != nullptr)
@@ -987,14 +1475,18 @@ namespace WEEJOBS_NAMESPACE
         // Not enough? Start up more
         while (_metrics.concurrency < _target_concurrency)
         {
-            _metrics.concurrency++;
+            unsigned index = _metrics.concurrency++;
 
-            _threads.push_back(std::thread([this]
+            _threads.push_back(std::thread([this, index, init = _thread_init]
                 {
                     if (instance()._set_thread_name)
                     {
                         instance()._set_thread_name(_metrics.name.c_str());
                     }
+                    if (init)
+                    {
+                        init(index);
+                    }
                     run();
                 }
             ));
@@ -1018,6 +1510,20 @@ namespace WEEJOBS_NAMESPACE
             }
         }
         _queue.clear();
+        _queue_size = 0;
+
+        for (auto& shard : _shards)
+        {
+            std::lock_guard<std::mutex> shard_lock(shard.mutex);
+            for (auto& queuedjob : shard.jobs)
+            {
+                if (queuedjob.ctx.group != nullptr)
+                {
+                    queuedjob.ctx.group->release();
+                }
+            }
+            shard.jobs.clear();
+        }
 
         // wake up all threads so they can exit
         _block.notify_all();
@@ -1050,9 +1556,9 @@ namespace WEEJOBS_NAMESPACE
             {
                 if (pool != thief)
                 {
-                    if (static_cast<std::size_t>(pool->_queue.size()) > max_num_jobs)
+                    if (static_cast<std::size_t>(pool->_metrics.pending) > max_num_jobs)
                     {
-                        max_num_jobs = pool->_queue.size();
+                        max_num_jobs = pool->_metrics.pending;
                         pool_with_most_jobs = pool;
                     }
                 }
@@ -1061,7 +1567,7 @@ namespace WEEJOBS_NAMESPACE
 
         if (pool_with_most_jobs)
         {
-            return pool_with_most_jobs->_take_job(stolen, true);
+            return pool_with_most_jobs->_next_job(stolen, 0u);
         }
 
         return false;
@@ -1,12 +1,15 @@
 #pragma once
 #include "rtree.h"
+#include <algorithm>
 #include <cmath>
 #include <climits>
+#include <limits>
 #include <map>
 #include <unordered_map>
 #include <iterator>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 #define marker_is_set(INDEX, BITS) ((markers[INDEX] & BITS) != 0)
 #define marker_not_set(INDEX, BITS) ((markers[INDEX] & BITS) == 0)
@@ -272,6 +275,10 @@ namespace weemesh
 
         spatial_index_t _spatial_index;
         vert_table_t _vert_lut;
+        // working set of candidate triangles during an insert; a member so
+        // its capacity persists across the thousands of inserts a
+        // constraint-heavy tile performs
+        std::vector<UID> _working_set;
         int _num_edits = 0;
         int _boundary_marker = 1;
         int _constraint_marker = 16;
@@ -449,6 +456,14 @@ namespace weemesh
             }
         }
 
+        // insert a batch of segments into the mesh, cutting triangles as
+        // necessary. Equivalent to inserting each segment in turn.
+        void insert(const std::vector<segment_t>& segments, int marker)
+        {
+            for (auto& seg : segments)
+                insert(seg, marker);
+        }
+
         // insert a segment into the mesh, cutting triangles as necessary
         void insert(const segment_t& seg, int marker)
         {
@@ -459,14 +474,6 @@ namespace weemesh
             a_min[1] = std::min(seg.first.y, seg.second.y);
             a_max[0] = std::max(seg.first.x, seg.second.x);
             a_max[1] = std::max(seg.first.y, seg.second.y);
-            std::vector<UID> uids;
-
-            _spatial_index.Search(
-                a_min, a_max,
-                [&uids](const UID& u) {
-                    uids.push_back(u);
-                    return true;
-                });
 
             // The working set of triangles which we will add to if we have
             // to split triangles. Any triangle only needs to be split once,
@@ -475,30 +482,61 @@ namespace weemesh
             // splits will just happen on the new triangles later. (That's why
             // every split operation is followed by a "continue" to short-circuit
             // to loop)
-            std::list<UID> uid_list;
-            std::copy(uids.begin(), uids.end(), std::back_inserter(uid_list));
-            for (auto uid : uid_list)
+            _working_set.clear();
+
+            _spatial_index.Search(
+                a_min, a_max,
+                [this](const UID& u) {
+                    _working_set.push_back(u);
+                    return true;
+                });
+
+            // signed-distance test (scaled by the segment length) of a point
+            // against the segment's supporting line, for pruning:
+            vert_t dir = seg.second - seg.first;
+            auto side = [&](vert_t::value_type x, vert_t::value_type y) {
+                return dir.cross2d(vert_t(x, y, 0.0) - seg.first);
+            };
+            vert_t::value_type slack = epsilon * dir.length2d();
+
+            for (std::size_t n = 0; n < _working_set.size(); ++n)
             {
-                triangle_t& tri = triangles[uid];
+                triangle_t& tri = triangles[_working_set[n]];
 
                 // skip triangles that are "degenerate" in 2D. We will keep them
                 // because they may NOT be degenerate in 3D (e.g. steep slopes).
                 if (tri.is_2d_degenerate)
                     continue;
 
+                // The spatial index only filters on the segment's bounding
+                // box, so a long diagonal constraint will hand us every
+                // triangle under that box. If the triangle's own bbox lies
+                // entirely on one side of the segment's supporting line
+                // (beyond tolerance), the segment cannot touch it; skip it
+                // before running the containment and edge-crossing tests.
+                auto s0 = side(tri.a_min[0], tri.a_min[1]);
+                auto s1 = side(tri.a_max[0], tri.a_min[1]);
+                auto s2 = side(tri.a_min[0], tri.a_max[1]);
+                auto s3 = side(tri.a_max[0], tri.a_max[1]);
+                if ((s0 > slack && s1 > slack && s2 > slack && s3 > slack) ||
+                    (s0 < -slack && s1 < -slack && s2 < -slack && s3 < -slack))
+                {
+                    continue;
+                }
+
                 // first see if one of the endpoints falls within a triangle.
                 // if so, split the triangle into 2 or 3 new ones, and mark
                 // all of its verts as CONSTRAINT so they will not be subject
                 // to morphing.
                 if (tri.contains_2d(seg.first, epsilon))
                 {
-                    if (inside_split(tri, seg.first, &uid_list, marker))
+                    if (inside_split(tri, seg.first, &_working_set, marker))
                         continue;
                 }
 
                 if (tri.contains_2d(seg.second, epsilon))
                 {
-                    if (inside_split(tri, seg.second, &uid_list, marker))
+                    if (inside_split(tri, seg.second, &_working_set, marker))
                         continue;
                 }
 
@@ -532,7 +570,7 @@ namespace weemesh
                     if (new_uid >= 0) {
                         markers[tri.i2] |= _constraint_marker;
                         markers[tri.i0] |= _constraint_marker;
-                        uid_list.push_back(new_uid);
+                        _working_set.push_back(new_uid);
                         ++new_tris;
                     }
 
@@ -540,7 +578,7 @@ namespace weemesh
                     if (new_uid >= 0) {
                         markers[tri.i1] |= _constraint_marker;
                         markers[tri.i2] |= _constraint_marker;
-                        uid_list.push_back(new_uid);
+                        _working_set.push_back(new_uid);
                         ++new_tris;
                     }
 
@@ -577,7 +615,7 @@ namespace weemesh
                     if (new_uid >= 0) {
                         markers[tri.i0] |= _constraint_marker;
                         markers[tri.i1] |= _constraint_marker;
-                        uid_list.push_back(new_uid);
+                        _working_set.push_back(new_uid);
                         ++new_tris;
                     }
 
@@ -585,7 +623,7 @@ namespace weemesh
                     if (new_uid >= 0) {
                         markers[tri.i2] |= _constraint_marker;
                         markers[tri.i0] |= _constraint_marker;
-                        uid_list.push_back(new_uid);
+                        _working_set.push_back(new_uid);
                         ++new_tris;
                     }
 
@@ -622,7 +660,7 @@ namespace weemesh
                     if (new_uid >= 0) {
                         markers[tri.i1] |= _constraint_marker;
                         markers[tri.i2] |= _constraint_marker;
-                        uid_list.push_back(new_uid);
+                        _working_set.push_back(new_uid);
                         ++new_tris;
                     }
 
@@ -630,7 +668,7 @@ namespace weemesh
                     if (new_uid >= 0) {
                         markers[tri.i0] |= _constraint_marker;
                         markers[tri.i1] |= _constraint_marker;
-                        uid_list.push_back(new_uid);
+                        _working_set.push_back(new_uid);
                         ++new_tris;
                     }
 
@@ -654,7 +692,7 @@ namespace weemesh
         // inserts point "p" into the interior of triangle "tri",
         // adds three new triangles, and removes the original triangle.
         // return true if a split actual happened
-        bool inside_split(triangle_t& tri, const vert_t& p, std::list<UID>* uid_list, int new_marker)
+        bool inside_split(triangle_t& tri, const vert_t& p, std::vector<UID>* uid_list, int new_marker)
         {
             int new_i = get_or_create_vertex(p, new_marker);
             if (new_i < 0)
@@ -980,4 +1018,364 @@ namespace weemesh
             }
         }
     };
+
+    /**
+    * High-throughput triangulator for straight-edge polygons with holes,
+    * using ear clipping in the manner of the well-known "earcut" algorithm.
+    * Emits index triples over the input rings, never creating new vertices,
+    * so it is much faster than constrained meshing when the fill needs no
+    * interior points; fall back to mesh_t's constrained insertion when it
+    * does (or when triangulate() reports failure on degenerate input).
+    */
+    class triangulator_t
+    {
+    public:
+        //! Triangulate a polygon given as a collection of rings, where
+        //! rings[0] is the outer ring and the rest are holes (input winding
+        //! does not matter). Appends triangle index triples to "out",
+        //! indexing the ring vertices in concatenated order (outer ring
+        //! first, then each hole). Returns false if the polygon could not
+        //! be fully triangulated, e.g. for self-intersecting input, in
+        //! which case "out" may hold a partial result.
+        template<class RINGS> // e.g., std::vector<std::vector<vert_t>>
+        bool triangulate(const RINGS& rings, std::vector<unsigned>& out)
+        {
+            if (rings.empty() || rings[0].size() < 3)
+                return false;
+
+            std::size_t total = 0;
+            for (auto& ring : rings)
+                total += ring.size();
+
+            _arena.clear();
+            _arena.reserve(total + 2 * rings.size()); // +2 per hole bridge
+
+            node_t* outer = linked_ring(rings[0], 0u, true);
+            if (!outer || outer->prev == outer->next)
+                return false;
+
+            if (rings.size() > 1)
+            {
+                std::vector<node_t*> holes;
+                unsigned base = (unsigned)rings[0].size();
+
+                for (std::size_t r = 1; r < rings.size(); ++r)
+                {
+                    if (rings[r].size() >= 3)
+                    {
+                        node_t* ring = linked_ring(rings[r], base, false);
+                        if (ring)
+                            holes.push_back(leftmost(ring));
+                    }
+                    base += (unsigned)rings[r].size();
+                }
+
+                // connecting holes left to right keeps the bridges from
+                // crossing each other:
+                std::sort(holes.begin(), holes.end(), [](node_t* a, node_t* b) { return a->x < b->x; });
+
+                for (auto hole : holes)
+                    outer = eliminate_hole(hole, outer);
+            }
+
+            outer = filter_points(outer);
+            if (!outer)
+                return false;
+
+            out.reserve(out.size() + 3 * (total - 2));
+            return clip_ears(outer, out);
+        }
+
+    private:
+        struct node_t
+        {
+            unsigned i;
+            double x, y;
+            node_t* prev;
+            node_t* next;
+        };
+
+        // all nodes live here; reserved up front so pointers stay valid
+        std::vector<node_t> _arena;
+
+        node_t* insert_node(unsigned i, double x, double y, node_t* last)
+        {
+            _arena.push_back(node_t{ i, x, y, nullptr, nullptr });
+            node_t* p = &_arena.back();
+            if (!last)
+            {
+                p->prev = p;
+                p->next = p;
+            }
+            else
+            {
+                p->next = last->next;
+                p->prev = last;
+                last->next->prev = p;
+                last->next = p;
+            }
+            return p;
+        }
+
+        static void remove_node(node_t* p)
+        {
+            p->next->prev = p->prev;
+            p->prev->next = p->next;
+        }
+
+        static double area(const node_t* p, const node_t* q, const node_t* r)
+        {
+            return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+        }
+
+        static bool equals(const node_t* a, const node_t* b)
+        {
+            return a->x == b->x && a->y == b->y;
+        }
+
+        static bool point_in_triangle(
+            double ax, double ay, double bx, double by, double cx, double cy,
+            double px, double py)
+        {
+            return
+                (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+                (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+                (bx - px) * (cy - py) >= (cx - px) * (by - py);
+        }
+
+        template<class RING>
+        static double signed_area(const RING& ring)
+        {
+            double sum = 0.0;
+            for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+                sum += (ring[j].x - ring[i].x) * (ring[i].y + ring[j].y);
+            return sum;
+        }
+
+        // builds a circular doubly-linked list from a ring, reversing it if
+        // necessary so that the list winds in the requested direction:
+        template<class RING>
+        node_t* linked_ring(const RING& ring, unsigned base, bool clockwise)
+        {
+            node_t* last = nullptr;
+
+            if (clockwise == (signed_area(ring) > 0.0))
+            {
+                for (unsigned i = 0; i < (unsigned)ring.size(); ++i)
+                    last = insert_node(base + i, ring[i].x, ring[i].y, last);
+            }
+            else
+            {
+                for (unsigned i = (unsigned)ring.size(); i-- > 0; )
+                    last = insert_node(base + i, ring[i].x, ring[i].y, last);
+            }
+            return last;
+        }
+
+        // removes duplicate and collinear points:
+        static node_t* filter_points(node_t* start, node_t* end = nullptr)
+        {
+            if (!start)
+                return nullptr;
+            if (!end)
+                end = start;
+
+            node_t* p = start;
+            bool again;
+            do
+            {
+                again = false;
+                if (equals(p, p->next) || area(p->prev, p, p->next) == 0.0)
+                {
+                    remove_node(p);
+                    p = end = p->prev;
+                    if (p == p->next)
+                        return nullptr;
+                    again = true;
+                }
+                else
+                {
+                    p = p->next;
+                }
+            } while (again || p != end);
+
+            return end;
+        }
+
+        static node_t* leftmost(node_t* start)
+        {
+            node_t* p = start;
+            node_t* left = start;
+            do
+            {
+                if (p->x < left->x || (p->x == left->x && p->y < left->y))
+                    left = p;
+                p = p->next;
+            } while (p != start);
+            return left;
+        }
+
+        // whether the diagonal from a to b lies inside the polygon in the
+        // local neighborhood of a:
+        static bool locally_inside(const node_t* a, const node_t* b)
+        {
+            return area(a->prev, a, a->next) < 0.0 ?
+                area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0 :
+                area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
+        }
+
+        // David Eberly's algorithm for finding an outer-ring vertex that the
+        // hole's leftmost vertex can bridge to without crossing any edges:
+        static node_t* find_hole_bridge(node_t* hole, node_t* outer)
+        {
+            node_t* p = outer;
+            double hx = hole->x;
+            double hy = hole->y;
+            double qx = -std::numeric_limits<double>::max();
+            node_t* m = nullptr;
+
+            // find the nearest edge that a leftward ray from the hole point
+            // crosses, and its endpoint with the smaller x:
+            do
+            {
+                if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+                {
+                    double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+                    if (x <= hx && x > qx)
+                    {
+                        qx = x;
+                        m = p->x < p->next->x ? p : p->next;
+                        if (x == hx)
+                            return m; // hole touches the outline
+                    }
+                }
+                p = p->next;
+            } while (p != outer);
+
+            if (!m)
+                return nullptr;
+
+            // look for reflex points inside the triangle (hole point,
+            // intersection, endpoint); if found, bridge to the one with the
+            // smallest angle to the ray instead:
+            const node_t* stop = m;
+            double mx = m->x;
+            double my = m->y;
+            double tan_min = std::numeric_limits<double>::max();
+
+            p = m;
+            do
+            {
+                if (hx >= p->x && p->x >= mx && hx != p->x &&
+                    point_in_triangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+                {
+                    double tangent = std::fabs(hy - p->y) / (hx - p->x);
+
+                    if (locally_inside(p, hole) &&
+                        (tangent < tan_min || (tangent == tan_min && p->x > m->x)))
+                    {
+                        m = p;
+                        mx = m->x;
+                        my = m->y;
+                        tan_min = tangent;
+                    }
+                }
+                p = p->next;
+            } while (p != stop);
+
+            return m;
+        }
+
+        // links two rings into one by adding a bridge edge from a to b,
+        // duplicating both endpoints:
+        node_t* split_ring(node_t* a, node_t* b)
+        {
+            node_t* a2 = insert_node(a->i, a->x, a->y, nullptr);
+            node_t* b2 = insert_node(b->i, b->x, b->y, nullptr);
+            node_t* an = a->next;
+            node_t* bp = b->prev;
+
+            a->next = b;
+            b->prev = a;
+
+            a2->next = an;
+            an->prev = a2;
+
+            b2->next = a2;
+            a2->prev = b2;
+
+            bp->next = b2;
+            b2->prev = bp;
+
+            return b2;
+        }
+
+        node_t* eliminate_hole(node_t* hole, node_t* outer)
+        {
+            node_t* bridge = find_hole_bridge(hole, outer);
+            if (!bridge)
+                return outer;
+
+            node_t* merged = split_ring(bridge, hole);
+            filter_points(merged, merged->next);
+
+            node_t* filtered = filter_points(bridge, bridge->next);
+            return filtered ? filtered : outer;
+        }
+
+        static bool is_ear(const node_t* ear)
+        {
+            const node_t* a = ear->prev;
+            const node_t* b = ear;
+            const node_t* c = ear->next;
+
+            if (area(a, b, c) >= 0.0)
+                return false; // reflex or degenerate corner
+
+            // no other reflex point may fall inside the candidate ear:
+            const node_t* p = ear->next->next;
+            while (p != ear->prev)
+            {
+                if (point_in_triangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+                    area(p->prev, p, p->next) >= 0.0)
+                {
+                    return false;
+                }
+                p = p->next;
+            }
+            return true;
+        }
+
+        static bool clip_ears(node_t* ear, std::vector<unsigned>& out)
+        {
+            if (!ear)
+                return false;
+
+            node_t* stop = ear;
+
+            while (ear->prev != ear->next)
+            {
+                node_t* prev = ear->prev;
+                node_t* next = ear->next;
+
+                if (is_ear(ear))
+                {
+                    out.push_back(prev->i);
+                    out.push_back(ear->i);
+                    out.push_back(next->i);
+
+                    remove_node(ear);
+                    ear = next->next;
+                    stop = next->next;
+                    continue;
+                }
+
+                ear = next;
+
+                if (ear == stop)
+                    return false; // no ears left; bad input remains
+            }
+            return true;
+        }
+    };
 }
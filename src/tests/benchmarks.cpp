@@ -0,0 +1,328 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ *
+ * Microbenchmarks for the data-model hot paths. Run with no arguments to
+ * print ns/op for each kernel; use --save to record a baseline file and
+ * --compare to check a run against one (non-zero exit on regression), e.g.
+ *
+ *   rocky_benchmarks --save baseline.txt
+ *   ... make changes ...
+ *   rocky_benchmarks --compare baseline.txt
+ */
+#include <rocky/rocky.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ROCKY_NAMESPACE;
+
+namespace
+{
+    // defeat dead-code elimination without perturbing the timed loop:
+    volatile double sink = 0.0;
+
+    template<typename T>
+    inline void keep(const T& value) {
+        sink = sink + (double)value;
+    }
+
+    // Runs fn (which performs "ops" operations per call) repeatedly until
+    // roughly a quarter second has elapsed, and returns the fastest
+    // observed ns per operation. Minimum-of-N rejects scheduler noise
+    // better than the mean does.
+    template<typename F>
+    double ns_per_op(F&& fn, std::size_t ops)
+    {
+        using clock = std::chrono::steady_clock;
+
+        fn(); // warm caches and code
+
+        double best = 1e18;
+        auto deadline = clock::now() + std::chrono::milliseconds(250);
+        do
+        {
+            auto t0 = clock::now();
+            fn();
+            auto t1 = clock::now();
+            double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / (double)ops;
+            if (ns < best) best = ns;
+        }
+        while (clock::now() < deadline);
+
+        return best;
+    }
+
+    std::map<std::string, double> results;
+    std::string filter;
+
+    template<typename F>
+    void run(const std::string& name, F&& fn, std::size_t ops)
+    {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            return;
+        double ns = ns_per_op(fn, ops);
+        results[name] = ns;
+        std::printf("%-40s %12.1f ns/op\n", name.c_str(), ns);
+    }
+
+    void benchmark_image_read_bilinear()
+    {
+        Image image(Image::R8G8B8A8_UNORM, 256, 256);
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<float> uv(0.0f, 1.0f);
+
+        const std::size_t N = 4096;
+        std::vector<std::pair<float, float>> coords(N);
+        for (auto& c : coords)
+            c = { uv(rng), uv(rng) };
+
+        run("Image::read_bilinear", [&]()
+            {
+                glm::fvec4 pixel;
+                float total = 0.0f;
+                for (auto& [u, v] : coords)
+                {
+                    image.read_bilinear(pixel, u, v);
+                    total += pixel.r;
+                }
+                keep(total);
+            }, N);
+    }
+
+    void benchmark_srs_transform()
+    {
+        SRS wgs84("wgs84");
+        SRS mercator("spherical-mercator");
+        if (!wgs84.valid() || !mercator.valid())
+        {
+            std::printf("%-40s %12s\n", "SRSOperation::transform", "(no PROJ)");
+            return;
+        }
+        auto xform = wgs84.to(mercator);
+
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<double> lon(-179.0, 179.0), lat(-80.0, 80.0);
+
+        const std::size_t N = 1024;
+        std::vector<glm::dvec3> points(N);
+        for (auto& p : points)
+            p = { lon(rng), lat(rng), 0.0 };
+
+        run("SRSOperation::transform", [&]()
+            {
+                double total = 0.0;
+                for (auto p : points)
+                {
+                    xform.transform(p.x, p.y);
+                    total += p.x;
+                }
+                keep(total);
+            }, N);
+    }
+
+    void benchmark_tilekey_math()
+    {
+        Profile geodetic("global-geodetic");
+        Profile mercator("spherical-mercator");
+
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<double> lon(-179.0, 179.0), lat(-80.0, 80.0);
+
+        const std::size_t N = 1024;
+        std::vector<glm::dvec2> points(N);
+        for (auto& p : points)
+            p = { lon(rng), lat(rng) };
+
+        run("TileKey::createTileKeyContainingPoint", [&]()
+            {
+                unsigned total = 0;
+                for (auto& p : points)
+                {
+                    auto key = TileKey::createTileKeyContainingPoint(p.x, p.y, 12, geodetic);
+                    total += key.x;
+                }
+                keep(total);
+            }, N);
+
+        // cross-profile queries (the mosaic-assembly path):
+        std::vector<TileKey> keys;
+        keys.reserve(N);
+        for (auto& p : points)
+            keys.push_back(TileKey::createTileKeyContainingPoint(p.x, p.y, 12, geodetic));
+
+        run("TileKey::getIntersectingKeys", [&]()
+            {
+                std::size_t total = 0;
+                TileKey::Vector out;
+                for (auto& key : keys)
+                {
+                    out.clear();
+                    key.getIntersectingKeys(mercator, out);
+                    total += out.size();
+                }
+                keep(total);
+            }, N);
+    }
+
+    void benchmark_geoextent_intersection()
+    {
+        SRS wgs84("wgs84");
+
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<double> x(-170.0, 160.0), y(-80.0, 70.0);
+
+        const std::size_t N = 1024;
+        std::vector<GeoExtent> extents;
+        extents.reserve(N);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            double xmin = x(rng), ymin = y(rng);
+            extents.emplace_back(wgs84, xmin, ymin, xmin + 10.0, ymin + 10.0);
+        }
+
+        GeoExtent probe(wgs84, -10.0, -10.0, 10.0, 10.0);
+
+        run("GeoExtent::intersects", [&]()
+            {
+                unsigned total = 0;
+                for (auto& e : extents)
+                    total += e.intersects(probe) ? 1 : 0;
+                keep(total);
+            }, N);
+
+        run("GeoExtent::intersectionSameSRS", [&]()
+            {
+                double total = 0.0;
+                for (auto& e : extents)
+                    total += e.intersectionSameSRS(probe).width();
+                keep(total);
+            }, N);
+    }
+
+    void benchmark_lru_cache()
+    {
+        const std::size_t N = 4096;
+
+        util::LRUCache<std::uint64_t, std::uint64_t> cache(N / 2);
+
+        run("LRUCache get/put (1 thread)", [&]()
+            {
+                std::uint64_t total = 0;
+                for (std::uint64_t i = 0; i < N; ++i)
+                {
+                    auto hit = cache.get(i % (N / 4));
+                    if (hit == 0)
+                        cache.put(i % (N / 4), i + 1);
+                    total += hit;
+                }
+                keep(total);
+            }, N);
+
+        // contended: each thread works the same key range so the shards
+        // see real lock traffic, not a partitioned workload
+        const unsigned THREADS = 4;
+        run("LRUCache get/put (4 threads)", [&]()
+            {
+                std::vector<std::thread> threads;
+                for (unsigned t = 0; t < THREADS; ++t)
+                {
+                    threads.emplace_back([&, t]()
+                        {
+                            std::uint64_t total = 0;
+                            for (std::uint64_t i = 0; i < N; ++i)
+                            {
+                                auto hit = cache.get(i % (N / 4));
+                                if (hit == 0)
+                                    cache.put(i % (N / 4), i + t + 1);
+                                total += hit;
+                            }
+                            keep(total);
+                        });
+                }
+                for (auto& t : threads)
+                    t.join();
+            }, N * THREADS);
+    }
+
+    std::map<std::string, double> loadBaseline(const std::string& filename)
+    {
+        std::map<std::string, double> baseline;
+        std::ifstream in(filename);
+        std::string name;
+        double ns;
+        while (std::getline(in, name, '\t') && (in >> ns))
+        {
+            baseline[name] = ns;
+            in.ignore(); // trailing newline
+        }
+        return baseline;
+    }
+
+    void saveBaseline(const std::string& filename)
+    {
+        std::ofstream out(filename);
+        for (auto& [name, ns] : results)
+            out << name << '\t' << ns << '\n';
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string saveFile, compareFile;
+    double tolerance = 0.20; // fractional slowdown to tolerate
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+            saveFile = argv[++i];
+        else if (std::strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+            compareFile = argv[++i];
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+            tolerance = std::atof(argv[++i]) / 100.0;
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else
+        {
+            std::printf("usage: %s [--filter substring] [--save file] [--compare file [--tolerance pct]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    benchmark_image_read_bilinear();
+    benchmark_srs_transform();
+    benchmark_tilekey_math();
+    benchmark_geoextent_intersection();
+    benchmark_lru_cache();
+
+    if (!saveFile.empty())
+        saveBaseline(saveFile);
+
+    int regressions = 0;
+    if (!compareFile.empty())
+    {
+        auto baseline = loadBaseline(compareFile);
+        std::printf("\nvs. %s (tolerance %.0f%%):\n", compareFile.c_str(), tolerance * 100.0);
+        for (auto& [name, ns] : results)
+        {
+            auto i = baseline.find(name);
+            if (i == baseline.end())
+                continue;
+            double delta = (ns - i->second) / i->second;
+            bool regressed = delta > tolerance;
+            std::printf("%-40s %+11.1f%% %s\n", name.c_str(), delta * 100.0, regressed ? "REGRESSION" : "");
+            if (regressed)
+                ++regressions;
+        }
+    }
+
+    return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,356 @@
+/**
+ * rocky c++
+ * Copyright 2023 Pelican Mapping
+ * MIT License
+ *
+ * Headless soak test for slow-growth regressions. Kiosk deployments run
+ * for weeks, and a slow leak in a tile cache or a drifting merge latency
+ * only shows after hours - long after any unit test has come and gone.
+ * This target orbits a camera over a layer stack, paging tiles through
+ * TerrainTileModelFactory in a steady-state working set, and samples
+ * process memory, cache sizes, and merge-latency percentiles on a fixed
+ * interval. At the end it fits a trend to the samples (ignoring the
+ * warmup) and exits non-zero if memory or latency drifted past the
+ * thresholds, e.g.
+ *
+ *   rocky_soak --minutes 480 --max-memory-drift 64
+ */
+#include <rocky/rocky.h>
+#include <rocky/Memory.h>
+#include <rocky/TerrainTileModelFactory.h>
+#include <rocky/TMSImageLayer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ROCKY_NAMESPACE;
+using namespace std::chrono;
+
+namespace
+{
+    int usage(const char* name)
+    {
+        std::cout
+            << "usage: " << name << " [options]\n"
+            << "    --minutes <n>            soak duration (default 10)\n"
+            << "    --map <file.json>        layer stack to page (default: OSM imagery)\n"
+            << "    --concurrency <n>        merge worker threads (default 4)\n"
+            << "    --interval <sec>         sample window (default 30)\n"
+            << "    --max-memory-drift <n>   fail if private bytes grow faster than\n"
+            << "                             this many MB/hour after warmup (default 64)\n"
+            << "    --max-latency-drift <n>  fail if the merge p95 of the last quarter\n"
+            << "                             exceeds the first quarter by more than\n"
+            << "                             this percentage (default 50)\n"
+            << "    --csv <file>             also append the samples to a CSV file\n"
+            << std::endl;
+        return -1;
+    }
+
+    // one sample window's worth of measurements
+    struct Sample
+    {
+        double hours = 0.0;         // since soak start
+        double privateMB = 0.0;
+        double physicalMB = 0.0;
+        std::size_t cacheEntries = 0;
+        unsigned merged = 0;
+        double p50 = 0.0;           // window merge latency, ms
+        double p95 = 0.0;
+    };
+
+    double percentile(std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0.0;
+        auto i = (std::size_t)(p * (double)(sorted.size() - 1));
+        return sorted[i];
+    }
+
+    // least-squares slope of y against x; the drift rate per unit x
+    double slope(const std::vector<double>& x, const std::vector<double>& y)
+    {
+        if (x.size() < 2)
+            return 0.0;
+        double n = (double)x.size(), sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            sx += x[i], sy += y[i], sxx += x[i] * x[i], sxy += x[i] * y[i];
+        }
+        double d = n * sxx - sx * sx;
+        return d != 0.0 ? (n * sxy - sx * sy) / d : 0.0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string mapFile, csvFile;
+    double minutes = 10.0;
+    unsigned concurrency = 4;
+    double intervalSec = 30.0;
+    double maxMemoryDriftMBPerHour = 64.0;
+    double maxLatencyDriftPercent = 50.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--minutes" && i + 1 < argc) minutes = std::atof(argv[++i]);
+        else if (arg == "--map" && i + 1 < argc) mapFile = argv[++i];
+        else if (arg == "--concurrency" && i + 1 < argc) concurrency = std::atoi(argv[++i]);
+        else if (arg == "--interval" && i + 1 < argc) intervalSec = std::atof(argv[++i]);
+        else if (arg == "--max-memory-drift" && i + 1 < argc) maxMemoryDriftMBPerHour = std::atof(argv[++i]);
+        else if (arg == "--max-latency-drift" && i + 1 < argc) maxLatencyDriftPercent = std::atof(argv[++i]);
+        else if (arg == "--csv" && i + 1 < argc) csvFile = argv[++i];
+        else return usage(argv[0]);
+    }
+
+    Log()->set_level(log::level::warn);
+
+    auto context = ContextFactory::create();
+
+    auto map = Map::create();
+
+    if (!mapFile.empty())
+    {
+        std::ifstream in(mapFile);
+        if (!in)
+        {
+            std::cout << "Cannot open map file " << mapFile << std::endl;
+            return -1;
+        }
+        std::stringstream buf;
+        buf << in.rdbuf();
+        auto status = map->from_json(buf.str(), context->io);
+        if (status.failed())
+        {
+            std::cout << "Cannot parse map file: " << status.message << std::endl;
+            return -1;
+        }
+    }
+    else
+    {
+        auto imagery = TMSImageLayer::create();
+        imagery->uri = "https://[abc].tile.openstreetmap.org/{z}/{x}/{y}.png";
+        imagery->profile = Profile("spherical-mercator");
+        map->add(imagery);
+    }
+
+    map->openAllLayers(context->io);
+
+    for (auto& layer : map->layers().all())
+    {
+        if (layer->status().failed())
+        {
+            std::cout << "Layer \"" << layer->name() << "\" failed to open: "
+                << layer->status().message << std::endl;
+            return -1;
+        }
+    }
+
+    // the orbit: a kiosk-style loop at constant range, circling the
+    // globe so the working set keeps turning over
+    const double orbitLat = 40.0;          // degrees
+    const double orbitRange = 100.0e3;     // meters
+    const double orbitDegPerSec = 0.5;
+
+    // same nominal viewport rocky_stress uses to map range to LOD
+    Profile profile("global-geodetic");
+    const unsigned tileSize = 257;
+    const double vfov = 30.0;
+    const double viewportHeight = 1080.0;
+    const double metersPerDegree = 111320.0;
+
+    double mpp = 2.0 * orbitRange * tan(util::deg2rad(0.5 * vfov)) / viewportHeight;
+    double res = mpp / metersPerDegree;
+    unsigned lod = std::min(profile.getLevelOfDetailForHorizResolution(res, tileSize), 19u);
+
+    TerrainTileModelFactory factory;
+    auto pool = jobs::get_pool("rocky.soak", concurrency);
+
+    std::mutex statsMutex;
+    std::vector<double> windowLatencies;
+    std::atomic<unsigned> windowMerged = { 0 };
+
+    std::map<TileKey, jobs::future<bool>> inflight;
+    std::set<TileKey> resident;
+
+    std::vector<Sample> samples;
+
+    std::ofstream csv;
+    if (!csvFile.empty())
+    {
+        csv.open(csvFile, std::ios::app);
+        csv << "hours,private_mb,physical_mb,cache_entries,merged,p50_ms,p95_ms\n";
+    }
+
+    std::cout << ROCKY_PROJECT_NAME " " ROCKY_VERSION_STRING " soak test\n"
+        << "duration=" << minutes << " min, interval=" << intervalSec << " s, lod=" << lod << "\n"
+        << "    hours  priv_MB  phys_MB    cache   merged   p50_ms   p95_ms\n";
+
+    auto start = steady_clock::now();
+    auto elapsed = [&]() { return 1e-3 * (double)duration_cast<milliseconds>(steady_clock::now() - start).count(); };
+    auto nextSample = start + duration_cast<steady_clock::duration>(duration<double>(intervalSec));
+
+    for (double now = elapsed(); now <= minutes * 60.0; now = elapsed())
+    {
+        double lon = -180.0 + std::fmod(now * orbitDegPerSec, 360.0);
+
+        double h = res * viewportHeight * 0.5;
+        double w = h * (16.0 / 9.0);
+        GeoExtent visible(profile.srs(),
+            std::max(lon - w, profile.extent().xmin()),
+            std::max(orbitLat - h, profile.extent().ymin()),
+            std::min(lon + w, profile.extent().xmax()),
+            std::min(orbitLat + h, profile.extent().ymax()));
+
+        TileKey::Vector wanted;
+        TileKey::getIntersectingKeys(visible, lod, profile, wanted);
+        std::set<TileKey> wantedSet(wanted.begin(), wanted.end());
+
+        // steady-state working set: drop tiles behind the orbit
+        for (auto iter = resident.begin(); iter != resident.end(); )
+        {
+            if (wantedSet.count(*iter) == 0)
+                iter = resident.erase(iter);
+            else
+                ++iter;
+        }
+
+        for (auto& key : wanted)
+        {
+            if (resident.count(key) > 0 || inflight.count(key) > 0)
+                continue;
+
+            auto task = [&factory, &statsMutex, &windowLatencies, &windowMerged,
+                map, key, io = context->io](jobs::cancelable&)
+                {
+                    auto t0 = steady_clock::now();
+                    auto model = factory.createTileModel(map.get(), key, {}, io);
+                    auto t1 = steady_clock::now();
+
+                    if (!model.empty())
+                    {
+                        std::lock_guard lock(statsMutex);
+                        windowLatencies.push_back(
+                            1e-3 * (double)duration_cast<microseconds>(t1 - t0).count());
+                    }
+                    windowMerged++;
+                    return true;
+                };
+
+            inflight[key] = jobs::dispatch(task, jobs::context{ "rocky::soak", pool });
+        }
+
+        for (auto iter = inflight.begin(); iter != inflight.end(); )
+        {
+            if (iter->second.available())
+            {
+                resident.insert(iter->first);
+                iter = inflight.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        // close out a sample window?
+        if (steady_clock::now() >= nextSample)
+        {
+            nextSample += duration_cast<steady_clock::duration>(duration<double>(intervalSec));
+
+            Sample s;
+            s.hours = now / 3600.0;
+            s.privateMB = (double)Memory::getProcessPrivateUsage() / 1048576.0;
+            s.physicalMB = (double)Memory::getProcessPhysicalUsage() / 1048576.0;
+            s.cacheEntries = context->io.services.contentCache ?
+                context->io.services.contentCache->size() : 0;
+            s.merged = windowMerged.exchange(0);
+            {
+                std::lock_guard lock(statsMutex);
+                std::sort(windowLatencies.begin(), windowLatencies.end());
+                s.p50 = percentile(windowLatencies, 0.50);
+                s.p95 = percentile(windowLatencies, 0.95);
+                windowLatencies.clear();
+            }
+            samples.emplace_back(s);
+
+            printf("%9.3lf %8.1lf %8.1lf %8zu %8u %8.2lf %8.2lf\n",
+                s.hours, s.privateMB, s.physicalMB, s.cacheEntries, s.merged, s.p50, s.p95);
+
+            if (csv.is_open())
+            {
+                csv << s.hours << ',' << s.privateMB << ',' << s.physicalMB << ','
+                    << s.cacheEntries << ',' << s.merged << ',' << s.p50 << ',' << s.p95 << "\n";
+                csv.flush();
+            }
+        }
+
+        std::this_thread::sleep_for(milliseconds(100));
+    }
+
+    // Drift analysis. The first 20% is warmup - caches filling to their
+    // steady-state sizes reads as growth but isn't drift.
+    auto warmup = samples.size() / 5;
+    if (samples.size() - warmup < 4)
+    {
+        std::cout << "Too few samples for drift analysis; run longer or "
+            "shorten --interval" << std::endl;
+        return -1;
+    }
+
+    std::vector<double> hoursAxis, privateAxis;
+    for (auto i = warmup; i < samples.size(); ++i)
+    {
+        hoursAxis.push_back(samples[i].hours);
+        privateAxis.push_back(samples[i].privateMB);
+    }
+    double memoryDrift = slope(hoursAxis, privateAxis); // MB per hour
+
+    // latency drift: first quarter vs last quarter of the post-warmup run
+    auto quarter = std::max<std::size_t>(1, (samples.size() - warmup) / 4);
+    double p95first = 0.0, p95last = 0.0;
+    for (std::size_t i = 0; i < quarter; ++i)
+    {
+        p95first += samples[warmup + i].p95;
+        p95last += samples[samples.size() - 1 - i].p95;
+    }
+    p95first /= (double)quarter, p95last /= (double)quarter;
+    double latencyDrift = p95first > 0.0 ? 100.0 * (p95last - p95first) / p95first : 0.0;
+
+    bool failed = false;
+
+    std::cout << "\nmemory drift          " << memoryDrift << " MB/hour"
+        << " (limit " << maxMemoryDriftMBPerHour << ")\n";
+    if (memoryDrift > maxMemoryDriftMBPerHour)
+    {
+        std::cout << "FAIL: private bytes are drifting upward" << std::endl;
+        failed = true;
+    }
+
+    std::cout << "merge p95 drift       " << latencyDrift << " %"
+        << " (limit " << maxLatencyDriftPercent << ")\n";
+    if (latencyDrift > maxLatencyDriftPercent)
+    {
+        std::cout << "FAIL: merge latency is drifting upward" << std::endl;
+        failed = true;
+    }
+
+    if (!failed)
+    {
+        std::cout << "OK: no drift detected" << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -156,6 +156,18 @@ TEST_CASE("Compression")
 
     // ensure the decompressed stream matched the original data
     CHECK(decompressed_data == original_data);
+
+    // streaming decompression, feeding the input in small chunks the way
+    // it would arrive from the network:
+    util::StreamingZLibDecompressor streamer;
+    std::string streamed_data;
+    const std::size_t chunk = 257;
+    for (std::size_t i = 0; i < compressed_data.size(); i += chunk)
+    {
+        auto n = std::min(chunk, compressed_data.size() - i);
+        CHECK(streamer.decode(compressed_data.data() + i, n, streamed_data) == true);
+    }
+    CHECK(streamed_data == original_data);
 }
 #endif
 
@@ -200,6 +212,37 @@ TEST_CASE("Image")
     CHECK(equiv(value.g, 0.5f, 0.01f));
     CHECK(equiv(value.b, 0.0f, 0.01f));
     CHECK(equiv(value.a, 1.0f, 0.01f));
+
+    // bilinear sampling through the format-specialized kernels:
+    image = Image::create(Image::R8G8B8A8_UNORM, 2, 2);
+    image->write(Image::Pixel(0, 0, 0, 1), 0, 0);
+    image->write(Image::Pixel(1, 0, 0, 1), 1, 0);
+    image->write(Image::Pixel(0, 0, 0, 1), 0, 1);
+    image->write(Image::Pixel(1, 0, 0, 1), 1, 1);
+    image->read_bilinear(value, 0.5f, 0.5f);
+    CHECK(equiv(value.r, 0.5f, 0.01f));
+    CHECK(equiv(value.a, 1.0f, 0.01f));
+
+    // typed views agree with the Layout dispatch:
+    ImageView<Image::R8G8B8A8_UNORM> view(image.get());
+    REQUIRE(view.valid());
+    view.write(Image::Pixel(0.25f, 0.5f, 0.75f, 1.0f), 0, 0);
+    view.read(value, 0, 0);
+    CHECK(equiv(value.r, 0.25f, 0.01f));
+    CHECK(equiv(value.g, 0.5f, 0.01f));
+    image->read(value, 0, 0);
+    CHECK(equiv(value.b, 0.75f, 0.01f));
+
+    // contiguous mipmap chain:
+    image = Image::create(Image::R8G8B8A8_UNORM, 4, 4);
+    image->fill(Image::Pixel(1, 1, 1, 1));
+    CHECK(image->mipLevels() == 1);
+    CHECK(image->sizeInBytes() == 64);
+    image->generateMipmaps();
+    CHECK(image->mipLevels() == 3);
+    CHECK(image->sizeInBytes() == 84); // 4x4 + 2x2 + 1x1, 4bpp
+    image->read(value, 0, 0);
+    CHECK(equiv(value.r, 1.0f, 0.01f)); // base level untouched
 }
 
 TEST_CASE("Heightfield")
@@ -231,6 +274,18 @@ TEST_CASE("Heightfield")
         // all NODATA:
         hf->fill(NO_DATA_VALUE);
         CHECK(hf->heightAtPixel(16.5, 16.5, Interpolation::BILINEAR) == NO_DATA_VALUE);
+
+        // min/max pyramid:
+        auto hf2 = Heightfield::create(257, 257);
+        hf2->fill(0.0f);
+        hf2->heightAt(100, 200) = 500.0f;
+        GeoHeightfield geohf(hf2, GeoExtent(SRS::WGS84, 0, 0, 1, 1));
+        geohf.generateMinMaxPyramid();
+        CHECK(geohf.hasMinMaxPyramid());
+        auto minmax = geohf.minMaxHeight(0.0, 0.0, 0.25, 0.25);
+        CHECK(minmax.y < 500.0f);
+        minmax = geohf.minMaxHeight(0.0, 0.0, 1.0, 1.0);
+        CHECK(minmax.y == 500.0f);
     }
 }
 